@@ -20,12 +20,57 @@ QT += widgets
 QT += printsupport 
 QT += charts
 QT += svg
+QT += concurrent
 QT += testlib
 # testlib only needed to use QTest::qWait in Chart::getPixmap()...
 qtHaveModule(opengl): QT += opengl
 
 INCLUDEPATH  += ./src
 
+# Optional BLAS/LAPACK backend for the dense Matrix products, inversion and
+# linear systems. Enable it with:  qmake CONFIG+=socnetv_blas
+# By default it links OpenBLAS (Accelerate on macOS). For another vendor, pass
+# its link line, i.e.  qmake CONFIG+=socnetv_blas BLAS_LIBS="-lmkl_rt"
+# Without it, the built-in kernels in src/matrix.cpp are used.
+socnetv_blas {
+    DEFINES += SOCNETV_USE_BLAS
+    isEmpty(BLAS_LIBS) {
+        macx: BLAS_LIBS = -framework Accelerate
+        else: BLAS_LIBS = -lopenblas
+    }
+    LIBS += $${BLAS_LIBS}
+    message("Using BLAS/LAPACK backend: $${BLAS_LIBS}")
+}
+
+# Transparent compressed input and output (src/compressedfile.cpp).
+# gzip needs zlib, which is used by default on unix. Elsewhere, or to turn it
+# on explicitly, use:  qmake CONFIG+=socnetv_zlib
+# zstd needs libzstd 1.4 or later:  qmake CONFIG+=socnetv_zstd
+unix: CONFIG += socnetv_zlib
+socnetv_zlib {
+    DEFINES += SOCNETV_USE_ZLIB
+    LIBS += -lz
+}
+socnetv_zstd {
+    DEFINES += SOCNETV_USE_ZSTD
+    LIBS += -lzstd
+}
+
+# Debug messages of the hot paths (src/graphtrace.h) are compiled out of
+# release builds. To keep them, use:  qmake CONFIG+=socnetv_hot_path_logging
+CONFIG(debug, debug|release): CONFIG += socnetv_hot_path_logging
+socnetv_hot_path_logging {
+    DEFINES += SOCNETV_HOT_PATH_LOGGING
+}
+
+# Benchmarks of the analyses, layouts and parsers (src/graphbenchmark.cpp).
+# "make benchmark" builds socnetv and writes the timings to benchmark.csv.
+# Pass more options with BENCHMARK_ARGS, i.e.
+#   make benchmark BENCHMARK_ARGS="--sizes 1000,10000 --threads 8"
+benchmark.commands = ./$(TARGET) --benchmark --out benchmark.csv $(BENCHMARK_ARGS)
+benchmark.depends = $(TARGET)
+QMAKE_EXTRA_TARGETS += benchmark
+
 FORMS += src/forms/dialogfilteredgesbyweight.ui \
     src/forms/dialogsettings.ui \
     src/forms/dialogsysteminfo.ui \
@@ -49,15 +94,43 @@ FORMS += src/forms/dialogfilteredgesbyweight.ui \
 HEADERS += src/mainwindow.h \
     src/texteditor.h \
     src/graph.h \
+    src/graphcsr.h \
+    src/graphdistanceheap.h \
+    src/graphrandom.h \
+    src/graphquadtree.h \
+    src/graphlayoutengine.h \
+    src/graphcomponents.h \
+    src/graphdistribution.h \
+    src/graphscoreindex.h \
+    src/graphlabelindex.h \
+    src/graphneighborhood.h \
+    src/graphweightindex.h \
+    src/graphresultcache.h \
+    src/graphresultstore.h \
+    src/graphprogress.h \
+    src/graphscheduler.h \
+    src/graphtrace.h \
+    src/graphbatch.h \
+    src/graphbenchmark.h \
+    src/graphbinaryfile.h \
+    src/graphfilewriter.h \
+    src/graphcliques.h \
+    src/graphattributes.h \
     src/graphvertex.h \
     src/matrix.h \
+    src/sparsematrix.h \
     src/parser.h \
+    src/compressedfile.h \
     src/webcrawler.h \
+    src/webcrawlerfrontier.h \
+    src/webcrawlerindex.h \
     src/chart.h \
     src/graphicswidget.h \
     src/graphicsedge.h \
     src/graphicsedgeweight.h \
     src/graphicsedgelabel.h \
+    src/graphicsedgelayer.h \
+    src/graphicsnodelayer.h \
     src/graphicsguide.h \
     src/graphicsnode.h \
     src/graphicsnodelabel.h \
@@ -82,21 +155,50 @@ HEADERS += src/mainwindow.h \
     src/forms/dialogexportpdf.h \
     src/forms/dialogexportimage.h \
     src/forms/dialogsysteminfo.h \
+    src/forms/dialogprofiler.h \
     src/global.h
 
 SOURCES += src/main.cpp \
     src/mainwindow.cpp \
     src/texteditor.cpp \
     src/graph.cpp \
+    src/graphcsr.cpp \
+    src/graphdistanceheap.cpp \
+    src/graphrandom.cpp \
+    src/graphquadtree.cpp \
+    src/graphlayoutengine.cpp \
+    src/graphcomponents.cpp \
+    src/graphdistribution.cpp \
+    src/graphscoreindex.cpp \
+    src/graphlabelindex.cpp \
+    src/graphneighborhood.cpp \
+    src/graphweightindex.cpp \
+    src/graphresultcache.cpp \
+    src/graphresultstore.cpp \
+    src/graphprogress.cpp \
+    src/graphscheduler.cpp \
+    src/graphtrace.cpp \
+    src/graphbatch.cpp \
+    src/graphbenchmark.cpp \
+    src/graphbinaryfile.cpp \
+    src/graphfilewriter.cpp \
+    src/graphcliques.cpp \
+    src/graphattributes.cpp \
     src/graphvertex.cpp \
     src/matrix.cpp \
+    src/sparsematrix.cpp \
     src/parser.cpp \
+    src/compressedfile.cpp \
     src/webcrawler.cpp \
+    src/webcrawlerfrontier.cpp \
+    src/webcrawlerindex.cpp \
     src/chart.cpp \
     src/graphicswidget.cpp \
     src/graphicsedge.cpp \
     src/graphicsedgeweight.cpp \
     src/graphicsedgelabel.cpp \
+    src/graphicsedgelayer.cpp \
+    src/graphicsnodelayer.cpp \
     src/graphicsguide.cpp \
     src/graphicsnode.cpp \
     src/graphicsnodelabel.cpp \
@@ -120,7 +222,8 @@ SOURCES += src/main.cpp \
     src/forms/dialognodefind.cpp \
     src/forms/dialogexportpdf.cpp \
     src/forms/dialogexportimage.cpp \
-    src/forms/dialogsysteminfo.cpp
+    src/forms/dialogsysteminfo.cpp \
+    src/forms/dialogprofiler.cpp
 
 
 RESOURCES = src/src.qrc
@@ -82,6 +82,7 @@ BuildRequires:  pkgconfig(Qt5Widgets)
 BuildRequires:  pkgconfig(Qt5Network)
 BuildRequires:  pkgconfig(Qt5Charts)
 BuildRequires:  pkgconfig(Qt5Svg)
+BuildRequires:  pkgconfig(zlib)
 Provides:       %{name} = %{version}
 Obsoletes:      %{name} < %{version}
 BuildRoot:	%{_tmppath}/%{name}-%{version}-%{release}-buildroot
@@ -137,6 +137,49 @@ void Chart::removeAllSeries() {
 
 
 
+/**
+ * @brief Updates the series of the chart in place with the points of series,
+ * if the chart has one series of the same type, line or area.
+ * The chart keeps its series and axes, so that it is not rebuilt every time
+ * a distribution is recomputed. The caller still owns series.
+ * @param series
+ * @return true if the chart series has been updated
+ */
+bool Chart::replaceSeries(QAbstractSeries *series) {
+    if ( ! series || m_chart->series().size() != 1 ) {
+        return false;
+    }
+    QAbstractSeries *current = m_chart->series().first();
+    if ( current->type() != series->type() ) {
+        return false;
+    }
+
+    QXYSeries *from = Q_NULLPTR, *to = Q_NULLPTR;
+    switch ( series->type() ) {
+    case QAbstractSeries::SeriesTypeLine:
+        from = static_cast<QXYSeries *>(series);
+        to = static_cast<QXYSeries *>(current);
+        break;
+    case QAbstractSeries::SeriesTypeArea:
+        from = static_cast<QAreaSeries *>(series)->upperSeries();
+        to = static_cast<QAreaSeries *>(current)->upperSeries();
+        break;
+    default:
+        break;
+    }
+    if ( ! from || ! to ) {
+        return false;
+    }
+
+    qDebug() << "Chart::replaceSeries() - replacing" << to->count()
+             << "points with" << from->count();
+    to->replace( from->pointsVector() );
+    current->setName( series->name() );
+    return true;
+}
+
+
+
 /**
  * @brief Creates default axes. Must be called AFTER loading a series to the chart
  */
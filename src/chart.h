@@ -59,6 +59,7 @@ public:
     void addSeries(QAbstractSeries *series = Q_NULLPTR );
     void appendToSeries (const QPointF &p);
     void removeAllSeries();
+    bool replaceSeries(QAbstractSeries *series);
 
     void createDefaultAxes();
     QList<QAbstractAxis*> axes(Qt::Orientations orientation = Qt::Horizontal|Qt::Vertical,
@@ -0,0 +1,818 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         compressedfile.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "compressedfile.h"
+
+#include <QtDebug>
+#include <QThread>
+#include <QMutexLocker>
+
+#include <cstring>
+
+#ifdef SOCNETV_USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SOCNETV_USE_ZSTD
+#include <zstd.h>
+#endif
+
+
+static const int COMPRESSED_FILE_CHUNK_SIZE = 1 << 20;     // decompressed
+static const int COMPRESSED_FILE_INPUT_SIZE = 1 << 18;     // compressed
+static const int COMPRESSED_FILE_MAX_CHUNKS = 4;
+
+
+/**
+ * @brief The worker thread which decompresses a CompressedFile.
+ * It reads the compressed file and queues the decompressed data in chunks,
+ * waiting while the reader has COMPRESSED_FILE_MAX_CHUNKS chunks left to read.
+ */
+class CompressedFileDecoder : public QThread
+{
+public:
+    explicit CompressedFileDecoder(CompressedFile *owner) : m_owner(owner) {}
+
+protected:
+    void run() override {
+        QString error;
+        switch (m_owner->m_compression) {
+        case CompressedFile::Gzip:
+            error = inflateGzip();
+            break;
+        case CompressedFile::Zstd:
+            error = inflateZstd();
+            break;
+        default:
+            break;
+        }
+        m_owner->decoderFinish(error);
+    }
+
+private:
+    QString inflateGzip() {
+#ifdef SOCNETV_USE_ZLIB
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+        // 15 + 32: the maximum window, with a gzip or zlib header
+        if ( inflateInit2(&stream, 15 + 32) != Z_OK ) {
+            return QObject::tr("Cannot initialize the gzip decompressor.");
+        }
+        QString error;
+        QByteArray input;
+        QByteArray output(COMPRESSED_FILE_CHUNK_SIZE, Qt::Uninitialized);
+        int produced = 0;
+        int status = Z_OK;
+        // A call which fills the output chunk may leave decoded data in the
+        // stream, which the next call returns without more input
+        bool outputFull = false;
+        while ( ! m_owner->decoderCancelled() ) {
+            if ( stream.avail_in == 0 && ! outputFull ) {
+                input = m_owner->m_file.read(COMPRESSED_FILE_INPUT_SIZE);
+                if ( input.isEmpty() ) {
+                    if ( status != Z_STREAM_END ) {
+                        error = QObject::tr("The gzip file is truncated.");
+                    }
+                    break;
+                }
+                stream.next_in = reinterpret_cast<Bytef *>( input.data() );
+                stream.avail_in = (uInt) input.size();
+            }
+            if ( status == Z_STREAM_END ) {
+                // Another gzip member follows, as in files made by cat
+                inflateReset(&stream);
+            }
+            stream.next_out = reinterpret_cast<Bytef *>( output.data() ) + produced;
+            stream.avail_out = (uInt) ( COMPRESSED_FILE_CHUNK_SIZE - produced );
+            status = inflate(&stream, Z_NO_FLUSH);
+            if ( status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR ) {
+                error = QObject::tr("The gzip file is corrupt: %1")
+                        .arg( stream.msg ? stream.msg : "unknown error" );
+                break;
+            }
+            produced = COMPRESSED_FILE_CHUNK_SIZE - (int) stream.avail_out;
+            outputFull = ( produced == COMPRESSED_FILE_CHUNK_SIZE && status != Z_STREAM_END );
+            if ( produced == COMPRESSED_FILE_CHUNK_SIZE ) {
+                if ( ! m_owner->decoderPush(output) ) {
+                    break;
+                }
+                output = QByteArray(COMPRESSED_FILE_CHUNK_SIZE, Qt::Uninitialized);
+                produced = 0;
+            }
+        }
+        if ( produced > 0 && error.isEmpty() ) {
+            output.truncate(produced);
+            m_owner->decoderPush(output);
+        }
+        inflateEnd(&stream);
+        return error;
+#else
+        return QObject::tr("This build of SocNetV cannot read gzip files.");
+#endif
+    }
+
+    QString inflateZstd() {
+#ifdef SOCNETV_USE_ZSTD
+        ZSTD_DStream *stream = ZSTD_createDStream();
+        if ( !stream || ZSTD_isError( ZSTD_initDStream(stream) ) ) {
+            ZSTD_freeDStream(stream);
+            return QObject::tr("Cannot initialize the zstd decompressor.");
+        }
+        QString error;
+        QByteArray input;
+        QByteArray output(COMPRESSED_FILE_CHUNK_SIZE, Qt::Uninitialized);
+        ZSTD_inBuffer in = { 0, 0, 0 };
+        size_t produced = 0;
+        size_t frameRemaining = 1;
+        // A call which fills the output chunk may leave decoded data in the
+        // stream, even if it has consumed all input: call it again before
+        // reading more. A frame is complete and flushed when it returns 0.
+        bool outputFull = false;
+        while ( ! m_owner->decoderCancelled() ) {
+            if ( in.pos == in.size && ! outputFull ) {
+                input = m_owner->m_file.read(COMPRESSED_FILE_INPUT_SIZE);
+                if ( input.isEmpty() ) {
+                    if ( frameRemaining != 0 ) {
+                        error = QObject::tr("The zstd file is truncated.");
+                    }
+                    break;
+                }
+                in.src = input.constData();
+                in.size = (size_t) input.size();
+                in.pos = 0;
+            }
+            ZSTD_outBuffer out = { output.data(), (size_t) COMPRESSED_FILE_CHUNK_SIZE, produced };
+            frameRemaining = ZSTD_decompressStream(stream, &out, &in);
+            if ( ZSTD_isError(frameRemaining) ) {
+                error = QObject::tr("The zstd file is corrupt: %1")
+                        .arg( ZSTD_getErrorName(frameRemaining) );
+                break;
+            }
+            produced = out.pos;
+            outputFull = ( produced == (size_t) COMPRESSED_FILE_CHUNK_SIZE && frameRemaining != 0 );
+            if ( produced == (size_t) COMPRESSED_FILE_CHUNK_SIZE ) {
+                if ( ! m_owner->decoderPush(output) ) {
+                    break;
+                }
+                output = QByteArray(COMPRESSED_FILE_CHUNK_SIZE, Qt::Uninitialized);
+                produced = 0;
+            }
+        }
+        if ( produced > 0 && error.isEmpty() ) {
+            output.truncate( (int) produced );
+            m_owner->decoderPush(output);
+        }
+        ZSTD_freeDStream(stream);
+        return error;
+#else
+        return QObject::tr("This build of SocNetV cannot read zstd files.");
+#endif
+    }
+
+    CompressedFile *m_owner;
+};
+
+
+
+/**
+ * @brief The compressor state of a CompressedFile opened for writing.
+ */
+struct CompressedFileEncoder {
+#ifdef SOCNETV_USE_ZLIB
+    z_stream gzip;
+#endif
+#ifdef SOCNETV_USE_ZSTD
+    ZSTD_CStream *zstd;
+#endif
+    QByteArray output;
+};
+
+
+
+/**
+ * @brief Constructs a CompressedFile for fileName. Call open() to use it.
+ * @param fileName
+ */
+CompressedFile::CompressedFile(const QString &fileName) :
+    m_file(fileName),
+    m_compression(None),
+    m_readPosition(0),
+    m_decoder(0),
+    m_queuedBytes(0),
+    m_decoderDone(false),
+    m_decoderCancel(false),
+    m_chunkPosition(0),
+    m_encoder(0)
+{
+}
+
+
+CompressedFile::~CompressedFile() {
+    close();
+}
+
+
+/**
+ * @brief Sets the compression to write with. Reading detects it by itself.
+ * @param compression
+ */
+void CompressedFile::setCompression(const Compression &compression) {
+    m_compression = compression;
+}
+
+
+
+/**
+ * @brief Opens the file.
+ * For reading, it detects the compression and starts the decompression.
+ * It fails if the file is compressed with a method this build cannot read.
+ * For writing, it starts the compressor set by setCompression().
+ * Read-write mode is not supported for compressed files.
+ * @param mode
+ * @return
+ */
+bool CompressedFile::open(OpenMode mode) {
+    if ( isOpen() ) {
+        return false;
+    }
+    if ( ! m_file.open( mode & ~QIODevice::Text ) ) {
+        setErrorString( m_file.errorString() );
+        return false;
+    }
+    m_readPosition = 0;
+
+    if ( mode & QIODevice::ReadOnly ) {
+        if ( ! ( mode & QIODevice::WriteOnly ) ) {
+            m_compression = detect( m_file.peek(4) );
+        }
+        if ( m_compression != None && ( mode & QIODevice::WriteOnly ) ) {
+            setErrorString( tr("Compressed files cannot be opened for reading and writing.") );
+            m_file.close();
+            return false;
+        }
+        if ( m_compression != None && ! isSupported(m_compression) ) {
+            setErrorString( tr("This build of SocNetV cannot read %1 compressed files.")
+                            .arg( compressionName(m_compression) ) );
+            m_file.close();
+            return false;
+        }
+        if ( m_compression != None ) {
+            qDebug() << "CompressedFile::open() - reading"
+                     << compressionName(m_compression) << "file" << fileName();
+            decoderStart();
+        }
+    }
+    else if ( m_compression != None ) {
+        if ( ! encoderStart() ) {
+            m_file.close();
+            return false;
+        }
+    }
+
+    // Our reads go straight to readData(), which tracks the position itself.
+    return QIODevice::open( mode | QIODevice::Unbuffered );
+}
+
+
+
+/**
+ * @brief Closes the file.
+ * If writing compressed data, it flushes the compressor first.
+ */
+void CompressedFile::close() {
+    if ( ! isOpen() ) {
+        return;
+    }
+    // Let any QTextStream on this device flush before the compressor ends
+    emit aboutToClose();
+    if ( m_encoder ) {
+        encoderWrite(0, 0, true);
+        encoderEnd();
+    }
+    decoderStop();
+    m_file.close();
+    QIODevice::close();
+}
+
+
+
+/**
+ * @brief Seeks to pos.
+ * Compressed files seek forward by decompressing and dropping the data up to
+ * pos, and seek backward by decompressing the file again from its start.
+ * @param pos
+ * @return
+ */
+bool CompressedFile::seek(qint64 pos) {
+    if ( ! isOpen() || pos < 0 ) {
+        return false;
+    }
+    if ( openMode() & QIODevice::WriteOnly ) {
+        if ( isCompressed() ) {
+            return false;
+        }
+        return m_file.seek(pos) && QIODevice::seek(pos);
+    }
+
+    // If pos is within data peeked but not read yet, QIODevice keeps that data
+    // buffered, and we have to continue after it.
+    const qint64 target = ( pos >= QIODevice::pos() && pos < m_readPosition )
+            ? m_readPosition
+            : pos;
+
+    if ( ! isCompressed() ) {
+        if ( ! m_file.seek(target) ) {
+            return false;
+        }
+        m_readPosition = target;
+        return QIODevice::seek(pos);
+    }
+
+    if ( target < m_readPosition ) {
+        decoderStop();
+        if ( ! m_file.seek(0) ) {
+            return false;
+        }
+        m_readPosition = 0;
+        decoderStart();
+    }
+    QByteArray skipped(COMPRESSED_FILE_INPUT_SIZE, Qt::Uninitialized);
+    while ( m_readPosition < target ) {
+        const qint64 bytes = readData( skipped.data(),
+                                       qMin( (qint64) skipped.size(), target - m_readPosition ) );
+        if ( bytes <= 0 ) {
+            return false;
+        }
+    }
+    return QIODevice::seek(pos);
+}
+
+
+
+/**
+ * @brief Returns true if all data have been read.
+ * @return
+ */
+bool CompressedFile::atEnd() const {
+    if ( ! isCompressed() || ( openMode() & QIODevice::WriteOnly ) ) {
+        return QIODevice::atEnd() && m_file.atEnd();
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        if ( m_chunkPosition < m_chunk.size() || ! m_chunks.isEmpty() || ! m_decoderDone ) {
+            return false;
+        }
+    }
+    return QIODevice::atEnd();
+}
+
+
+
+/**
+ * @brief Returns the number of bytes which can be read without waiting.
+ * @return
+ */
+qint64 CompressedFile::bytesAvailable() const {
+    if ( ! isCompressed() ) {
+        return QIODevice::bytesAvailable();
+    }
+    QMutexLocker locker(&m_mutex);
+    return ( m_chunk.size() - m_chunkPosition ) + m_queuedBytes
+            + QIODevice::bytesAvailable();
+}
+
+
+
+/**
+ * @brief Returns the size of the file, or of the compressed data written so far.
+ * The decompressed size is not known in advance, so it is 0 for compressed
+ * files opened for reading, as for other devices of unknown size.
+ * @return
+ */
+qint64 CompressedFile::size() const {
+    if ( isCompressed() && ( openMode() & QIODevice::ReadOnly ) ) {
+        return 0;
+    }
+    return m_file.size();
+}
+
+
+
+/**
+ * @brief Maps the file to memory, like QFile::map().
+ * Returns 0 for compressed files, which have to be read instead.
+ * @param offset
+ * @param size
+ * @return
+ */
+uchar *CompressedFile::map(const qint64 &offset, const qint64 &size) {
+    if ( isCompressed() ) {
+        return 0;
+    }
+    return m_file.map(offset, size);
+}
+
+
+
+qint64 CompressedFile::readData(char *data, qint64 maxSize) {
+    if ( ! isCompressed() ) {
+        const qint64 bytes = m_file.read(data, maxSize);
+        if ( bytes > 0 ) {
+            m_readPosition += bytes;
+        }
+        return bytes;
+    }
+
+    qint64 copied = 0;
+    while ( copied < maxSize ) {
+        if ( m_chunkPosition >= m_chunk.size() ) {
+            QMutexLocker locker(&m_mutex);
+            while ( m_chunks.isEmpty() && ! m_decoderDone ) {
+                m_chunkReady.wait(&m_mutex);
+            }
+            if ( m_chunks.isEmpty() ) {
+                if ( ! m_decoderError.isEmpty() ) {
+                    setErrorString(m_decoderError);
+                    if ( copied == 0 ) {
+                        return -1;
+                    }
+                }
+                break;
+            }
+            m_chunk = m_chunks.dequeue();
+            m_queuedBytes -= m_chunk.size();
+            m_chunkPosition = 0;
+            m_chunkTaken.wakeOne();
+        }
+        const qint64 bytes = qMin( maxSize - copied,
+                                   (qint64) ( m_chunk.size() - m_chunkPosition ) );
+        std::memcpy( data + copied, m_chunk.constData() + m_chunkPosition, bytes );
+        m_chunkPosition += (int) bytes;
+        copied += bytes;
+    }
+    m_readPosition += copied;
+    return copied;
+}
+
+
+
+qint64 CompressedFile::writeData(const char *data, qint64 maxSize) {
+    if ( ! m_encoder ) {
+        return m_file.write(data, maxSize);
+    }
+    return encoderWrite(data, maxSize, false) ? maxSize : -1;
+}
+
+
+
+/**
+ * @brief Starts the decompression thread, from the current file position.
+ */
+void CompressedFile::decoderStart() {
+    m_chunks.clear();
+    m_queuedBytes = 0;
+    m_chunk.clear();
+    m_chunkPosition = 0;
+    m_decoderDone = false;
+    m_decoderCancel = false;
+    m_decoderError.clear();
+    m_decoder = new CompressedFileDecoder(this);
+    m_decoder->start();
+}
+
+
+/**
+ * @brief Stops the decompression thread, if any, and drops its queued data.
+ */
+void CompressedFile::decoderStop() {
+    if ( ! m_decoder ) {
+        return;
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_decoderCancel = true;
+        m_chunkTaken.wakeAll();
+    }
+    m_decoder->wait();
+    delete m_decoder;
+    m_decoder = 0;
+    m_chunks.clear();
+    m_queuedBytes = 0;
+    m_chunk.clear();
+    m_chunkPosition = 0;
+}
+
+
+/**
+ * @brief Called by the decoder thread to queue a chunk of decompressed data.
+ * Waits while the queue is full.
+ * @param chunk
+ * @return false if the decoder has to stop
+ */
+bool CompressedFile::decoderPush(const QByteArray &chunk) {
+    QMutexLocker locker(&m_mutex);
+    while ( m_chunks.size() >= COMPRESSED_FILE_MAX_CHUNKS && ! m_decoderCancel ) {
+        m_chunkTaken.wait(&m_mutex);
+    }
+    if ( m_decoderCancel ) {
+        return false;
+    }
+    m_chunks.enqueue(chunk);
+    m_queuedBytes += chunk.size();
+    m_chunkReady.wakeOne();
+    return true;
+}
+
+
+/**
+ * @brief Called by the decoder thread when it ends, with an error if any.
+ * @param error
+ */
+void CompressedFile::decoderFinish(const QString &error) {
+    if ( ! error.isEmpty() ) {
+        qDebug() << "CompressedFile::decoderFinish() - error:" << error;
+    }
+    QMutexLocker locker(&m_mutex);
+    m_decoderDone = true;
+    m_decoderError = error;
+    m_chunkReady.wakeAll();
+}
+
+
+bool CompressedFile::decoderCancelled() {
+    QMutexLocker locker(&m_mutex);
+    return m_decoderCancel;
+}
+
+
+
+/**
+ * @brief Starts the compressor of a file opened for writing.
+ * @return
+ */
+bool CompressedFile::encoderStart() {
+    if ( ! isSupported(m_compression) ) {
+        setErrorString( tr("This build of SocNetV cannot write %1 compressed files.")
+                        .arg( compressionName(m_compression) ) );
+        return false;
+    }
+    m_encoder = new CompressedFileEncoder;
+    m_encoder->output.resize(COMPRESSED_FILE_INPUT_SIZE);
+    bool ok = false;
+    switch (m_compression) {
+    case Gzip:
+#ifdef SOCNETV_USE_ZLIB
+        std::memset(&m_encoder->gzip, 0, sizeof(m_encoder->gzip));
+        // 15 + 16: the maximum window, with a gzip header
+        ok = ( deflateInit2(&m_encoder->gzip, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                            15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK );
+#endif
+        break;
+    case Zstd:
+#ifdef SOCNETV_USE_ZSTD
+        m_encoder->zstd = ZSTD_createCStream();
+        ok = ( m_encoder->zstd != 0 );
+#endif
+        break;
+    default:
+        break;
+    }
+    if ( ! ok ) {
+        setErrorString( tr("Cannot initialize the %1 compressor.")
+                        .arg( compressionName(m_compression) ) );
+        delete m_encoder;
+        m_encoder = 0;
+    }
+    return ok;
+}
+
+
+/**
+ * @brief Compresses size bytes of data, and writes the output to the file.
+ * @param data
+ * @param size
+ * @param finish true to end the compressed stream
+ * @return
+ */
+bool CompressedFile::encoderWrite(const char *data, const qint64 &size, const bool &finish) {
+    char *output = m_encoder->output.data();
+    const int outputSize = m_encoder->output.size();
+    switch (m_compression) {
+    case Gzip: {
+#ifdef SOCNETV_USE_ZLIB
+        z_stream &stream = m_encoder->gzip;
+        qint64 remaining = size;
+        do {
+            // zlib counts in uInt
+            const uInt block = (uInt) qMin( remaining, (qint64) COMPRESSED_FILE_CHUNK_SIZE );
+            stream.next_in = reinterpret_cast<Bytef *>( const_cast<char *>( data + ( size - remaining ) ) );
+            stream.avail_in = block;
+            remaining -= block;
+            const int flush = ( finish && remaining == 0 ) ? Z_FINISH : Z_NO_FLUSH;
+            do {
+                stream.next_out = reinterpret_cast<Bytef *>( output );
+                stream.avail_out = (uInt) outputSize;
+                if ( deflate(&stream, flush) == Z_STREAM_ERROR ) {
+                    setErrorString( tr("gzip compression failed.") );
+                    return false;
+                }
+                const qint64 produced = outputSize - (qint64) stream.avail_out;
+                if ( produced > 0 && m_file.write(output, produced) != produced ) {
+                    setErrorString( m_file.errorString() );
+                    return false;
+                }
+            } while ( stream.avail_out == 0 );
+        } while ( remaining > 0 );
+        return true;
+#else
+        break;
+#endif
+    }
+    case Zstd: {
+#ifdef SOCNETV_USE_ZSTD
+        ZSTD_inBuffer in = { data, (size_t) size, 0 };
+        for (;;) {
+            ZSTD_outBuffer out = { output, (size_t) outputSize, 0 };
+            const size_t left = ZSTD_compressStream2( m_encoder->zstd, &out, &in,
+                                                      finish ? ZSTD_e_end : ZSTD_e_continue );
+            if ( ZSTD_isError(left) ) {
+                setErrorString( tr("zstd compression failed: %1")
+                                .arg( ZSTD_getErrorName(left) ) );
+                return false;
+            }
+            if ( out.pos > 0 && m_file.write(output, (qint64) out.pos) != (qint64) out.pos ) {
+                setErrorString( m_file.errorString() );
+                return false;
+            }
+            if ( finish ? left == 0 : in.pos == in.size ) {
+                return true;
+            }
+        }
+#else
+        break;
+#endif
+    }
+    default:
+        break;
+    }
+    return false;
+}
+
+
+/**
+ * @brief Frees the compressor.
+ */
+void CompressedFile::encoderEnd() {
+    switch (m_compression) {
+    case Gzip:
+#ifdef SOCNETV_USE_ZLIB
+        deflateEnd(&m_encoder->gzip);
+#endif
+        break;
+    case Zstd:
+#ifdef SOCNETV_USE_ZSTD
+        ZSTD_freeCStream(m_encoder->zstd);
+#endif
+        break;
+    default:
+        break;
+    }
+    delete m_encoder;
+    m_encoder = 0;
+}
+
+
+
+/**
+ * @brief Detects the compression from the first bytes of a file.
+ * @param magic
+ * @return
+ */
+CompressedFile::Compression CompressedFile::detect(const QByteArray &magic) {
+    if ( magic.size() >= 2 && (uchar) magic[0] == 0x1f && (uchar) magic[1] == 0x8b ) {
+        return Gzip;
+    }
+    if ( magic.size() >= 4 && (uchar) magic[0] == 0x28 && (uchar) magic[1] == 0xb5
+         && (uchar) magic[2] == 0x2f && (uchar) magic[3] == 0xfd ) {
+        return Zstd;
+    }
+    return None;
+}
+
+
+/**
+ * @brief Detects the compression of the file fileName, by its magic bytes.
+ * @param fileName
+ * @return
+ */
+CompressedFile::Compression CompressedFile::detect(const QString &fileName) {
+    QFile file(fileName);
+    if ( ! file.open(QIODevice::ReadOnly) ) {
+        return None;
+    }
+    return detect( file.read(4) );
+}
+
+
+/**
+ * @brief Returns the compression to write fileName with, by its extension:
+ * gzip for .gz, zstd for .zst, none otherwise.
+ * @param fileName
+ * @return
+ */
+CompressedFile::Compression CompressedFile::compressionForFileName(const QString &fileName) {
+    if ( fileName.endsWith(".gz", Qt::CaseInsensitive) ) {
+        return Gzip;
+    }
+    if ( fileName.endsWith(".zst", Qt::CaseInsensitive)
+         || fileName.endsWith(".zstd", Qt::CaseInsensitive) ) {
+        return Zstd;
+    }
+    return None;
+}
+
+
+/**
+ * @brief Returns fileName without its compression extension, if any,
+ * i.e. net.graphml for net.graphml.gz
+ * @param fileName
+ * @return
+ */
+QString CompressedFile::fileNameWithoutCompression(const QString &fileName) {
+    if ( compressionForFileName(fileName) == None ) {
+        return fileName;
+    }
+    return fileName.left( fileName.lastIndexOf('.') );
+}
+
+
+/**
+ * @brief Returns true if this build can read and write compression.
+ * @param compression
+ * @return
+ */
+bool CompressedFile::isSupported(const Compression &compression) {
+    switch (compression) {
+    case None:
+        return true;
+    case Gzip:
+#ifdef SOCNETV_USE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case Zstd:
+#ifdef SOCNETV_USE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+
+QString CompressedFile::compressionName(const Compression &compression) {
+    switch (compression) {
+    case Gzip:
+        return "gzip";
+    case Zstd:
+        return "zstd";
+    default:
+        return "none";
+    }
+}
+
+
+/**
+ * @brief Returns the size of the chunks of decompressed data the worker
+ * thread hands to the reader, see decoderPush()
+ * @return
+ */
+int CompressedFile::chunkSize() {
+    return COMPRESSED_FILE_CHUNK_SIZE;
+}
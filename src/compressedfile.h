@@ -0,0 +1,130 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         compressedfile.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef COMPRESSEDFILE_H
+#define COMPRESSEDFILE_H
+
+#include <QIODevice>
+#include <QFile>
+#include <QByteArray>
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+
+class CompressedFileDecoder;
+struct CompressedFileEncoder;
+
+
+/**
+ * @brief The CompressedFile class
+ * A file device which reads and writes gzip and zstd compressed files
+ * transparently, so that every loader and saver can use it in place of QFile.
+ * When opened for reading, the compression is detected by the magic bytes of
+ * the file, and files which are not compressed are read as they are.
+ * Compressed files are decompressed by a worker thread, which keeps a few
+ * chunks ahead of the reader, so decompression runs in parallel with parsing.
+ * Seeking forward skips decompressed data, and seeking backward restarts the
+ * decompression, so readers which rewind the file with seek(0) still work.
+ * When opened for writing, the data are compressed with the compression set
+ * by setCompression(), none by default.
+ * gzip needs zlib (SOCNETV_USE_ZLIB) and zstd needs libzstd (SOCNETV_USE_ZSTD).
+ */
+class CompressedFile : public QIODevice
+{
+public:
+    enum Compression {
+        None = 0,
+        Gzip = 1,
+        Zstd = 2
+    };
+
+    explicit CompressedFile(const QString &fileName);
+    ~CompressedFile() override;
+
+    QString fileName() const { return m_file.fileName(); }
+
+    void setCompression(const Compression &compression);
+    Compression compression() const { return m_compression; }
+    bool isCompressed() const { return m_compression != None; }
+
+    bool open(OpenMode mode) override;
+    void close() override;
+
+    bool isSequential() const override { return false; }
+    bool seek(qint64 pos) override;
+    bool atEnd() const override;
+    qint64 bytesAvailable() const override;
+    qint64 size() const override;
+
+    uchar *map(const qint64 &offset, const qint64 &size);
+
+    static Compression detect(const QByteArray &magic);
+    static Compression detect(const QString &fileName);
+    static Compression compressionForFileName(const QString &fileName);
+    static QString fileNameWithoutCompression(const QString &fileName);
+    static bool isSupported(const Compression &compression);
+    static QString compressionName(const Compression &compression);
+    static int chunkSize();
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    friend class CompressedFileDecoder;
+
+    void decoderStart();
+    void decoderStop();
+    bool decoderPush(const QByteArray &chunk);
+    void decoderFinish(const QString &error);
+    bool decoderCancelled();
+
+    bool encoderStart();
+    bool encoderWrite(const char *data, const qint64 &size, const bool &finish);
+    void encoderEnd();
+
+    QFile m_file;
+    Compression m_compression;
+    qint64 m_readPosition;
+
+    CompressedFileDecoder *m_decoder;
+    mutable QMutex m_mutex;
+    QWaitCondition m_chunkReady;
+    QWaitCondition m_chunkTaken;
+    QQueue<QByteArray> m_chunks;
+    qint64 m_queuedBytes;
+    bool m_decoderDone;
+    bool m_decoderCancel;
+    QString m_decoderError;
+    QByteArray m_chunk;
+    int m_chunkPosition;
+
+    CompressedFileEncoder *m_encoder;
+};
+
+#endif // COMPRESSEDFILE_H
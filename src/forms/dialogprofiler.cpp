@@ -0,0 +1,149 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         dialogprofiler.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include <QtWidgets>
+#include "dialogprofiler.h"
+#include "graphtrace.h"
+
+
+/**
+ * @brief Creates the profiler, which exports to dataDir by default
+ * @param dataDir
+ * @param parent
+ */
+DialogProfiler::DialogProfiler(const QString &dataDir, QWidget *parent) :
+    QDialog(parent),
+    m_dataDir(dataDir)
+{
+    m_table = new QTableWidget(0, 9);
+    m_table->setHorizontalHeaderLabels( QStringList()
+                                        << tr("Started") << tr("Run")
+                                        << tr("Parameters") << tr("N") << tr("E")
+                                        << tr("Wall ms") << tr("CPU ms")
+                                        << tr("Threads") << tr("Peak MB") );
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setSortingEnabled(true);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    m_table->setToolTip(tr("Every analysis, layout, file operation and report run "
+                           "in this session. \nCPU time is of all threads; "
+                           "Peak MB is the memory held by matrices and distance stores."));
+
+    m_refreshButton = new QPushButton(tr("&Refresh"));
+    m_clearButton = new QPushButton(tr("&Clear"));
+    m_exportButton = new QPushButton(tr("&Export JSON..."));
+
+    m_buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+    m_buttonBox->addButton(m_refreshButton, QDialogButtonBox::ActionRole);
+    m_buttonBox->addButton(m_clearButton, QDialogButtonBox::ActionRole);
+    m_buttonBox->addButton(m_exportButton, QDialogButtonBox::ActionRole);
+
+    connect(m_refreshButton, SIGNAL(clicked()), this, SLOT(refresh()));
+    connect(m_clearButton, SIGNAL(clicked()), this, SLOT(clear()));
+    connect(m_exportButton, SIGNAL(clicked()), this, SLOT(exportJson()));
+    connect(m_buttonBox, SIGNAL(rejected()), this, SLOT(reject()));
+
+    QVBoxLayout *mainLayout = new QVBoxLayout;
+    mainLayout->addWidget(m_table);
+    mainLayout->addWidget(m_buttonBox);
+    setLayout(mainLayout);
+
+    setWindowTitle(tr("Analysis Profiler"));
+    resize(900, 500);
+
+    refresh();
+}
+
+
+/**
+ * @brief Lists the runs recorded so far, latest first
+ */
+void DialogProfiler::refresh() {
+    const QVector<GraphTrace::Run> runs = GraphTrace::runs();
+
+    // numeric items, so that sorting by a column sorts by value
+    const auto number = [](const qreal &value, const int &decimals) {
+        QTableWidgetItem *item = new QTableWidgetItem;
+        item->setData(Qt::DisplayRole, decimals > 0
+                      ? QVariant( QString::number(value, 'f', decimals).toDouble() )
+                      : QVariant( (qlonglong) value ));
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        return item;
+    };
+
+    m_table->setSortingEnabled(false);
+    m_table->setRowCount( runs.size() );
+
+    for (int i = 0; i < runs.size(); ++i) {
+        const GraphTrace::Run &run = runs[ runs.size() - 1 - i ];
+        m_table->setItem(i, 0, new QTableWidgetItem( run.started.toString("hh:mm:ss") ));
+        m_table->setItem(i, 1, new QTableWidgetItem( run.phase ));
+        m_table->setItem(i, 2, new QTableWidgetItem( run.parameters ));
+        m_table->setItem(i, 3, run.vertices < 0 ? new QTableWidgetItem : number(run.vertices, 0));
+        m_table->setItem(i, 4, run.edges < 0 ? new QTableWidgetItem : number(run.edges, 0));
+        m_table->setItem(i, 5, number(run.wallNsecs / 1e6, 3));
+        m_table->setItem(i, 6, number(run.cpuNsecs / 1e6, 3));
+        m_table->setItem(i, 7, number(run.threads, 0));
+        m_table->setItem(i, 8, number(run.peakBytes / 1048576.0, 1));
+    }
+
+    m_table->setSortingEnabled(true);
+    m_table->resizeColumnsToContents();
+}
+
+
+/**
+ * @brief Forgets the runs recorded so far
+ */
+void DialogProfiler::clear() {
+    GraphTrace::clear();
+    refresh();
+}
+
+
+/**
+ * @brief Asks for a file name, and writes the runs to it as JSON
+ */
+void DialogProfiler::exportJson() {
+    const QString dateTime = QDateTime::currentDateTime().toString("yy-MM-dd-hhmmss");
+    const QString fileName = QFileDialog::getSaveFileName(
+                this, tr("Export profile to JSON file"),
+                m_dataDir + "socnetv-profile-" + dateTime + ".json",
+                tr("JSON (*.json);;All (*)"));
+    if ( fileName.isEmpty() ) {
+        return;
+    }
+    QFile file(fileName);
+    if ( !file.open(QIODevice::WriteOnly) || file.write( GraphTrace::runsJson() ) < 0 ) {
+        QMessageBox::warning(this, tr("Export profile"),
+                             tr("Could not write to %1").arg(fileName));
+        return;
+    }
+    file.close();
+}
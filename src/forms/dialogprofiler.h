@@ -0,0 +1,68 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         dialogprofiler.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef DIALOGPROFILER_H
+#define DIALOGPROFILER_H
+
+#include <QDialog>
+
+class QTableWidget;
+class QPushButton;
+class QDialogButtonBox;
+
+
+/**
+ * @brief The DialogProfiler class
+ * The Analysis Profiler: lists every analysis, layout, file operation and
+ * report run so far, as recorded by GraphTrace, with the size of the network,
+ * the parameters, wall and CPU time, threads and the peak memory held by
+ * matrices and distance stores. The list can be exported as JSON.
+ */
+class DialogProfiler : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit DialogProfiler(const QString &dataDir, QWidget *parent = Q_NULLPTR);
+
+public slots:
+    void refresh();
+
+private slots:
+    void clear();
+    void exportJson();
+
+private:
+    QString m_dataDir;
+    QTableWidget *m_table;
+    QPushButton *m_refreshButton;
+    QPushButton *m_clearButton;
+    QPushButton *m_exportButton;
+    QDialogButtonBox *m_buttonBox;
+};
+
+#endif
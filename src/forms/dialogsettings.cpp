@@ -109,6 +109,8 @@ DialogSettings::DialogSettings(QMap<QString, QString> &appSettings,
                 (appSettings["showProgressBar"] == "true") ? true:false
                 );
 
+    ui->analysisThreadsSpin->setValue( appSettings["analysisThreads"].toInt() );
+
 
     /**
       * Style options
@@ -387,6 +389,9 @@ DialogSettings::DialogSettings(QMap<QString, QString> &appSettings,
     connect (ui->progressDialogChkBox, &QCheckBox::stateChanged,
              this, &DialogSettings::setProgressDialog);
 
+    connect (ui->analysisThreadsSpin, SIGNAL(valueChanged(int)),
+             this, SLOT(getAnalysisThreads(int)));
+
     connect (ui->showToolBarChkBox, &QCheckBox::stateChanged,
              this, &DialogSettings::setToolBar);
 
@@ -570,6 +575,17 @@ void DialogSettings::getReportsChartType(const int &type){
 
 
 
+/**
+ * @brief Gets the number of threads of the parallel analyses
+ * @param threads 0 for all CPU cores
+ */
+void DialogSettings::getAnalysisThreads(const int &threads) {
+    m_appSettings["analysisThreads"]= QString::number(threads);
+    emit setAnalysisThreads(threads);
+}
+
+
+
 /**
  * @brief DialogSettings::getCanvasBgColor
  * Opens a QColorDialog for the user to select a new bg color
@@ -57,6 +57,8 @@ public slots:
     void getReportsLabelsLength(const int &length);
     void getReportsChartType(const int &type);
 
+    void getAnalysisThreads(const int &threads);
+
     void getCanvasBgColor();
     void getCanvasBgImage();
     void getCanvasUpdateMode(const QString &text);
@@ -95,6 +97,7 @@ signals:
     void setStyleSheetDefault(const bool &toggle);
 
     void setProgressDialog(bool);
+    void setAnalysisThreads(const int &threads);
     void setToolBar(bool);
     void setStatusBar(bool);
     void setPrintLogo(bool);
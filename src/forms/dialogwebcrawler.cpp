@@ -63,6 +63,8 @@ DialogWebCrawler::DialogWebCrawler(QWidget *parent) : QDialog (parent)
 
     ui.selfLinksCheckBox->setChecked(false);
     ui.waitCheckBox ->setChecked(true);
+    ui.checkpointsCheckBox->setChecked(false);
+    ui.resumeCheckBox->setChecked(false);
 
     connect (ui.seedUrlEdit, &QLineEdit::textChanged,
                      this, &DialogWebCrawler::checkErrors);
@@ -406,6 +408,8 @@ void DialogWebCrawler::getUserChoices(){
                       ui.waitCheckBox ->isChecked(),
                       ui.extLinksIncludedCheckBox->isChecked(),
                       ui.extLinksCheckBox->isChecked(),
-                      ui.socialLinksCheckBox ->isChecked()
+                      ui.socialLinksCheckBox ->isChecked(),
+                      ui.checkpointsCheckBox->isChecked(),
+                      ui.resumeCheckBox->isChecked()
                       );
 }
@@ -61,7 +61,9 @@ signals:
                       const bool &extLinksIncluded,
                       const bool &extLinksCrawl,
                       const bool &socialLinks,
-                      const bool &delayedRequests
+                      const bool &delayedRequests,
+                      const bool &checkpoints,
+                      const bool &resume
                       );
     void webCrawlerDialogError(QString);
 private:
@@ -64,6 +64,7 @@ enum FileType {
     EDGELIST_WEIGHTED = 7,  // .CSV, .TXT, .LIST, LST, WLST
     EDGELIST_SIMPLE   = 8,  // .CSV, .TXT, .LIST, LST
     TWOMODE           = 9,  // .2SM .AFF
+    BINARY            = 10, // .SNB (native binary snapshot)
     UNRECOGNIZED      =-1  // UNRECOGNIZED FILE FORMAT
 };
 
@@ -104,10 +105,18 @@ enum NetworkRequestType {
 
 };
 
+// Level of detail of the canvas items, in on-screen pixels.
+// Smaller nodes are drawn as plain squares, shorter edges as hairlines
+// without arrows, smaller text is not drawn at all.
+static const double LOD_NODE_MIN_SIZE = 4;
+static const double LOD_EDGE_MIN_LENGTH = 16;
+static const double LOD_TEXT_MIN_SIZE = 5;
+
 static const int SUBGRAPH_CLIQUE = 1;
 static const int SUBGRAPH_STAR   = 2;
 static const int SUBGRAPH_CYCLE  = 3;
 static const int SUBGRAPH_LINE   = 4;
+static const int SUBGRAPH_INDUCED = 5;
 
 static const int MATRIX_ADJACENCY        = 1;
 static const int MATRIX_DISTANCES        = 2;
@@ -124,6 +133,10 @@ static const int MATRIX_DISTANCES_JACCARD= 14;
 static const int MATRIX_DISTANCES_HAMMING= 15;
 static const int MATRIX_DISTANCES_CHEBYSHEV= 16;
 
+// Matrices with more actors are written in HTML reports as pages of
+// MATRIX_HTML_PAGE_SIZE rows and columns
+static const int MATRIX_HTML_PAGE_SIZE = 100;
+
 
 
 
@@ -159,36 +172,6 @@ public:
     ~MyEdge(){}
 };
 
-class GraphDistance
-{
-public:
-    int target;
-    int distance;
-
-    GraphDistance(int t, int dist)
-        : target(t), distance(dist)
-    {
-
-    }
-};
-
-
-// implement a min-priority queue
-class GraphDistancesCompare {
-public:
-    bool operator()(GraphDistance& t1, GraphDistance& t2)
-    {
-        if (t1.distance == t2.distance)
-            return t1.target > t2.target;
-        return t1.distance > t2.distance;  //minimum priority
-        // Returns true if t1 is closer than t2
-        // else
-    }
-};
-
-
-
-
 class PairVF
 {
 public:
@@ -32,6 +32,7 @@
 
 #include <QtGlobal>
 #include <QFile>
+#include <QSaveFile>
 #include <QDir>
 #include <QtMath>
 #include <QPointF>
@@ -40,6 +41,8 @@
 #include <QColor>
 #include <QTextCodec>
 #include <QFileInfo>
+#include <QDataStream>
+#include <QCryptographicHash>
 
 #include <QAbstractSeries>
 #include <QSplineSeries>
@@ -50,18 +53,30 @@
 #include <QValueAxis>
 #include <QPixmap>
 #include <QElapsedTimer>
+#include <QAtomicInt>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
+#include <QTimer>
 
 #include <cstdlib>		//allows the use of RAND_MAX macro 
 
 #include <queue>		//for BFS queue Q
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+#include <limits>
 #include <ctime>        // for randomizeThings
 
 #include "chart.h"
+#include "graphbinaryfile.h"
+#include "compressedfile.h"
+#include "graphfilewriter.h"
+#include "graphtrace.h"
+#include "graphscheduler.h"
 
 #include "graphicsnode.h"
 #include "graphicsedge.h"
+#include "graphcliques.h"
 
 
 
@@ -75,9 +90,59 @@ Graph::Graph() {
 
     qRegisterMetaType<NetworkRequestType>("NetworkRequestType");
 
+    // The background job signals from a worker thread, the results are
+    // attached in the thread of the graph
+    connect(this, &Graph::signalBackgroundAnalysisDone,
+            this, &Graph::backgroundAnalysisApply, Qt::QueuedConnection);
+
     m_totalVertices=0;
     m_totalEdges=0;
 
+    m_graphVersion=0;
+    m_componentsArcVersion=0;
+
+    m_tieCountersValid=false;
+    m_tieCountersVersion=0;
+    m_tieCountersArcVersion=0;
+    m_tiesWeight=0;
+    m_tiesWeightReciprocated=0;
+    m_tiesNonSymmetric=0;
+    m_tiePairs=0;
+    m_tiePairsReciprocated=0;
+    m_tieArcs=0;
+
+    m_distancesCompact=false;
+    m_distancesIncremental=true;
+    m_distancesIncrementalCentralities=false;
+    m_distancesIncrementalVersion=0;
+    m_distancesIncrementalRelation=0;
+
+    m_centralityBetweennessSamples=0;
+    m_centralityBetweennessSampled=0;
+    m_backgroundParameters=-1;
+    m_backgroundDropIsolates=false;
+    m_graphBulkDepth=0;
+    m_graphBulkUniqueEdges=false;
+    m_randomSeed=0;
+    m_random.seed( (quint64) QDateTime::currentMSecsSinceEpoch() );
+    m_prestigePageRankGaussSeidel=false;
+    m_centralityEigenvectorTolerance=0.0000001;
+    m_centralityEigenvectorMaxIterations=500;
+    m_centralityEigenvectorLanczos=false;
+    m_graphMatrixAdjacencySparse=false;
+    m_graphMatrixAdjacencySparseDensity=0.05;
+    m_layoutForceDirectedTheta=0.5;
+    m_layoutFrameRate=30;
+    m_layoutAnimateMaxVertices=5000;
+    m_graphContentHashVersion=0;
+    m_graphContentHashRelation=-1;
+    m_distancesStoreSize=0;
+    m_distancesStoreRelation=0;
+    m_reachValid=false;
+    m_reachRelation=0;
+    m_reachVersion=0;
+    m_reachWords=0;
+
     // We do init these two vars here, because they only get their values
     // on MW::resizeEvent which might happen after we have started creating
     // nodes.
@@ -112,20 +177,20 @@ Graph::Graph() {
 
     calculatedDistances=false;
     calculatedIsolates = false;
-    calculatedDP=false;
-    calculatedDC=false;
-    calculatedIC=false;
-    calculatedEVC=false;
+    calculatedBCApproximate=false;
+    calculatedEccentricity=false;
     calculatedCentralities=false;
-    calculatedIRCC=false;
-    calculatedPP=false;
-    calculatedPRP=false;
     calculatedTriad=false;
+    m_graphDistancesParameters = -1;
+    m_graphCentralitiesParameters = -1;
 
     m_reportsDataDir = "";
     m_reportsRealPrecision = 6;
     m_reportsLabelLength = 8;
     m_reportsChartType  = ChartType::Spline;
+    m_reportsChartPoints = 256;
+    m_reportsChartImagePoints = 2048;
+    m_reportsChartBars = 64;
 
     m_vertexClicked = 0;
     m_clickedEdge.source=0;
@@ -135,9 +200,23 @@ Graph::Graph() {
 
     web_crawler = 0;
 
+    m_crawler_wake_at = -1;
+    m_crawler_run = 0;
+    m_crawler_max_urls = 0;
+    m_crawler_delayed_requests = 0;
+    m_crawler_visited_urls = 0;
+    m_crawler_max_requests = 8;
+    m_crawler_max_host_requests = 2;
+    m_crawler_max_frontier = 1000000;
+    m_crawler_checkpoints = false;
+    m_crawler_checkpoint_pending = false;
+    m_crawler_checkpoint_pages = 500;
+    m_crawler_checkpoint_at = 0;
+
     m_graphFileFormatExportSupported<< FileType::GRAPHML
                                     << FileType::PAJEK
-                                    << FileType::ADJACENCY;
+                                    << FileType::ADJACENCY
+                                    << FileType::BINARY;
 
     randomizeThings();
 
@@ -271,6 +350,16 @@ Graph::Graph() {
  * @brief Graph::~Graph
  */
 Graph::~Graph() {
+    qDebug()<<"Graph::~Graph() - Waiting for background analysis";
+    m_backgroundAbort.storeRelease(1);
+    m_backgroundJob.waitForFinished();
+
+    // i.e. socnetv --batch exits as soon as the file is loaded
+    if ( file_parserThread.isRunning() ) {
+        file_parserThread.quit();
+        file_parserThread.wait();
+    }
+
     qDebug()<<"Graph::~Graph() - Calling clear()";
     clear("exit");
 
@@ -290,6 +379,34 @@ void Graph::clear(const QString &reason) {
     m_graph.clear();
     vpos.clear();
 
+    m_csr.reset();
+    m_csrUnion.reset();
+    m_labelIndex.clear();
+    m_weightIndex.clear();
+    m_distancesIncrementalBase.reset();
+    m_distancesIncrementalArcs.clear();
+    m_graphVersion++;
+
+    // Drop any pending bulk construction, its queued items are gone
+    m_graphBulkDepth=0;
+    m_graphBulkUniqueEdges=false;
+    m_graphBulkDeferred.clear();
+
+    // The results of a running background job would be stale
+    m_backgroundAbort.storeRelease(1);
+
+    distancesStoreClear();
+
+    m_components.clear();
+
+    m_prominenceScoreIndex.clear();
+
+    m_tieCountersValid = false;
+
+    m_reachValid = false;
+    m_reachComponent.clear();
+    vector<quint64>().swap(m_reachRows);
+
     discreteDPs.clear();
     discreteSDCs.clear();
     discreteCCs.clear();
@@ -324,6 +441,8 @@ void Graph::clear(const QString &reason) {
         qDebug() << "\n\n\n\n Graph::clear()  clearing AM\n\n\n";
         AM.clear();
     }
+    SAM.clear();
+    m_graphMatrixAdjacencySparse=false;
     if ( invM.size() > 0) {
         qDebug() << "\n\n\n\n Graph::clear()  clearing invM\n\n\n";
         invM.clear();
@@ -399,14 +518,14 @@ void Graph::clear(const QString &reason) {
     calculatedIsolates = false;
 
     calculatedCentralities=false;
-    calculatedDP=false;
-    calculatedDC=false;
-    calculatedIC=false;
-    calculatedEVC=false;
-    calculatedIRCC=false;
-    calculatedPP=false;
-    calculatedPRP=false;
+    calculatedBCApproximate=false;
+    calculatedEccentricity=false;
     calculatedTriad=false;
+    m_graphDistancesParameters = -1;
+    m_graphCentralitiesParameters = -1;
+
+    m_resultCache.clear();
+    m_graphContentHash.clear();
 
     m_graphHasChanged=false;
 
@@ -419,10 +538,6 @@ void Graph::clear(const QString &reason) {
     graphLoadedTerminateParserThreads("clear");
     webCrawlTerminateThreads("clear");
 
-    //    if ( urlQueue->size() > 0 ) {
-    //        urlQueue->clear();
-    //    }
-
 
     if ( reason != "exit") {
         qDebug()<< "Graph::clear() - Clearing end. Emitting graphSetModified()";
@@ -516,7 +631,18 @@ double Graph::canvasVisibleY(const double &y) const {
  * inside the canvas usable area
  */
 double Graph::canvasRandomX()  const {
-    qreal randX = static_cast <qreal> ( rand() % static_cast <int> (canvasWidth) );
+    return canvasRandomX(m_random);
+}
+
+
+/**
+ * @brief Returns a random x-coordinate inside the canvas usable area,
+ * drawn from the given generator
+ * @param rng
+ * @return
+ */
+double Graph::canvasRandomX(GraphRandom &rng) const {
+    qreal randX = static_cast <qreal> ( rng.bounded( static_cast <int> (canvasWidth) ) );
     return qMin ( canvasWidth - 30.0 , qMax ( 30.0 , randX ) );
 }
 
@@ -528,7 +654,18 @@ double Graph::canvasRandomX()  const {
  * inside the canvas usable area
  */
 double Graph::canvasRandomY() const {
-    qreal randY = static_cast <qreal> ( rand() % static_cast <int> (canvasHeight) );
+    return canvasRandomY(m_random);
+}
+
+
+/**
+ * @brief Returns a random y-coordinate inside the canvas usable area,
+ * drawn from the given generator
+ * @param rng
+ * @return
+ */
+double Graph::canvasRandomY(GraphRandom &rng) const {
+    qreal randY = static_cast <qreal> ( rng.bounded( static_cast <int> (canvasHeight) ) );
     return qMin ( canvasHeight - 30.0 , qMax (30.0 , randY ) );
 }
 
@@ -538,8 +675,8 @@ double Graph::canvasRandomY() const {
 /**
  * @brief Changes m_curRelation to relNum.
  * If relNum==RAND_MAX, changes to last added relation.
- * Then calls GraphVertex::relationSet() for all enabled vertices, to disable edges
- * of the old relation and enable edges of the new relation
+ * Then calls GraphVertex::relationSet() for all vertices, which only
+ * selects the edge partition of the new relation, without touching any edge.
  * Then, if notifyMW==TRUE, it signals signalRelationChangedToGW(int),
  * which disables/enables the on screen edges, and
  * Called from MW when the user selects a relation in the combo box.
@@ -566,16 +703,17 @@ void Graph::relationSet(int relNum, const bool notifyMW){
         return;
     }
 
+    // The tie counters describe the current relation only
+    m_tieCountersValid = false;
+
+    // Disabled vertices follow too, so that they are in the right
+    // relation when enabled again.
     VList::const_iterator it;
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        qDebug() << "++ Graph::relationSet(int) - changing relation of vertex"
-                 << (*it)->name()
-                 << "to" << relNum;
-        if ( ! (*it)->isEnabled() )
-            continue;
         (*it)->relationSet(relNum);
     }
     m_curRelation = relNum;
+    m_graphVersion++;
 
     // Check if isWeighted so that multiple-relation networks are properly loaded.
     graphIsWeighted();
@@ -584,7 +722,10 @@ void Graph::relationSet(int relNum, const bool notifyMW){
         //notify MW to change combo box relation name
         emit signalRelationChangedToMW(m_curRelation);
         //notify GW to disable/enable the on screen edges.
-        emit signalRelationChangedToGW(m_curRelation);
+        const int relation = m_curRelation;
+        graphBulkDefer( [=] () {
+            emit signalRelationChangedToGW(relation);
+        } );
         qDebug()<<"Graph::relationSet() - Calling graphSetModified()";
         graphSetModified(GraphChange::ChangedEdges);
     }
@@ -755,7 +896,7 @@ void Graph::vertexCreate(const int &number,
 
     int value = 1;
 
-    qDebug() << "Graph::vertexCreate() - vertex:" << number
+    qCHotDebug(lcGraph) << "Graph::vertexCreate() - vertex:" << number
              << "shape:" << shape
              << "icon:" << iconPath
              << "signalMW:" << signalMW
@@ -784,25 +925,29 @@ void Graph::vertexCreate(const int &number,
                     iconPath
                     )
                 );
+    m_labelIndex.insert(number, label);
 
     m_totalVertices++;
 
-
-    emit signalDrawNode( p,
-                         number,
-                         size,
-                         shape,
-                         iconPath,
-                         color,
-                         numColor,
-                         numSize,
-                         initVertexNumberDistance,
-                         label,
-                         labelColor,
-                         labelSize,
-                         initVertexLabelDistance);
-
-    qDebug() << "Graph::vertexCreate() - Added new vertex:" << number
+    const int numDistance = initVertexNumberDistance;
+    const int labelDistance = initVertexLabelDistance;
+    graphBulkDefer( [=] () {
+        emit signalDrawNode( p,
+                             number,
+                             size,
+                             shape,
+                             iconPath,
+                             color,
+                             numColor,
+                             numSize,
+                             numDistance,
+                             label,
+                             labelColor,
+                             labelSize,
+                             labelDistance);
+    } );
+
+    qCHotDebug(lcGraph) << "Graph::vertexCreate() - Added new vertex:" << number
              << "Calling graphSetModified().";
 
     graphSetModified(GraphChange::ChangedVertices, signalMW);
@@ -954,7 +1099,7 @@ int Graph::vertexNumberMin() {
  * @return vertex pos or -1
  */
 int Graph::vertexExists(const int &v1){
-    qDebug () << "Graph::vertexExists() - check for number v:" << v1
+    qCHotDebug(lcGraph) << "Graph::vertexExists() - check for number v:" << v1
               <<  " with vpos " << vpos[v1]
                   << " named " << m_graph[ vpos[v1] ] ->name();
     if ( vpos.contains(v1) ) {
@@ -962,7 +1107,7 @@ int Graph::vertexExists(const int &v1){
             return vpos[v1];
         }
         else{
-            qDebug () << "Graph::vertexExists() - error in vpos for number v:" << v1;
+            qCHotDebug(lcGraph) << "Graph::vertexExists() - error in vpos for number v:" << v1;
         }
     }
 
@@ -972,24 +1117,28 @@ int Graph::vertexExists(const int &v1){
 
 
 /**
- * @brief Checks if there is a vertex with a specific label in the graph
- * Returns the vpos or -1
- * Complexity:  O(N)
+ * @brief Checks if there is a vertex with a specific label in the graph,
+ * ignoring case. A vertex with exactly this label is found in O(1), through
+ * m_labelIndex. Otherwise, the first vertex whose label contains it is
+ * returned, found through the trigrams of the labels.
  * @param label
  * @return vpos or -1
  */
 int Graph::vertexExists(const QString &label){
-    qDebug ()<<"Graph::vertexExists() - check for label:"<< label.toUtf8()  ;
-    VList::const_iterator it;
-    int i=0;
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        if ( (*it) ->label().contains( label, Qt::CaseInsensitive ) )  {
-            //            qDebug()<< "Graph: vertexExists() at pos %i" << i;
-            return i;
+    qCHotDebug(lcGraph)<<"Graph::vertexExists() - check for label:"<< label.toUtf8()  ;
+    const int v = m_labelIndex.find(label);
+    if ( v != -1 ) {
+        return vpos.value(v, -1);
+    }
+    int first = -1;
+    const QList<int> found = m_labelIndex.search(label);
+    for (int i = 0; i < found.size(); ++i) {
+        const int pos = vpos.value(found.at(i), -1);
+        if ( pos != -1 && ( first == -1 || pos < first ) ) {
+            first = pos;
         }
-        i++;
     }
-    return -1;
+    return first;
 }
 
 
@@ -1097,8 +1246,6 @@ bool Graph::vertexFindByIndexScore(const int &index, const QStringList &threshol
 
     bool searchResult = false;
 
-    VList::const_iterator it;
-
     QString thresholdStr="";
 
     bool gtThan  = false;
@@ -1107,7 +1254,6 @@ bool Graph::vertexFindByIndexScore(const int &index, const QStringList &threshol
     bool lsEqual = false;
     bool convertedOk=false;
     qreal threshold=0;
-    qreal score=0;
 
     //FIXME
     bool dropIsolates=false;
@@ -1153,6 +1299,8 @@ bool Graph::vertexFindByIndexScore(const int &index, const QStringList &threshol
         break;
     }
 
+    const GraphScoreIndex &scoreIndex = prominenceScoreIndex(index);
+
     for (int i = 0; i < thresholds.size(); ++i) {
 
         thresholdStr = thresholds.at(i);
@@ -1180,7 +1328,7 @@ bool Graph::vertexFindByIndexScore(const int &index, const QStringList &threshol
         else if (thresholdStr.startsWith("<=")) {
             lsEqual = true;
             thresholdStr.remove("<=");
-            qDebug()<< "Graph::vertexFindByIndexScore() - thresholdStr starts with >=";
+            qDebug()<< "Graph::vertexFindByIndexScore() - thresholdStr starts with <=";
         }
         else if (thresholdStr.startsWith("<"))  {
             lsThan = true;
@@ -1204,79 +1352,15 @@ bool Graph::vertexFindByIndexScore(const int &index, const QStringList &threshol
                        "threshold"<<threshold;
         }
 
-        for (it= m_graph.cbegin(); it!= m_graph.cend(); ++it){
-
-            switch (index) {
-            case 0: {
-                score=0;
-                break;
-            }
-            case IndexType::DC : {
-                score=(*it)->SDC();
-                break;
-            }
-            case IndexType::CC : {
-                score=(*it)->SCC();
-                break;
-            }
-            case IndexType::IRCC : {
-                score=(*it)->SIRCC();
-                break;
-            }
-            case IndexType::BC : {
-                score=(*it)->SBC();
-                break;
-            }
-            case IndexType::SC : {
-                score=(*it)->SSC();
-                break;
-            }
-            case IndexType::EC : {
-                score=(*it)->SEC();
-                break;
-            }
-            case IndexType::PC : {
-                score=(*it)->SPC();
-                break;
-            }
-            case IndexType::IC : {
-                score=(*it)->SIC();
-                break;
-            }
-            case IndexType::EVC : {
-                score=(*it)->SEVC();
-                break;
-            }
-            case IndexType::DP : {
-                score=(*it)->SDP();
-                break;
-            }
-            case IndexType::PRP : {
-                score=(*it)->SPRP();
-                break;
-            }
-            case IndexType::PP : {
-                score=(*it)->SPP();
-                break;
-            }
-            }
-
-            if (gtThan) {
-                if ( score > threshold ) {
-                    qDebug() << "Graph::vertexFindByIndexScore() - vertex" << (*it)->name()
-                             << "matches. Adding it to foundList";
-                    foundList << (*it)->name();
-                }
-            }
-            else {
-                if ( score < threshold ) {
-                    qDebug() << "Graph::vertexFindByIndexScore() - vertex" << (*it)->name()
-                             << "matches. Adding it to foundList";
-                    foundList << (*it)->name();
-                }
-            }
-
+        if (gtThan || gtEqual) {
+            scoreIndex.above(threshold, gtEqual, foundList);
         }
+        else if (lsThan || lsEqual) {
+            scoreIndex.below(threshold, lsEqual, foundList);
+        }
+
+        qDebug() << "Graph::vertexFindByIndexScore() - vertices found so far:"
+                 << foundList.size();
     }
 
 
@@ -1292,76 +1376,101 @@ bool Graph::vertexFindByIndexScore(const int &index, const QStringList &threshol
 
 /**
  * @brief Removes the vertex v1 from the graph
- * First, it removes all edges to doomed from other vertices
- * Then it changes the vpos of all subsequent vertices inside m_graph
- * Finally, it removes the vertex.
+ * See vertexRemoveList()
  * @param int v1
  */
 void Graph::vertexRemove(const int &v1){
-    qDebug() << "Graph::vertexRemove() - v: "
-             << m_graph[ vpos[v1] ]->name()
-             << "  vpos: " << vpos[v1]
-                << " Removing all inbound and outbound edges ";
-    int doomedPos=vpos[v1];
+    qDebug() << "Graph::vertexRemove() - v: " << v1;
+    vertexRemoveList( QList<int>() << v1 );
+}
 
-    //Remove links to v1 from each other vertex
-    VList::const_iterator it;
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        if  ( qAbs((*it)->hasEdgeTo(v1) ) > 0) {
-            qDebug()<< "Graph::vertexRemove() - vertex " << (*it)->name()
-                    << " has outbound Edge to "<< v1 << ". Removing it.";
-            (*it)->edgeRemoveTo(v1);
-        }
-        if (  qAbs((*it)->hasEdgeFrom(v1)) > 0 ) {
-            qDebug()<< "Graph::vertexRemove() - vertex " << (*it)->name()
-                    << " has inbound Edge from "<< v1 << ". Removing it.";
-            (*it)->edgeRemoveFrom(v1);
+
+
+/**
+ * @brief Removes the given vertices from the graph at once.
+ * First, the doomed vertices are marked as tombstones, by their position in
+ * m_graph. Then only their own edges are walked, to drop the opposite entries
+ * from their surviving neighbors. Finally, m_graph and vpos are compacted in
+ * a single pass, instead of once per vertex.
+ * The nodes are removed from GW in one scene batch.
+ * @param vertexList the numbers of the vertices to remove
+ */
+void Graph::vertexRemoveList(const QList<int> &vertexList){
+
+    const int N = m_graph.size();
+    const int relation = relationCurrent();
+
+    std::vector<char> doomed(N, 0);
+    QList<int> removed;
+    for (const int &v : vertexList) {
+        const int pos = vpos.value(v, -1);
+        if ( pos < 0 || doomed[pos] ) {
+            continue;
         }
+        doomed[pos] = 1;
+        removed.append(v);
     }
 
-    qDebug()<< "Graph::vertexRemove() - Finished with vertices. "
-               "Update the vpos which maps vertices inside m_graph " ;
-    int prevIndex=doomedPos;
+    qDebug() << "Graph::vertexRemoveList() - removing" << removed.size()
+             << "of" << N << "vertices";
 
-    qDebug()<< "Graph::vertexRemove() - Updating vpos of all subsequent vertices ";
-    H_Int::const_iterator it1=vpos.cbegin();
-    while (it1 != vpos.cend()){
-        if ( it1.value() > doomedPos ) {
-            prevIndex = it1.value();
-            qDebug() << "Graph::vertexRemove() - vertex " << it1.key()
-                     << " had prevIndex: " << prevIndex
-                     << " > doomedPos " << doomedPos
-                     << " Setting new vpos. vpos size was: "<< vpos.size();
-            vpos.insert( it1.key(), --prevIndex)  ;
-            qDebug() << "Graph::vertexRemove() - vertex " << it1.key()
-                     << " new vpos: " << vpos.value( it1.key(), -666)
-                     << " vpos size now: "<< vpos.size();
+    if ( removed.isEmpty() ) {
+        return;
+    }
 
-        }
-        else {
-            qDebug() << "Graph::vertexRemove() " << it1.key() << " with vpos "
-                     << it1.value() << " < doomedPos. CONTINUE";
+    graphBulkBegin( 0, removed.size() );
 
+    // Remove the edges to and from the doomed vertices from each survivor
+    H_edges::const_iterator it;
+    for (const int &v : removed) {
+        GraphVertex *vertex = m_graph[ vpos[v] ];
+        const H_edges &outEdges = vertex->outEdgesRelation(relation);
+        for (it = outEdges.constBegin(); it != outEdges.constEnd(); ++it) {
+            const int pos = vpos.value( it.key(), -1 );
+            if ( pos >= 0 && ! doomed[pos] ) {
+                m_graph[pos]->edgeRemoveFrom(v);
+            }
+        }
+        const H_edges &inEdges = vertex->inEdgesRelation(relation);
+        for (it = inEdges.constBegin(); it != inEdges.constEnd(); ++it) {
+            const int pos = vpos.value( it.key(), -1 );
+            if ( pos >= 0 && ! doomed[pos] ) {
+                m_graph[pos]->edgeRemoveTo(v);
+            }
         }
-        ++it1;
     }
 
-    //Now remove vertex Doomed from m_graph
-    qDebug()<< "Graph::vertexRemove() -  graph vertices=size="<< vertices() << "="
-             << m_graph.size() <<  " removing vertex at vpos " << doomedPos ;
-    m_graph.removeAt( doomedPos ) ;
-    m_totalVertices--;
-    qDebug()<< "Graph::vertexRemove() - Now graph vertices=size="<< vertices() << "="
-             << m_graph.size() <<  " total edges now  " << edgesEnabled();
+    // Compact m_graph and vpos
+    VList survivors;
+    survivors.reserve( N - removed.size() );
+    for (int i = 0; i < N; ++i) {
+        if ( doomed[i] ) {
+            delete m_graph[i];
+            continue;
+        }
+        vpos[ m_graph[i]->name() ] = survivors.size();
+        survivors.append( m_graph[i] );
+    }
+    m_graph.swap(survivors);
 
-    order=false;
+    for (const int &v : removed) {
+        vpos.remove(v);
+        m_labelIndex.remove(v);
+        if ( vertexClicked() == v ) {
+            vertexClickedSet(0, QPointF(0,0));
+        }
+        graphBulkDefer( [=] () {
+            emit signalRemoveNode(v);
+        } );
+    }
+    m_totalVertices -= removed.size();
 
-    if (vertexClicked()==v1)
-        vertexClickedSet(0, QPointF(0,0));
+    qDebug()<< "Graph::vertexRemoveList() - Now graph vertices=size="<< vertices() << "="
+             << m_graph.size();
 
-    graphSetModified(GraphChange::ChangedVertices);
+    order=false;
 
-    emit signalRemoveNode(v1);
+    graphBulkCommit(GraphChange::ChangedVertices);
 }
 
 
@@ -1378,21 +1487,32 @@ void Graph::vertexRemove(const int &v1){
 void Graph::vertexIsolatedAllToggle(const bool &toggle){
     qDebug() << "Graph::vertexIsolatedAllToggle() - set all isolated to" << toggle;
 
+    QList<GraphVertex*> isolates;
     VList::const_iterator it;
     for ( it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        if ( !(*it)->isIsolated() ){
-            continue;
+        if ( (*it)->isIsolated() && (*it)->isEnabled() != toggle ){
+            isolates.append(*it);
         }
-        else {
-            qDebug() << "Graph::vertexIsolatedAllToggle() - vertex" << (*it)->name()
-                     << "is isolated. Toggling it and emitting setVertexVisibility signal to GW...";
-            (*it)->setEnabled (toggle) ;
+    }
+
+    if ( isolates.isEmpty() ) {
+        return;
+    }
 
-            graphSetModified(GraphChange::ChangedVertices);
+    // Report all the toggled vertices at once
+    graphBulkBegin( 0, isolates.size() );
 
-            emit setVertexVisibility( (*it)-> name(), toggle );
-        }
+    for (GraphVertex *vertex : isolates) {
+        const int v = vertex->name();
+        qDebug() << "Graph::vertexIsolatedAllToggle() - vertex" << v
+                 << "is isolated. Toggling it";
+        vertex->setEnabled (toggle) ;
+        graphBulkDefer( [=] () {
+            emit setVertexVisibility( v, toggle );
+        } );
     }
+
+    graphBulkCommit(GraphChange::ChangedVertices);
 }
 
 
@@ -1814,6 +1934,7 @@ void Graph::vertexLabelSet(const int &v1, const QString &label){
             << "vpos " << vpos[v1]
                << "new label"<< label;
     m_graph[ vpos[v1] ]->setLabel ( label);
+    m_labelIndex.insert(v1, label);
     emit setNodeLabel ( m_graph[ vpos[v1] ]-> name(), label);
 
     graphSetModified(GraphChange::ChangedVerticesMetadata);
@@ -2009,17 +2130,19 @@ void Graph::edgeCreate(const int &v1,
                        const QString &label,
                        const bool &signalMW){
 
-    qDebug() <<"-- Graph::edgeCreate() - " << v1 << " -> " << v2
+    qCHotDebug(lcGraph) <<"-- Graph::edgeCreate() - " << v1 << " -> " << v2
             << " weight " << weight
             << " type " << type
             << " label " << label;
 
     // check whether there is already such an edge
     // (see #713617 - https://bugs.launchpad.net/socnetv/+bug/713617)
-    if (!edgeExists(v1,v2)){
+    // A bulk build with unique edges has promised there is not.
+    const bool weightNumbers = initEdgeWeightNumbers;
+    if ( ( m_graphBulkDepth > 0 && m_graphBulkUniqueEdges ) || !edgeExists(v1,v2) ) {
         if ( type == EdgeType::Undirected ) {
 
-            qDebug()<< "-- Graph::edgeCreate() - Creating UNDIRECTED edge."
+            qCHotDebug(lcGraph)<< "-- Graph::edgeCreate() - Creating UNDIRECTED edge."
                       << "Emitting drawEdge signal to GW";
 
             edgeAdd ( v1, v2,
@@ -2030,12 +2153,14 @@ void Graph::edgeCreate(const int &v1,
                       );
 
 
-            emit signalDrawEdge(v1, v2, weight, label, ( (weight==0) ? "blue" :  color  ), type,
-                                drawArrows, bezier, initEdgeWeightNumbers);
+            graphBulkDefer( [=] () {
+                emit signalDrawEdge(v1, v2, weight, label, ( (weight==0) ? "blue" :  color  ), type,
+                                    drawArrows, bezier, weightNumbers);
+            } );
         }
         else if ( edgeExists( v2, v1 ) )  {
 
-            qDebug()<<"-- Graph::edgeCreate() - Creating RECIPROCAL edge."
+            qCHotDebug(lcGraph)<<"-- Graph::edgeCreate() - Creating RECIPROCAL edge."
                    << "Emitting drawEdge to GW";
 
             edgeAdd ( v1,
@@ -2046,13 +2171,15 @@ void Graph::edgeCreate(const int &v1,
                       color);
 
 
-            emit signalDrawEdge(v1, v2, weight, label, color, EdgeType::Reciprocated,
-                                drawArrows, bezier, initEdgeWeightNumbers);
+            graphBulkDefer( [=] () {
+                emit signalDrawEdge(v1, v2, weight, label, color, EdgeType::Reciprocated,
+                                    drawArrows, bezier, weightNumbers);
+            } );
             m_graphIsDirected = true;
         }
         else {
 
-            qDebug()<< "-- Graph::edgeCreate() - Creating directed edge. Opposite arc does not exist."
+            qCHotDebug(lcGraph)<< "-- Graph::edgeCreate() - Creating directed edge. Opposite arc does not exist."
                     << "Emitting drawEdge to GW...";
 
             edgeAdd ( v1,
@@ -2063,8 +2190,10 @@ void Graph::edgeCreate(const int &v1,
                       ( (weight==0) ? "blue" :  color  )
                       );
 
-            emit signalDrawEdge(v1, v2, weight, label, ( (weight==0) ? "blue" :  color  ), EdgeType::Directed,
-                                drawArrows, bezier, initEdgeWeightNumbers);
+            graphBulkDefer( [=] () {
+                emit signalDrawEdge(v1, v2, weight, label, ( (weight==0) ? "blue" :  color  ), EdgeType::Directed,
+                                    drawArrows, bezier, weightNumbers);
+            } );
 
             m_graphIsDirected = true;
             m_graphIsSymmetric=false;
@@ -2072,7 +2201,7 @@ void Graph::edgeCreate(const int &v1,
     }
 
     else {
-        qDebug() << "-- Graph::edgeCreate() - "
+        qCHotDebug(lcGraph) << "-- Graph::edgeCreate() - "
                     << "Edge " << v1 << " -> " << v2
                     << " declared previously (exists) - nothing to do \n\n";
     }
@@ -2089,6 +2218,49 @@ void Graph::edgeCreate(const int &v1,
 
 
 
+/**
+ * @brief Creates many edges at once, within a bulk build.
+ * Called from the Parser with the deduplicated edges of an edge list file, so
+ * edgeCreate() can skip its check for an existing edge, and with the edges of
+ * the numeric sections of a Pajek file, which may repeat (uniqueEdges false).
+ * @param sources
+ * @param targets
+ * @param weights
+ * @param color
+ * @param type
+ * @param drawArrows
+ * @param bezier
+ * @param uniqueEdges true if the list has no edge twice, nor any existing edge
+ */
+void Graph::edgeCreateList(const QVector<int> &sources,
+                           const QVector<int> &targets,
+                           const QVector<qreal> &weights,
+                           const QString &color,
+                           const int &type,
+                           const bool &drawArrows,
+                           const bool &bezier,
+                           const bool &uniqueEdges) {
+
+    qDebug() << "Graph::edgeCreateList() - edges:" << sources.size()
+             << "uniqueEdges:" << uniqueEdges;
+
+    graphBulkBegin( 0, sources.size() );
+
+    const bool bulkUniqueEdges = m_graphBulkUniqueEdges;
+    m_graphBulkUniqueEdges = bulkUniqueEdges || uniqueEdges;
+    for (int i = 0; i < sources.size(); ++i) {
+        edgeCreate( sources[i], targets[i], weights[i], color, type,
+                    drawArrows, bezier, QString(), false );
+    }
+    m_graphBulkUniqueEdges = bulkUniqueEdges;
+
+    graphBulkCommit(GraphChange::ChangedEdges, false);
+}
+
+
+
+
+
 /**
  * @brief Called from WebCrawler when it finds an new link
  * Calls edgeCreate() method with initEdgeColor
@@ -2126,13 +2298,37 @@ void Graph::edgeAdd (const int &v1, const int &v2,
     int source=vpos[v1];
     int target=vpos[v2];
 
-    qDebug()<< "Graph: edgeAdd() - new edge from vertex "<< v1 << "["<< source
+    qCHotDebug(lcGraph)<< "Graph: edgeAdd() - new edge from vertex "<< v1 << "["<< source
             << "] to vertex "<< v2 << "["<< target << "] of weight "<<weight
             << " and label " << label;
 
+    // Carry the tie counters over to the new version, if they are up to date
+    const bool updateTies = tieCountersValid();
+    if ( updateTies ) {
+        graphTieCountersPair(v1, v2, -1);
+    }
+
+    distancesIncrementalArc(source, target);
+    if ( type == EdgeType::Undirected ) {
+        distancesIncrementalArc(target, source);
+    }
+
     m_graph [ source ]->edgeAddTo(v2, weight, color, label );
     m_graph [ target ]->edgeAddFrom(v1, weight);
 
+    // Carry the components over to the new version, if they are up to date
+    const bool updateComponents = m_components.isValid( relationCurrent(), m_graphVersion );
+
+    m_graphVersion++;
+
+    if ( updateComponents ) {
+        m_components.arcAdded(source, target, m_graphVersion);
+        if ( type == EdgeType::Undirected ) {
+            m_components.arcAdded(target, source, m_graphVersion);
+        }
+        m_componentsArcVersion = m_graphVersion;
+    }
+
     if ( weight != 1 && weight!=0) {
         graphSetWeighted(true);
     }
@@ -2146,6 +2342,11 @@ void Graph::edgeAdd (const int &v1, const int &v2,
         m_graph [ source ]->edgeAddFrom(v2, weight);
     }
 
+    if ( updateTies ) {
+        graphTieCountersPair(v1, v2, +1);
+        graphTieCountersUpdated();
+    }
+
 }
 
 
@@ -2166,6 +2367,17 @@ void Graph::edgeRemove (const int &v1,
                         const bool &removeOpposite) {
     qDebug ()<< "Graph::edgeRemove() - edge" << v1 << "[" << vpos[v1]
                 << "] --> " << v2 << " to be removed. RemoveOpposite:" <<removeOpposite;
+
+    const bool updateTies = tieCountersValid();
+    if ( updateTies ) {
+        graphTieCountersPair(v1, v2, -1);
+    }
+
+    distancesIncrementalArc(vpos[v1], vpos[v2]);
+    if ( graphIsUndirected() || removeOpposite ) {
+        distancesIncrementalArc(vpos[v2], vpos[v1]);
+    }
+
     m_graph [ vpos[v1] ]->edgeRemoveTo(v2);
     m_graph [ vpos[v2] ]->edgeRemoveFrom(v1);
 
@@ -2180,7 +2392,17 @@ void Graph::edgeRemove (const int &v1,
         }
     }
 
-    emit signalRemoveEdge(v1,v2, ( graphIsDirected() || removeOpposite ));
+    m_graphVersion++;
+
+    if ( updateTies ) {
+        graphTieCountersPair(v1, v2, +1);
+        graphTieCountersUpdated();
+    }
+
+    const bool removeBoth = ( graphIsDirected() || removeOpposite );
+    graphBulkDefer( [=] () {
+        emit signalRemoveEdge(v1, v2, removeBoth);
+    } );
 
     graphSetModified(GraphChange::ChangedEdges);
 }
@@ -2204,17 +2426,22 @@ void Graph::edgeRemoveSelected (SelectedEdge &selectedEdge,
 void Graph::edgeRemoveSelectedAll() {
     qDebug()<< "Graph::edgeRemoveSelectedAll()";
 
-    foreach (SelectedEdge edgeToRemove, graphSelectedEdges()) {
+    // Report all the removals at once
+    const QList<SelectedEdge> selectedEdges = graphSelectedEdges();
+    graphBulkBegin( 0, selectedEdges.size() );
+
+    foreach (SelectedEdge edgeToRemove, selectedEdges) {
         qDebug() << "Graph::edgeRemoveSelectedAll() - About to remove" << edgeToRemove;
         edgeRemoveSelected( edgeToRemove, true );
     }
+
+    graphBulkCommit(GraphChange::ChangedEdges);
 }
 
 /**
  * @brief Changes the canvas visibility of an edge
  * Called from
  * GraphVertex::edgeFilterByRelation
- * GraphVertex::edgeFilterByWeight
  * GraphVertex::setOutEdgeEnabled
  * GraphVertex::edgeFilterUnilateral
  * @param relation
@@ -2228,6 +2455,17 @@ void Graph::edgeVisibilitySet ( int relation,  int source, int target, bool visi
              << "relation"<< relation
              << "visible"<< visible
              << "emitting signal to GW";
+    // The arc has just been flipped to visible: take out the pair as it was
+    // before, then put it back as it is now.
+    const bool updateTies = ( relation == m_curRelation && tieCountersValid() );
+    if ( updateTies ) {
+        graphTieCountersPair(source, target, -1, source, target);
+        graphTieCountersPair(source, target, +1);
+    }
+    m_graphVersion++;
+    if ( updateTies ) {
+        graphTieCountersUpdated();
+    }
     emit setEdgeVisibility ( relation, source, target, visible);
 }
 
@@ -2239,22 +2477,82 @@ void Graph::edgeVisibilitySet ( int relation,  int source, int target, bool visi
 /**
  * @brief Called from MW::DialogEdgeFilter to filter edges over or under
  * a specified weight (m_threshold).
- * For each vertex in the Graph, calls the homonymous method of GraphVertex class.
+ * The edges are visited in weight order, through graphWeightIndex(). When
+ * the threshold moves and the edges are still as the previous filter left
+ * them, only the edges between the previous and the new cut are visited.
+ * The edges that changed are reported to GW in two batches, one per status,
+ * instead of one setEdgeVisibility() signal per edge.
  * @param m_threshold
  * @param overThreshold
  */
 void Graph::edgeFilterByWeight(qreal m_threshold, bool overThreshold){
     if (overThreshold)
-        qDebug() << "Graph: edgeFilterByWeight() over " << m_threshold ;
+        qCHotDebug(lcGraph) << "Graph: edgeFilterByWeight() over " << m_threshold ;
     else
-        qDebug() << "Graph: edgeFilterByWeight()  below "<< m_threshold ;
+        qCHotDebug(lcGraph) << "Graph: edgeFilterByWeight()  below "<< m_threshold ;
 
-    VList::const_iterator it;
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        (*it)->edgeFilterByWeight ( m_threshold, overThreshold );
+    graphWeightIndex();
+
+    const int cut = m_weightIndex.cut(m_threshold, overThreshold);
+    int first = 0, last = m_weightIndex.size();
+    if ( m_weightIndex.hasCut(overThreshold) ) {
+        // The edges outside the two cuts are already as this cut wants them
+        first = qMin( cut, m_weightIndex.cutPosition() );
+        last = qMax( cut, m_weightIndex.cutPosition() );
+    }
+    qCHotDebug(lcGraph) << "Graph: edgeFilterByWeight() - visiting edges" << first
+                        << "to" << last << "of" << m_weightIndex.size();
+
+    // The flipped arcs update the tie counters, as in edgeVisibilitySet().
+    const bool updateTies = tieCountersValid();
+
+    QVector<int> enabledSources, enabledTargets, disabledSources, disabledTargets;
+    for (int e = first; e < last; ++e) {
+        const bool status = GraphWeightIndex::isKept(e, cut, overThreshold);
+        GraphVertex *vertex = m_graph[ m_weightIndex.source(e) ];
+        const int target = m_weightIndex.target(e);
+        if ( ! vertex->setOutEdgeFiltered( target, m_weightIndex.weight(e), status ) ) {
+            continue;
+        }
+        const int source = vertex->name();
+        if ( updateTies ) {
+            graphTieCountersPair(source, target, -1, source, target);
+            graphTieCountersPair(source, target, +1);
+        }
+        if ( status ) {
+            enabledSources.append(source);
+            enabledTargets.append(target);
+        }
+        else {
+            disabledSources.append(source);
+            disabledTargets.append(target);
+        }
+    }
+
+    m_weightIndex.setCut(cut, overThreshold);
+
+    if ( enabledSources.isEmpty() && disabledSources.isEmpty() ) {
+        qCHotDebug(lcGraph) << "Graph: edgeFilterByWeight() - no edge changed";
+        emit statusMessage(tr("Edges have been filtered."));
+        return;
+    }
+
+    if ( updateTies ) {
+        graphTieCountersUpdated();
+    }
+
+    if ( ! disabledSources.isEmpty() ) {
+        emit setEdgesVisibility( relationCurrent(), disabledSources, disabledTargets, false );
+    }
+    if ( ! enabledSources.isEmpty() ) {
+        emit setEdgesVisibility( relationCurrent(), enabledSources, enabledTargets, true );
     }
 
     graphSetModified(GraphChange::ChangedEdges);
+
+    // The index has made the changes itself, so it still holds
+    m_weightIndex.setVersion( m_graphVersion );
+
     emit statusMessage(tr("Edges have been filtered."));
 }
 
@@ -2267,12 +2565,15 @@ void Graph::edgeFilterByWeight(qreal m_threshold, bool overThreshold){
   */
 void Graph::edgeFilterByRelation(int relation, bool status){
     qDebug() << "Graph::edgeFilterByRelation() " ;
+    // Vertices report every edge of the relation, changed or not
+    m_tieCountersValid = false;
     VList::const_iterator it;
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
         if ( ! (*it)->isEnabled() )
             continue;
         (*it)->edgeFilterByRelation ( relation, status );
     }
+    m_graphVersion++;
 }
 
 
@@ -2361,14 +2662,14 @@ qreal Graph::edgeExists (const int &v1, const int &v2, const bool &checkReciproc
 
     edgeWeightTemp = 0;
     edgeWeightTemp = m_graph[ vpos[v1] ]->hasEdgeTo(v2);
-    qDebug() << "Graph::edgeExists() - " << v1 << "->" << v2 << "=" << edgeWeightTemp  ;
+    qCHotDebug(lcGraph) << "Graph::edgeExists() - " << v1 << "->" << v2 << "=" << edgeWeightTemp  ;
     if (!checkReciprocal) {
         return edgeWeightTemp;
     }
     else { //check if edge is reciprocal
         if  ( edgeWeightTemp!=0 ) {
             edgeReverseWeightTemp = m_graph[ vpos[v2] ]->hasEdgeTo(v1);
-            qDebug() << "Graph::edgeExists() - and " << v2 << "->" << v1 << "=" << edgeWeightTemp  ;
+            qCHotDebug(lcGraph) << "Graph::edgeExists() - and " << v2 << "->" << v1 << "=" << edgeWeightTemp  ;
             if  ( edgeWeightTemp == edgeReverseWeightTemp  ){
                 return edgeWeightTemp;
             }
@@ -2387,7 +2688,7 @@ qreal Graph::edgeExists (const int &v1, const int &v2, const bool &checkReciproc
  * @return
  */
 bool Graph::edgeSymmetric(const int &v1, const int &v2){
-    qDebug() << "***Graph: edgeSymmetric()";
+    qCHotDebug(lcGraph) << "***Graph: edgeSymmetric()";
     if ( ( edgeExists( v1, v2 , true) ) !=0 ) {
         return true;
     }
@@ -2411,13 +2712,14 @@ int Graph::edgesEnabled() {
         return enabledEdges;
     }
 
-    m_totalEdges = 0;
-
-    VList::const_iterator it;
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        m_totalEdges+=(*it)->outEdges();
+    // The tie counters count the arcs too, and once computed they follow
+    // every edge edit, so later calls are O(1).
+    if ( ! tieCountersValid() ) {
+        graphTieCountersCompute();
     }
-    qDebug() << "Graph::edgesEnabled() - edges recounted: " <<  m_totalEdges;
+    m_totalEdges = m_tieArcs;
+
+    qDebug() << "Graph::edgesEnabled() - edges counted: " <<  m_totalEdges;
     calculatedEdges = true;
     enabledEdges = (( graphIsUndirected() ) ? m_totalEdges / 2 : m_totalEdges);
     return enabledEdges;
@@ -2458,15 +2760,29 @@ int Graph::vertexEdgesInbound (int v1) {
  */
 void Graph::edgeWeightSet (const int &v1, const int &v2,
                            const qreal &weight, const bool &undirected) {
-    qDebug() << "Graph::edgeWeightSet() - " << v1 << "[" << vpos[v1]
+    qCHotDebug(lcGraph) << "Graph::edgeWeightSet() - " << v1 << "[" << vpos[v1]
                 << "] ->" << v2 << "[" << vpos[v2] << "]" << " = " << weight;
+    const bool updateTies = tieCountersValid();
+    if ( updateTies ) {
+        graphTieCountersPair(v1, v2, -1);
+    }
+    distancesIncrementalArc(vpos[v1], vpos[v2]);
+    if (undirected) {
+        distancesIncrementalArc(vpos[v2], vpos[v1]);
+    }
     m_graph [ vpos[v1] ]->changeOutEdgeWeight(v2, weight);
     if (undirected) {
-        qDebug() << "Graph::edgeWeightSet() - changing opposite edge weight too";
+        qCHotDebug(lcGraph) << "Graph::edgeWeightSet() - changing opposite edge weight too";
         m_graph [ vpos[v2] ]->changeOutEdgeWeight(v1, weight);
     }
+    if ( updateTies ) {
+        graphTieCountersPair(v1, v2, +1);
+        graphTieCountersUpdated();
+    }
 
-    emit setEdgeWeight(v1,v2, weight);
+    graphBulkDefer( [=] () {
+        emit setEdgeWeight(v1, v2, weight);
+    } );
 
     graphSetModified(GraphChange::ChangedEdges);
 
@@ -2680,6 +2996,85 @@ QList<int> Graph::vertexNeighborhoodList(const int &v1) {
 }
 
 
+
+/**
+ * @brief Returns the vertices within hops from vertex v1 in the current
+ * relation, in breadth-first order, v1 first.
+ * The list can be passed as is to verticesCreateSubgraph().
+ * @param v1
+ * @param hops
+ * @param direction GraphNeighborhood::Out, In or Both
+ * @return  QList<int>
+ */
+QList<int> Graph::vertexNeighborhoodHops(const int &v1, const int &hops,
+                                         const int &direction) {
+    QList<int> list;
+    if ( !vpos.contains(v1) ) {
+        return list;
+    }
+    const GraphCSR &csr = graphCSR();
+    m_neighborhood.query( csr, vpos[v1], hops,
+                          static_cast<GraphNeighborhood::Direction>(direction) );
+    const QVector<int> &found = m_neighborhood.vertices();
+    list.reserve( found.size() );
+    for (int k = 0; k < found.size(); ++k) {
+        list << csr.name( found[k] );
+    }
+    qDebug()<< "Graph::vertexNeighborhoodHops() - v1" << v1 << "hops" << hops
+            << "vertices" << list.size();
+    return list;
+}
+
+
+
+/**
+ * @brief Returns the geodesic distance from v1 to v2 in the current relation,
+ * if it is at most hops, or -1 otherwise.
+ * Unlike the distance matrix, it searches only around v1 and v2.
+ * @param v1
+ * @param v2
+ * @param hops
+ * @return
+ */
+int Graph::vertexNeighborhoodDistance(const int &v1, const int &v2, const int &hops) {
+    if ( !vpos.contains(v1) || !vpos.contains(v2) ) {
+        return -1;
+    }
+    return m_neighborhood.distance( graphCSR(), vpos[v1], vpos[v2], hops,
+                                    graphIsDirected() ? GraphNeighborhood::Out
+                                                      : GraphNeighborhood::Both );
+}
+
+
+
+/**
+ * @brief Selects the ego network of vertex v1, that is the vertices within
+ * hops from it, ignoring the direction of the arcs, and reports its size
+ * and density. The selected vertices can then be used by the subgraph
+ * actions, see verticesCreateSubgraph().
+ * @param v1
+ * @param hops
+ */
+void Graph::vertexEgoNetworkSelect(const int &v1, const int &hops) {
+    QList<int> list = vertexNeighborhoodHops(v1, hops, GraphNeighborhood::Both);
+    if ( list.isEmpty() ) {
+        return;
+    }
+    const GraphCSR &csr = graphCSR();
+    QStringList sizes;
+    foreach (int size, m_neighborhood.hopSizes()) {
+        sizes << QString::number(size);
+    }
+    emit signalNodesFound(list);
+    emit statusMessage( tr("Ego network of node %1 within %2 hops: "
+                           "%3 nodes (per hop: %4), %5 arcs, density %6")
+                        .arg(v1).arg(hops).arg(list.size())
+                        .arg(sizes.join(", "))
+                        .arg(m_neighborhood.egoArcs(csr))
+                        .arg(m_neighborhood.egoDensity(csr), 0, 'g', 3) );
+}
+
+
 /**
  * @brief Returns the set of all vertices mutually connected to vertex v1 in the
  * current relation
@@ -2819,7 +3214,9 @@ QSet<int> Graph::verticesSet(){
 
 
 /**
- * @brief Creates a subgraph (clique, star, cycle, line) with vertices in vList
+ * @brief Creates a subgraph (clique, star, cycle, line) with vertices in vList,
+ * or copies the subgraph they induce to a new relation, see
+ * verticesCreateSubgraphInduced().
  * Iff vList is empty, then fallbacks to the m_verticesSelected.
  * @param vList
  */
@@ -2827,6 +3224,11 @@ void Graph::verticesCreateSubgraph(QList<int> vList,
                                    const int &type,
                                    const int &center) {
 
+    if ( type == SUBGRAPH_INDUCED ) {
+        verticesCreateSubgraphInduced( vList.isEmpty() ? m_verticesSelected : vList );
+        return;
+    }
+
     if ( relations() == 1 && edgesEnabled()==0 ) {
         QString newRelationName = QString::number ( vList.size() ) + tr("-clique");
         relationCurrentRename(newRelationName, true);
@@ -2842,7 +3244,10 @@ void Graph::verticesCreateSubgraph(QList<int> vList,
     int progressCounter = 0;
     QString pMsg = tr("Creating subgraph. \nPlease wait...");
     emit statusMessage( pMsg);
-    emit signalProgressBoxCreate(vList.size(),pMsg);
+    graphProgressCreate(vList.size(),pMsg);
+
+    // Report the new edges at once, when the subgraph is complete
+    graphBulkBegin( 0, ( type == SUBGRAPH_CLIQUE ) ? vList.size() * (vList.size()-1) / 2 : vList.size() );
 
 
     qreal weight;
@@ -2854,7 +3259,7 @@ void Graph::verticesCreateSubgraph(QList<int> vList,
 
         for (int i=0; i < vList.size(); ++i ) {
 
-            emit signalProgressBoxUpdate(++progressCounter);
+            graphProgressUpdate(++progressCounter);
 
             for (int j=i+1; j < vList.size(); ++j ) {
 
@@ -2886,7 +3291,7 @@ void Graph::verticesCreateSubgraph(QList<int> vList,
 
         for (int j=0; j < vList.size(); ++j ) {
 
-            emit signalProgressBoxUpdate(++progressCounter);
+            graphProgressUpdate(++progressCounter);
 
             if ( ! (weight=edgeExists( center, vList.value(j) ) ) ) {
                 if ( center == vList.value(j))
@@ -2916,7 +3321,7 @@ void Graph::verticesCreateSubgraph(QList<int> vList,
         int j=0;
         for (int i=0; i < vList.size(); ++i ) {
 
-            emit signalProgressBoxUpdate(++progressCounter);
+            graphProgressUpdate(++progressCounter);
 
             j= ( i == vList.size()-1) ? 0:i+1;
             if ( ! (weight=edgeExists( vList.value(i), vList.value(j) ) ) ) {
@@ -2948,7 +3353,7 @@ void Graph::verticesCreateSubgraph(QList<int> vList,
         int j=0;
         for (int i=0; i < vList.size(); ++i ) {
 
-            emit signalProgressBoxUpdate(++progressCounter);
+            graphProgressUpdate(++progressCounter);
 
             if ( i == vList.size()-1 ) break;
             j= i+1;
@@ -2977,10 +3382,12 @@ void Graph::verticesCreateSubgraph(QList<int> vList,
 
     }
     else {
-        emit signalProgressBoxKill();
+        graphBulkCommit(GraphChange::ChangedEdges);
+        graphProgressKill();
         return;
     }
-    emit signalProgressBoxKill();
+    graphBulkCommit(GraphChange::ChangedEdges);
+    graphProgressKill();
 
 }
 
@@ -2989,39 +3396,240 @@ void Graph::verticesCreateSubgraph(QList<int> vList,
 
 
 /**
- * @brief Sets the graph modification status.
- * If there are major changes, then signalGraphModified is emitted
- * In any case, SignalGraphSavedStatus is emitted.
- * @param graphChangedFlag
- * @param signalMW
+ * @brief Copies the subgraph induced by the vertices in vList, that is the
+ * enabled edges of the current relation between any two of them, to a new
+ * relation.
+ * The edges are collected in parallel from graphCSR(): each worker scans the
+ * out-row of one vertex of vList and keeps the targets that are marked in a
+ * membership bitmap. They are then created in one bulk build, so that GW
+ * draws them in a single scene update.
+ * @param vList
  */
-void Graph::graphSetModified(const int &graphNewStatus, const bool &signalMW){
+void Graph::verticesCreateSubgraphInduced(const QList<int> &vList) {
 
-    if ( graphNewStatus == GraphChange::ChangedNew ) {
+    qDebug()<<"Graph::verticesCreateSubgraphInduced() - vertices:" << vList.size();
 
-        // this is called from:
-        // graphFileLoaded() after successful loading
+    const bool undirected = graphIsUndirected();
 
-        qDebug()<<"Graph::graphSetModified() - new, thus saved..."
-                  "emit signalGraphModified()";
+    QVector<int> sources, targets;
+    QVector<qreal> weights;
+    {
+        const GraphCSR &csr = graphCSR();
+
+        std::vector<char> member( csr.vertices(), 0 );
+        QVector<int> members;
+        members.reserve( vList.size() );
+        for (const int &v : vList) {
+            const int i = vpos.value(v, -1);
+            if ( i < 0 || member[i] ) {
+                continue;
+            }
+            member[i] = 1;
+            members.append(i);
+        }
 
-        m_graphHasChanged=graphNewStatus;
+        QString pMsg = tr("Extracting induced subgraph. \nPlease wait...");
+        emit statusMessage( pMsg );
+        graphProgressCreate( members.size(), pMsg );
+
+        // The edges of each member, as CSR edge positions. An undirected
+        // edge is kept once, from its smaller end.
+        std::vector< std::vector<int> > rows( members.size() );
+        graphParallelFor( members.size(), graphWorkerThreads( members.size() ),
+                          [&](const int &, const int &m) {
+            const int i = members[m];
+            std::vector<int> &row = rows[m];
+            for (int e = csr.outBegin(i); e < csr.outEnd(i); ++e) {
+                const int j = csr.outTarget(e);
+                if ( member[j] && ( !undirected || j >= i ) ) {
+                    row.push_back(e);
+                }
+            }
+        } );
 
-        emit signalGraphModified(graphIsDirected(),
-                                 m_totalVertices,
-                                 edgesEnabled(),
-                                 graphDensity());
+        graphProgressKill();
 
-        return;
+        int E = 0;
+        for (size_t m = 0; m < rows.size(); ++m) {
+            E += (int) rows[m].size();
+        }
+        sources.reserve(E);
+        targets.reserve(E);
+        weights.reserve(E);
+        for (int m = 0; m < members.size(); ++m) {
+            for (const int &e : rows[m]) {
+                sources.append( csr.name( members[m] ) );
+                targets.append( csr.name( csr.outTarget(e) ) );
+                weights.append( csr.outWeight(e) );
+            }
+        }
     }
-    else if ( graphNewStatus == GraphChange::ChangedNone ) {
 
-        // this is called from:
-        // graphSaved() after successful saving
+    qDebug()<<"Graph::verticesCreateSubgraphInduced() - induced edges:" << sources.size();
 
-        qDebug()<<"Graph::graphSetModified() - no changes, graph is saved...";
+    relationAdd( QString::number( vList.size() ) + tr("-induced"), true );
 
-        m_graphHasChanged=graphNewStatus;
+    graphBulkBegin( 0, sources.size(), true );
+    for (int k = 0; k < sources.size(); ++k) {
+        edgeCreate( sources[k], targets[k], weights[k], initEdgeColor,
+                    undirected ? EdgeType::Undirected : EdgeType::Directed,
+                    !undirected, false, QString(), false);
+    }
+    graphBulkCommit(GraphChange::ChangedEdges);
+}
+
+
+
+
+
+/**
+ * @brief Starts a bulk construction of the graph.
+ * Until the matching graphBulkCommit(), vertexCreate(), edgeCreate() and the
+ * other edit methods only change the graph data: the per-element graphSetModified()
+ * calls are coalesced, and the signals to GW are queued, to be emitted in order at commit.
+ * Used by the random network generators, the file loader and verticesCreateSubgraph().
+ * Calls may nest; only the outermost pair takes effect.
+ * @param vertices the number of vertices to be appended, used to reserve capacity
+ * @param edges the number of edges to be appended, used to reserve capacity
+ * @param uniqueEdges if true, the caller guarantees that it never creates the same
+ * edge twice, so edgeCreate() skips its existence check.
+ */
+void Graph::graphBulkBegin(const int &vertices,
+                           const int &edges,
+                           const bool &uniqueEdges) {
+
+    qDebug() << "Graph::graphBulkBegin() - vertices:" << vertices
+             << "edges:" << edges
+             << "uniqueEdges:" << uniqueEdges
+             << "depth:" << m_graphBulkDepth;
+
+    if ( m_graphBulkDepth++ == 0 ) {
+        m_graphBulkUniqueEdges = uniqueEdges;
+        m_graphBulkDeferred.clear();
+    }
+
+    vpos.reserve( vpos.size() + vertices );
+    m_graph.reserve( m_graph.size() + vertices );
+    m_graphBulkDeferred.reserve( m_graphBulkDeferred.size() + vertices + edges );
+}
+
+
+/**
+ * @brief Ends a bulk construction started with graphBulkBegin().
+ * Emits the queued signals to GW, between signalSceneBuildBegin() and
+ * signalSceneBuildEnd(), and then calls graphSetModified() once.
+ * @param graphNewStatus the change to report
+ * @param signalMW
+ */
+void Graph::graphBulkCommit(const int &graphNewStatus, const bool &signalMW) {
+
+    if ( m_graphBulkDepth == 0 ) {
+        qDebug() << "Graph::graphBulkCommit() - no bulk build in progress.";
+        graphSetModified(graphNewStatus, signalMW);
+        return;
+    }
+    if ( --m_graphBulkDepth > 0 ) {
+        return;
+    }
+
+    qDebug() << "Graph::graphBulkCommit() - emitting"
+             << m_graphBulkDeferred.size() << "queued signals";
+
+    vector< std::function<void ()> > deferred;
+    deferred.swap(m_graphBulkDeferred);
+
+    // Replay the queued signals as one scene build, reporting progress
+    // if there are many of them.
+    const int count = (int) deferred.size();
+    const int progressStep = 1000;
+    const bool showProgress = ( count >= 10 * progressStep );
+    if ( count > 0 ) {
+        emit signalSceneBuildBegin( count );
+    }
+    if ( showProgress ) {
+        QString pMsg = tr("Drawing the network (%1 items).\n"
+                          "Please wait...").arg(count);
+        emit statusMessage( pMsg );
+        graphProgressCreate( count, pMsg );
+    }
+    for (int i = 0; i < count; ++i) {
+        deferred[i]();
+        if ( showProgress && ( i + 1 ) % progressStep == 0 ) {
+            graphProgressUpdate( i + 1 );
+        }
+    }
+    if ( showProgress ) {
+        graphProgressKill();
+    }
+    if ( count > 0 ) {
+        emit signalSceneBuildEnd();
+    }
+
+    m_graphBulkUniqueEdges = false;
+
+    graphSetModified(graphNewStatus, signalMW);
+}
+
+
+/**
+ * @brief Emits a signal to GW now, or queues it if a bulk build is in progress.
+ * @param emission
+ */
+void Graph::graphBulkDefer(const std::function<void ()> &emission) {
+    if ( m_graphBulkDepth > 0 ) {
+        m_graphBulkDeferred.push_back(emission);
+        return;
+    }
+    emission();
+}
+
+
+
+/**
+ * @brief Sets the graph modification status.
+ * If there are major changes, then signalGraphModified is emitted
+ * In any case, SignalGraphSavedStatus is emitted.
+ * @param graphChangedFlag
+ * @param signalMW
+ */
+void Graph::graphSetModified(const int &graphNewStatus, const bool &signalMW){
+
+    if ( m_graphBulkDepth > 0 && graphNewStatus > GraphChange::ChangedMajor ) {
+        // A bulk build is in progress; graphBulkCommit() will report
+        // all the changes at once. Any cached CSR snapshot is stale, though.
+        m_graphVersion++;
+        m_distancesIncrementalBase.reset();
+        m_distancesIncrementalArcs.clear();
+        return;
+    }
+
+    if ( graphNewStatus == GraphChange::ChangedNew ) {
+
+        // this is called from:
+        // graphFileLoaded() after successful loading
+
+        qDebug()<<"Graph::graphSetModified() - new, thus saved..."
+                  "emit signalGraphModified()";
+
+        m_graphHasChanged=graphNewStatus;
+
+        m_graphVersion++;
+
+        emit signalGraphModified(graphIsDirected(),
+                                 m_totalVertices,
+                                 edgesEnabled(),
+                                 graphDensity());
+
+        return;
+    }
+    else if ( graphNewStatus == GraphChange::ChangedNone ) {
+
+        // this is called from:
+        // graphSaved() after successful saving
+
+        qDebug()<<"Graph::graphSetModified() - no changes, graph is saved...";
+
+        m_graphHasChanged=graphNewStatus;
 
         emit signalGraphSavedStatus(true);
 
@@ -3037,8 +3645,45 @@ void Graph::graphSetModified(const int &graphNewStatus, const bool &signalMW){
 
         m_graphHasChanged=graphNewStatus;
 
+        // The components are still valid if the only change since they were
+        // computed is the arcs edgeAdd() has already merged into them.
+        const bool carryComponents =
+                graphNewStatus == GraphChange::ChangedEdges
+                && m_componentsArcVersion == m_graphVersion
+                && m_components.isValid( relationCurrent(), m_graphVersion );
+
+        // Likewise the tie counters, if the edge edits have kept them up to date.
+        const bool carryTies =
+                graphNewStatus == GraphChange::ChangedEdges
+                && m_tieCountersArcVersion == m_graphVersion
+                && tieCountersValid();
+
+        // The geodesic distances can be repaired, instead of recomputed, if
+        // the only changes since are the edge edits distancesIncrementalArc() saw.
+        const bool repairDistances =
+                graphNewStatus == GraphChange::ChangedEdges
+                && m_distancesIncrementalBase && calculatedDistances;
+        const bool repairCentralities =
+                repairDistances && m_distancesIncrementalCentralities
+                && calculatedCentralities;
+
+        // Any cached CSR snapshot is now stale
+        m_graphVersion++;
+
+        if ( carryComponents ) {
+            m_components.setVersion( m_graphVersion );
+        }
+        m_componentsArcVersion = 0;
+
+        if ( carryTies ) {
+            m_tieCountersVersion = m_graphVersion;
+        }
+        m_tieCountersArcVersion = 0;
+
         // Init all calculated* flags to false, as all prior computations
-        // are now invalid and we need to recompute any of them
+        // are now invalid and we need to recompute any of them.
+        // The prominence index results in m_resultCache are keyed by the
+        // graph version, which has just been bumped, so they expire by themselves.
         calculatedGraphReciprocity = false;
         calculatedGraphSymmetry = false;
         calculatedGraphWeighted = false;
@@ -3052,13 +3697,16 @@ void Graph::graphSetModified(const int &graphNewStatus, const bool &signalMW){
         calculatedAdjacencyMatrix = false;
         calculatedDistances = false;
         calculatedCentralities = false;
-        calculatedDP = false;
-        calculatedDC = false;
-        calculatedPP = false;
-        calculatedIRCC = false;
-        calculatedIC = false;
-        calculatedEVC=false;
-        calculatedPRP = false;
+        calculatedBCApproximate = false;
+        calculatedEccentricity = false;
+
+        // A successful repair sets calculatedDistances and
+        // calculatedEccentricity again
+        if ( repairDistances ) {
+            distancesIncrementalRepair(repairCentralities);
+        }
+        m_distancesIncrementalBase.reset();
+        m_distancesIncrementalArcs.clear();
 
         if (signalMW) {
 
@@ -3282,11 +3930,11 @@ bool Graph::graphIsWeighted(){
 
     QString pMsg = tr("Checking if the graph edges are valued. \nPlease wait...");
     emit statusMessage( pMsg);
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         for (it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1){
             m_weight = edgeExists ( (*it1)->name(), (*it)->name() ) ;
@@ -3304,7 +3952,7 @@ bool Graph::graphIsWeighted(){
     calculatedGraphWeighted = true;
     qDebug()<< "Graph::graphIsWeighted() - result" << m_graphIsWeighted;
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
     return m_graphIsWeighted;
 }
@@ -3356,7 +4004,14 @@ int Graph:: verticesWithReciprocalEdges(){
  */
 void Graph::webCrawlTerminateThreads (QString reason){
     qDebug() << "Graph::webCrawlTerminateThreads() - reason " << reason
-             << "Checking webcrawlerThread...";
+             << "Clearing the frontier and checking webcrawlerThread...";
+
+    // Stop making requests. Any pending spider timer will do nothing.
+    m_crawler_run++;
+    m_crawler_wake_at = -1;
+    m_crawler_frontier.clear();
+    m_crawler_checkpoint_pending = false;
+    m_crawler_checkpoint_inflight.clear();
 
     while (webcrawlerThread.isRunning() ) {
 
@@ -3375,6 +4030,9 @@ void Graph::webCrawlTerminateThreads (QString reason){
 /**
  * @brief Called by MW to start the web crawler with user options.
  * The crawler is created and moved to a new thread.
+ * To resume a crawl, the network, the frontier and what the crawler knows
+ * are restored from the last checkpoint, so no page is downloaded again,
+ * apart from those which were in flight.
  * @param startUrl
  * @param urlPatternsIncluded
  * @param urlPatternsExcluded
@@ -3389,6 +4047,8 @@ void Graph::webCrawlTerminateThreads (QString reason){
  * @param extLinksCrawl
  * @param socialLinks
  * @param delayedRequests
+ * @param checkpoints if true, saves a checkpoint every m_crawler_checkpoint_pages pages
+ * @param resume if true, resumes the crawl from startUrl from its last checkpoint
  */
 void Graph::startWebCrawler(
         const QUrl &startUrl,
@@ -3404,31 +4064,38 @@ void Graph::startWebCrawler(
         const bool &extLinksIncluded,
         const bool &extLinksCrawl,
         const bool &socialLinks,
-        const bool &delayedRequests){
-
-    // Rename current relation
-    relationCurrentRename(tr("web"), true);
+        const bool &delayedRequests,
+        const bool &checkpoints,
+        const bool &resume){
 
     qDebug() << "Graph::startWebCrawler() - "
              << "activeGraph thread:" << thread()
              << "startUrl:" << startUrl.toString()
-             << "Creating url queue and passing it to a new WebCrawler object";
+             << "resume:" << resume
+             << "Creating a new WebCrawler object";
 
 
     // Initialize
     m_crawler_max_urls = maxNodes;                      // maximum urls we'll visit (max nodes in the resulted network)
-    m_crawler_delayed_requests = delayedRequests;       // Controls if we will wait between requests
+    m_crawler_delayed_requests = delayedRequests;       // Controls if we will wait between requests to the same host
     m_crawler_visited_urls = 0;                         // A counter of the urls visited.
-
-    // Create a new url queue
-    urlQueue = new QQueue<QUrl>;
-
-    // Enqueue the start QUrl
-    urlQueue->enqueue(startUrl);
-
-    // Create the web_crawler that will parse the downloaded HTML code and pass the urlQueue to it
+    m_crawler_run++;
+    m_crawler_wake_at = -1;
+    m_crawler_frontier.clear();
+    // Every url in the frontier is a new node, so maxNodes bounds it as well
+    m_crawler_frontier.setLimits( ( maxNodes > 0 ) ? maxNodes : m_crawler_max_frontier,
+                                  m_crawler_max_host_requests,
+                                  delayedRequests );
+    m_crawler_clock.start();
+
+    m_crawler_start_url = startUrl;
+    m_crawler_checkpoints = checkpoints;
+    m_crawler_checkpoint_pending = false;
+    m_crawler_checkpoint_inflight.clear();
+
+    // Create the web_crawler that will parse the downloaded HTML code
+    // and send us back the new urls to crawl
     web_crawler = new WebCrawler(
-                urlQueue,
                 startUrl,
                 urlPatternsIncluded,
                 urlPatternsExcluded,
@@ -3443,6 +4110,35 @@ void Graph::startWebCrawler(
                 extLinksCrawl,
                 socialLinks);
 
+    // Resume the last crawl from this url, if asked to and there is a checkpoint.
+    bool resumed = false;
+    if ( resume ) {
+        QByteArray crawlerState;
+        const QString fileName = webCrawlCheckpointFile(startUrl);
+        if ( webCrawlCheckpointRead(fileName, crawlerState)
+             && web_crawler->restore(crawlerState) ) {
+            relationsClear();
+            if ( graphLoadFromBinaryFormat(fileName + ".snb") ) {
+                resumed = true;
+            }
+            else {
+                web_crawler->reset();
+            }
+        }
+        if ( !resumed ) {
+            m_crawler_frontier.clear();
+            m_crawler_visited_urls = 0;
+            emit statusMessage( tr("Could not resume the crawl of %1. Starting a new crawl.")
+                                .arg( startUrl.toString() ) );
+        }
+    }
+    m_crawler_checkpoint_at = m_crawler_visited_urls + m_crawler_checkpoint_pages;
+
+    if ( !resumed ) {
+        // Rename current relation
+        relationCurrentRename(tr("web"), true);
+    }
+
     qDebug() << "Graph::startWebCrawler() - Moving out web_crawler from thread:"
              << web_crawler->thread();
 
@@ -3453,11 +4149,23 @@ void Graph::startWebCrawler(
              << web_crawler->thread() ;
 
     // Connect signals and slots
+    connect(this, &Graph::signalWebCrawlData,
+            web_crawler, &WebCrawler::parseData);
+
     connect(this, &Graph::signalWebCrawlParse,
             web_crawler, &WebCrawler::parse);
 
-    connect(web_crawler, &WebCrawler::signalStartSpider,
-            this, &Graph::webSpider);
+    connect(this, &Graph::signalWebCrawlCheckpoint,
+            web_crawler, &WebCrawler::checkpoint);
+
+    connect(web_crawler, &WebCrawler::signalCheckpoint,
+            this, &Graph::webCrawlCheckpointWrite);
+
+    connect(web_crawler, &WebCrawler::signalAbortDownload,
+            this, &Graph::signalNetworkManagerAbort);
+
+    connect(web_crawler, &WebCrawler::signalEnqueueUrl,
+            this, &Graph::webCrawlEnqueue);
 
     connect(web_crawler, &WebCrawler::signalCreateNode,
             this, &Graph::vertexCreateAtPosRandomWithLabel);
@@ -3476,219 +4184,454 @@ void Graph::startWebCrawler(
     qDebug() << "Graph::startWebCrawler() - Starting webcrawlerThread!";
     webcrawlerThread.start();
 
+    if ( resumed ) {
+        emit statusMessage( tr("Resuming the crawl of %1: %2 urls visited, %3 urls to visit.")
+                            .arg( startUrl.toString() )
+                            .arg( m_crawler_visited_urls )
+                            .arg( m_crawler_frontier.size() ) );
+        webSpider();
+        return;
+    }
+
     // Create the initial vertex for the starting url
     qDebug() << "Graph::startWebCrawler()  - Creating initial node 1, initialUrlStr:" << startUrl.toString();
     vertexCreateAtPosRandomWithLabel(1, startUrl.toString(), false);
 
-    // Call the spider to download the html code of the starting url .
-    qDebug() << "Graph::startWebCrawler() - Calling webSpider()...";
-    this->webSpider();
+    // Enqueue the starting url, the spider will download its html code.
+    qDebug() << "Graph::startWebCrawler() - Enqueuing the start url...";
+    webCrawlEnqueue(startUrl);
 
     qDebug("Graph::startWebCrawler() - reach the end - See the threads running? ");
 }
 
 
+
+/**
+ * @brief Returns the base file name of the checkpoints of a crawl from
+ * startUrl, in the data dir. The crawl state goes in the file itself and the
+ * network in the same file name with the .snb suffix.
+ * @param startUrl
+ * @return
+ */
+QString Graph::webCrawlCheckpointFile(const QUrl &startUrl) const {
+    return QDir(m_reportsDataDir).filePath(
+                QString("socnetv-crawl-%1.crawl")
+                .arg( WebCrawlerIndex::fingerprint(startUrl), 16, 16, QChar('0') ) );
+}
+
+
+
+/**
+ * @brief Begins a checkpoint of the crawl. The spider stops making new
+ * requests and the crawler is asked for what it knows. The urls in flight now
+ * are saved, to be requested again on resume, since the crawler may parse
+ * them after it has written its part. See webCrawlCheckpointWrite().
+ */
+void Graph::webCrawlCheckpoint() {
+    qDebug() << "Graph::webCrawlCheckpoint() - visited urls" << m_crawler_visited_urls;
+    m_crawler_checkpoint_pending = true;
+    m_crawler_checkpoint_inflight = m_crawler_frontier.inflight();
+    emit signalWebCrawlCheckpoint();
+}
+
+
+
+/**
+ * @brief Completes a checkpoint of the crawl, when the crawler sends what it
+ * knows. Every node and edge the crawler signalled before is in the network
+ * by now, so this writes the network as a binary snapshot, and then the
+ * crawl state: the start url, the visited urls count, the crawler state, and
+ * the frontier together with the urls in flight when the checkpoint began.
+ * Then the spider goes on.
+ * @param crawlerState
+ */
+void Graph::webCrawlCheckpointWrite(const QByteArray &crawlerState) {
+
+    const QString fileName = webCrawlCheckpointFile(m_crawler_start_url);
+
+    qDebug() << "Graph::webCrawlCheckpointWrite() - file:" << fileName;
+
+    QByteArray state;
+    QDataStream out( &state, QIODevice::WriteOnly );
+    out.setVersion(QDataStream::Qt_5_0);
+    out << (quint32) 0x534e5743 << (qint32) 1
+        << m_crawler_start_url
+        << (qint32) m_crawler_visited_urls
+        << crawlerState;
+    m_crawler_frontier.write(out, m_crawler_checkpoint_inflight);
+
+    QSaveFile file(fileName);
+    if ( graphSaveToBinaryFormat(fileName + ".snb")
+         && file.open(QIODevice::WriteOnly)
+         && file.write(state) == state.size()
+         && file.commit() ) {
+        emit statusMessage( tr("Crawl checkpoint saved: %1 urls visited, %2 urls to visit.")
+                            .arg( m_crawler_visited_urls )
+                            .arg( m_crawler_frontier.size() + m_crawler_checkpoint_inflight.size() ) );
+    }
+    else {
+        emit statusMessage( tr("Error. Could not write the crawl checkpoint to %1")
+                            .arg( fileName ) );
+    }
+
+    m_crawler_checkpoint_pending = false;
+    m_crawler_checkpoint_inflight.clear();
+    m_crawler_checkpoint_at = m_crawler_visited_urls + m_crawler_checkpoint_pages;
+    webSpider();
+}
+
+
+
+/**
+ * @brief Reads the crawl state of a checkpoint written by webCrawlCheckpointWrite(),
+ * restoring the visited urls count and the frontier.
+ * @param fileName
+ * @param crawlerState the state of the crawler, to restore it
+ * @return false if there is no valid checkpoint of a crawl from the current start url
+ */
+bool Graph::webCrawlCheckpointRead(const QString &fileName, QByteArray &crawlerState) {
+
+    QFile file(fileName);
+    if ( !file.open(QIODevice::ReadOnly) ) {
+        qDebug() << "Graph::webCrawlCheckpointRead() - cannot open" << fileName;
+        return false;
+    }
+    QDataStream in( &file );
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    qint32 format = 0, visited = 0;
+    QUrl startUrl;
+    in >> magic >> format >> startUrl >> visited >> crawlerState;
+    if ( in.status() != QDataStream::Ok || magic != 0x534e5743 || format != 1
+         || startUrl != m_crawler_start_url || visited < 0 ) {
+        qDebug() << "Graph::webCrawlCheckpointRead() - not a checkpoint of" << m_crawler_start_url;
+        return false;
+    }
+    if ( !m_crawler_frontier.read(in) ) {
+        m_crawler_frontier.clear();
+        return false;
+    }
+    m_crawler_visited_urls = visited;
+    qDebug() << "Graph::webCrawlCheckpointRead() - visited urls" << visited
+             << "frontier" << m_crawler_frontier.size();
+    return true;
+}
+
+
+/**
+ * @brief Adds a url to the frontier of the web crawler, then calls the spider
+ * to make as many requests as allowed.
+ * @param url
+ * @param priority the depth of url from the start url; lower depths go first
+ */
+void Graph::webCrawlEnqueue(const QUrl &url, const int &priority) {
+    m_crawler_frontier.enqueue(url, priority);
+    webSpider();
+}
+
+
+
 /**
- * @brief A loop, that constantly takes the url awaiting in fron of the urlQueue, and signals to the MW to make the network request
+ * @brief Takes urls from the frontier and signals the MW to download them,
+ * until there are m_crawler_max_requests requests in flight.
+ * The frontier decides which url goes next: the hosts take turns and each
+ * host may have up to m_crawler_max_host_requests requests in flight and,
+ * if delayed requests are enabled, waits a random delay of up to one second
+ * between its requests. The spider never sleeps: if every host with urls
+ * waits, a single-shot timer calls it again.
+ * It is called again as well whenever a reply arrives or a url is enqueued.
  */
 void Graph::webSpider(){
 
-    //repeat forever....
-    do {
+    // Wait while a checkpoint is written, or begin one when it is due
+    if ( m_crawler_checkpoint_pending ) {
+        return;
+    }
+    if ( m_crawler_checkpoints && webcrawlerThread.isRunning()
+         && m_crawler_visited_urls >= m_crawler_checkpoint_at ) {
+        webCrawlCheckpoint();
+        return;
+    }
+
+    const qint64 now = m_crawler_clock.elapsed();
+    qint64 wakeAt = -1;
+    QUrl currentUrl;
 
-        //  Until we crawl all urls in urlQueue.
-        if ( urlQueue->size() == 0 ) {
-            qDebug () <<"Graph::webSpider() - urlQueue is empty. No more urls to crawl for now... "  ;
-            break;
-        }
+    while ( m_crawler_frontier.requests() < m_crawler_max_requests ) {
 
-        // or until we have reached m_maxNodes
-        if (m_crawler_max_urls > 0 && m_crawler_visited_urls == m_crawler_max_urls) {
+        // Stop when we have reached m_maxNodes
+        if (m_crawler_max_urls > 0 && m_crawler_visited_urls >= m_crawler_max_urls) {
             qDebug () << "Graph::webSpider() - Reached m_maxNodes. STOPPING." ;
-            //                emit finished("message from spider: visitedNodes > maxnodes. ");
             break;
         }
 
-        // Take the first url awaiting in the queue
-        qDebug() << "Graph::webSpider() - urlQueue size " << urlQueue->size()
-                 << " - Taking the first url from the urlQueue  ";
-        QUrl currentUrl = urlQueue->dequeue();
-
-        qDebug() << "Graph::webSpider() - url to download: "
-                 <<  currentUrl
-                  << "Increasing visitedNodes to" << m_crawler_visited_urls + 1
-                  << "and emitting signal to download html code...";
-
-
-        // Check if we need to add some delay in the request
-        if (m_crawler_delayed_requests) {
-            int m_wait_msecs = rand() % 1000;
-            qDebug() << "Graph::webSpider() - Sleeping for" << m_wait_msecs << "msecs";
-            QThread::msleep(m_wait_msecs);
+        if ( !m_crawler_frontier.take(now, currentUrl, wakeAt) ) {
+            break;
         }
 
+        m_crawler_visited_urls++;
+
+        qDebug() << "Graph::webSpider() - url to download:" << currentUrl
+                 << "requests in flight" << m_crawler_frontier.requests()
+                 << "visited urls" << m_crawler_visited_urls
+                 << "frontier size" << m_crawler_frontier.size();
 
         // Signal MW to make the network request
-        qDebug() << "Graph::webSpider() - Emitting signal to the MW to make the network request ";
         emit signalNetworkManagerRequest(currentUrl, NetworkRequestType::Crawler);
+    }
 
-        // increase counter
-        m_crawler_visited_urls++;
+    // Wake up when the first waiting host may be requested again
+    if ( wakeAt != -1 && ( m_crawler_wake_at == -1 || wakeAt < m_crawler_wake_at ) ) {
+        m_crawler_wake_at = wakeAt;
+        const quint64 run = m_crawler_run;
+        QTimer::singleShot( (int) ( wakeAt - now ), this, [this, run]() {
+            if ( run != m_crawler_run ) {
+                return;
+            }
+            m_crawler_wake_at = -1;
+            webSpider();
+        });
+    }
+}
 
 
-    } while ( 1 );
 
+/**
+ * @brief Gets the new bytes of a page downloaded by the MW network manager
+ * for the Web Crawler, and passes them to the Web Crawler, in its own thread,
+ * which parses them while the download goes on.
+ * @param url
+ * @param data
+ */
+void Graph::webCrawlData(const QUrl &url, const QByteArray &data) {
+    emit signalWebCrawlData(url, data);
 }
 
+
+
 /**
- * @brief Gets the reply of a MW network request made by Web Crawler, and emits that reply as is to the Web Crawler.
+ * @brief Gets the end of a MW network request made by Web Crawler, and
+ * passes it, with the last bytes of the page, to the Web Crawler to finish
+ * parsing. Then, the spider can make another request.
+ * @param url
+ * @param locationHeader
+ * @param data
  */
-void Graph::slotHandleCrawlerRequestReply(){
+void Graph::slotHandleCrawlerRequestReply(const QUrl &url,
+                                          const QString &locationHeader,
+                                          const QByteArray &data){
 
     qDebug() << "Graph::slotHandleCrawlerRequestReply() - Got reply from MW network manager request...";
 
-    // Get network reply from the sender
-    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    m_crawler_frontier.finished(url);
 
     qDebug() << "Graph::slotHandleCrawlerRequestReply() - Emitting signal to Web Crawler to parse the reply...";
-    emit signalWebCrawlParse(reply);
+    emit signalWebCrawlParse(url, locationHeader, data);
 
+    webSpider();
 }
 
 
 
 /**
- * @brief Computes and returns the arc reciprocity of the graph.
- * Also computes the dyad reciprocity and fills parameters with values.
-
- * @return
+ * @brief Recounts the tie counters of the current relation from scratch:
+ * the total and reciprocated tie weight, the non-symmetric ties, the total
+ * and reciprocated pairs (dyads) and the enabled arcs, plus each vertex's
+ * reciprocated and non-symmetric ties.
+ * A tie v1 -> v2 of an enabled vertex is reciprocated when the edge
+ * v2 -> v1 has the same weight. Every pair is visited once.
+ * Afterwards the edge edits keep the counters up to date, pair by pair,
+ * see graphTieCountersPair().
  */
-qreal Graph::graphReciprocity(){
-
-    qDebug()<< "Graph::graphReciprocity()";
-
-    if ( calculatedGraphReciprocity ){
-        qDebug() << "Graph::graphReciprocity() - graph not modified and "
-                    "already calculated reciprocity. Returning previous result: "
-                 << m_graphReciprocityArc;
-        return m_graphReciprocityArc;
-    }
-
-    qDebug() << "Graph::graphReciprocity() - Computing...";
+void Graph::graphTieCountersCompute() {
 
-    emit statusMessage ( (tr("Calculating the Arc Reciprocity of the graph...")) );
+    qDebug() << "Graph::graphTieCountersCompute()";
 
-    m_graphReciprocityArc=0;
-    m_graphReciprocityDyad=0;
-    m_graphReciprocityTiesReciprocated=0;
-    m_graphReciprocityTiesNonSymmetric=0;
-    m_graphReciprocityTiesTotal=0;
-    m_graphReciprocityPairsReciprocated=0;
-    m_graphReciprocityPairsTotal=0;
+    m_tiesWeight = 0;
+    m_tiesWeightReciprocated = 0;
+    m_tiesNonSymmetric = 0;
+    m_tiePairs = 0;
+    m_tiePairsReciprocated = 0;
+    m_tieArcs = 0;
 
-    qreal weight = 0, reciprocalWeight = 0;
-
-    int y=0, v2=0, v1=0;
+    int v1 = 0, v2 = 0, arcs = 0;
+    qreal reverseWeight = 0;
 
     QHash<int,qreal> enabledOutEdges;
-
     QHash<int,qreal>::const_iterator hit;
-    VList::const_iterator it, it1;
-
-    H_StrToBool totalDyads;
-    H_StrToBool reciprocatedDyads;
-    QString pair, reversePair;
+    VList::const_iterator it;
 
-    //initialize counters
     for ( it = m_graph.cbegin(); it != m_graph.cend(); ++it) {
         (*it)->setOutEdgesReciprocated(0);
         (*it)->setOutEdgesNonSym(0);
         (*it)->setInEdgesNonSym(0);
+        arcs += (*it)->outEdges();
     }
 
-    // Compute "arc" reciprocity
-    //  the number of ties that are involved in reciprocal relations
-    //  relative to the total number of actual ties (not possible ties)
-    for ( it = m_graph.cbegin(); it != m_graph.cend(); ++it)
-    {
-        v1 = (*it) -> name();
+    for ( it = m_graph.cbegin(); it != m_graph.cend(); ++it) {
 
         if ( ! (*it)->isEnabled() )
             continue;
 
-        enabledOutEdges=(*it)->outEdgesEnabledHash();
-
-        hit=enabledOutEdges.cbegin();
-
-        while ( hit!=enabledOutEdges.cend() ){
+        v1 = (*it)->name();
+        enabledOutEdges = (*it)->outEdgesEnabledHash();
 
+        for ( hit = enabledOutEdges.cbegin(); hit != enabledOutEdges.cend(); ++hit ) {
             v2 = hit.key();
-            y=vpos[ v2 ];
-            weight = hit.value();
-            m_graphReciprocityTiesTotal += weight;
-
-            // Compute "dyad" reciprocity
-            pair = QString::number(v1) + ">" + QString::number(v2) ;
-            reversePair = QString::number(v2) + ">" + QString::number(v1) ;
-            if ( !totalDyads.contains(pair) && !totalDyads.contains(reversePair) ) {
-                totalDyads [pair] = true;
+            // Leave the pair to v2, if v2 is the smaller one with a tie to v1
+            if ( v2 < v1
+                 && m_graph[ vpos[v2] ]->isEnabled()
+                 && m_graph[ vpos[v2] ]->outEdgeStatus(v1, reverseWeight) ) {
+                continue;
             }
+            graphTieCountersPair(v1, v2, +1);
+        }
+    }
 
+    // The pairs above counted the arcs of enabled vertices only
+    m_tieArcs = arcs;
 
-            qDebug() << pair
-                     << "totalTies" << m_graphReciprocityTiesTotal
-                     << "totalDyads" << totalDyads.count();
-
-            if (  (reciprocalWeight = edgeExists(v2, v1) ) == weight) {
-
-                (*it)->setOutEdgesReciprocated(); //increase reciprocated ties for ego
-                (*it)->setOutEdgesReciprocated();
+    m_tieCountersValid = true;
+    m_tieCountersVersion = m_graphVersion;
 
-                m_graphReciprocityTiesReciprocated  +=reciprocalWeight  ;
+    qDebug() << "Graph::graphTieCountersCompute() - ties" << m_tiesWeight
+             << "reciprocated" << m_tiesWeightReciprocated
+             << "non-symmetric" << m_tiesNonSymmetric
+             << "pairs" << m_tiePairs
+             << "reciprocated pairs" << m_tiePairsReciprocated
+             << "arcs" << m_tieArcs;
+}
 
-                pair = QString::number(v2) + ">" + QString::number(v1) ;
-                reversePair = QString::number(v1) + ">" + QString::number(v2) ;
-                if ( !reciprocatedDyads.contains(pair) && !reciprocatedDyads.contains(reversePair) ) {
-                    reciprocatedDyads [pair] = true;
-                }
 
 
-                qDebug() << pair << "reciprocal!"
-                          << "reciprocatedTies" << m_graphReciprocityTiesReciprocated
-                          << "reciprocatedDyads" << reciprocatedDyads.count();
+/**
+ * @brief Adds (sign=+1) or subtracts (sign=-1) the share of the pair v1, v2
+ * in the tie counters, as the pair is now. An edge edit subtracts the pair
+ * before it changes it and adds it back afterwards, in O(1).
+ * If flipSource -> flipTarget is given, the pair is taken as if the enabled
+ * status of that arc were the opposite of what it is now.
+ * @param v1
+ * @param v2
+ * @param sign
+ * @param flipSource
+ * @param flipTarget
+ */
+void Graph::graphTieCountersPair(const int &v1, const int &v2, const int &sign,
+                                 const int &flipSource, const int &flipTarget) {
 
-            }
-            else {
-                (*it)->setOutEdgesNonSym();
-                m_graph[y]->setInEdgesNonSym();
-                m_graphReciprocityTiesNonSymmetric++;
-            }
+    GraphVertex *vertex1 = m_graph[ vpos[v1] ];
+    GraphVertex *vertex2 = m_graph[ vpos[v2] ];
+    const bool loop = ( v1 == v2 );
 
-            ++hit;
-        }
+    qreal weight12 = 0, weight21 = 0;
+    bool arc12 = vertex1->outEdgeStatus(v2, weight12);
+    bool arc21 = false;
+    if ( ! loop ) {
+        arc21 = vertex2->outEdgeStatus(v1, weight21);
+    }
+    if ( flipSource == v1 && flipTarget == v2 ) {
+        arc12 = ! arc12;
+    }
+    else if ( flipSource == v2 && flipTarget == v1 ) {
+        arc21 = ! arc21;
+    }
+    if ( loop ) {
+        arc21 = arc12;
+        weight21 = weight12;
     }
-    //delete enabledOutEdges;
-
-    m_graphReciprocityArc = (qreal) m_graphReciprocityTiesReciprocated / (qreal) m_graphReciprocityTiesTotal;
 
-    m_graphReciprocityPairsReciprocated = reciprocatedDyads.count();
-    m_graphReciprocityPairsTotal = totalDyads.count();
+    m_tieArcs += sign * ( ( arc12 ? 1 : 0 ) + ( ( ! loop && arc21 ) ? 1 : 0 ) );
 
-    m_graphReciprocityDyad = (qreal) m_graphReciprocityPairsReciprocated / (qreal) m_graphReciprocityPairsTotal;
+    bool pair = false, pairReciprocated = false;
 
-    qDebug() << "Graph: graphReciprocity() - Finished. Arc reciprocity:"
-             << m_graphReciprocityTiesReciprocated
-             << "/"
-             << m_graphReciprocityTiesTotal << "="  << m_graphReciprocityArc << endl
-             << m_graphReciprocityPairsReciprocated
-             << "/"
-             << m_graphReciprocityPairsTotal << "=" << m_graphReciprocityDyad;
+    // A tie counts if its source is enabled. Its reverse weight is that of
+    // the opposite edge if enabled, else 0.
+    for (int d = 0; d < ( loop ? 1 : 2 ); ++d) {
+        GraphVertex *source = ( d == 0 ) ? vertex1 : vertex2;
+        GraphVertex *target = ( d == 0 ) ? vertex2 : vertex1;
+        const bool arc = ( d == 0 ) ? arc12 : arc21;
+        const qreal weight = ( d == 0 ) ? weight12 : weight21;
+        const qreal reverseWeight = ( d == 0 ) ? ( arc21 ? weight21 : 0 )
+                                               : ( arc12 ? weight12 : 0 );
+        if ( ! arc || ! source->isEnabled() ) {
+            continue;
+        }
+        pair = true;
+        m_tiesWeight += sign * weight;
+        if ( reverseWeight == weight ) {
+            pairReciprocated = true;
+            m_tiesWeightReciprocated += sign * reverseWeight;
+            source->setOutEdgesReciprocated( source->outEdgesReciprocated() + 2 * sign );
+        }
+        else {
+            m_tiesNonSymmetric += sign;
+            source->setOutEdgesNonSym( source->outEdgesNonSym() + sign );
+            target->setInEdgesNonSym( target->inEdgesNonSym() + sign );
+        }
+    }
 
+    m_tiePairs += sign * ( pair ? 1 : 0 );
+    m_tiePairsReciprocated += sign * ( pairReciprocated ? 1 : 0 );
+}
 
 
-    calculatedGraphReciprocity = true;
 
-    return m_graphReciprocityArc;
+/**
+ * @brief Marks the tie counters, just updated by an edge edit, as
+ * describing the current graph version
+ */
+void Graph::graphTieCountersUpdated() {
+    m_tieCountersVersion = m_graphVersion;
+    m_tieCountersArcVersion = m_graphVersion;
+}
+
+
+
+/**
+ * @brief Computes and returns the arc reciprocity of the graph.
+ * Also computes the dyad reciprocity and fills parameters with values.
+
+ * @return
+ */
+qreal Graph::graphReciprocity(){
+
+    qDebug()<< "Graph::graphReciprocity()";
+
+    if ( calculatedGraphReciprocity ){
+        qDebug() << "Graph::graphReciprocity() - graph not modified and "
+                    "already calculated reciprocity. Returning previous result: "
+                 << m_graphReciprocityArc;
+        return m_graphReciprocityArc;
+    }
+
+    if ( ! tieCountersValid() ) {
+        qDebug() << "Graph::graphReciprocity() - Computing...";
+        emit statusMessage ( (tr("Calculating the Arc Reciprocity of the graph...")) );
+        graphTieCountersCompute();
+    }
+
+    m_graphReciprocityTiesReciprocated = m_tiesWeightReciprocated;
+    m_graphReciprocityTiesNonSymmetric = m_tiesNonSymmetric;
+    m_graphReciprocityTiesTotal = m_tiesWeight;
+    m_graphReciprocityPairsReciprocated = m_tiePairsReciprocated;
+    m_graphReciprocityPairsTotal = m_tiePairs;
+
+    m_graphReciprocityArc = m_tiesWeightReciprocated / m_tiesWeight;
+    m_graphReciprocityDyad = (qreal) m_graphReciprocityPairsReciprocated / (qreal) m_graphReciprocityPairsTotal;
+
+    qDebug() << "Graph: graphReciprocity() - Finished. Arc reciprocity:"
+             << m_graphReciprocityTiesReciprocated
+             << "/"
+             << m_graphReciprocityTiesTotal << "="  << m_graphReciprocityArc << endl
+             << m_graphReciprocityPairsReciprocated
+             << "/"
+             << m_graphReciprocityPairsTotal << "=" << m_graphReciprocityDyad;
+
+
+
+    calculatedGraphReciprocity = true;
+
+    return m_graphReciprocityArc;
 }
 
 
@@ -3697,7 +4640,7 @@ qreal Graph::graphReciprocity(){
 
 
 
-
+
 /**
  * @brief Writes reciprocity report to filename
  * @param fileName
@@ -3705,6 +4648,9 @@ qreal Graph::graphReciprocity(){
  */
 void Graph::writeReciprocity(const QString fileName, const bool considerWeights)
 {
+
+    GraphTraceScope trace("Graph::writeReciprocity");
+    trace.setInput( vertices(), edgesEnabled() );
     qDebug() << "Graph::writeReciprocity()";
 
     Q_UNUSED(considerWeights);
@@ -3736,7 +4682,7 @@ void Graph::writeReciprocity(const QString fileName, const bool considerWeights)
 
     QString pMsg = tr("Writing Reciprocity to file. \nPlease wait...");
     emit statusMessage ( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     outText << htmlHead;
 
@@ -3852,7 +4798,7 @@ void Graph::writeReciprocity(const QString fileName, const bool considerWeights)
     VList::const_iterator it;
     for (it= m_graph.cbegin(); it!= m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         rowCount++;
         qDebug() << "Graph::writeReciprocity outnon  - innon - rec"
@@ -3948,7 +4894,7 @@ void Graph::writeReciprocity(const QString fileName, const bool considerWeights)
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 }
 
 
@@ -3967,46 +4913,10 @@ bool Graph::graphIsSymmetric(){
                  << m_graphIsSymmetric;
         return m_graphIsSymmetric;
     }
-    m_graphIsSymmetric=true;
-    int v2=0, v1=0;
-    qreal weight = 0;
-
-    QHash<int,qreal> enabledOutEdges;
-
-    QHash<int,qreal>::const_iterator hit;
-    VList::const_iterator lit;
-
-
-    for ( lit = m_graph.cbegin(); lit != m_graph.cend(); ++lit)
-    {
-        v1 = (*lit) -> name();
-
-        if ( ! (*lit)->isEnabled() )
-            continue;
-
-        enabledOutEdges=(*lit)->outEdgesEnabledHash();
-
-        hit=enabledOutEdges.cbegin();
-
-        while ( hit!=enabledOutEdges.cend() ){
-
-            v2 = hit.key();
-            weight = hit.value();
-
-            if ( edgeExists ( v2, v1 )  != weight) {
-
-                m_graphIsSymmetric=false;
-                //                qDebug() <<"Graph::graphIsSymmetric() - "
-                //                         << " graph not symmetric because "
-                //                         << v1 << " -> " << v2 << " weight " << weight
-                //                         << " differs from " << v2 << " -> " << v1 ;
-
-                break;
-            }
-            ++hit;
-        }
+    if ( ! tieCountersValid() ) {
+        graphTieCountersCompute();
     }
-    //delete enabledOutEdges;
+    m_graphIsSymmetric = ( m_tiesNonSymmetric == 0 );
     qDebug() << "Graph: graphIsSymmetric() - Finished. Result:"  << m_graphIsSymmetric;
     calculatedGraphSymmetry = true;
     return m_graphIsSymmetric;
@@ -4017,47 +4927,60 @@ bool Graph::graphIsSymmetric(){
 
 /**
  * @brief Transforms the graph to symmetric (all edges reciprocal)
+ * The sorted out- and in-rows of each vertex in graphCSR() are merged:
+ * an arc without its opposite gets a copy of it, and a reciprocated pair
+ * takes the weight of the arc from the vertex that comes first in m_graph.
+ * The changes are applied in one bulk build.
  */
 void Graph::graphSymmetrize(){
     qDebug()<< "Graph::graphSymmetrize";
-    VList::const_iterator it;
-    int v2=0, v1=0, weight;
-    qreal invertWeight=0;
-    QHash<int,qreal> enabledOutEdges;
-    QHash<int,qreal>::const_iterator it1;
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        v1 = (*it)->name();
-        qDebug() << "Graph:graphSymmetrize() - iterate over edges of v1 " << v1;
-        enabledOutEdges=(*it)->outEdgesEnabledHash();
-        it1=enabledOutEdges.cbegin();
-        while ( it1!=enabledOutEdges.cend() ){
-            v2 = it1.key();
-            weight = it1.value();
-            qDebug() << "Graph:graphSymmetrize() - "
-                     << " v1 " << v1
-                     << " outLinked to " << v2 << " weight " << weight;
-            invertWeight = edgeExists(v2,v1);
-            if ( invertWeight == 0 ) {
-                qDebug() << "Graph:graphSymmetrize(): s = " << v1
-                         << " is NOT inLinked from y = " <<  v2  ;
-                edgeCreate( v2, v1, weight, initEdgeColor, false, true, false,
-                            QString(), false);
-            }
-            else {
-                qDebug() << "Graph: graphSymmetrize(): v1 = " << v1
-                         << " is already inLinked from v2 = " << v2 ;
-                if (weight!= invertWeight )
-                    edgeWeightSet(v2,v1,weight);
-            }
 
-            ++it1;
+    QVector<int> createSources, createTargets, setSources, setTargets;
+    QVector<qreal> createWeights, setWeights;
+    {
+        const GraphCSR &csr = graphCSR();
+        for (int i = 0; i < csr.vertices(); ++i) {
+            int ei = csr.inBegin(i);
+            const int eiEnd = csr.inEnd(i);
+            for (int eo = csr.outBegin(i); eo < csr.outEnd(i); ++eo) {
+                const int j = csr.outTarget(eo);
+                const qreal weight = csr.outWeight(eo);
+                while ( ei < eiEnd && csr.inSource(ei) < j ) {
+                    ++ei;
+                }
+                if ( ei < eiEnd && csr.inSource(ei) == j ) {
+                    if ( j > i && csr.inWeight(ei) != weight ) {
+                        qDebug() << "Graph: graphSymmetrize(): v1 = " << csr.name(i)
+                                 << " is already inLinked from v2 = " << csr.name(j)
+                                 << " with another weight";
+                        setSources.append( csr.name(j) );
+                        setTargets.append( csr.name(i) );
+                        setWeights.append( weight );
+                    }
+                    continue;
+                }
+                qDebug() << "Graph:graphSymmetrize(): s = " << csr.name(i)
+                         << " is NOT inLinked from y = " << csr.name(j);
+                createSources.append( csr.name(j) );
+                createTargets.append( csr.name(i) );
+                createWeights.append( weight );
+            }
         }
     }
-    //delete enabledOutEdges;
+
+    graphBulkBegin( 0, createSources.size() + setSources.size() );
+
+    for (int k = 0; k < createSources.size(); ++k) {
+        edgeCreate( createSources[k], createTargets[k], createWeights[k], initEdgeColor,
+                    EdgeType::Directed, true, false, QString(), false);
+    }
+    for (int k = 0; k < setSources.size(); ++k) {
+        edgeWeightSet( setSources[k], setTargets[k], setWeights[k] );
+    }
 
     m_graphIsSymmetric=true;
 
-    graphSetModified(GraphChange::ChangedEdges);
+    graphBulkCommit(GraphChange::ChangedEdges);
 }
 
 
@@ -4066,83 +4989,58 @@ void Graph::graphSymmetrize(){
  * @brief Creates a new symmetric relation by keeping only strong-ties (mutual links)
  * in the current relation. In the new relation, two actors are connected only if
  * they are mutually connected in the current relation.
+ * If allRelations is true, two actors are connected if they are mutually
+ * connected in the union of all relations, see graphCSRUnion().
  * @param allRelations
  */
 void Graph::graphSymmetrizeStrongTies(const bool &allRelations){
 
-    qDebug()<< "Graph::graphSymmetrizeStrongTies()"
+    qCHotDebug(lcGraph)<< "Graph::graphSymmetrizeStrongTies()"
             << "initial relations"<<relations();
 
-    int y=0, v2=0, v1=0, weight;
-    qreal invertWeight=0;
-
-    VList::const_iterator it;
-
-    QHash<int,qreal> outEdgesAll;
-    QHash<int,qreal>::const_iterator it1;
-
-    QHash<QString,qreal> *strongTies = new QHash<QString,qreal>;
-
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        v1 = (*it)->name();
-        qDebug() << "Graph::graphSymmetrizeStrongTies() - v" << v1
-                 << "iterate over outEdges in all relations";
-        outEdgesAll=(*it)->outEdgesEnabledHash(allRelations); //outEdgesAllRelationsUniqueHash();
-        it1=outEdgesAll.cbegin();
-        while ( it1!=outEdgesAll.cend() ){
-            v2 = it1.key();
-            weight = it1.value();
-            y=vpos[ v2 ];
-            qDebug() << "Graph::graphSymmetrizeStrongTies() - "
-                     << v1 << "->" << v2 << "=" << weight << "Checking opposite.";
-            invertWeight = m_graph[y]->hasEdgeTo( v1,allRelations ) ;
-            if ( invertWeight == 0 ) {
-                qDebug() << "Graph::graphSymmetrizeStrongTies() - " << v1
-                         << "<-" <<  v2 << " does not exist. Weak tie. Continue." ;
-            }
-            else {
-                if (!strongTies->contains(QString::number(v1)+"--"+QString::number(v2)) &&
-                        !strongTies->contains(QString::number(v2)+"--"+QString::number(v1)) ){
-                    qDebug() << "Graph::graphSymmetrizeStrongTies() - " << v1
-                             << "--" << v2 << " exists. Strong Tie. Adding";
-                    strongTies->insert(QString::number(v1)+"--"+QString::number(v2), 1);
+    // The mutual pairs are read from the CSR snapshot of the current
+    // relation, or of the union of all relations, each pair once, by
+    // merging the sorted out- and in-rows of each vertex.
+    QVector<int> sources, targets;
+    {
+        const GraphCSR &csr = allRelations ? graphCSRUnion(GraphCSR::ReduceMax)
+                                           : graphCSR();
+        for (int i = 0; i < csr.vertices(); ++i) {
+            int ei = csr.inBegin(i);
+            const int eiEnd = csr.inEnd(i);
+            for (int eo = csr.outBegin(i); eo < csr.outEnd(i); ++eo) {
+                const int j = csr.outTarget(eo);
+                while ( ei < eiEnd && csr.inSource(ei) < j ) {
+                    ++ei;
                 }
-                else {
-                    qDebug() << "Graph::graphSymmetrizeStrongTies() - " << v1
-                             << "--" << v2 << " exists. Strong Tie already found. Continue";
+                if ( j < i || csr.outWeight(eo) == 0 || ei == eiEnd
+                     || csr.inSource(ei) != j || csr.inWeight(ei) == 0 ) {
+                    continue;
                 }
+                qCHotDebug(lcGraph) << "Graph::graphSymmetrizeStrongTies() - "
+                         << csr.name(i) << "--" << csr.name(j) << " exists. Strong Tie. Adding";
+                sources.append( csr.name(i) );
+                targets.append( csr.name(j) );
             }
-            ++it1;
         }
     }
 
-
     relationAdd("Strong Ties",true);
 
-    QHash<QString,qreal>::const_iterator it2;
-    it2=strongTies->constBegin();
-    QStringList vertices;
-    qDebug() << "Graph::graphSymmetrizeStrongTies() - creating strong tie edges";
-    while ( it2!=strongTies->constEnd() ){
-        vertices = it2.key().split("--");
-        qDebug() << "Graph::graphSymmetrizeStrongTies() - tie " <<it2.key()
-                 << "vertices.at(0)" << vertices.at(0)
-                 << "vertices.at(1)" << vertices.at(1);
-        v1 = (vertices.at(0)).toInt();
-        v2 = (vertices.at(1)).toInt();
-        qDebug() << "Graph::graphSymmetrizeStrongTies() - calling edgeCreate for"
-                 << v1 << "--"<<v2;
-        edgeCreate( v1, v2, 1, initEdgeColor, EdgeType::Undirected, true, false,
+    qCHotDebug(lcGraph) << "Graph::graphSymmetrizeStrongTies() - creating"
+                        << sources.size() << "strong tie edges";
+
+    graphBulkBegin( 0, sources.size(), true );
+    for (int k = 0; k < sources.size(); ++k) {
+        edgeCreate( sources[k], targets[k], 1, initEdgeColor,
+                    EdgeType::Undirected, true, false,
                     QString(), false);
-        ++it2;
     }
 
-    //delete outEdgesAll;
-    delete strongTies;
     m_graphIsSymmetric=true;
 
-    graphSetModified(GraphChange::ChangedEdges);
-    qDebug()<< "Graph::graphSymmetrizeStrongTies()"
+    graphBulkCommit(GraphChange::ChangedEdges);
+    qCHotDebug(lcGraph)<< "Graph::graphSymmetrizeStrongTies()"
             << "final relations"<<relations();
 }
 
@@ -4160,59 +5058,77 @@ void Graph::graphSymmetrizeStrongTies(const bool &allRelations){
 * common neighbors. The resulting relation is symmetric.
  */
 void Graph::graphCocitation(){
-    qDebug()<< "Graph::graphCocitation()"
+    qCHotDebug(lcGraph)<< "Graph::graphCocitation()"
             << "initial relations"<<relations();
 
-    int v1=0, v2=0, i=0, j=0, weight;
-    bool dropIsolates = false;
-
-    graphMatrixAdjacencyCreate();
-
-    Matrix *CT = new Matrix (AM.rows(), AM.cols());
-    *CT = AM.cocitationMatrix();
-
-    //CT->printMatrixConsole(true);
-
-    VList::const_iterator it, it1;
+    // C = A^T A is computed row by row straight from graphCSR(), with a
+    // dense accumulator (Gustavson): row i sums the out-rows of the citers
+    // of i. C is symmetric, so only the upper triangle j > i is kept, and
+    // each pair becomes one undirected edge. Touched entries are marked
+    // apart from their sums, which negative weights may cancel to 0.
+    QVector<int> sources, targets;
+    QVector<qreal> weights;
+    {
+        const GraphCSR &csr = graphCSR();
+        const int V = csr.vertices();
 
-    relationAdd("Cocitation",true);
+        QVector<qreal> row(V, 0);
+        vector<char> mark(V, 0);
+        QVector<int> touched;
 
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        if ( ! (*it)->isEnabled() || ( (*it)->isIsolated() && dropIsolates) ) {
-            continue;
-        }
-        v1 = (*it)->name();
-        j = 0;
-        for (it1=m_graph.cbegin(); it1!=m_graph.cend(); it1++){
-            qDebug()<< "Graph::graphCocitation() - (i,j)" << i+1<<j+1;
-            if ( ! (*it1)->isEnabled() || ( (*it1)->isIsolated() && dropIsolates) ) {
+        for (int i = 0; i < V; ++i) {
+            if ( ! csr.isEnabled(i) ) {
                 continue;
             }
-            v2 = (*it1)->name();
-
-            if (v1==v2) {
-                j++;
-                qDebug()<< "Graph::graphCocitation() - skipping self loop" << v1<<v2;
-                continue;
+            for (int ei = csr.inBegin(i); ei < csr.inEnd(i); ++ei) {
+                const int k = csr.inSource(ei);
+                if ( ! csr.isEnabled(k) ) {
+                    continue;
+                }
+                const qreal a = csr.inWeight(ei);
+                for (int eo = csr.outBegin(k); eo < csr.outEnd(k); ++eo) {
+                    const int j = csr.outTarget(eo);
+                    if ( j <= i || ! csr.isEnabled(j) ) {
+                        continue;
+                    }
+                    if ( ! mark[j] ) {
+                        mark[j] = 1;
+                        touched.append(j);
+                    }
+                    row[j] += a * csr.outWeight(eo);
+                }
             }
-            if ( (weight = CT->item(i, j) ) != 0 ) {
-                qDebug()<< "Graph::graphCocitation() - creating edge"
-                        << v1 << "<->" << v2
-                        << "because CT(" << i+1 << "," <<  j+1 << ") = " << weight;
-                edgeCreate( v1, v2, weight, initEdgeColor,
-                            EdgeType::Undirected, true, false,
-                            QString(), false);
+            for (const int &j : touched) {
+                if ( row[j] != 0 ) {
+                    qCHotDebug(lcGraph)<< "Graph::graphCocitation() - creating edge"
+                            << csr.name(i) << "<->" << csr.name(j)
+                            << "because C =" << row[j];
+                    sources.append( csr.name(i) );
+                    targets.append( csr.name(j) );
+                    weights.append( row[j] );
+                }
+                row[j] = 0;
+                mark[j] = 0;
             }
-
-            j++;
+            touched.clear();
         }
-        i++;
+    }
+
+    qCHotDebug(lcGraph)<< "Graph::graphCocitation() - C non-zeros" << sources.size();
+
+    relationAdd("Cocitation",true);
+
+    graphBulkBegin( 0, sources.size(), true );
+    for (int k = 0; k < sources.size(); ++k) {
+        edgeCreate( sources[k], targets[k], weights[k], initEdgeColor,
+                    EdgeType::Undirected, true, false,
+                    QString(), false);
     }
 
     m_graphIsSymmetric=true;
 
-    graphSetModified(GraphChange::ChangedEdges);
-    qDebug()<< "Graph::graphCocitation()"
+    graphBulkCommit(GraphChange::ChangedEdges);
+    qCHotDebug(lcGraph)<< "Graph::graphCocitation()"
             << "final relations"<<relations();
 }
 
@@ -4226,68 +5142,48 @@ void Graph::graphDichotomization(const qreal threshold) {
     qDebug()<< "Graph::graphDichotomization()"
             << "initial relations"<<relations();
 
-    int v2 = 0, v1 = 0;
-    qreal weight = 0;
-
-    VList::const_iterator it;
-
-    QHash<int,qreal> outEdgesAll;
-    QHash<int,qreal>::const_iterator it1;
-
-    QHash<QString,qreal> *binaryTies = new QHash<QString,qreal>;
+    // The edges over the threshold are the tail of the weight index.
+    // Each pair gives one undirected binary tie, whatever its direction.
+    const GraphWeightIndex &index = graphWeightIndex();
 
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        v1 = (*it)->name();
-        qDebug() << "Graph::graphDichotomization() - v" << v1
-                 << "iterate over outEdges in all relations";
-        outEdgesAll=(*it)->outEdgesEnabledHash(false);
-        it1=outEdgesAll.cbegin();
-        while ( it1!=outEdgesAll.cend() ){
-            v2 = it1.key();
-            weight = it1.value();
+    QSet<quint64> binaryTies;
+    QVector<int> sources, targets;
+    qreal weight = 0;
 
-            qDebug() << "Graph::graphDichotomization() - "
-                     << v1 << "->" << v2 << "=" << weight << "Checking opposite.";
-            if (weight>threshold) {
-                if (!binaryTies->contains(QString::number(v1)+"--"+QString::number(v2) ) ) {
-                    qDebug() << "Graph::graphDichotomization() - " << v1
-                             << "--" << v2 << " over threshold. Adding";
-                    binaryTies->insert(QString::number(v1)+"--"+QString::number(v2), 1);
-                }
-                else {
-                    qDebug() << "Graph::graphDichotomization() - " << v1
-                             << "--" << v2 << " exists. Binary Tie already found. Continue";
-                }
-            }
-            ++it1;
+    for (int e = index.upperBound(threshold); e < index.size(); ++e) {
+        GraphVertex *vertex = m_graph[ index.source(e) ];
+        const int v1 = vertex->name();
+        const int v2 = index.target(e);
+        if ( ! vertex->outEdgeStatus(v2, weight) ) {
+            continue;
         }
+        const quint64 key = ( (quint64) qMin(v1, v2) << 32 ) | (quint32) qMax(v1, v2);
+        if ( binaryTies.contains(key) ) {
+            qDebug() << "Graph::graphDichotomization() - " << v1
+                     << "--" << v2 << " exists. Binary Tie already found. Continue";
+            continue;
+        }
+        qDebug() << "Graph::graphDichotomization() - " << v1
+                 << "--" << v2 << " over threshold. Adding";
+        binaryTies.insert(key);
+        sources.append(v1);
+        targets.append(v2);
     }
 
     relationAdd("Binary-"+QString::number(threshold),true);
 
-    QHash<QString,qreal>::const_iterator it2;
-    it2=binaryTies->constBegin();
-    QStringList vertices;
-    qDebug() << "Graph::graphDichotomization() - creating binary tie edges";
-    while ( it2!=binaryTies->constEnd() ){
-        vertices = it2.key().split("--");
-        qDebug() << "Graph::graphDichotomization() - binary tie " <<it2.key()
-                 << "vertices.at(0)" << vertices.at(0)
-                 << "vertices.at(1)" << vertices.at(1);
-        v1 = (vertices.at(0)).toInt();
-        v2 = (vertices.at(1)).toInt();
-        qDebug() << "Graph::graphDichotomization() - calling edgeCreate for"
-                 << v1 << "--"<<v2;
-        edgeCreate( v1, v2, 1, initEdgeColor, EdgeType::Undirected, true, false,
+    qDebug() << "Graph::graphDichotomization() - creating" << sources.size()
+             << "binary tie edges";
+
+    graphBulkBegin( 0, sources.size(), true );
+    for (int i = 0; i < sources.size(); ++i) {
+        edgeCreate( sources[i], targets[i], 1, initEdgeColor, EdgeType::Undirected, true, false,
                     QString(), false);
-        ++it2;
     }
 
-    //delete outEdgesAll;
-    delete binaryTies;
     m_graphIsSymmetric=true;
 
-    graphSetModified(GraphChange::ChangedEdges);
+    graphBulkCommit(GraphChange::ChangedEdges);
     qDebug()<< "Graph::graphDichotomization()"
             << "final relations"<<relations();
 
@@ -4409,7 +5305,7 @@ void Graph::edgeTypeSet(const int &v1,
                         const qreal &weight,
                         const int &dirType) {
 
-    qDebug() << "Graph::edgeTypeSet(): " << v1
+    qCHotDebug(lcGraph) << "Graph::edgeTypeSet(): " << v1
              << " -> " <<  v2  << "edgeType" << dirType;
 
     if (dirType!=EdgeType::Directed) {
@@ -4419,7 +5315,7 @@ void Graph::edgeTypeSet(const int &v1,
 
         if ( inverseWeight == 0 ) {
             // if the opposite edge does not exist, add it
-            qDebug() << "Graph::edgeTypeSet(): opposite  " << v1
+            qCHotDebug(lcGraph) << "Graph::edgeTypeSet(): opposite  " << v1
                      << " <- " <<  v2 << " does not exist - Add it to Graph." ;
             // Note: Even if dirType=EdgeType::Undirected we add the opposite edge as EdgeType::Reciprocated
             edgeAdd(v2,v1, weight, EdgeType::Reciprocated, "", initEdgeColor);
@@ -4428,7 +5324,7 @@ void Graph::edgeTypeSet(const int &v1,
             if ( dirType  == EdgeType::Undirected ) {
                 // if the opposite edge does exist, equal edge weights
                 // TOFIX: how do we decide which of the two weights to keep?
-                qDebug() << "Graph::edgeTypeSet(): opposite  " << v1
+                qCHotDebug(lcGraph) << "Graph::edgeTypeSet(): opposite  " << v1
                          << " <- " <<  v2 << " exists - equaling weights." ;
                 if ( weight!= inverseWeight ) {
                     edgeWeightSet(v2,v1,weight);
@@ -4438,7 +5334,9 @@ void Graph::edgeTypeSet(const int &v1,
                 // if dirType is EdgeType::Reciprocated we don't need  to equalize weights
             }
         }
-        emit signalEdgeType( v1, v2, dirType );
+        graphBulkDefer( [=] () {
+            emit signalEdgeType( v1, v2, dirType );
+        } );
     }
 
     //graphSetModified(GraphChange::ChangedEdges);
@@ -4450,1302 +5348,3577 @@ void Graph::edgeTypeSet(const int &v1,
 
 
 /**
- * @brief Returns true if vertices v1 and v2 are reachable.
- * @param v1
- * @param v2
- * @return
+ * @brief Computes the transitive closure (reachability) of the current relation.
+ * Reachability only needs a boolean closure, so instead of running all-pairs
+ * geodesic distances this condenses the graph into its strongly connected
+ * components (see graphComponents()) and then, in reverse
+ * topological order, ORs together the 64-bit packed reach sets of the
+ * successor components. All vertices of a component share one row, so the
+ * store takes C x N bits, where C is the number of components.
+ * Only enabled vertices take part. As with geodesic distances, every vertex
+ * reaches itself, unless the graph has no edges at all.
+ * The result is cached until the graph or the current relation changes.
  */
-bool Graph::graphReachable(const int &v1, const int &v2) {
-    qDebug()<< "Graph::reachable()";
-    graphDistancesGeodesic(false);
-    return ( m_graph[ vpos[v1] ] ->distance( v2) != RAND_MAX ) ? true: false;
-}
-
+void Graph::graphReachabilityClosure() {
 
+    GraphTraceScope trace("Graph::graphReachabilityClosure");
+    trace.setInput( vertices(), edgesEnabled() );
 
+    const GraphCSR &csr = graphCSR();
 
-/**
- * @brief Creates the reachability matrix XRM
- */
-void Graph::graphMatrixReachabilityCreate() {
-    qDebug() << "Graph::graphMatrixReachabilityCreate()";
-
+    if ( m_reachValid
+         && m_reachRelation == csr.relation()
+         && m_reachVersion == csr.version() ) {
+        qDebug() << "Graph::graphReachabilityClosure() - closure up to date";
+        return;
+    }
 
-    graphDistancesGeodesic(false);
+    const int N = csr.vertices();
+    const int *offsets = csr.outOffsets();
+    const int *targets = csr.outTargets();
 
-    VList::const_iterator it, jt;
+    qDebug() << "Graph::graphReachabilityClosure() - N" << N
+             << "arcs" << csr.edges();
 
-    int N = vertices( false, false, true);
+    // Strong components come in reverse topological order of the condensation
+    const GraphComponents &components = graphComponents(true);
+    const int strongComponents = components.strongComponents();
+    const int *memberOffsets = components.strongOffsets().constData();
+    const int *members = components.strongMembers().constData();
+    int v = 0, w = 0;
 
-    int progressCounter=0;
-    int source = 0 , target = 0;
-    int i = 0, j = 0 ;
-    int reachVal = 0;
+    const int words = ( N + 63 ) >> 6;
+    const bool selfReach = ( csr.edges() > 0 );
 
-    XRM.resize(N, N);
+    m_reachRows.assign( (size_t) strongComponents * words, 0 );
+    m_reachComponent = components.strongComponentOf();
+    m_reachWords = words;
 
-    QString pMsg = tr("Creating reachability matrix. \nPlease wait ");
+    QString pMsg = tr("Computing reachability. \nPlease wait ");
     emit statusMessage ( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
-
+    graphProgressCreate(strongComponents, pMsg);
 
-    qDebug() << "Graph: graphMatrixReachabilityCreate() - writing matrix...";
-
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
-
-        emit signalProgressBoxUpdate(++progressCounter);
+    // Successor components are always numbered before their predecessors,
+    // so a single pass in component order closes every row.
+    vector<int> lastMerged(strongComponents, -1);
+    int c = 0, d = 0, k = 0, e = 0, word = 0;
 
-        source = (*it)->name();
+    for ( c = 0; c < strongComponents; ++c ) {
 
-        if  ( ! (*it)->isEnabled()  ) {
-            qDebug() << "Graph: graphMatrixReachabilityCreate() - "
-                     << source << "disabled. SKIP";
-            continue;
+        if ( ( c & 1023 ) == 0 ) {
+            graphProgressUpdate(c);
         }
 
+        quint64 *row = m_reachRows.data() + (size_t) c * words;
 
-        qDebug() << "Graph: graphMatrixReachabilityCreate() - "
-                  << "source" << source
-                  << "i" << i;
+        for ( k = memberOffsets[c]; k < memberOffsets[c+1]; ++k ) {
 
-        for (jt=m_graph.cbegin(); jt!=m_graph.cend(); ++jt) {
-
-            target = (*jt)->name();
-
-            if  ( ! (*jt)->isEnabled()  ) {
-                qDebug() << "Graph: graphMatrixReachabilityCreate() - "
-                         << target << "disabled. SKIP";
-                continue;
+            v = members[k];
+            if ( selfReach ) {
+                row[ v >> 6 ] |= Q_UINT64_C(1) << ( v & 63 );
             }
 
-            qDebug() << "Graph: graphMatrixReachabilityCreate() - "
-                     << "target" << target << "j" << j;
-
-
-            reachVal = ((*it)->distance( target ) != RAND_MAX ) ? 1 : 0;
-            qDebug() << "Graph: graphMatrixReachabilityCreate() -  setting XRM ("<< i <<","<< j << ") =" <<  reachVal;
-            XRM.setItem( i, j, reachVal );
-
-            j++;
+            for ( e = offsets[v]; e < offsets[v+1]; ++e ) {
+                w = targets[e];
+                if ( ! csr.isEnabled(w) ) {
+                    continue;
+                }
+                d = m_reachComponent[w];
+                if ( d == c ) {
+                    // w is in the same component as v: both reach each other
+                    row[ w >> 6 ] |= Q_UINT64_C(1) << ( w & 63 );
+                    continue;
+                }
+                if ( lastMerged[d] == c ) {
+                    continue;
+                }
+                lastMerged[d] = c;
+                const quint64 *successor = m_reachRows.data() + (size_t) d * words;
+                for ( word = 0; word < words; ++word ) {
+                    row[word] |= successor[word];
+                }
+            }
         }
-        j=0;
-        i++;
     }
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
+    m_reachRelation = csr.relation();
+    m_reachVersion = csr.version();
+    m_reachValid = true;
 
+    qDebug() << "Graph::graphReachabilityClosure() - components" << strongComponents
+             << "words per row" << words;
 }
 
 
 
-
 /**
- * @brief Returns the geodesic distance (length of shortest path)
- * from vertex v1 to vertex v2
+ * @brief Returns true if vertices v1 and v2 are reachable.
  * @param v1
  * @param v2
- * @param considerWeights
- * @param inverseWeights
  * @return
  */
-int Graph::graphDistanceGeodesic(const int &v1, const int &v2,
-                                 const bool &considerWeights,
-                                 const bool &inverseWeights){
-    qDebug() <<"Graph::graphDistanceGeodesic()";
-    graphDistancesGeodesic(false, considerWeights, inverseWeights, false);
-    return m_graph[ vpos[v1] ]->distance(v2);
+bool Graph::graphReachable(const int &v1, const int &v2) {
+    qDebug()<< "Graph::reachable()";
+    if ( ! vpos.contains(v1) || ! vpos.contains(v2) ) {
+        return false;
+    }
+    graphReachabilityClosure();
+    return reachabilityClosureReaches( vpos[v1], vpos[v2] );
 }
 
 
 
 
 /**
- * @brief Returns the diameter of the graph, aka the largest geodesic distance
- * between any two vertices
- * @param considerWeights
- * @param inverseWeights
- * @return
+ * @brief Creates the reachability matrix XRM from the transitive closure
  */
-int Graph::graphDiameter(const bool considerWeights,
-                         const bool inverseWeights){
-    qDebug () << "Graph::graphDiameter()" ;
-    graphDistancesGeodesic(false, considerWeights, inverseWeights, false);
-    return m_graphDiameter;
-}
+void Graph::graphMatrixReachabilityCreate() {
+    qDebug() << "Graph::graphMatrixReachabilityCreate()";
 
+    graphReachabilityClosure();
 
+    const GraphCSR &csr = graphCSR();
+    const int N = csr.vertices();
 
-/**
- * @brief Returns the average distance of the graph
- * @param considerWeights
- * @param inverseWeights
- * @param dropIsolates
- * @return
- */
-qreal Graph::graphDistanceGeodesicAverage(const bool considerWeights,
-                                          const bool inverseWeights,
-                                          const bool dropIsolates){
+    // Dense indices of the enabled vertices
+    QVector<int> enabled;
+    enabled.reserve(N);
+    for ( int k = 0; k < N; ++k ) {
+        if ( csr.isEnabled(k) ) {
+            enabled.append(k);
+        }
+    }
 
+    const int M = enabled.size();
 
+    XRM.resize(M, M);
 
-    qDebug() <<"Graph::graphDistanceGeodesicAverage() - Computing distances...";
+    qDebug() << "Graph: graphMatrixReachabilityCreate() - writing matrix...";
 
-    graphDistancesGeodesic(false, considerWeights, inverseWeights, dropIsolates);
+    for ( int i = 0; i < M; ++i ) {
+        for ( int j = 0; j < M; ++j ) {
+            XRM.setItem( i, j, reachabilityClosureReaches( enabled[i], enabled[j] ) ? 1 : 0 );
+        }
+    }
+
+}
 
-    qDebug() <<"Graph::graphDistanceGeodesicAverage() - "
-             << "average distance:"
-             << m_graphAverageDistance;
 
-    return m_graphAverageDistance;
 
+
+/**
+ * @brief Enables or disables the compact geodesic store.
+ * When enabled, graphDistancesGeodesic() stores all pair-wise distances and
+ * shortest path counts in two flat N x N arrays (32-bit each), instead of
+ * filling the per-vertex hashes, which cost a hash node per vertex pair.
+ * GraphVertex::distance() and GraphVertex::shortestPaths() read from it.
+ * Any prior computation is invalidated.
+ * @param toggle
+ */
+void Graph::setDistancesStorageCompact(const bool &toggle) {
+    qDebug() << "Graph::setDistancesStorageCompact() - toggle" << toggle;
+    if ( m_distancesCompact == toggle ) {
+        return;
+    }
+    m_distancesCompact = toggle;
+    distancesStoreClear();
+    calculatedDistances = false;
+    calculatedCentralities = false;
 }
 
 
 
+/**
+ * @brief Allocates the compact geodesic store for N vertices.
+ * All distances are set to infinity and all shortest path counts to zero.
+ * Frees the per-vertex distance hashes.
+ * @param N
+ * @return false if there is not enough memory for the store
+ */
+bool Graph::distancesStoreInit(const int &N) {
+    qDebug() << "Graph::distancesStoreInit() - N" << N;
+    distancesStoreClear();
+    try {
+        m_distancesStore.assign( (size_t) N * N, std::numeric_limits<float>::infinity() );
+        m_sigmasStore.assign( (size_t) N * N, 0 );
+    }
+    catch (const std::bad_alloc &) {
+        qDebug() << "Graph::distancesStoreInit() - cannot allocate store. "
+                    "Falling back to vertex hashes.";
+        distancesStoreClear();
+        return false;
+    }
+    VList::const_iterator it;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+        (*it)->clearDistance();
+        (*it)->clearShortestPaths();
+    }
+    m_distancesStoreSize = N;
+    m_distancesStoreRelation = relationCurrent();
+    GraphTrace::memoryAllocated( distancesStoreBytes() );
+    return true;
+}
+
+
 
 /**
- * @brief Returns the number of geodesics (shortest-paths) in the graph.
-  * @return
+ * @brief Returns the bytes held by the compact geodesic store
+ * @return
  */
-int Graph::graphGeodesics()  {
-    qDebug()<< "Graph::graphGeodesics()";
+qint64 Graph::distancesStoreBytes() const {
+    return (qint64) m_distancesStore.capacity() * sizeof(float)
+            + (qint64) m_sigmasStore.capacity() * sizeof(quint32);
+}
 
-    graphDistancesGeodesic(false, false,false,false);
 
-    qDebug()<< "Graph::graphGeodesics() - geodesics:" << m_graphGeodesicsCount;
-    return m_graphGeodesicsCount;
+
+/**
+ * @brief Frees the compact geodesic store
+ */
+void Graph::distancesStoreClear() {
+    if ( m_distancesStoreSize > 0 ) {
+        GraphTrace::memoryReleased( distancesStoreBytes() );
+    }
+    m_distancesStoreSize = 0;
+    vector<float>().swap(m_distancesStore);
+    vector<quint32>().swap(m_sigmasStore);
+}
 
 
+
+/**
+ * @brief Returns the geodesic distance v1 -> v2 from the compact store.
+ * Returns RAND_MAX if the pair is not connected, if any vertex is unknown
+ * or if the store was computed for another relation.
+ * @param v1 source vertex number
+ * @param v2 target vertex number
+ * @return qreal
+ */
+qreal Graph::distancesStoreDistance(const int &v1, const int &v2) const {
+    if ( m_distancesStoreRelation != m_curRelation ) {
+        return RAND_MAX;
+    }
+    const int i = vpos.value(v1, -1);
+    const int j = vpos.value(v2, -1);
+    if ( i < 0 || j < 0 || i >= m_distancesStoreSize || j >= m_distancesStoreSize ) {
+        return RAND_MAX;
+    }
+    const float d = m_distancesStore[ (size_t) i * m_distancesStoreSize + j ];
+    return ( d == std::numeric_limits<float>::infinity() ) ? RAND_MAX : d;
 }
 
 
 
+/**
+ * @brief Returns the number of shortest paths v1 -> v2 from the compact store.
+ * @param v1 source vertex number
+ * @param v2 target vertex number
+ * @return int
+ */
+int Graph::distancesStoreShortestPaths(const int &v1, const int &v2) const {
+    if ( m_distancesStoreRelation != m_curRelation ) {
+        return 0;
+    }
+    const int i = vpos.value(v1, -1);
+    const int j = vpos.value(v2, -1);
+    if ( i < 0 || j < 0 || i >= m_distancesStoreSize || j >= m_distancesStoreSize ) {
+        return 0;
+    }
+    return m_sigmasStore[ (size_t) i * m_distancesStoreSize + j ];
+}
+
 
 
 /**
- * @brief Checks if the graph is connected, in the sense of a topological space,
- * i.e., there is a path from any vertex to any other vertex in the graph.
- * Called from MW::slotConnectedness()
+ * @brief Returns the CSR adjacency snapshot of the current relation.
+ * The snapshot is rebuilt lazily, only when the graph version or the current
+ * relation has changed since the last build. Every traversal (BFS, dijkstra)
+ * reads edges from here instead of walking the per-vertex edge hashes.
+ * The returned reference is valid until the next structural change.
+ * @return const GraphCSR&
+ */
+const GraphCSR &Graph::graphCSR() {
+    if ( ! m_csr || ! m_csr->isValid( relationCurrent(), m_graphVersion ) ) {
+        qDebug() << "Graph::graphCSR() - snapshot stale, rebuilding for relation"
+                 << relationCurrent() << "version" << m_graphVersion;
+        // Copy-on-write: a snapshot still held by graphSnapshot() users
+        // is left alone and a new one is built.
+        if ( ! m_csr || m_csr.use_count() > 1 ) {
+            m_csr = std::make_shared<GraphCSR>();
+        }
+        m_csr->build( m_graph, vpos, relationCurrent(), m_graphVersion );
+    }
+    return *m_csr;
+}
+
+
+
+/**
+ * @brief Returns a CSR snapshot of the union of all relations: an arc i -> j
+ * for every pair with an enabled edge in any relation, weighted by the sum,
+ * the max or the count of the weights of its edges.
+ * Like graphCSR(), it is rebuilt only when the graph version or the
+ * reduction changes, so that the analyses across relations read it instead
+ * of collecting the edges of every vertex in every call.
+ * @param reduction
+ * @return
+ */
+const GraphCSR &Graph::graphCSRUnion(const GraphCSR::Reduction &reduction) {
+    if ( ! m_csrUnion || ! m_csrUnion->isValid( GraphCSR::AllRelations, m_graphVersion, reduction ) ) {
+        qDebug() << "Graph::graphCSRUnion() - snapshot stale, rebuilding for reduction"
+                 << reduction << "version" << m_graphVersion;
+        if ( ! m_csrUnion ) {
+            m_csrUnion = std::make_shared<GraphCSR>();
+        }
+        m_csrUnion->buildUnion( m_graph, vpos, relations(), reduction, m_graphVersion );
+    }
+    return *m_csrUnion;
+}
+
+
+
+/**
+ * @brief Returns a shared, immutable snapshot of the topology and weights
+ * of the current relation, that is the current graphCSR().
+ * The snapshot stays valid for as long as the caller holds it, even after
+ * the graph changes, so analysis jobs can run on it in worker threads while
+ * the graph keeps being edited. Use GraphCSR::isValid() to check whether the
+ * snapshot still describes the current graph version.
+ * @return std::shared_ptr<const GraphCSR>
+ */
+std::shared_ptr<const GraphCSR> Graph::graphSnapshot() {
+    graphCSR();
+    return m_csr;
+}
+
+
+
+/**
+ * @brief Returns the edges of the current relation, enabled or not, sorted
+ * by weight. The index is rebuilt only when the graph version or the current
+ * relation has changed since the last build, or since edgeFilterByWeight()
+ * last moved its version forward.
+ * @return
+ */
+const GraphWeightIndex &Graph::graphWeightIndex() {
+    if ( ! m_weightIndex.isValid( relationCurrent(), m_graphVersion ) ) {
+        qDebug() << "Graph::graphWeightIndex() - stale, rebuilding for relation"
+                 << relationCurrent() << "version" << m_graphVersion;
+        m_weightIndex.build( m_graph, relationCurrent(), m_graphVersion );
+    }
+    return m_weightIndex;
+}
+
+
+
+/**
+ * @brief Returns the strong and weak components of the current relation.
+ * They are computed from graphCSR() once per graph version. Arcs added with
+ * edgeAdd() are merged into the weak components without a rebuild, while
+ * the strong components are recomputed on demand, if strong is true.
+ * @param strong
+ * @return
+ */
+const GraphComponents &Graph::graphComponents(const bool &strong) {
+    if ( ! m_components.isValid( relationCurrent(), m_graphVersion ) ) {
+        qDebug() << "Graph::graphComponents() - stale, rebuilding for relation"
+                 << relationCurrent() << "version" << m_graphVersion;
+        m_components.build( graphCSR() );
+    }
+    else if ( strong && ! m_components.isStrongValid() ) {
+        qDebug() << "Graph::graphComponents() - rebuilding strong components";
+        m_components.buildStrong( graphCSR() );
+    }
+    return m_components;
+}
+
+
+
+/**
+ * @brief Returns the vertices sorted by their (standardized) score in the
+ * given prominence index. The index is built once per graph version from
+ * the scores last computed, and dropped whenever the scores are computed
+ * again. The caller must have computed the index scores.
+ * @param index
+ * @return
+ */
+const GraphScoreIndex &Graph::prominenceScoreIndex(const int &index) {
+    GraphScoreIndex &scoreIndex = m_prominenceScoreIndex[index];
+    if ( ! scoreIndex.isValid( m_graphVersion ) ) {
+        qDebug() << "Graph::prominenceScoreIndex() - stale, rebuilding index"
+                 << index << "version" << m_graphVersion;
+        QVector<qreal> scores;
+        QVector<int> names;
+        scores.reserve( m_graph.size() );
+        names.reserve( m_graph.size() );
+        VList::const_iterator it;
+        for ( it = m_graph.cbegin(); it != m_graph.cend(); ++it ) {
+            scores << prominenceScore( (*it), index );
+            names << (*it)->name();
+        }
+        scoreIndex.build(scores, names, m_graphVersion);
+    }
+    return scoreIndex;
+}
+
+
+
+/**
+ * @brief Returns the standardized score of vertex in the given prominence index
+ * @param vertex
+ * @param index
+ * @return
+ */
+qreal Graph::prominenceScore(GraphVertex *vertex, const int &index) const {
+    switch (index) {
+    case IndexType::DC :
+        return vertex->SDC();
+    case IndexType::CC :
+        return vertex->SCC();
+    case IndexType::IRCC :
+        return vertex->SIRCC();
+    case IndexType::BC :
+        return vertex->SBC();
+    case IndexType::SC :
+        return vertex->SSC();
+    case IndexType::EC :
+        return vertex->SEC();
+    case IndexType::PC :
+        return vertex->SPC();
+    case IndexType::IC :
+        return vertex->SIC();
+    case IndexType::EVC :
+        return vertex->SEVC();
+    case IndexType::DP :
+        return vertex->SDP();
+    case IndexType::PRP :
+        return vertex->SPRP();
+    case IndexType::PP :
+        return vertex->SPP();
+    default:
+        return 0;
+    }
+}
+
+
+
+/**
+ * @brief Makes the vertices hold the results of the prominence index computed
+ * with these parameters on the current graph version, if m_resultCache or,
+ * when enabled, the on-disk m_resultStore have them.
+ * Returns false if the index must be computed.
+ * @param index
+ * @param parameters see GraphResultCache::parameters()
  * @return bool
  */
-bool Graph::graphIsConnected() {
+bool Graph::resultCacheRestore(const int &index, const int &parameters) {
 
-    qDebug() << "Graph::graphIsConnected() ";
+    if ( m_resultCache.isLive(index, parameters, m_graphVersion) ) {
+        return true;
+    }
 
-    if ( calculatedDistances ) {
-        qDebug()<< "Graph::graphIsConnected() - graph unmodified. Returning:"
-                << m_graphIsConnected;
-        return m_graphIsConnected;
+    const GraphResultCache::Result *result =
+            m_resultCache.find(index, parameters, m_graphVersion);
+
+    if ( result == nullptr && m_resultStore.isEnabled() ) {
+        GraphResultCache::Result stored;
+        const QString entry = resultStoreEntry(index, parameters);
+        if ( m_resultStore.read( graphContentHash(), entry, [&](QDataStream &in) {
+                                 return GraphResultCache::read(in, stored); } )
+             && stored.scores.size() == 2 * m_graph.size() ) {
+            GraphResultCache::Result &slot =
+                    m_resultCache.insert(index, parameters, m_graphVersion);
+            stored.version = m_graphVersion;
+            slot = stored;
+            result = &slot;
+        }
     }
 
-    graphDistancesGeodesic(false, false,false,false);
+    if ( result == nullptr || result->scores.size() != 2 * m_graph.size() ) {
+        return false;
+    }
 
-    return m_graphIsConnected;
+    qDebug() << "Graph::resultCacheRestore() - restoring index" << index
+             << "parameters" << parameters;
+
+    resultCacheApply(index, *result);
+
+    m_resultCache.setLive(index, parameters);
+    m_prominenceScoreIndex.remove(index);
+    return true;
+}
+
+
+
+/**
+ * @brief Files the results of the prominence index just computed with these
+ * parameters in m_resultCache, and in m_resultStore if enabled.
+ * @param index
+ * @param parameters see GraphResultCache::parameters()
+ */
+void Graph::resultCacheStore(const int &index, const int &parameters) {
+
+    GraphResultCache::Result &result =
+            m_resultCache.insert(index, parameters, m_graphVersion);
+
+    resultCacheCapture(index, result);
+
+    m_resultCache.setLive(index, parameters);
+
+    qDebug() << "Graph::resultCacheStore() - stored index" << index
+             << "parameters" << parameters
+             << "results cached" << m_resultCache.size();
+
+    if ( m_resultStore.isEnabled() ) {
+        const QString entry = resultStoreEntry(index, parameters);
+        m_resultStore.write( graphContentHash(), entry, [&](QDataStream &out) {
+            GraphResultCache::write(out, result); } );
+    }
+}
+
+
+
+/**
+ * @brief Returns the name of the m_resultStore entry of a prominence index,
+ * which also holds the solver options its scores depend on
+ * @param index
+ * @param parameters see GraphResultCache::parameters()
+ * @return QString
+ */
+QString Graph::resultStoreEntry(const int &index, const int &parameters) const {
+    QString entry = QString("index-%1-%2").arg(index).arg(parameters);
+    switch (index) {
+    case IndexType::EVC :
+        entry += QString("-%1-%2-%3").arg(m_centralityEigenvectorTolerance)
+                .arg(m_centralityEigenvectorMaxIterations)
+                .arg(m_centralityEigenvectorLanczos);
+        break;
+    case IndexType::PRP :
+        entry += QString("-%1").arg(m_prestigePageRankGaussSeidel);
+        break;
+    default:
+        break;
+    }
+    return entry;
+}
+
+
+
+/**
+ * @brief Copies the results of a prominence index from the vertices and
+ * the graph-wide statistics into result
+ * @param index
+ * @param result
+ */
+void Graph::resultCacheCapture(const int &index, GraphResultCache::Result &result) {
+
+    QList<qreal*> reals;
+    QList<int*> ints;
+    GraphDistribution *distribution = nullptr;
+    resultCacheFields(index, reals, ints, distribution);
+
+    result.reals.clear();
+    result.ints.clear();
+    result.scores.clear();
+
+    for (int i = 0; i < reals.size(); ++i) {
+        result.reals << *reals[i];
+    }
+    for (int i = 0; i < ints.size(); ++i) {
+        result.ints << *ints[i];
+    }
+    if ( distribution != nullptr ) {
+        result.distribution = *distribution;
+    }
+
+    VList::const_iterator it;
+    qreal raw = 0, standard = 0;
+    result.scores.reserve( 2 * m_graph.size() );
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+        resultCacheVertex( (*it), index, raw, standard, true );
+        result.scores << raw << standard;
+    }
+}
+
+
+
+/**
+ * @brief Copies the results of a prominence index back to the vertices and
+ * the graph-wide statistics. The result must belong to the current graph.
+ * @param index
+ * @param result
+ */
+void Graph::resultCacheApply(const int &index, const GraphResultCache::Result &result) {
+
+    QList<qreal*> reals;
+    QList<int*> ints;
+    GraphDistribution *distribution = nullptr;
+    resultCacheFields(index, reals, ints, distribution);
 
+    for (int i = 0; i < reals.size() && i < result.reals.size(); ++i) {
+        *reals[i] = result.reals[i];
+    }
+    for (int i = 0; i < ints.size() && i < result.ints.size(); ++i) {
+        *ints[i] = result.ints[i];
+    }
+    if ( distribution != nullptr ) {
+        *distribution = result.distribution;
+    }
+
+    VList::const_iterator it;
+    int i = 0;
+    qreal raw, standard;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it, i+=2) {
+        raw = result.scores[i];
+        standard = result.scores[i+1];
+        resultCacheVertex( (*it), index, raw, standard, false );
+    }
+}
+
+
+
+/**
+ * @brief Returns the graph-wide statistics that make up the results of a
+ * prominence index, as kept by m_resultCache.
+ * The geodesic indices (CC, BC, SC, EC, PC) are not kept by m_resultCache,
+ * only by m_resultStore along with the distances, see geodesicsStoreWrite().
+ * @param index
+ * @param reals
+ * @param ints classes, max and min vertex
+ * @param distribution
+ */
+void Graph::resultCacheFields(const int &index,
+                              QList<qreal*> &reals,
+                              QList<int*> &ints,
+                              GraphDistribution *&distribution) {
+    switch (index) {
+    case IndexType::DC :
+        reals << &sumDC << &sumSDC << &maxSDC << &minSDC
+              << &meanSDC << &varianceSDC << &groupDC;
+        ints << &classesSDC << &maxNodeSDC << &minNodeSDC;
+        distribution = &discreteSDCs;
+        break;
+    case IndexType::CC :
+        reals << &sumCC << &sumSCC << &maxSCC << &minSCC << &nomSCC << &denomSCC
+              << &meanSCC << &varianceSCC << &groupCC << &maxIndexCC;
+        ints << &classesSCC << &maxNodeSCC << &minNodeSCC;
+        distribution = &discreteCCs;
+        break;
+    case IndexType::BC :
+        reals << &sumBC << &sumSBC << &maxSBC << &minSBC << &nomSBC << &denomSBC
+              << &meanSBC << &varianceSBC << &groupSBC << &maxIndexBC;
+        ints << &classesSBC << &maxNodeSBC << &minNodeSBC;
+        distribution = &discreteBCs;
+        break;
+    case IndexType::SC :
+        reals << &sumSC << &sumSSC << &maxSSC << &minSSC
+              << &meanSSC << &varianceSSC << &groupSC << &maxIndexSC;
+        ints << &classesSSC << &maxNodeSSC << &minNodeSSC;
+        distribution = &discreteSCs;
+        break;
+    case IndexType::EC :
+        reals << &sumEC << &maxEC << &minEC << &nomEC << &denomEC
+              << &meanEC << &varianceEC << &groupEC << &maxIndexEC;
+        ints << &classesEC << &maxNodeEC << &minNodeEC;
+        distribution = &discreteECs;
+        break;
+    case IndexType::PC :
+        reals << &sumPC << &sumSPC << &maxSPC << &minSPC << &nomSPC << &denomSPC
+              << &meanSPC << &varianceSPC << &groupSPC << &maxIndexPC;
+        ints << &classesSPC << &maxNodeSPC << &minNodeSPC;
+        distribution = &discretePCs;
+        break;
+    case IndexType::IRCC :
+        reals << &sumIRCC << &maxIRCC << &minIRCC << &meanIRCC
+              << &varianceIRCC << &nomIRCC << &denomIRCC << &groupIRCC;
+        ints << &classesIRCC << &maxNodeIRCC << &minNodeIRCC;
+        distribution = &discreteIRCCs;
+        break;
+    case IndexType::IC :
+        reals << &sumIC << &t_sumIC << &maxIC << &minIC << &meanIC
+              << &varianceIC << &nomIC << &denomIC << &maxIndexIC;
+        ints << &classesIC << &maxNodeIC << &minNodeIC;
+        distribution = &discreteICs;
+        break;
+    case IndexType::EVC :
+        reals << &sumEVC << &sumSEVC << &maxEVC << &minEVC << &meanEVC
+              << &varianceEVC << &nomEVC << &denomEVC << &groupEVC;
+        ints << &classesEVC << &maxNodeEVC << &minNodeEVC;
+        distribution = &discreteEVCs;
+        break;
+    case IndexType::DP :
+        reals << &sumDP << &sumSDP << &maxSDP << &minSDP
+              << &meanSDP << &varianceSDP << &groupDP;
+        ints << &classesSDP << &maxNodeDP << &minNodeDP;
+        distribution = &discreteDPs;
+        break;
+    case IndexType::PRP :
+        reals << &sumPRP << &t_sumPRP << &maxPRP << &minPRP
+              << &meanPRP << &variancePRP;
+        ints << &classesPRP << &maxNodePRP << &minNodePRP;
+        distribution = &discretePRPs;
+        break;
+    case IndexType::PP :
+        reals << &sumPP << &maxPP << &minPP << &meanPP
+              << &variancePP << &nomPP << &denomPP << &groupPP;
+        ints << &classesPP << &maxNodePP << &minNodePP;
+        distribution = &discretePPs;
+        break;
+    default:
+        break;
+    }
+}
+
+
+
+/**
+ * @brief Reads (save=true) or writes the raw and std score of vertex
+ * in the given prominence index
+ * @param vertex
+ * @param index
+ * @param raw
+ * @param standard
+ * @param save
+ */
+void Graph::resultCacheVertex(GraphVertex *vertex, const int &index,
+                              qreal &raw, qreal &standard, const bool &save) {
+    switch (index) {
+    case IndexType::DC :
+        if (save) { raw = vertex->DC(); standard = vertex->SDC(); }
+        else { vertex->setDC(raw); vertex->setSDC(standard); }
+        break;
+    case IndexType::CC :
+        if (save) { raw = vertex->CC(); standard = vertex->SCC(); }
+        else { vertex->setCC(raw); vertex->setSCC(standard); }
+        break;
+    case IndexType::BC :
+        if (save) { raw = vertex->BC(); standard = vertex->SBC(); }
+        else { vertex->setBC(raw); vertex->setSBC(standard); }
+        break;
+    case IndexType::SC :
+        if (save) { raw = vertex->SC(); standard = vertex->SSC(); }
+        else { vertex->setSC(raw); vertex->setSSC(standard); }
+        break;
+    case IndexType::EC :
+        if (save) { raw = vertex->EC(); standard = vertex->SEC(); }
+        else { vertex->setEC(raw); vertex->setSEC(standard); }
+        break;
+    case IndexType::PC :
+        if (save) { raw = vertex->PC(); standard = vertex->SPC(); }
+        else { vertex->setPC(raw); vertex->setSPC(standard); }
+        break;
+    case IndexType::IRCC :
+        if (save) { raw = vertex->IRCC(); standard = vertex->SIRCC(); }
+        else { vertex->setIRCC(raw); vertex->setSIRCC(standard); }
+        break;
+    case IndexType::IC :
+        if (save) { raw = vertex->IC(); standard = vertex->SIC(); }
+        else { vertex->setIC(raw); vertex->setSIC(standard); }
+        break;
+    case IndexType::EVC :
+        if (save) { raw = vertex->EVC(); standard = vertex->SEVC(); }
+        else { vertex->setEVC(raw); vertex->setSEVC(standard); }
+        break;
+    case IndexType::DP :
+        if (save) { raw = vertex->DP(); standard = vertex->SDP(); }
+        else { vertex->setDP(raw); vertex->setSDP(standard); }
+        break;
+    case IndexType::PRP :
+        if (save) { raw = vertex->PRP(); standard = vertex->SPRP(); }
+        else { vertex->setPRP(raw); vertex->setSPRP(standard); }
+        break;
+    case IndexType::PP :
+        if (save) { raw = vertex->PP(); standard = vertex->SPP(); }
+        else { vertex->setPP(raw); vertex->setSPP(standard); }
+        break;
+    default:
+        break;
+    }
 }
 
 
 
+/**
+ * @brief Returns a content hash of the current relation of the network:
+ * its vertices, in order, and its enabled edges with their weights.
+ * Results keyed by it in m_resultStore hold for any network with the same
+ * content, i.e. the same file opened again.
+ * The hash is recomputed only when the graph has changed.
+ * @return const QByteArray&
+ */
+const QByteArray &Graph::graphContentHash() {
+
+    if ( ! m_graphContentHash.isEmpty()
+         && m_graphContentHashVersion == m_graphVersion
+         && m_graphContentHashRelation == relationCurrent() ) {
+        return m_graphContentHash;
+    }
+
+    const GraphCSR &csr = graphCSR();
+    const int V = csr.vertices();
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << (qint32) V << (qint32) csr.edges();
+    for (int i = 0; i < V; ++i) {
+        out << (qint32) csr.name(i) << csr.isEnabled(i) << (qint32) csr.outDegree(i);
+        for (int e = csr.outBegin(i); e < csr.outEnd(i); ++e) {
+            out << (qint32) csr.outTarget(e) << csr.outWeight(e);
+        }
+    }
+
+    m_graphContentHash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    m_graphContentHashVersion = m_graphVersion;
+    m_graphContentHashRelation = relationCurrent();
+
+    qDebug() << "Graph::graphContentHash() -" << m_graphContentHash.toHex();
+
+    return m_graphContentHash;
+}
+
+
+
+/**
+ * @brief Writes the geodesic distances and shortest path counts just computed,
+ * along with the centralities if computeCentralities, to m_resultStore.
+ * @param computeCentralities
+ * @param parameters see GraphResultCache::parameters()
+ */
+void Graph::geodesicsStoreWrite(const bool &computeCentralities, const int &parameters) {
+
+    if ( ! m_resultStore.isEnabled() ) {
+        return;
+    }
+
+    const QString entry = QString( computeCentralities ? "centralities-%1" : "distances-%1")
+            .arg(parameters);
+
+    m_resultStore.write( graphContentHash(), entry, [&](QDataStream &out) {
+
+        const int N = m_graph.size();
+        VList::const_iterator it, it1;
+        qreal distance = 0;    // RAND_MAX if unreachable
+
+        out << (qint32) N << computeCentralities;
+        out << (qint32) m_graphDiameter << m_graphAverageDistance
+            << m_graphSumDistance << m_graphGeodesicsCount << m_graphIsConnected;
+
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+            out << (*it)->distanceSum();
+        }
+
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+            for (it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1) {
+                distance = (*it)->distance( (*it1)->name() );
+                out << distance
+                    << (quint32) (*it)->shortestPaths( (*it1)->name() );
+            }
+        }
+
+        if ( ! computeCentralities ) {
+            return;
+        }
+
+        const int geodesicIndices[] = { IndexType::CC, IndexType::BC, IndexType::SC,
+                                        IndexType::EC, IndexType::PC };
+        GraphResultCache::Result result;
+        for (const int &index : geodesicIndices) {
+            resultCacheCapture(index, result);
+            GraphResultCache::write(out, result);
+        }
+
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+            out << (*it)->eccentricity();
+        }
+        out << maxEccentricity << minEccentricity << (qint32) classesEccentricity
+            << (qint32) maxNodeEccentricity << (qint32) minNodeEccentricity;
+        discreteEccentricities.write(out);
+    } );
+}
+
+
+
+/**
+ * @brief Restores from m_resultStore the geodesic distances, and the
+ * centralities if computeCentralities, computed with these parameters
+ * on a network with the same content.
+ * A stored centralities entry serves distance requests as well.
+ * @param computeCentralities
+ * @param parameters see GraphResultCache::parameters()
+ * @return true if the results were restored
+ */
+bool Graph::geodesicsStoreRead(const bool &computeCentralities, const int &parameters) {
+
+    if ( ! m_resultStore.isEnabled() ) {
+        return false;
+    }
+
+    const int N = m_graph.size();
+
+    qint32 diameter = 0;
+    qreal averageDistance = 0, sumDistance = 0, geodesicsCount = 0;
+    bool connected = false, centralities = false;
+    QVector<qreal> distanceSums;
+    vector<qreal> distances;
+    vector<quint32> sigmas;
+    GraphResultCache::Result results[5];
+    QVector<qreal> eccentricities;
+    qreal eccentricityMax = 0, eccentricityMin = 0;
+    qint32 eccentricityClasses = 0, eccentricityMaxNode = 0, eccentricityMinNode = 0;
+    GraphDistribution eccentricityDistribution;
+
+    auto reader = [&](QDataStream &in) {
+        qint32 size = 0;
+        in >> size >> centralities;
+        if ( size != N || ( computeCentralities && ! centralities ) ) {
+            return false;
+        }
+        in >> diameter >> averageDistance >> sumDistance >> geodesicsCount >> connected;
+
+        distanceSums.resize(N);
+        for (int i = 0; i < N; ++i) {
+            in >> distanceSums[i];
+        }
+
+        try {
+            distances.resize( (size_t) N * N );
+            sigmas.resize( (size_t) N * N );
+        }
+        catch (const std::bad_alloc &) {
+            return false;
+        }
+        for (size_t k = 0; k < distances.size() && in.status() == QDataStream::Ok; ++k) {
+            in >> distances[k] >> sigmas[k];
+        }
+
+        if ( ! centralities ) {
+            return in.status() == QDataStream::Ok;
+        }
+
+        for (int r = 0; r < 5; ++r) {
+            if ( ! GraphResultCache::read(in, results[r])
+                 || results[r].scores.size() != 2 * N ) {
+                return false;
+            }
+        }
+        eccentricities.resize(N);
+        for (int i = 0; i < N; ++i) {
+            in >> eccentricities[i];
+        }
+        in >> eccentricityMax >> eccentricityMin >> eccentricityClasses
+           >> eccentricityMaxNode >> eccentricityMinNode;
+        eccentricityDistribution.read(in);
+        return in.status() == QDataStream::Ok;
+    };
+
+    const QByteArray &hash = graphContentHash();
+    const QString centralitiesEntry = QString("centralities-%1").arg(parameters);
+    if ( ! m_resultStore.read( hash, centralitiesEntry, reader ) ) {
+        if ( computeCentralities
+             || ! m_resultStore.read( hash, QString("distances-%1").arg(parameters), reader ) ) {
+            return false;
+        }
+    }
+
+    qDebug() << "Graph::geodesicsStoreRead() - restoring distances"
+             << ( centralities ? "and centralities" : "" )
+             << "parameters" << parameters;
+
+    VList::const_iterator it, it1;
+    int i = 0, j = 0;
+    size_t k = 0;
+
+    if ( m_distancesCompact && distancesStoreInit(N) ) {
+        for (k = 0; k < distances.size(); ++k) {
+            if ( distances[k] != RAND_MAX ) {
+                m_distancesStore[k] = distances[k];
+            }
+        }
+        m_sigmasStore.swap(sigmas);
+    }
+    else {
+        distancesStoreClear();
+        for (it=m_graph.cbegin(), k=0; it!=m_graph.cend(); ++it) {
+            (*it)->clearDistance();
+            (*it)->clearShortestPaths();
+            for (it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1, ++k) {
+                if ( distances[k] != RAND_MAX ) {
+                    (*it)->setDistance( (*it1)->name(), distances[k] );
+                }
+                if ( sigmas[k] != 0 ) {
+                    (*it)->setShortestPaths( (*it1)->name(), sigmas[k] );
+                }
+            }
+        }
+    }
+
+    m_graphDiameter = diameter;
+    m_graphAverageDistance = averageDistance;
+    m_graphSumDistance = sumDistance;
+    m_graphGeodesicsCount = geodesicsCount;
+    m_graphIsConnected = connected;
+
+    m_vertexPairsNotConnected.clear();
+    m_geodesicRangeSize.assign(N, 0);
+    m_geodesicRangeSum.assign(N, 0);
+    m_geodesicDomainSize.assign(N, 0);
+    m_geodesicDomainSum.assign(N, 0);
+    qreal distance = 0;
+    for (it=m_graph.cbegin(), i=0; it!=m_graph.cend(); ++it, ++i) {
+        (*it)->setDistanceSum( distanceSums[i] );
+        if ( ! (*it)->isEnabled() ) {
+            continue;
+        }
+        for (it1=m_graph.cbegin(), j=0; it1!=m_graph.cend(); ++it1, ++j) {
+            if ( i == j ) {
+                continue;
+            }
+            distance = (*it)->distance( (*it1)->name() );
+            if ( distance == RAND_MAX ) {
+                if ( (*it1)->isEnabled() ) {
+                    m_vertexPairsNotConnected.insert( (*it)->name(), (*it1)->name() );
+                }
+                continue;
+            }
+            if ( (*it1)->isEnabled() ) {
+                m_geodesicRangeSize[i]++;
+                m_geodesicRangeSum[i] += distance;
+            }
+            m_geodesicDomainSize[j]++;
+            m_geodesicDomainSum[j] += distance;
+        }
+    }
+
+    calculatedDistances = true;
+    m_graphDistancesParameters = parameters & ~GraphResultCache::DropIsolates;
+    calculatedCentralities = false;
+
+    if ( centralities ) {
+        const int geodesicIndices[] = { IndexType::CC, IndexType::BC, IndexType::SC,
+                                        IndexType::EC, IndexType::PC };
+        for (int r = 0; r < 5; ++r) {
+            resultCacheApply( geodesicIndices[r], results[r] );
+            m_resultCache.clearLive( geodesicIndices[r] );
+            m_prominenceScoreIndex.remove( geodesicIndices[r] );
+        }
+        for (it=m_graph.cbegin(), i=0; it!=m_graph.cend(); ++it, ++i) {
+            (*it)->setEccentricity( eccentricities[i] );
+        }
+        maxEccentricity = eccentricityMax;
+        minEccentricity = eccentricityMin;
+        classesEccentricity = eccentricityClasses;
+        maxNodeEccentricity = eccentricityMaxNode;
+        minNodeEccentricity = eccentricityMinNode;
+        discreteEccentricities = eccentricityDistribution;
+
+        calculatedCentralities = true;
+        m_graphCentralitiesParameters = parameters;
+        calculatedBCApproximate = false;
+    }
+
+    return true;
+}
+
+
+
+/**
+ * @brief Returns the geodesic distance (length of shortest path)
+ * from vertex v1 to vertex v2
+ * If the distances have not been computed with these parameters, it solves
+ * the SSSP problem of v1 only, instead of computing all pair-wise distances.
+ * @param v1
+ * @param v2
+ * @param considerWeights
+ * @param inverseWeights
+ * @return
+ */
+int Graph::graphDistanceGeodesic(const int &v1, const int &v2,
+                                 const bool &considerWeights,
+                                 const bool &inverseWeights){
+    qDebug() <<"Graph::graphDistanceGeodesic()";
+
+    // Single weighted queries on larger networks use parallel delta-stepping
+    const int deltaSteppingMinVertices = 10000;
+
+    if ( calculatedDistances
+         && m_graphDistancesParameters == GraphResultCache::parameters(considerWeights,
+                                                                       inverseWeights,
+                                                                       false) ) {
+        return m_graph[ vpos[v1] ]->distance(v2);
+    }
+
+    // Solve the SSSP problem of v1 only
+    const GraphCSR &csr = graphCSR();
+    const int si = vpos[v1];
+    const int ti = vpos[v2];
+    qreal distance = RAND_MAX;
+
+    if ( considerWeights && csr.vertices() >= deltaSteppingMinVertices
+         && graphWorkerThreads( csr.vertices() ) > 1 ) {
+        vector<qreal> dist;
+        deltaStepping(si, dist, csr, inverseWeights);
+        distance = dist[ti];
+    }
+    else {
+        GraphGeodesicWorkspace ws;
+        ws.init( csr.vertices(), false );
+        if ( considerWeights ) {
+            dijkstra(si, ws, csr, false, inverseWeights);
+        }
+        else {
+            BFS(si, ws, csr, false);
+        }
+        distance = ws.dist[ti];
+    }
+
+    return distance;
+}
+
+
+
+
+/**
+ * @brief Returns the diameter of the graph, aka the largest geodesic distance
+ * between any two vertices
+ * @param considerWeights
+ * @param inverseWeights
+ * @return
+ */
+int Graph::graphDiameter(const bool considerWeights,
+                         const bool inverseWeights){
+    qDebug () << "Graph::graphDiameter()" ;
+    if ( ! calculatedDistances &&
+         ( ! considerWeights || ! graphIsWeighted() ) && graphIsSymmetric() ) {
+        graphEccentricitiesBounded();
+        return m_graphDiameter;
+    }
+    graphDistancesGeodesic(false, considerWeights, inverseWeights, false);
+    return m_graphDiameter;
+}
+
+
+
+/**
+ * @brief Computes the eccentricity of every vertex and the diameter of an
+ * unweighted symmetric graph with the BoundingDiameters algorithm
+ * (Takes & Kosters, 2011), without solving the all-pairs problem.
+ *
+ * Every BFS from a vertex v with eccentricity e(v) tightens, for each vertex w
+ * in the same component, the bounds
+ *   max( e(v)-d(v,w), d(v,w) ) <= e(w) <= e(v)+d(v,w)
+ * and vertices whose bounds meet are settled. The next BFS source alternates
+ * between the candidate with the largest upper bound and the one with
+ * the smallest lower bound. On real-world sparse networks only a handful of
+ * BFS runs are needed.
+ *
+ * As in graphDistancesGeodesic(), in a disconnected graph every vertex has
+ * infinite eccentricity, while the diameter is the largest finite distance.
+ * Sets m_graphDiameter, m_graphIsConnected and the Eccentricity of each vertex,
+ * along with the min/max eccentricity and eccentricity classes.
+ */
+void Graph::graphEccentricitiesBounded() {
+
+    if ( calculatedEccentricity ) {
+        qDebug() << "Graph::graphEccentricitiesBounded() - "
+                    "graph not modified. Return.";
+        return;
+    }
+
+    qDebug() << "Graph::graphEccentricitiesBounded()";
+
+    const GraphCSR &csr = graphCSR();
+    const int N = csr.vertices();
+    const int INF = std::numeric_limits<int>::max();
+    const int *targets = csr.outTargets();
+
+    vector<int> dist(N, -1), lower(N, 0), upper(N, INF), ecc(N, 0), Q;
+    vector<bool> visited(N, false);
+    QVector<int> members, candidates;
+    int components = 0, bfsRuns = 0, diameter = 0;
+    int i=0, j=0, u=0, w=0, e=0, v=0, d=0, k=0;
+    bool pickUpper = true;
+
+    QString pMsg  = tr("Computing eccentricities. \nPlease wait...");
+    emit statusMessage ( pMsg  );
+    graphProgressCreate(N, pMsg );
+
+    // BFS from src over the snapshot, returns the eccentricity of src
+    // inside its component. Leaves the distances in dist for vertices in Q.
+    auto bfs = [&](const int &src) -> int {
+        for ( size_t q = 0; q < Q.size(); ++q ) {
+            dist[ Q[q] ] = -1;
+        }
+        Q.clear();
+        Q.push_back(src);
+        dist[src] = 0;
+        int maxDist = 0;
+        for ( size_t head = 0; head < Q.size(); ++head ) {
+            int x = Q[head];
+            for ( int f = csr.outBegin(x); f < csr.outEnd(x); ++f ) {
+                int y = targets[f];
+                if ( dist[y] < 0 && csr.isEnabled(y) ) {
+                    dist[y] = dist[x] + 1;
+                    if ( dist[y] > maxDist ) {
+                        maxDist = dist[y];
+                    }
+                    Q.push_back(y);
+                }
+            }
+        }
+        bfsRuns++;
+        return maxDist;
+    };
+
+    for ( i = 0; i < N; ++i ) {
+
+        if ( visited[i] || ! csr.isEnabled(i) ) {
+            continue;
+        }
+
+        // The first BFS finds the component of i and settles i itself.
+        components++;
+        ecc[i] = bfs(i);
+        members = QVector<int>( Q.begin(), Q.end() );
+        candidates.clear();
+
+        for ( j = 0; j < members.size(); ++j ) {
+            w = members[j];
+            visited[w] = true;
+            d = dist[w];
+            lower[w] = qMax( ecc[i] - d, d );
+            upper[w] = ecc[i] + d;
+            if ( w != i && lower[w] != upper[w] ) {
+                candidates << w;
+            }
+            else {
+                ecc[w] = lower[w];
+            }
+        }
+
+        while ( ! candidates.isEmpty() ) {
+
+            // Select the next source, alternating between the largest upper
+            // and the smallest lower bound. Ties go to the higher degree.
+            v = candidates[0];
+            for ( k = 1; k < candidates.size(); ++k ) {
+                u = candidates[k];
+                if ( pickUpper ) {
+                    if ( upper[u] > upper[v] ||
+                         ( upper[u] == upper[v] && csr.outDegree(u) > csr.outDegree(v) ) ) {
+                        v = u;
+                    }
+                }
+                else {
+                    if ( lower[u] < lower[v] ||
+                         ( lower[u] == lower[v] && csr.outDegree(u) > csr.outDegree(v) ) ) {
+                        v = u;
+                    }
+                }
+            }
+            pickUpper = !pickUpper;
+
+            e = bfs(v);
+            ecc[v] = lower[v] = upper[v] = e;
+
+            // Tighten the bounds and drop the settled candidates
+            k = 0;
+            for ( j = 0; j < candidates.size(); ++j ) {
+                w = candidates[j];
+                d = dist[w];
+                lower[w] = qMax( lower[w], qMax( e - d, d ) );
+                upper[w] = qMin( upper[w], e + d );
+                if ( lower[w] == upper[w] ) {
+                    ecc[w] = lower[w];
+                    continue;
+                }
+                candidates[k++] = w;
+            }
+            candidates.resize(k);
+
+            graphProgressUpdate( N - candidates.size() );
+        }
+
+        for ( j = 0; j < members.size(); ++j ) {
+            if ( ecc[ members[j] ] > diameter ) {
+                diameter = ecc[ members[j] ];
+            }
+        }
+    }
+
+    qDebug() << "Graph::graphEccentricitiesBounded() - components" << components
+             << "diameter" << diameter
+             << "BFS runs" << bfsRuns << "for" << N << "vertices";
+
+    m_graphDiameter = diameter;
+    m_graphIsConnected = ( components < 2 );
+
+    maxEccentricity=0; minEccentricity=RAND_MAX; maxNodeEccentricity=0;
+    minNodeEccentricity=0; discreteEccentricities.clear();
+    classesEccentricity=0;
+
+    VList::const_iterator it;
+    for ( i=0, it=m_graph.cbegin(); it!=m_graph.cend(); ++it, ++i ) {
+        if ( ! (*it)->isEnabled() ) {
+            continue;
+        }
+        if ( ! m_graphIsConnected ) {
+            (*it)->setEccentricity( RAND_MAX );
+            continue;
+        }
+        (*it)->setEccentricity( ecc[i] );
+        minmax( ecc[i], (*it), maxEccentricity, minEccentricity,
+                maxNodeEccentricity, minNodeEccentricity) ;
+        resolveClasses(ecc[i], discreteEccentricities,
+                       classesEccentricity ,(*it)->name() );
+    }
+
+    calculatedEccentricity = true;
+
+    graphProgressKill();
+}
+
+
+
+/**
+ * @brief Returns the average distance of the graph
+ * @param considerWeights
+ * @param inverseWeights
+ * @param dropIsolates
+ * @return
+ */
+qreal Graph::graphDistanceGeodesicAverage(const bool considerWeights,
+                                          const bool inverseWeights,
+                                          const bool dropIsolates){
+
+
+
+    qDebug() <<"Graph::graphDistanceGeodesicAverage() - Computing distances...";
+
+    graphDistancesGeodesic(false, considerWeights, inverseWeights, dropIsolates);
+
+    qDebug() <<"Graph::graphDistanceGeodesicAverage() - "
+             << "average distance:"
+             << m_graphAverageDistance;
+
+    return m_graphAverageDistance;
+
+}
+
+
+
+
+/**
+ * @brief Returns the number of geodesics (shortest-paths) in the graph.
+  * @return
+ */
+int Graph::graphGeodesics()  {
+    qDebug()<< "Graph::graphGeodesics()";
+
+    graphDistancesGeodesic(false, false,false,false);
+
+    qDebug()<< "Graph::graphGeodesics() - geodesics:" << m_graphGeodesicsCount;
+    return m_graphGeodesicsCount;
+
+
+}
+
+
+
+
+
+/**
+ * @brief Checks if the graph is connected, in the sense of a topological space,
+ * i.e., there is a path from any vertex to any other vertex in the graph.
+ * For digraphs this means strongly connected.
+ * Uses the component engine (see graphComponents()), not the geodesics:
+ * an undirected graph only needs its weak components, kept up to date as
+ * edges are added.
+ * Called from MW::slotConnectedness()
+ * @return bool
+ */
+bool Graph::graphIsConnected() {
+
+    qDebug() << "Graph::graphIsConnected() ";
+
+    if ( calculatedDistances ) {
+        qDebug()<< "Graph::graphIsConnected() - graph unmodified. Returning:"
+                << m_graphIsConnected;
+        return m_graphIsConnected;
+    }
+
+    if ( graphIsUndirected() ) {
+        m_graphIsConnected = graphComponents(false).isWeaklyConnected();
+    }
+    else {
+        m_graphIsConnected = graphComponents(true).isStronglyConnected();
+    }
+
+    qDebug() << "Graph::graphIsConnected() - result" << m_graphIsConnected;
+
+    return m_graphIsConnected;
+
+}
+
+
+
+/**
+ * @brief Returns the connectedness of the graph, from its strong and weak
+ * components:
+ *   1 if the graph is undirected and connected, or directed and strongly connected
+ *   2 if the graph is directed and only weakly connected
+ *   0 if the graph is disconnected
+ * The null and the singleton graph are considered connected.
+ * @param updateProgress
+ * @return
+ */
+int Graph::graphConnectednessFull(const bool updateProgress) {
+
+    qDebug() << "Graph::graphConnectednessFull()";
+
+    if ( updateProgress ) {
+        QString pMsg = tr("Computing graph components. \nPlease wait ");
+        emit statusMessage ( pMsg );
+    }
+
+    const GraphComponents &components = graphComponents(true);
+
+    qDebug() << "Graph::graphConnectednessFull() - strong components"
+             << components.strongComponents()
+             << "weak components" << components.weakComponents();
+
+    if ( components.isStronglyConnected() ) {
+        return 1;
+    }
+    if ( components.isWeaklyConnected() ) {
+        return 2;
+    }
+    return 0;
+}
+
+
+
+
+
+
+
+/**
+ * @brief Creates the matrix SIGMA of shortest paths (geodesics) between vertices
+ * Each SIGMA(i,j) is the number of shortest paths (geodesics) from i and j
+ * @param considerWeights
+ * @param inverseWeights
+ * @param dropIsolates
+ */
+void Graph::graphMatrixShortestPathsCreate(const bool &considerWeights,
+                                           const bool &inverseWeights,
+                                           const bool &dropIsolates) {
+    qCHotDebug(lcGraph) << "Graph::graphMatrixShortestPathsCreate()";
+
+    graphDistancesGeodesic(false,considerWeights,inverseWeights, dropIsolates);
+
+    if ( graphCancelled() ) {
+        return;
+    }
+
+    VList::const_iterator it, jt;
+
+    int N = vertices( dropIsolates, false, true);
+
+    int progressCounter=0;
+    int source = 0 , target = 0;
+    int i = 0, j = 0 ;
+
+    qCHotDebug(lcGraph) << "Graph::graphMatrixShortestPathsCreate() - Resizing matrix to hold "
+             << N << " vertices";
+
+    SIGMA.resize(N, N);
+
+    QString pMsg = tr("Creating shortest paths matrix. \nPlease wait ");
+    emit statusMessage ( pMsg );
+    graphProgressCreate(N,pMsg);
+
+
+    qCHotDebug(lcGraph) << "Graph::graphMatrixShortestPathsCreate() - Writing shortest paths matrix...";
+
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+
+        graphProgressUpdate(++progressCounter);
+
+        source = (*it)->name();
+
+        if  ( (*it)->isIsolated() && dropIsolates ) {
+            qCHotDebug(lcGraph) << "Graph::graphMatrixShortestPathsCreate() - "
+                     << source << "isolated. SKIP";
+
+            continue;
+        }
+
+        if  ( ! (*it)->isEnabled()  ) {
+            qCHotDebug(lcGraph) << "Graph::graphMatrixShortestPathsCreate() - "
+                     << source << "disabled. SKIP";
+            continue;
+        }
+
+        qCHotDebug(lcGraph) << "Graph::graphMatrixShortestPathsCreate() - source" << source
+                 << "i" << i;
+
+        for (jt=m_graph.cbegin(); jt!=m_graph.cend(); ++jt) {
+
+            target = (*jt)->name();
+
+            if  ( (*jt)->isIsolated() && dropIsolates ) {
+                qCHotDebug(lcGraph) << "Graph::graphMatrixShortestPathsCreate() - "
+                         << target << "isolated. SKIP";
+                continue;
+            }
+
+            if  ( ! (*jt)->isEnabled()  ) {
+                qCHotDebug(lcGraph) << "Graph::graphMatrixShortestPathsCreate() - "
+                         << target << "disabled. SKIP";
+                continue;
+            }
+
+            qCHotDebug(lcGraph) << "Graph::graphMatrixShortestPathsCreate() - "
+                     << "target" << target << "j" << j;
+
+
+            qCHotDebug(lcGraph) << "Graph::graphMatrixShortestPathsCreate() -  setting SIGMA ("
+                     << i <<","<< j << ") =" << (*it)->shortestPaths( target )  ;
+            SIGMA.setItem( i, j, (*it)->shortestPaths( target ) );
+            j++;
+        }
+        j=0;
+        i++;
+    }
+
+    graphProgressKill();
+
+
+}
+
+
+
+/**
+ * @brief Creates the matrix DM of geodesic distances between vertices
+ * @param considerWeights
+ * @param inverseWeights
+ * @param dropIsolates
+ */
+void Graph::graphMatrixDistanceGeodesicCreate(const bool &considerWeights,
+                                              const bool &inverseWeights,
+                                              const bool &dropIsolates) {
+
+    GraphTraceScope trace("Graph::graphMatrixDistanceGeodesicCreate");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("considerWeights=%1 inverseWeights=%2 dropIsolates=%3")
+                    .arg(considerWeights).arg(inverseWeights).arg(dropIsolates) );
+    qCHotDebug(lcGraph) << "Graph::graphMatrixDistanceGeodesicCreate()";
+
+
+    graphDistancesGeodesic(false,considerWeights,inverseWeights, dropIsolates);
+
+    if ( graphCancelled() ) {
+        return;
+    }
+
+    VList::const_iterator it, jt;
+
+    int N = vertices( dropIsolates, false, true);
+
+    int progressCounter=0;
+    int source = 0 , target = 0;
+    int i = 0, j = 0 ;
+
+    qCHotDebug(lcGraph) << "Graph::graphMatrixDistanceGeodesicCreate() - "
+                "Resizing distance matrix to hold "
+             << N << " vertices";
+
+    DM.resize(N, N);
+
+    QString pMsg = tr("Creating geodesic distances matrix. \nPlease wait ");
+    emit statusMessage ( pMsg );
+    graphProgressCreate(N,pMsg);
+
+
+    qCHotDebug(lcGraph) << "Graph: graphMatrixDistanceGeodesicCreate() - Writing distances matrix...";
+
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+
+        graphProgressUpdate(++progressCounter);
+
+        source = (*it)->name();
+
+        if  ( (*it)->isIsolated() && dropIsolates ) {
+            qCHotDebug(lcGraph) << "Graph: graphMatrixDistanceGeodesicCreate() - "
+                     << source << "isolated. SKIP";
+
+            continue;
+        }
+
+        if  ( ! (*it)->isEnabled()  ) {
+            qCHotDebug(lcGraph) << "Graph: graphMatrixDistanceGeodesicCreate() - "
+                     << source << "disabled. SKIP";
+            continue;
+        }
+
+
+        qCHotDebug(lcGraph) << "Graph: graphMatrixDistanceGeodesicCreate() - source"
+                 << source << "i" << i;
+
+        for (jt=m_graph.cbegin(); jt!=m_graph.cend(); ++jt) {
+
+            target = (*jt)->name();
+
+            if  ( (*jt)->isIsolated() && dropIsolates ) {
+                qCHotDebug(lcGraph) << "Graph: graphMatrixDistanceGeodesicCreate() - "
+                         << target << "isolated. SKIP";
+                continue;
+            }
+
+            if  ( ! (*jt)->isEnabled()  ) {
+                qCHotDebug(lcGraph) << "Graph: graphMatrixDistanceGeodesicCreate() - "
+                         << target << "disabled. SKIP";
+                continue;
+            }
+
+            qCHotDebug(lcGraph) << "Graph: graphMatrixDistanceGeodesicCreate() - "
+                     << "target" << target << "j" << j;
+
+
+            qCHotDebug(lcGraph) << "Graph: graphMatrixDistanceGeodesicCreate() -  setting DM ("
+                     << i <<","<< j << ") =" << (*it)->distance( target ) ;
+            DM.setItem( i, j, (*it)->distance( target ) );
+
+            j++;
+        }
+        j=0;
+        i++;
+    }
+
+    graphProgressKill();
+
+
+}
+
+
+/**
+ * @brief Computes the geodesic distances between all vertices:
+  * In the process, it also computes many other centrality/prestige metrics:
+ * * The so-called sigma matrix, where the (i,j) element is the number of shortest paths
+ *   from vertex i to vertex j, called sigma(i,j).
+ * * The Diameter of the graph, m_graphDiameter, which is the length of the longest
+ *   shortest path between every (i,j)
+ * * The Eccentricity of every node i which is the length of the longest shortest
+ *   path from i to every other node j
+ * * The InfluenceRange and InfluenceDomain of each node.
+ * * The centralities for every u in V:
+ *   - Betweenness: BC(u) = Sum ( sigma(i,j,u)/sigma(i,j) ) for every s,t in V
+ *   - Stress: SC(u) = Sum ( sigma(i,j) ) for every s,t in V
+ *   - Eccentricity: EC(u) =  1/maxDistance(u,t)  for some t in V
+ *   - Closeness: CC(u) =  1 / Sum( d(u,t) )  for every  t in V
+ *   - Power:
+ * All of them are computed in a single pass, with one traversal per source,
+ * whatever the caller asks for. Thus, once the distances have been computed,
+ * any other distance-based index (CC, IRCC, BC, SC, EC, PC, PP) with
+ * the same weight parameters does not traverse the graph again.
+ * The distances do not depend on dropIsolates, only the std centralities do.
+ * @param centralities if true, the caller needs the centralities, not only the distances
+ * @param considerWeights
+ * @param inverseWeights
+ * @param dropIsolates
+ */
+void Graph::graphDistancesGeodesic(const bool &centralities,
+                                   const bool &considerWeights,
+                                   const bool &inverseWeights,
+                                   const bool &dropIsolates) {
+
+    GraphTraceScope trace("Graph::graphDistancesGeodesic");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("centralities=%1 considerWeights=%2 inverseWeights=%3 "
+                            "dropIsolates=%4")
+                    .arg(centralities).arg(considerWeights).arg(inverseWeights)
+                    .arg(dropIsolates) );
+
+    graphCancelReset();
+
+    qCHotDebug(lcGraph) << "Graph::graphDistancesGeodesic()"
+             << "centralities" << centralities
+             << "considerWeights:"<<considerWeights
+             << "inverseWeights:"<<inverseWeights
+             << "dropIsolates:" << dropIsolates;
+
+    // The distances and centralities are stored in the vertices once, for
+    // the parameters they were last computed with; other parameters recompute.
+    const int cacheParameters = GraphResultCache::parameters(considerWeights,
+                                                             inverseWeights,
+                                                             dropIsolates);
+    const int distancesParameters = GraphResultCache::parameters(considerWeights,
+                                                                 inverseWeights,
+                                                                 false);
+    if (centralities) {
+        if ( calculatedCentralities && m_graphCentralitiesParameters == cacheParameters ) {
+            qCHotDebug(lcGraph) << "Graph::graphDistancesGeodesic() - Centralities calculated. Return.";
+            return;
+        }
+    }
+    else if ( calculatedDistances && m_graphDistancesParameters == distancesParameters )  {
+        qCHotDebug(lcGraph) << "Graph::graphDistancesGeodesic() - graph not modified. Return.";
+        return;
+    }
+
+    // Fused pass: a recomputation always computes all distance-based indices
+    const bool computeCentralities = true;
+
+    // Until the pass completes, there is nothing to repair after edge edits
+    m_distancesIncrementalVersion = 0;
+
+    VList::const_iterator it, it1;
+
+    qCHotDebug(lcGraph) << "Graph::graphDistancesGeodesic() - Recomputing geodesic distances.";
+
+
+    //drop isolated vertices from calculations (i.e. std C and group C).
+    int N = vertices(dropIsolates,false,true);
+    int E = edgesEnabled();
+
+
+    QString pMsg  = tr("Computing geodesic distances. \nPlease wait...");
+    emit statusMessage ( pMsg  );
+    graphProgressCreate(N, pMsg );
+
+    m_graphIsSymmetric = graphIsSymmetric();
+    qCHotDebug(lcGraph) << "Graph::graphDistancesGeodesic() - m_graphIsSymmetric"
+                << m_graphIsSymmetric ;
+
+    if ( E > 0 && geodesicsStoreRead(centralities, cacheParameters) ) {
+        qCHotDebug(lcGraph) << "Graph::graphDistancesGeodesic() - restored from result store. Return.";
+        graphProgressKill();
+        return;
+    }
+
+    if ( E == 0 ) {
+
+        // The compact store, if enabled, starts with infinite distances
+        // and zero sigmas, so there is nothing else to do.
+        if ( ! m_distancesCompact || ! distancesStoreInit( m_graph.size() ) ) {
+            distancesStoreClear();
+            for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+                for (it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1) {
+                    // Set all pair-wise distances to RAND_MAX
+                    (*it)->setDistance((*it1)->name(), RAND_MAX);
+                    // Set all pair-wise shortest-path counts (sigmas) to 0
+                    (*it)->setShortestPaths((*it1)->name(), 0);
+                }
+            }
+        }
+        // Without edges, all influence ranges and domains are empty
+        m_geodesicRangeSize.assign(m_graph.size(), 0);
+        m_geodesicRangeSum.assign(m_graph.size(), 0);
+        m_geodesicDomainSize.assign(m_graph.size(), 0);
+        m_geodesicDomainSum.assign(m_graph.size(), 0);
+        if ( N < 2 ) {
+            //singleton graph consisting of a single isolated node
+            //is considered connected
+            m_graphIsConnected = true;
+        }
+        else {
+            //any non-empty and non-singleton graph with zero edges is disconnected
+            m_graphIsConnected = false;
+        }
+
+    }
+    else {
+
+        qCHotDebug(lcGraph) << "Graph::graphDistancesGeodesic() - Initializing variables";
+
+        m_graphDiameter=0;
+        calculatedDistances = false;
+        calculatedCentralities = false;
+        m_graphSumDistance = 0;
+        m_graphGeodesicsCount = 0; //non zero distances
+        sumPC=0;
+        sumSPC=0;
+
+        qCHotDebug(lcGraph) << "	m_graphDiameter "<< m_graphDiameter
+                 << " m_graphAverageDistance " <<m_graphAverageDistance;
+        qCHotDebug(lcGraph) << "	reciprocalEdgesVert "<< reciprocalEdgesVert
+                 << " inboundEdgesVert " << inboundEdgesVert
+                 << " outboundEdgesVert "<<  outboundEdgesVert;
+        qCHotDebug(lcGraph) << "	E " << E <<  " N " << N;
+
+
+        // Build the adjacency snapshot here, once, before any worker starts.
+        const GraphCSR &csr = graphCSR();
+
+        // Use the compact store, if enabled and there is enough memory.
+        if ( ! m_distancesCompact || ! distancesStoreInit( m_graph.size() ) ) {
+            distancesStoreClear();
+        }
+
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+
+            // All pair-wise distances are set to RAND_MAX by default
+            // inside GraphVertex::distance()
+            // so we don't need to explicitly set them here.
+            // We just clear distance hashmap of each actor.
+            (*it)->clearDistance();
+            // Set all pair-wise shortest-path counts (sigmas) to 0
+            (*it)->clearShortestPaths();
+
+            //Zero centrality scores for each vertex
+            if (computeCentralities) {
+
+                qCHotDebug(lcGraph) << " Graph:graphDistancesGeodesic() -"
+                            "Initializing actor centrality indices";
+                (*it)->setBC( 0.0 );
+                (*it)->setSC( 0.0 );
+                (*it)->setEccentricity( 0.0 );
+                (*it)->setEC( 0.0 );
+                (*it)->setCC( 0.0 );
+                (*it)->setIRCC( 0.0 );
+                (*it)->setPC( 0.0 );
+
+
+            }
+
+        }
+
+        if (computeCentralities) {
+            // IRCC, BC and SC scores were reset above, the cached ones must be restored
+            m_resultCache.clearLive(IndexType::IRCC);
+            m_resultCache.clearLive(IndexType::BC);
+            m_resultCache.clearLive(IndexType::SC);
+        }
+
+
+
+        qCHotDebug(lcGraph) << "*********** MAIN LOOP: "
+                    "for every s in V solve the Single Source Shortest Path (SSSP) problem...";
+
+        const int totalVertices = m_graph.size();
+
+        QVector<int> sources(totalVertices);
+        for (int i = 0; i < totalVertices; ++i) {
+            sources[i] = i;
+        }
+
+        vector<GraphGeodesicWorkspace> workspaces;
+
+        // Each worker writes the influence range of its own sources only
+        m_geodesicRangeSize.assign(totalVertices, 0);
+        m_geodesicRangeSum.assign(totalVertices, 0);
+        m_geodesicRangeMax.assign(totalVertices, 0);
+
+        graphDistancesGeodesicWorkers(csr, sources, workspaces,
+                                      computeCentralities,
+                                      considerWeights,
+                                      inverseWeights,
+                                      false, true, &m_cancelRequested);
+
+        if ( graphCancelled() ) {
+            // Discard the distances of the sources done so far.
+            // The centralities were zeroed above and stay not calculated.
+            for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+                (*it)->clearDistance();
+                (*it)->clearShortestPaths();
+            }
+            distancesStoreClear();
+            calculatedBCApproximate=false;
+            m_prominenceScoreIndex.remove(IndexType::CC);
+            m_prominenceScoreIndex.remove(IndexType::BC);
+            m_prominenceScoreIndex.remove(IndexType::SC);
+            m_prominenceScoreIndex.remove(IndexType::EC);
+            m_prominenceScoreIndex.remove(IndexType::PC);
+            qDebug() << "Graph::graphDistancesGeodesic() - cancelled. Return.";
+            graphProgressKill();
+            emit statusMessage( tr("Computing geodesic distances cancelled.") );
+            return;
+        }
+
+        const int threads = workspaces.size();
+
+        qCHotDebug(lcGraph) << "*********** MAIN LOOP: reducing worker accumulators";
+
+        for (int t = 0; t < threads; ++t) {
+            const GraphGeodesicWorkspace &ws = workspaces[t];
+            m_graphSumDistance += ws.sumDistance;
+            m_graphGeodesicsCount += ws.geodesicsCount;
+            sumPC += ws.sumPC;
+            sumSPC += ws.sumSPC;
+        }
+
+        m_geodesicDomainSize.assign(totalVertices, 0);
+        m_geodesicDomainSum.assign(totalVertices, 0);
+        for (int t = 0; t < threads; ++t) {
+            const GraphGeodesicWorkspace &ws = workspaces[t];
+            for (int i = 0; i < totalVertices; ++i) {
+                m_geodesicDomainSize[i] += ws.domainSize[i];
+                m_geodesicDomainSum[i] += ws.domainSum[i];
+            }
+        }
+
+        m_geodesicBC.assign(totalVertices, 0);
+        m_geodesicSC.assign(totalVertices, 0);
+        if (computeCentralities) {
+            for (int i = 0; i < totalVertices; ++i) {
+                for (int t = 0; t < threads; ++t) {
+                    m_geodesicBC[i] += workspaces[t].BC[i];
+                    m_geodesicSC[i] += workspaces[t].SC[i];
+                }
+                m_graph[i]->setBC( m_geodesicBC[i] );
+                m_graph[i]->setSC( m_geodesicSC[i] );
+            }
+        }
+
+
+        qCHotDebug(lcGraph) << "*********** MAIN LOOP (SSSP problem): FINISHED.";
+
+
+        graphDistancesGeodesicFinish(computeCentralities, considerWeights,
+                                     inverseWeights, dropIsolates);
+
+        m_distancesIncrementalVersion = m_graphVersion;
+        m_distancesIncrementalRelation = relationCurrent();
+
+    }  // END else (aka E!=0)
+
+
+
+    calculatedDistances=true;
+    m_graphDistancesParameters = distancesParameters;
+
+    if ( E > 0 ) {
+        geodesicsStoreWrite(computeCentralities, cacheParameters);
+    }
+
+    qCHotDebug(lcGraph) << "Graph::graphDistancesGeodesic()- FINISHED computing distances";
+
 
+    graphProgressKill();
 
+}
 
 
 /**
- * @brief Creates the matrix SIGMA of shortest paths (geodesics) between vertices
- * Each SIGMA(i,j) is the number of shortest paths (geodesics) from i and j
+ * @brief Reduces the per-source results of the geodesic pass, stored in the
+ * vertices and in m_graphSumDistance, m_geodesicBC etc., to the graph-wide
+ * ones: connectedness, average distance, eccentricities and, if
+ * computeCentralities is true, the standardized centralities, their
+ * extrema, classes, variances and group indices.
+ * It reads the stored distances only, so that graphDistancesGeodesic() and
+ * distancesIncrementalRepair() share it.
+ * @param computeCentralities
  * @param considerWeights
  * @param inverseWeights
  * @param dropIsolates
  */
-void Graph::graphMatrixShortestPathsCreate(const bool &considerWeights,
-                                           const bool &inverseWeights,
-                                           const bool &dropIsolates) {
-    qDebug() << "Graph::graphMatrixShortestPathsCreate()";
-
-    graphDistancesGeodesic(false,considerWeights,inverseWeights, dropIsolates);
+void Graph::graphDistancesGeodesicFinish(const bool &computeCentralities,
+                                         const bool &considerWeights,
+                                         const bool &inverseWeights,
+                                         const bool &dropIsolates) {
 
-    VList::const_iterator it, jt;
+    VList::const_iterator it, it1;
 
-    int N = vertices( dropIsolates, false, true);
+    //drop isolated vertices from calculations (i.e. std C and group C).
+    int N = vertices(dropIsolates,false,true);
 
-    int progressCounter=0;
-    int source = 0 , target = 0;
-    int i = 0, j = 0 ;
+    const int cacheParameters = GraphResultCache::parameters(considerWeights,
+                                                             inverseWeights,
+                                                             dropIsolates);
+
+    qreal maxEdgeWeightInNetwork=0;
+    qreal CC=0, BC=0, SC= 0, eccentricity=0, EC=0;
+    qreal SCC=0, SBC=0, SSC=0, SEC=0, SPC=0;
+    qreal tempVarianceBC=0, tempVarianceSC=0,tempVarianceEC=0;
+    qreal tempVarianceCC=0, tempVariancePC=0;
+    qreal pairDistance = 0;
+
+    m_graphIsConnected = true;
+
+    qCHotDebug(lcGraph) << "Graph: graphDistancesGeodesic() - initialising centrality variables ";
+
+    maxSCC=0; minSCC=RAND_MAX; nomSCC=0; denomSCC=0; groupCC=0; maxNodeSCC=0;
+    minNodeSCC=0; sumSCC=0; sumCC=0;
+    discreteCCs.clear(); classesSCC=0;
+    maxSBC=0; minSBC=RAND_MAX; nomSBC=0; denomSBC=0; groupSBC=0; maxNodeSBC=0;
+    minNodeSBC=0; sumBC=0; sumSBC=0;
+    discreteBCs.clear(); classesSBC=0;
+    maxSSC=0; minSSC=RAND_MAX; groupSC=0; maxNodeSSC=0;
+    minNodeSSC=0;sumSC=0; sumSSC=0;
+    discreteSCs.clear(); classesSSC=0;
+    maxSPC=0; minSPC=RAND_MAX; nomSPC=0; denomSPC=0; groupSPC=0; maxNodeSPC=0;
+    minNodeSPC=0;
+    discretePCs.clear(); classesSPC=0;
+    maxEccentricity=0; minEccentricity=RAND_MAX; maxNodeEccentricity=0;
+    minNodeEccentricity=0; discreteEccentricities.clear();
+    classesEccentricity=0;
+    maxSPC=0; minSPC=RAND_MAX; maxNodeSPC=0; minNodeSPC=0;
+    maxEC=0; minEC=RAND_MAX; nomEC=0; denomEC=0; groupEC=0; maxNodeEC=0;
+    minNodeEC=0; sumEC=0;
+
+    discreteECs.clear(); classesEC=0;
 
-    qDebug() << "Graph::graphMatrixShortestPathsCreate() - Resizing matrix to hold "
-             << N << " vertices";
+    m_graphAverageDistance=0;
 
-    SIGMA.resize(N, N);
+    // Stores vertex pairs not connected
+    // Vertices in keys have
+    // Infinite Eccentricity
+    // Zero Eccentricity Centrality
+    // Zero Closeness Centrality
+    m_vertexPairsNotConnected.clear();
 
-    QString pMsg = tr("Creating shortest paths matrix. \nPlease wait ");
-    emit statusMessage ( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    // The diameter is the largest distance from any source
+    m_graphDiameter = 0;
+    for (size_t i = 0; i < m_geodesicRangeMax.size(); ++i) {
+        if ( m_geodesicRangeMax[i] > m_graphDiameter ) {
+            m_graphDiameter = m_geodesicRangeMax[i];
+        }
+    }
 
+    if (considerWeights && inverseWeights) {
+        // find the max weight in the network.
+        // it will be used for maxCC below
+        maxEdgeWeightInNetwork = graphCSR().maxWeight();
+    }
 
-    qDebug() << "Graph::graphMatrixShortestPathsCreate() - Writing shortest paths matrix...";
+    qCHotDebug(lcGraph) << "Graph: graphDistancesGeodesic() - "
+                " initialising variables for max centrality scores";
+    if (m_graphIsSymmetric) {
+        maxIndexBC= ( N == 2 ) ? 1 : ( N-1.0 ) * ( N-2.0 ) / 2.0;
+        maxIndexSC= ( N == 2 ) ? 1 : ( N-1.0 ) * ( N-2.0 ) / 2.0;
+        maxIndexCC=N-1.0;
+        maxIndexPC=N-1.0;
+        qCHotDebug(lcGraph, "############# m_graphIsSymmetric - maxIndexBC %f, maxIndexCC %f, maxIndexSC %f", maxIndexBC, maxIndexCC, maxIndexSC);
+    }
+    else {
 
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+        maxIndexBC= ( N == 2 ) ? 1 : ( N-1.0 ) * ( N-2.0 );  // fix N=2 case where maxIndex becomes zero
+        maxIndexSC= ( N == 2 ) ? 1 : ( N-1.0 ) * ( N-2.0 );
+        maxIndexPC=N-1.0;
+        maxIndexCC=N-1.0;
+        qCHotDebug(lcGraph, "############# NOT SymmetricAdjacencyMatrix - maxIndexBC %f, maxIndexCC %f, maxIndexSC %f", maxIndexBC, maxIndexCC, maxIndexSC);
+    }
 
-        emit signalProgressBoxUpdate(++progressCounter);
+    if (considerWeights && inverseWeights) {
+        maxIndexCC = maxIndexCC * (1.0 / maxEdgeWeightInNetwork);
+    }
 
-        source = (*it)->name();
+    // check if there are disconnected nodes
+    // and get the distance sums
+    qCHotDebug(lcGraph) << "Checking if there are disconnected nodes";
 
-        if  ( (*it)->isIsolated() && dropIsolates ) {
-            qDebug() << "Graph::graphMatrixShortestPathsCreate() - "
-                     << source << "isolated. SKIP";
+    m_graphIsConnected = true;
 
-            continue;
-        }
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
 
-        if  ( ! (*it)->isEnabled()  ) {
-            qDebug() << "Graph::graphMatrixShortestPathsCreate() - "
-                     << source << "disabled. SKIP";
+        if ( ! (*it)->isEnabled() ) {
+            qCHotDebug(lcGraph)<< "actor i" <<  (*it)->name() << "disabled. SKIP/CONTINUE";
             continue;
         }
 
-        qDebug() << "Graph::graphMatrixShortestPathsCreate() - source" << source
-                 << "i" << i;
-
-        for (jt=m_graph.cbegin(); jt!=m_graph.cend(); ++jt) {
+        pairDistance = 0;
+        (*it)->setDistanceSum( 0 );
 
-            target = (*jt)->name();
+        for ( it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1){
 
-            if  ( (*jt)->isIsolated() && dropIsolates ) {
-                qDebug() << "Graph::graphMatrixShortestPathsCreate() - "
-                         << target << "isolated. SKIP";
+            if ( ! (*it1)->isEnabled() ) {
+                qCHotDebug(lcGraph)<< "   actor j" <<  (*it1)->name() << "disabled. SKIP/CONTINUE";
                 continue;
             }
-
-            if  ( ! (*jt)->isEnabled()  ) {
-                qDebug() << "Graph::graphMatrixShortestPathsCreate() - "
-                         << target << "disabled. SKIP";
+            if (  (*it1)->name() == (*it)->name() ) {
+                qCHotDebug(lcGraph)<< "   == actor j" <<  (*it1)->name() << "SKIP/CONTINUE";
                 continue;
             }
+            
+            pairDistance = (*it)-> distance ( (*it1)->name() );
+            
+            if ( pairDistance == RAND_MAX) {
+                m_vertexPairsNotConnected.insert((*it)->name(), (*it1)->name());
+                (*it)->setEccentricity( RAND_MAX );
+                m_graphIsConnected = false;
 
-            qDebug() << "Graph::graphMatrixShortestPathsCreate() - "
-                     << "target" << target << "j" << j;
-
+                qCHotDebug(lcGraph)<< "actor i" <<  (*it)->name()
+                        << "has infinite eccentricity. "
+                           "There is no path from it to actor j"
+                        << (*it1)->name();
 
-            qDebug() << "Graph::graphMatrixShortestPathsCreate() -  setting SIGMA ("
-                     << i <<","<< j << ") =" << (*it)->shortestPaths( target )  ;
-            SIGMA.setItem( i, j, (*it)->shortestPaths( target ) );
-            j++;
-        }
-        j=0;
-        i++;
-    }
+            }
+            else {
 
-    emit signalProgressBoxKill();
+                qCHotDebug(lcGraph)<< "actor i" <<  (*it)->name()
+                        <<"distanceSum" << (*it)->distanceSum();
+                (*it)->setDistanceSum( (*it)->distanceSum() + pairDistance);
 
+            }
+        } // end for
+        
+        qCHotDebug(lcGraph)<< "actor i" <<  (*it)->name()
+                <<"Final distanceSum" << (*it)->distanceSum();
 
-}
 
+        if (computeCentralities) {
 
+            // Compute Eccentricity (max geodesic distance)
+            eccentricity = (*it)->eccentricity();
+            
+            qCHotDebug(lcGraph) << "actor"
+                     << (*it)->name()
+                     << "eccentricity" << eccentricity;
+            
+            if ( eccentricity != RAND_MAX ) {
+
+                //Find min/max Eccentricity
+                minmax( eccentricity, (*it), maxEccentricity, minEccentricity,
+                        maxNodeEccentricity, minNodeEccentricity) ;
+                resolveClasses(eccentricity, discreteEccentricities,
+                               classesEccentricity ,(*it)->name() );
+
+                //Eccentricity Centrality is the inverted Eccentricity
+                EC=1.0 / eccentricity;
+                (*it)->setEC( EC ); //Set Eccentricity Centrality
+                (*it)->setSEC( EC ); //Set std EC = EC
+                sumEC+=EC;  //set sum EC
+
+                qCHotDebug(lcGraph)<< "actor i" <<  (*it)->name()
+                        << "EC"
+                        << EC;
+            }
+            else {
 
-/**
- * @brief Creates the matrix DM of geodesic distances between vertices
- * @param considerWeights
- * @param inverseWeights
- * @param dropIsolates
- */
-void Graph::graphMatrixDistanceGeodesicCreate(const bool &considerWeights,
-                                              const bool &inverseWeights,
-                                              const bool &dropIsolates) {
-    qDebug() << "Graph::graphMatrixDistanceGeodesicCreate()";
+                EC=0;
+                (*it)->setEC( EC );     //Set Eccentricity Centrality
+                (*it)->setSEC( EC );    //Set std EC = EC
+                sumEC+=EC;  //set sum EC
 
+                qCHotDebug(lcGraph)<< "actor i" <<  (*it)->name()
+                        << "EC=0 (disconnected graph)";
 
-    graphDistancesGeodesic(false,considerWeights,inverseWeights, dropIsolates);
+            }
+            
+        } // end if compute centralities
 
-    VList::const_iterator it, jt;
+    } // end for disconnected checking
 
-    int N = vertices( dropIsolates, false, true);
+    // Compute average path length...
+    if (m_vertexPairsNotConnected.count()==0) {
 
-    int progressCounter=0;
-    int source = 0 , target = 0;
-    int i = 0, j = 0 ;
+        m_graphAverageDistance = m_graphSumDistance / ( N * ( N-1.0 ) );
+        qCHotDebug(lcGraph) <<"Graph::graphDistancesGeodesic() - Average distance:"
+                << m_graphAverageDistance ;
 
-    qDebug() << "Graph::graphMatrixDistanceGeodesicCreate() - "
-                "Resizing distance matrix to hold "
-             << N << " vertices";
+    }
+    else {
 
-    DM.resize(N, N);
+        //TODO In not connected nets, it would be nice to ask the user what to do
+        // with unconnected pairs (make M or drop (default?)
+        qCHotDebug(lcGraph) <<"Graph::graphDistancesGeodesic() - Average distance:"
+                << m_graphAverageDistance ;
+        m_graphAverageDistance = m_graphSumDistance / m_graphGeodesicsCount;
 
-    QString pMsg = tr("Creating geodesic distances matrix. \nPlease wait ");
-    emit statusMessage ( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
 
+    }
 
-    qDebug() << "Graph: graphMatrixDistanceGeodesicCreate() - Writing distances matrix...";
 
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+    if (computeCentralities) {
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        qCHotDebug(lcGraph) << "Graph: graphDistancesGeodesic() - "
+                    "Computing centralities...";
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+            if ( dropIsolates && (*it)->isIsolated() ){
+                qCHotDebug(lcGraph) << "vertex " << (*it)->name()
+                         << " isolated, continue. ";
+                continue;
+            }
 
-        source = (*it)->name();
+            // Compute classes and min/maxEC
+            SEC=(*it)->SEC();
+            resolveClasses(SEC, discreteECs, classesEC,(*it)->name() );
+            minmax( SEC, (*it), maxEC, minEC, maxNodeEC, minNodeEC) ;
+
+            // Compute classes and min/maxSPC
+            SPC = (*it)->SPC();  //same as PC
+            resolveClasses(SPC, discretePCs, classesSPC,(*it)->name() );
+            minmax( SPC, (*it), maxSPC, minSPC, maxNodeSPC, minNodeSPC) ;
+
+            // Compute std BC, classes and min/maxSBC
+            if (m_graphIsSymmetric) {
+                qCHotDebug(lcGraph)<< "Betweenness centrality must be divided by"
+                        <<" two if the graph is undirected";
+                (*it)->setBC ( (*it)->BC()/2.0);
+            }
+            BC=(*it)->BC();
+            sumBC+=BC;
+            SBC = BC/maxIndexBC;
+            (*it)->setSBC( SBC );
+            resolveClasses(SBC, discreteBCs, classesSBC);
+            sumSBC+=SBC;
+            minmax( SBC, (*it), maxSBC, minSBC, maxNodeSBC, minNodeSBC) ;
+
+            // Compute std CC, classes and min/maxSCC
+            CC = (*it)->CC();
+            sumCC+=CC;
+            SCC = maxIndexCC * CC;
+            (*it)->setSCC (  SCC );
+            resolveClasses(SCC, discreteCCs, classesSCC,(*it)->name() );
+            sumSCC+=SCC;
+            minmax( SCC, (*it), maxSCC, minSCC, maxNodeSCC, minNodeSCC) ;
+
+            //prepare to compute stdSC
+            SC=(*it)->SC();
+            if (m_graphIsSymmetric){
+                (*it)->setSC(SC/2.0);
+                SC=(*it)->SC();
+                qCHotDebug(lcGraph) << "SC of " <<(*it)->name()
+                         << "  divided by 2 (because the graph is symmetric) "
+                         << (*it)->SC();
+            }
+            sumSC+=SC;
 
-        if  ( (*it)->isIsolated() && dropIsolates ) {
-            qDebug() << "Graph: graphMatrixDistanceGeodesicCreate() - "
-                     << source << "isolated. SKIP";
+            qCHotDebug(lcGraph) << "vertex " << (*it)->name() << " - "
+                     << " EC: "<< (*it)->EC()
+                     << " CC: "<< (*it)->CC()
+                     << " BC: "<< (*it)->BC()
+                     << " SC: "<< (*it)->SC()
+                     << " PC: "<< (*it)->PC();
+        } // end for
 
-            continue;
-        }
+        qCHotDebug(lcGraph) << "Graph: graphDistancesGeodesic() -"
+                    "Computing mean centrality values...";
 
-        if  ( ! (*it)->isEnabled()  ) {
-            qDebug() << "Graph: graphMatrixDistanceGeodesicCreate() - "
-                     << source << "disabled. SKIP";
-            continue;
-        }
+        // Compute mean values and prepare to compute variances
+        meanSBC = sumSBC /(qreal) N ;
+        varianceSBC=0;
+        tempVarianceBC=0;
 
+        meanSCC = sumSCC /(qreal) N ;
+        varianceSCC=0;
+        tempVarianceCC=0;
 
-        qDebug() << "Graph: graphMatrixDistanceGeodesicCreate() - source"
-                 << source << "i" << i;
+        meanSPC = sumSPC /(qreal) N ;
+        varianceSPC=0;
+        tempVariancePC=0;
 
-        for (jt=m_graph.cbegin(); jt!=m_graph.cend(); ++jt) {
+        meanEC = sumEC /(qreal) N ;
+        varianceEC=0;
+        tempVarianceEC=0;
 
-            target = (*jt)->name();
+        qCHotDebug(lcGraph) << "Graph: graphDistancesGeodesic() - "
+                    "Computing std centralities ...";
 
-            if  ( (*jt)->isIsolated() && dropIsolates ) {
-                qDebug() << "Graph: graphMatrixDistanceGeodesicCreate() - "
-                         << target << "isolated. SKIP";
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+            if ( dropIsolates && (*it)->isIsolated() ) {
                 continue;
             }
+            // Compute std SC, classes and min/maxSSC
+            SC=(*it)->SC();
+            SSC=SC/sumSC;
+            (*it)->setSSC(SSC);
+            resolveClasses(SSC, discreteSCs, classesSSC);
+            sumSSC+=SSC;
+            minmax( SSC, (*it), maxSSC, minSSC, maxNodeSSC, minNodeSSC) ;
 
-            if  ( ! (*jt)->isEnabled()  ) {
-                qDebug() << "Graph: graphMatrixDistanceGeodesicCreate() - "
-                         << target << "disabled. SKIP";
-                continue;
-            }
+            //Compute numerator of groupSBC
+            SBC=(*it)->SBC();
+            nomSBC +=(maxSBC - SBC );
 
-            qDebug() << "Graph: graphMatrixDistanceGeodesicCreate() - "
-                     << "target" << target << "j" << j;
+            //calculate BC variance
+            tempVarianceBC = (  SBC  -  meanSBC  ) ;
+            tempVarianceBC *=tempVarianceBC;
+            varianceSBC  += tempVarianceBC;
 
+            //Compute numerator of groupCC
+            nomSCC += maxSCC- (*it)->SCC();
 
-            qDebug() << "Graph: graphMatrixDistanceGeodesicCreate() -  setting DM ("
-                     << i <<","<< j << ") =" << (*it)->distance( target ) ;
-            DM.setItem( i, j, (*it)->distance( target ) );
+            //calculate CC variance
+            tempVarianceCC = (  (*it)->SCC()  -  meanSCC  ) ;
+            tempVarianceCC *=tempVarianceCC;
+            varianceSCC  += tempVarianceCC;
 
-            j++;
-        }
-        j=0;
-        i++;
-    }
+            //Compute numerator of groupSPC
+            SPC=(*it)->SPC();
+            nomSPC +=(maxSPC - SPC );
 
-    emit signalProgressBoxKill();
+            //calculate PC variance
+            tempVariancePC = (  (*it)->SPC()  -  meanSPC  ) ;
+            tempVariancePC *=tempVariancePC;
+            varianceSPC  += tempVariancePC;
 
 
-}
+            //calculate EC variance
+            tempVarianceEC = (  (*it)->EC()  -  meanEC  ) ;
+            tempVarianceEC *=tempVarianceEC;
+            varianceEC  += tempVarianceEC;
 
 
-/**
- * @brief Computes the geodesic distances between all vertices:
-  * In the process, it also computes many other centrality/prestige metrics:
- * * The so-called sigma matrix, where the (i,j) element is the number of shortest paths
- *   from vertex i to vertex j, called sigma(i,j).
- * * The Diameter of the graph, m_graphDiameter, which is the length of the longest
- *   shortest path between every (i,j)
- * * The Eccentricity of every node i which is the length of the longest shortest
- *   path from i to every other node j
- * * The InfluenceRange and InfluenceDomain of each node.
- * * The centralities for every u in V (if centralities=true):
- *   - Betweenness: BC(u) = Sum ( sigma(i,j,u)/sigma(i,j) ) for every s,t in V
- *   - Stress: SC(u) = Sum ( sigma(i,j) ) for every s,t in V
- *   - Eccentricity: EC(u) =  1/maxDistance(u,t)  for some t in V
- *   - Closeness: CC(u) =  1 / Sum( d(u,t) )  for every  t in V
- *   - Power:
- * @param centralities
- * @param considerWeights
- * @param inverseWeights
- * @param dropIsolates
- */
-void Graph::graphDistancesGeodesic(const bool &computeCentralities,
-                                   const bool &considerWeights,
-                                   const bool &inverseWeights,
-                                   const bool &dropIsolates) {
+        } // end for
 
-    qDebug() << "Graph::graphDistancesGeodesic()"
-             << "centralities" << computeCentralities
-             << "considerWeights:"<<considerWeights
-             << "inverseWeights:"<<inverseWeights
-             << "dropIsolates:" << dropIsolates;
+        //compute final variances
+        varianceSBC  /=  (qreal) N;
+        varianceSCC  /=  (qreal) N;
+        varianceSPC  /=  (qreal) N;
 
-    if (computeCentralities) {
-        if ( calculatedCentralities ) {
-            qDebug() << "Graph::graphDistancesGeodesic() - Centralities calculated. Return.";
-            return;
+        varianceEC  /=  (qreal) N;
+
+
+        // calculate SC mean value and prepare to compute variance
+        meanSSC = sumSSC /(qreal) N ;
+        varianceSSC=0;
+        tempVarianceSC=0;
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+            if ( dropIsolates && (*it)->isIsolated() ){
+                continue;
+            }
+            tempVarianceSC = (  (*it)->SSC()  -  meanSSC  ) ;
+            tempVarianceSC *=tempVarianceSC;
+            varianceSSC  += tempVarianceSC;
         }
-    }
-    else if ( calculatedDistances )  {
-        qDebug() << "Graph::graphDistancesGeodesic() - graph not modified. Return.";
-        return;
-    }
+        //calculate final SC variance
+        varianceSSC  /=  (qreal) N;
 
-    VList::const_iterator it, it1;
-    QList<int>::const_iterator it2;
+        denomSPC = (  (N-2.0) ) / (2.0 );   //only for connected nets
+        if (N < 3 )
+            denomSPC = N-1.0;
+        //what if the net is disconnected (isolates exist) ?
+        groupSPC = nomSPC/denomSPC;
 
-    int w=0, u=0,s=0, si=0, ui=0, wi=0;
-    //int i=0;
-    int progressCounter=0;
+        denomSCC = ( ( N-1.0) * (N-2.0) ) / (2.0 * N -3.0);
+        if (N < 3 )
+            denomSCC = N-1.0;
 
-    qDebug() << "Graph::graphDistancesGeodesic() - Recomputing geodesic distances.";
+        groupCC = nomSCC/denomSCC;	//Calculate group Closeness centrality
 
+        //nomSBC*=2.0;
+        //            denomSBC =   (N-1.0) *  (N-1.0) * (N-2.0);
+        denomSBC =   (N-1.0) ;  // Wasserman&Faust - formula 5.14
+        groupSBC=nomSBC/denomSBC;		//Calculate group Betweenness centrality
 
-    //drop isolated vertices from calculations (i.e. std C and group C).
-    int N = vertices(dropIsolates,false,true);
-    int E = edgesEnabled();
+        calculatedCentralities=true;
+        m_graphCentralitiesParameters = cacheParameters;
+        calculatedBCApproximate=false;
+        m_prominenceScoreIndex.remove(IndexType::CC);
+        m_prominenceScoreIndex.remove(IndexType::BC);
+        m_prominenceScoreIndex.remove(IndexType::SC);
+        m_prominenceScoreIndex.remove(IndexType::EC);
+        m_prominenceScoreIndex.remove(IndexType::PC);
 
+    }  // END if computeCentralities
+}
 
-    QString pMsg  = tr("Computing geodesic distances. \nPlease wait...");
-    emit statusMessage ( pMsg  );
-    emit signalProgressBoxCreate(N, pMsg );
 
-    m_graphIsSymmetric = graphIsSymmetric();
-    qDebug() << "Graph::graphDistancesGeodesic() - m_graphIsSymmetric"
-                << m_graphIsSymmetric ;
 
-    if ( E == 0 ) {
 
-        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
-            for (it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1) {
-                // Set all pair-wise distances to RAND_MAX
-                (*it)->setDistance((*it1)->name(), RAND_MAX);
-                // Set all pair-wise shortest-path counts (sigmas) to 0
-                (*it)->setShortestPaths((*it1)->name(), 0);
-            }
-        }
-        if ( N < 2 ) {
-            //singleton graph consisting of a single isolated node
-            //is considered connected
-            m_graphIsConnected = true;
-        }
-        else {
-            //any non-empty and non-singleton graph with zero edges is disconnected
-            m_graphIsConnected = false;
-        }
+/**
+ * @brief Enables or disables the incremental geodesic distances.
+ * When enabled, an edge edit repairs the distances and shortest path counts
+ * computed before it, see distancesIncrementalRepair(), instead of leaving
+ * them to a full recomputation. If centralities is true, the distance-based
+ * centralities (BC, SC, CC, EC, PC) are repaired too, at the cost of a
+ * second traversal of the affected sources.
+ * @param toggle
+ * @param centralities
+ */
+void Graph::setDistancesIncremental(const bool &toggle, const bool &centralities) {
+    qDebug() << "Graph::setDistancesIncremental() - toggle" << toggle
+             << "centralities" << centralities;
+    m_distancesIncremental = toggle;
+    m_distancesIncrementalCentralities = centralities;
+    m_distancesIncrementalBase.reset();
+    m_distancesIncrementalArcs.clear();
+}
 
-    }
-    else {
 
-        qDebug() << "Graph::graphDistancesGeodesic() - Initializing variables";
-
-        qreal distances_sum_for_s = 0, maxEdgeWeightInNetwork=0, tempEdgeWeight=0;
-        qreal CC=0, BC=0, SC= 0, eccentricity=0, EC=0, PC=0;
-        qreal SCC=0, SBC=0, SSC=0, SEC=0, SPC=0;
-        qreal tempVarianceBC=0, tempVarianceSC=0,tempVarianceEC=0;
-        qreal tempVarianceCC=0, tempVariancePC=0;
-        qreal sigma_u=0, sigma_w=0;
-        qreal delta_u=0, delta_w=0;
-        qreal d_sw=0, d_su=0;
-        qreal pairDistance = 0;
-
-        m_graphIsConnected = true;
-
-        H_f_i::const_iterator hfi ; // for Power Centrality
-
-        qDebug() << "Graph: graphDistancesGeodesic() - initialising centrality variables ";
-
-        maxSCC=0; minSCC=RAND_MAX; nomSCC=0; denomSCC=0; groupCC=0; maxNodeSCC=0;
-        minNodeSCC=0; sumSCC=0; sumCC=0;
-        discreteCCs.clear(); classesSCC=0;
-        maxSBC=0; minSBC=RAND_MAX; nomSBC=0; denomSBC=0; groupSBC=0; maxNodeSBC=0;
-        minNodeSBC=0; sumBC=0; sumSBC=0;
-        discreteBCs.clear(); classesSBC=0;
-        maxSSC=0; minSSC=RAND_MAX; groupSC=0; maxNodeSSC=0;
-        minNodeSSC=0;sumSC=0; sumSSC=0;
-        discreteSCs.clear(); classesSSC=0;
-        maxSPC=0; minSPC=RAND_MAX; nomSPC=0; denomSPC=0; groupSPC=0; maxNodeSPC=0;
-        minNodeSPC=0; sumSPC=0;sumPC=0;
-        discretePCs.clear(); classesSPC=0;
-        maxEccentricity=0; minEccentricity=RAND_MAX; maxNodeEccentricity=0;
-        minNodeEccentricity=0; discreteEccentricities.clear();
-        classesEccentricity=0;
-        maxSPC=0; minSPC=RAND_MAX; maxNodeSPC=0; minNodeSPC=0; sumSPC=0;
-        maxEC=0; minEC=RAND_MAX; nomEC=0; denomEC=0; groupEC=0; maxNodeEC=0;
-        minNodeEC=0; sumEC=0;
-
-        discreteECs.clear(); classesEC=0;
 
-        m_graphDiameter=0;
-        calculatedDistances = false;
-        m_graphAverageDistance=0;
-        m_graphSumDistance = 0;
-        m_graphGeodesicsCount = 0; //non zero distances
+/**
+ * @brief Records that the arc source -> target (by vpos) of the current
+ * relation is about to be added, removed or reweighted.
+ * Called by edgeAdd(), edgeRemove() and edgeWeightSet() before they change
+ * the graph. The first call after a geodesic pass keeps a snapshot of the
+ * graph the distances were computed on, for distancesIncrementalRepair().
+ * @param source
+ * @param target
+ */
+void Graph::distancesIncrementalArc(const int &source, const int &target) {
+    if ( ! m_distancesIncremental || m_graphBulkDepth > 0 ) {
+        return;
+    }
+    if ( ! m_distancesIncrementalBase ) {
+        if ( ! calculatedDistances
+             || m_distancesIncrementalVersion != m_graphVersion
+             || m_distancesIncrementalRelation != relationCurrent() ) {
+            return;
+        }
+        m_distancesIncrementalBase = graphSnapshot();
+    }
+    m_distancesIncrementalArcs.append( qMakePair(source, target) );
+}
 
-        // Stores vertex pairs not connected
-        // Vertices in keys have
-        // Infinite Eccentricity
-        // Zero Eccentricity Centrality
-        // Zero Closeness Centrality
-        m_vertexPairsNotConnected.clear();
 
-        qDebug() << "	m_graphDiameter "<< m_graphDiameter
-                 << " m_graphAverageDistance " <<m_graphAverageDistance;
-        qDebug() << "	reciprocalEdgesVert "<< reciprocalEdgesVert
-                 << " inboundEdgesVert " << inboundEdgesVert
-                 << " outboundEdgesVert "<<  outboundEdgesVert;
-        qDebug() << "	E " << E <<  " N " << N;
 
+/**
+ * @brief Repairs the geodesic distances after the edge edits recorded by
+ * distancesIncrementalArc(), instead of solving the all-pairs problem again.
+ * Called by graphSetModified().
+ *
+ * A source s is affected by a change of the arc u -> v, of cost c before and
+ * c' after the edit, only if the arc was on a shortest path from s, that is
+ * d(s,u) + c = d(s,v), or if it now makes one, d(s,u) + c' <= d(s,v), as in
+ * the dynamic algorithm of Ramalingam & Reps (1996). The distances and the
+ * shortest path counts from every other source stay as they are.
+ * Only the affected sources are solved again. Their old contributions to the
+ * graph-wide sums and to the influence ranges and domains are taken from
+ * their stored rows. If centralities is true, their old betweenness and
+ * stress dependencies are found again on the snapshot of the graph before the
+ * edit. Then the new contributions replace the old ones, and
+ * graphDistancesGeodesicFinish() recomputes the graph-wide indices.
+ *
+ * Gives up, leaving everything to the next full computation, if the graph
+ * differs from the snapshot in any arc that was not recorded, if no arc is
+ * left, or if more than half of the sources are affected.
+ * @param centralities
+ * @return true if the distances, and the centralities if asked, are valid again
+ */
+bool Graph::distancesIncrementalRepair(const bool &centralities) {
+
+    GraphTraceScope trace("Graph::distancesIncrementalRepair");
+
+    const GraphCSR &before = *m_distancesIncrementalBase;
+    const GraphCSR &csr = graphCSR();
+    const int N = csr.vertices();
+
+    const bool considerWeights = m_graphDistancesParameters & GraphResultCache::ConsiderWeights;
+    const bool inverseWeights = m_graphDistancesParameters & GraphResultCache::InverseWeights;
+    const bool dropIsolates = m_graphCentralitiesParameters & GraphResultCache::DropIsolates;
+    const bool repairCentralities = centralities
+            && ( m_graphCentralitiesParameters & ~GraphResultCache::DropIsolates )
+               == m_graphDistancesParameters
+            && (int) m_geodesicBC.size() == N;
+
+    if ( N != before.vertices() || N != m_graph.size()
+         || before.edges() == 0 || csr.edges() == 0
+         || before.relation() != csr.relation()
+         || (int) m_geodesicRangeMax.size() != N ) {
+        qDebug() << "Graph::distancesIncrementalRepair() - cannot repair. Return.";
+        return false;
+    }
 
-        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
-            for (it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1) {
-                // All pair-wise distances are set to RAND_MAX by default
-                // inside GraphVertex::distance()
-                // so we don't need to explicitly set them here.
-                // We just clear distance hashmap of each actor.
-                (*it)->clearDistance();
-                // Set all pair-wise shortest-path counts (sigmas) to 0
-                // (*it)->setShortestPaths((*it1)->name(), 0);
-                (*it)->clearShortestPaths();
+    QSet<quint64> edited;
+    for (int a = 0; a < m_distancesIncrementalArcs.size(); ++a) {
+        edited.insert( ( (quint64) m_distancesIncrementalArcs[a].first << 32 )
+                       | (quint32) m_distancesIncrementalArcs[a].second );
+    }
+    auto isEdited = [&edited](const int &i, const int &j) {
+        return edited.contains( ( (quint64) i << 32 ) | (quint32) j );
+    };
 
-                if (considerWeights && inverseWeights) {
-                    // find the max weight in the network.
-                    // it will be used for maxCC below
-                    tempEdgeWeight = (*it)->hasEdgeTo((*it1)->name());
-                    if ( tempEdgeWeight > maxEdgeWeightInNetwork ) {
-                        maxEdgeWeightInNetwork = tempEdgeWeight;
-                    }
+    // Check that the edited arcs are the only difference. The rows of both
+    // snapshots are sorted by target.
+    for (int i = 0; i < N; ++i) {
+        if ( before.isEnabled(i) != csr.isEnabled(i) ) {
+            return false;
+        }
+        int a = before.outBegin(i), b = csr.outBegin(i);
+        while ( a < before.outEnd(i) || b < csr.outEnd(i) ) {
+            const int ta = ( a < before.outEnd(i) ) ? before.outTarget(a) : N;
+            const int tb = ( b < csr.outEnd(i) ) ? csr.outTarget(b) : N;
+            if ( ta == tb ) {
+                if ( before.outWeight(a) != csr.outWeight(b) && !isEdited(i, ta) ) {
+                    return false;
+                }
+                ++a;
+                ++b;
+            }
+            else if ( ta < tb ) {
+                if ( !isEdited(i, ta) ) {
+                    return false;
+                }
+                ++a;
+            }
+            else {
+                if ( !isEdited(i, tb) ) {
+                    return false;
                 }
+                ++b;
+            }
+        }
+    }
+
+    // The cost of the arc u -> v as the SSSP kernels see it, RAND_MAX if
+    // there is no such arc or if dijkstra() ignores it.
+    auto arcCost = [&](const GraphCSR &g, const int &u, const int &v) -> qreal {
+        const int *first = g.outTargets() + g.outBegin(u);
+        const int *last = g.outTargets() + g.outEnd(u);
+        const int *p = std::lower_bound(first, last, v);
+        if ( p == last || *p != v ) {
+            return RAND_MAX;
+        }
+        if ( !considerWeights ) {
+            return 1;
+        }
+        qreal weight = g.outWeights()[ p - g.outTargets() ];
+        if ( inverseWeights ) {
+            weight = 1.0 / weight;
+        }
+        return ( weight > 0 ) ? weight : RAND_MAX;
+    };
 
+    QVector<int> affected;
+    vector<char> isAffected(N, 0);
+    QSet<quint64>::const_iterator arc;
+    for (arc = edited.constBegin(); arc != edited.constEnd(); ++arc) {
+        const int u = (int) ( *arc >> 32 );
+        const int v = (int) ( *arc & 0xffffffff );
+        const qreal oldCost = arcCost(before, u, v);
+        const qreal newCost = arcCost(csr, u, v);
+        if ( oldCost == newCost ) {
+            continue;
+        }
+        for (int s = 0; s < N; ++s) {
+            if ( isAffected[s] || !csr.isEnabled(s) ) {
+                continue;
+            }
+            const qreal du = m_graph[s]->distance( csr.name(u) );
+            if ( du == RAND_MAX ) {
+                continue;
+            }
+            const qreal dv = m_graph[s]->distance( csr.name(v) );
+            // The stored distances may be single precision
+            const qreal tolerance = 1e-6 * qMax( (qreal) 1, du );
+            if ( ( oldCost != RAND_MAX && du + oldCost <= dv + tolerance )
+                 || ( newCost != RAND_MAX && du + newCost <= dv + tolerance ) ) {
+                isAffected[s] = 1;
+                affected << s;
             }
+        }
+    }
 
-            //Zero centrality scores for each vertex
-            if (computeCentralities) {
+    qDebug() << "Graph::distancesIncrementalRepair() - edited arcs" << edited.size()
+             << "affected sources" << affected.size() << "of" << N;
 
-                qDebug() << " Graph:graphDistancesGeodesic() -"
-                            "Initializing actor centrality indices";
-                (*it)->setBC( 0.0 );
-                (*it)->setSC( 0.0 );
-                (*it)->setEccentricity( 0.0 );
-                (*it)->setEC( 0.0 );
-                (*it)->setCC( 0.0 );
-                (*it)->setIRCC( 0.0 );
-                (*it)->setPC( 0.0 );
+    if ( affected.size() * 2 > N ) {
+        return false;
+    }
 
+    vector<GraphGeodesicWorkspace> workspaces;
+    int t = 0, i = 0, k = 0;
 
+    // Old betweenness and stress dependencies of the affected sources
+    if ( repairCentralities && !affected.isEmpty() ) {
+        graphDistancesGeodesicWorkers(before, affected, workspaces,
+                                      true, considerWeights, inverseWeights,
+                                      true, false);
+        for (t = 0; t < (int) workspaces.size(); ++t) {
+            for (i = 0; i < N; ++i) {
+                m_geodesicBC[i] -= workspaces[t].BC[i];
+                m_geodesicSC[i] -= workspaces[t].SC[i];
             }
-
         }
+    }
 
-
-        qDebug() << "Graph: graphDistancesGeodesic() - "
-                    " initialising variables for max centrality scores";
-        if (m_graphIsSymmetric) {
-            maxIndexBC= ( N == 2 ) ? 1 : ( N-1.0 ) * ( N-2.0 ) / 2.0;
-            maxIndexSC= ( N == 2 ) ? 1 : ( N-1.0 ) * ( N-2.0 ) / 2.0;
-            maxIndexCC=N-1.0;
-            maxIndexPC=N-1.0;
-            qDebug("############# m_graphIsSymmetric - maxIndexBC %f, maxIndexCC %f, maxIndexSC %f", maxIndexBC, maxIndexCC, maxIndexSC);
+    // Old contributions of the affected rows, as graphDistancesGeodesicSource()
+    // added them, then the rows are cleared
+    for (int a = 0; a < affected.size(); ++a) {
+        const int s = affected[a];
+        GraphVertex *source = m_graph[s];
+        qreal rowSum = 0;
+        for (k = 0; k < N; ++k) {
+            const qreal d = source->distance( csr.name(k) );
+            rowSum += d;
+            if ( k == s || d == RAND_MAX ) {
+                continue;
+            }
+            m_graphSumDistance -= d;
+            m_graphGeodesicsCount--;
+            m_geodesicDomainSize[k]--;
+            m_geodesicDomainSum[k] -= d;
+        }
+        m_graphSumDistance -= rowSum;
+        sumPC -= source->PC();
+        sumSPC -= source->SPC();
+        m_geodesicRangeSize[s] = 0;
+        m_geodesicRangeSum[s] = 0;
+        m_geodesicRangeMax[s] = 0;
+
+        if ( m_distancesStoreSize == N ) {
+            std::fill( m_distancesStore.begin() + (size_t) s * N,
+                       m_distancesStore.begin() + (size_t) ( s + 1 ) * N,
+                       std::numeric_limits<float>::infinity() );
+            std::fill( m_sigmasStore.begin() + (size_t) s * N,
+                       m_sigmasStore.begin() + (size_t) ( s + 1 ) * N, 0 );
         }
         else {
+            source->clearDistance();
+            source->clearShortestPaths();
+        }
+    }
 
-            maxIndexBC= ( N == 2 ) ? 1 : ( N-1.0 ) * ( N-2.0 );  // fix N=2 case where maxIndex becomes zero
-            maxIndexSC= ( N == 2 ) ? 1 : ( N-1.0 ) * ( N-2.0 );
-            maxIndexPC=N-1.0;
-            maxIndexCC=N-1.0;
-            qDebug("############# NOT SymmetricAdjacencyMatrix - maxIndexBC %f, maxIndexCC %f, maxIndexSC %f", maxIndexBC, maxIndexCC, maxIndexSC);
+    // New rows and contributions
+    workspaces.clear();
+    if ( !affected.isEmpty() ) {
+        graphDistancesGeodesicWorkers(csr, affected, workspaces,
+                                      true, considerWeights, inverseWeights,
+                                      false, false);
+    }
+    for (t = 0; t < (int) workspaces.size(); ++t) {
+        const GraphGeodesicWorkspace &ws = workspaces[t];
+        m_graphSumDistance += ws.sumDistance;
+        m_graphGeodesicsCount += ws.geodesicsCount;
+        sumPC += ws.sumPC;
+        sumSPC += ws.sumSPC;
+        for (i = 0; i < N; ++i) {
+            m_geodesicDomainSize[i] += ws.domainSize[i];
+            m_geodesicDomainSum[i] += ws.domainSum[i];
+            if ( repairCentralities ) {
+                m_geodesicBC[i] += ws.BC[i];
+                m_geodesicSC[i] += ws.SC[i];
+            }
         }
+    }
+
+    m_graphIsSymmetric = graphIsSymmetric();
 
-        if (considerWeights && inverseWeights) {
-            maxIndexCC = maxIndexCC * (1.0 / maxEdgeWeightInNetwork);
+    if ( repairCentralities ) {
+        for (i = 0; i < N; ++i) {
+            m_graph[i]->setBC( m_geodesicBC[i] );
+            m_graph[i]->setSC( m_geodesicSC[i] );
         }
+    }
+    else {
+        // The raw sums are stale, until the next full computation
+        vector<qreal>().swap(m_geodesicBC);
+        vector<qreal>().swap(m_geodesicSC);
+    }
 
-        qDebug() << "*********** MAIN LOOP: "
-                    "for every s in V solve the Single Source Shortest Path (SSSP) problem...";
-        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+    graphDistancesGeodesicFinish(repairCentralities, considerWeights,
+                                 inverseWeights, dropIsolates);
+
+    // The eccentricities follow from the repaired rows: the largest distance
+    // from each vertex, infinite if it does not reach every enabled vertex
+    int enabled = 0;
+    for (i = 0; i < N; ++i) {
+        if ( csr.isEnabled(i) ) {
+            enabled++;
+        }
+    }
+    maxEccentricity=0; minEccentricity=RAND_MAX; maxNodeEccentricity=0;
+    minNodeEccentricity=0; discreteEccentricities.clear();
+    classesEccentricity=0;
+    for (i = 0; i < N; ++i) {
+        if ( ! csr.isEnabled(i) ) {
+            continue;
+        }
+        const qreal eccentricity = ( m_geodesicRangeSize[i] < enabled - 1 )
+                ? RAND_MAX : m_geodesicRangeMax[i];
+        m_graph[i]->setEccentricity( eccentricity );
+        if ( eccentricity != RAND_MAX ) {
+            minmax( eccentricity, m_graph[i], maxEccentricity, minEccentricity,
+                    maxNodeEccentricity, minNodeEccentricity) ;
+            resolveClasses(eccentricity, discreteEccentricities,
+                           classesEccentricity, m_graph[i]->name() );
+        }
+    }
+    // graphEccentricitiesBounded() keeps the unweighted eccentricities only
+    calculatedEccentricity = ( ! considerWeights || ! graphIsWeighted() );
 
-            s=(*it)->name();
-            si=vpos[s];
-            distances_sum_for_s = 0;
+    calculatedDistances = true;
+    m_distancesIncrementalVersion = m_graphVersion;
 
-            qDebug()<< "***** PHASE 1 (SSSP): "
-                    << "Source vertex s" << s << "vpos" << si;
+    qDebug() << "Graph::distancesIncrementalRepair() - repaired"
+             << affected.size() << "rows, centralities" << repairCentralities;
 
-            emit signalProgressBoxUpdate( ++progressCounter );
+    return true;
+}
 
-            if ( ! (*it)->isEnabled() ) {
-                qDebug()<< "***** PHASE 1 (SSSP): s" << s  << "disabled. SKIP/CONTINUE";
-                continue;
-            }
 
 
-            if (computeCentralities) {
 
-                qDebug()<< "***** PHASE 1 (SSSP): "
-                           "Empty Stack which will return vertices in "
-                           "order of their (non increasing) distance from s ...";
-                //- Complexity linear O(n)
-                while ( !Stack.empty() ) {
-                    Stack.pop();
-                }
+/**
+ * @brief Allocates the workspace buffers for N vertices and zeroes the accumulators
+ * @param N
+ * @param computeCentralities
+ */
+void GraphGeodesicWorkspace::init(const int &N, const bool &computeCentralities) {
+    dist.assign(N, RAND_MAX);
+    sigma.assign(N, 0);
+    Q.clear();
+    Q.reserve(N);
+    heap.resize(N);
+    Stack.clear();
+    if (computeCentralities) {
+        delta.assign(N, 0);
+        Ps.assign(N, vector<int>());
+        Stack.reserve(N);
+        BC.assign(N, 0);
+        SC.assign(N, 0);
+    }
+    domainSize.assign(N, 0);
+    domainSum.assign(N, 0);
+    sizeOfNthOrderNeighborhood.clear();
+    sumDistance = 0;
+    geodesicsCount = 0;
+    sumPC = 0;
+    sumSPC = 0;
+    diameter = 0;
+    eccentricity = 0;
+}
 
-                qDebug()<< "***** PHASE 1 (SSSP): "
-                           "...and for each vertex: empty list Ps of predecessors";
-                for (it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1) {
-                    (*it1)->clearPs();
 
-                }
-                sizeOfNthOrderNeighborhood.clear();
-            }
+/**
+ * @brief Resets the per-source buffers before solving a new SSSP problem.
+ * Keeps the accumulators and the allocated capacity.
+ * @param computeCentralities
+ */
+void GraphGeodesicWorkspace::reset(const bool &computeCentralities) {
+    std::fill(dist.begin(), dist.end(), RAND_MAX);
+    std::fill(sigma.begin(), sigma.end(), 0);
+    Q.clear();
+    heap.clear();
+    Stack.clear();
+    eccentricity = 0;
+    if (computeCentralities) {
+        std::fill(delta.begin(), delta.end(), 0);
+        for (vector< vector<int> >::iterator it = Ps.begin(); it != Ps.end(); ++it) {
+            it->clear();
+        }
+        sizeOfNthOrderNeighborhood.clear();
+    }
+}
 
-            qDebug()<< "***** PHASE 1 (SSSP): "
-                       "Call BFS or dijkstra for s"
-                     << s << " vpos " << si
-                     << " to compute distance and shortest paths to every vertex t" ;
 
-            if (!considerWeights) {
-                BFS(s,si,computeCentralities, dropIsolates );
-            }
-            else {
-                dijkstra(s, si,computeCentralities, inverseWeights, dropIsolates);
-            }
 
-            qDebug()<< "***** PHASE 1 (SSSP): "
-                       "FINISHED BFS / DIJKSTRA ALGORITHM. "
-                   "Continuing to calculate centralities";
+/**
+ * @brief Sets the number of pivot sources used to estimate Betweenness and
+ * Stress centralities. Zero means exact computation (all sources).
+ * @param samples
+ */
+void Graph::setCentralityBetweennessSamples(const int &samples) {
+    qDebug() << "Graph::setCentralityBetweennessSamples() - samples" << samples;
+    m_centralityBetweennessSamples = ( samples > 0 ) ? samples : 0;
+    calculatedBCApproximate = false;
+}
 
-            if (computeCentralities) {
 
 
+/**
+ * @brief Computes approximate Betweenness and Stress centralities from a
+ * uniform sample of m_centralityBetweennessSamples pivot sources
+ * (Brandes & Pich, 2007).
+ * The dependencies of the sampled sources are accumulated with the same
+ * kernel as the exact computation and scaled by n/k, where n is the number
+ * of eligible sources and k the sample size. Distances and all other
+ * indices are left untouched.
+ * If sampling is disabled or k >= n, it computes the exact scores instead,
+ * via graphDistancesGeodesic().
+ * @param considerWeights
+ * @param inverseWeights
+ * @param dropIsolates
+ * @return true if the BC/SC scores are approximate
+ */
+bool Graph::centralityBetweennessApproximate(const bool &considerWeights,
+                                             const bool &inverseWeights,
+                                             const bool &dropIsolates) {
 
-                qDebug()<< "***** PHASE 2 (CENTRALITIES): "
-                           "s" << s << "vpos" << si << "CC" << CC;
+    GraphTraceScope trace("Graph::centralityBetweennessApproximate");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("considerWeights=%1 inverseWeights=%2 dropIsolates=%3")
+                    .arg(considerWeights).arg(inverseWeights).arg(dropIsolates) );
 
+    qDebug() << "Graph::centralityBetweennessApproximate() - samples"
+             << m_centralityBetweennessSamples;
 
-                // Compute Power Centrality
-                // In = [ 1/(N-1) ] * ( Nd1 + Nd2 * 1/2 + ... + Ndi * 1/i )
-                // where
-                // Ndi (sizeOfNthOrderNeighborhood) is the number of nodes at distance i from this node.
-                // N is the sum Nd0 + Nd1 + Nd2 + ... + Ndi, that is the amount of nodes in the same component as the current node
+    graphCancelReset();
 
-                sizeOfComponent = 1;
-                PC=0;
-                hfi = sizeOfNthOrderNeighborhood.constBegin();
-                //FIXME do we need to check for disabled nodes somewhere?
-                while (hfi != sizeOfNthOrderNeighborhood.constEnd()) {
-                    qDebug() << " sizeOfNthOrderNeighborhood.value("<< hfi.key() <<")"
-                                 << hfi.value();
-                    PC += ( 1.0 / hfi.key() ) * hfi.value();
-                    sizeOfComponent += hfi.value();
-                    ++hfi;
-                }
+    VList::const_iterator it;
+    QVector<int> sources;
+    int i=0;
 
-                (*it)->setPC( PC );
-                sumPC += PC;
-                if ( sizeOfComponent != 1 )
-                    SPC = ( 1.0/(sizeOfComponent-1.0) ) * PC;
-                else
-                    SPC = 0;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it, ++i) {
+        if ( ! (*it)->isEnabled() || ( dropIsolates && (*it)->isIsolated() ) ) {
+            continue;
+        }
+        sources << i;
+    }
+
+    const int k = m_centralityBetweennessSamples;
+
+    if ( k <= 0 || k >= sources.size() || edgesEnabled() == 0 ) {
+        const int cacheParameters = GraphResultCache::parameters(considerWeights,
+                                                                 inverseWeights,
+                                                                 dropIsolates);
+        if ( ! ( calculatedCentralities && m_graphCentralitiesParameters == cacheParameters )
+             && resultCacheRestore(IndexType::BC, cacheParameters)
+             && resultCacheRestore(IndexType::SC, cacheParameters) ) {
+            qDebug() << "Graph::centralityBetweennessApproximate() - "
+                        "exact scores restored from cache";
+            return false;
+        }
+        qDebug() << "Graph::centralityBetweennessApproximate() - "
+                    "computing exact scores instead";
+        graphDistancesGeodesic(true, considerWeights, inverseWeights, dropIsolates);
+        return false;
+    }
+
+    if ( calculatedBCApproximate && m_centralityBetweennessSampled == k ) {
+        qDebug() << "Graph::centralityBetweennessApproximate() - "
+                    "graph not modified. Return.";
+        return true;
+    }
 
-                (*it)->setSPC( SPC );	//Set std PC
+    const qreal scale = (qreal) sources.size() / (qreal) k;
 
-                sumSPC += SPC;   //add to sumSPC -- used later to compute mean and variance
+    // Choose k distinct pivots with a partial Fisher-Yates shuffle
+    for (i = 0; i < k; ++i) {
+        qSwap( sources[i], sources[ i + m_random.bounded( sources.size() - i ) ] );
+    }
+    sources.resize(k);
 
-                qDebug()<< "***** PHASE 2 (CENTRALITIES): "
-                           "s" << s << "vpos" << si << "PC" << PC;
+    QString pMsg  = tr("Estimating betweenness from %1 sampled sources. \nPlease wait...").arg(k);
+    emit statusMessage ( pMsg  );
+    graphProgressCreate(k, pMsg );
 
+    const GraphCSR &csr = graphCSR();
+    vector<GraphGeodesicWorkspace> workspaces;
 
-                // Compute Betweenness Centrality
+    graphDistancesGeodesicWorkers(csr, sources, workspaces,
+                                  true, considerWeights, inverseWeights, true,
+                                  true, &m_cancelRequested);
 
-                qDebug()<< "***** PHASE 2 (BC/ACCUMULATION): "
-                           "Start back propagation of dependencies." <<
-                           "Set dependency delta[u]=0 on each vertex";
+    if ( graphCancelled() ) {
+        // The sampled dependencies are incomplete, keep the old scores
+        qDebug() << "Graph::centralityBetweennessApproximate() - cancelled. Return.";
+        graphProgressKill();
+        emit statusMessage( tr("Estimating betweenness cancelled.") );
+        return true;
+    }
 
-                for (it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1){
-                    (*it1)->setDelta(0.0);
+    vector<qreal> BC(m_graph.size(), 0), SC(m_graph.size(), 0);
+    for (size_t t = 0; t < workspaces.size(); ++t) {
+        for (i = 0; i < m_graph.size(); ++i) {
+            BC[i] += workspaces[t].BC[i];
+            SC[i] += workspaces[t].SC[i];
+        }
+    }
 
-                    // compute sum of distances from current vertex to every other vertex
+    centralityBetweennessApply(BC, SC, scale, dropIsolates);
 
-                    distances_sum_for_s += (*it)->distance( (*it1)->name() ) ;
-                    qDebug() << "    Compute Centralities: "
-                               "For CC: sum of distances. distance(" << (*it)->name()
-                             << "," <<  (*it1)->name() << ") = " << (*it)->distance( (*it1)->name() )
-                             << "new sum of distances for s =" << distances_sum_for_s;
+    // The BC/SC scores of the vertices are estimates now
+    calculatedBCApproximate = true;
+    m_centralityBetweennessSampled = k;
 
-                }
-                qDebug() << "    Compute Centralities: "
-                          "For CC: total sum of distances for s =" << distances_sum_for_s;
+    graphProgressKill();
 
-                m_graphSumDistance += distances_sum_for_s;
+    return true;
+}
 
-                // Compute Closeness Centrality
-                if ( distances_sum_for_s != 0 && distances_sum_for_s < RAND_MAX)  {
-                    // Connected actor:
-                    // There is a path from this actor to all others
-                    // Invert the sum of distances and set it as CC
-                    CC=1.0/distances_sum_for_s;
-                }
-                else {
-                    // Not connected actor. Cases:
-                    // a) Isolated: The actor has no outbound links
-                    // b) Disconnected graph: There is no path from this actor
-                    // to some of the other actors, which means her distance to
-                    // them is infinite
-                    // For these two cases, set CC as zero.
-                    CC=0;
-                }
-                (*it)->setCC( CC );
 
 
+/**
+ * @brief Sets the Betweenness and Stress centralities of the vertices from
+ * the dependencies accumulated by graphDistancesGeodesicWorkers() over
+ * some sources, scaled by scale, and computes their std scores and statistics.
+ * @param sumsBC the BC dependencies of each vertex index
+ * @param sumsSC the SC counts of each vertex index
+ * @param scale n/k, when k of n sources were used
+ * @param dropIsolates
+ */
+void Graph::centralityBetweennessApply(const vector<qreal> &sumsBC,
+                                       const vector<qreal> &sumsSC,
+                                       const qreal &scale,
+                                       const bool &dropIsolates) {
 
-                qDebug()<< "***** PHASE 2 (BC/ACCUMULATION): "
-                           "Visit all vertices in reverse order of their discovery (from s = "
-                         << s
-                         << " ) to sum dependencies. Initial Stack size " << Stack.size();
+    VList::const_iterator it;
+    int i=0;
+    int N = vertices(dropIsolates,false,true);
+    qreal BC=0, SBC=0, SC=0, SSC=0;
+    qreal tempVarianceBC=0, tempVarianceSC=0;
 
-                while ( !Stack.empty() ) {
-                    w=Stack.top();
-                    wi=vpos[w];
+    m_graphIsSymmetric = graphIsSymmetric();
 
-                    qDebug()<< "***** PHASE 2 (BC/ACCUMULATION): "
-                               "Stack top is vertex w " << w
-                            << "This is the furthest vertex from s. Popping it.";
+    if (m_graphIsSymmetric) {
+        maxIndexBC= ( N == 2 ) ? 1 : ( N-1.0 ) * ( N-2.0 ) / 2.0;
+        maxIndexSC= ( N == 2 ) ? 1 : ( N-1.0 ) * ( N-2.0 ) / 2.0;
+    }
+    else {
+        maxIndexBC= ( N == 2 ) ? 1 : ( N-1.0 ) * ( N-2.0 );
+        maxIndexSC= ( N == 2 ) ? 1 : ( N-1.0 ) * ( N-2.0 );
+    }
 
-                    Stack.pop();
-                    QList<int> lst=m_graph[wi]->Ps();
+    maxSBC=0; minSBC=RAND_MAX; nomSBC=0; denomSBC=0; groupSBC=0; maxNodeSBC=0;
+    minNodeSBC=0; sumBC=0; sumSBC=0;
+    discreteBCs.clear(); classesSBC=0;
+    maxSSC=0; minSSC=RAND_MAX; groupSC=0; maxNodeSSC=0;
+    minNodeSSC=0;sumSC=0; sumSSC=0;
+    discreteSCs.clear(); classesSSC=0;
 
-                    qDebug()<< "***** PHASE 2 (BC/ACCUMULATION): "
-                               "preLOOP: Size of predecessors list Ps[w]"<< lst.size();
+    for (i=0, it=m_graph.cbegin(); it!=m_graph.cend(); ++it, ++i) {
+        BC = sumsBC[i] * scale;
+        SC = sumsSC[i] * scale;
+        if (m_graphIsSymmetric) {
+            BC /= 2.0;
+            SC /= 2.0;
+        }
+        (*it)->setBC( BC );
+        (*it)->setSC( SC );
 
-                    qDebug()<< "***** PHASE 2 (BC/ACCUMULATION): "
-                               "LOOP over every vertex u in Ps of w"<<w;
+        if ( dropIsolates && (*it)->isIsolated() ){
+            continue;
+        }
 
-                    if (lst.size() > 0) // just in case...do a sanity check
-                        for ( it2=lst.cbegin(); it2 != lst.cend(); it2++ ){
-                            u=(*it2);
-                            ui=vpos[u];
-                            sigma_u=m_graph[si]->shortestPaths(u);
-                            sigma_w=m_graph[si]->shortestPaths(w);
-                            delta_u=m_graph[ui]->delta();
-                            delta_w=m_graph[wi]->delta();
+        sumBC+=BC;
+        SBC = BC/maxIndexBC;
+        (*it)->setSBC( SBC );
+        resolveClasses(SBC, discreteBCs, classesSBC);
+        sumSBC+=SBC;
+        minmax( SBC, (*it), maxSBC, minSBC, maxNodeSBC, minNodeSBC) ;
 
-                            qDebug()<< "***** PHASE 2 (BC/ACCUMULATION): "
-                                       "Selecting Ps[w] element u"<< u
-                                    << "with delta_u" << delta_u
-                                    << "sigma(s,u)"<< sigma_u
-                                    << "sigma(s,w)" << sigma_w
-                                    << "delta_w"<< delta_w;
+        sumSC+=SC;
+    }
 
-                            if ( m_graph[si]->shortestPaths(w) > 0 ) {
-                                //delta[u]=delta[u]+(1+delta[w])*(sigma[u]/sigma[w]) ;
-                                d_su=delta_u + ( 1.0 + delta_w ) * ( (qreal) sigma_u / (qreal)sigma_w);
-                            }
-                            else {
-                                d_su=delta_u;
-                                qDebug()<< "***** PHASE 2 (BC/ACCUMULATION): "
-                                           "zero shortest paths from s to w - "
-                                           "using SAME DELTA for vertex u";
-                            }
-                            qDebug()<< "***** PHASE 2 (BC/ACCUMULATION): "
-                                       "Assigning new delta d_su"
-                                    << d_su
-                                    << " to u" << u;
+    meanSBC = sumSBC /(qreal) N ;
+    varianceSBC=0;
 
-                            m_graph[ui]->setDelta( d_su);
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+        if ( dropIsolates && (*it)->isIsolated() ) {
+            continue;
+        }
+        SSC = ( sumSC != 0 ) ? (*it)->SC() / sumSC : 0;
+        (*it)->setSSC(SSC);
+        resolveClasses(SSC, discreteSCs, classesSSC);
+        sumSSC+=SSC;
+        minmax( SSC, (*it), maxSSC, minSSC, maxNodeSSC, minNodeSSC) ;
 
-                        } // end for
+        SBC=(*it)->SBC();
+        nomSBC +=(maxSBC - SBC );
 
-                    qDebug()<< "***** PHASE 2 (BC/ACCUMULATION): "
-                               "Adding delta_w to BC of w";
+        tempVarianceBC = (  SBC  -  meanSBC  ) ;
+        tempVarianceBC *=tempVarianceBC;
+        varianceSBC  += tempVarianceBC;
+    }
+    varianceSBC  /=  (qreal) N;
 
-                    if  (w!=s) {
+    meanSSC = sumSSC /(qreal) N ;
+    varianceSSC=0;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+        if ( dropIsolates && (*it)->isIsolated() ){
+            continue;
+        }
+        tempVarianceSC = (  (*it)->SSC()  -  meanSSC  ) ;
+        tempVarianceSC *=tempVarianceSC;
+        varianceSSC  += tempVarianceSC;
+    }
+    varianceSSC  /=  (qreal) N;
 
-                        qDebug()<< "***** PHASE 2 (BC/ACCUMULATION): "
-                                   "w!=s. For this furthest vertex we need to add its new delta"
-                                 << delta_w
-                                 << "to old BC index:"
-                                 <<  m_graph[wi]->BC();
+    denomSBC =   (N-1.0) ;  // Wasserman&Faust - formula 5.14
+    groupSBC=nomSBC/denomSBC;
 
-                        d_sw = m_graph[wi]->BC() + delta_w;
+    // The vertices no longer hold the scores of a cached result
+    calculatedCentralities = false;
+    m_resultCache.clearLive(IndexType::BC);
+    m_resultCache.clearLive(IndexType::SC);
+    m_prominenceScoreIndex.remove(IndexType::BC);
+    m_prominenceScoreIndex.remove(IndexType::SC);
+}
 
-                        qDebug()<< "***** PHASE 2 (BC/ACCUMULATION): "
-                                   "s" << s << "vpos" << si << "BC = d_sw" << d_sw;
 
-                        m_graph[wi]->setBC (d_sw);
 
-                    } // END if
+/**
+ * @brief Starts computing the exact Betweenness and Stress centralities in
+ * the background, on a graphSnapshot() of the current relation, so that the
+ * graph can be edited and browsed meanwhile. The job runs on worker threads
+ * and only touches the snapshot. When it finishes, backgroundAnalysisApply()
+ * attaches the results to the graph version they were computed for.
+ * Returns false if there is nothing to run in the background, that is the
+ * scores are already known or they are to be estimated from sampled sources,
+ * in which case centralityBetweennessApproximate() must be called directly.
+ * @param considerWeights
+ * @param inverseWeights
+ * @param dropIsolates
+ * @return true if a background job is running
+ */
+bool Graph::centralityBetweennessBackground(const bool &considerWeights,
+                                            const bool &inverseWeights,
+                                            const bool &dropIsolates) {
 
-                } // END while stack
+    if ( m_backgroundJob.isRunning() ) {
+        qDebug() << "Graph::centralityBetweennessBackground() - job already running";
+        return true;
+    }
 
-            } // END if computeCentralities
+    const int cacheParameters = GraphResultCache::parameters(considerWeights,
+                                                             inverseWeights,
+                                                             dropIsolates);
 
-        }     // END for SSSP problem
+    if ( m_centralityBetweennessSamples > 0 || edgesEnabled() == 0
+         || ( calculatedCentralities && m_graphCentralitiesParameters == cacheParameters )
+         || m_resultCache.find(IndexType::BC, cacheParameters, m_graphVersion) != nullptr ) {
+        qDebug() << "Graph::centralityBetweennessBackground() - nothing to run";
+        return false;
+    }
 
+    VList::const_iterator it;
+    QVector<int> sources;
+    int i=0;
 
-        qDebug() << "*********** MAIN LOOP (SSSP problem): FINISHED.";
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it, ++i) {
+        if ( ! (*it)->isEnabled() || ( dropIsolates && (*it)->isIsolated() ) ) {
+            continue;
+        }
+        sources << i;
+    }
 
+    m_backgroundSnapshot = graphSnapshot();
+    m_backgroundParameters = cacheParameters;
+    m_backgroundDropIsolates = dropIsolates;
+    m_backgroundAbort.storeRelease(0);
 
-        // check if there are disconnected nodes
-        // and get the distance sums
-        qDebug() << "Checking if there are disconnected nodes";
+    qDebug() << "Graph::centralityBetweennessBackground() - starting job on snapshot version"
+             << m_backgroundSnapshot->version() << "sources" << sources.size();
 
-        m_graphIsConnected = true;
+    emit statusMessage( tr("Computing betweenness in the background...") );
 
-        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+    std::shared_ptr<const GraphCSR> snapshot = m_backgroundSnapshot;
 
-            if ( ! (*it)->isEnabled() ) {
-                qDebug()<< "actor i" <<  (*it)->name() << "disabled. SKIP/CONTINUE";
-                continue;
+    m_backgroundJob = GraphScheduler::run( [this, snapshot, sources,
+                                         considerWeights, inverseWeights]() {
+        vector<GraphGeodesicWorkspace> workspaces;
+        graphDistancesGeodesicWorkers(*snapshot, sources, workspaces,
+                                      true, considerWeights, inverseWeights,
+                                      true, false, &m_backgroundAbort);
+        m_backgroundBC.assign(snapshot->vertices(), 0);
+        m_backgroundSC.assign(snapshot->vertices(), 0);
+        for (size_t t = 0; t < workspaces.size(); ++t) {
+            for (int i = 0; i < snapshot->vertices(); ++i) {
+                m_backgroundBC[i] += workspaces[t].BC[i];
+                m_backgroundSC[i] += workspaces[t].SC[i];
             }
+        }
+        emit signalBackgroundAnalysisDone();
+    } );
 
-            pairDistance = 0;
+    return true;
+}
 
-            for ( it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1){
 
-                if ( ! (*it1)->isEnabled() ) {
-                    qDebug()<< "   actor j" <<  (*it1)->name() << "disabled. SKIP/CONTINUE";
-                    continue;
-                }
-                if (  (*it1)->name() == (*it)->name() ) {
-                    qDebug()<< "   == actor j" <<  (*it1)->name() << "SKIP/CONTINUE";
-                    continue;
-                }
-                
-                pairDistance = (*it)-> distance ( (*it1)->name() );
-                
-                if ( pairDistance == RAND_MAX) {
-                    m_vertexPairsNotConnected.insert((*it)->name(), (*it1)->name());
-                    (*it)->setEccentricity( RAND_MAX );
-                    m_graphIsConnected = false;
-
-                    qDebug()<< "actor i" <<  (*it)->name()
-                            << "has infinite eccentricity. "
-                               "There is no path from it to actor j"
-                            << (*it1)->name();
 
-                }
-                else {
+/**
+ * @brief Called in the graph thread when the background job has finished.
+ * If the snapshot still describes the current graph version, the results
+ * become the BC/SC scores of the vertices and are filed in m_resultCache
+ * for that version. Otherwise, they are dropped.
+ * Emits signalBackgroundAnalysisFinished in both cases.
+ */
+void Graph::backgroundAnalysisApply() {
 
-                    qDebug()<< "actor i" <<  (*it)->name()
-                            <<"distanceSum" << (*it)->distanceSum();
-                    (*it)->setDistanceSum( (*it)->distanceSum() + pairDistance);
+    const bool current = m_backgroundSnapshot
+            && ! m_backgroundAbort.loadAcquire()
+            && m_backgroundSnapshot->isValid( relationCurrent(), m_graphVersion );
 
-                }
-            } // end for
-            
-            qDebug()<< "actor i" <<  (*it)->name()
-                    <<"Final distanceSum" << (*it)->distanceSum();
+    qDebug() << "Graph::backgroundAnalysisApply() - snapshot version"
+             << ( m_backgroundSnapshot ? m_backgroundSnapshot->version() : 0 )
+             << "graph version" << m_graphVersion
+             << "current" << current;
 
+    if ( current ) {
+        centralityBetweennessApply(m_backgroundBC, m_backgroundSC, 1.0,
+                                   m_backgroundDropIsolates);
+        calculatedBCApproximate = false;
+        resultCacheStore(IndexType::BC, m_backgroundParameters);
+        resultCacheStore(IndexType::SC, m_backgroundParameters);
+    }
 
-            if (computeCentralities) {
+    m_backgroundSnapshot.reset();
+    vector<qreal>().swap(m_backgroundBC);
+    vector<qreal>().swap(m_backgroundSC);
 
-                // Compute Eccentricity (max geodesic distance)
-                eccentricity = (*it)->eccentricity();
-                
-                qDebug() << "actor"
-                         << (*it)->name()
-                         << "eccentricity" << eccentricity;
-                
-                if ( eccentricity != RAND_MAX ) {
-
-                    //Find min/max Eccentricity
-                    minmax( eccentricity, (*it), maxEccentricity, minEccentricity,
-                            maxNodeEccentricity, minNodeEccentricity) ;
-                    resolveClasses(eccentricity, discreteEccentricities,
-                                   classesEccentricity ,(*it)->name() );
-
-                    //Eccentricity Centrality is the inverted Eccentricity
-                    EC=1.0 / eccentricity;
-                    (*it)->setEC( EC ); //Set Eccentricity Centrality
-                    (*it)->setSEC( EC ); //Set std EC = EC
-                    sumEC+=EC;  //set sum EC
-
-                    qDebug()<< "actor i" <<  (*it)->name()
-                            << "EC"
-                            << EC;
-                }
-                else {
+    emit signalBackgroundAnalysisFinished(IndexType::BC, current);
+}
 
-                    EC=0;
-                    (*it)->setEC( EC );     //Set Eccentricity Centrality
-                    (*it)->setSEC( EC );    //Set std EC = EC
-                    sumEC+=EC;  //set sum EC
 
-                    qDebug()<< "actor i" <<  (*it)->name()
-                            << "EC=0 (disconnected graph)";
 
-                }
-                
-            } // end if compute centralities
+/**
+ * @brief Runs the SSSP kernel for every source index in sources, using
+ * a pool of graphWorkerThreads() workers.
+ * Sources are handed out one at a time, so that workers stay busy even when
+ * the per-source cost varies a lot. Each worker owns one workspace, which
+ * the caller reduces after this method returns.
+ * Emits signalProgressBoxUpdate while the workers run.
+ * @param csr the adjacency snapshot, built by the caller
+ * @param sources the indices (vpos) of the source vertices
+ * @param workspaces returns one workspace per worker
+ * @param computeCentralities
+ * @param considerWeights
+ * @param inverseWeights
+ * @param dependenciesOnly if true, only the BC/SC accumulators are updated
+ * and the graph itself is not accessed, thus csr may be a graphSnapshot()
+ * @param reportProgress if false, no progress signals are emitted
+ * @param abort if not null and set, the workers stop taking new sources
+ */
+void Graph::graphDistancesGeodesicWorkers(const GraphCSR &csr,
+                                          const QVector<int> &sources,
+                                          vector<GraphGeodesicWorkspace> &workspaces,
+                                          const bool &computeCentralities,
+                                          const bool &considerWeights,
+                                          const bool &inverseWeights,
+                                          const bool &dependenciesOnly,
+                                          const bool &reportProgress,
+                                          const QAtomicInt *abort) {
+
+    const int N = csr.vertices();
+    const int totalSources = sources.size();
+    const int threads = graphWorkerThreads(totalSources);
+
+    qCHotDebug(lcGraph) << "Graph::graphDistancesGeodesicWorkers() - starting" << threads
+             << "workers for" << totalSources << "sources";
+
+    workspaces.clear();
+    workspaces.resize(threads);
+
+    // A workspace is initialized by its worker, if that worker ever runs
+    vector<char> initialized(threads, 0);
+
+    GraphScheduler::Progress progress;
+    if ( reportProgress ) {
+        progress = [this](const int &done) { graphProgressUpdate(done); };
+    }
+
+    GraphScheduler::parallelFor( totalSources, threads,
+                                 [&](const int &t, const int &first, const int &last) {
+        GraphGeodesicWorkspace &ws = workspaces[t];
+        if ( ! initialized[t] ) {
+            ws.init( N, computeCentralities );
+            initialized[t] = 1;
+        }
+        for (int next = first; next < last; ++next) {
+            if ( csr.isEnabled( sources[next] ) ) {
+                graphDistancesGeodesicSource( sources[next], ws, csr,
+                                              computeCentralities,
+                                              considerWeights,
+                                              inverseWeights,
+                                              dependenciesOnly );
+            }
+        }
+    }, 1, progress, abort );
 
-        } // end for disconnected checking
+    // Drop the workspaces of the workers which found nothing left to do
+    for (int t = threads - 1; t > 0; --t) {
+        if ( ! initialized[t] ) {
+            workspaces.erase( workspaces.begin() + t );
+        }
+    }
+    if ( ! initialized[0] ) {
+        workspaces[0].init( N, computeCentralities );
+    }
 
-        // Compute average path length...
-        if (m_vertexPairsNotConnected.count()==0) {
+    if ( reportProgress ) {
+        graphProgressUpdate( totalSources );
+    }
 
-            m_graphAverageDistance = m_graphSumDistance / ( N * ( N-1.0 ) );
-            qDebug() <<"Graph::graphDistancesGeodesic() - Average distance:"
-                    << m_graphAverageDistance ;
+    qCHotDebug(lcGraph) << "Graph::graphDistancesGeodesicWorkers() - finished";
+}
 
-        }
-        else {
 
-            //TODO In not connected nets, it would be nice to ask the user what to do
-            // with unconnected pairs (make M or drop (default?)
-            qDebug() <<"Graph::graphDistancesGeodesic() - Average distance:"
-                    << m_graphAverageDistance ;
-            m_graphAverageDistance = m_graphSumDistance / m_graphGeodesicsCount;
 
+/**
+ * @brief Returns the number of workers to use for the given number of
+ * independent work items, at most the size of the shared GraphScheduler
+ * pool, which is set in the Settings dialog or by socnetv --batch --threads.
+ * @param items
+ * @return int
+ */
+int Graph::graphWorkerThreads(const int &items) const {
+    return GraphScheduler::workers(items);
+}
 
-        }
 
 
-        if (computeCentralities) {
+/**
+ * @brief Starts reporting the progress of a computation of max steps, and
+ * asks MainWindow to show a progress box with msg.
+ * If max is 0, the computation has as many steps as vertices.
+ * The outermost computation also clears any earlier graphCancel(), see
+ * graphCancelReset().
+ * @param max
+ * @param msg
+ */
+void Graph::graphProgressCreate(const int max, const QString msg) {
+    graphCancelReset();
+    m_progress.start( ( max == 0 ) ? vertices() : max );
+    emit signalProgressBoxCreate(max, msg);
+}
 
-            qDebug() << "Graph: graphDistancesGeodesic() - "
-                        "Computing centralities...";
-            for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
-                if ( dropIsolates && (*it)->isIsolated() ){
-                    qDebug() << "vertex " << (*it)->name()
-                             << " isolated, continue. ";
-                    continue;
-                }
 
-                // Compute classes and min/maxEC
-                SEC=(*it)->SEC();
-                resolveClasses(SEC, discreteECs, classesEC,(*it)->name() );
-                minmax( SEC, (*it), maxEC, minEC, maxNodeEC, minNodeEC) ;
-
-                // Compute classes and min/maxSPC
-                SPC = (*it)->SPC();  //same as PC
-                resolveClasses(SPC, discretePCs, classesSPC,(*it)->name() );
-                minmax( SPC, (*it), maxSPC, minSPC, maxNodeSPC, minNodeSPC) ;
-
-                // Compute std BC, classes and min/maxSBC
-                if (m_graphIsSymmetric) {
-                    qDebug()<< "Betweenness centrality must be divided by"
-                            <<" two if the graph is undirected";
-                    (*it)->setBC ( (*it)->BC()/2.0);
-                }
-                BC=(*it)->BC();
-                sumBC+=BC;
-                SBC = BC/maxIndexBC;
-                (*it)->setSBC( SBC );
-                resolveClasses(SBC, discreteBCs, classesSBC);
-                sumSBC+=SBC;
-                minmax( SBC, (*it), maxSBC, minSBC, maxNodeSBC, minNodeSBC) ;
-
-                // Compute std CC, classes and min/maxSCC
-                CC = (*it)->CC();
-                sumCC+=CC;
-                SCC = maxIndexCC * CC;
-                (*it)->setSCC (  SCC );
-                resolveClasses(SCC, discreteCCs, classesSCC,(*it)->name() );
-                sumSCC+=SCC;
-                minmax( SCC, (*it), maxSCC, minSCC, maxNodeSCC, minNodeSCC) ;
-
-                //prepare to compute stdSC
-                SC=(*it)->SC();
-                if (m_graphIsSymmetric){
-                    (*it)->setSC(SC/2.0);
-                    SC=(*it)->SC();
-                    qDebug() << "SC of " <<(*it)->name()
-                             << "  divided by 2 (because the graph is symmetric) "
-                             << (*it)->SC();
-                }
-                sumSC+=SC;
+/**
+ * @brief Records that count steps of the running computation are done.
+ * Loops call it as often as they like: the progress box, and its throughput
+ * and time left, are updated at most every 100 msecs, and at the end, so that
+ * fast loops do not flood the GUI thread with queued events.
+ * @param count
+ */
+void Graph::graphProgressUpdate(const int &count) {
+    if ( m_progress.update(count) ) {
+        emit signalProgressBoxUpdate(count);
+        emit signalProgressBoxRate( m_progress.throughput(), m_progress.eta() );
+    }
+}
 
-                qDebug() << "vertex " << (*it)->name() << " - "
-                         << " EC: "<< (*it)->EC()
-                         << " CC: "<< (*it)->CC()
-                         << " BC: "<< (*it)->BC()
-                         << " SC: "<< (*it)->SC()
-                         << " PC: "<< (*it)->PC();
-            } // end for
 
-            qDebug() << "Graph: graphDistancesGeodesic() -"
-                        "Computing mean centrality values...";
+/**
+ * @brief Ends the running computation and asks MainWindow to close its
+ * progress box.
+ */
+void Graph::graphProgressKill() {
+    m_progress.finish();
+    emit signalProgressBoxKill();
+}
 
-            // Compute mean values and prepare to compute variances
-            meanSBC = sumSBC /(qreal) N ;
-            varianceSBC=0;
-            tempVarianceBC=0;
 
-            meanSCC = sumSCC /(qreal) N ;
-            varianceSCC=0;
-            tempVarianceCC=0;
 
-            meanSPC = sumSPC /(qreal) N ;
-            varianceSPC=0;
-            tempVariancePC=0;
+/**
+ * @brief Asks the running analysis to stop, as when the user clicks Cancel
+ * in its progress box. Thread-safe: it only sets a flag, which the analyses
+ * check at coarse granularity (per source vertex, per iteration, etc.) via
+ * graphCancelled(). The cancelled analysis discards its partial results.
+ */
+void Graph::graphCancel() {
+    qDebug() << "Graph::graphCancel()";
+    m_cancelRequested.storeRelease(1);
+}
 
-            meanEC = sumEC /(qreal) N ;
-            varianceEC=0;
-            tempVarianceEC=0;
 
-            qDebug() << "Graph: graphDistancesGeodesic() - "
-                        "Computing std centralities ...";
 
-            for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
-                if ( dropIsolates && (*it)->isIsolated() ) {
-                    continue;
-                }
-                // Compute std SC, classes and min/maxSSC
-                SC=(*it)->SC();
-                SSC=SC/sumSC;
-                (*it)->setSSC(SSC);
-                resolveClasses(SSC, discreteSCs, classesSSC);
-                sumSSC+=SSC;
-                minmax( SSC, (*it), maxSSC, minSSC, maxNodeSSC, minNodeSSC) ;
+/**
+ * @brief Forgets any earlier graphCancel(), unless another computation is
+ * running. Called when a cancellable analysis starts, so that a result
+ * restored from the caches is not mistaken for a cancelled one.
+ */
+void Graph::graphCancelReset() {
+    if ( m_progress.depth() == 0 ) {
+        m_cancelRequested.storeRelease(0);
+    }
+}
+
 
-                //Compute numerator of groupSBC
-                SBC=(*it)->SBC();
-                nomSBC +=(maxSBC - SBC );
 
-                //calculate BC variance
-                tempVarianceBC = (  SBC  -  meanSBC  ) ;
-                tempVarianceBC *=tempVarianceBC;
-                varianceSBC  += tempVarianceBC;
+/**
+ * @brief Calls work(worker, item) for every item in 0..items-1, on a pool of
+ * threads workers, see GraphScheduler::parallelFor(). Items are handed out one
+ * at a time, and each worker passes its own number 0..threads-1, so that it
+ * can write to per-worker state; the calling thread is worker 0.
+ * Emits signalProgressBoxUpdate with the number of finished items, while the
+ * workers run, unless reportProgress is false. Returns when all items are done.
+ * @param items
+ * @param threads the number of workers, see graphWorkerThreads()
+ * @param work
+ * @param reportProgress
+ */
+void Graph::graphParallelFor(const int &items,
+                             const int &threads,
+                             const std::function<void (const int &, const int &)> &work,
+                             const bool &reportProgress) {
 
-                //Compute numerator of groupCC
-                nomSCC += maxSCC- (*it)->SCC();
+    qDebug() << "Graph::graphParallelFor() - starting" << threads
+             << "workers for" << items << "items";
 
-                //calculate CC variance
-                tempVarianceCC = (  (*it)->SCC()  -  meanSCC  ) ;
-                tempVarianceCC *=tempVarianceCC;
-                varianceSCC  += tempVarianceCC;
+    GraphScheduler::Progress progress;
+    if ( reportProgress ) {
+        progress = [this](const int &done) { graphProgressUpdate(done); };
+    }
 
-                //Compute numerator of groupSPC
-                SPC=(*it)->SPC();
-                nomSPC +=(maxSPC - SPC );
+    GraphScheduler::parallelFor( items, threads,
+                                 [&work](const int &t, const int &first, const int &last) {
+        for (int item = first; item < last; ++item) {
+            work( t, item );
+        }
+    }, 1, progress );
 
-                //calculate PC variance
-                tempVariancePC = (  (*it)->SPC()  -  meanSPC  ) ;
-                tempVariancePC *=tempVariancePC;
-                varianceSPC  += tempVariancePC;
+    if ( reportProgress ) {
+        graphProgressUpdate( items );
+    }
+}
 
 
-                //calculate EC variance
-                tempVarianceEC = (  (*it)->EC()  -  meanEC  ) ;
-                tempVarianceEC *=tempVarianceEC;
-                varianceEC  += tempVarianceEC;
 
+/**
+ * @brief Solves the SSSP problem for the source vertex at index si and,
+ * if computeCentralities is true, accumulates its contribution to the
+ * centrality indices (PC, CC, BC, SC, eccentricity).
+ *
+ * This is the per-source unit of work of graphDistancesGeodesic() and it is
+ * thread-safe: it only writes to the workspace ws and to the source vertex
+ * itself, while BC/SC dependencies go to the workspace accumulators.
+ *
+ * @param si  the index (vpos) of the source vertex
+ * @param ws  the calling worker's own workspace
+ * @param csr the adjacency snapshot to traverse
+ * @param computeCentralities
+ * @param considerWeights
+ * @param inverseWeights
+ * @param dependenciesOnly if true, only accumulates BC/SC dependencies and
+ * leaves the distances and all other indices of the source untouched.
+ */
+void Graph::graphDistancesGeodesicSource(const int &si,
+                                         GraphGeodesicWorkspace &ws,
+                                         const GraphCSR &csr,
+                                         const bool &computeCentralities,
+                                         const bool &considerWeights,
+                                         const bool &inverseWeights,
+                                         const bool &dependenciesOnly) {
 
-            } // end for
+    const int N = csr.vertices();
+    int w=0, k=0;
+    qreal PC=0, SPC=0, CC=0, sizeOfComponent=0, distances_sum_for_s=0;
+    H_f_i::const_iterator hfi ; // for Power Centrality
+    vector<int>::const_iterator it2;
 
-            //compute final variances
-            varianceSBC  /=  (qreal) N;
-            varianceSCC  /=  (qreal) N;
-            varianceSPC  /=  (qreal) N;
+    // Sampled or snapshot sources must not touch the graph
+    GraphVertex *source = dependenciesOnly ? nullptr : m_graph[si];
 
-            varianceEC  /=  (qreal) N;
+    qCHotDebug(lcGraph)<< "***** PHASE 1 (SSSP): "
+            << "Source vertex s" << csr.name(si) << "vpos" << si;
 
+    ws.reset(computeCentralities);
 
-            // calculate SC mean value and prepare to compute variance
-            meanSSC = sumSSC /(qreal) N ;
-            varianceSSC=0;
-            tempVarianceSC=0;
-            for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
-                if ( dropIsolates && (*it)->isIsolated() ){
-                    continue;
-                }
-                tempVarianceSC = (  (*it)->SSC()  -  meanSSC  ) ;
-                tempVarianceSC *=tempVarianceSC;
-                varianceSSC  += tempVarianceSC;
+    if (!considerWeights) {
+        BFS(si, ws, csr, computeCentralities );
+    }
+    else {
+        dijkstra(si, ws, csr, computeCentralities, inverseWeights);
+    }
+
+    // Store the distances and shortest path counts of s to every reachable t
+    if ( dependenciesOnly ) {
+        // sampled sources: nothing to store
+    }
+    else if ( m_distancesStoreSize == N ) {
+        // Row si of the compact store is written only by this worker
+        float *distRow = m_distancesStore.data() + (size_t) si * N;
+        quint32 *sigmaRow = m_sigmasStore.data() + (size_t) si * N;
+        for ( k = 0; k < N; ++k ) {
+            if ( ws.dist[k] == RAND_MAX ) {
+                continue;
+            }
+            distRow[k] = ws.dist[k];
+            sigmaRow[k] = (quint32) ws.sigma[k];
+        }
+    }
+    else {
+        for ( k = 0; k < N; ++k ) {
+            if ( ws.dist[k] == RAND_MAX ) {
+                continue;
+            }
+            source->setDistance( csr.name(k), ws.dist[k] );
+            if ( ws.sigma[k] > 0 ) {
+                source->setShortestPaths( csr.name(k), (int) ws.sigma[k] );
+            }
+        }
+    }
+
+    if ( ! dependenciesOnly && (int) m_geodesicRangeSize.size() == N ) {
+        // Influence range of s (reached enabled vertices) and its
+        // contribution to the influence domain of every reached vertex.
+        // Disabled sources reach nobody.
+        const bool rangeMax = ( (int) m_geodesicRangeMax.size() == N );
+        for ( k = 0; k < N; ++k ) {
+            if ( k == si || ws.dist[k] == RAND_MAX ) {
+                continue;
+            }
+            if ( csr.isEnabled(k) ) {
+                m_geodesicRangeSize[si]++;
+                m_geodesicRangeSum[si] += ws.dist[k];
             }
-            //calculate final SC variance
-            varianceSSC  /=  (qreal) N;
+            ws.domainSize[k]++;
+            ws.domainSum[k] += ws.dist[k];
+            // The largest distance from s, for the diameter
+            if ( rangeMax && ws.dist[k] > m_geodesicRangeMax[si] ) {
+                m_geodesicRangeMax[si] = ws.dist[k];
+            }
+        }
+    }
+
+    if ( ! computeCentralities ) {
+        return;
+    }
 
-            denomSPC = (  (N-2.0) ) / (2.0 );   //only for connected nets
-            if (N < 3 )
-                denomSPC = N-1.0;
-            //what if the net is disconnected (isolates exist) ?
-            groupSPC = nomSPC/denomSPC;
+    if ( ! dependenciesOnly ) {
 
-            denomSCC = ( ( N-1.0) * (N-2.0) ) / (2.0 * N -3.0);
-            if (N < 3 )
-                denomSCC = N-1.0;
+        source->setEccentricity( ws.eccentricity );
 
-            groupCC = nomSCC/denomSCC;	//Calculate group Closeness centrality
+        // Compute Power Centrality
+        // In = [ 1/(N-1) ] * ( Nd1 + Nd2 * 1/2 + ... + Ndi * 1/i )
+        // where
+        // Ndi (sizeOfNthOrderNeighborhood) is the number of nodes at distance i from this node.
+        // N is the sum Nd0 + Nd1 + Nd2 + ... + Ndi, that is the amount of nodes in the same component as the current node
 
-            //nomSBC*=2.0;
-            //            denomSBC =   (N-1.0) *  (N-1.0) * (N-2.0);
-            denomSBC =   (N-1.0) ;  // Wasserman&Faust - formula 5.14
-            groupSBC=nomSBC/denomSBC;		//Calculate group Betweenness centrality
+        sizeOfComponent = 1;
+        hfi = ws.sizeOfNthOrderNeighborhood.constBegin();
+        while (hfi != ws.sizeOfNthOrderNeighborhood.constEnd()) {
+            PC += ( 1.0 / hfi.key() ) * hfi.value();
+            sizeOfComponent += hfi.value();
+            ++hfi;
+        }
 
-            calculatedCentralities=true;
+        source->setPC( PC );
+        ws.sumPC += PC;
+        if ( sizeOfComponent != 1 )
+            SPC = ( 1.0/(sizeOfComponent-1.0) ) * PC;
+        else
+            SPC = 0;
 
-        }  // END if computeCentralities
+        source->setSPC( SPC );	//Set std PC
 
-    }  // END else (aka E!=0)
+        ws.sumSPC += SPC;   //add to sumSPC -- used later to compute mean and variance
 
+        // Compute sum of distances from s to every other vertex
+        for ( k = 0; k < N; ++k ) {
+            distances_sum_for_s += ws.dist[k];
+        }
 
+        ws.sumDistance += distances_sum_for_s;
 
-    calculatedDistances=true;
+        // Compute Closeness Centrality
+        if ( distances_sum_for_s != 0 && distances_sum_for_s < RAND_MAX)  {
+            // Connected actor:
+            // There is a path from this actor to all others
+            // Invert the sum of distances and set it as CC
+            CC=1.0/distances_sum_for_s;
+        }
+        else {
+            // Not connected actor. Cases:
+            // a) Isolated: The actor has no outbound links
+            // b) Disconnected graph: There is no path from this actor
+            // to some of the other actors, which means her distance to
+            // them is infinite
+            // For these two cases, set CC as zero.
+            CC=0;
+        }
+        source->setCC( CC );
 
-    qDebug() << "Graph::graphDistancesGeodesic()- FINISHED computing distances";
+        qCHotDebug(lcGraph)<< "***** PHASE 2 (CENTRALITIES): "
+                   "s" << csr.name(si) << "vpos" << si
+                << "PC" << PC << "CC" << CC
+                << "Back propagation of dependencies. Stack size" << ws.Stack.size();
+    }
 
+    // Compute Betweenness Centrality
+    // Visit all vertices in reverse order of their discovery to sum dependencies
+    while ( !ws.Stack.empty() ) {
+        w = ws.Stack.back();
+        ws.Stack.pop_back();
 
-    emit signalProgressBoxKill();
+        for ( it2 = ws.Ps[w].cbegin(); it2 != ws.Ps[w].cend(); ++it2 ) {
+            if ( ws.sigma[w] > 0 ) {
+                //delta[u]=delta[u]+(1+delta[w])*(sigma[u]/sigma[w]) ;
+                ws.delta[*it2] += ( 1.0 + ws.delta[w] ) * ( ws.sigma[*it2] / ws.sigma[w] );
+            }
+        }
 
+        if  (w!=si) {
+            ws.BC[w] += ws.delta[w];
+        }
+    }
 }
 
 
 
 
-
 /**
 *	Breadth-First Search (BFS) method for unweighted graphs (directed or not)
 
     INPUT:
-        a 'source' vertex with vpos s and a boolean computeCentralities.
-        (Implicitly, BFS uses the m_graph structure)
+        a 'source' vertex with vpos si, the worker workspace ws,
+        the adjacency snapshot csr and a boolean computeCentralities.
 
     OUTPUT:
-        For every vertex t: d(s, t) is set to the distance of each t from s
-        For every vertex t: s(s, t) is set to the number of shortest paths between s and t
+        For every vertex t: ws.dist[t] is set to the distance of each t from s
+        For every vertex t: ws.sigma[t] is set to the number of shortest paths between s and t
 
         Also, if computeCentralities is true then BFS does extra operations:
             a) For source vertex s:
-                it calculates CC(s) as the sum of its distances from every other vertex.
                 it calculates eccentricity(s) as the maximum distance from all other vertices.
                 it increases sizeOfNthOrderNeighborhood [ N ] by one, to store the number of nodes at distance n from source s
             b) For every vertex u:
                 it increases SC(u) by one, when it finds a new shor. path from s to t through u.
                 appends each neighbor y of u to the list , thus Ps stores all predecessors of y on all all shortest paths from s
-            c) Each vertex u popped from Q is pushed to a stack Stack
-
-*/ 
-void Graph::BFS(const int &s, const int &si,  const bool &computeCentralities,
-                const bool &dropIsolates){
-    Q_UNUSED(dropIsolates);
+            c) Each vertex u popped from Q is pushed to the workspace Stack
 
-    qDebug()<< "BFS:";
-    int u=0, ui=0 ,w=0, wi=0;
-    int dist_u=0, temp=0, dist_w=0;
-    int relation=0;
-    //int  weight=0;
-    bool edgeStatus=false;
-    H_edges::const_iterator it1;
+*/
+void Graph::BFS(const int &si,
+                GraphGeodesicWorkspace &ws,
+                const GraphCSR &csr,
+                const bool &computeCentralities){
 
+    int u=0, w=0, e=0;
+    qreal dist_u=0, dist_w=0;
+    size_t head=0;
+    const int *targets = csr.outTargets();
 
     //set distance of s from s equal to 0
-    m_graph[si]->setDistance(s,0);
+    ws.dist[si] = 0;
 
     //set sigma of s from s equal to 1
-    m_graph[si]->setShortestPaths(s,1);
+    ws.sigma[si] = 1;
 
-    //    qDebug("BFS: Construct a queue Q of integers and push source vertex s=%i to Q as initial vertex", s);
-    queue<int> Q;
+    ws.Q.push_back(si);
 
-    Q.push(s);
+    while ( head < ws.Q.size() ) {
 
-    qDebug()<< "BFS: LOOP: While Q not empty ";
-    while ( !Q.empty() ) {
+        u = ws.Q[head++];
 
-        u=Q.front(); Q.pop();
-        ui=vpos[u];
-        qDebug()<< "BFS: Dequeue: first element of Q is u"<<u<< "vpos"<< ui;
-
-        if ( ! m_graph [ ui ]->isEnabled() ) {
+        if ( ! csr.isEnabled(u) ) {
             continue ;
         }
 
         if (computeCentralities){
-            qDebug()<< "BFS: Compute centralities: Pushing u" << u
-                    << "to global Stack ";
-            Stack.push(u);
-        }
-        qDebug() << "BFS: LOOP over every edge (u,w) e E, that is all neighbors w of vertex u";
-        it1=m_graph [ ui ] ->m_outEdges.cbegin();
-        while ( it1!=m_graph [ ui ] -> m_outEdges.cend() ){
-            relation = it1.value().first;
-            if ( relation != relationCurrent() )  {
-                ++it1;
-                continue;
-            }
-            edgeStatus=it1.value().second.second;
-            if ( edgeStatus != true)   {
-                ++it1;
-                continue;
-            }
-            w = it1.key();
-            //  weight = it1.value().second.first;
-            wi=vpos[ w ];
-            qDebug("BFS: u=%i is connected with node w=%i of vpos wi=%i. ", u, w, wi);
+            ws.Stack.push_back(u);
+        }
 
-            qDebug("BFS: Start path discovery");
+        dist_u = ws.dist[u];
 
-            //if distance (s,w) is infinite, w found for the first time.
-            if ( m_graph [ si ]->distance( w ) == RAND_MAX ) {
+        // LOOP over every edge (u,w) e E, that is all neighbors w of vertex u
+        for ( e = csr.outBegin(u); e < csr.outEnd(u); ++e ) {
 
-                qDebug("BFS: First time visiting w=%i. Enqueuing w to the end of Q", w);
+            w = targets[e];
 
-                Q.push(w);
+            //if distance (s,w) is infinite, w found for the first time.
+            if ( ws.dist[w] == RAND_MAX ) {
 
-                qDebug()<<"BFS: First check if distance(s,u) = infinite and set it to zero";
+                ws.Q.push_back(w);
 
-                dist_u=m_graph [ si ]->distance( u );
                 dist_w = dist_u + 1;
+                ws.dist[w] = dist_w;
 
-                qDebug() << "BFS: Setting dist_w = d ( s" << s << ", w"<<w
-                         << ") equal to dist_u=d(s,u) plus 1. New dist_w" << dist_w ;
-                ;
-                m_graph[si]->setDistance(w,dist_w);
-
-
-                m_graphSumDistance += dist_w;
-                m_graphGeodesicsCount++;
-
-
-                qDebug()<< "== BFS  - d("
-                        << s <<"," << w
-                        <<")=" <<
-                          m_graph[si]->distance(w) ;
+                ws.sumDistance += dist_w;
+                ws.geodesicsCount++;
 
                 if (computeCentralities){
-                    qDebug()<<"BFS: Calculate PC: store the number of nodes at distance "
-                           << dist_w << "from s";
-
-                    sizeOfNthOrderNeighborhood.insert(
-                                dist_w,
-                                sizeOfNthOrderNeighborhood.value(dist_w,0)+1
-                                );
-                    qDebug()<<"BFS: Calculate CC: the sum of distances (will invert it l8r)";
-                    m_graph [si]->setCC (m_graph [si]->CC() + dist_w);
-
-                    qDebug()<<"BFS: Calculate Eccentricity: the maximum distance ";
-                    if (m_graph [si]->eccentricity() < dist_w )
-                        m_graph [si]->setEccentricity(dist_w);
+                    // PC: store the number of nodes at distance dist_w from s
+                    ws.sizeOfNthOrderNeighborhood[dist_w]++;
 
+                    // Eccentricity: the maximum distance
+                    if ( ws.eccentricity < dist_w )
+                        ws.eccentricity = dist_w;
                 }
-                //                qDebug("BFS: Checking m_graphDiameter");
-                if ( dist_w > m_graphDiameter){
-                    m_graphDiameter=dist_w;
-                    //                    qDebug() << "BFS: new m_graphDiameter = " <<  m_graphDiameter ;
+
+                if ( dist_w > ws.diameter){
+                    ws.diameter = dist_w;
                 }
             }
 
-            qDebug()<< "BFS: Start path counting";
-
             //Is edge (u,w) on a shortest path from s to w via u?
 
-            if ( m_graph[si]->distance(w) == m_graph[si]->distance(u) + 1) {
+            if ( ws.dist[w] == dist_u + 1 ) {
 
-                temp=m_graph[si]->shortestPaths(w)+m_graph[si]->shortestPaths(u);
-
-                qDebug()<< "BFS: Found a NEW SHORTEST PATH from s" << s
-                        << "to w"<< w << "via u"<< u
-                        << "Setting Sigma(s, w)"<< temp;
-                if (s!=w) {
-                    m_graph[si]->setShortestPaths(w, temp);
+                if ( w != si ) {
+                    ws.sigma[w] += ws.sigma[u];
                 }
                 if (computeCentralities){
-                    qDebug()<< "BFS/SC: Computing centralities: Computing SC ";
-                    if ( s!=w && s != u && u!=w ) {
-                        qDebug() << "BFS: setSC of u="<<u<<" to "<<m_graph[ui]->SC()+1;
-                        m_graph[ui]->setSC( m_graph[ui]->SC()+1 );
-                    }
-                    else {
-                        //                        qDebug() << "BFS/SC: skipping setSC of u, because s="
-                        //                                 <<s<<" w="<< w << " u="<< u;
+                    if ( si!=w && si != u && u!=w ) {
+                        ws.SC[u] += 1;
                     }
-                    //                    qDebug() << "BFS/SC: SC is " << m_graph[u]->SC();
-                    qDebug() << "BFS: appending u"<< u << " to list Ps[w=" << w
-                             << "] with the predecessors of w on all shortest paths from s ";
-                    m_graph[wi]->appendToPs(u);
+                    ws.Ps[w].push_back(u);
                 }
             }
-            ++it1;
         }
 
     }
@@ -5756,260 +8929,269 @@ void Graph::BFS(const int &s, const int &si,  const bool &computeCentralities,
 
 /**
 *	Dijkstra's algorithm for solving the SSSP problem in weighted graphs (directed or not).
-*   It uses a min-priority queue prQ to provide constant time lookup of the minimum
-*   distance. The priority queue is implemented with std::priority_queue
+*   It uses the indexed min-heap of the workspace, ws.heap, with decrease-key, thus
+*   every vertex is popped (settled) exactly once, in non-decreasing order of distance.
+*   Edges with non-positive cost are ignored.
 
     INPUT:
-        a 'source' vertex with vpos s and a boolean computeCentralities.
-        (Implicitly, the algorithm uses the m_graph structure)
+        a 'source' vertex with vpos si, the worker workspace ws,
+        the adjacency snapshot csr and a boolean computeCentralities.
 
     OUTPUT:
-        For every vertex t: d(s, t) is set to the distance of each t from s
-        For every vertex t: s(s, t) is set to the number of shortest paths between s and t
+        For every vertex t: ws.dist[t] is set to the distance of each t from s
+        For every vertex t: ws.sigma[t] is set to the number of shortest paths between s and t
 
         Also, if computeCentralities is true then it does extra operations:
             a) For source vertex s:
-                it calculates CC(s) as the sum of its distances from every other vertex.
                 it calculates eccentricity(s) as the maximum distance from all other vertices.
                 it increases sizeOfNthOrderNeighborhood [ N ] by one, to store the number of nodes at distance n from source s
             b) For every vertex u:
-                it increases SC(u) by one, when it finds a new shor. path from s to t through u.
-                appends each neighbor y of u to the list Ps, thus Ps stores all predecessors of y on all all shortest paths from s
-            c) Each vertex u popped from prQ is pushed to a stack Stack
+                it increases SC(u) by one for every shortest path edge (u,t) with u,t != s,
+                when t is settled.
+                Ps[t] stores all predecessors of t on all shortest paths from s
+            c) Each vertex u popped from the heap is pushed to the workspace Stack
 
 */
-void Graph::dijkstra(const int &s, const int &si,
+void Graph::dijkstra(const int &si,
+                     GraphGeodesicWorkspace &ws,
+                     const GraphCSR &csr,
                      const bool &computeCentralities,
-                     const bool &inverseWeights,
-                     const bool &dropIsolates){
-
-    Q_UNUSED(dropIsolates);
+                     const bool &inverseWeights){
 
-    int u=0,ui=0, w=0, wi=0, v=0, temp=0;
-    int relation=0;
+    int u=0, w=0, e=0;
     qreal  weight=0, dist_u=0,  dist_w=0, old_dist_w=0;
-    bool edgeStatus=false;
-    H_edges::const_iterator it1;
-    VList::const_iterator it;
-
-    qDebug() << "### dijkstra: Construct a priority queue prQ of all vertices-distances";
-
-    // TODO: Check prQ functionality in weighted graphs, where edge weight denotes value (not cost)
-    priority_queue<GraphDistance, vector<GraphDistance>, GraphDistancesCompare> prQ;
+    const int *targets = csr.outTargets();
+    const qreal *weights = csr.outWeights();
+    vector<int>::const_iterator it;
 
     //set d( s, s ) = 0
-    m_graph[si]->setDistance(s,0);
+    ws.dist[si] = 0;
 
     //set sp ( s , s ) = 1
-    m_graph[si]->setShortestPaths(s,1);
+    ws.sigma[si] = 1;
 
+    ws.heap.push(si, 0);
 
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
-        v=vpos[ (*it)->name() ];
-        if (v != s ){
-            // NOTE: d(i,j) init to RAND_MAX already done in graphDistancesGeodesic
-            //            qDebug() << " push " << v << " to prQ with infinite distance from s";
-            //            prQ.push(GraphDistance(v,RAND_MAX));
-
-            //TODO // Previous node in optimal path from source
-            //    previous[v]  := undefined
-        }
-    }
-    qDebug() << "### dijkstra: push s" << s << "to prQ with 0 distance from s";
+    while ( !ws.heap.isEmpty() ) {
 
-    //crucial: without it the priority prQ would pop arbitrary node at first loop
-    prQ.push(GraphDistance(s,0));
+        u = ws.heap.pop();
 
-    qDebug()<<"### dijkstra: prQ size "<< prQ.size();
+        dist_u = ws.dist[u];
 
+        // u is settled: its distance and shortest paths are final
+        if ( u != si ) {
 
-    qDebug() << "### dijkstra: LOOP: While prQ not empty ";
-    while ( !prQ.empty() ) {
-        u=prQ.top().target;
-        ui=vpos[u];
+            ws.sumDistance += dist_u;
+            ws.geodesicsCount++;
 
-        qDebug()<< "    *** dijkstra: take u"<< u << "vpos" << ui
-                << " from prQ. It has minimum distance from s =" << s;
-        prQ.pop();
+            if ( dist_u > ws.diameter){
+                ws.diameter = dist_u;
+            }
 
-        if ( ! m_graph [ ui ]->isEnabled() )
-            continue ;
+            if (computeCentralities){
 
-        if (computeCentralities){
+                // PC: store the number of nodes at distance dist_u from s
+                ws.sizeOfNthOrderNeighborhood[dist_u]++;
 
-            qDebug()<< "    *** dijkstra: Compute centralities: pushing u ="
-                    << u
-                    << " to global Stack ";
+                // EC: max distance
+                if ( ws.eccentricity < dist_u ) {
+                    ws.eccentricity = dist_u;
+                }
 
-            Stack.push(u);
+                for ( it = ws.Ps[u].cbegin(); it != ws.Ps[u].cend(); ++it ) {
+                    if ( *it != si ) {
+                        ws.SC[*it] += 1;
+                    }
+                }
+            }
         }
 
-        qDebug() << "    --- dijkstra: LOOP over every edge ("<< u <<", w ) e E... ";
-
-        it1=m_graph [ ui ] ->m_outEdges.cbegin();
-
-        while ( it1!=m_graph [ ui ] -> m_outEdges.cend() ) {
+        if ( ! csr.isEnabled(u) )
+            continue ;
 
-            relation = it1.value().first;
-            if ( relation != relationCurrent() )  {
-                ++it1;
-                continue;
-            }
-            edgeStatus=it1.value().second.second;
-            if ( edgeStatus != true)   {
-                ++it1;
-                continue;
-            }
+        if (computeCentralities){
+            ws.Stack.push_back(u);
+        }
 
-            w = it1.key();
-            wi=vpos[ w ];
+        for ( e = csr.outBegin(u); e < csr.outEnd(u); ++e ) {
 
-            weight = it1.value().second.first;
+            w = targets[e];
 
-            qDebug()<<"    --- dijkstra: edge (u, w) = ("<< u << ","<< w << ") =" << weight;
+            weight = weights[e];
 
             if (inverseWeights) { //only invert if user asked to do so
                 weight = 1.0 / weight;
-                qDebug () << "    --- dijkstra: inverting weight to " << weight;
             }
 
-            qDebug() <<"    --- dijkstra: Start path discovery";
-
-            dist_u=m_graph [ si ]->distance( u );
-
-            if (dist_u == RAND_MAX || dist_u < 0) {
-                dist_w = RAND_MAX;
-                qDebug() << "    --- dijkstra: dist_w = RAND_MAX " << RAND_MAX;
-
-            }
-            else {
-                dist_w = dist_u + weight;
-                qDebug() << "    --- dijkstra: dist_w = dist_u + weight = "
-                         << dist_u << "+" << weight <<  "=" <<dist_w ;
+            if ( ! ( weight > 0 ) ) {
+                continue;
             }
 
-            old_dist_w = m_graph [ si ]->distance( w );
+            dist_w = dist_u + weight;
 
-            qDebug() << "    --- dijkstra: RELAXATION: check if dist_w =" << dist_w
-                     <<  "  shorter than current d(s=" << s <<",w="<<w <<")="
-                      << old_dist_w;
+            old_dist_w = ws.dist[w];
 
-            if ( ( dist_w == old_dist_w ) &&  dist_w < RAND_MAX ) {
+            // RELAXATION: check if dist_w is shorter than current d(s,w)
 
-                qDebug() <<"    --- dijkstra: dist_w : " << dist_w
-                        <<  " ==  current d(s,w) : " << old_dist_w ;
+            if ( dist_w == old_dist_w &&  dist_w < RAND_MAX ) {
 
-                temp = m_graph[si]->shortestPaths(w) + m_graph[si]->shortestPaths(u);
-                // WRONG! We do not know for sure that we are in a shortest path!!!
-                qDebug() <<"    --- dijkstra: Found ANOTHER SP from s =" << s
-                        << " to w=" << w << " via u="<< u
-                        << " - Setting Sigma(s, w) = "<< temp;
-
-                if (s!=w) {
-                    m_graph[si]->setShortestPaths(w, temp);
-                }
+                // Another shortest path to w, via u
+                ws.sigma[w] += ws.sigma[u];
 
                 if (computeCentralities){
-
-                    if ( s!=w && s != u && u!=w ) {
-
-                        qDebug() << "    --- dijkstra: Compute Centralities: "
-                                    "setSC of u" << u
-                                 <<"to" << m_graph[ui]->SC()+1;
-
-                        m_graph[ui]->setSC(m_graph[ui]->SC()+1);
-                    }
-                    else {
-                        qDebug() << "    --- dijkstra: Compute Centralities: "
-                                    "Skipping setSC of u, because s="
-                                 <<s<<" w="<< w << " u="<< u;
-                    }
-                    qDebug() << "    --- dijkstra: Compute Centralities: "
-                                "SC is " << m_graph[ui]->SC();
-
-                    qDebug() << "    --- dijkstra: Compute Centralities: "
-                                "Appending u="<< u << " to list Ps[w =" << w
-                             << "] with the predecessors of w on all shortest paths from s ";
-                    m_graph[wi]->appendToPs(u);
+                    ws.Ps[w].push_back(u);
                 }
             }
 
-            else if (dist_w > 0 && dist_w < old_dist_w  ) {
-
-                qDebug() <<"    --- dijkstra: dist_w " << dist_w
-                        <<  " <  current d(s,w) =" << old_dist_w
-                         << " Pushing w" << w<< "to prQ with distance"<< dist_w << "from s"<<s;
+            else if ( dist_w < old_dist_w  ) {
 
-                prQ.push(GraphDistance(w,dist_w));
-                // FIXME: w might have been already visited?
-                // If so, we might use QMap<int> which is sorted (minimum)
-                // and also provides contain()
-                m_graph[si]->setDistance(w,dist_w);
+                // A shorter path to w, via u: w is not settled yet
+                ws.dist[w] = dist_w;
+                ws.sigma[w] = ws.sigma[u];
+                ws.heap.push(w, dist_w);
 
-                m_graphGeodesicsCount++;
-
-                qDebug() << "    --- dijkstra: "
-                            "Set d ( s=" << s << ", w="<< w
-                         << " ) = "<< dist_w << "="<< m_graph[si]->distance(w);
-
-                if ( dist_w > m_graphDiameter){
-                    m_graphDiameter=dist_w;
-                    qDebug() << "    --- dijkstra: "
-                                "New graph diameter =" << m_graphDiameter ;
+                if (computeCentralities){
+                    ws.Ps[w].clear();
+                    ws.Ps[w].push_back(u);
                 }
 
-                if (s!=w) {
-                    qDebug() << "    --- dijkstra: "
-                              "Found NEW shortest path from s =" << s
-                             << " to w =" << w << " via u ="<< u
-                             << " - Setting Sigma(s, w) = 1 ";
-                    m_graph[si]->setShortestPaths(w, 1);
-                }
+            }
 
+        } // END loop for every outEdge of u
 
-                if (computeCentralities){
+    } // END loop while heap not empty
 
-                    sizeOfNthOrderNeighborhood.insert(
-                                dist_w,
-                                sizeOfNthOrderNeighborhood.value(dist_w,0)+1
-                                );
-
-                    qDebug() << "    --- dijkstra: Compute Centralities: "
-                              "For PC: sizeOfNthOrderNeighborhood: number of nodes at distance "
-                           << dist_w << "from s is "
-                           <<  sizeOfNthOrderNeighborhood.value(dist_w,0);
-
-                    if (m_graph [si]->eccentricity() < dist_w ) {
-                        m_graph [si]->setEccentricity(dist_w);
-                        qDebug() << "    --- dijkstra: Compute Centralities: "
-                                  "For EC: max distance ="
-                                  <<  m_graph [si]->eccentricity();
-                    }
+}
 
-                    qDebug() << "    --- dijkstra: Compute Centralities: "
-                                "Appending u="<< u << " to list Ps[w =" << w
-                             << "] with the predecessors of w on all shortest paths from s ";
-                    m_graph[wi]->appendToPs(u);
 
-                }
 
+/**
+ * @brief Parallel delta-stepping (Meyer & Sanders, 2003) for the SSSP problem
+ * of the source vertex at index si in weighted graphs.
+ * Vertices are kept in buckets of width delta, the mean edge cost. The
+ * vertices of the first non-empty bucket relax their light edges (cost <= delta)
+ * until the bucket stays empty, and then their heavy edges, once.
+ * The relaxation requests of large buckets are generated in parallel, one
+ * list per worker, and applied serially, so dist is never written concurrently.
+ * It computes distances only (no shortest path counts), for single-source
+ * queries on large, sparse and road-like networks.
+ * Edges with non-positive cost are ignored.
+ * @param si the index (vpos) of the source vertex
+ * @param dist returns the distance from si to every vertex index, RAND_MAX if unreachable
+ * @param csr the adjacency snapshot to traverse
+ * @param inverseWeights
+ */
+void Graph::deltaStepping(const int &si,
+                          vector<qreal> &dist,
+                          const GraphCSR &csr,
+                          const bool &inverseWeights) {
+
+    // Buckets smaller than this are relaxed by the calling thread
+    const int parallelGrain = 1024;
+
+    const int N = csr.vertices();
+    const int *targets = csr.outTargets();
+    const qreal *weights = csr.outWeights();
+    int e = 0, count = 0;
+    qreal cost = 0, sum = 0;
+
+    auto edgeCost = [&](const int &edge) {
+        return inverseWeights ? 1.0 / weights[edge] : weights[edge];
+    };
 
+    dist.assign(N, RAND_MAX);
+    dist[si] = 0;
 
+    for ( e = 0; e < csr.edges(); ++e ) {
+        cost = edgeCost(e);
+        if ( cost > 0 && cost < RAND_MAX ) {
+            sum += cost;
+            count++;
+        }
+    }
+    if ( count == 0 ) {
+        return;
+    }
+    const qreal delta = sum / count;
+
+    qDebug() << "Graph::deltaStepping() - source" << si << "delta" << delta;
+
+    map< quint64, vector<int> > buckets;
+    map< quint64, vector<int> >::iterator bit;
+    vector<qreal> relaxedAt(N, -1);   // last distance each vertex was relaxed at
+    vector<int> frontier, settled;
+    const int threads = graphWorkerThreads( N / parallelGrain );
+    vector< vector< pair<int, qreal> > > requests(threads);
+
+    // Finds the requests (w, d) of the light or heavy edges of the vertices
+    auto findRequests = [&](const vector<int> &vertices, const bool &light) {
+        auto work = [&](const int &t, const int &chunk) {
+            const int first = chunk * parallelGrain;
+            const int last = qMin( first + parallelGrain, (int) vertices.size() );
+            int v = 0, edge = 0;
+            qreal c = 0, d = 0;
+            for ( int k = first; k < last; ++k ) {
+                v = vertices[k];
+                for ( edge = csr.outBegin(v); edge < csr.outEnd(v); ++edge ) {
+                    c = edgeCost(edge);
+                    if ( ! ( c > 0 ) || light != ( c <= delta ) ) {
+                        continue;
+                    }
+                    d = dist[v] + c;
+                    if ( d < dist[ targets[edge] ] ) {
+                        requests[t].push_back( make_pair( targets[edge], d ) );
+                    }
+                }
             }
-            else {
-                qDebug() << "    --- dijkstra: "
-                            "NOT a new SP";
+        };
+        const int chunks = ( (int) vertices.size() + parallelGrain - 1 ) / parallelGrain;
+        if ( chunks > 1 && threads > 1 ) {
+            graphParallelFor( chunks, threads, work, false );
+        }
+        else {
+            for ( int chunk = 0; chunk < chunks; ++chunk ) {
+                work( 0, chunk );
+            }
+        }
+        // Apply the requests
+        for ( int t = 0; t < threads; ++t ) {
+            for ( const pair<int, qreal> &request : requests[t] ) {
+                if ( request.second < dist[request.first] ) {
+                    dist[request.first] = request.second;
+                    buckets[ (quint64) ( request.second / delta ) ].push_back( request.first );
+                }
             }
+            requests[t].clear();
+        }
+    };
 
-            ++it1;
+    buckets[0].push_back(si);
 
-        } // END loop for every outEdge of u
+    while ( ! buckets.empty() ) {
 
-        qDebug() << "    --- dijkstra: LOOP END over every edge ("<< u <<", w ) e E... ";
+        const quint64 b = buckets.begin()->first;
+        settled.clear();
 
-    } // END loop while prQ not empty
+        while ( ( bit = buckets.find(b) ) != buckets.end() ) {
+            frontier.clear();
+            for ( const int &v : bit->second ) {
+                // skip stale and duplicate entries
+                if ( relaxedAt[v] == dist[v] || (quint64) ( dist[v] / delta ) != b ) {
+                    continue;
+                }
+                relaxedAt[v] = dist[v];
+                if ( ! csr.isEnabled(v) ) {
+                    continue;
+                }
+                frontier.push_back(v);
+            }
+            buckets.erase(bit);
+            settled.insert( settled.end(), frontier.begin(), frontier.end() );
+            findRequests( frontier, true );
+        }
 
-    qDebug() << "### dijkstra: LOOP END. prQ is empty - Returning.";
+        findRequests( settled, false );
+    }
 }
 
 
@@ -6045,24 +9227,16 @@ void Graph::minmax(qreal C, GraphVertex *v, qreal &max, qreal &min, int &maxNode
 
 /**
  * @brief Checks if score C is a new prominence class
- * If yes, it stores that number in a QHash<QString,int> type where the score is the key.
+ * If yes, it opens a new class for it in the numeric frequency table.
  * If no, increases the frequency of this prominence score by 1
  * Called from graphDistancesGeodesic()
  * @param C
  * @param discreteClasses
  * @param classes
  */
-void Graph::resolveClasses(qreal C, H_StrToInt &discreteClasses, int &classes){
-    int frq = 0;
-    H_StrToInt::iterator it2;
-    it2 = discreteClasses.find(QString::number(C));    //Amort. O(1) complexity
-    if (it2 == discreteClasses.end() )	{
+void Graph::resolveClasses(qreal C, GraphDistribution &discreteClasses, int &classes){
+    if ( discreteClasses.add(C) ) {
         classes++;
-        discreteClasses.insert(QString::number(C), 1);
-    }
-    else {
-        frq = it2.value() ;
-        discreteClasses.insert(QString::number(C), frq + 1);
     }
 }
 
@@ -6075,18 +9249,10 @@ void Graph::resolveClasses(qreal C, H_StrToInt &discreteClasses, int &classes){
  * @param classes
  * @param vertex
  */
-void Graph::resolveClasses(qreal C, H_StrToInt &discreteClasses, int &classes, int vertex){
-    int frq = 0;
-    H_StrToInt::iterator it2;
+void Graph::resolveClasses(qreal C, GraphDistribution &discreteClasses, int &classes, int vertex){
     Q_UNUSED(vertex);
-    it2 = discreteClasses.find(QString::number(C));    //Amort. O(1) complexity
-    if (it2 == discreteClasses.end() )	{
+    if ( discreteClasses.add(C) ) {
         classes++;
-        discreteClasses.insert(QString::number(C), 1);
-    }
-    else {
-        frq = it2.value() ;
-        discreteClasses.insert(QString::number(C), frq + 1);
     }
 }
 
@@ -6108,6 +9274,9 @@ void Graph::writeMatrixDistancesPlainText (const QString &fn,
                                            const bool &considerWeights,
                                            const bool &inverseWeights,
                                            const bool &dropIsolates) {
+
+    GraphTraceScope trace("Graph::writeMatrixDistancesPlainText");
+    trace.setInput( vertices(), edgesEnabled() );
     qDebug ("Graph::writeMatrixDistancesPlainText()");
 
     graphMatrixDistanceGeodesicCreate(considerWeights, inverseWeights, dropIsolates);
@@ -6146,6 +9315,9 @@ void Graph::writeMatrixShortestPathsPlainText(const QString &fn,
                                               const bool &considerWeights,
                                               const bool &inverseWeights) {
 
+    GraphTraceScope trace("Graph::writeMatrixShortestPathsPlainText");
+    trace.setInput( vertices(), edgesEnabled() );
+
     qDebug()<< "Graph::writeMatrixShortestPathsPlainText()";
 
     graphMatrixShortestPathsCreate( considerWeights, inverseWeights, false);
@@ -6184,6 +9356,9 @@ void Graph::writeEccentricity(const QString fileName, const bool considerWeights
                               const bool inverseWeights, const bool dropIsolates)
 {
 
+    GraphTraceScope trace("Graph::writeEccentricity");
+    trace.setInput( vertices(), edgesEnabled() );
+
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -6199,9 +9374,19 @@ void Graph::writeEccentricity(const QString fileName, const bool considerWeights
     outText.setCodec("UTF-8");
 
     if ( !calculatedCentralities  ) {
-        graphDistancesGeodesic(true, considerWeights,
-                               inverseWeights, dropIsolates);
+        // Unweighted symmetric graphs do not need the all-pairs computation
+        if ( ( ! considerWeights || ! graphIsWeighted() ) && graphIsSymmetric() ) {
+            graphEccentricitiesBounded();
+        }
+        else {
+            graphDistancesGeodesic(true, considerWeights,
+                                   inverseWeights, dropIsolates);
+        }
+    }
 
+    if ( graphCancelled() ) {
+        file.remove();
+        return;
     }
 
     int progressCounter=0;
@@ -6212,7 +9397,7 @@ void Graph::writeEccentricity(const QString fileName, const bool considerWeights
     QString pMsg = tr("Writing Eccentricity scores to file. \nPlease wait...");
     emit statusMessage ( pMsg );
 
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     outText << htmlHead;
 
@@ -6272,7 +9457,7 @@ void Graph::writeEccentricity(const QString fileName, const bool considerWeights
     VList::const_iterator it;
     for (it= m_graph.cbegin(); it!= m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
         rowCount++;
         eccentr = (*it)->eccentricity();
         qDebug() << "Graph::writeEccentricity() - actor "
@@ -6356,7 +9541,7 @@ void Graph::writeEccentricity(const QString fileName, const bool considerWeights
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 }
 
 
@@ -6365,16 +9550,31 @@ void Graph::writeEccentricity(const QString fileName, const bool considerWeights
  * @brief Computes the Information centrality of each vertex - diagonal included
  *  Note that there is no known generalization of Stephenson&Zelen's theory
  *  for information centrality to directional data
+ *
+ * IC(i) = 1 / ( C(i,i) + (T - 2R) / n ), where C is the inverse of the matrix
+ * B = L + J, L the Laplacian of the symmetrized adjacency and J the all-ones
+ * matrix, T the trace of C and R the sum of any row of C.
+ * Since B * 1 = n * 1, every row of C sums to R = 1/n. The diagonal of C is
+ * found column by column, solving B x = e_i with the Jacobi preconditioned
+ * conjugate gradient method, where B is applied as L x + sum(x) without ever
+ * forming it. The solves are independent and run on a pool of workers.
+ * Memory is O(n + m) and the full inverse is never materialized.
  * @param considerWeights
  * @param inverseWeights
  */
 void Graph::centralityInformation(const bool considerWeights,
                                   const bool inverseWeights){
 
-    qDebug()<< "Graph::centralityInformation()";
+    GraphTraceScope trace("Graph::centralityInformation");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("considerWeights=%1 inverseWeights=%2")
+                    .arg(considerWeights).arg(inverseWeights) );
 
-    if ( calculatedIC ) {
-        qDebug()<< "Graph::centralityInformation() - already computed. Return.";
+    qCHotDebug(lcGraph)<< "Graph::centralityInformation()";
+
+    const int cacheParameters = GraphResultCache::parameters(considerWeights, inverseWeights, true);
+    if ( resultCacheRestore(IndexType::IC, cacheParameters) ) {
+        qCHotDebug(lcGraph)<< "Graph::centralityInformation() - already computed. Return.";
         return;
     }
 
@@ -6388,67 +9588,163 @@ void Graph::centralityInformation(const bool considerWeights,
 
     VList::const_iterator it;
 
-    int i=0, j=0;
+    int i=0, k=0, e=0;
 
-    qreal m_weight=0, weightSum=1, diagonalEntriesSum=0, rowSum=0;
+    qreal diagonalEntriesSum=0, rowSum=0;
     qreal IC=0, SIC=0;
     /* Note: isolated nodes must be dropped from the AM
         Otherwise, the SIGMA matrix might be singular, therefore non-invertible. */
     bool dropIsolates=true;
-    bool symmetrize=true;
     int n=vertices(dropIsolates,false,true);
 
-    graphMatrixAdjacencyCreate(dropIsolates, considerWeights, inverseWeights, symmetrize);
-
     QString pMsg = tr("Computing Information Centralities. \nPlease wait...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(n,pMsg);
+    graphProgressCreate(n,pMsg);
+
+    // Participating vertices: enabled and not isolated
+    const GraphCSR &csr = graphCSR();
+    const int V = csr.vertices();
+    QVector<int> local(V, -1), global;
+    for (it=m_graph.cbegin(), i=0; it!=m_graph.cend(); ++it, ++i) {
+        if ( ! (*it)->isEnabled() || (*it)->isIsolated() ) {
+            continue;
+        }
+        local[i] = global.size();
+        global << i;
+    }
+    n = global.size();
 
-    WM.resize( n, n );
-    invM.resize(n, n);
+    // The weight of arc i -> j, as in the adjacency matrix
+    auto arcWeight = [&](const int &from, const int &to) {
+        qreal w = csr.edgeWeight(from, to);
+        if ( w == 0 ) {
+            return (qreal) 0;
+        }
+        if ( !considerWeights ) {
+            return (qreal) 1;
+        }
+        return ( inverseWeights ) ? 1.0 / w : w;
+    };
 
-    for (i=0; i<n; i++){
-        weightSum = 1;
-        for (j=0; j<n; j++){
-            if ( i == j )
+    // Symmetrized Laplacian rows, without the diagonal. As in the symmetrized
+    // adjacency matrix, the tie between a and b (a before b) takes the weight
+    // of b -> a if it exists, otherwise the weight of a -> b.
+    QVector<int> offsets(n+1, 0), targets;
+    vector<qreal> weights, diagonal(n, 0);
+    QVector<int> row;
+    for (k = 0; k < n; ++k) {
+        i = global[k];
+        offsets[k] = targets.size();
+        row.clear();
+        for (e = csr.outBegin(i); e < csr.outEnd(i); ++e) {
+            row << csr.outTarget(e);
+        }
+        for (e = csr.inBegin(i); e < csr.inEnd(i); ++e) {
+            row << csr.inSource(e);
+        }
+        std::sort(row.begin(), row.end());
+        for (int r = 0; r < row.size(); ++r) {
+            const int j = row[r];
+            if ( j == i || local[j] < 0 || ( r > 0 && row[r-1] == j ) ) {
                 continue;
-            m_weight = AM.item(i,j);
-            weightSum += m_weight; //sum of weights for all edges incident to i
-            WM.setItem(i,j,1-m_weight);
+            }
+            const int lo = qMin(i, j), hi = qMax(i, j);
+            qreal w = arcWeight(hi, lo);
+            if ( w == 0 ) {
+                w = arcWeight(lo, hi);
+            }
+            targets << local[j];
+            weights.push_back(w);
+            diagonal[k] += w;
         }
-        WM.setItem(i,i,weightSum);
     }
+    offsets[n] = targets.size();
 
-    emit signalProgressBoxUpdate(n/3);
-    emit statusMessage ( tr("Computing inverse adjacency matrix. Please wait...") );
+    emit statusMessage ( tr("Computing the diagonal of the inverse matrix. Please wait...") );
 
-    invM.inverse(WM);
+    const qreal tolerance = 1e-10;
+    const int maxIterations = qMax( 1000, n );
+    const int threads = graphWorkerThreads(n);
+    vector<qreal> inverseDiagonal(n, 0);
+    vector< vector<qreal> > buffers(threads);
 
-    emit statusMessage ( tr("Computing IC scores. Please wait...") );
+    graphParallelFor( n, threads, [&](const int &t, const int &col) {
+        vector<qreal> &buf = buffers[t];
+        if ( buf.empty() ) {
+            buf.assign( 5 * (size_t) n, 0 );
+        }
+        qreal *x = buf.data(), *r = x + n, *z = r + n, *p = z + n, *q = p + n;
+        qreal rz = 0, rzNext = 0, pq = 0, alpha = 0, beta = 0, rr = 0, sum = 0;
+        int a = 0, c = 0;
+
+        // x = 0, r = e_col, z = M^-1 r, p = z
+        for (a = 0; a < n; ++a) {
+            x[a] = 0;
+            r[a] = ( a == col ) ? 1 : 0;
+            z[a] = r[a] / ( diagonal[a] + 1 );
+            p[a] = z[a];
+        }
+        rz = z[col];
+
+        for (int iter = 0; iter < maxIterations; ++iter) {
+            // q = B p = L p + sum(p)
+            sum = 0;
+            for (a = 0; a < n; ++a) {
+                sum += p[a];
+            }
+            pq = 0;
+            for (a = 0; a < n; ++a) {
+                qreal v = diagonal[a] * p[a] + sum;
+                for (c = offsets[a]; c < offsets[a+1]; ++c) {
+                    v -= weights[c] * p[ targets[c] ];
+                }
+                q[a] = v;
+                pq += p[a] * v;
+            }
+            if ( pq == 0 ) {
+                break;
+            }
+            alpha = rz / pq;
+            rr = 0;
+            for (a = 0; a < n; ++a) {
+                x[a] += alpha * p[a];
+                r[a] -= alpha * q[a];
+                rr += r[a] * r[a];
+            }
+            if ( rr < tolerance * tolerance ) {
+                break;
+            }
+            rzNext = 0;
+            for (a = 0; a < n; ++a) {
+                z[a] = r[a] / ( diagonal[a] + 1 );
+                rzNext += r[a] * z[a];
+            }
+            beta = rzNext / rz;
+            rz = rzNext;
+            for (a = 0; a < n; ++a) {
+                p[a] = z[a] + beta * p[a];
+            }
+        }
+        inverseDiagonal[col] = x[col];
+    } );
 
-    emit signalProgressBoxUpdate(2*n/3);
+    emit statusMessage ( tr("Computing IC scores. Please wait...") );
 
     diagonalEntriesSum = 0;
-    rowSum = 0;
-    for (j=0; j<n; j++){
-        rowSum += invM.item(0,j);
+    rowSum = ( n > 0 ) ? 1.0 / n : 0;
+    for (k=0; k<n; k++){
+        diagonalEntriesSum  += inverseDiagonal[k];  // calculate the matrix trace
     }
-    for (i=0; i<n; i++){
-        diagonalEntriesSum  += invM.item(i,i);  // calculate the matrix trace
-    }
-
 
-    i=0;
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        if ( (*it)->isIsolated() ) {
+    for (it=m_graph.cbegin(), i=0; it!=m_graph.cend(); ++it, ++i){
+        if ( local[i] < 0 ) {
             (*it) -> setIC ( 0 );
             continue;
         }
-        IC= 1.0 / ( invM.item(i,i) + (diagonalEntriesSum - 2.0 * rowSum) / n );
+        IC= 1.0 / ( inverseDiagonal[ local[i] ] + (diagonalEntriesSum - 2.0 * rowSum) / n );
 
         (*it) -> setIC ( IC );
         t_sumIC += IC;
-        i++;
     }
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
         IC = (*it)->IC();
@@ -6471,12 +9767,11 @@ void Graph::centralityInformation(const bool considerWeights,
 
     varianceIC  /=  (qreal) n;
 
-    calculatedIC = true;
-
-    WM.clear();
+    resultCacheStore(IndexType::IC, cacheParameters);
+    m_prominenceScoreIndex.remove(IndexType::IC);
 
-    emit signalProgressBoxUpdate(n);
-    emit signalProgressBoxKill();
+    graphProgressUpdate(n);
+    graphProgressKill();
 }
 
 
@@ -6492,6 +9787,9 @@ void Graph::writeCentralityInformation(const QString fileName,
                                        const bool considerWeights,
                                        const bool inverseWeights){
 
+    GraphTraceScope trace("Graph::writeCentralityInformation");
+    trace.setInput( vertices(), edgesEnabled() );
+
     qDebug() << "Graph::writeCentralityInformation()";
 
     QElapsedTimer computationTimer;
@@ -6531,7 +9829,7 @@ void Graph::writeCentralityInformation(const QString fileName,
 
     QString pMsg = tr("Writing Information Centralities to file. \nPlease wait...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     outText.setRealNumberPrecision(m_reportsRealPrecision);
 
@@ -6610,7 +9908,7 @@ void Graph::writeCentralityInformation(const QString fileName,
 
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         rowCount++;
 
@@ -6741,7 +10039,7 @@ void Graph::writeCentralityInformation(const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -6764,6 +10062,9 @@ void Graph::writeCentralityEigenvector(const QString fileName,
                                        const bool &inverseWeights,
                                        const bool &dropIsolates){
 
+    GraphTraceScope trace("Graph::writeCentralityEigenvector");
+    trace.setInput( vertices(), edgesEnabled() );
+
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -6797,7 +10098,7 @@ void Graph::writeCentralityEigenvector(const QString fileName,
 
     QString pMsg = tr("Writing Eigenvector Centrality scores to file. \nPlease wait...") ;
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     outText.setRealNumberPrecision(m_reportsRealPrecision);
 
@@ -6884,7 +10185,7 @@ void Graph::writeCentralityEigenvector(const QString fileName,
 
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         rowCount++;
 
@@ -6999,25 +10300,87 @@ void Graph::writeCentralityEigenvector(const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
+
+}
+
+
+
+/**
+ * @brief Sets the convergence tolerance of Eigenvector centrality, that is
+ * the L1 distance between successive normalized vectors (power iteration)
+ * or the residual norm of the Ritz vector (Lanczos) below which it stops.
+ * @param tolerance
+ */
+void Graph::setCentralityEigenvectorTolerance(const qreal &tolerance) {
+    qDebug() << "Graph::setCentralityEigenvectorTolerance() -" << tolerance;
+    m_centralityEigenvectorTolerance = ( tolerance > 0 ) ? tolerance : 0.0000001;
+    m_resultCache.remove(IndexType::EVC);
+}
+
+
+
+/**
+ * @brief Sets the maximum number of sparse matrix-vector products that
+ * Eigenvector centrality may spend before it stops.
+ * @param iterations
+ */
+void Graph::setCentralityEigenvectorMaxIterations(const int &iterations) {
+    qDebug() << "Graph::setCentralityEigenvectorMaxIterations() -" << iterations;
+    m_centralityEigenvectorMaxIterations = ( iterations > 0 ) ? iterations : 500;
+    m_resultCache.remove(IndexType::EVC);
+}
+
 
+
+/**
+ * @brief If toggle is true, Eigenvector centrality is computed with a restarted
+ * Lanczos solver on symmetric graphs, which converges much faster than power
+ * iteration when the second eigenvalue is close to the first in magnitude, as in
+ * (near) bipartite graphs. On other graphs it uses the shifted power iteration
+ * x <- (A + I) x, which has the same leading eigenvector but does not oscillate.
+ * @param toggle
+ */
+void Graph::setCentralityEigenvectorLanczos(const bool &toggle) {
+    qDebug() << "Graph::setCentralityEigenvectorLanczos() -" << toggle;
+    if ( m_centralityEigenvectorLanczos == toggle ) {
+        return;
+    }
+    m_centralityEigenvectorLanczos = toggle;
+    m_resultCache.remove(IndexType::EVC);
 }
 
 
 
 /**
  * @brief Computes Eigenvector centrality
+ *
+ * The EVC scores are the leading eigenvector of the adjacency matrix A, with
+ * EVC(i) proportional to the sum of A(i,j) EVC(j) over the out-edges of i.
+ * The matrix is kept sparse, as rows of the CSR snapshot restricted to the
+ * enabled vertices (dropping isolates if asked), and each product Ax runs on
+ * a pool of workers over blocks of rows.
+ * The vector is normalized to unit Euclidean length. See
+ * setCentralityEigenvectorTolerance(), setCentralityEigenvectorMaxIterations()
+ * and setCentralityEigenvectorLanczos().
  * @param considerWeights
  * @param inverseWeights
+ * @param dropIsolates
  */
 void Graph::centralityEigenvector(const bool &considerWeights,
                                   const bool &inverseWeights,
                                   const bool &dropIsolates) {
 
-    qDebug() << "Graph::centralityEigenvector()";
+    GraphTraceScope trace("Graph::centralityEigenvector");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("considerWeights=%1 inverseWeights=%2 dropIsolates=%3")
+                    .arg(considerWeights).arg(inverseWeights).arg(dropIsolates) );
 
-    if ( calculatedEVC ) {
-        qDebug() << "Graph::centralityEigenvector() - Already computed. Return.";
+    qCHotDebug(lcGraph) << "Graph::centralityEigenvector()";
+
+    const int cacheParameters = GraphResultCache::parameters(considerWeights, inverseWeights, dropIsolates);
+    if ( resultCacheRestore(IndexType::EVC, cacheParameters) ) {
+        qCHotDebug(lcGraph) << "Graph::centralityEigenvector() - Already computed. Return.";
         return;
     }
 
@@ -7032,102 +10395,275 @@ void Graph::centralityEigenvector(const bool &considerWeights,
     meanEVC=0;
     VList::const_iterator it;
 
-    bool symmetrize=false;
-    bool useDegrees=false;
-    int i = 0;
+    const qreal tolerance = m_centralityEigenvectorTolerance;
+    const int maxIterations = m_centralityEigenvectorMaxIterations;
+    const int blockSize = 4096;        // rows per work item of the parallel SpMV
+
+    int i = 0, k = 0, e = 0;
     int N = vertices(dropIsolates);
+    int iterations = 0;
+    qreal SEVC = 0, norm = 0, distance = 0;
 
-    qreal *EVC = new (nothrow) qreal [N];
-    Q_CHECK_PTR( EVC );
-    qreal SEVC = 0;
+    QString pMsg = tr("Computing Eigenvector Centrality scores. \nPlease wait...") ;
+    emit statusMessage( pMsg );
+    graphProgressCreate(N,pMsg);
+
+    // Sparse adjacency over the participating vertices only
+    const GraphCSR &csr = graphCSR();
+    const int V = csr.vertices();
+    QVector<int> local(V, -1), global;
+    for (it=m_graph.cbegin(), i=0; it!=m_graph.cend(); ++it, ++i) {
+        if ( ! (*it)->isEnabled() || ( dropIsolates && (*it)->isIsolated() ) ) {
+            continue;
+        }
+        local[i] = global.size();
+        global << i;
+    }
+    N = global.size();
+
+    QVector<int> offsets(N+1, 0), targets;
+    vector<qreal> weights;
+    targets.reserve( csr.edges() );
+    weights.reserve( csr.edges() );
+    for (k = 0; k < N; ++k) {
+        i = global[k];
+        offsets[k] = targets.size();
+        for (e = csr.outBegin(i); e < csr.outEnd(i); ++e) {
+            if ( local[ csr.outTarget(e) ] < 0 ) {
+                continue;
+            }
+            targets << local[ csr.outTarget(e) ];
+            if ( !considerWeights ) {
+                weights.push_back( 1 );
+            }
+            else if ( inverseWeights ) {
+                weights.push_back( 1.0 / csr.outWeight(e) );
+            }
+            else {
+                weights.push_back( csr.outWeight(e) );
+            }
+        }
+    }
+    offsets[N] = targets.size();
+
+    const int blocks = ( N + blockSize - 1 ) / blockSize;
+    const int threads = graphWorkerThreads(blocks);
+    const bool useLanczos = m_centralityEigenvectorLanczos;
+    const bool symmetric = graphIsSymmetric();
+
+    // y = A x + shift * x
+    auto product = [&](const vector<qreal> &x, vector<qreal> &y, const qreal &shift) {
+        graphParallelFor( blocks, threads, [&](const int &, const int &block) {
+            const int first = block * blockSize;
+            const int last = qMin( N, first + blockSize );
+            for (int r = first; r < last; ++r) {
+                qreal sum = shift * x[r];
+                for (int c = offsets[r]; c < offsets[r+1]; ++c) {
+                    sum += weights[c] * x[ targets[c] ];
+                }
+                y[r] = sum;
+            }
+        }, false );
+    };
 
-    graphMatrixAdjacencyCreate(dropIsolates, considerWeights,
-                               inverseWeights, symmetrize);
+    auto euclidean = [&](const vector<qreal> &x) {
+        qreal s = 0;
+        for (int r = 0; r < N; ++r) {
+            s += x[r] * x[r];
+        }
+        return sqrt(s);
+    };
 
+    vector<qreal> EVC(N, 1.0), tmp(N, 0);
 
-    QString pMsg = tr("Computing Eigenvector Centrality scores. \nPlease wait...") ;
-    emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressUpdate( N / 3);
 
+    if ( N > 0 && targets.size() > 0 && useLanczos && symmetric ) {
 
-    if (useDegrees) {
+        // Restarted Lanczos with full reorthogonalization. Each cycle builds
+        // an orthonormal Krylov basis Q of A from the current vector, and
+        // restarts from the Ritz vector of the largest eigenvalue of the
+        // tridiagonal matrix T = Q'AQ.
+        const int m = qMin( N, 30 );
+        vector< vector<qreal> > Q( m, vector<qreal>(N, 0) );
+        vector<qreal> alpha(m, 0), beta(m+1, 0);
+        qreal residual = RAND_MAX, theta = 0;
 
-        qDebug() << "Graph::centralityEigenvector() - Using outDegree for initial EVC vector";
+        norm = euclidean(EVC);
+        for (int r = 0; r < N; ++r) {
+            EVC[r] /= norm;
+        }
 
-        emit statusMessage(tr("Computing outDegrees. Please wait..."));
+        while ( residual > tolerance && iterations < maxIterations ) {
 
-        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
+            int steps = 0;
+            Q[0] = EVC;
+            beta[0] = 0;
 
-            if (!(*it)->isIsolated() && dropIsolates) {
-                continue;
+            for (int j = 0; j < m && iterations < maxIterations; ++j) {
+                product( Q[j], tmp, 0 );
+                iterations++;
+                steps = j + 1;
+                qreal a = 0;
+                for (int r = 0; r < N; ++r) {
+                    a += tmp[r] * Q[j][r];
+                }
+                alpha[j] = a;
+                for (int r = 0; r < N; ++r) {
+                    tmp[r] -= a * Q[j][r] + ( j > 0 ? beta[j] * Q[j-1][r] : 0 );
+                }
+                for (int l = 0; l <= j; ++l) {
+                    qreal dot = 0;
+                    for (int r = 0; r < N; ++r) {
+                        dot += tmp[r] * Q[l][r];
+                    }
+                    for (int r = 0; r < N; ++r) {
+                        tmp[r] -= dot * Q[l][r];
+                    }
+                }
+                beta[j+1] = euclidean(tmp);
+                if ( j + 1 == m || beta[j+1] < tolerance * 1e-3 ) {
+                    break;
+                }
+                for (int r = 0; r < N; ++r) {
+                    Q[j+1][r] = tmp[r] / beta[j+1];
+                }
             }
 
-            EVC[i] = (*it)->degreeOut();
+            Matrix T(steps, steps), S;
+            for (int j = 0; j < steps; ++j) {
+                T.setItem(j, j, alpha[j]);
+                if ( j + 1 < steps ) {
+                    T.setItem(j, j+1, beta[j+1]);
+                    T.setItem(j+1, j, beta[j+1]);
+                }
+            }
+            vector<qreal> ritzValues(steps, 0);
+            T.eigenSymmetric( ritzValues.data(), S );
+            int best = 0;
+            for (int j = 1; j < steps; ++j) {
+                if ( ritzValues[j] > ritzValues[best] ) {
+                    best = j;
+                }
+            }
+            theta = ritzValues[best];
+
+            // Ritz vector and its residual norm ||A x - theta x|| = beta * |s_last|
+            std::fill( EVC.begin(), EVC.end(), 0 );
+            for (int j = 0; j < steps; ++j) {
+                const qreal s = S.item(j, best);
+                for (int r = 0; r < N; ++r) {
+                    EVC[r] += s * Q[j][r];
+                }
+            }
+            residual = fabs( beta[steps] * S.item(steps-1, best) );
 
-            i++;
-        }
+            norm = euclidean(EVC);
+            if ( !norm ) {
+                norm = 1;
+            }
+            qreal sum = 0;
+            for (int r = 0; r < N; ++r) {
+                EVC[r] /= norm;
+                sum += EVC[r];
+            }
+            // The Perron vector is non-negative
+            if ( sum < 0 ) {
+                for (int r = 0; r < N; ++r) {
+                    EVC[r] = -EVC[r];
+                }
+            }
 
-    }
-    else {
-        qDebug() << "Graph::centralityEigenvector() - Using unit initial EVC vector";
-        for (int i = 0 ; i < N ; i++) {
-            EVC[i] = 1;
+            qCHotDebug(lcGraph) << "Graph::centralityEigenvector() - Lanczos cycle of" << steps
+                     << "steps, products" << iterations
+                     << "theta" << theta << "residual" << residual;
         }
-
     }
+    else if ( N > 0 && targets.size() > 0 ) {
 
-    emit signalProgressBoxUpdate( N / 3);
+        // Power iteration, shifted by the identity when asked for
+        const qreal shift = useLanczos ? 1.0 : 0.0;
 
-    AM.powerIteration(EVC, sumEVC, maxEVC, maxNodeEVC,
-                      minEVC, minNodeEVC,
-                      0.0000001, 500);
+        do {
+            product( EVC, tmp, shift );
+            iterations++;
+
+            // norm should never be zero, but in case there is
+            // numerical error, we set it to 1
+            norm = euclidean(tmp);
+            if ( !norm ) {
+                norm = 1;
+            }
 
-    emit signalProgressBoxUpdate(2 * N / 3);
+            distance = 0;
+            for (int r = 0; r < N; ++r) {
+                tmp[r] /= norm;
+                distance += fabs( tmp[r] - EVC[r] );
+            }
+            EVC.swap(tmp);
 
-    emit statusMessage(tr("Leading eigenvector computed. "
-                          "Analysing centralities. Please wait..."));
+            qCHotDebug(lcGraph) << "Graph::centralityEigenvector() - iteration" << iterations
+                     << "distance from previous" << distance;
 
-    i = 0;
+        } while ( distance > tolerance && iterations < maxIterations );
+    }
 
-    meanEVC = sumEVC / (qreal) N;
+    qCHotDebug(lcGraph) << "Graph::centralityEigenvector() - leading eigenvector after"
+             << iterations << "matrix-vector products";
 
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
+    graphProgressUpdate(2 * N / 3);
 
-        if (!(*it)->isIsolated() && dropIsolates) {
-            continue;
+    emit statusMessage(tr("Leading eigenvector computed. "
+                          "Analysing centralities. Please wait..."));
+
+    for (k = 0; k < N; ++k) {
+        sumEVC += EVC[k];
+        if ( EVC[k] > maxEVC ) {
+            maxEVC = EVC[k];
+            maxNodeEVC = csr.name( global[k] );
         }
+        if ( EVC[k] < minEVC ) {
+            minEVC = EVC[k];
+            minNodeEVC = csr.name( global[k] );
+        }
+    }
+
+    meanEVC = ( N > 0 ) ? sumEVC / (qreal) N : 0;
+
+    for (k = 0; k < N; ++k) {
 
-        (*it) -> setEVC( EVC[i]);
+        GraphVertex *vertex = m_graph[ global[k] ];
+
+        vertex -> setEVC( EVC[k] );
         if ( maxEVC != 0 ) {
-            SEVC = EVC[i] / maxEVC ;
+            SEVC = EVC[k] / maxEVC ;
         }
         else {
             SEVC = 0 ;
         }
 
-        (*it) -> setSEVC( SEVC );
+        vertex -> setSEVC( SEVC );
 
         resolveClasses(SEVC, discreteEVCs, classesEVC);
 
-        varianceEVC += (EVC[i]-meanEVC) * (EVC[i]-meanEVC) ;
-
-        i++;
+        varianceEVC += (EVC[k]-meanEVC) * (EVC[k]-meanEVC) ;
 
     }
 
-    varianceEVC=varianceEVC/(qreal) N;
+    if ( N > 0 ) {
+        varianceEVC=varianceEVC/(qreal) N;
+    }
 
 
     // group eigenvector centralization measure is
     // S(cmax - c(vi)) divided by the maximum value possible,
     // where c(vi) is the eigenvector centrality of vertex vi.
 
-    calculatedEVC=true;
+    resultCacheStore(IndexType::EVC, cacheParameters);
+    m_prominenceScoreIndex.remove(IndexType::EVC);
 
-    delete [] EVC;
-
-    emit signalProgressBoxUpdate( N );
-    emit signalProgressBoxKill();
+    graphProgressUpdate( N );
+    graphProgressKill();
 }
 
 
@@ -7141,9 +10677,15 @@ void Graph::centralityEigenvector(const bool &considerWeights,
  * @param dropIsolates
  */
 void Graph::centralityDegree(const bool &weights, const bool &dropIsolates){
-    qDebug("Graph::centralityDegree()");
-    if ( calculatedDC ) {
-        qDebug() << "Graph::centralityDegree() - graph not changed - returning";
+
+    GraphTraceScope trace("Graph::centralityDegree");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("weights=%1 dropIsolates=%2")
+                    .arg(weights).arg(dropIsolates) );
+    qCHotDebug(lcGraph, "Graph::centralityDegree()");
+    const int cacheParameters = GraphResultCache::parameters(weights, false, dropIsolates);
+    if ( resultCacheRestore(IndexType::DC, cacheParameters) ) {
+        qCHotDebug(lcGraph) << "Graph::centralityDegree() - graph not changed - returning";
         return;
     }
     qreal DC=0, nom=0, denom=0,  SDC=0;
@@ -7162,9 +10704,9 @@ void Graph::centralityDegree(const bool &weights, const bool &dropIsolates){
 
     QString pMsg =  tr("Computing out-Degree Centralities. \nPlease wait...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
-    emit signalProgressBoxUpdate(N/3);
+    graphProgressUpdate(N/3);
 
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
 
@@ -7172,7 +10714,7 @@ void Graph::centralityDegree(const bool &weights, const bool &dropIsolates){
         if (!(*it)->isIsolated()) {
             for (it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1){
                 if ( (weight=edgeExists( (*it)->name(), (*it1)->name() ) ) != 0.0  )   {
-                    //                    qDebug() << "Graph::centralityDegree() - vertex "
+                    //                    qCHotDebug(lcGraph) << "Graph::centralityDegree() - vertex "
                     //                             <<  (*it)->name()
                     //                             << " has edge to = " <<  (*it1)->name();
                     if (weights)
@@ -7189,11 +10731,11 @@ void Graph::centralityDegree(const bool &weights, const bool &dropIsolates){
 
         (*it) -> setDC ( DC ) ;	//Set OutDegree
         sumDC += DC;          // store sumDC (for std calc below)
-        qDebug() << "Graph:centralityDegree() - vertex "
+        qCHotDebug(lcGraph) << "Graph:centralityDegree() - vertex "
                  <<  (*it)->name() << " has DC = " << DC ;
     }
 
-    emit signalProgressBoxUpdate(2*N/3);
+    graphProgressUpdate(2*N/3);
     // Calculate std Out-Degree, min, max, classes and sumSDC
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
         DC= (*it)->DC();
@@ -7205,14 +10747,14 @@ void Graph::centralityDegree(const bool &weights, const bool &dropIsolates){
         }
         (*it) -> setSDC( SDC );		//Set Standard DC
 
-        //        qDebug() << "Graph::centralityDegree() - vertex "
+        //        qCHotDebug(lcGraph) << "Graph::centralityDegree() - vertex "
         //                 <<  (*it)->name() << " SDC " << (*it)->SDC ();
 
         sumSDC+=SDC;
 
         resolveClasses(SDC, discreteSDCs, classesSDC );
 
-        //qDebug() << "DC classes =  " << classesSDC;
+        //qCHotDebug(lcGraph) << "DC classes =  " << classesSDC;
 
         if (maxSDC < SDC ) {
             maxSDC = SDC ;
@@ -7228,7 +10770,7 @@ void Graph::centralityDegree(const bool &weights, const bool &dropIsolates){
         maxNodeSDC=-1;
 
     meanSDC = sumSDC / (qreal) N;
-    //    qDebug() << "Graph::centralityDegree() - sumSDC  " << sumSDC
+    //    qCHotDebug(lcGraph) << "Graph::centralityDegree() - sumSDC  " << sumSDC
     //             << " vertices " << N << " meanSDC = sumSDC / N = " << meanSDC;
 
     // Calculate Variance and the Degree Centralization of the whole graph.
@@ -7244,7 +10786,7 @@ void Graph::centralityDegree(const bool &weights, const bool &dropIsolates){
     }
     varianceSDC=varianceSDC/(qreal) N;
 
-    //    qDebug() << "Graph::centralityDegree() - variance = " << varianceSDC;
+    //    qCHotDebug(lcGraph) << "Graph::centralityDegree() - variance = " << varianceSDC;
     if (m_graphIsSymmetric) {
         // we divide by N-1 because we use std C values
         denom= (N-1.0)*(N-2.0)  / (N-1.0);
@@ -7257,15 +10799,16 @@ void Graph::centralityDegree(const bool &weights, const bool &dropIsolates){
         denom = N-1.0;
     }
 
-    //    qDebug () << "*** N is " << N << " nom " << nom << " denom is " << denom;
+    //    qCHotDebug(lcGraph) << "*** N is " << N << " nom " << nom << " denom is " << denom;
     if (!weights) {
         groupDC=nom/denom;
     }
 
-    calculatedDC=true;
+    resultCacheStore(IndexType::DC, cacheParameters);
+    m_prominenceScoreIndex.remove(IndexType::DC);
 
-    emit signalProgressBoxUpdate(N);
-    emit signalProgressBoxKill();
+    graphProgressUpdate(N);
+    graphProgressKill();
 
 }
 
@@ -7344,7 +10887,7 @@ void Graph::prominenceDistribution(const int &index,
     QString pMsg = tr("Computing Centrality Distribution. \nPlease wait...");
     emit statusMessage(  pMsg );
 
-    H_StrToInt discreteClasses;
+    GraphDistribution discreteClasses;
 
     QString seriesName;
 
@@ -7440,6 +10983,60 @@ void Graph::prominenceDistribution(const int &index,
 
 
 
+/**
+ * @brief Returns the range of the values and of the frequencies of the
+ * sorted classes of a distribution
+ * @param values
+ * @param frequencies
+ * @param min
+ * @param max
+ * @param minF
+ * @param maxF
+ */
+void Graph::prominenceDistributionRange(const QVector<qreal> &values,
+                                        const QVector<int> &frequencies,
+                                        qreal &min, qreal &max,
+                                        qreal &minF, qreal &maxF) const {
+    for (int c = 0; c < frequencies.size(); ++c) {
+        if ( frequencies[c] < minF ) {
+            minF = frequencies[c];
+        }
+        if ( frequencies[c] > maxF ) {
+            maxF = frequencies[c];
+        }
+    }
+    if ( ! values.isEmpty() ) {
+        min = values.first();
+        max = values.last();
+    }
+}
+
+
+
+/**
+ * @brief Returns at most maxPoints (value,frequency) points of the sorted
+ * classes of a distribution, see GraphDistribution::downsample()
+ * @param values
+ * @param frequencies
+ * @param maxPoints
+ * @return
+ */
+QVector<QPointF> Graph::prominenceDistributionPoints(const QVector<qreal> &values,
+                                                     const QVector<int> &frequencies,
+                                                     const int &maxPoints) const {
+    QVector<qreal> sampledValues;
+    QVector<int> sampledFrequencies;
+    GraphDistribution::downsample(values, frequencies, maxPoints,
+                                  sampledValues, sampledFrequencies);
+    QVector<QPointF> points( sampledValues.size() );
+    for (int c = 0; c < sampledValues.size(); ++c) {
+        points[c] = QPointF( sampledValues[c], sampledFrequencies[c] );
+    }
+    return points;
+}
+
+
+
 /**
  * @brief Computes the distribution of a centrality index scores.
  * The distribution data are returned as QSplineSeries series to MW
@@ -7447,7 +11044,7 @@ void Graph::prominenceDistribution(const int &index,
  * @param index
  * @param series
  */
-void Graph::prominenceDistributionSpline(const H_StrToInt &discreteClasses,
+void Graph::prominenceDistributionSpline(const GraphDistribution &discreteClasses,
                                          const QString &seriesName,
                                          const QString &distImageFileName) {
 
@@ -7464,58 +11061,26 @@ void Graph::prominenceDistributionSpline(const H_StrToInt &discreteClasses,
     QValueAxis *axisX1 = new QValueAxis ();
     QValueAxis *axisY1 = new QValueAxis ();
 
-    // The seriesPQ is a priority queue which will hold
-    // the (value,frequency) pairs ordered from smallest to larger value
-    // This is used further below to insert pairs to the series in an ordered way
-    priority_queue<PairVF, vector<PairVF>, PairVFCompare> seriesPQ;
-
-    QHash<QString, int>::const_iterator i;
-
-    for (i = discreteClasses.constBegin(); i != discreteClasses.constEnd(); ++i) {
-
-        qDebug() << "Graph::prominenceDistributionSpline() - discreteClasses: "
-                 << i.key() << ": " << i.value() ;
-
-        seriesPQ.push(PairVF(i.key().toDouble(), i.value()));
+    // The (value,frequency) pairs of the classes,
+    // ordered from smallest to larger value
+    QVector<qreal> values;
+    QVector<int> frequencies;
+    discreteClasses.sorted(values, frequencies);
 
-    }
-
-    unsigned int initialSize = seriesPQ.size();
     qreal min = 0;
     qreal max = 0;
-    qreal value = 0;
 
-    qreal frequency = 0;
     qreal minF = RAND_MAX;
     qreal maxF = 0;
 
-    while (!seriesPQ.empty()) {
-        qDebug() << "Graph::prominenceDistributionSpline() - seriesPQ top is:"
-                 << seriesPQ.top().value << " : "
-                 << seriesPQ.top().frequency;
-
-        value =  seriesPQ.top().value;
-        frequency = seriesPQ.top().frequency;
-
-        series->append( value,  frequency );
-        series1->append( value,  frequency );
-
-        if ( frequency < minF ) {
-            minF = frequency;
-        }
-        if ( frequency > maxF ) {
-            maxF = frequency;
-        }
-
-        if ( initialSize == seriesPQ.size() ) {
-            min = value;
-        }
-        if ( seriesPQ.size() == 1 ) {
-            max = value;
-        }
+    prominenceDistributionRange(values, frequencies, min, max, minF, maxF);
 
+    qDebug() << "Graph::prominenceDistributionSpline() - classes:" << values.size();
 
-        seriesPQ.pop();
+    // The charts get a bounded number of points, whatever the number of classes
+    series->replace( prominenceDistributionPoints(values, frequencies, m_reportsChartPoints) );
+    if ( !distImageFileName.isEmpty() ) {
+        series1->replace( prominenceDistributionPoints(values, frequencies, m_reportsChartImagePoints) );
     }
 
     axisX->setMin(min);
@@ -7601,7 +11166,7 @@ void Graph::prominenceDistributionSpline(const H_StrToInt &discreteClasses,
  * @param index
  * @param series
  */
-void Graph::prominenceDistributionArea(const H_StrToInt &discreteClasses,
+void Graph::prominenceDistributionArea(const GraphDistribution &discreteClasses,
                                        const QString &name,
                                        const QString &distImageFileName) {
 
@@ -7609,7 +11174,7 @@ void Graph::prominenceDistributionArea(const H_StrToInt &discreteClasses,
 
     QAreaSeries *series = new QAreaSeries ();
     series->setName (name);
-    QLineSeries *upperSeries = new QLineSeries();
+    QLineSeries *upperSeries = new QLineSeries(series);
     QValueAxis *axisX = new QValueAxis();
     QValueAxis *axisY = new QValueAxis();
 
@@ -7619,57 +11184,24 @@ void Graph::prominenceDistributionArea(const H_StrToInt &discreteClasses,
     QValueAxis *axisX1 = new QValueAxis();
     QValueAxis *axisY1 = new QValueAxis();
 
-    // The seriesPQ is a priority queue which will hold
-    // the (value,frequency) pairs ordered from smallest to larger value
-    // This is used further below to insert pairs to the series in an ordered way
-    priority_queue<PairVF, vector<PairVF>, PairVFCompare> seriesPQ;
-
-    QHash<QString, int>::const_iterator i;
-
-    for (i = discreteClasses.constBegin(); i != discreteClasses.constEnd(); ++i) {
-
-        qDebug() << "discreteClasses: " << i.key() << ": " << i.value() << endl;
+    // The (value,frequency) pairs of the classes,
+    // ordered from smallest to larger value
+    QVector<qreal> values;
+    QVector<int> frequencies;
+    discreteClasses.sorted(values, frequencies);
 
-        seriesPQ.push(PairVF(i.key().toDouble(), i.value()));
-
-    }
-
-    unsigned int initialSize = seriesPQ.size();
     qreal min = 0;
     qreal max = 0;
-    qreal value = 0;
 
-    qreal frequency = 0;
     qreal minF = RAND_MAX;
     qreal maxF = 0;
 
-    while (!seriesPQ.empty()) {
-
-        qDebug() << seriesPQ.top().value << " : "
-                 << seriesPQ.top().frequency << endl;
-
-        value =  seriesPQ.top().value;
-        frequency = seriesPQ.top().frequency;
-
-        upperSeries->append( value,  frequency );
-
-        if ( frequency < minF ) {
-            minF = frequency;
-        }
-        if ( frequency > maxF ) {
-            maxF = frequency;
-        }
-
-        if ( initialSize == seriesPQ.size() ) {
-            min = value;
-        }
-        if ( seriesPQ.size() == 1 ) {
-            max = value;
-        }
+    prominenceDistributionRange(values, frequencies, min, max, minF, maxF);
 
+    qDebug() << "Graph::prominenceDistributionArea() - classes:" << values.size();
 
-        seriesPQ.pop();
-    }
+    // The charts get a bounded number of points, whatever the number of classes
+    upperSeries->replace( prominenceDistributionPoints(values, frequencies, m_reportsChartPoints) );
 
     axisX->setMin(min);
     axisX->setMax(max);
@@ -7698,7 +11230,9 @@ void Graph::prominenceDistributionArea(const H_StrToInt &discreteClasses,
         axisY1->setMin(minF);
         axisY1->setMax(maxF+1.0);
 
-        series1->setUpperSeries(upperSeries);
+        QLineSeries *upperSeries1 = new QLineSeries(series1);
+        upperSeries1->replace( prominenceDistributionPoints(values, frequencies, m_reportsChartImagePoints) );
+        series1->setUpperSeries(upperSeries1);
 
         QChart *chart = new QChart();
         QChartView *chartView = new QChartView( chart );
@@ -7760,7 +11294,7 @@ void Graph::prominenceDistributionArea(const H_StrToInt &discreteClasses,
  * @param set
  * @param strX
  */
-void Graph::prominenceDistributionBars(const H_StrToInt &discreteClasses,
+void Graph::prominenceDistributionBars(const GraphDistribution &discreteClasses,
                                        const QString &name,
                                        const QString &distImageFileName) {
 
@@ -7779,22 +11313,20 @@ void Graph::prominenceDistributionBars(const H_StrToInt &discreteClasses,
     QValueAxis *axisY1 = new QValueAxis;
     QBarCategoryAxis *axisX1 = new QBarCategoryAxis();
 
-    // The seriesPQ is a priority queue which will hold
-    // the (value,frequency) pairs ordered from smallest to larger value
-    // This is used further below to insert pairs to the series in an ordered way
-    priority_queue<PairVF, vector<PairVF>, PairVFCompare> seriesPQ;
+    // The (value,frequency) pairs of the classes,
+    // ordered from smallest to larger value
+    QVector<qreal> allValues;
+    QVector<int> allFrequencies;
+    discreteClasses.sorted(allValues, allFrequencies);
 
-    QHash<QString, int>::const_iterator i;
+    // The charts get a bounded number of bars, whatever the number of
+    // classes: the classes are grouped in bins of equal width if need be.
+    QVector<qreal> values;
+    QVector<int> frequencies;
+    GraphDistribution::bin(allValues, allFrequencies, m_reportsChartBars, values, frequencies);
 
-    for (i = discreteClasses.constBegin(); i != discreteClasses.constEnd(); ++i) {
-
-        qDebug() << "discreteClasses: " << i.key() << ": " << i.value() << endl;
-
-        seriesPQ.push(PairVF(i.key().toDouble(), i.value()));
-
-    }
-
-    unsigned int initialSize = seriesPQ.size();
+    qDebug() << "Graph::prominenceDistributionBars() - classes:" << allValues.size()
+             << "bars:" << values.size();
 
     QString min = QString();
     QString max = QString();
@@ -7804,14 +11336,11 @@ void Graph::prominenceDistributionBars(const H_StrToInt &discreteClasses,
     qreal minF = RAND_MAX;
     qreal maxF = 0;
 
-    while (!seriesPQ.empty()) {
-
-        value = QString::number(  seriesPQ.top().value, 'f', 6);
+    for (int c = 0; c < values.size(); ++c) {
 
-        frequency = seriesPQ.top().frequency;
+        value = QString::number( values[c], 'f', 6);
 
-        qDebug() << "value:"<< value << " : "
-                 << "frequency:"<< frequency << endl;
+        frequency = frequencies[c];
 
         axisX->append( value );
         barSet->append( frequency );
@@ -7828,16 +11357,14 @@ void Graph::prominenceDistributionBars(const H_StrToInt &discreteClasses,
             maxF = frequency;
         }
 
-        if ( initialSize == seriesPQ.size() ) {
+        if ( c == 0 ) {
             min = value;
         }
-        if ( seriesPQ.size() == 1 ) {
+        if ( c == values.size() - 1 ) {
             max = value;
         }
 
-        seriesPQ.pop();
-
-    } // end while
+    } // end for
 
     axisX->setMin(min);
     axisX->setMax(max);
@@ -7920,6 +11447,143 @@ void Graph::prominenceDistributionBars(const H_StrToInt &discreteClasses,
 
 
 
+/**
+ * @brief Writes every vertex index stored on the enabled vertices, raw and
+ * standardized, as one table with a row per actor and a column per index.
+ * Values are comma separated, or tab separated if fileName ends in .tsv or
+ * .tab. The file is compressed if its name ends in .gz or .zst.
+ * The rows are formatted in chunks, in parallel unless parallel is false,
+ * and written in order.
+ * The indices not computed yet keep their last (usually zero) value.
+ * @param fileName
+ * @param parallel
+ * @return
+ */
+bool Graph::writeVertexIndicesTable(const QString &fileName,
+                                    const bool &parallel) {
+
+    GraphTraceScope trace("Graph::writeVertexIndicesTable");
+    trace.setInput( vertices(), edgesEnabled() );
+
+    qDebug() << "Graph::writeVertexIndicesTable() - file:" << fileName
+             << "parallel" << parallel;
+
+    const QString plainFileName = CompressedFile::fileNameWithoutCompression(fileName);
+    const char delimiter = ( plainFileName.endsWith(".tsv", Qt::CaseInsensitive)
+                             || plainFileName.endsWith(".tab", Qt::CaseInsensitive) )
+            ? '\t' : ',';
+
+    CompressedFile file( fileName );
+    file.setCompression( CompressedFile::compressionForFileName(fileName) );
+    if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )  {
+        emit statusMessage ( tr("Error. Could not write to ") + fileName );
+        return false;
+    }
+    GraphFileWriter outText( &file );
+
+    const char *columns[] = {
+        "actor", "label",
+        "DC", "DC'", "CC", "CC'", "IRCC", "IRCC'", "BC", "BC'", "SC", "SC'",
+        "EC", "EC'", "PC", "PC'", "IC", "IC'", "EVC", "EVC'",
+        "DP", "DP'", "PRP", "PRP'", "PP", "PP'", "CLC", "eccentricity"
+    };
+    const int columnCount = sizeof(columns) / sizeof(columns[0]);
+    for (int c = 0; c < columnCount; ++c) {
+        if ( c > 0 ) {
+            outText << delimiter;
+        }
+        outText << columns[c];
+    }
+    outText << '\n';
+
+    QVector<GraphVertex *> rows;
+    rows.reserve( m_graph.size() );
+    VList::const_iterator it;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
+        if ( (*it)->isEnabled() ) {
+            rows << (*it);
+        }
+    }
+
+    const int chunkSize = 4096;
+    const int chunks = ( rows.size() + chunkSize - 1 ) / chunkSize;
+    const int threads = ( parallel ) ? graphWorkerThreads(chunks) : 1;
+    // At most this many formatted chunks are held in memory at once
+    const int batch = qMax( 1, 4 * threads );
+    QVector<QByteArray> formatted( qMin( chunks, batch ) );
+
+    QString pMsg = tr("Writing vertex indices to file. \nPlease wait...");
+    emit statusMessage( pMsg );
+    graphProgressCreate( chunks, pMsg );
+
+    for (int first = 0; first < chunks; first += batch) {
+        const int count = qMin( batch, chunks - first );
+
+        graphParallelFor( count, qMin( threads, count ),
+                          [&](const int &worker, const int &item) {
+            Q_UNUSED(worker);
+            QByteArray &out = formatted[item];
+            out.clear();
+            out.reserve( chunkSize * 256 );
+            char number[32];
+            const auto appendNumber = [&](const qreal &value) {
+                out.append( delimiter );
+                out.append( number, GraphFileWriter::formatNumber( number, value ) );
+            };
+            const int begin = ( first + item ) * chunkSize;
+            const int end = qMin( rows.size(), begin + chunkSize );
+            for (int r = begin; r < end; ++r) {
+                GraphVertex *v = rows[r];
+                out.append( number, GraphFileWriter::formatNumber( number, v->name() ) );
+                out.append( delimiter );
+                QString label = v->label();
+                // quote labels with delimiters, quotes or line breaks
+                if ( label.contains( QLatin1Char(delimiter) ) || label.contains('"')
+                     || label.contains('\n') || label.contains('\r') ) {
+                    label = "\"" + label.replace("\"", "\"\"") + "\"";
+                }
+                out.append( label.toUtf8() );
+                appendNumber( v->DC() );   appendNumber( v->SDC() );
+                appendNumber( v->CC() );   appendNumber( v->SCC() );
+                appendNumber( v->IRCC() ); appendNumber( v->SIRCC() );
+                appendNumber( v->BC() );   appendNumber( v->SBC() );
+                appendNumber( v->SC() );   appendNumber( v->SSC() );
+                appendNumber( v->EC() );   appendNumber( v->SEC() );
+                appendNumber( v->PC() );   appendNumber( v->SPC() );
+                appendNumber( v->IC() );   appendNumber( v->SIC() );
+                appendNumber( v->EVC() );  appendNumber( v->SEVC() );
+                appendNumber( v->DP() );   appendNumber( v->SDP() );
+                appendNumber( v->PRP() );  appendNumber( v->SPRP() );
+                appendNumber( v->PP() );   appendNumber( v->SPP() );
+                appendNumber( v->CLC() );
+                appendNumber( v->eccentricity() );
+                out.append( '\n' );
+            }
+        }, false );
+
+        for (int c = 0; c < count; ++c) {
+            outText << formatted[c];
+        }
+        graphProgressUpdate( first + count );
+    }
+
+    graphProgressKill();
+
+    if ( !outText.finish() ) {
+        emit statusMessage ( tr("Error. Could not write to ") + fileName );
+        return false;
+    }
+    file.close();
+
+    emit statusMessage( tr("Vertex indices of %1 actors saved to file %2")
+                        .arg( rows.size() )
+                        .arg( QFileInfo(fileName).fileName() ) );
+    return true;
+}
+
+
+
+
 /**
  * @brief Writes the Degree Centrality to a file
  * @param fileName
@@ -7930,6 +11594,9 @@ void Graph::writeCentralityDegree ( const QString fileName,
                                     const bool considerWeights,
                                     const bool dropIsolates) {
 
+    GraphTraceScope trace("Graph::writeCentralityDegree");
+    trace.setInput( vertices(), edgesEnabled() );
+
     qDebug()<< "Graph:: writeCentralityDegree() - considerWeights "
             << considerWeights
             << " dropIsolates " <<dropIsolates;
@@ -7972,7 +11639,7 @@ void Graph::writeCentralityDegree ( const QString fileName,
 
     QString pMsg =  tr("Writing out-Degree Centralities. \nPlease wait...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     outText << "<h1>";
     outText << tr("DEGREE CENTRALITY (DC) REPORT");
@@ -8046,7 +11713,7 @@ void Graph::writeCentralityDegree ( const QString fileName,
 
         rowCount++;
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         outText << fixed;
 
@@ -8196,7 +11863,7 @@ void Graph::writeCentralityDegree ( const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 }
 
 
@@ -8215,6 +11882,9 @@ void Graph::writeCentralityCloseness( const QString fileName,
                                       const bool inverseWeights,
                                       const bool dropIsolates) {
 
+    GraphTraceScope trace("Graph::writeCentralityCloseness");
+    trace.setInput( vertices(), edgesEnabled() );
+
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -8234,6 +11904,11 @@ void Graph::writeCentralityCloseness( const QString fileName,
 
     graphDistancesGeodesic(true, considerWeights, inverseWeights, dropIsolates);
 
+    if ( graphCancelled() ) {
+        file.remove();
+        return;
+    }
+
     QString distImageFileName ;
 
     if ( m_reportsChartType != ChartType::None ) {
@@ -8251,7 +11926,7 @@ void Graph::writeCentralityCloseness( const QString fileName,
 
     QString pMsg = tr("Writing Closeness Centrality scores to file. \nPlease wait ...");
     emit statusMessage(pMsg);
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     outText << htmlHead;
 
@@ -8329,7 +12004,7 @@ void Graph::writeCentralityCloseness( const QString fileName,
 
     for (it= m_graph.cbegin(); it!= m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         rowCount++;
 
@@ -8484,7 +12159,7 @@ void Graph::writeCentralityCloseness( const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -8507,21 +12182,31 @@ void Graph::writeCentralityCloseness( const QString fileName,
 void Graph::centralityClosenessIR(const bool considerWeights,
                                   const bool inverseWeights,
                                   const bool dropIsolates){
-    qDebug()<< "Graph::centralityClosenessIR()";
-    if ( calculatedIRCC ) {
-        qDebug() << "Graph::centralityClosenessIR() - "
+
+    GraphTraceScope trace("Graph::centralityClosenessIR");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("considerWeights=%1 inverseWeights=%2 dropIsolates=%3")
+                    .arg(considerWeights).arg(inverseWeights).arg(dropIsolates) );
+    qCHotDebug(lcGraph)<< "Graph::centralityClosenessIR()";
+    const int cacheParameters = GraphResultCache::parameters(considerWeights, inverseWeights, dropIsolates);
+    if ( resultCacheRestore(IndexType::IRCC, cacheParameters) ) {
+        qCHotDebug(lcGraph) << "Graph::centralityClosenessIR() - "
                     " graph not changed - returning";
         return;
     }
 
     graphDistancesGeodesic(false,considerWeights,inverseWeights,dropIsolates);
 
+    if ( graphCancelled() ) {
+        return;
+    }
+
     // calculate centralities
-    VList::const_iterator it, jt;
+    VList::const_iterator it;
     int progressCounter = 0;
+    int i = 0;
     qreal IRCC=0,SIRCC=0;
     qreal Ji=0;
-    qreal dist=0;
     qreal sumD=0;
     qreal averageD=0;
     qreal N=vertices(dropIsolates,false, true);
@@ -8536,14 +12221,14 @@ void Graph::centralityClosenessIR(const bool considerWeights,
     QString pMsg = tr("Computing Influence Range Centrality scores. \n"
                       "Please wait");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
-    qDebug()<< "Graph::centralityClosenessIR() - dropIsolates"<< dropIsolates;
-    qDebug()<< "Graph::centralityClosenessIR() - computing scores for actors: " << N;
+    qCHotDebug(lcGraph)<< "Graph::centralityClosenessIR() - dropIsolates"<< dropIsolates;
+    qCHotDebug(lcGraph)<< "Graph::centralityClosenessIR() - computing scores for actors: " << N;
 
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+    for (it=m_graph.cbegin(), i=0; it!=m_graph.cend(); ++it, ++i) {
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         IRCC=0;
         sumD=0;
@@ -8551,37 +12236,23 @@ void Graph::centralityClosenessIR(const bool considerWeights,
         if ((*it)->isIsolated()) {
             continue;
         }
-        for (jt=m_graph.cbegin(); jt!=m_graph.cend(); ++jt){
-
-            if ( (*it)->name() == (*jt)->name() ) {
-                continue;
-            }
-            if ( ! (*jt)-> isEnabled() ) {
-                continue;
-            }
-
-            dist = (*it)->distance( (*jt)->name() );
-
-            if (dist != RAND_MAX ) {
-                sumD += dist;
-                Ji ++; // compute |Ji|
-            }
-            qDebug()<< "Graph::centralityClosenessIR() - dist(" << (*it)->name()
-                    << ","<< (*jt)->name() << ") =" << dist << "sumD" << sumD << " Ji"<<Ji;
 
-        }
+        // The influence range |Ji| and the sum of distances to the actors
+        // in it have been found by the geodesic pass
+        Ji = m_geodesicRangeSize[i];
+        sumD = m_geodesicRangeSum[i];
 
-        qDebug()<< "Graph::centralityClosenessIR() - " << (*it)->name()
+        qCHotDebug(lcGraph)<< "Graph::centralityClosenessIR() - " << (*it)->name()
                 << " sumD"<< sumD
                 << "distanceSum" << (*it)->distanceSum();
 
         // sanity check for sumD=0 (=> node is disconnected)
         if (sumD != 0)  {
             averageD = sumD / Ji;
-            qDebug()<< "Graph::centralityClosenessIR() - averageD = sumD /  Ji"<<averageD ;
-            qDebug()<< "Graph::centralityClosenessIR() - Ji / (N-1)"<< Ji << "/" << N-1;
+            qCHotDebug(lcGraph)<< "Graph::centralityClosenessIR() - averageD = sumD /  Ji"<<averageD ;
+            qCHotDebug(lcGraph)<< "Graph::centralityClosenessIR() - Ji / (N-1)"<< Ji << "/" << N-1;
             IRCC =  ( Ji / (qreal) (N-1) ) / averageD;
-            qDebug()<< "Graph::centralityClosenessIR() - [ Ji / (N-1) ] / [ sumD / Ji]" << IRCC ;
+            qCHotDebug(lcGraph)<< "Graph::centralityClosenessIR() - [ Ji / (N-1) ] / [ sumD / Ji]" << IRCC ;
         }
 
         sumIRCC += IRCC;
@@ -8606,9 +12277,10 @@ void Graph::centralityClosenessIR(const bool considerWeights,
 
     varianceIRCC=varianceIRCC/(qreal) N;
 
-    calculatedIRCC=true;
+    resultCacheStore(IndexType::IRCC, cacheParameters);
+    m_prominenceScoreIndex.remove(IndexType::IRCC);
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -8629,6 +12301,9 @@ void Graph::writeCentralityClosenessInfluenceRange(const QString fileName,
                                                    const bool inverseWeights,
                                                    const bool dropIsolates) {
 
+    GraphTraceScope trace("Graph::writeCentralityClosenessInfluenceRange");
+    trace.setInput( vertices(), edgesEnabled() );
+
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -8642,6 +12317,11 @@ void Graph::writeCentralityClosenessInfluenceRange(const QString fileName,
 
     centralityClosenessIR(considerWeights,inverseWeights, dropIsolates);
 
+    if ( graphCancelled() ) {
+        file.remove();
+        return;
+    }
+
     QString distImageFileName ;
 
     if ( m_reportsChartType != ChartType::None ) {
@@ -8660,7 +12340,7 @@ void Graph::writeCentralityClosenessInfluenceRange(const QString fileName,
     QString pMsg = tr("Writing Influence Range Centrality scores. \n"
                       "Please wait");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
 
     outText << htmlHead;
@@ -8734,7 +12414,7 @@ void Graph::writeCentralityClosenessInfluenceRange(const QString fileName,
 
     for (it= m_graph.cbegin(); it!= m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         rowCount++;
 
@@ -8838,7 +12518,7 @@ void Graph::writeCentralityClosenessInfluenceRange(const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 
 }
@@ -8858,6 +12538,9 @@ void Graph::writeCentralityBetweenness(const QString fileName,
                                        const bool inverseWeights,
                                        const bool dropIsolates) {
 
+    GraphTraceScope trace("Graph::writeCentralityBetweenness");
+    trace.setInput( vertices(), edgesEnabled() );
+
     qDebug() << "Graph::writeCentralityBetweenness()";
 
     QElapsedTimer computationTimer;
@@ -8871,7 +12554,14 @@ void Graph::writeCentralityBetweenness(const QString fileName,
     }
     QTextStream outText ( &file ); outText.setCodec("UTF-8");
 
-    graphDistancesGeodesic(true, considerWeights, inverseWeights, dropIsolates);
+    bool approximate = centralityBetweennessApproximate(considerWeights,
+                                                        inverseWeights,
+                                                        dropIsolates);
+
+    if ( graphCancelled() ) {
+        file.remove();
+        return;
+    }
 
     QString distImageFileName ;
 
@@ -8889,7 +12579,7 @@ void Graph::writeCentralityBetweenness(const QString fileName,
 
     QString pMsg =  tr("Writing Betweenness Centrality scores to file. \nPlease wait...");
     emit statusMessage ( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     outText << htmlHead;
 
@@ -8921,6 +12611,16 @@ void Graph::writeCentralityBetweenness(const QString fileName,
             << tr("BC' is the standardized index (BC divided by (N-1)(N-2)/2 in symmetric nets or (N-1)(N-2) otherwise.")
             << "</p>";
 
+    if (approximate) {
+        outText << "<p>"
+                << "<span class=\"info\">"
+                << tr("Approximate scores: ")
+                <<"</span>"
+                << tr("estimated from %1 sampled sources out of %2.")
+                   .arg(m_centralityBetweennessSampled).arg(N)
+                << "</p>";
+    }
+
     outText << "<p>"
             << "<span class=\"info\">"
             << tr("BC range: ")
@@ -8964,7 +12664,7 @@ void Graph::writeCentralityBetweenness(const QString fileName,
     VList::const_iterator it;
 
     for (it= m_graph.cbegin(); it!= m_graph.cend(); ++it){
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
         rowCount++;
 
         outText <<fixed;
@@ -9115,7 +12815,7 @@ void Graph::writeCentralityBetweenness(const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -9134,6 +12834,9 @@ void Graph::writeCentralityStress( const QString fileName,
                                    const bool inverseWeights,
                                    const bool dropIsolates) {
 
+    GraphTraceScope trace("Graph::writeCentralityStress");
+    trace.setInput( vertices(), edgesEnabled() );
+
     qDebug() << "Graph::writeCentralityStress()";
 
     QElapsedTimer computationTimer;
@@ -9147,7 +12850,14 @@ void Graph::writeCentralityStress( const QString fileName,
     }
     QTextStream outText ( &file ); outText.setCodec("UTF-8");
 
-    graphDistancesGeodesic(true, considerWeights, inverseWeights,dropIsolates);
+    bool approximate = centralityBetweennessApproximate(considerWeights,
+                                                        inverseWeights,
+                                                        dropIsolates);
+
+    if ( graphCancelled() ) {
+        file.remove();
+        return;
+    }
 
     QString distImageFileName ;
 
@@ -9168,7 +12878,7 @@ void Graph::writeCentralityStress( const QString fileName,
 
     QString pMsg =  tr("Writing Stress Centralities. \nPlease wait...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
 
     outText << htmlHead;
@@ -9198,6 +12908,16 @@ void Graph::writeCentralityStress( const QString fileName,
             << tr("SC' is the standardized index (SC divided by sumSC).")
             << "</p>";
 
+    if (approximate) {
+        outText << "<p>"
+                << "<span class=\"info\">"
+                << tr("Approximate scores: ")
+                <<"</span>"
+                << tr("estimated from %1 sampled sources out of %2.")
+                   .arg(m_centralityBetweennessSampled).arg(N)
+                << "</p>";
+    }
+
     outText << "<p>"
             << "<span class=\"info\">"
             << tr("SC range: ")
@@ -9239,7 +12959,7 @@ void Graph::writeCentralityStress( const QString fileName,
 
     for (it= m_graph.cbegin(); it!= m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         rowCount++;
 
@@ -9352,7 +13072,7 @@ void Graph::writeCentralityStress( const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -9369,6 +13089,9 @@ void Graph::writeCentralityEccentricity(const QString fileName,
                                         const bool inverseWeights,
                                         const bool dropIsolates) {
 
+    GraphTraceScope trace("Graph::writeCentralityEccentricity");
+    trace.setInput( vertices(), edgesEnabled() );
+
     qDebug() << "Graph::writeCentralityEccentricity()";
 
     QElapsedTimer computationTimer;
@@ -9384,6 +13107,11 @@ void Graph::writeCentralityEccentricity(const QString fileName,
 
     graphDistancesGeodesic(true, considerWeights, inverseWeights,dropIsolates);
 
+    if ( graphCancelled() ) {
+        file.remove();
+        return;
+    }
+
     QString distImageFileName ;
 
     if ( m_reportsChartType != ChartType::None ) {
@@ -9403,7 +13131,7 @@ void Graph::writeCentralityEccentricity(const QString fileName,
 
     QString pMsg = tr("Writing Eccentricity Centralities to file. \nPlease wait...") ;
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     outText << htmlHead;
 
@@ -9466,7 +13194,7 @@ void Graph::writeCentralityEccentricity(const QString fileName,
 
     for (it= m_graph.cbegin(); it!= m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         rowCount++;
 
@@ -9571,7 +13299,7 @@ void Graph::writeCentralityEccentricity(const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -9589,6 +13317,9 @@ void Graph::writeCentralityPower(const QString fileName,
                                  const bool inverseWeights,
                                  const bool dropIsolates) {
 
+    GraphTraceScope trace("Graph::writeCentralityPower");
+    trace.setInput( vertices(), edgesEnabled() );
+
     qDebug() << "Graph::writeCentralityPower()";
 
     QElapsedTimer computationTimer;
@@ -9604,6 +13335,11 @@ void Graph::writeCentralityPower(const QString fileName,
 
     graphDistancesGeodesic(true, considerWeights, inverseWeights, dropIsolates);
 
+    if ( graphCancelled() ) {
+        file.remove();
+        return;
+    }
+
 
     QString distImageFileName ;
 
@@ -9624,7 +13360,7 @@ void Graph::writeCentralityPower(const QString fileName,
 
     QString pMsg = tr("Writing Gil-Schmidt Power Centralities to file. \nPlease wait...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     outText << htmlHead;
 
@@ -9695,7 +13431,7 @@ void Graph::writeCentralityPower(const QString fileName,
 
     for (it= m_graph.cbegin(); it!= m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         rowCount++;
 
@@ -9846,7 +13582,7 @@ void Graph::writeCentralityPower(const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -9864,10 +13600,16 @@ void Graph::writeCentralityPower(const QString fileName,
  */
 void Graph::prestigeDegree(const bool &weights, const bool &dropIsolates){
 
-    qDebug()<< "Graph::prestigeDegree()";
+    GraphTraceScope trace("Graph::prestigeDegree");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("weights=%1 dropIsolates=%2")
+                    .arg(weights).arg(dropIsolates) );
 
-    if ( calculatedDP ) {
-        qDebug() << "Graph::prestigeDegree() - "
+    qCHotDebug(lcGraph)<< "Graph::prestigeDegree()";
+
+    const int cacheParameters = GraphResultCache::parameters(weights, false, dropIsolates);
+    if ( resultCacheRestore(IndexType::DP, cacheParameters) ) {
+        qCHotDebug(lcGraph) << "Graph::prestigeDegree() - "
                     " graph not changed - returning";
         return;
     }
@@ -9897,28 +13639,28 @@ void Graph::prestigeDegree(const bool &weights, const bool &dropIsolates){
 
     QString pMsg = tr("Computing Degree Prestige (in-Degree). \n Please wait ...");
     emit statusMessage(  pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
 
-    qDebug()<< "Graph::prestigeDegree() - vertices"
+    qCHotDebug(lcGraph)<< "Graph::prestigeDegree() - vertices"
             << N
             <<"graph modified. Recomputing...";
 
     for ( it = m_graph.cbegin(); it != m_graph.cend(); ++it)  {
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         v1 = (*it) -> name();
-        qDebug()<< "Graph::prestigeDegree() - computing DP for vertex" << v1 ;
+        qCHotDebug(lcGraph)<< "Graph::prestigeDegree() - computing DP for vertex" << v1 ;
 
         DP=0;
 
         if ( ! (*it)->isEnabled() ) {
-            qDebug()<< "Graph::prestigeDegree() - vertex disabled. Continue.";
+            qCHotDebug(lcGraph)<< "Graph::prestigeDegree() - vertex disabled. Continue.";
             continue;
         }
 
-        qDebug() << "Graph::prestigeDegree() - Iterate over inbound edges of "
+        qCHotDebug(lcGraph) << "Graph::prestigeDegree() - Iterate over inbound edges of "
                  << v1 ;
 
 
@@ -9930,11 +13672,11 @@ void Graph::prestigeDegree(const bool &weights, const bool &dropIsolates){
 
             v2 = hit.key();
 
-            qDebug() << "Graph::prestigeDegree() - inbound edge from" << v2;
+            qCHotDebug(lcGraph) << "Graph::prestigeDegree() - inbound edge from" << v2;
 
             if (  ! edgeExists ( v2, v1)  ) {
                 //sanity check
-                qDebug() << "Graph::prestigeDegree() - Cannot verify inbound edge"
+                qCHotDebug(lcGraph) << "Graph::prestigeDegree() - Cannot verify inbound edge"
                          << v2 << "CONTINUE" ;
                 ++hit;
                 continue;
@@ -9957,7 +13699,7 @@ void Graph::prestigeDegree(const bool &weights, const bool &dropIsolates){
         (*it) -> setDP ( DP ) ;		//Set DP
         sumDP += DP;
 
-        qDebug() << "Graph: prestigeDegree() vertex " <<  (*it)->name()
+        qCHotDebug(lcGraph) << "Graph: prestigeDegree() vertex " <<  (*it)->name()
                  << " DP "  << DP;
 
     }
@@ -9977,12 +13719,12 @@ void Graph::prestigeDegree(const bool &weights, const bool &dropIsolates){
         (*it) -> setSDP( SDP );
         sumSDP += SDP;
 
-        qDebug() << "Graph::prestigeDegree - vertex " <<  (*it)->name() << " DP  "
+        qCHotDebug(lcGraph) << "Graph::prestigeDegree - vertex " <<  (*it)->name() << " DP  "
                  << DP << " SDP " << (*it)->SDP ();
 
         resolveClasses(SDP, discreteDPs, classesSDP);
 
-        qDebug("DP classes = %i ", classesSDP);
+        qCHotDebug(lcGraph, "DP classes = %i ", classesSDP);
 
         if (maxSDP < SDP ) {
             maxSDP = SDP ;
@@ -10000,7 +13742,7 @@ void Graph::prestigeDegree(const bool &weights, const bool &dropIsolates){
 
     meanSDP = sumSDP / (qreal) N;
 
-    qDebug("Graph: sumSDP = %f, meanSDP = %f", sumSDP, meanSDP);
+    qCHotDebug(lcGraph, "Graph: sumSDP = %f, meanSDP = %f", sumSDP, meanSDP);
 
     // Calculate Variance and the Degree Prestigation of the whole graph. :)
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
@@ -10023,13 +13765,14 @@ void Graph::prestigeDegree(const bool &weights, const bool &dropIsolates){
 
     if (!weights) {
         groupDP=nom/denom;
-        qDebug("Graph: varianceSDP = %f, groupDP = %f", varianceSDP, groupDP);
+        qCHotDebug(lcGraph, "Graph: varianceSDP = %f, groupDP = %f", varianceSDP, groupDP);
     }
 
     delete enabledInEdges;
-    calculatedDP=true;
+    resultCacheStore(IndexType::DP, cacheParameters);
+    m_prominenceScoreIndex.remove(IndexType::DP);
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -10044,6 +13787,9 @@ void Graph::prestigeDegree(const bool &weights, const bool &dropIsolates){
 void Graph::writePrestigeDegree (const QString fileName,
                                  const bool considerWeights,
                                  const bool dropIsolates) {
+
+    GraphTraceScope trace("Graph::writePrestigeDegree");
+    trace.setInput( vertices(), edgesEnabled() );
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -10080,7 +13826,7 @@ void Graph::writePrestigeDegree (const QString fileName,
 
     QString pMsg = tr("Writing Degree Prestige (in-Degree) scores to file. \nPlease wait ...");
     emit statusMessage(  pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
 
     outText << htmlHead;
@@ -10158,7 +13904,7 @@ void Graph::writePrestigeDegree (const QString fileName,
 
     for (it= m_graph.cbegin(); it!= m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate( ++progressCounter );
+        graphProgressUpdate( ++progressCounter );
 
         rowCount++;
 
@@ -10309,7 +14055,7 @@ void Graph::writePrestigeDegree (const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -10323,19 +14069,29 @@ void Graph::writePrestigeDegree (const QString fileName,
 void Graph::prestigeProximity( const bool considerWeights,
                                const bool inverseWeights,
                                const bool dropIsolates){
-    qDebug()<< "Graph::prestigeProximity()";
-    if ( calculatedPP ) {
-        qDebug() << "Graph::prestigeProximity() - "
+
+    GraphTraceScope trace("Graph::prestigeProximity");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("considerWeights=%1 inverseWeights=%2 dropIsolates=%3")
+                    .arg(considerWeights).arg(inverseWeights).arg(dropIsolates) );
+    qCHotDebug(lcGraph)<< "Graph::prestigeProximity()";
+    const int cacheParameters = GraphResultCache::parameters(considerWeights, inverseWeights, dropIsolates);
+    if ( resultCacheRestore(IndexType::PP, cacheParameters) ) {
+        qCHotDebug(lcGraph) << "Graph::prestigeProximity() - "
                     " graph not changed - returning";
         return;
     }
 
-    graphDistancesGeodesic(false,considerWeights, inverseWeights,inverseWeights);
+    graphDistancesGeodesic(false,considerWeights, inverseWeights,dropIsolates);
+
+    if ( graphCancelled() ) {
+        return;
+    }
 
     // calculate centralities
-    VList::const_iterator it, jt;
+    VList::const_iterator it;
+    int i = 0;
     qreal PP=0;
-    qreal dist=0;
     qreal Ii=0;
     qreal V=vertices(dropIsolates);
     classesPP=0;
@@ -10350,11 +14106,11 @@ void Graph::prestigeProximity( const bool considerWeights,
 
     QString pMsg = tr("Computing Proximity Prestige scores. \nPlease wait ...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(V,pMsg);
+    graphProgressCreate(V,pMsg);
 
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+    for (it=m_graph.cbegin(), i=0; it!=m_graph.cend(); ++it, ++i) {
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         PP=0;
         Ii = 0;
@@ -10363,24 +14119,12 @@ void Graph::prestigeProximity( const bool considerWeights,
             continue;
         }
 
-        for (jt=m_graph.cbegin(); jt!=m_graph.cend(); ++jt){
-
-            if ( (*it)->name() == (*jt)->name() ) {
-                continue;
-            }
-            if ( ! (*jt)-> isEnabled() ) {
-                continue;
-            }
-
-            dist = (*jt)->distance( (*it)->name() );
+        // The influence domain |Ii| and the sum of distances from the actors
+        // in it have been found by the geodesic pass
+        Ii = m_geodesicDomainSize[i];
+        PP = m_geodesicDomainSum[i];
 
-            if (dist != RAND_MAX ) {
-                PP += dist;
-                Ii ++; // compute |Ii|
-            }
-        }
-
-        qDebug()<< "Graph::prestigeProximity() -  vertex"
+        qCHotDebug(lcGraph)<< "Graph::prestigeProximity() -  vertex"
                 << (*it)->name()
                 << "actors in influence domain Ii" << Ii
                 << "actors in network"<< (V-1)
@@ -10403,7 +14147,7 @@ void Graph::prestigeProximity( const bool considerWeights,
 
         resolveClasses(PP, discretePPs, classesPP);
 
-        //qDebug("PP classes = %i ", classesPP);
+        //qCHotDebug(lcGraph, "PP classes = %i ", classesPP);
         if (maxPP < PP ) {
             maxPP = PP ;
             maxNodePP=(*it)->name();
@@ -10430,13 +14174,14 @@ void Graph::prestigeProximity( const bool considerWeights,
 
     variancePP=variancePP/ V;
 
-    qDebug() << "Graph::prestigeProximity - sumPP = " << sumPP
+    qCHotDebug(lcGraph) << "Graph::prestigeProximity - sumPP = " << sumPP
              << " meanPP = " << meanPP
              << " variancePP " << variancePP;
 
-    calculatedPP=true;
+    resultCacheStore(IndexType::PP, cacheParameters);
+    m_prominenceScoreIndex.remove(IndexType::PP);
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -10455,6 +14200,9 @@ void Graph::writePrestigeProximity( const QString fileName,
                                     const bool considerWeights,
                                     const bool inverseWeights,
                                     const bool dropIsolates) {
+
+    GraphTraceScope trace("Graph::writePrestigeProximity");
+    trace.setInput( vertices(), edgesEnabled() );
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -10468,6 +14216,11 @@ void Graph::writePrestigeProximity( const QString fileName,
 
     prestigeProximity(considerWeights, inverseWeights, dropIsolates);
 
+    if ( graphCancelled() ) {
+        file.remove();
+        return;
+    }
+
     QString distImageFileName ;
 
     if ( m_reportsChartType != ChartType::None ) {
@@ -10487,7 +14240,7 @@ void Graph::writePrestigeProximity( const QString fileName,
 
     QString pMsg = tr("Writing Proximity Prestige scores to file. \nPlease wait ...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
 
     outText << htmlHead;
@@ -10555,7 +14308,7 @@ void Graph::writePrestigeProximity( const QString fileName,
 
     for (it= m_graph.cbegin(); it!= m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         rowCount++;
 
@@ -10659,7 +14412,7 @@ void Graph::writePrestigeProximity( const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -10667,16 +14420,50 @@ void Graph::writePrestigeProximity( const QString fileName,
 
 
 
+/**
+ * @brief Selects the PageRank iteration scheme.
+ * If toggle is true, prestigePageRank() uses Gauss–Seidel sweeps, which update
+ * scores in place and usually converge in fewer iterations, but run on a single
+ * thread. Otherwise it uses Jacobi (power) iterations with a parallel SpMV.
+ * @param toggle
+ */
+void Graph::setPrestigePageRankGaussSeidel(const bool &toggle) {
+    qDebug() << "Graph::setPrestigePageRankGaussSeidel() - toggle" << toggle;
+    if ( m_prestigePageRankGaussSeidel == toggle ) {
+        return;
+    }
+    m_prestigePageRankGaussSeidel = toggle;
+    m_resultCache.remove(IndexType::PRP);
+}
+
+
+
 /**
  * @brief Calculates the PageRank Prestige of each vertex
+ *
+ * Iterates PR(i) = (1-d)/N + d * ( Σ_{j->i} PR(j)/outdeg(j) + D/N ) over the
+ * inbound (transposed) rows of the CSR snapshot, where D is the total score of
+ * dangling vertices (with no outbound edges), which is redistributed uniformly.
+ * Stops when the L1 norm of the change falls below a fixed tolerance, or after
+ * a maximum number of iterations. The residual of each iteration is reported
+ * to the progress box.
+ * With Jacobi iterations the pull SpMV runs on a pool of workers, over blocks
+ * of vertices. See setPrestigePageRankGaussSeidel().
+ * If dropIsolates is true, isolated vertices take no part and keep 1/N.
  * @param dropIsolates
  */
 void Graph::prestigePageRank(const bool &dropIsolates){
 
-    qDebug()<< "Graph::prestigePageRank()";
+    GraphTraceScope trace("Graph::prestigePageRank");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("dropIsolates=%1")
+                    .arg(dropIsolates) );
+
+    qCHotDebug(lcGraph)<< "Graph::prestigePageRank()";
 
-    if ( calculatedPRP ) {
-        qDebug() << " graph not changed - return ";
+    const int cacheParameters = GraphResultCache::parameters(false, false, dropIsolates);
+    if ( resultCacheRestore(IndexType::PRP, cacheParameters) ) {
+        qCHotDebug(lcGraph) << " graph not changed - return ";
         return;
     }
 
@@ -10691,170 +14478,184 @@ void Graph::prestigePageRank(const bool &dropIsolates){
     // Google creators set d to 0.85.
     d_factor = 0.85;
 
-    qreal PRP=0, oldPRP = 0;
+    const qreal tolerance = 0.00001;   // The L1 residual where we stop the iteration
+    const int maxIterations = 1000;
+    const int blockSize = 4096;        // vertices per work item of the parallel SpMV
+
+    qreal PRP=0;
     qreal SPRP=0;
-    int iterations = 1; // a counter
-    int referrer;
-    qreal delta = 0.00001; // The delta where we will stop the iterative calculation
-    qreal maxDelta = RAND_MAX;
-    qreal sumInLinksPR = 0;  // temp var for inlinks sum PR
-    qreal transferedPRP = 0;
-    qreal inLinks = 0;       // temp var
-    qreal outLinks = 0;       // temp var
     qreal t_variance=0;
+    int iterations = 0; // a counter
+    int i = 0, e = 0;
     int N =  vertices(dropIsolates) ;
 
     VList::const_iterator it;
-    H_edges::const_iterator jt;
-
-    int relation=0;
-    bool edgeStatus=false;
-
 
     QString pMsg = tr("Computing PageRank Prestige scores. \nPlease wait ...");
     emit statusMessage( pMsg ) ;
-    emit signalProgressBoxCreate(N,pMsg);
-
+    graphProgressCreate(100,pMsg);
 
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
-
         // At first, PR scores have probability distribution
         // from 0 to 1, so each one is set to 1/N
         (*it)->setPRP( 1.0 / (qreal) N );
-
-        // compute inEdges() to warm up inEdgesConst for everyone
-        inLinks = (*it)->inEdges();
-        outLinks = (*it)->outEdges();
-        qDebug() << "Graph::prestigePageRank() - node "
-                 << (*it)->name() << " PR = " << (*it)->PRP()
-                 << " inLinks (set const): " << inLinks
-                 << " outLinks (set const): " << outLinks;
     }
 
     if ( edgesEnabled() == 0 ) {
-        qDebug()<< "Graph::prestigePageRank() "
+        qCHotDebug(lcGraph)<< "Graph::prestigePageRank() "
                 <<" - all vertices are isolated and of equal PR. Stop";
+        graphProgressKill();
         return;
     }
 
-    emit signalProgressBoxUpdate( N / 3);
-
-    // begin iteration - continue until we reach our desired delta
-    while (maxDelta > delta) {
-
-        qDebug()<< "Graph::prestigePageRank() - ITERATION : " << iterations;
-
-        sumPRP=0;
-        maxDelta = 0;
-        maxPRP=0;
-        minPRP=RAND_MAX;
-        maxNodePRP = 0;
-        minNodePRP = 0;
-
-        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it)
-        {
-            sumInLinksPR = 0;
-            oldPRP = (*it)->PRP();
-
-            qDebug() << "Graph::prestigePageRank() - computing PR for node: "
-                     << (*it)->name()  << " current PR " << oldPRP;
-
-            if ( (*it)->isIsolated() ) {
-                // isolates have constant PR = 1/N
-                qDebug() << "Graph::prestigePageRank() - isolated - CONTINUE ";
-                continue;
-            }
-
-            jt=(*it)->m_inEdges.cbegin();
+    const GraphCSR &csr = graphCSR();
+    const int V = csr.vertices();
+    const int *inOffsets = csr.inOffsets();
+    const int *inSources = csr.inSources();
 
-            qDebug() << "Graph::prestigePageRank() - Iterate over inEdges of "
-                     << (*it)->name() ;
-
-            while ( jt != (*it) -> m_inEdges.cend() )
-            {
-                relation = jt.value().first;
-                if ( relation != relationCurrent() ){
-                    ++jt;
-                    continue;
-                }
-                edgeStatus=jt.value().second.second;
-                if ( edgeStatus != true){
-                    ++jt;
-                    continue;
-                }
-
-                referrer = jt.key();
-
-                qDebug() << "Graph::prestigePageRank() - Node " << (*it)->name()
-                         << " inLinked from neighbor " << referrer  << " vpos "
-                         << vpos[referrer];
+    // The vertices taking part, and the inverse out-degree of each one
+    QVector<bool> active(V, false);
+    QVector<int> dangling;
+    vector<qreal> invOutDegree(V, 0);
+    for (it=m_graph.cbegin(), i=0; it!=m_graph.cend(); ++it, ++i) {
+        if ( ! (*it)->isEnabled() || ( dropIsolates && (*it)->isIsolated() ) ) {
+            continue;
+        }
+        active[i] = true;
+        if ( csr.outDegree(i) == 0 ) {
+            dangling << i;
+        }
+        else {
+            invOutDegree[i] = 1.0 / csr.outDegree(i);
+        }
+    }
 
-                if ( edgeExists( referrer , (*it)->name() ) )
-                {
-                    inLinks = m_graph[ vpos[referrer] ] ->inEdgesConst();
-                    outLinks = m_graph[ vpos[referrer] ]-> outEdgesConst();
+    vector<qreal> x(V, 0), y(V, 0), contrib(V, 0);
+    for (i = 0; i < V; ++i) {
+        if ( active[i] ) {
+            x[i] = 1.0 / (qreal) N;
+        }
+    }
 
-                    PRP =  m_graph[ vpos[referrer] ]->PRP();
+    const int blocks = ( V + blockSize - 1 ) / blockSize;
+    const int threads = graphWorkerThreads(blocks);
+    vector<qreal> residuals(threads, 0);
 
-                    transferedPRP = (outLinks != 0 ) ? ( PRP / outLinks ) : PRP;
+    qreal residual = RAND_MAX, firstResidual = 0, danglingSum = 0, base = 0;
 
-                    qDebug()<< "Graph::prestigePageRank() - neighbor " << referrer
-                            << " has PR = " << PRP
-                            << " and outLinks = " << outLinks
-                            << "  will transfer " << transferedPRP ;
+    // begin iteration - continue until the L1 residual drops below tolerance
+    while ( residual > tolerance && iterations < maxIterations ) {
 
-                    sumInLinksPR +=  transferedPRP;
+        iterations++;
 
+        danglingSum = 0;
+        foreach (int j, dangling) {
+            danglingSum += x[j];
+        }
+        base = ( 1.0 - d_factor ) / (qreal) N
+                + d_factor * danglingSum / (qreal) N;
+
+        if ( m_prestigePageRankGaussSeidel ) {
+            // In-place sweep: sources earlier in the order contribute their new score
+            residual = 0;
+            for (i = 0; i < V; ++i) {
+                contrib[i] = x[i] * invOutDegree[i];
+            }
+            for (i = 0; i < V; ++i) {
+                if ( ! active[i] ) {
+                    continue;
                 }
-                ++jt;
+                qreal sum = 0;
+                for (e = inOffsets[i]; e < inOffsets[i+1]; ++e) {
+                    sum += contrib[ inSources[e] ];
+                }
+                PRP = base + d_factor * sum;
+                residual += fabs( PRP - x[i] );
+                x[i] = PRP;
+                contrib[i] = PRP * invOutDegree[i];
             }
-
-            PRP = (1-d_factor) / (qreal) N + d_factor * sumInLinksPR;
-
-            (*it) -> setPRP ( PRP );
-
-            sumPRP+=PRP;
-
-            qDebug() << "Graph::prestigePageRank() - Node "
-                     << (*it)->name()
-                     << " new PR = " << PRP
-                     << " old PR was = " << oldPRP
-                     << " diff = " << fabs(PRP - oldPRP);
-
-            // calculate diff from last PageRank value for this vertex
-            // and set it to minDelta if the latter is bigger.
-
-            if ( maxDelta < fabs(PRP - oldPRP) ) {
-                maxDelta = fabs(PRP - oldPRP);
-                qDebug()<< "Graph::prestigePageRank() - Setting new maxDelta = "
-                        <<  maxDelta;
+            // Keep the scores a probability distribution
+            qreal total = 0;
+            for (i = 0; i < V; ++i) {
+                total += x[i];
+            }
+            if ( total > 0 ) {
+                for (i = 0; i < V; ++i) {
+                    x[i] /= total;
+                }
             }
-
         }
-
-        // normalize in every iteration
-
-        qDebug() << "Graph::prestigePageRank() - sumPRP for this iteration " <<
-                    sumPRP;
-
-        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
-            PRP = (*it)->PRP();
-
-            if ( PRP > maxPRP ) {
-                maxPRP = PRP;
-                maxNodePRP=(*it)->name();
+        else {
+            for (i = 0; i < V; ++i) {
+                contrib[i] = x[i] * invOutDegree[i];
             }
-            if ( PRP < minPRP ) {
-                minPRP = PRP;
-                minNodePRP=(*it)->name();
+            std::fill( residuals.begin(), residuals.end(), 0 );
+            graphParallelFor( blocks, threads, [&](const int &t, const int &block) {
+                const int first = block * blockSize;
+                const int last = qMin( V, first + blockSize );
+                qreal r = 0;
+                for (int v = first; v < last; ++v) {
+                    if ( ! active[v] ) {
+                        continue;
+                    }
+                    qreal sum = 0;
+                    for (int k = inOffsets[v]; k < inOffsets[v+1]; ++k) {
+                        sum += contrib[ inSources[k] ];
+                    }
+                    y[v] = base + d_factor * sum;
+                    r += fabs( y[v] - x[v] );
+                }
+                residuals[t] += r;
+            }, false );
+            residual = 0;
+            for (int t = 0; t < threads; ++t) {
+                residual += residuals[t];
             }
+            x.swap(y);
+        }
 
+        qCHotDebug(lcGraph)<< "Graph::prestigePageRank() - iteration" << iterations
+                << "L1 residual" << residual;
+
+        // Report progress as the share of the way, in orders of magnitude,
+        // from the first residual down to the tolerance
+        if ( iterations == 1 ) {
+            firstResidual = residual;
         }
-        iterations++;
+        if ( firstResidual > tolerance && residual > 0 ) {
+            graphProgressUpdate(
+                        qBound( 0,
+                                (int) ( 100 * log( firstResidual / residual )
+                                        / log( firstResidual / tolerance ) ),
+                                99 ) );
+        }
+        emit statusMessage( tr("Computing PageRank Prestige scores. "
+                               "Iteration %1, residual %2")
+                            .arg(iterations).arg(residual) );
     }
 
+    qCHotDebug(lcGraph)<< "Graph::prestigePageRank() - finished after" << iterations
+            << "iterations, L1 residual" << residual;
 
-    emit signalProgressBoxUpdate( 2* N / 3);
+    // store scores and find min/max PRPs
+    maxNodePRP = 0;
+    minNodePRP = 0;
+    for (it=m_graph.cbegin(), i=0; it!=m_graph.cend(); ++it, ++i) {
+        if ( ! active[i] ) {
+            continue;
+        }
+        PRP = x[i];
+        (*it)->setPRP( PRP );
+        sumPRP += PRP;
+        if ( PRP > maxPRP ) {
+            maxPRP = PRP;
+            maxNodePRP=(*it)->name();
+        }
+        if ( PRP < minPRP ) {
+            minPRP = PRP;
+            minNodePRP=(*it)->name();
+        }
+    }
 
     if (N != 0 ) {
         meanPRP = sumPRP / (qreal) N ;
@@ -10863,7 +14664,7 @@ void Graph::prestigePageRank(const bool &dropIsolates){
         meanPRP = SPRP;
     }
 
-    qDebug() << "sumPRP = " << sumPRP << "  N = " << N
+    qCHotDebug(lcGraph) << "sumPRP = " << sumPRP << "  N = " << N
              << "  meanPRP = " << meanPRP;
 
 
@@ -10880,29 +14681,25 @@ void Graph::prestigePageRank(const bool &dropIsolates){
         SPRP = PRP / maxPRP ;
         (*it)->setSPRP( SPRP );
 
-        qDebug()<< "Graph::prestigePageRank() vertex: " <<  (*it)->name()
+        qCHotDebug(lcGraph)<< "Graph::prestigePageRank() vertex: " <<  (*it)->name()
                 << " PR = " << PRP << " standard PR = " << SPRP
                 << " t_sumPRP " << t_sumPRP;
 
         t_variance = ( PRP  - meanPRP  ) ;
         t_variance *=t_variance;
-        qDebug() << "PRP " <<  (*it)->PRP() << "  t_variance "
-                 << PRP - meanPRP  << " t_variance^2" << t_variance ;
         variancePRP  += t_variance;
 
     }
 
-
-
-
-    qDebug() << "PRP' Variance   " << variancePRP   << " N " << N ;
+    qCHotDebug(lcGraph) << "PRP' Variance   " << variancePRP   << " N " << N ;
     variancePRP  = variancePRP  / (qreal) N;
-    qDebug() << "PRP' Variance: " << variancePRP   ;
+    qCHotDebug(lcGraph) << "PRP' Variance: " << variancePRP   ;
 
-    calculatedPRP= true;
+    resultCacheStore(IndexType::PRP, cacheParameters);
+    m_prominenceScoreIndex.remove(IndexType::PRP);
 
-    emit signalProgressBoxUpdate( N);
-    emit signalProgressBoxKill();
+    graphProgressUpdate( 100 );
+    graphProgressKill();
 
 
     return;
@@ -10918,6 +14715,9 @@ void Graph::prestigePageRank(const bool &dropIsolates){
  */
 void Graph::writePrestigePageRank(const QString fileName,
                                   const bool dropIsolates){
+
+    GraphTraceScope trace("Graph::writePrestigePageRank");
+    trace.setInput( vertices(), edgesEnabled() );
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -10951,7 +14751,7 @@ void Graph::writePrestigePageRank(const QString fileName,
 
     QString pMsg = tr("Writing PageRank scores to file. \nPlease wait ...");
     emit statusMessage( pMsg ) ;
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     outText.setRealNumberPrecision(m_reportsRealPrecision);
 
@@ -11033,7 +14833,7 @@ void Graph::writePrestigePageRank(const QString fileName,
 
     for (it= m_graph.cbegin(); it!= m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate( ++progressCounter );
+        graphProgressUpdate( ++progressCounter );
 
         rowCount++;
 
@@ -11141,7 +14941,7 @@ void Graph::writePrestigePageRank(const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -11153,6 +14953,9 @@ void Graph::writePrestigePageRank(const QString fileName,
 
 /**
  * @brief Adds a little universal randomness :)
+ * If a seed has been set with setRandomSeed(), m_random restarts from it,
+ * so that every random network or layout made with that seed is the same.
+ * Otherwise m_random, seeded from the clock, just goes on.
  */
 void Graph::randomizeThings()   {
     time_t now;				/* define 'now'. time_t is probably a typedef	*/
@@ -11160,6 +14963,23 @@ void Graph::randomizeThings()   {
                      * into 'now' as 'calender time' the number of seconds since  1/1/1970   	*/
 
     srand( (unsigned int ) now);
+    if ( m_randomSeed != 0 ) {
+        m_random.seed( m_randomSeed );
+    }
+}
+
+
+
+/**
+ * @brief Sets the seed of the random network generators and layouts.
+ * With a non-zero seed their output is reproducible, bit for bit.
+ * A zero seed restores the default, a time-based seed.
+ * @param seed
+ */
+void Graph::setRandomSeed(const quint64 &seed) {
+    qDebug() << "Graph::setRandomSeed() - seed" << seed;
+    m_randomSeed = seed;
+    m_random.seed( ( seed != 0 ) ? seed : (quint64) QDateTime::currentMSecsSinceEpoch() );
 }
 
 
@@ -11167,6 +14987,9 @@ void Graph::randomizeThings()   {
 
 /**
  * @brief Create an erdos-renyi random network according to the given model
+ * Both models run in O(N+E) time: G(n,p) skips geometrically over the pairs
+ * without an edge and G(n,M) samples M distinct pairs with sort-and-merge.
+ * In graph mode, each unordered pair is a single trial.
  * @param vert
  * @param model
  * @param edges
@@ -11181,7 +15004,12 @@ void Graph::randomNetErdosCreate(const int &N,
                                  const QString &mode,
                                  const bool &diag)
 {
-    qDebug() << "Graph::randomNetErdosCreate() - vertices " << N
+
+    GraphTraceScope trace("Graph::randomNetErdosCreate");
+    trace.setInput( N, m,
+                    QString("model=%1 p=%2 mode=%3 diag=%4")
+                    .arg(model).arg(p).arg(mode).arg(diag) );
+    qCHotDebug(lcGraph) << "Graph::randomNetErdosCreate() - vertices " << N
              << " model " << model
              << " edges " << m
              << " edge probability " << p
@@ -11191,25 +15019,26 @@ void Graph::randomNetErdosCreate(const int &N,
     if (mode=="graph") {
         graphSetDirected(false);
     }
-    vpos.reserve(N);
+    // Each pair is sampled at most once, thus the edges are unique
+    graphBulkBegin( N, ( model == "G(n,p)" ) ? 0 : m, true );
 
     randomizeThings();
 
     int progressCounter=0;
     int edgeCount = 0;
 
-    qDebug() << "Graph::randomNetErdosCreate() - Creating nodes...";
+    qCHotDebug(lcGraph) << "Graph::randomNetErdosCreate() - Creating nodes...";
 
     QString pMsg  = tr( "Creating Erdos-Renyi Random Network. \n"
                                " Please wait..." );
 
-    emit signalProgressBoxCreate( (m != 0 ? m:N), pMsg );
+    graphProgressCreate( (m != 0 ? m:N), pMsg );
 
     for (int i=0; i< N ; i++)
     {
         int x=canvasRandomX();
         int y=canvasRandomY();
-        qDebug("Graph: randomNetErdosCreate, new node i=%i, at x=%i, y=%i", i+1, x,y);
+        qCHotDebug(lcGraph, "Graph: randomNetErdosCreate, new node i=%i, at x=%i, y=%i", i+1, x,y);
         vertexCreate(
                     i+1, initVertexSize, initVertexColor,
                     initVertexNumberColor, initVertexNumberSize,
@@ -11218,94 +15047,134 @@ void Graph::randomNetErdosCreate(const int &N,
                     );
     }
 
-    qDebug() << "Graph::randomNetErdosCreate() - Creating edges...";
+    qCHotDebug(lcGraph) << "Graph::randomNetErdosCreate() - Creating edges...";
+
+    // Ordered pairs (v,w) are used in digraphs, unordered pairs (w<v) in graphs.
+    // Row v of the pair space holds the candidate targets w of v.
+    const bool undirected = ( mode == "graph" );
+    auto rowLength = [&](const qint64 &v) -> qint64 {
+        if ( undirected ) {
+            return diag ? v + 1 : v;
+        }
+        return diag ? N : N - 1;
+    };
+    auto createEdge = [&](const qint64 &v, qint64 w) {
+        if ( ! undirected && ! diag && w >= v ) {
+            w++;    // skip the diagonal
+        }
+        edgeCount ++ ;
+        if ( undirected ) {
+            edgeCreate(w+1, v+1, 1, initEdgeColor,
+                       EdgeType::Undirected, false, false,
+                       QString(), false);
+        }
+        else {
+            edgeCreate(v+1, w+1, 1, initEdgeColor,
+                       EdgeType::Directed, true, false,
+                       QString(), false);
+        }
+    };
+
+    qint64 pairs = 0;
+    for (qint64 v = 0; v < N; ++v) {
+        pairs += rowLength(v);
+    }
+
+    qint64 v = 0, w = -1;
+
     if ( model == "G(n,p)")
     {
-        qDebug() << "Graph::randomNetErdosCreate() - G(n,p) model...";
-        for (int i=0;i<N; i++) {
-            for (int j=0; j<N; j++) {
-                //                qDebug() << "Graph::randomNetErdosCreate() - Bernoulli trial "
-                //                       << "for edge " <<  i+1 << " -> " << j+1;
-                if (!diag && i==j) {
-                    qDebug()<< " Graph::randomNetErdosCreate() - skip because "
-                            << i+1 << " = " << j+1
-                            << " and diag " << diag;
-                    continue;
+        // Geometric skipping (Batagelj & Brandes, 2005): the gap to the next
+        // edge in the pair space is geometrically distributed, thus only the
+        // created edges cost anything.
+        qCHotDebug(lcGraph) << "Graph::randomNetErdosCreate() - G(n,p) model, pairs" << pairs;
+
+        if ( p > 0 ) {
+            const qreal logq = std::log( 1.0 - p );
+            qreal skip = 0;
+
+            while ( v < N ) {
+                skip = ( p >= 1 ) ? 0 : std::floor( std::log( 1.0 - m_random.uniform() ) / logq );
+                if ( skip >= (qreal) pairs ) {
+                    break;
                 }
-                if ( ( rand() % 100 + 1 ) / 100.0 < p )    {
-                    edgeCount ++ ;
-
-                    if (mode == "graph") {
-                        qDebug() << "Graph::randomNetErdosCreate() - "
-                                    <<" create undirected Edge no "
-                                    << edgeCount;
-                        edgeCreate(i+1, j+1, 1, initEdgeColor,
-                                   EdgeType::Undirected, false, false,
-                                   QString(), false);
-                    }
-                    else {
-                        qDebug() << "Graph::randomNetErdosCreate() - "
-                                    <<" create directed Edge no "
-                                    << edgeCount;
-
-                        edgeCreate(i+1, j+1, 1, initEdgeColor,
-                                   EdgeType::Directed, true, false,
-                                   QString(), false);
-                    }
+                w += 1 + (qint64) skip;
+                while ( v < N && w >= rowLength(v) ) {
+                    w -= rowLength(v);
+                    v++;
+                    graphProgressUpdate(++progressCounter );
+                }
+                if ( v < N ) {
+                    createEdge(v, w);
                 }
-                //                else
-                //                    qDebug() << "Graph::randomNetErdosCreate() - do not create Edge";
             }
-
-            emit signalProgressBoxUpdate(++progressCounter );
-
         }
 
     }
     else
     {
-        qDebug() << "Graph::randomNetErdosCreate() - G(n,M) model...";
-        int source = 0, target = 0 ;
-        do {
-            source =  rand() % N + 1;
-            target =  rand() % N + 1;
-            qDebug() << "Graph::randomNetErdosCreate() - random pair "
-                        << " " << source
-                        << " , " << target ;
-            if (!diag && source == target ) {
-                qDebug() << "Graph::randomNetErdosCreate() - skip self loop pair ";
-                continue;
-            }
-            if ( edgeExists(source, target) ) {
-                qDebug() << "Graph::randomNetErdosCreate() - skip pair - exists";
-                continue;
+        // Sample m distinct pair indices without a hash set: draw the missing
+        // number of indices, sort and merge them with the ones drawn so far,
+        // until m distinct indices are found. This keeps the first m distinct
+        // values of a uniform sequence, which is a uniform m-subset.
+        // Dense networks sample the pairs to leave out instead.
+        qCHotDebug(lcGraph) << "Graph::randomNetErdosCreate() - G(n,M) model, pairs" << pairs;
+
+        const qint64 edges = qBound( (qint64) 0, (qint64) m, pairs );
+        const bool complement = ( edges > pairs / 2 );
+        const qint64 samples = complement ? pairs - edges : edges;
+
+        const quint64 range = (quint64) qMax( (qint64) 1, pairs );
+        vector<qint64> sample, drawn, merged;
+        sample.reserve(samples);
+
+        while ( (qint64) sample.size() < samples ) {
+            drawn.resize( samples - sample.size() );
+            for ( qint64 &k : drawn ) {
+                k = (qint64) m_random.bounded64(range);
             }
-            edgeCount ++;
-            if (mode == "graph") {
-                qDebug() << "Graph::randomNetErdosCreate() - create "
-                            << " undirected Edge no " << edgeCount;
-                edgeCreate(source, target, 1, initEdgeColor,
-                           EdgeType::Undirected, false, false,
-                           QString(), false);
-            }
-            else {
-                qDebug() << "Graph::randomNetErdosCreate() - create "
-                            << " directed Edge no " << edgeCount;
-                edgeCreate(source, target, 1, initEdgeColor,
-                           EdgeType::Directed, true, false,
-                           QString(), false);
+            std::sort(drawn.begin(), drawn.end());
+            merged.clear();
+            std::set_union(sample.begin(), sample.end(),
+                           drawn.begin(), drawn.end(),
+                           std::back_inserter(merged));
+            merged.erase( std::unique(merged.begin(), merged.end()), merged.end() );
+            sample.swap(merged);
+        }
+
+        // Walk the sorted indices, or their complement, row by row
+        vector<qint64>::const_iterator next = sample.cbegin();
+        qint64 rowStart = 0, length = 0;
+        for ( v = 0; v < N; ++v ) {
+            length = rowLength(v);
+            for ( w = 0; w < length; ++w ) {
+                const bool sampled = ( next != sample.cend() && *next == rowStart + w );
+                if ( sampled ) {
+                    ++next;
+                }
+                if ( sampled != complement ) {
+                    createEdge(v, w);
+                    graphProgressUpdate(++progressCounter );
+                }
+                else if ( ! complement ) {
+                    // jump to the next sampled index of this row, if any
+                    if ( next == sample.cend() || *next >= rowStart + length ) {
+                        break;
+                    }
+                    w = *next - rowStart - 1;
+                }
             }
-            emit signalProgressBoxUpdate(++progressCounter );
-        } while ( edgeCount != m );
+            rowStart += length;
+        }
 
     }
 
     relationCurrentRename(tr("erdos-renyi"), true);
 
-    emit signalProgressBoxUpdate((m != 0 ? m:N));
-    emit signalProgressBoxKill();
+    graphProgressUpdate((m != 0 ? m:N));
+    graphProgressKill();
 
-    graphSetModified(GraphChange::ChangedVerticesEdges);
+    graphBulkCommit(GraphChange::ChangedVerticesEdges);
 }
 
 
@@ -11316,6 +15185,8 @@ void Graph::randomNetErdosCreate(const int &N,
 
 /**
  * @brief Creates a scale-free random-network network
+ * Every new node attaches to m distinct old nodes j, chosen with probability
+ * proportional to alpha + k_j ^ power (Barabasi-Albert preferential attachment).
  * @param N
  * @param power
  * @param m0
@@ -11330,7 +15201,12 @@ void Graph::randomNetScaleFreeCreate (const int &N,
                                       const qreal &alpha,
                                       const QString &mode)
 {
-    qDebug() << "Graph::randomNetScaleFreeCreate() - max nodes n" << N
+
+    GraphTraceScope trace("Graph::randomNetScaleFreeCreate");
+    trace.setInput( N, 0,
+                    QString("power=%1 m0=%2 m=%3 alpha=%4 mode=%5")
+                    .arg(power).arg(m0).arg(m).arg(alpha).arg(mode) );
+    qCHotDebug(lcGraph) << "Graph::randomNetScaleFreeCreate() - max nodes n" << N
              << "power" << power
              <<"edges added in every round m" <<m
             <<"alpha" <<alpha
@@ -11345,31 +15221,29 @@ void Graph::randomNetScaleFreeCreate (const int &N,
     int x=0;
     int y=0;
     int newEdges = 0;
-    double sumDegrees=0;
-    double k_j;
     double x0 = canvasWidth/2.0;
     double y0 =canvasHeight/2.0;
     double radius = canvasMaxRadius();
     double rad= (2.0* M_PI/ N );
-    double  prob_j = 0, prob=0;
     int progressCounter=0;
 
-    vpos.reserve( N );
+    // New vertices attach to distinct older ones, thus the edges are unique
+    graphBulkBegin( N, m0 * (m0-1) / 2 + (N-m0) * m, true );
 
-    qDebug() << "Graph::randomNetScaleFreeCreate() - "
+    qCHotDebug(lcGraph) << "Graph::randomNetScaleFreeCreate() - "
              << "Create initial connected net of m0 nodes";
 
     QString pMsg = tr ("Creating Scale-Free Random Network. \n"
                   "Please wait...");
     emit statusMessage(pMsg);
-    emit signalProgressBoxCreate(N, pMsg );
+    graphProgressCreate(N, pMsg );
 
 
     for (int i=0; i< m0 ; ++i) {
         x=x0 + radius * cos(i * rad);
         y=y0 + radius * sin(i * rad);
 
-        qDebug() << "Graph::randomNetScaleFreeCreate() - "
+        qCHotDebug(lcGraph) << "Graph::randomNetScaleFreeCreate() - "
                     << " initial node i " << i+1 << " pos " << x << "," << y;
         vertexCreate(
                     i+1, initVertexSize,initVertexColor,
@@ -11380,28 +15254,91 @@ void Graph::randomNetScaleFreeCreate (const int &N,
     }
 
     for (int i=0; i < m0; ++i){
-        qDebug() << "Graph::randomNetScaleFreeCreate() - "
+        qCHotDebug(lcGraph) << "Graph::randomNetScaleFreeCreate() - "
                    << " Creating all edges for initial node i " << i+1;
         for (int j=i+1; j< m0  ; ++j) {
-            qDebug() << "Graph::randomNetScaleFreeCreate() ---- "
+            qCHotDebug(lcGraph) << "Graph::randomNetScaleFreeCreate() ---- "
                         "Creating initial edge " << i+1 << " <-> " << j+1;
             edgeCreate (i+1, j+1, 1, initEdgeColor,
                         EdgeType::Undirected, false, false,
                         QString(), false);
         }
-        emit signalProgressBoxUpdate( ++progressCounter );
+        graphProgressUpdate( ++progressCounter );
     }
 
-    qDebug()<< "Graph::randomNetScaleFreeCreate() - @@@@ "
+    qCHotDebug(lcGraph)<< "Graph::randomNetScaleFreeCreate() - @@@@ "
                << " start network growth to " << N
                << " nodes with preferential attachment" ;
 
+    // The attachment weight of an old node j is alpha + k_j ^ power, where
+    // k_j is its in-degree. For power 1 we sample from the repeated endpoints
+    // array, which holds every node once per unit of in-degree, otherwise we
+    // keep the weights in a Fenwick tree. Both cost O(E) or O(E log N) in total.
+    const bool linear = ( power == 1 );
+    const int edgesPerNode = qMax( 0, m );
+    vector<int> endpoints;          // power 1: node j appears k_j times
+    vector<int> degree(N, 0);       // k_j
+    vector<qreal> tree(N + 1, 0);   // other powers: Fenwick tree of the weights
+    vector<int> chosenBy(N, -1);    // the last new node which chose j
+    vector<int> targets;
+    qreal totalWeight = 0;
+    int treeTop = 1;
+    while ( treeTop * 2 <= N ) {
+        treeTop *= 2;
+    }
+
+    auto attachmentWeight = [&](const int &j) {
+        return alpha + pow( (qreal) degree[j], power );
+    };
+    auto treeAdd = [&](int j, const qreal &delta) {
+        totalWeight += delta;
+        for ( ++j; j <= N; j += j & ( -j ) ) {
+            tree[j] += delta;
+        }
+    };
+    auto treeFind = [&](qreal r) {
+        // the node of the smallest prefix sum greater than r
+        int j = 0;
+        for ( int step = treeTop; step > 0; step /= 2 ) {
+            if ( j + step <= N && tree[j + step] <= r ) {
+                j += step;
+                r -= tree[j];
+            }
+        }
+        return j;
+    };
+    auto addDegree = [&](const int &j) {
+        const qreal before = linear ? 0 : attachmentWeight(j);
+        degree[j]++;
+        if ( linear ) {
+            endpoints.push_back(j);
+        }
+        else {
+            treeAdd( j, attachmentWeight(j) - before );
+        }
+    };
+
+
+    // The initial nodes are all connected to each other
+    if ( linear ) {
+        endpoints.reserve( (size_t) m0 * qMax(0, m0 - 1)
+                           + (size_t) ( mode == "graph" ? 2 : 1 ) * edgesPerNode * N );
+    }
+    for (int j = 0; j < m0 && j < N; ++j) {
+        if ( ! linear ) {
+            treeAdd( j, attachmentWeight(j) );
+        }
+        for (int k = 0; k < m0 - 1; ++k) {
+            addDegree(j);
+        }
+    }
+
     for (int i= m0 ; i < N ; ++i) {
 
         x=x0 + radius * cos(i * rad);
         y=y0 + radius * sin(i * rad);
 
-        qDebug() << "Graph::randomNetScaleFreeCreate() - ++++"
+        qCHotDebug(lcGraph) << "Graph::randomNetScaleFreeCreate() - ++++"
                     << " adding new node i " << i+1
                     << " pos " << x << "," << y ;
 
@@ -11412,82 +15349,76 @@ void Graph::randomNetScaleFreeCreate (const int &N,
                     QPoint(x, y), initVertexShape,initVertexIconPath, false
                     );
 
-        emit signalProgressBoxUpdate( ++progressCounter );
-
-        // need to multiply by 2, since we have a undirected graph
-        // and edgesEnabled reports edges/2
-        sumDegrees =  2 * edgesEnabled();
-
-        newEdges = 0;
-
-        qDebug()<< "Graph::randomNetScaleFreeCreate() - repeat until we reach"
-                << m << "new edges for node" <<i+1;
-        for (;;)
-        {	//do until we create m new edges
-
-            for (int j=0; j < i  ; ++j) {
-                qDebug() << "Graph::randomNetScaleFreeCreate() - "
-                           << " preferential attachment test of new node i "
-                           << i+1
-                           << " with node j " << j+1
-                           << " - newEdges " << newEdges ;
-
-                if (newEdges == m)
-                    break;
-
-                k_j = vertexDegreeIn(j+1);
-                k_j = pow ( k_j , power );
-                if (sumDegrees < 1 )
-                    prob_j = 1; // always create edge if no other edge exist
-                else
-                    prob_j = ( alpha + k_j  ) / sumDegrees ;
-
-                prob  = ( rand() % 100 + 1 ) / 100.0;
-
-                qDebug() << "Graph::randomNetScaleFreeCreate() - "
-                            << " Edge probability with old node "
-                            << j+1 << " is: alpha + k_j ^ power " << alpha + k_j
-                            << " / sumDegrees " << sumDegrees
-                            << " = prob_j " << prob_j
-                            << " prob " << prob ;
-
-                if ( prob  <=  prob_j )  {
-                    if ( mode == "graph") {
-                        qDebug() << "Graph::randomNetScaleFreeCreate()  <-----> "
-                                    "Creating pref.att. undirected edge "
-                                 <<  i+1 << " <-> " << j+1;
-                        edgeCreate (i+1, j+1, 1, initEdgeColor,
-                                    EdgeType::Undirected, false, false,
-                                    QString(), false);
-                        newEdges ++;
+        graphProgressUpdate( ++progressCounter );
+
+        // Choose m distinct old nodes, with probability proportional
+        // to their attachment weight
+        targets.clear();
+        newEdges = qMin( edgesPerNode, i );
+        const qreal uniformWeight = linear ? alpha * i : 0;
+        const qreal weights = linear ? uniformWeight + endpoints.size() : totalWeight;
+
+        int attempts = 0;
+        while ( (int) targets.size() < newEdges ) {
+            int j = 0;
+            const qreal r = m_random.uniform() * weights;
+            if ( weights <= 0 || ++attempts > 32 * newEdges ) {
+                // No edges and no alpha, or too few old nodes with non-zero
+                // weight: every old node is equally likely
+                j = (int) ( m_random.uniform() * i );
+            }
+            else if ( linear ) {
+                j = ( r < uniformWeight || endpoints.empty() )
+                        ? (int) ( m_random.uniform() * i )
+                        : endpoints[ qMin( (size_t) ( r - uniformWeight ), endpoints.size() - 1 ) ];
+            }
+            else {
+                j = treeFind(r);
+            }
+            j = qBound(0, j, i - 1);
+            if ( chosenBy[j] == i ) {
+                continue;
+            }
+            chosenBy[j] = i;
+            targets.push_back(j);
+        }
 
-                    }
-                    else {
-                        qDebug() << "Graph::randomNetScaleFreeCreate()  -----> "
-                                    "Creating pref.att. directed edge "
-                                 <<  i+1 << " <-> " << j+1;
-                        edgeCreate (i+1, j+1, 1, initEdgeColor,
-                                    EdgeType::Directed, true, false,
-                                    QString(), false);
-                        newEdges ++;
+        if ( ! linear ) {
+            treeAdd( i, attachmentWeight(i) );
+        }
 
-                    }
-                }
+        for (const int &j : targets) {
+            if ( mode == "graph") {
+                qCHotDebug(lcGraph) << "Graph::randomNetScaleFreeCreate()  <-----> "
+                            "Creating pref.att. undirected edge "
+                         <<  i+1 << " <-> " << j+1;
+                edgeCreate (i+1, j+1, 1, initEdgeColor,
+                            EdgeType::Undirected, false, false,
+                            QString(), false);
+                addDegree(i);
             }
-            if ( newEdges == m )
-                break;
+            else {
+                qCHotDebug(lcGraph) << "Graph::randomNetScaleFreeCreate()  -----> "
+                            "Creating pref.att. directed edge "
+                         <<  i+1 << " <-> " << j+1;
+                edgeCreate (i+1, j+1, 1, initEdgeColor,
+                            EdgeType::Directed, true, false,
+                            QString(), false);
+            }
+            addDegree(j);
         }
-        qDebug()<< "Graph::randomNetScaleFreeCreate() - " << m << "edges reached "
+
+        qCHotDebug(lcGraph)<< "Graph::randomNetScaleFreeCreate() - " << newEdges << "edges reached "
                 "for node" << i+1;
     }
 
     relationCurrentRename(tr("scale-free"),true);
-    qDebug() << "Graph::randomNetScaleFreeCreate() - finished. Calling "
-                "graphSetModified()";
+    qCHotDebug(lcGraph) << "Graph::randomNetScaleFreeCreate() - finished. Calling "
+                "graphBulkCommit()";
 
-    graphSetModified(GraphChange::ChangedVerticesEdges);
+    graphBulkCommit(GraphChange::ChangedVerticesEdges);
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
     layoutVertexSizeByIndegree();
 
@@ -11505,7 +15436,12 @@ void Graph::randomNetScaleFreeCreate (const int &N,
 void Graph::randomNetSmallWorldCreate (const int &N, const int &degree,
                                        const double &beta, const QString &mode)
 {
-    qDebug() << "Graph:randomNetSmallWorldCreate() -. "
+
+    GraphTraceScope trace("Graph::randomNetSmallWorldCreate");
+    trace.setInput( N, 0,
+                    QString("degree=%1 beta=%2 mode=%3")
+                    .arg(degree).arg(beta).arg(mode) );
+    qCHotDebug(lcGraph) << "Graph:randomNetSmallWorldCreate() -. "
              << "vertices: " << N
              << "degree: " << degree
              << "beta: " << beta
@@ -11516,38 +15452,41 @@ void Graph::randomNetSmallWorldCreate (const int &N, const int &degree,
         graphSetDirected(false);
     }
 
+    // The rewiring joins the ring lattice in one bulk build
+    graphBulkBegin( N, N * (degree/2) );
+
     randomNetRingLatticeCreate(N, degree, true);
 
     QString pMsg  = tr("Creating Small-World Random Network. \n"
                        "Please wait ...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N, pMsg);
+    graphProgressCreate(N, pMsg);
 
-    qDebug("******** Graph: REWIRING starts...");
+    qCHotDebug(lcGraph, "******** Graph: REWIRING starts...");
 
     int candidate=0;
     int progressCounter=1;
 
     for (int i=1;i<N; i++) {
         for (int j=i+1;j<N; j++) {
-            qDebug()<<">>>>> REWIRING: Check if  "<< i << " is linked to " << j;
+            qCHotDebug(lcGraph)<<">>>>> REWIRING: Check if  "<< i << " is linked to " << j;
             if ( edgeExists(i, j) ) {
-                qDebug()<<">>>>> REWIRING: They're linked. Do a random REWIRING "
+                qCHotDebug(lcGraph)<<">>>>> REWIRING: They're linked. Do a random REWIRING "
                           "Experiment between "<< i<< " and " << j
                        << " Beta parameter is " << beta;
-                if (rand() % 100 < (beta * 100))  {
-                    qDebug(">>>>> REWIRING: We'l break this edge!");
+                if (m_random.bounded(100) < (beta * 100))  {
+                    qCHotDebug(lcGraph, ">>>>> REWIRING: We'l break this edge!");
                     edgeRemove(i, j, true);
-                    qDebug()<<">>>>> REWIRING: OK. Let's create a new edge!";
+                    qCHotDebug(lcGraph)<<">>>>> REWIRING: OK. Let's create a new edge!";
                     for (;;) {	//do until we create a new edge
-                        candidate=rand() % (N+1) ;		//pick another vertex.
+                        candidate=m_random.bounded(N+1) ;		//pick another vertex.
                         if (candidate == 0 || candidate == i) continue;
-                        qDebug()<<">>>>> REWIRING: Candidate: "<< candidate;
+                        qCHotDebug(lcGraph)<<">>>>> REWIRING: Candidate: "<< candidate;
                         //Only if differs from i and hasnot edge with it
                         if (  edgeExists(i, candidate) == 0)
-                            qDebug("<----> Random New Edge Experiment between %i and %i:", i, candidate);
-                        if (rand() % 100 > 0.5) {
-                            qDebug("Creating new link!");
+                            qCHotDebug(lcGraph, "<----> Random New Edge Experiment between %i and %i:", i, candidate);
+                        if (m_random.bounded(100) > 0.5) {
+                            qCHotDebug(lcGraph, "Creating new link!");
                             edgeCreate(i, candidate, 1, initEdgeColor,
                                        EdgeType::Undirected, false, false,
                                        QString(), false);
@@ -11558,17 +15497,17 @@ void Graph::randomNetSmallWorldCreate (const int &N, const int &degree,
                 else  qDebug("Will not break link!");
             }
         }
-        emit signalProgressBoxUpdate( ++progressCounter );
+        graphProgressUpdate( ++progressCounter );
     }
 
     relationCurrentRename(tr("small-world"), true);
 
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
-    layoutVertexSizeByIndegree();
+    graphBulkCommit(GraphChange::ChangedVerticesEdges);
 
-    graphSetModified(GraphChange::ChangedVerticesEdges);
+    layoutVertexSizeByIndegree();
 }
 
 
@@ -11584,7 +15523,12 @@ void Graph::randomNetSmallWorldCreate (const int &N, const int &degree,
 void Graph::randomNetRegularCreate(const int &N,
                                    const int &degree,
                                    const QString &mode, const bool &diag){
-    qDebug() << "Graph::randomNetRegularCreate()";
+
+    GraphTraceScope trace("Graph::randomNetRegularCreate");
+    trace.setInput( N, 0,
+                    QString("degree=%1 mode=%2 diag=%3")
+                    .arg(degree).arg(mode).arg(diag) );
+    qCHotDebug(lcGraph) << "Graph::randomNetRegularCreate()";
     Q_UNUSED(diag);
 
     if (mode=="graph") {
@@ -11603,19 +15547,19 @@ void Graph::randomNetRegularCreate(const int &N,
 
 
     randomizeThings();
-    vpos.reserve(N);
+    graphBulkBegin( N, N * degree );
 
     QString pMsg = tr( "Creating pseudo-random d-regular network. \n"
                        "Please wait..." );
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate (N, pMsg );
+    graphProgressCreate(N, pMsg );
 
-    qDebug()<< "Graph::randomNetRegularCreate() - creating vertices";
+    qCHotDebug(lcGraph)<< "Graph::randomNetRegularCreate() - creating vertices";
 
     for (int i=0; i< N ; i++) {
         x=canvasRandomX();
         y=canvasRandomY();
-        qDebug() << "Graph::randomNetRegularCreate() - creating new vertex at "
+        qCHotDebug(lcGraph) << "Graph::randomNetRegularCreate() - creating new vertex at "
                     << x << "," << y;
 
         vertexCreate(
@@ -11627,16 +15571,16 @@ void Graph::randomNetRegularCreate(const int &N,
     }
 
 
-    qDebug()<< "Graph::randomNetRegularCreate() - Creating initial edges";
+    qCHotDebug(lcGraph)<< "Graph::randomNetRegularCreate() - Creating initial edges";
     if (mode=="graph") {
         for (int i=0;i<N; i++){
-            qDebug()<< "Graph::randomNetRegularCreate() - "
+            qCHotDebug(lcGraph)<< "Graph::randomNetRegularCreate() - "
                        "Creating undirected edges for node  "<< i+1;
             for (int j=0; j< degree/2 ; j++) {
                 target = i + j+1 ;
                 if ( target > (N-1))
                     target = target-N;
-                qDebug()<< "Graph::randomNetRegularCreate() - undirected edge "
+                qCHotDebug(lcGraph)<< "Graph::randomNetRegularCreate() - undirected edge "
                         << i+1 << "<->"<< target+1;
                 m_edges.append(QString::number(i+1)+"->"+QString::number(target+1));
                 edgeCount ++;
@@ -11646,14 +15590,14 @@ void Graph::randomNetRegularCreate(const int &N,
     }
     else {
         for (int i=0;i<N; i++){
-            qDebug()<< "Graph::randomNetRegularCreate() - "
+            qCHotDebug(lcGraph)<< "Graph::randomNetRegularCreate() - "
                        "Creating directed edges for node  "
                     << i+1;
             for (int j=0; j< degree ; j++) {
                 target = i + j+1 ;
                 if ( target > (N-1))
                     target = target-N;
-                qDebug()<< "Graph::randomNetRegularCreate() - directed edge "
+                qCHotDebug(lcGraph)<< "Graph::randomNetRegularCreate() - directed edge "
                         << i+1 << "->"<< target+1;
                 m_edges.append(QString::number(i+1)+"->"+QString::number(target+1));
                 edgeCount ++;
@@ -11661,7 +15605,7 @@ void Graph::randomNetRegularCreate(const int &N,
         }
 
     }
-    qDebug()<< "Graph::randomNetRegularCreate() - Edges created:" << edgeCount
+    qCHotDebug(lcGraph)<< "Graph::randomNetRegularCreate() - Edges created:" << edgeCount
             << "Edge list count:" << m_edges.size()
             << "Now reordering all edges in pairs...";
 
@@ -11686,19 +15630,19 @@ void Graph::randomNetRegularCreate(const int &N,
                (graphIsUndirected() && m_edges.contains( secondEdgeVertices[1] + "->" + firstEdgeVertices[0]) )||
                (graphIsUndirected() && m_edges.contains( firstEdgeVertices[1] + "->" + secondEdgeVertices[0] ) ) ) {
 
-            firstEdge = m_edges.at(rand() % m_edges.size()) ;
+            firstEdge = m_edges.at(m_random.bounded(m_edges.size())) ;
             firstEdgeVertices = firstEdge.split("->");
-            secondEdge = m_edges.at(rand() % m_edges.size()) ;
+            secondEdge = m_edges.at(m_random.bounded(m_edges.size())) ;
             secondEdgeVertices = secondEdge.split("->");
-            qDebug()<< "Graph::randomNetRegularCreate() - firstEdgeVertices:"
+            qCHotDebug(lcGraph)<< "Graph::randomNetRegularCreate() - firstEdgeVertices:"
                     << firstEdgeVertices
                     << " secondEdgeVertices:" << secondEdgeVertices;
         }
-        qDebug()<< "Graph::randomNetRegularCreate() - removing edges:"
+        qCHotDebug(lcGraph)<< "Graph::randomNetRegularCreate() - removing edges:"
                 <<firstEdge << secondEdge;
         m_edges.removeAll(firstEdge);
         m_edges.removeAll(secondEdge);
-        qDebug()<< "Graph::randomNetRegularCreate() - 2 edges deleted for reordering:"
+        qCHotDebug(lcGraph)<< "Graph::randomNetRegularCreate() - 2 edges deleted for reordering:"
                 << firstEdgeVertices[0] << "->" << firstEdgeVertices[1]
                 << "and"
                 << secondEdgeVertices[0] << "->" << secondEdgeVertices[1]
@@ -11706,7 +15650,7 @@ void Graph::randomNetRegularCreate(const int &N,
 
         m_edges.append( firstEdgeVertices[0]+"->"+secondEdgeVertices[1]);
         m_edges.append(secondEdgeVertices[0]+"->"+firstEdgeVertices[1]);
-        qDebug()<< "Graph::randomNetRegularCreate() - 2 new edges added:"
+        qCHotDebug(lcGraph)<< "Graph::randomNetRegularCreate() - 2 new edges added:"
                 << firstEdgeVertices[0] << "->" << secondEdgeVertices[1]
                 <<"and"
                 << secondEdgeVertices[0]<<"->"<<firstEdgeVertices[1]
@@ -11719,7 +15663,7 @@ void Graph::randomNetRegularCreate(const int &N,
     for (int i = 0; i < m_edges.size(); ++i) {
 
         m_edge = m_edges.at(i).split("->");
-        qDebug() << "Graph::randomNetRegularCreate() -"
+        qCHotDebug(lcGraph) << "Graph::randomNetRegularCreate() -"
                  << "Drawing undirected Edge no" << edgeCount << ":"
                  << m_edge[0].toInt(0) << "<->" << m_edge[1].toInt(0);
 
@@ -11731,21 +15675,21 @@ void Graph::randomNetRegularCreate(const int &N,
                 QString(), false);
         edgeCount++;
         progressCounter +=progressFraction;
-        qDebug() << "Graph::randomNetRegularCreate() -"
+        qCHotDebug(lcGraph) << "Graph::randomNetRegularCreate() -"
                     << "progressCounter " << progressCounter
                     << "fmod ( progressCounter, 1.0) = "
                  << fmod ( progressCounter, 1.0);
         if ( fmod ( progressCounter, 1.0) == 0) {
-            emit signalProgressBoxUpdate( (int) progressCounter );
+            graphProgressUpdate( (int) progressCounter );
         }
 
     }
 
     relationCurrentRename(tr("d-regular"), true);
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
-    graphSetModified(GraphChange::ChangedVerticesEdges);
+    graphBulkCommit(GraphChange::ChangedVerticesEdges);
 
 }
 
@@ -11764,7 +15708,12 @@ void Graph::randomNetRegularCreate(const int &N,
 void Graph::randomNetRingLatticeCreate(const int &N, const int &degree,
                                        const bool updateProgress)
 {
-    qDebug()<< "Graph::createRingLatticeNetwork()";
+
+    GraphTraceScope trace("Graph::randomNetRingLatticeCreate");
+    trace.setInput( N, 0,
+                    QString("degree=%1")
+                    .arg(degree) );
+    qCHotDebug(lcGraph)<< "Graph::createRingLatticeNetwork()";
     int x=0;
     int y=0;
     int progressCounter=0;
@@ -11778,12 +15727,14 @@ void Graph::randomNetRingLatticeCreate(const int &N, const int &degree,
 
     randomizeThings();
 
-    vpos.reserve(N);
+    graphBulkBegin( N, N * (degree/2) );
 
-    QString pMsg  = tr( "Creating ring-lattice network. \n"
-                        "Please wait..." );
-    emit statusMessage( pMsg );
-    emit signalProgressBoxCreate (N, pMsg );
+    if (updateProgress) {
+        QString pMsg  = tr( "Creating ring-lattice network. \n"
+                            "Please wait..." );
+        emit statusMessage( pMsg );
+        graphProgressCreate(N, pMsg );
+    }
 
     for (int i=0; i< N ; i++) {
         x=x0 + radius * cos(i * rad);
@@ -11792,31 +15743,31 @@ void Graph::randomNetRingLatticeCreate(const int &N, const int &degree,
                       initVertexNumberColor, initVertexNumberSize,
                       QString::number (i+1), initVertexLabelColor,  initVertexLabelSize,
                       QPoint(x, y), initVertexShape, initVertexIconPath, false);
-        qDebug("Graph::createRingLatticeNetwork(): new node i=%i, at x=%i, y=%i", i+1, x,y);
+        qCHotDebug(lcGraph, "Graph::createRingLatticeNetwork(): new node i=%i, at x=%i, y=%i", i+1, x,y);
     }
     int target = 0;
     for (int i=0;i<N; i++){
-        qDebug("Creating links for node %i = ", i+1);
+        qCHotDebug(lcGraph, "Creating links for node %i = ", i+1);
         for (int j=0; j< degree/2 ; j++) {
             target = i + j+1 ;
             if ( target > (N-1))
                 target = target-N;
-            qDebug("Creating Link between %i  and %i", i+1, target+1);
+            qCHotDebug(lcGraph, "Creating Link between %i  and %i", i+1, target+1);
             edgeCreate(i+1, target+1, 1, initEdgeColor,
                        EdgeType::Undirected, false, false,
                        QString(), false);
         }
         if (updateProgress) {
-            emit signalProgressBoxUpdate( ++progressCounter );
+            graphProgressUpdate( ++progressCounter );
         }
     }
 
     if (updateProgress) {
         relationCurrentRename(tr("ring-lattice"), true);
-        emit signalProgressBoxKill();
+        graphProgressKill();
     }
 
-    graphSetModified(GraphChange::ChangedVerticesEdges, updateProgress);
+    graphBulkCommit(GraphChange::ChangedVerticesEdges, updateProgress);
 
 }
 
@@ -11841,7 +15792,14 @@ void Graph::randomNetLatticeCreate(const int &N,
                                    const int &neighborhoodLength,
                                    const QString &mode,
                                    const bool &circular){
-    qDebug() << "Graph::randomNetLatticeCreate()";
+
+    GraphTraceScope trace("Graph::randomNetLatticeCreate");
+    trace.setInput( N, 0,
+                    QString("length=%1 dimension=%2 neighborhoodLength=%3 mode=%4 "
+                            "circular=%5")
+                    .arg(length).arg(dimension).arg(neighborhoodLength).arg(mode)
+                    .arg(circular) );
+    qCHotDebug(lcGraph) << "Graph::randomNetLatticeCreate()";
     Q_UNUSED(circular);
     Q_UNUSED(dimension);
     if (mode=="graph") {
@@ -11867,23 +15825,23 @@ void Graph::randomNetLatticeCreate(const int &N,
 
     randomizeThings();
 
-    vpos.reserve(N);
+    graphBulkBegin( N, N * neighborhoodLength * 2 );
 
     QString pMsg = tr( "Creating lattice network. \n"
                        "Please wait..." );
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate (N, pMsg );
+    graphProgressCreate(N, pMsg );
 
 
     // create vertices
 
-    qDebug()<< "Graph::randomNetLatticeCreate() - creating vertices";
+    qCHotDebug(lcGraph)<< "Graph::randomNetLatticeCreate() - creating vertices";
 
     nCount = 0;
     canvasPadding = 20;
     nodeHPadding= ( canvasWidth )  / (double) ( length + 2);
     nodeVPadding= ( canvasHeight ) / (double) ( length + 2);
-    qDebug()<< "Graph::randomNetLatticeCreate() - "
+    qCHotDebug(lcGraph)<< "Graph::randomNetLatticeCreate() - "
                "canvasPadding" << canvasPadding
             << "nodeHPadding"<<nodeHPadding;
     for (int i=0; i < length ; i++) {
@@ -11896,7 +15854,7 @@ void Graph::randomNetLatticeCreate(const int &N,
             // compute horizontal pos
             x = canvasPadding + nodeHPadding * (j+1) ;
 
-            qDebug() << "Graph::randomNetLatticeCreate() - creating new vertex at"
+            qCHotDebug(lcGraph) << "Graph::randomNetLatticeCreate() - creating new vertex at"
                      << x << "," << y;
 
             // create vertex
@@ -11918,7 +15876,7 @@ void Graph::randomNetLatticeCreate(const int &N,
 
     // create edges
 
-    qDebug()<< "Graph::randomNetLatticeCreate() - Creating edges";
+    qCHotDebug(lcGraph)<< "Graph::randomNetLatticeCreate() - Creating edges";
 
     if (mode=="graph") {
 
@@ -11926,7 +15884,7 @@ void Graph::randomNetLatticeCreate(const int &N,
 
         for (int i=1;i<=N; i++){
 
-            qDebug()<< "Graph::randomNetLatticeCreate() - "
+            qCHotDebug(lcGraph)<< "Graph::randomNetLatticeCreate() - "
                        "Creating undirected edges for node  "<< i;
 
             for (int j=1; j< neighborhoodLength+1 ; j++) {
@@ -11940,31 +15898,31 @@ void Graph::randomNetLatticeCreate(const int &N,
 
 
                         if ( i % length == 0  && target == i + 1) {
-                            qDebug()<< "Graph::randomNetLatticeCreate() - "
+                            qCHotDebug(lcGraph)<< "Graph::randomNetLatticeCreate() - "
                                     << i << "<->"<< target << "OOB RIGHT";
 
                             continue;
                         }
                         if ( i % length == 1  && target == i - 1) {
-                            qDebug()<< "Graph::randomNetLatticeCreate() - "
+                            qCHotDebug(lcGraph)<< "Graph::randomNetLatticeCreate() - "
                                     << i << "<->"<< target << "OOB LEFT";
 
                             continue;
                         }
                         if ( target > N  ) {
-                            qDebug()<< "Graph::randomNetLatticeCreate() - "
+                            qCHotDebug(lcGraph)<< "Graph::randomNetLatticeCreate() - "
                                     << i << "<->"<< target << "OOB DOWN";
                             target = target % N ;
                             continue;
                         }
 
                         if ( target < 1 ) {
-                            qDebug()<< "Graph::randomNetLatticeCreate() - "
+                            qCHotDebug(lcGraph)<< "Graph::randomNetLatticeCreate() - "
                                     << i << "<->"<< target << "OOB UP";
                             target =  N - target ;
                             continue;
                         }
-                        qDebug()<< "Graph::randomNetLatticeCreate() - "
+                        qCHotDebug(lcGraph)<< "Graph::randomNetLatticeCreate() - "
                                 << i << "<->"<< target << "OK";
                         edge = QString::number(i)+"<->"+QString::number(target);
                         oppEdge = QString::number(i)+"<->"+QString::number(target);
@@ -12010,7 +15968,7 @@ void Graph::randomNetLatticeCreate(const int &N,
     for (int i = 0; i < latticeEdges.size(); ++i) {
 
         m_edge = latticeEdges.at(i).split("<->");
-        qDebug() << "Graph::randomNetLatticeCreate() -"
+        qCHotDebug(lcGraph) << "Graph::randomNetLatticeCreate() -"
                  << "Drawing undirected Edge no" << i + 1 << ":"
                  << m_edge[0].toInt(0) << "<->" << m_edge[1].toInt(0);
 
@@ -12022,37 +15980,305 @@ void Graph::randomNetLatticeCreate(const int &N,
                 QString(), false);
         //        edgeCount++;
         progressCounter +=progressFraction;
-        //        qDebug() << "Graph::randomNetLatticeCreate() -"
+        //        qCHotDebug(lcGraph) << "Graph::randomNetLatticeCreate() -"
         //                    << "progressCounter " << progressCounter
         //                    << "fmod ( progressCounter, 1.0) = "
         //                 << fmod ( progressCounter, 1.0);
         //        if ( fmod ( progressCounter, 1.0) == 0) {
-        //            emit signalProgressBoxUpdate( (int) progressCounter );
+        //            graphProgressUpdate( (int) progressCounter );
         //        }
 
     }
 
     relationCurrentRename(tr("lattice"), true);
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
+
+    graphBulkCommit(GraphChange::ChangedVerticesEdges);
+
+}
+
+
+
+
+/**
+ * @brief Calculates and returns the number of walks of a given length between v1 and v2
+ * Only the row of v1 is computed, with length sparse matrix-vector products.
+ * @param v1
+ * @param v2
+ * @param length
+ * @return
+ */
+int Graph::walksBetween(int v1, int v2, int length) {
+    graphMatrixAdjacencySparseCreate(false, true, false, false);
+
+    // the SAM index of a vertex is its position among the enabled vertices
+    int i = -1, j = -1, index = 0;
+    VList::const_iterator it;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
+        if ( ! (*it)->isEnabled() ) {
+            continue;
+        }
+        if ( (*it)->name() == v1 ) {
+            i = index;
+        }
+        if ( (*it)->name() == v2 ) {
+            j = index;
+        }
+        ++index;
+    }
+    if ( i < 0 || j < 0 ) {
+        return 0;
+    }
+
+    QVector<qreal> walks;
+    graphWalksRow(i, length, walks);
+    return walks[j];
+}
+
+
+
+/**
+ * @brief Walks engine: computes row (or column) index of A^length, or of
+ * A + A^2 + ... + A^length if cumulative is true, where A = SAM.
+ * It takes length sparse matrix-vector products, x <- x A for a row or
+ * x <- A x for a column, starting from the unit vector e_index.
+ * Time O(length * E) and memory O(N). Thread-safe, it only reads SAM, which
+ * must have been created by graphMatrixAdjacencySparseCreate().
+ * @param index
+ * @param length
+ * @param walks
+ * @param cumulative
+ * @param column
+ */
+void Graph::graphWalksVector(const int &index,
+                             const int &length,
+                             QVector<qreal> &walks,
+                             const bool &cumulative,
+                             const bool &column) const {
+    const int N = SAM.rows();
+    QVector<qreal> x(N, 0), y(N, 0);
+    x[index] = 1;
+    walks.fill(0, N);
+    for (int step = 1; step <= length; ++step) {
+        SAM.productByVector(x.constData(), y.data(), !column);
+        x.swap(y);
+        if ( cumulative ) {
+            for (int k = 0; k < N; ++k) {
+                walks[k] += x[k];
+            }
+        }
+    }
+    if ( ! cumulative ) {
+        walks.swap(x);
+    }
+}
+
+
+
+/**
+ * @brief Computes row i of the walks matrix: walks[j] is the number of walks
+ * of length from i to j, or of any length up to length if cumulative.
+ * See graphWalksVector().
+ * @param row
+ * @param length
+ * @param walks
+ * @param cumulative
+ */
+void Graph::graphWalksRow(const int &row,
+                          const int &length,
+                          QVector<qreal> &walks,
+                          const bool &cumulative) const {
+    graphWalksVector(row, length, walks, cumulative, false);
+}
+
 
-    graphSetModified(GraphChange::ChangedVerticesEdges);
 
+/**
+ * @brief Computes column j of the walks matrix: walks[i] is the number of
+ * walks of length from i to j, or of any length up to length if cumulative.
+ * See graphWalksVector().
+ * @param column
+ * @param length
+ * @param walks
+ * @param cumulative
+ */
+void Graph::graphWalksColumn(const int &column,
+                             const int &length,
+                             QVector<qreal> &walks,
+                             const bool &cumulative) const {
+    graphWalksVector(column, length, walks, cumulative, true);
+}
+
+
+
+/**
+ * @brief Computes the rows of the walks matrix in order and hands each one to
+ * consumer(row, walks), so that they can be written out without ever holding
+ * the whole N x N matrix. Rows are computed in parallel, a batch at a time.
+ * Emits signalProgressBoxUpdate with the number of rows done.
+ * SAM must have been created by graphMatrixAdjacencySparseCreate().
+ * @param length
+ * @param cumulative
+ * @param consumer
+ */
+void Graph::graphWalksRowsStream(const int &length,
+                                 const bool &cumulative,
+                                 const std::function<void (const int &, const QVector<qreal> &)> &consumer) {
+    const int N = SAM.rows();
+    const int batch = 64;
+    QVector< QVector<qreal> > rows(batch);
+
+    qDebug() << "Graph::graphWalksRowsStream() - length" << length
+             << "cumulative" << cumulative << "rows" << N;
+
+    for (int first = 0; first < N; first += batch) {
+        const int count = qMin(batch, N - first);
+        graphParallelFor(count, graphWorkerThreads(count),
+                         [&](const int &worker, const int &item) {
+            Q_UNUSED(worker);
+            graphWalksRow(first + item, length, rows[item], cumulative);
+        }, false);
+        for (int r = 0; r < count; ++r) {
+            consumer(first + r, rows[r]);
+        }
+        graphProgressUpdate(first + count);
+    }
 }
 
 
 
+/**
+ * @brief Streams the walks matrix to outText, row by row, as plain text
+ * (htmlTable=false) or as an HTML table like writeMatrixHTMLTable().
+ * If length > 0, it writes the Walks of given length matrix, otherwise the
+ * Total Walks matrix of all lengths up to N-1.
+ * The value range is written after the matrix, since it is only known then.
+ * @param outText
+ * @param length
+ * @param htmlTable
+ */
+void Graph::writeWalksMatrixStream(QTextStream &outText,
+                                   const int &length,
+                                   const bool &htmlTable) {
+
+    graphMatrixAdjacencySparseCreate(false, true, false, false);
+
+    const int N = SAM.rows();
+    const bool cumulative = ( length <= 0 );
+    const int steps = ( cumulative ) ? N - 1 : length;
+    const int fieldWidth = 13;
+
+    // walks are sums of products of weights, so integers iff all weights are
+    bool hasRealNumbers = false;
+    for (int e = 0; e < SAM.nonZeros(); ++e) {
+        if ( fmod( SAM.value(e), 1.0 ) != 0 ) {
+            hasRealNumbers = true;
+            break;
+        }
+    }
+    qreal maxVal = 0, minVal = RAND_MAX;
+
+    QVector<int> names;
+    names.reserve(N);
+    VList::const_iterator it;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
+        if ( (*it)->isEnabled() ) {
+            names << (*it)->name();
+        }
+    }
+
+    QString pMsg = tr("Computing and writing walks matrix. \nPlease wait...");
+    emit statusMessage( pMsg );
+    graphProgressCreate(N, pMsg );
+
+    outText <<  ( (hasRealNumbers) ? qSetRealNumberPrecision(3) : qSetRealNumberPrecision(0) ) ;
+
+    if ( htmlTable ) {
+        outText << "<table  border=\"1\" cellspacing=\"0\" cellpadding=\"0\" class=\"stripes\">"
+                << "<thead>"
+                << "<tr>"
+                << "<th>"
+                << tr("<sub>Actor</sup>/<sup>Actor</sup>")
+                << "</th>";
+        for (int j = 0; j < N; ++j) {
+            outText <<"<th>" << names[j] << "</th>";
+        }
+        outText << "</tr>"
+                << "</thead>"
+                << "<tbody>";
+    }
+    else {
+        outText << qSetFieldWidth(0) << endl ;
+        outText << "- Values:        "
+                << ( (hasRealNumbers) ? ("real numbers (printed decimals 3)") : ("integers only" ) )
+                << endl << endl;
+        outText << qSetFieldWidth(7) << fixed << right << "v"<< qSetFieldWidth(3) << "" ;
+        for (int j = 0; j < N; ++j) {
+            outText << qSetFieldWidth(fieldWidth) << fixed << (j+1);
+        }
+        outText << qSetFieldWidth(0) << endl;
+        outText << qSetFieldWidth(7)<< endl;
+    }
+
+    graphWalksRowsStream(steps, cumulative,
+                         [&](const int &i, const QVector<qreal> &walks) {
+        if ( htmlTable ) {
+            outText << "<tr class=" << (((i+1)%2==0) ? "even" :"odd" )<< ">";
+            outText <<"<td class=\"header\">" << names[i] << "</td>";
+        }
+        else {
+            outText << qSetFieldWidth(7) << fixed << right << (i+1)
+                    << qSetFieldWidth(3) <<"" ;
+        }
+        for (int j = 0; j < N; ++j) {
+            const qreal element = walks[j];
+            maxVal = qMax(maxVal, element);
+            minVal = qMin(minVal, element);
+            if ( htmlTable ) {
+                outText << fixed << right;
+                outText <<"<td" << ( (i == j) ? " class=\"diag\">" : ">")
+                        << element << "</td>";
+            }
+            else {
+                outText << qSetFieldWidth(fieldWidth) << fixed << right << element;
+            }
+        }
+        if ( htmlTable ) {
+            outText <<"</tr>";
+        }
+        else {
+            outText << qSetFieldWidth(0) << endl;
+        }
+    });
+
+    if ( htmlTable ) {
+        outText << "</tbody></table>";
+        outText << qSetFieldWidth(0) << endl ;
+        outText << "<p>"
+                << "<span class=\"info\">"
+                << ("Values: ")
+                <<"</span>"
+                << ( (hasRealNumbers) ? ("real numbers (printed decimals 3)") : ("integers only" ) )
+                << "<br />"
+                << "<span class=\"info\">"
+                << ("- Max value: ")
+                <<"</span>"
+                << QString::number(maxVal)
+                << "<br />"
+                << "<span class=\"info\">"
+                << ("- Min value: ")
+                <<"</span>"
+                << QString::number(minVal)
+                << "</p>";
+    }
+    else {
+        outText << qSetFieldWidth(0) << endl;
+        outText << "- Max value:  " << maxVal << endl;
+        outText << "- Min value:   " << minVal << endl;
+    }
 
-/**
- * @brief Calculates and returns the number of walks of a given length between v1 and v2
- * @param v1
- * @param v2
- * @param length
- * @return
- */
-int Graph::walksBetween(int v1, int v2, int length) {
-    graphWalksMatrixCreate(length);
-    return XM.item(v1-1,v2-1);
+    graphProgressKill();
 }
 
 
@@ -12060,6 +16286,9 @@ int Graph::walksBetween(int v1, int v2, int length) {
 
 /**
  * @brief Computes either the "Walks of given length" or the "Total Walks" matrix.
+ * This builds the whole N x N result in XM or XSM; the reports and
+ * walksBetween() use the row-at-a-time walks engine instead,
+ * see graphWalksVector() and writeWalksMatrixStream().
  * If length>0, it computes the Walks of given length matrix, XM=AM^l
  * where each element (i,j) denotes the number of walks of length l between vertex i and j.
  * If length=0, it computes the Total Walks matrix, XSM=Sum{AM^n} where each (i,j)
@@ -12074,13 +16303,20 @@ void Graph::graphWalksMatrixCreate(const int &N,
                                    const int &length,
                                    const bool &updateProgress) {
 
+    GraphTraceScope trace("Graph::graphWalksMatrixCreate");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("N=%1 length=%2")
+                    .arg(N).arg(length) );
+
     bool dropIsolates=false;
     bool considerWeights=true;
     bool inverseWeights=false;
     bool symmetrize=false;
 
 
-    graphMatrixAdjacencyCreate(dropIsolates, considerWeights, inverseWeights, symmetrize);
+    // Walks of a given length can be counted with sparse products
+    graphMatrixAdjacencyCreate(dropIsolates, considerWeights, inverseWeights, symmetrize,
+                               (length > 0) );
 
     if (length>0) {
         qDebug()<< "Graph::graphWalksMatrixCreate() - "
@@ -12089,13 +16325,18 @@ void Graph::graphWalksMatrixCreate(const int &N,
         QString pMsg = tr("Computing walks of length %1. \nPlease wait...").arg(length) ;
         emit statusMessage( pMsg  );
         if (updateProgress) {
-            signalProgressBoxCreate(length,pMsg);
+            graphProgressCreate(length,pMsg);
         }
 
-        XM = AM.pow(length, false);
+        if ( m_graphMatrixAdjacencySparse ) {
+            SAM.pow(length).toDense(XM);
+        }
+        else {
+            AM.pow(XM, length, false);
+        }
 
         if (updateProgress) {
-            emit signalProgressBoxUpdate (length);
+            graphProgressUpdate(length);
         }
 
 
@@ -12112,16 +16353,19 @@ void Graph::graphWalksMatrixCreate(const int &N,
         QString pMsg = tr("Computing sociomatrix powers up to %1. \nPlease wait...").arg(N-1) ;
         emit statusMessage( pMsg  );
         if (updateProgress) {
-            signalProgressBoxCreate(N-1,pMsg);
+            graphProgressCreate(N-1,pMsg);
         }
 
 
+        Matrix PM;  // scratch product, its buffer is swapped with XM's every step
+
         for (int i=2; i <= (N-1) ; ++i) {
 
             emit statusMessage(tr("Computing all sociomatrix powers up to %1. "
                                  "Now computing A^%2. Please wait...").arg(N-1).arg(i));
 
-            XM*=AM;
+            PM.product(XM, AM);
+            XM.swap(PM);
             //           qDebug() << "Graph::graphWalksMatrixCreate() i"<<i <<"XM=AM^i";
             //           XM.printMatrixConsole();
 
@@ -12131,19 +16375,19 @@ void Graph::graphWalksMatrixCreate(const int &N,
             //           XSM.printMatrixConsole();
 
             if (updateProgress) {
-                emit signalProgressBoxUpdate (i);
+                graphProgressUpdate(i);
             }
 
         }
 
         if (updateProgress) {
-            emit signalProgressBoxUpdate (N-1);
+            graphProgressUpdate(N-1);
         }
 
     }
 
     if (updateProgress) {
-        emit signalProgressBoxKill();
+        graphProgressKill();
     }
     //    qDebug()<< "AM + AM = ";
     //    (AM+AM).printMatrixConsole(true);
@@ -12174,6 +16418,9 @@ void Graph::graphWalksMatrixCreate(const int &N,
  * @param length
  */
 void Graph::writeWalksTotalMatrixPlainText(const QString &fn){
+
+    GraphTraceScope trace("Graph::writeWalksTotalMatrixPlainText");
+    trace.setInput( vertices(), edgesEnabled() );
     qDebug("Graph::writeWalksTotalMatrixPlainText() ");
 
     QFile file (fn);
@@ -12191,10 +16438,7 @@ void Graph::writeWalksTotalMatrixPlainText(const QString &fn){
             <<" between each pair of nodes \n\n";
     outText << "Warning: Walk counts consider unordered pairs of nodes\n\n";
 
-    int N = vertices();
-    graphWalksMatrixCreate( N, 0, true);
-
-    outText << XSM ;
+    writeWalksMatrixStream(outText, 0, false);
 
     file.close();
 
@@ -12207,6 +16451,9 @@ void Graph::writeWalksTotalMatrixPlainText(const QString &fn){
  * @param length
  */
 void Graph::writeWalksOfLengthMatrixPlainText(const QString &fn, const int &length){
+
+    GraphTraceScope trace("Graph::writeWalksOfLengthMatrixPlainText");
+    trace.setInput( vertices(), edgesEnabled() );
     qDebug()<<"Graph::writeWalksOfLengthMatrixPlainText() ";
 
     QFile file (fn);
@@ -12222,10 +16469,7 @@ void Graph::writeWalksOfLengthMatrixPlainText(const QString &fn, const int &leng
     outText << "Network name: "<< graphName()<<" \n";
     outText << "Number of walks of length "<< length <<" between each pair of nodes \n\n";
 
-    int N = vertices();
-    graphWalksMatrixCreate( N, length, true);
-
-    outText << XM ;
+    writeWalksMatrixStream(outText, length, false);
 
     file.close();
 }
@@ -12244,6 +16488,9 @@ void Graph::writeMatrixWalks (const QString &fn,
                               const int &length,
                               const bool &simpler) {
 
+    GraphTraceScope trace("Graph::writeMatrixWalks");
+    trace.setInput( vertices(), edgesEnabled() );
+
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -12261,7 +16508,6 @@ void Graph::writeMatrixWalks (const QString &fn,
     int N = vertices();
 
     emit statusMessage(tr("Computing Walks..."));
-    graphWalksMatrixCreate(N, length, true);
 
     QTextStream outText( &file ); outText.setCodec("UTF-8");
 
@@ -12317,17 +16563,9 @@ void Graph::writeMatrixWalks (const QString &fn,
     }
 
     emit statusMessage ( tr("Writing Walks matrix to file:") + fn );
-    qDebug()<<"Graph::writeMatrixWalks() - Writing XM to file";
+    qDebug()<<"Graph::writeMatrixWalks() - Streaming walks rows to file";
 
-
-    if (length > 0) {
-        //XM.printHTMLTable(outText);
-        writeMatrixHTMLTable(outText,XM,true);
-    }
-    else {
-        writeMatrixHTMLTable(outText,XSM,true);
-        //XSM.printHTMLTable(outText);
-    }
+    writeWalksMatrixStream(outText, length, true);
 
     outText << "<p>&nbsp;</p>";
     outText << "<p class=\"small\">";
@@ -12360,46 +16598,32 @@ void Graph::writeMatrixWalks (const QString &fn,
  */
 QList<int> Graph::vertexinfluenceRange(int v1){
 
-    qDebug() << "Graph::vertexinfluenceRange() - vertex:"<< v1;
-
-    graphDistancesGeodesic(false);
-
-    VList::const_iterator jt;
-
-    int N = vertices( false, false, true);
-
-    int progressCounter=0;
-    int target = 0;
+    qCHotDebug(lcGraph) << "Graph::vertexinfluenceRange() - vertex:"<< v1;
 
     influenceRanges.clear();
-    influenceRanges.reserve(N);
-
-    QString pMsg = tr("Creating Influence Range List. \nPlease wait ");
-    emit statusMessage ( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
 
+    if ( ! vpos.contains(v1) ) {
+        return influenceRanges.values(v1);
+    }
 
-    for (jt=m_graph.cbegin(); jt!=m_graph.cend(); ++jt) {
+    graphReachabilityClosure();
 
-        emit signalProgressBoxUpdate(++progressCounter);
+    const GraphCSR &csr = graphCSR();
+    const int N = csr.vertices();
+    const int source = vpos[v1];
 
-        target = (*jt)->name();
+    influenceRanges.reserve(N);
 
-        if  ( ! (*jt)->isEnabled()  ) {
-            qDebug() << "Graph::vertexinfluenceRange() - target:"
-                     << target << "disabled. SKIP";
+    for ( int k = 0; k < N; ++k ) {
+        if ( ! csr.isEnabled(k) ) {
             continue;
         }
-
-        if ( graphDistanceGeodesic(v1, target) != RAND_MAX ) {
-            qDebug() << "Graph::vertexinfluenceRange() - v1 can reach:" << target;
-            influenceRanges.insert(v1,target);
-
+        if ( reachabilityClosureReaches( source, k ) ) {
+            qCHotDebug(lcGraph) << "Graph::vertexinfluenceRange() - v1 can reach:" << csr.name(k);
+            influenceRanges.insert(v1, csr.name(k));
         }
     }
 
-    emit signalProgressBoxKill();
-
     return influenceRanges.values(v1);
 
 }
@@ -12417,46 +16641,33 @@ QList<int> Graph::vertexinfluenceRange(int v1){
  * @return
  */
 QList<int> Graph::vertexinfluenceDomain(int v1){
-    qDebug() << "Graph::vertexinfluenceDomain() - vertex:"<< v1;
-
-    graphDistancesGeodesic(false);
-
-    VList::const_iterator it;
-
-    int N = vertices( false, false, true);
-
-    int progressCounter=0;
-    int source = 0;
-
+    qCHotDebug(lcGraph) << "Graph::vertexinfluenceDomain() - vertex:"<< v1;
 
     influenceDomains.clear();
-    influenceDomains.reserve(N);
 
-    QString pMsg = tr("Creating Influence Domain List. \nPlease wait ");
-    emit statusMessage ( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    if ( ! vpos.contains(v1) ) {
+        return influenceDomains.values(v1);
+    }
 
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+    graphReachabilityClosure();
 
-        emit signalProgressBoxUpdate(++progressCounter);
+    const GraphCSR &csr = graphCSR();
+    const int N = csr.vertices();
+    const int target = vpos[v1];
 
-        source = (*it)->name();
+    influenceDomains.reserve(N);
 
-        if  ( ! (*it)->isEnabled()  ) {
-            qDebug() << "Graph::vertexinfluenceDomain() - "
-                     << source << "disabled. SKIP";
+    // Column test: the sources whose closure row has the v1 bit set
+    for ( int k = 0; k < N; ++k ) {
+        if ( ! csr.isEnabled(k) ) {
             continue;
         }
-
-        if ((*it)->distance( v1 ) != RAND_MAX ) {
-            qDebug() << "Graph::vertexinfluenceDomain() - v1 reachable from:" << source;
-            influenceDomains.insert(v1,source);
-
+        if ( reachabilityClosureReaches( k, target ) ) {
+            qCHotDebug(lcGraph) << "Graph::vertexinfluenceDomain() - v1 reachable from:" << csr.name(k);
+            influenceDomains.insert(v1, csr.name(k));
         }
     }
 
-    emit signalProgressBoxKill();
-
     return influenceDomains.values(v1);
 
 }
@@ -12472,6 +16683,9 @@ QList<int> Graph::vertexinfluenceDomain(int v1){
     Writes the reachability matrix X^R of the graph to a file
 */
 void Graph::writeReachabilityMatrixPlainText(const QString &fn, const bool &dropIsolates) {
+
+    GraphTraceScope trace("Graph::writeReachabilityMatrixPlainText");
+    trace.setInput( vertices(), edgesEnabled() );
     qDebug("Graph::writeReachabilityMatrixPlainText() ");
 
     QFile file (fn);
@@ -12490,7 +16704,10 @@ void Graph::writeReachabilityMatrixPlainText(const QString &fn, const bool &drop
     outText << "Two nodes are reachable if there is a walk between them (their geodesic distance is non-zero). \n";
     outText << "If nodes i and j are reachable then XR(i,j)=1 otherwise XR(i,j)=0.\n\n";
 
-    graphDistancesGeodesic(false,false,false,dropIsolates);
+    // Reachability does not depend on isolates: they only reach themselves.
+    Q_UNUSED(dropIsolates);
+
+    graphMatrixReachabilityCreate();
 
     outText << XRM ;
 
@@ -12512,6 +16729,9 @@ void Graph::writeReachabilityMatrixPlainText(const QString &fn, const bool &drop
 void Graph::writeClusteringCoefficient( const QString fileName,
                                         const bool considerWeights) {
 
+    GraphTraceScope trace("Graph::writeClusteringCoefficient");
+    trace.setInput( vertices(), edgesEnabled() );
+
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -12534,7 +16754,7 @@ void Graph::writeClusteringCoefficient( const QString fileName,
 
     QString pMsg = tr("Writing Clustering Coefficients to file. \nPlease wait...");
     emit statusMessage ( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     outText.setRealNumberPrecision(m_reportsRealPrecision);
 
@@ -12611,7 +16831,7 @@ void Graph::writeClusteringCoefficient( const QString fileName,
 
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
 
-        emit signalProgressBoxUpdate( ++progressCounter );
+        graphProgressUpdate( ++progressCounter );
 
         rowCount++;
 
@@ -12701,7 +16921,7 @@ void Graph::writeClusteringCoefficient( const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 }
 
 
@@ -12711,6 +16931,9 @@ void Graph::writeClusteringCoefficient( const QString fileName,
 void Graph::writeTriadCensus( const QString fileName,
                               const bool considerWeights) {
 
+    GraphTraceScope trace("Graph::writeTriadCensus");
+    trace.setInput( vertices(), edgesEnabled() );
+
     qDebug() << "Graph::writeTriadCensus()";
 
     QElapsedTimer computationTimer;
@@ -12731,7 +16954,12 @@ void Graph::writeTriadCensus( const QString fileName,
     if (  !calculatedTriad) {
         if (!graphTriadCensus()){
             qDebug() << "Error in graphTriadCensus(). Exiting...";
-            file.close();
+            if ( graphCancelled() ) {
+                file.remove();
+            }
+            else {
+                file.close();
+            }
             return;
         }
     }
@@ -12761,7 +16989,7 @@ void Graph::writeTriadCensus( const QString fileName,
 
     QString pMsg = tr("Writing Triad Census to file. \nPlease wait...") ;
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(16,pMsg);
+    graphProgressCreate(16,pMsg);
 
 
     outText << htmlHead;
@@ -12815,7 +17043,7 @@ void Graph::writeTriadCensus( const QString fileName,
 
     for (int i = 0 ; i<=15 ; i++) {
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         rowCount = i + 1;
         outText << "<tr class=" << ((rowCount%2==0) ? "even" :"odd" )<< ">"
@@ -12842,7 +17070,7 @@ void Graph::writeTriadCensus( const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 }
 
 
@@ -12859,6 +17087,9 @@ void Graph::writeTriadCensus( const QString fileName,
 bool Graph::writeCliqueCensus(const QString &fileName,
                               const bool considerWeights) {
 
+    GraphTraceScope trace("Graph::writeCliqueCensus");
+    trace.setInput( vertices(), edgesEnabled() );
+
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -12888,18 +17119,22 @@ bool Graph::writeCliqueCensus(const QString &fileName,
 
     QString pMsg = tr("Computing Clique Census and writing it to a file. \nPlease wait...");
     emit statusMessage(pMsg);
-    emit signalProgressBoxCreate(2*N,pMsg);
+    graphProgressCreate(2*N,pMsg);
 
     // compute clique census
     pMsg = tr("Computing Clique Census. Please wait..") ;
     emit statusMessage ( pMsg );
     qDebug() << "Graph::writeCliqueCensus() - calling graphCliques";
 
-    csRecDepth = 0;
-
     // Call graphCliques() to compute all cliques (maximal connected subgraphs) of the network.
     graphCliques();
 
+    if ( graphCancelled() ) {
+        file.remove();
+        graphProgressKill();
+        return false;
+    }
+
     pMsg = tr("Writing Clique Census to file. Please wait..") ;
     emit statusMessage ( pMsg );
 
@@ -13109,7 +17344,12 @@ bool Graph::writeCliqueCensus(const QString &fileName,
 
     pMsg = tr("Computing HCA for Cliques. Please wait..") ;
     emit statusMessage ( pMsg );
-    if (! graphClusteringHierarchical(CLQM,
+
+    // clustering works on qreal matrices
+    Matrix CLQ;
+    CLQM.toMatrix(CLQ);
+
+    if (! graphClusteringHierarchical(CLQ,
                                       varLocation,
                                       graphMetricStrToType("Euclidean"),
                                       Clustering::Complete_Linkage,
@@ -13118,9 +17358,14 @@ bool Graph::writeCliqueCensus(const QString &fileName,
                                       true,
                                       false,
                                       true) ) {
-        file.close();
-        emit statusMessage( "Error completing HCA analysis");
-        emit signalProgressBoxKill();
+        if ( graphCancelled() ) {
+            file.remove();
+        }
+        else {
+            file.close();
+            emit statusMessage( "Error completing HCA analysis");
+        }
+        graphProgressKill();
         return false;
     }
 
@@ -13140,7 +17385,7 @@ bool Graph::writeCliqueCensus(const QString &fileName,
            << "</p>";
 
 
-    emit signalProgressBoxUpdate(2 * N);
+    graphProgressUpdate(2 * N);
 
     outText << "<p>"
            << "<span class=\"info\">"
@@ -13163,7 +17408,7 @@ bool Graph::writeCliqueCensus(const QString &fileName,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
     return true;
 }
@@ -13214,172 +17459,100 @@ void Graph:: graphCliqueAdd(const QList<int> &clique){
 
 
 /**
- * @brief Finds all maximal cliques in an undirected (?) graph.
- * Implements the Bron–Kerbosch algorithm, a recursive backtracking algorithm
- * that searches for all maximal cliques in a given graph G.
- * Given three sets R, P, and X, the algorithm finds the maximal cliques that
- * include all of the vertices in R, some of the vertices in P, and none of
- * the vertices in X.
- * In each call to the algorithm, P and X are disjoint sets whose union consists
- * of those vertices that form cliques when added to R.
- * In other words, P ∪ X is the set of vertices which are joined to every element of R.
- * When P and X are both empty there are no further elements that can be added to R,
- * so R is a maximal clique and the algorithm outputs R.
- * The recursion is initiated by setting R and X to be the empty set and P to be
- * the vertex set of the graph.
- * Within each recursive call, the algorithm considers the vertices in P in turn.
- * if there are no vertices, it either reports R as a maximal clique (if X is empty),
- * or backtracks.
- * For each vertex v chosen from P, it makes a recursive call in which v is added to R
- * and in which P and X are restricted to the neighbor set NBS(v) of v,
- * which finds and reports all clique extensions of R that contain v.
- * Then, it moves v from P to X to exclude it from consideration in future cliques
- * and continues with the next vertex in P.
- * @param R
- * @param P
- * @param X
+ * @brief Finds all maximal cliques of the graph, where two actors are adjacent
+ * if they are mutually connected with the same weight (see neighborhoodList).
+ * Isolated actors form singleton cliques.
+ *
+ * Implements the Bron–Kerbosch algorithm with Tomita pivoting over a degeneracy
+ * ordering (Eppstein, Löffler & Strash). For each actor v, in that order,
+ * it reports the maximal cliques whose earliest member is v, with P the later
+ * neighbors and X the earlier neighbors of v. Such subproblems are bounded by
+ * the degeneracy of the graph, use bitsets for P and X, and are independent,
+ * so they run on a pool of graphWorkerThreads() workers.
+ *
+ * Found cliques are stored via graphCliqueAdd() in the main thread.
  */
-void Graph::graphCliques(QSet<int> R, QSet<int> P, QSet<int> X) {
+void Graph::graphCliques() {
 
-    csRecDepth ++ ;
+    GraphTraceScope trace("Graph::graphCliques");
+    trace.setInput( vertices(), edgesEnabled() );
 
-    qDebug () << "Graph::graphCliques() - STARTS HERE. csRecDepth:"
-              << csRecDepth
-              << " - Check if we are at initialization step";
+    const int V = vertices() ;
 
-    if (R.isEmpty() && P.isEmpty() && X.isEmpty()){
+    graphCancelReset();
 
-        int V = vertices() ;
-        P.reserve( V );
-        R.reserve( V );
-        X.reserve( V );
-        P=verticesSet();
+    qCHotDebug(lcGraph) << "Graph::graphCliques() - vertices" << V;
 
-        qDebug() << "Graph::graphCliques() - initialization step. R, X empty and P=V(G): "
-                 << P;
+    CLQM.zeroMatrix(V,V);  //co-membership matrix CLQM
 
-        CLQM.zeroMatrix(V,V);  //co-membership matrix CLQM
+    m_cliques.clear();
 
-        m_cliques.clear();
-
-        VList::const_iterator it;
-        int vertex=0;
-        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it)     {
-            vertex = (*it)->name();
-            neighboursHash[ vertex ] = (*it) -> neighborhoodList().toSet(); // vertexNeighborhoodSet(vertex);
-            qDebug() << "Graph::graphCliques() - initialization step. NeighborhoodList of v"
-                     << vertex
-                     << ": "
-                     <<neighboursHash[ vertex ] ;
-            (*it)->clearCliques();
+    VList::const_iterator it;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it)     {
+        (*it)->clearCliques();
+    }
+
+    // The cliques of the same network may be in the result store
+    QList< QList<int> > stored;
+    if ( m_resultStore.isEnabled()
+         && m_resultStore.read( graphContentHash(), "cliques", [&](QDataStream &in) {
+                             in >> stored;
+                             return in.status() == QDataStream::Ok; } ) ) {
+        for (int k = 0; k < stored.size(); ++k) {
+            graphCliqueAdd( stored[k] );
         }
-    }
-
-    qDebug() << "Graph::graphCliques() - check if P and X are both empty (which would mean we have a clique in R)...";
-
-    if (P.isEmpty() && X.isEmpty()) {
-
-        qDebug() << "Graph::graphCliques() - P and X are both empty. MAXIMAL clique R=" << R;
-
-        QList<int> clique = R.values();
-
-        graphCliqueAdd(clique);
-
-        csRecDepth -- ;
-
+        qCHotDebug(lcGraph) << "Graph::graphCliques() - restored from result store. Total cliques:"
+                 << m_cliques.count();
         return;
-
     }
 
-    int v;
-
-    QSet<int> NBS;
-
-    QSet<int> Rnext, Pnext, Xnext;
-
-    QSet<int>::iterator i = P.begin();
-
-    int counter = 0;
-
-    // Loop over vertices in P, randomly
-
-    qDebug() << "Graph::graphCliques() - Start looping over vertices in P (randomly)";
+    const GraphCSR &csr = graphCSR();
 
-    while( i != P.end()) {
+    const GraphCliqueCensus census(csr);
 
-        counter ++ ;
+    const int total = census.vertices();
+    const int threads = graphWorkerThreads(total);
 
-        v = *i;
+    vector< QList< QList<int> > > found(threads);
 
-        qDebug() << "Graph::graphCliques() - CURRENT v:" << v
-                 << " P:" << P << " P.count=" <<P.count()
-                 << " R:" << R
-                 << " X:" << X ;
+    qCHotDebug(lcGraph) << "Graph::graphCliques() - starting" << threads
+             << "workers for" << total << "subproblems";
 
-        NBS = neighboursHash[ v ];
-
-        if (NBS.count() == 1 && NBS.contains(v)) {
-
-            qDebug() << "Graph::graphCliques() - v:" << v
-                     << "has only a tie to itself";
-
-            //graphCliques( R, P, X );
-
-            ++i;
-
-            continue;
+    emit statusMessage ( tr("Finding cliques. Please wait...") );
 
+    GraphScheduler::parallelFor( total, threads,
+                                 [&](const int &t, const int &first, const int &last) {
+        for (int next = first; next < last; ++next) {
+            census.find( next, found[t] );
         }
+    }, 1, [this](const int &done) { graphProgressUpdate(done); }, &m_cancelRequested );
 
-        Rnext = R;
-        Rnext << v ;
-        Pnext = P&NBS;
-        Xnext = X&NBS;
+    graphProgressUpdate( total );
 
-        qDebug() << "Graph::graphCliques() - v:" << v
-                 << "RECURSIVE CALL to graphCliques ( R ⋃ {v}, P ⋂ NB(v), X ⋂ NBS(v) )"
-                    << endl << "NBS(v):" << NBS
-                    << endl << "Rnext = R ⋃ {v}:" << Rnext
-                    << endl << "Pnext = P ⋂ NBS(v):" << Pnext
-                    << endl << "Xnext = X ⋂ NBS(v):" << Xnext;
-
-        if (csRecDepth==1) {
-            emit signalProgressBoxUpdate(counter);
-            emit statusMessage ( tr("Finding cliques: Recursive backtracking for actor ") + QString::number(v));
-        }
+    if ( graphCancelled() ) {
+        // Discard the cliques found so far, none of them was added yet
+        qDebug() << "Graph::graphCliques() - cancelled. Return.";
+        emit statusMessage( tr("Finding cliques cancelled.") );
+        return;
+    }
 
-        // find all clique extensions of R that contain v
-        try {
-            graphCliques( Rnext, Pnext, Xnext );
-        } catch (...) {
-            qDebug() << "Graph::graphCliques() - ERROR";
-            return;
+    for (int t = 0; t < threads; ++t) {
+        for (int k = 0; k < found[t].size(); ++k) {
+            graphCliqueAdd( found[t][k] );
         }
+    }
 
+    qCHotDebug(lcGraph) << "Graph::graphCliques() - finished. Total cliques:"
+             << m_cliques.count();
 
-        // Set P = P \ v
-        i=P.erase(i);    //P-=v;
-
-        // Set X = X + v
-        X.insert(v);
-
-        qDebug() << "Graph::graphCliques() - v:" << v
-                 << "RETURNED from recursive call - recDepth: "
-                 << csRecDepth
-                 << " Moved v:"<<  v
-                 <<" from P to X to be excluded in the future"
-                 << " P=" << P << " P.count:" <<P.count()
-                 << " R=" << R << " R.count:" <<R.count()
-                 << " X=" << X << " X.count:" <<X.count()
-                 << " Continuing with next v in P";
-        //++i;
-
-    } //end while loop
-
-    qDebug() << "Graph::graphCliques() - FINISHED loop over P:" << P
-             << "at csRecDepth:" <<  csRecDepth;
-
-    csRecDepth -- ;
+    if ( m_resultStore.isEnabled() ) {
+        m_resultStore.write( graphContentHash(), "cliques", [&](QDataStream &out) {
+            for (int t = 0; t < threads; ++t) {
+                stored << found[t];
+            }
+            out << stored;
+        } );
+    }
 
 }
 
@@ -13442,6 +17615,9 @@ bool Graph::writeClusteringHierarchical(const QString &fileName,
                                         const bool &inverseWeights,
                                         const bool &dropIsolates) {
 
+    GraphTraceScope trace("Graph::writeClusteringHierarchical");
+    trace.setInput( vertices(), edgesEnabled() );
+
 
     QElapsedTimer computationTimer;
     computationTimer.start();
@@ -13468,32 +17644,80 @@ bool Graph::writeClusteringHierarchical(const QString &fileName,
 
     Matrix STR_EQUIV;
 
-    switch (graphMatrixStrToType(matrix)) {
-    case MATRIX_ADJACENCY:
-        graphMatrixAdjacencyCreate(dropIsolates);
-        STR_EQUIV=AM;
-        break;
-    case MATRIX_DISTANCES:
-        graphMatrixDistanceGeodesicCreate(considerWeights, inverseWeights, dropIsolates);
-        STR_EQUIV=DM;
-        break;
-    default:
-        break;
-    }
+    // The clustering of the same network with the same options may be in the
+    // result store, along with the dissimilarities matrix it was computed on.
+    const QString storeEntry = QString("clustering-%1-%2-%3-%4-%5-%6-%7")
+            .arg(matrix, varLocation, metric, method)
+            .arg(diagonal).arg(dendrogram)
+            .arg( GraphResultCache::parameters(considerWeights, inverseWeights, dropIsolates) );
+
+    auto clusteringRead = [&](QDataStream &in) {
+        qint32 rows = 0, cols = 0;
+        qreal element = 0;
+        in >> rows >> cols;
+        if ( rows < 0 || cols < 0 ) {
+            return false;
+        }
+        STR_EQUIV.zeroMatrix(rows, cols);
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                in >> element;
+                STR_EQUIV.setItem(i, j, element);
+            }
+        }
+        in >> m_clusteringLevel >> m_clustersPerSequence
+           >> m_clustersByName >> m_clusterPairNamesPerSeq;
+        return in.status() == QDataStream::Ok;
+    };
 
-    if (! graphClusteringHierarchical(STR_EQUIV,
-                                      varLocation,
-                                      graphMetricStrToType(metric),
-                                      graphClusteringMethodStrToType(method),
-                                      diagonal,
-                                      dendrogram,
-                                      considerWeights,
-                                      inverseWeights,
-                                      dropIsolates) ) {
-        qDebug()<< "Graph::writeClusteringHierarchical() - HCA failed. Returning...";
-        emit statusMessage( "Error completing HCA analysis");
-        emit signalProgressBoxKill();
-        return false;
+    if ( ! m_resultStore.isEnabled()
+         || ! m_resultStore.read( graphContentHash(), storeEntry, clusteringRead ) ) {
+
+        switch (graphMatrixStrToType(matrix)) {
+        case MATRIX_ADJACENCY:
+            graphMatrixAdjacencyCreate(dropIsolates);
+            STR_EQUIV=AM;
+            break;
+        case MATRIX_DISTANCES:
+            graphMatrixDistanceGeodesicCreate(considerWeights, inverseWeights, dropIsolates);
+            STR_EQUIV=DM;
+            break;
+        default:
+            break;
+        }
+
+        if (! graphClusteringHierarchical(STR_EQUIV,
+                                          varLocation,
+                                          graphMetricStrToType(metric),
+                                          graphClusteringMethodStrToType(method),
+                                          diagonal,
+                                          dendrogram,
+                                          considerWeights,
+                                          inverseWeights,
+                                          dropIsolates) ) {
+            qDebug()<< "Graph::writeClusteringHierarchical() - HCA failed. Returning...";
+            if ( graphCancelled() ) {
+                file.remove();
+            }
+            else {
+                emit statusMessage( "Error completing HCA analysis");
+            }
+            graphProgressKill();
+            return false;
+        }
+
+        if ( m_resultStore.isEnabled() ) {
+            m_resultStore.write( graphContentHash(), storeEntry, [&](QDataStream &out) {
+                out << (qint32) STR_EQUIV.rows() << (qint32) STR_EQUIV.cols();
+                for (int i = 0; i < STR_EQUIV.rows(); ++i) {
+                    for (int j = 0; j < STR_EQUIV.cols(); ++j) {
+                        out << STR_EQUIV.item(i, j);
+                    }
+                }
+                out << m_clusteringLevel << m_clustersPerSequence
+                    << m_clustersByName << m_clusterPairNamesPerSeq;
+            } );
+        }
     }
 
     QTextStream outText ( &file );
@@ -13501,7 +17725,7 @@ bool Graph::writeClusteringHierarchical(const QString &fileName,
 
     QString pMsg = tr("Writing Hierarchical Cluster Analysis to file. \nPlease wait... ");
     emit statusMessage ( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
 
 
@@ -13566,7 +17790,7 @@ bool Graph::writeClusteringHierarchical(const QString &fileName,
             <<"</span>"
            << "</p>";
 
-    emit signalProgressBoxUpdate( N /3);
+    graphProgressUpdate( N /3);
 
     writeMatrixHTMLTable(outText,STR_EQUIV,true,false,false, dropIsolates);
     //STR_EQUIV.printHTMLTable(outText,true,false);
@@ -13578,7 +17802,7 @@ bool Graph::writeClusteringHierarchical(const QString &fileName,
            << "</p>";
 
 
-    emit signalProgressBoxUpdate( 2* N /3);
+    graphProgressUpdate( 2* N /3);
     writeClusteringHierarchicalResultsToStream(outText, N, dendrogram);
 
 
@@ -13596,8 +17820,8 @@ bool Graph::writeClusteringHierarchical(const QString &fileName,
     file.close();
     qDebug()<< "Graph::writeClusteringHierarchical() - finished";
 
-    emit signalProgressBoxUpdate( N);
-    emit signalProgressBoxKill();
+    graphProgressUpdate( N);
+    graphProgressKill();
 
     return true;
 
@@ -13835,6 +18059,8 @@ void Graph::writeClusteringHierarchicalResultsToStream(QTextStream& outText,
  * - Clustering::Single_Linkage: "single-link" or "connectedness" or "minimum"
  * - Clustering::Complete_Linkage: "complete-link" or "diameter" or "maximum"
  * - Clustering::Average_Linkage: "average-link" or UPGMA
+ * The merges are found with the nearest-neighbor chain algorithm over the
+ * condensed lower triangle of the dissimilarities, in O(N^2) time.
  * @param matrix
  * @param metric
  * @param method
@@ -13852,8 +18078,17 @@ bool Graph::graphClusteringHierarchical(Matrix &STR_EQUIV,
                                         const bool &inverseWeights,
                                         const bool &dropIsolates) {
 
+    GraphTraceScope trace("Graph::graphClusteringHierarchical");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("varLocation=%1 metric=%2 method=%3 diagonal=%4 "
+                            "considerWeights=%5 inverseWeights=%6 dropIsolates=%7")
+                    .arg(varLocation).arg(metric).arg(method).arg(diagonal)
+                    .arg(considerWeights).arg(inverseWeights).arg(dropIsolates) );
+
     Q_UNUSED (inverseWeights);
 
+    graphCancelReset();
+
     qDebug() << "Graph::graphClusteringHierarchical() - "
              << "metric" << metric
              << "method" << graphClusteringMethodTypeToString(method)
@@ -13864,82 +18099,75 @@ bool Graph::graphClusteringHierarchical(Matrix &STR_EQUIV,
     qDebug() << "Graph::graphClusteringHierarchical() - STR_EQUIV matrix:";
     //STR_EQUIV.printMatrixConsole(true);
 
-    qreal min=RAND_MAX;
-    qreal max=0;
-    int imin, jmin, imax, jmax, mergedClusterIndex, deletedClusterIndex ;
-    qreal distanceNewCluster;
-
     // temp vector stores cluster members at each clustering level
     QVector<int> clusteredItems;
 
-    // maps original and clustered items per their DSM matrix index
-    // so that we know that at Level X the matrix index 0 corresponds to the cluster i.e. { 1,2,4}
-    QMap <int, V_int> m_clustersIndex;
-    QMap<int,V_int>::iterator it;
-    QMap<int,V_int>::iterator prev;
-
-    QMap<QString,V_int>::const_iterator sit;
-
     // variables for diagram computation
     QVector<QString> clusterPairNames;
     QString cluster1, cluster2;
 
-    Matrix DSM;  //dissimilarities matrix. Note: will be destroyed in the end.
+    // The dissimilarities are symmetric, so only the strictly lower triangle
+    // is kept, condensed row by row: D(i,j), i > j, is at i*(i-1)/2 + j.
+    // It is updated in place as clusters merge.
+    vector<qreal> D;
+    vector<qreal> self;
 
     // TODO: needs fix when distances matrix with -1 (infinity) elements is used.
 
-    // compute, if needed, the dissimilarities matrix
+    // compute, if needed, the dissimilarities, straight into condensed form.
+    // STR_EQUIV is then overwritten with them, for the report.
     switch (metric) {
     case METRIC_NONE:
-        DSM=STR_EQUIV;
         break;
     case METRIC_JACCARD_INDEX:
-        graphMatrixDissimilaritiesCreate(STR_EQUIV, DSM, metric,varLocation,diagonal, considerWeights);
-        STR_EQUIV = DSM;
-        break;
     case METRIC_MANHATTAN_DISTANCE:
-        graphMatrixDissimilaritiesCreate(STR_EQUIV, DSM, metric,varLocation,diagonal, considerWeights);
-        STR_EQUIV = DSM;
-        break;
     case METRIC_HAMMING_DISTANCE:
-        graphMatrixDissimilaritiesCreate(STR_EQUIV, DSM, metric,varLocation,diagonal, considerWeights);
-        STR_EQUIV = DSM;
-        break;
     case METRIC_EUCLIDEAN_DISTANCE:
-        graphMatrixDissimilaritiesCreate(STR_EQUIV, DSM, metric,varLocation,diagonal, considerWeights);
-        STR_EQUIV = DSM;
-        break;
     case METRIC_CHEBYSHEV_MAXIMUM:
-        graphMatrixDissimilaritiesCreate(STR_EQUIV, DSM, metric,varLocation,diagonal, considerWeights);
-        STR_EQUIV = DSM;
+        if ( ! STR_EQUIV.distancesCondensed(metric, varLocation, diagonal, D, self) ) {
+            emit statusMessage("ERROR: not enough memory for the dissimilarities");
+            return false;
+        }
+        STR_EQUIV.fromCondensed(D, self);
         break;
     default:
         break;
     }
 
-
-    int N = DSM.rows();
+    int N = STR_EQUIV.rows();
 
 
     qDebug() << "Graph::graphClusteringHierarchical() -"
-             << "initial matrix DSM contents:";
-    //DSM.printMatrixConsole();
+             << "initial dissimilarities matrix contents:";
+    //STR_EQUIV.printMatrixConsole();
 
-    if (DSM.illDefined()) {
-        //        DSM.clear();
-        //        STR_EQUIV.clear();
+    if (STR_EQUIV.illDefined()) {
         emit statusMessage("ERROR computing dissimilarities matrix");
         return false;
     }
 
+    if ( metric == METRIC_NONE ) {
+        try {
+            D.resize( (size_t) N * ( N - 1 ) / 2 );
+        }
+        catch (const std::bad_alloc &) {
+            emit statusMessage("ERROR: not enough memory for the dissimilarities");
+            return false;
+        }
+        for (int i = 1; i < N; ++i ) {
+            qreal *row = D.data() + (size_t) i * ( i - 1 ) / 2;
+            for (int j = 0; j < i; ++j ) {
+                row[j] = STR_EQUIV.item(i, j);
+            }
+        }
+    }
+    vector<qreal>().swap(self);
+
     clusteredItems.reserve(N);
     if (diagram) {
         clusterPairNames.reserve(N);
     }
 
-
-    m_clustersIndex.clear();
-
     m_clustersPerSequence.clear();
     m_clusteringLevel.clear();
 
@@ -13948,249 +18176,199 @@ bool Graph::graphClusteringHierarchical(Matrix &STR_EQUIV,
 
     //
     //Step 1: Assign each of the N items to its own cluster.
-    //        We have N unit clusters
+    //        We have N unit clusters. Cluster i lives in slot i.
     //
-    int clustersLeft = N;
-    int seq = 1 ; //clustering stage/level sequence number
+    QVector<V_int> clusterMembers;
+    QVector<QString> clusterNames;
+    clusterMembers.reserve(N);
+    clusterNames.reserve(N);
 
     VList::const_iterator vit;
-    int i = 0;
     for ( vit=m_graph.cbegin(); vit!=m_graph.cend(); ++vit){
-        //        if (dropIsolates) {
-        //            if ((*vit)->isIsolated()) {
-        //                continue;
-        //            }
-        //        }
-        //         if (!(*vit)->isEnabled()) {
-        //            continue;
-        //         }
-
         if ((*vit)->isEnabled() && ( ! (*vit)->isIsolated() ) ) {
             clusteredItems.clear();
             clusteredItems << (*vit)->name();
-            m_clustersIndex[i] = clusteredItems;
+            clusterMembers << clusteredItems;
+            clusterNames << QString::number( clusterMembers.size() );
             if (diagram) {
-                m_clustersByName.insert(QString::number(i+1),clusteredItems );
+                m_clustersByName.insert(clusterNames.last(), clusteredItems );
             }
-            i++;
         }
-
-
     }
 
-    //    for (int i = 0 ; i< N ; i ++ ) {
-    //        clusteredItems.clear();
-    //        clusteredItems << i+1;
-    //        m_clustersIndex[i] = clusteredItems;
-    //        if (diagram) {
-    //            m_clustersByName.insert(QString::number(i+1),clusteredItems );
-    //        }
-    //    }
+    // When isolates are kept in the dissimilarities, their slots have no members
+    clusterMembers.resize(N);
+    clusterNames.resize(N);
+
+    auto distance = [&D](const int &i, const int &j) -> qreal & {
+        return ( i > j ) ? D[ (size_t) i * ( i - 1 ) / 2 + j ]
+                         : D[ (size_t) j * ( j - 1 ) / 2 + i ];
+    };
 
     QString pMsg=tr("Computing Hierarchical Clustering. \nPlease wait...");
     emit statusMessage(pMsg);
-    emit signalProgressBoxCreate(N, pMsg);
-
-    while (clustersLeft > 1)
-    {
-
-        emit signalProgressBoxUpdate(seq);
-
-        qDebug() << endl
-                 << "Graph::graphClusteringHierarchical() -"
-                 <<"matrix DSM contents now:";
-        //DSM.printMatrixConsole();
+    graphProgressCreate(N, pMsg);
 
-        //
-        //Step 2. Find the most similar pair of clusters.
-        //        Merge them into a single new cluster.
-        //
-        DSM.NeighboursNearestFarthest(min, max, imin, jmin, imax, jmax);
-        mergedClusterIndex = (imin < jmin ) ? imin : jmin;
-        deletedClusterIndex =  (mergedClusterIndex  == imin ) ? jmin : imin;
-
-        m_clusteringLevel << min;
+    //
+    //Step 2. Follow a chain of nearest neighbors until two clusters are
+    //        each other's nearest neighbors, then merge them into a single
+    //        new cluster (nearest-neighbor chain, Murtagh 1983).
+    //        Single, complete and average (WPGMA) linkage are reducible,
+    //        so this yields the same hierarchy as merging the globally
+    //        closest pair each time, in O(N^2) instead of O(N^3).
+    //
+    struct ClusterMerge {
+        int slot1, slot2;
+        qreal level;
+    };
+    vector<ClusterMerge> merges;
+    merges.reserve(N);
 
-        clusteredItems.clear();
-        clusteredItems = m_clustersIndex[mergedClusterIndex] + m_clustersIndex[deletedClusterIndex] ;
+    vector<int> chain;
+    chain.reserve(N);
+    vector<char> active(N, 1);
 
-        qDebug() << "Graph::graphClusteringHierarchical() -"
-                 << "level"<< min
-                 << "seq" << seq
-                 <<"clusteredItems in level"  <<clusteredItems;
+    int clustersLeft = N;
+    int first = 0, a = 0, b = 0, prev = 0, k = 0, lo = 0, hi = 0;
+    qreal nearest = 0, dak = 0, distanceNewCluster = 0;
 
-        m_clustersPerSequence.insert( seq, clusteredItems);
+    while ( clustersLeft > 1 ) {
 
-        if (diagram) {
+        if ( chain.empty() ) {
+            while ( ! active[first] ) {
+                first++;
+            }
+            chain.push_back(first);
+        }
 
-            cluster1.clear();
-            cluster2.clear();
-            clusterPairNames.clear();
+        a = chain.back();
+        prev = ( chain.size() > 1 ) ? chain[ chain.size() - 2 ] : -1;
 
-            for ( sit= m_clustersByName.constBegin() ; sit != m_clustersByName.constEnd(); ++sit) {
-                if (sit.value() == m_clustersIndex[mergedClusterIndex] ) {
-                    cluster1 = sit.key();
-                }
-                else if (sit.value() == m_clustersIndex[deletedClusterIndex] ) {
-                    cluster2 = sit.key();
-                }
-            }
-            if (cluster1.isNull() && m_clustersIndex[mergedClusterIndex].size() == 1) {
-                cluster1 = QString::number( m_clustersIndex[mergedClusterIndex].first() );
+        // Nearest active neighbor of a. On ties keep the previous chain
+        // element, so that the chain always terminates.
+        b = prev;
+        nearest = ( prev >= 0 ) ? distance(a, prev) : std::numeric_limits<qreal>::max();
+        for ( k = 0; k < N; ++k ) {
+            if ( k == a || ! active[k] ) {
+                continue;
             }
-            if (cluster2.isNull() && m_clustersIndex[deletedClusterIndex].size() == 1) {
-                cluster1 = QString::number( m_clustersIndex[deletedClusterIndex].first() );
+            dak = distance(a, k);
+            if ( dak < nearest ) {
+                nearest = dak;
+                b = k;
             }
+        }
 
-            clusterPairNames.append(cluster1);
-            clusterPairNames.append(cluster2);
-
-            m_clusterPairNamesPerSeq.insert(seq, clusterPairNames);
-
-            m_clustersByName.insert("c"+QString::number(seq),clusteredItems );
-
-            qDebug() << "Graph::graphClusteringHierarchical() - computing diagram variables..."<<endl
-                     << "cluster1"<< cluster1 << endl
-                     << "cluster2"<< cluster2 << endl
-                     << "clusterPairNames" << clusterPairNames << endl
-                     << "m_clusterPairNamesPerSeq" << m_clusterPairNamesPerSeq << endl
-                     << "m_clustersByName" <<m_clustersByName;
-
-
-        } //end if diagram
-
+        if ( b != prev ) {
+            chain.push_back(b);
+            continue;
+        }
 
-        // map new cluster to a matrix index
-        m_clustersIndex[mergedClusterIndex] = clusteredItems ;
+        // a and b are reciprocal nearest neighbors.
+        chain.pop_back();
+        chain.pop_back();
 
-        qDebug() << "Graph::graphClusteringHierarchical() -" << endl
-                 << "  Clustering seq:"
-                 << seq << endl
-                 << "  Level:" << min << endl
-                 << "  Neareast neighbors: ("<< imin+1 <<","<<jmin+1<<")"
-                 << "Minimum/distance:" << min << endl
-                 << "  Farthest neighbors: ("<< imax+1 <<","<<jmax+1<<")"
-                 << "Maximum/distance:" << max << endl
-                 << "  Merge nearest neighbors into a single new cluster:"
-                 << mergedClusterIndex +1 << endl
-                 << "  m_clustersPerSequence" << m_clustersPerSequence;
+        //
+        //Step 3. Compute distances (or similarities) between the single
+        //        new cluster, which takes the lower slot, and the old ones
+        //
+        lo = qMin(a, b);
+        hi = qMax(a, b);
 
-        qDebug() << "Graph::graphClusteringHierarchical() -" << endl
-                 << "  Remove key"<< deletedClusterIndex
-                 << "and shift next values to left... " ;
+        for ( k = 0; k < N; ++k ) {
+            if ( k == lo || k == hi || ! active[k] ) {
+                continue;
+            }
+            switch (method) {
+            case Clustering::Complete_Linkage: // "complete-linkage":
+                distanceNewCluster = qMax( distance(k, lo), distance(k, hi) );
+                break;
+            case Clustering::Average_Linkage: //mean or "average-linkage"
+                distanceNewCluster = ( distance(k, lo) + distance(k, hi) ) / 2;
+                break;
+            case Clustering::Single_Linkage: //"single-linkage":
+            default:
+                distanceNewCluster = qMin( distance(k, lo), distance(k, hi) );
+                break;
+            }
+            distance(k, lo) = distanceNewCluster;
+        }
 
-        it = m_clustersIndex.find(deletedClusterIndex);
+        active[hi] = 0;
+        merges.push_back( { lo, hi, nearest } );
+        clustersLeft --;
 
-        while (it != m_clustersIndex.end()) {
-            prev = it;
-            ++it;
-            if ( it != m_clustersIndex.end() ) {
-                prev.value() = it.value() ;
-                //qDebug() << "  key now"<< prev.key() << ": " << prev.value() ;
+        if ( ( clustersLeft & 255 ) == 0 ) {
+            graphProgressUpdate(N - clustersLeft);
+            if ( graphCancelled() ) {
+                // Nothing was stored yet, only the diagram's unit clusters
+                qDebug() << "Graph::graphClusteringHierarchical() - cancelled. Return.";
+                m_clustersByName.clear();
+                clusteredItems.clear();
+                graphProgressKill();
+                emit statusMessage( tr("Computing hierarchical clustering cancelled.") );
+                return false;
             }
         }
-        m_clustersIndex.erase(--it); //erase the last element in map
-
-        qDebug() << "Graph::graphClusteringHierarchical() - Finished. " << endl
-                 << "  m_clustersIndex now" <<m_clustersIndex << endl
-                 << "  Compute distances "
-                    "between the new cluster and the old ones";
 
         //
-        //Step 3. Compute distances (or similarities) between
-        //        the single new cluster and the old clusters
+        //Step 4. Repeat steps 2 and 3 until all remaining items/clusters
+        //        are clustered into a single cluster of size N
         //
-        int j = mergedClusterIndex ;
-
-        qDebug() << "j = mergedClusterIndex " << mergedClusterIndex +1;
-
-        for (int i = 0 ; i< clustersLeft; i ++ ) {
-            if (i == deletedClusterIndex  ) {
-                //                qDebug() << "Graph::graphClusteringHierarchical() -"
-                //                          <<"SKIP this as it is one of the merged clusters.";
-                continue;
-
-            }
+    }
 
-            distanceNewCluster = 0;
+    vector<qreal>().swap(D);
 
-            switch (method) {
-            case Clustering::Single_Linkage: //"single-linkage":
-                if (i==j) {
-                    distanceNewCluster = 0;
-                }
-                else {
-                    distanceNewCluster= (DSM.item(i,imin) < DSM.item(i,jmin) ) ? DSM.item(i,imin) : DSM.item(i,jmin);
-                }
-                qDebug() << "Graph::graphClusteringHierarchical() - "
-                        << "  DSM("<<i+1<<","<<imin+1<<") ="<< DSM.item(i,imin)
-                        << "  DSM("<<i+1<<","<<jmin+1<<") ="<< DSM.item(i,jmin)
-                        << " ? minimum DSM("<<i+1<<","<<j+1<<" ="<<distanceNewCluster;
-                break;
+    // The chain finds the merges out of level order. Sort them by level;
+    // the sort is stable, so any merge still follows the merges it builds on.
+    std::stable_sort( merges.begin(), merges.end(),
+                      [](const ClusterMerge &x, const ClusterMerge &y) {
+                          return x.level < y.level;
+                      } );
 
-            case Clustering::Complete_Linkage: // "complete-linkage":
-                if (i==j) {
-                    distanceNewCluster = 0;
-                }
-                else {
-                    distanceNewCluster= (DSM.item(i,imin) > DSM.item(i,jmin) ) ? DSM.item(i,imin) : DSM.item(i,jmin);
+    int seq = 1 ; //clustering stage/level sequence number
 
-                }
-                qDebug() << "Graph::graphClusteringHierarchical() - "
-                        << "  DSM("<<i+1<<","<<imin+1<<") ="<< DSM.item(i,imin)
-                        << "  DSM("<<i+1<<","<<jmin+1<<") ="<< DSM.item(i,jmin)
-                        << " ? maximum DSM("<<i+1<<","<<j+1<<" ="<<distanceNewCluster;
-                break;
+    for ( const ClusterMerge &merge : merges ) {
 
-            case Clustering::Average_Linkage: //mean or "average-linkage" or UPGMA
-                if (i==j) {
-                    distanceNewCluster = 0;
-                }
-                else {
-                    distanceNewCluster= ( DSM.item(i,imin)  + DSM.item(i,jmin) ) / 2;
-                }
-                qDebug() << "Graph::graphClusteringHierarchical() - "
-                        << "  DSM("<<i+1<<","<<imin+1<<") ="<< DSM.item(i,imin)
-                        << "  DSM("<<i+1<<","<<jmin+1<<") ="<< DSM.item(i,jmin)
-                        << " ? average DSM("<<i+1<<","<<j+1<<" ="<<distanceNewCluster;
-                break;
+        // Members of the cluster in the lower slot come first
+        clusteredItems = clusterMembers[merge.slot1] + clusterMembers[merge.slot2];
 
-            default:
-                distanceNewCluster= (DSM.item(i,imin) < DSM.item(i,jmin) ) ? DSM.item(i,imin) : DSM.item(i,jmin);
-                break;
-            }
+        m_clusteringLevel << merge.level;
+        m_clustersPerSequence.insert( seq, clusteredItems);
 
-            DSM.setItem(i, j, distanceNewCluster);
-            DSM.setItem(j, i, distanceNewCluster);
+        qDebug() << "Graph::graphClusteringHierarchical() -"
+                 << "level"<< merge.level
+                 << "seq" << seq
+                 <<"clusteredItems in level"  <<clusteredItems;
 
-            // DSM.setItem(deletedClusterIndex, j, RAND_MAX);
-            // DSM.setItem(j, deletedClusterIndex, RAND_MAX);
+        if (diagram) {
 
+            cluster1 = clusterNames[merge.slot1];
+            cluster2 = clusterNames[merge.slot2];
 
-        }
+            clusterPairNames.clear();
+            clusterPairNames.append(cluster1);
+            clusterPairNames.append(cluster2);
 
+            m_clusterPairNamesPerSeq.insert(seq, clusterPairNames);
 
-        qDebug() << "Graph::graphClusteringHierarchical() - Finished."
-                 << "Resizing old DSM matrix";
-        //DSM.printMatrixConsole();
-        DSM.deleteRowColumn(deletedClusterIndex);
+            clusterNames[merge.slot1] = "c"+QString::number(seq);
+            m_clustersByName.insert(clusterNames[merge.slot1], clusteredItems );
 
-        clustersLeft --;
-        seq ++;
+        } //end if diagram
 
-        //
-        //Step 4. Repeat steps 2 and 3 until all remaining items/clusters
-        //        are clustered into a single cluster of size N
-        //
+        clusterMembers[merge.slot1] = clusteredItems;
+        clusterMembers[merge.slot2].clear();
 
-    }   // end while clustersLeft
+        seq ++;
+    }
 
     clusteredItems.clear();
-    m_clustersIndex.clear();
+    clusterMembers.clear();
 
     qDebug()<< "m_clustersByName" <<m_clustersByName;
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
     return true;
 }
@@ -14216,6 +18394,9 @@ void Graph::writeMatrixSimilarityMatchingPlain(const QString fileName,
                                                const bool &diagonal,
                                                const bool &considerWeights) {
 
+    GraphTraceScope trace("Graph::writeMatrixSimilarityMatchingPlain");
+    trace.setInput( vertices(), edgesEnabled() );
+
     Q_UNUSED(considerWeights);
 
     QFile file ( fileName );
@@ -14320,6 +18501,9 @@ void Graph::writeMatrixDissimilarities(const QString fileName,
                                        const bool &diagonal,
                                        const bool &considerWeights) {
 
+    GraphTraceScope trace("Graph::writeMatrixDissimilarities");
+    trace.setInput( vertices(), edgesEnabled() );
+
     qDebug()<< "Graph::writeMatrixDissimilarities()"
             << "metric" << metricStr
             << "varLocation" << varLocation
@@ -14460,6 +18644,11 @@ void Graph::graphMatrixDissimilaritiesCreate(Matrix &INPUT_MATRIX,
                                              const QString &varLocation,
                                              const bool &diagonal,
                                              const bool &considerWeights){
+
+    GraphTraceScope trace("Graph::graphMatrixDissimilaritiesCreate");
+    trace.setInput( INPUT_MATRIX.rows(), edgesEnabled(),
+                    QString("metric=%1 varLocation=%2 diagonal=%3 considerWeights=%4")
+                    .arg(metric).arg(varLocation).arg(diagonal).arg(considerWeights) );
     qDebug()<<"Graph::graphMatrixDissimilaritiesCreate() -metric" << metric;
 
     DSM = INPUT_MATRIX.distancesMatrix(metric, varLocation, diagonal, considerWeights);
@@ -14488,6 +18677,9 @@ void Graph::writeMatrixSimilarityMatching(const QString fileName,
                                           const bool &diagonal,
                                           const bool &considerWeights) {
 
+    GraphTraceScope trace("Graph::writeMatrixSimilarityMatching");
+    trace.setInput( vertices(), edgesEnabled() );
+
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -14524,7 +18716,7 @@ void Graph::writeMatrixSimilarityMatching(const QString fileName,
 
     QString pMsg = tr("Writing Similarity coefficients to file. \nPlease wait...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(1, pMsg);
+    graphProgressCreate(1, pMsg);
 
     outText.setRealNumberPrecision(m_reportsRealPrecision);
 
@@ -14595,7 +18787,7 @@ void Graph::writeMatrixSimilarityMatching(const QString fileName,
             <<"</span>"
             << "</p>";
 
-    emit signalProgressBoxUpdate(0);
+    graphProgressUpdate(0);
     //SCM.printHTMLTable(outText);
     writeMatrixHTMLTable(outText,SCM, true);
 
@@ -14639,8 +18831,8 @@ void Graph::writeMatrixSimilarityMatching(const QString fileName,
 
     file.close();
 
-    emit signalProgressBoxUpdate(1);
-    emit signalProgressBoxKill();
+    graphProgressUpdate(1);
+    graphProgressKill();
 }
 
 
@@ -14660,13 +18852,18 @@ void Graph::graphMatrixSimilarityMatchingCreate (Matrix &AM,
                                                  const QString &varLocation,
                                                  const bool &diagonal,
                                                  const bool &considerWeights){
+
+    GraphTraceScope trace("Graph::graphMatrixSimilarityMatchingCreate");
+    trace.setInput( AM.rows(), edgesEnabled(),
+                    QString("measure=%1 varLocation=%2 diagonal=%3 considerWeights=%4")
+                    .arg(measure).arg(varLocation).arg(diagonal).arg(considerWeights) );
     qDebug()<<"Graph::graphMatrixSimilarityMatchingCreate()";
 
     QString pMsg = tr ("Computing Similarity coefficients matrix. \nPlease wait...");
-    emit signalProgressBoxCreate(1, pMsg);
+    graphProgressCreate(1, pMsg);
     SCM.similarityMatrix(AM, measure, varLocation, diagonal, considerWeights);
-    emit signalProgressBoxUpdate(1);
-    emit signalProgressBoxKill();
+    graphProgressUpdate(1);
+    graphProgressKill();
 }
 
 
@@ -14683,6 +18880,9 @@ void Graph::writeMatrixSimilarityPearson(const QString fileName,
                                          const QString &varLocation,
                                          const bool &diagonal) {
 
+    GraphTraceScope trace("Graph::writeMatrixSimilarityPearson");
+    trace.setInput( vertices(), edgesEnabled() );
+
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -14830,6 +19030,9 @@ void Graph::writeMatrixSimilarityPearsonPlainText(const QString fileName,
                                                   const QString &varLocation,
                                                   const bool &diagonal)
 {
+
+    GraphTraceScope trace("Graph::writeMatrixSimilarityPearsonPlainText");
+    trace.setInput( vertices(), edgesEnabled() );
     Q_UNUSED(considerWeights);
     QFile file ( fileName );
     if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )  {
@@ -14922,6 +19125,11 @@ void Graph::graphMatrixSimilarityPearsonCreate (Matrix &AM,
                                                 Matrix &PCC,
                                                 const QString &varLocation,
                                                 const bool &diagonal){
+
+    GraphTraceScope trace("Graph::graphMatrixSimilarityPearsonCreate");
+    trace.setInput( AM.rows(), edgesEnabled(),
+                    QString("varLocation=%1 diagonal=%2")
+                    .arg(varLocation).arg(diagonal) );
     qDebug()<<"Graph::graphMatrixSimilarityPearsonCreate()";
 
 
@@ -14953,173 +19161,226 @@ qreal Graph::numberOfTriples(int v1){
 
 /**
  * @brief  Returns the local clustering coefficient (CLUCOF) of a vertex v1
+ * The neighborhood of v1 consists of the actors reciprocally connected to it.
+ * Counts the ties among them by intersecting the sorted rows of the CSR snapshot.
  * @param v1
  * @return
  */
 qreal Graph::clusteringCoefficientLocal(const int &v1){
     if ( !graphIsModified() && (m_graph[ vpos [v1] ] -> hasCLC() ) )  {
         qreal clucof=m_graph[ vpos [v1] ] ->CLC();
-        qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") - "
+        qCHotDebug(lcGraph) << "Graph::clusteringCoefficientLocal("<< v1 << ") - "
                  << " Not modified. Returning previous clucof = " << clucof;
         return clucof;
     }
 
-    qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") - "
+    qCHotDebug(lcGraph) << "Graph::clusteringCoefficientLocal("<< v1 << ") - "
             << " Graph changed or clucof not calculated.";
 
-    bool isSymmetric = false;
-
-    if ( graphIsSymmetric() ) {
-        isSymmetric = true;
-    }
-    else {
-        isSymmetric = false;
-    }
+    const bool isSymmetric = graphIsSymmetric();
+    const GraphCSR &csr = graphCSR();
+    const int i = vpos[v1];
 
     qreal clucof=0, denom = 0 , nom = 0;
-    int u1 = 0 , u2 = 0, k = 0;
-
-    H_StrToBool neighborhoodEdges;
-    neighborhoodEdges.clear();
+    int k = 0;
 
-    qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") - vertex " << v1
-             << "[" << vpos[v1] << "] "
-             << " Checking adjacent edges " ;
+    QVector<int> neighbors, row;
+    csr.mutualNeighbors(i, neighbors);
+    k = neighbors.size();   //k_{i} is the number of neighbours of a vertex
 
-    QHash<int,qreal> reciprocalEdges ;
-    reciprocalEdges = m_graph [ vpos[v1] ] -> reciprocalEdgesHash();
+    foreach (int u, neighbors) {
+        if ( isSymmetric ) {
+            csr.mutualNeighbors(u, row);
+            nom += GraphCSR::intersectionCount( neighbors.constData(), k,
+                                                row.constData(), row.size() );
+        }
+        else {
+            // ties u -> w to other neighbors w of v1
+            nom += GraphCSR::intersectionCount( neighbors.constData(), k,
+                                                csr.outTargets() + csr.outBegin(u),
+                                                csr.outDegree(u) );
+            if ( csr.edgeWeight(u, u) != 0 ) {
+                nom--;
+            }
+        }
+    }
 
-    QHash<int,qreal>::const_iterator it1;
-    QHash<int,qreal>::const_iterator it2;
+    if ( isSymmetric ) {
+        // each tie in the neighborhood was found from both ends
+        nom = nom / 2.0;
+        denom =	k * (k -1.0) / 2.0;
+    }
+    else {
+        denom = k * (k -1.0);
+    }
 
-    it1=reciprocalEdges.cbegin();
+    clucof = ( nom == 0 ) ? 0 : nom / denom;
 
-    while ( it1 != reciprocalEdges.cend() )
-    {
-        u1 = it1.key();
-
-        qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-                 << v1
-                 << "<->"
-                 << u1
-                 << "[" << vpos[u1] << "] exists"
-                 << "weight " << it1.value();
-
-        if ( v1 == u1 ) {
-            qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-                     << "v1 == u1 - CONTINUE";
-            ++it1;
-            continue;
-        }
+    qCHotDebug(lcGraph) << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
+             << "ties in neighborhood" << nom
+             << "max" << denom
+             << "CLUCOF = "<< clucof;
 
-        it2=reciprocalEdges.cbegin();
-        qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-                 << "Checking if neighbor" << u1
-                 << "is connected to other neighbors of" << v1;
+    m_graph[ i ] -> setCLC(clucof);
 
-        while ( it2 != reciprocalEdges.cend() ){
+    return clucof;
+}
 
-            u2 = it2.key();
 
-            qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-                     << "Other neighbor" << u2
-                     << "Check if there is an edge"
-                     << u1
-                     << "[" << vpos[u1] << "]"
-                        << "->" << u2 ;
 
-            if ( u1 == u2 ) {
-                qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-                         << "u1 == u2 - CONTINUE";
-                ++it2;
-                continue;
-            }
+/**
+ * @brief Computes the local clustering coefficients of all vertices at once
+ * and stores them with setCLC().
+ *
+ * On symmetric graphs it counts triangles: vertices are ranked by degree and
+ * each tie is oriented from the lower to the higher ranked end, so that every
+ * triangle is found exactly once, by intersecting the oriented rows of two of
+ * its vertices. On other graphs, it counts for each vertex the arcs among its
+ * reciprocal neighbors, by intersecting its neighborhood with their out-rows.
+ * Both run on a pool of workers, and every vertex and tie is counted by one
+ * worker only, so no counts are shared or merged. All the work is in
+ * GraphCSR::intersectionCount(), which merges the rows with AVX2 or NEON
+ * where available.
+ */
+void Graph::clusteringCoefficientsCompute() {
 
+    const bool isSymmetric = graphIsSymmetric();
+    const GraphCSR &csr = graphCSR();
+    const int N = csr.vertices();
+    int i = 0;
 
-            if ( edgeExists( u1, u2 ) != 0 )
-            {
-                qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-                         << "Connected neighbors: "
-                         << u1 << " -> " << u2;
+    qDebug() << "Graph::clusteringCoefficientsCompute() - vertices" << N
+             << "symmetric" << isSymmetric;
 
-                QString edge = QString::number(u1) + "->" + QString::number(u2);
-                QString revedge = QString::number(u2) + "->" + QString::number(u1);
+    // Reciprocal neighborhoods, as a flat CSR
+    QVector<int> offsets(N+1, 0), neighbors, row;
+    for (i = 0; i < N; ++i) {
+        offsets[i] = neighbors.size();
+        csr.mutualNeighbors(i, row);
+        neighbors += row;
+    }
+    offsets[N] = neighbors.size();
 
-                if ( isSymmetric ) {
-                    if ( ! neighborhoodEdges.contains(edge) &&
-                         ! neighborhoodEdges.contains(revedge)  )    {
-                        neighborhoodEdges.insert(edge, true);
-                        qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-                                 << "Edge added to neighborhoodEdges : " << edge;
+    const int *nbs = neighbors.constData();
+    const int threads = graphWorkerThreads(N);
+    vector<qreal> nom(N, 0);
 
-                    }
-                    else {
-                        qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-                                 << "Edge not added, discovered previously : " << edge;
-                    }
+    if ( isSymmetric ) {
 
-                }
-                else {
-                    if ( ! neighborhoodEdges.contains(edge) ) {
-                        neighborhoodEdges.insert(edge, true);
-                        qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-                                 << "Edge added to neighborhoodEdges : " << edge;
-                    }
-                    else {
-                        qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-                                 << "Edge not added, discovered previously : " << edge;
-                    }
+        // Rank vertices by degree, ties by index, and keep the higher ranked
+        // neighbors of each vertex. Rows stay sorted by index.
+        QVector<int> order(N), rank(N);
+        for (i = 0; i < N; ++i) {
+            order[i] = i;
+        }
+        std::sort( order.begin(), order.end(), [&](const int &a, const int &b) {
+            const int da = offsets[a+1] - offsets[a];
+            const int db = offsets[b+1] - offsets[b];
+            return ( da < db ) || ( da == db && a < b );
+        } );
+        for (i = 0; i < N; ++i) {
+            rank[ order[i] ] = i;
+        }
 
+        QVector<int> fwdOffsets(N+1, 0), fwd;
+        fwd.reserve( neighbors.size() / 2 );
+        for (i = 0; i < N; ++i) {
+            fwdOffsets[i] = fwd.size();
+            for (int e = offsets[i]; e < offsets[i+1]; ++e) {
+                if ( rank[ nbs[e] ] > rank[i] ) {
+                    fwd.append( nbs[e] );
                 }
-
             }
-
-            ++it2;
         }
-        ++it1;
-    }
-
-    nom=neighborhoodEdges.count();
-
-    qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-            << "neighborhoodEdges.count() =" <<  nom;
-
-    if ( nom == 0)
-        return 0;	//stop if we're at a leaf.
+        fwdOffsets[N] = fwd.size();
 
-    if ( isSymmetric ){
-        k=reciprocalEdges.count();  //k_{i} is the number of neighbours of a vertex
-        denom =	k * (k -1.0) / 2.0;
-
-        qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-                    << "Symmetric graph. "
-                    << "Max edges in neighborhood" << denom ;
+        // The transpose of the oriented rows: the lower ranked neighbors of
+        // each vertex, sorted by index, and where each tie sits in fwd
+        QVector<int> bwdOffsets(N+1, 0), bwd( fwd.size() ), bwdTie( fwd.size() );
+        for (int e = 0; e < fwd.size(); ++e) {
+            bwdOffsets[ fwd[e] + 1 ]++;
+        }
+        for (i = 0; i < N; ++i) {
+            bwdOffsets[i+1] += bwdOffsets[i];
+        }
+        QVector<int> cursor( bwdOffsets );
+        for (i = 0; i < N; ++i) {
+            for (int e = fwdOffsets[i]; e < fwdOffsets[i+1]; ++e) {
+                const int p = cursor[ fwd[e] ]++;
+                bwd[p] = i;
+                bwdTie[p] = e;
+            }
+        }
 
+        const int *f = fwd.constData();
+        const int *bw = bwd.constData();
+
+        // The triangle {u,v,w} ranked u < v < w is found once, as a common
+        // higher ranked neighbor of the tie u->v. Each worker writes only
+        // the counts of its own ties and vertices, so that no counts are
+        // shared: support[e] is the number of triangles over the tie e.
+        vector<int> support( fwd.size(), 0 );
+        graphParallelFor( N, threads, [&](const int &, const int &u) {
+            const int *uRow = f + fwdOffsets[u];
+            const int uSize = fwdOffsets[u+1] - fwdOffsets[u];
+            for (int e = fwdOffsets[u]; e < fwdOffsets[u+1]; ++e) {
+                const int v = f[e];
+                support[e] = GraphCSR::intersectionCount( uRow, uSize,
+                                                          f + fwdOffsets[v],
+                                                          fwdOffsets[v+1] - fwdOffsets[v] );
+            }
+        }, false );
+
+        // A vertex is the lowest ranked of the triangles over its higher
+        // ranked ties, the middle one of those over its lower ranked ties,
+        // and the highest ranked one of the ties among its lower neighbors
+        graphParallelFor( N, threads, [&](const int &, const int &x) {
+            qint64 tri = 0;
+            for (int e = fwdOffsets[x]; e < fwdOffsets[x+1]; ++e) {
+                tri += support[e];
+            }
+            const int *xRow = bw + bwdOffsets[x];
+            const int xSize = bwdOffsets[x+1] - bwdOffsets[x];
+            for (int p = bwdOffsets[x]; p < bwdOffsets[x+1]; ++p) {
+                const int v = bw[p];
+                tri += support[ bwdTie[p] ];
+                tri += GraphCSR::intersectionCount( xRow, xSize,
+                                                    bw + bwdOffsets[v],
+                                                    bwdOffsets[v+1] - bwdOffsets[v] );
+            }
+            nom[x] = tri;
+        } );
     }
     else {
-        // fixme : normally we should have a special method
-        // to compute the number of vertices k_i = |N_i|, in the neighborhood N_i
-        k=reciprocalEdges.count();
-        denom = k * (k -1.0);
-
-        qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") - "
-                    << "Not symmetric graph. "
-                    << "Max edges in neighborhood" << denom ;
+        graphParallelFor( N, threads, [&](const int &, const int &v) {
+            const int *vBegin = nbs + offsets[v];
+            const int k = offsets[v+1] - offsets[v];
+            qreal ties = 0;
+            for (int e = 0; e < k; ++e) {
+                const int u = vBegin[e];
+                ties += GraphCSR::intersectionCount( vBegin, k,
+                                                     csr.outTargets() + csr.outBegin(u),
+                                                     csr.outDegree(u) );
+                if ( csr.edgeWeight(u, u) != 0 ) {
+                    ties--;
+                }
+            }
+            nom[v] = ties;
+        } );
     }
 
-    clucof = nom / denom;
-
-    qDebug() << "Graph::clusteringCoefficientLocal("<< v1 << ") -"
-             << "CLUCOF = "<< clucof;
-
-    m_graph[ vpos [v1] ] -> setCLC(clucof);
+    qreal k = 0, denom = 0;
+    for (i = 0; i < N; ++i) {
+        k = offsets[i+1] - offsets[i];
+        denom = ( isSymmetric ) ? k * (k - 1.0) / 2.0 : k * (k - 1.0);
+        m_graph[i]->setCLC( ( nom[i] == 0 ) ? 0 : nom[i] / denom );
+    }
 
-    reciprocalEdges.clear();
-    neighborhoodEdges.clear();
-    return clucof;
+    qDebug() << "Graph::clusteringCoefficientsCompute() - finished";
 }
 
 
+
 /**
  * @brief Computes local clustering coefficients and returns
  * the network average Clustering Coefficient
@@ -15127,28 +19388,30 @@ qreal Graph::clusteringCoefficientLocal(const int &v1){
  * @return
  */
 qreal Graph::clusteringCoefficient (const bool updateProgress){
-    qDebug()<< "Graph::clusteringCoefficient()";
+
+    GraphTraceScope trace("Graph::clusteringCoefficient");
+    trace.setInput( vertices(), edgesEnabled() );
+    qCHotDebug(lcGraph)<< "Graph::clusteringCoefficient()";
     averageCLC=0;
     varianceCLC=0;
     maxCLC=0; minCLC=1;
     qreal temp=0;
     qreal x=0;
     qreal N = vertices();
-    int progressCounter = 0;
     VList::const_iterator vertex;
 
-    QString pMsg = tr("Computing Clustering Coefficient. \n"
-                      "Please wait...");
-    emit statusMessage(pMsg);
-    emit signalProgressBoxCreate(N,pMsg);
+    if (updateProgress) {
+        QString pMsg = tr("Computing Clustering Coefficient. \n"
+                          "Please wait...");
+        emit statusMessage(pMsg);
+        graphProgressCreate(N,pMsg);
+    }
 
-    for ( vertex = m_graph.cbegin(); vertex != m_graph.cend(); ++vertex) {
+    clusteringCoefficientsCompute();
 
-        if (updateProgress) {
-            emit signalProgressBoxUpdate(++progressCounter);
-        }
+    for ( vertex = m_graph.cbegin(); vertex != m_graph.cend(); ++vertex) {
 
-        temp = clusteringCoefficientLocal( (*vertex)->name() );
+        temp = (*vertex)->CLC();
 
         if (temp > maxCLC)  {
             maxCLC = temp;
@@ -15164,7 +19427,7 @@ qreal Graph::clusteringCoefficient (const bool updateProgress){
 
     averageCLC = averageCLC / N ;
 
-    qDebug() << "Graph::clusteringCoefficient() network average " << averageCLC;
+    qCHotDebug(lcGraph) << "Graph::clusteringCoefficient() network average " << averageCLC;
 
     for ( vertex = m_graph.cbegin(); vertex != m_graph.cend(); ++vertex) {
         x = (  (*vertex)->CLC()  -  averageCLC  ) ;
@@ -15173,10 +19436,10 @@ qreal Graph::clusteringCoefficient (const bool updateProgress){
 
     }
 
-    varianceIC  /=  N;
+    varianceCLC  /=  N;
 
     if (updateProgress) {
-        emit signalProgressBoxKill();
+        graphProgressKill();
     }
 
     return averageCLC;
@@ -15189,329 +19452,167 @@ qreal Graph::clusteringCoefficient (const bool updateProgress){
  * @brief Graph::graphTriadCensus
  *  Conducts a triad census and updates QList::triadTypeFreqs,
  * 		which is the list carrying all triad type frequencies
- *  Complexity:O(n!)
+ *
+ * Implements the subquadratic algorithm of Batagelj and Mrvar (2001), which
+ * visits only the triads that contain at least one connected dyad, each one
+ * exactly once, and classifies them by their 6-bit arc code.
+ * Triads with a single connected dyad (012, 102) are counted in bulk per dyad,
+ * while the 003 triads are derived by subtraction from the total.
+ * Source vertices are handed out to a pool of graphWorkerThreads()
+ * workers, each one with its own frequencies, which are summed at the end.
+ *  Complexity: O(m * Δ) where Δ is the maximum degree.
  * @return
  */
 bool Graph::graphTriadCensus(){
-    int mut=0, asy=0, nul =0;
-    int temp_mut=0, temp_asy=0, temp_nul =0, counter_021=0;
-    int ver1, ver2, ver3;
-    int N = vertices();
-    int progressCounter = 0;
 
-    VList::const_iterator v1;
-    VList::const_iterator v2;
-    VList::const_iterator v3;
+    GraphTraceScope trace("Graph::graphTriadCensus");
+    trace.setInput( vertices(), edgesEnabled() );
 
-    qDebug() << "Graph::graphTriadCensus()";
     /*
      * QList::triadTypeFreqs stores triad type frequencies with the following order:
      * 0	1	2	3		4	5	6	7	8		9	10	11	12		13	14	15
      * 003 012 102	021D 021U 021C 111D	111U 030T 030C 201 	120D 120U 120C 210 300
     */
 
-    for (int i = 0; i <= 15; ++i) {
-        triadTypeFreqs.append(0);
-        qDebug() << " initializing triadTypeFreqs[" << i << "] = "<< triadTypeFreqs[i];
-    }
-
-
-    QString pMsg = tr("Computing Triad Census. \nPlease wait...") ;
-    emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
-
-    for (v1=m_graph.cbegin(); v1!=m_graph.cend(); v1++) {
-
-        emit signalProgressBoxUpdate( ++progressCounter );
-
-        for (v2=(v1+1); v2!=m_graph.cend(); v2++) {
-
-            ver1=(*v1)->name();
-            ver2=(*v2)->name();
-
-            temp_mut=0, temp_asy=0, temp_nul =0;
-
-            if ( (*v1)->hasEdgeTo( ver2 ) ) {
-                if ( (*v2)->hasEdgeTo( ver1 ) )
-                    temp_mut++;
-                else
-                    temp_asy++;
-            }
-            else if ( (*v2)->hasEdgeTo( ver1 )  )
-                temp_asy++;
-            else
-                temp_nul++;
-
-            for (v3=(v2+1); v3!=m_graph.cend(); v3++){
-
-                mut = temp_mut ;
-                asy = temp_asy ;
-                nul = temp_nul ;
-
-                ver3=(*v3)->name();
-
-                if ( (*v1)->hasEdgeTo( ver3 ) ) {
-                    if ( (*v3)->hasEdgeTo( ver1 ) )
-                        mut++;
-                    else
-                        asy++;
-                }
-                else if ( (*v3)->hasEdgeTo( ver1 )  )
-                    asy++;
-                else
-                    nul++;
-
-                if ( (*v2)->hasEdgeTo( ver3 ) ) {
-                    if ( (*v3)->hasEdgeTo( ver2 ) )
-                        mut++;
-                    else
-                        asy++;
-                }
-                else if ( (*v3)->hasEdgeTo( ver2 )  )
-                    asy++;
-                else
-                    nul++;
-
-                qDebug()<< "triad of ("<< ver1 << ","<< ver2 << ","<< ver3
-                        << ") = ("	<<mut<<","<< asy<<","<<nul<<")";
-                triadType_examine_MAN_label(mut, asy, nul, (*v1), (*v2),  (*v3) ) ;
-
-                if ( mut==3 && asy==0 && nul==0 ){
-                    counter_021++;
-                }
-            } // end 3rd for
-
-        }// end 2rd for
-
-    }// end 1rd for
-    qDebug() << " ****** 003 COUNTER: "<< counter_021;
-
-    calculatedTriad=true;
-
-    emit signalProgressBoxKill();
-
-    return true;
-}
-
+    // Maps the arc code of a triad (v,u,w) to its type index above, where
+    // code = link(v,u) + 2 link(u,v) + 4 link(v,w) + 8 link(w,v) + 16 link(u,w) + 32 link(w,u)
+    static const int triadCodeType[64] = {
+        0, 1, 1, 2, 1, 3, 5, 7, 1, 5, 4, 6, 2, 7, 6, 10,
+        1, 5, 3, 7, 4, 8, 8, 12, 5, 9, 8, 13, 6, 13, 11, 14,
+        1, 4, 5, 6, 5, 8, 9, 13, 3, 8, 8, 11, 7, 12, 13, 14,
+        2, 6, 7, 10, 6, 11, 13, 14, 7, 13, 12, 14, 10, 14, 14, 15
+    };
 
+    const GraphCSR &csr = graphCSR();
+    const int N = csr.vertices();
+    int i=0, a=0, b=0;
 
+    graphCancelReset();
 
-/** 
-    Examines the triad type (in Mutual-Asymmetric-Null label format)
-    and increases by one the proper frequency element
-    inside QList::triadTypeFreqs
-*/
-void Graph::triadType_examine_MAN_label(int mut, int asy, int nul,
-                                        GraphVertex* vert1,
-                                        GraphVertex* vert2,
-                                        GraphVertex* vert3
-                                        ) 	{
-    VList m_triad;
-    bool isDown=false, isUp=false, isCycle=false, isTrans=false;
-    bool isOutLinked=false, isInLinked=false;
-
-    qDebug () << "Graph::triadType_examine_MAN_label() "
-        << " adding ("<< vert1->name() << ","<< vert2->name()
-        << ","<< vert3->name() << ") to m_triad ";
-
-    m_triad<<vert1<<vert2<<vert3;
-
-    switch (mut){
-    case 0:
-        switch (asy){
-        case 0:	//"003";
-            triadTypeFreqs[0] ++;
-            break;
-        case 1:	 //"012";
-            triadTypeFreqs[1] ++;
-            break;
-        case 2:
-            // "021?" - find out!
-            //	qDebug() << "triad vertices: ( "<< vert1->name() << ", "<< vert2->name()<< ", "<< vert3->name()<< " ) = ("	<<mut<<","<< asy<<","<<nul<<")";
-            foreach (GraphVertex *source, m_triad)  {
-                //qDebug() << "  vertex " << source->name() ;
-                isOutLinked=false; isInLinked=false;
-
-                foreach (GraphVertex *target, m_triad)  	{
-                    if ( source->name() == target->name() )
-                        continue;
+    qCHotDebug(lcGraph) << "Graph::graphTriadCensus() - vertices" << N;
 
-                    if ( source->hasEdgeTo(target->name()) ){
-                        if ( isOutLinked ){
-                            triadTypeFreqs[3] ++;//"021D"
-                            break;
-                        }
-                        else if (isInLinked){
-                            triadTypeFreqs[5] ++;//"021C"
-                            break;
-                        }
-                        else{
-                            isOutLinked=true;
-                        }
-                    }
-                    else if( target->hasEdgeTo(source->name()) ){
-                        //	qDebug() << "    vertex " << source->name()  << " is IN linked from " <<target->name();
-                        if ( isInLinked ){
-                            triadTypeFreqs[4] ++;//"021U"
-                            break;
-                        }
-                        else if (isOutLinked){
-                            triadTypeFreqs[5] ++;//"021C"
-                            break;
-                        }
-                        else{
-                            isInLinked=true;
-                        }
-                    }
+    QString pMsg = tr("Computing Triad Census. \nPlease wait...") ;
+    emit statusMessage( pMsg );
+    graphProgressCreate(N,pMsg);
+
+    // Undirected neighborhoods, sorted and without self-ties
+    QVector< QVector<int> > nbs(N);
+    for (i = 0; i < N; ++i) {
+        a = csr.outBegin(i);
+        b = csr.inBegin(i);
+        while ( a < csr.outEnd(i) || b < csr.inEnd(i) ) {
+            int next = 0;
+            if ( b == csr.inEnd(i) ||
+                 ( a < csr.outEnd(i) && csr.outTarget(a) <= csr.inSource(b) ) ) {
+                next = csr.outTarget(a);
+                if ( b < csr.inEnd(i) && csr.inSource(b) == next ) {
+                    b++;
                 }
+                a++;
             }
-            break;
-        case 3:
-            qDebug() << "triad vertices: ( "<< vert1->name() << ", "<< vert2->name()<< ", "<< vert3->name()<< " ) = ("	<<mut<<","<< asy<<","<<nul<<")";
-            isTrans=false;
-            foreach (GraphVertex *source, m_triad)  {
-                qDebug() << "  vertex " << source->name() ;
-
-                isOutLinked=false;
-
-                foreach (GraphVertex *target, m_triad)  	{
-                    if ( source->name() == target->name() )
-                        continue;
-
-                    if ( source->hasEdgeTo(target->name()) ){
-
-                        if ( isOutLinked ){
-                            triadTypeFreqs[8] ++;//"030T"
-                            isTrans=true;
-                            break;
-                        }
-                        else{
-                            isOutLinked=true;
-                        }
-                    }
-                }
+            else {
+                next = csr.inSource(b);
+                b++;
             }
-            if ( ! isTrans ) {//"030C"
-                triadTypeFreqs[9] ++;
+            if ( next != i ) {
+                nbs[i].append(next);
             }
-            break;
         }
-        break;
-
-    case 1:
-        switch (asy){
-        case 0:	//"102";
-            triadTypeFreqs[2] ++;
-            break;
-        case 1:
-            isDown=false; isUp=false;
-            //qDebug() << "triad vertices: ( "<< vert1->name() << ", "<< vert2->name()<< ", "<< vert3->name()<< " ) = ("	<<mut<<","<< asy<<","<<nul<<")";
-            foreach (GraphVertex *source, m_triad)  {
-                //	qDebug() << "  vertex " << source->name() ;
+    }
 
-                isInLinked=false;
+    const int threads = graphWorkerThreads(N);
 
-                foreach (GraphVertex *target, m_triad)  	{
-                    if ( source->name() == target->name() )
-                        continue;
+    vector< vector<qint64> > freqs( threads, vector<qint64>(16, 0) );
+    vector< QVector<int> > unions(threads);
 
-                    if ( target->hasEdgeTo(source->name()) ){
+    qCHotDebug(lcGraph) << "Graph::graphTriadCensus() - starting" << threads << "workers";
 
-                        if ( isInLinked ){
-                            triadTypeFreqs[6] ++;//"030T"
-                            isUp=true;
-                            break;
-                        }
-                        else{
-                            isInLinked=true;
-                        }
+    GraphScheduler::parallelFor( N, threads,
+                                 [&](const int &t, const int &first, const int &last) {
+        vector<qint64> &f = freqs[t];
+        QVector<int> &S = unions[t];
+        for (int v = first; v < last; ++v) {
+            const QVector<int> &nv = nbs[v];
+            foreach (int u, nv) {
+                if ( u <= v ) {
+                    continue;
+                }
+                const QVector<int> &nu = nbs[u];
+
+                // S = N(v) ∪ N(u) \ {u, v}
+                S.clear();
+                int x = 0, y = 0;
+                while ( x < nv.size() || y < nu.size() ) {
+                    int w = 0;
+                    if ( y == nu.size() || ( x < nv.size() && nv[x] < nu[y] ) ) {
+                        w = nv[x++];
+                    }
+                    else if ( x == nv.size() || nu[y] < nv[x] ) {
+                        w = nu[y++];
+                    }
+                    else {
+                        w = nv[x++];
+                        y++;
+                    }
+                    if ( w != u && w != v ) {
+                        S.append(w);
                     }
                 }
-            }
-            if ( ! isUp ) {//"111U"
-                triadTypeFreqs[7] ++;
-            }
-            break;
-        case 2:
-            isDown=false; isUp=false; isCycle=true;
-            qDebug() << "triad vertices: ( "<< vert1->name() << ", "
-                     << vert2->name()<< ", "<< vert3->name()<< " ) = ("
-                     <<mut<<","<< asy<<","<<nul<<")";
-
-            foreach (GraphVertex *source, m_triad)  {
-                //qDebug() << "  vertex " << source->name() ;
-                isOutLinked=false; isInLinked=false;
-
-                foreach (GraphVertex *target, m_triad)  	{
-                    if ( source->name() == target->name() )
-                        continue;
 
-                    if ( source->hasEdgeTo(target->name()) ){
-                        if (target->hasEdgeTo(source->name() ) ){
-                            isInLinked=true;
-                            isOutLinked=true;
-                            continue;
-                        }
-                        else if ( isOutLinked && !isInLinked ){
-                            triadTypeFreqs[11] ++;//"120D"
-                            isDown=true;
-                            isCycle=false;
-                            break;
-                        }
-                        else{
-                            isOutLinked=true;
-                        }
-                    }
-                    else if( target->hasEdgeTo(source->name()) ){
-                        //	qDebug() << "    vertex " << source->name()  << " is IN linked from " <<target->name();
-                        if (source->hasEdgeTo(target->name())){
-                            isOutLinked=true;
-                            isInLinked=true;
-                            continue;
-                        }
-                        else if ( isInLinked && !isOutLinked ){
-                            triadTypeFreqs[12] ++;//"120U"
-                            isUp=true;
-                            isCycle=false;
-                            break;
-                        }
-                        else{
-                            isInLinked=true;
-                        }
+                // Dyadic triads: (v,u) connected, w any non-neighbor of both
+                const bool mutual = ( csr.edgeWeight(v, u) != 0 &&
+                                      csr.edgeWeight(u, v) != 0 );
+                f[ mutual ? 2 : 1 ] += N - S.size() - 2;
+
+                // Connected triads, each one counted from its canonical dyad
+                foreach (int w, S) {
+                    if ( u < w ||
+                         ( v < w && w < u &&
+                           ! std::binary_search( nv.cbegin(), nv.cend(), w ) ) ) {
+                        const int code =
+                                ( csr.edgeWeight(v, u) != 0 ? 1 : 0 ) +
+                                ( csr.edgeWeight(u, v) != 0 ? 2 : 0 ) +
+                                ( csr.edgeWeight(v, w) != 0 ? 4 : 0 ) +
+                                ( csr.edgeWeight(w, v) != 0 ? 8 : 0 ) +
+                                ( csr.edgeWeight(u, w) != 0 ? 16 : 0 ) +
+                                ( csr.edgeWeight(w, u) != 0 ? 32 : 0 );
+                        f[ triadCodeType[code] ]++;
                     }
                 }
-                if (isUp || isDown)
-                    break;
             }
-            if ( isCycle ) {	//"120C"
-                triadTypeFreqs[13] ++;
-            }
-            break;
-        case 3:
-            // nothing here!
-            break;
         }
+    }, 1, [this](const int &done) { graphProgressUpdate(done); }, &m_cancelRequested );
 
-        break;
-    case 2:
-        switch (asy){
-        case 0:	// "201"
-            triadTypeFreqs[10] ++;
-            break;
-        case 1:	// "210"
-            triadTypeFreqs[14] ++;
-            break;
+    graphProgressUpdate( N );
+
+    if ( graphCancelled() ) {
+        // The frequencies of the workers are partial, keep none of them
+        qDebug() << "Graph::graphTriadCensus() - cancelled. Return.";
+        graphProgressKill();
+        emit statusMessage( tr("Computing triad census cancelled.") );
+        return false;
+    }
+
+    triadTypeFreqs.clear();
+    qint64 connected = 0;
+    for (i = 0; i <= 15; ++i) {
+        qint64 sum = 0;
+        for (int t = 0; t < threads; ++t) {
+            sum += freqs[t][i];
         }
-        break;
-    case 3:	// "300"
-        if (asy==0 && nul==0)
-            triadTypeFreqs[15] ++;
-        break;
+        triadTypeFreqs.append(sum);
+        connected += sum;
     }
+    triadTypeFreqs[0] = (qint64) N * ( N - 1 ) * ( N - 2 ) / 6 - connected;
 
+    qCHotDebug(lcGraph) << "Graph::graphTriadCensus() - triad type frequencies:" << triadTypeFreqs;
 
-}
+    calculatedTriad=true;
+
+    graphProgressKill();
 
+    return true;
+}
 
 
 
@@ -15574,9 +19675,20 @@ void Graph::graphLoad (	const QString m_fileName,
                         const int two_sm_mode,
                         const QString delimiter){
 
+    GraphTraceScope trace("Graph::graphLoad");
+    trace.setInput( 0, 0,
+                    QString("fileName=%1 fileFormat=%2")
+                    .arg(m_fileName).arg(fileFormat) );
+
 
     qDebug() << "Graph::graphLoad() - clearing relations ";
     relationsClear();
+
+    if ( fileFormat == FileType::BINARY ) {
+        // Native snapshots are mapped and replayed here, without the parser
+        graphLoadFromBinaryFormat(m_fileName);
+        return;
+    }
     qDebug() << "Graph::graphLoad() - "<< m_fileName
              << " calling parser.load() from thread " << this->thread();
 
@@ -15621,6 +19733,9 @@ void Graph::graphLoad (	const QString m_fileName,
     connect (file_parser, &Parser::edgeCreate,
              this,&Graph::edgeCreate);
 
+    connect (file_parser, &Parser::edgeCreateList,
+             this,&Graph::edgeCreateList);
+
 
     connect (
                 file_parser, SIGNAL(networkFileLoaded(int,
@@ -15652,6 +19767,9 @@ void Graph::graphLoad (	const QString m_fileName,
                 this, &Graph::graphLoadedTerminateParserThreads
                 );
 
+    // The parser creates the whole network; report it once, in graphFileLoaded()
+    graphBulkBegin();
+
     qDebug() << "Graph::graphLoad() - Starting file_parserThread ";
 
     file_parserThread.start();
@@ -15686,6 +19804,10 @@ void Graph::graphLoad (	const QString m_fileName,
 void Graph::graphLoadedTerminateParserThreads(QString reason) {
     qDebug() << "Graph::graphLoadedTerminateParserThreads() - reason " << reason
              <<" Checking if file_parserThread is running...";
+    if ( graphBulkBuilding() ) {
+        // The parser stopped without reporting a loaded file
+        graphBulkCommit(GraphChange::ChangedVerticesEdges, false);
+    }
     if (file_parserThread.isRunning() ) {
         qDebug() << "Graph::graphLoadedTerminateParserThreads() - deleting file_parser pointer";
         delete file_parser;
@@ -15722,6 +19844,7 @@ void Graph::graphFileLoaded (const int &fileType,
         qDebug() << "Graph::graphFileLoaded() - FileType::UNRECOGNIZED. "
                     "Emitting signalGraphLoaded with error message "
                  << message;
+        graphBulkCommit(GraphChange::ChangedVerticesEdges, false);
         emit signalGraphLoaded (fileType,
                                 QString(),
                                 QString(),
@@ -15757,9 +19880,9 @@ void Graph::graphFileLoaded (const int &fileType,
                 << " links" << totalLinks
                 << " edgeDirType" << edgeDirType;
 
-    qDebug() << "Graph::graphFileLoaded() -  Call graphSetModified";
+    qDebug() << "Graph::graphFileLoaded() -  Call graphBulkCommit";
 
-    graphSetModified(GraphChange::ChangedNew);
+    graphBulkCommit(GraphChange::ChangedNew);
 
     qDebug() << "Graph::graphFileLoaded() -  emit signalGraphLoaded()";
 
@@ -15805,10 +19928,15 @@ bool Graph::graphFileFormatExportSupported(const int &fileFormat) const {
  * @param fileType
   * @return
  */
-void Graph::graphSave(const QString &fileName,
+bool Graph::graphSave(const QString &fileName,
                       const int &fileType ,
                       const bool &saveEdgeWeights)
 {
+
+    GraphTraceScope trace("Graph::graphSave");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("fileName=%1 fileType=%2")
+                    .arg(fileName).arg(fileType) );
     qDebug() << "Graph::graphSave()";
     bool saved = false;
     m_fileFormat = fileType;
@@ -15820,7 +19948,10 @@ void Graph::graphSave(const QString &fileName,
     }
     case FileType::ADJACENCY: {
         qDebug() << "Graph::graphSave() - Adjacency formatted file";
-        saved=graphSaveToAdjacencyFormat(fileName, saveEdgeWeights) ;
+        // Save a sparse Matrix Market list if the file name ends in .mtx
+        saved=graphSaveToAdjacencyFormat(fileName, saveEdgeWeights,
+                                         CompressedFile::fileNameWithoutCompression(fileName)
+                                         .endsWith(".mtx", Qt::CaseInsensitive)) ;
         break;
     }
     case FileType::GRAPHVIZ: {
@@ -15833,6 +19964,11 @@ void Graph::graphSave(const QString &fileName,
         saved=graphSaveToGraphMLFormat(fileName);
         break;
     }
+    case FileType::BINARY: {
+        qDebug() << "Graph::graphSave() - SocNetV binary snapshot";
+        saved=graphSaveToBinaryFormat(fileName);
+        break;
+    }
     default: {
         m_fileFormat = FileType::UNRECOGNIZED;
         qDebug() << "Graph::graphSave() - Error! Unrecognized fileType";
@@ -15845,12 +19981,28 @@ void Graph::graphSave(const QString &fileName,
     else {
         emit signalGraphSavedStatus(FileType::UNRECOGNIZED);
     }
-
+    return saved;
 }
 
 
 
 
+/**
+ * @brief Returns the weight of the edge i -> j in the rows built by
+ * Graph::graphEdgeRows(), or 0 if there is no such edge.
+ */
+static qreal graphEdgeRowWeight(const vector<int> &offsets,
+                                const vector<int> &targets,
+                                const vector<qreal> &weights,
+                                const int &i, const int &j) {
+    vector<int>::const_iterator begin = targets.cbegin() + offsets[i];
+    vector<int>::const_iterator end = targets.cbegin() + offsets[i+1];
+    vector<int>::const_iterator it = lower_bound(begin, end, j);
+    return ( it != end && *it == j ) ? weights[ it - targets.cbegin() ] : 0;
+}
+
+
+
 /**
     Saves the active graph to a Pajek-formatted file
     Preserves node properties (positions, colours, etc)
@@ -15874,63 +20026,67 @@ bool Graph::graphSaveToPajekFormat (const QString &fileName, \
     maxHeight= (maxHeight== 0) ? canvasHeight:maxHeight;
 
 
-    QFile f( fileName );
+    // Compress the file if its name ends in .gz or .zst
+    CompressedFile f( fileName );
+    f.setCompression( CompressedFile::compressionForFileName(fileName) );
     if ( !f.open( QIODevice::WriteOnly | QIODevice::Text ) )  {
         emit statusMessage ( tr("Error. Could not write to ") + fileName );
         return false;
     }
-    QTextStream t( &f );
-    t.setCodec("UTF-8");
+    GraphFileWriter t( &f );
     t<<"*Network "<<networkName<<"\n";
 
     t<<"*Vertices "<< vertices() <<"\n";
     VList::const_iterator it;
-    VList::const_iterator jt;
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        qDebug()<<" Name x "<<  (*it)->name()  ;
         t<<(*it)->name()  <<" "<<"\""<<(*it)->label()<<"\"" ;
         t << " ic ";
         t<<  (*it)->colorToPajek();
-        qDebug()<<" Coordinates x " << (*it)->x()<< " "<<maxWidth<<" y " << (*it)->y()<< " "<<maxHeight;
         t << "\t\t" <<(*it)->x()/(maxWidth)<<" \t"<<(*it)->y()/(maxHeight);
         t << "\t"<<(*it)->shape();
         t<<"\n";
     }
 
+    // The edges each vertex has, as edgeExists() reports them
+    vector<int> offsets, targets;
+    vector<qreal> weights;
+    graphEdgeRows(offsets, targets, weights);
+    const int N = m_graph.size();
+
     t<<"*Arcs \n";
     qDebug()<< "Graph::graphSaveToPajekFormat: Arcs";
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        for (jt=m_graph.begin(); jt!=m_graph.end(); jt++){
-            qDebug() << "Graph::graphSaveToPajekFormat:  it=" << (*it)->name() << ", jt=" << (*jt)->name() ;
-            if  ( (weight=edgeExists ( (*it)->name(), (*jt)->name())) !=0
-                  &&   ( edgeExists ((*jt)->name(), (*it)->name())) != weight
-                  )
-            {
-                qDebug()<<"Graph::graphSaveToPajekFormat  weight "<< weight
-                       << " color "<<  (*it)->outLinkColor( (*jt)->name() ) ;
-                t << (*it)->name() <<" "<<(*jt)->name()<< " "<<weight;
+    for (int i = 0; i < N; ++i) {
+        for (int e = offsets[i]; e < offsets[i+1]; ++e) {
+            const int j = targets[e];
+            weight = weights[e];
+            if ( graphEdgeRowWeight(offsets, targets, weights, j, i) != weight ) {
+                t << m_graph[i]->name() <<" "<< m_graph[j]->name() << " "<<weight;
                 //FIXME bug in outLinkColor() when we remove then add many nodes from the end
-                t<< " c "<< (*it)->outLinkColor( (*jt)->name() );
+                t<< " c "<< m_graph[i]->outLinkColor( m_graph[j]->name() );
                 t <<"\n";
             }
-
         }
     }
 
     t<<"*Edges \n";
     qDebug() << "Graph::graphSaveToPajekFormat: Edges";
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        for (jt=m_graph.begin(); jt!=m_graph.end(); jt++){
-            qDebug() << "Graph::graphSaveToPajekFormat:  it=" <<  (*it)->name() << ", jt=" <<(*jt)->name() ;
-            if  ( ( weight=edgeExists((*it)->name(), (*jt)->name(), true) )!=0 )  {
-                if ( (*it)->name() > (*jt)->name() )
-                    continue;
-                t << (*it)->name() <<" "<<(*jt)->name()<< " "<<weight;
-                t << " c "<< (*it)->outLinkColor( (*jt)->name() );
+    for (int i = 0; i < N; ++i) {
+        for (int e = offsets[i]; e < offsets[i+1]; ++e) {
+            const int j = targets[e];
+            weight = weights[e];
+            if ( m_graph[i]->name() > m_graph[j]->name() )
+                continue;
+            if ( graphEdgeRowWeight(offsets, targets, weights, j, i) == weight ) {
+                t << m_graph[i]->name() <<" "<< m_graph[j]->name() << " "<<weight;
+                t << " c "<< m_graph[i]->outLinkColor( m_graph[j]->name() );
                 t <<"\n";
             }
         }
     }
+    if ( !t.finish() ) {
+        emit statusMessage ( tr("Error. Could not write to ") + fileName );
+        return false;
+    }
     f.close();
 
     emit statusMessage (tr( "File %1 saved" ).arg( fileNameNoPath ));
@@ -15943,22 +20099,32 @@ bool Graph::graphSaveToPajekFormat (const QString &fileName, \
 
 /**
  * @brief Graph::graphSaveToAdjacencyFormat
+ * Saves the adjacency matrix, either dense, one row of N values per line, or
+ * sparse, as a Matrix Market coordinate list of the non-zero entries.
  * @param fileName
+ * @param saveEdgeWeights
+ * @param sparse
  * @return
  */
 bool Graph::graphSaveToAdjacencyFormat (const QString &fileName,
-                                        const bool &saveEdgeWeights){
-    QFile file( fileName );
+                                        const bool &saveEdgeWeights,
+                                        const bool &sparse){
+    // Compress the file if its name ends in .gz or .zst
+    CompressedFile file( fileName );
+    file.setCompression( CompressedFile::compressionForFileName(fileName) );
     if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )  {
         emit statusMessage ( tr("Error. Could not write to ") + fileName );
         return false;
     }
-    QTextStream outText( &file );
-    outText.setCodec("UTF-8");
+    GraphFileWriter outText( &file );
     qDebug("Graph: graphSaveToAdjacencyFormat() for %i vertices", vertices());
 
-    writeMatrixAdjacencyTo(outText, saveEdgeWeights);
+    writeMatrixAdjacencyTo(outText, saveEdgeWeights, sparse);
 
+    if ( !outText.finish() ) {
+        emit statusMessage ( tr("Error. Could not write to ") + fileName );
+        return false;
+    }
     file.close();
     QString fileNameNoPath=fileName.split("/").last();
     emit statusMessage (QString( tr("Adjacency matrix-formatted network saved into file %1") ).arg( fileNameNoPath ));
@@ -16002,7 +20168,8 @@ bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
     qDebug () << "Graph::graphSaveToGraphMLFormat() - Save to directory:"
               << saveDirPath;
 
-    QString iconsSubDir = fileInfo.baseName() + "_" + fileInfo.suffix() +"_images";
+    const QFileInfo plainFileInfo ( CompressedFile::fileNameWithoutCompression(fileName) );
+    QString iconsSubDir = plainFileInfo.baseName() + "_" + plainFileInfo.suffix() +"_images";
     QString iconsDirPath = saveDirPath + "/" + iconsSubDir;
 
     QDir saveDir(saveDirPath);
@@ -16040,18 +20207,17 @@ bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
     maxWidth = (maxWidth == 0) ? (int)canvasWidth:maxWidth ;
     maxHeight= (maxHeight== 0) ? (int)canvasHeight:maxHeight;
 
-    QFile f( fileName );
+    // Compress the file if its name ends in .gz or .zst
+    CompressedFile f( fileName );
+    f.setCompression( CompressedFile::compressionForFileName(fileName) );
     if ( !f.open( QIODevice::WriteOnly | QIODevice::Text ) )  {
         emit statusMessage ( tr("Error. Could not write to ") + fileName );
         return false;
     }
-    QTextStream outText( &f );
-    outText.setCodec("UTF-8");
-    qDebug () << "Graph::graphSaveToGraphMLFormat() - codec used for saving stream: "
-              << outText.codec()->name();
+    GraphFileWriter outText( &f );
 
     qDebug()<< "Graph::graphSaveToGraphMLFormat() -  writing xml version";
-    outText << "<?xml version=\"1.0\" encoding=\"" << outText.codec()->name() << "\"?> \n";
+    outText << "<?xml version=\"1.0\" encoding=\"" << "UTF-8" << "\"?> \n";
     outText << " <!-- Created by SocNetV "<<  VERSION << " --> \n" ;
     outText << "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\" "
                "      xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance \" "
@@ -16128,7 +20294,8 @@ bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
                 "  </key> \n";
 
     VList::const_iterator it;
-    VList::const_iterator jt;
+    vector<int> offsets, targets;
+    vector<qreal> weights;
     QString  relationName;
     int relationPrevious = relationCurrent();
     for (int i = 0; i < relations(); ++i) {
@@ -16215,109 +20382,50 @@ bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
 
         qDebug() << "Graph::graphSaveToGraphMLFormat() - writing edges data";
         edgeCount=0;
-        if (graphIsDirected()) {
-            for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it)
+        const bool directed = graphIsDirected();
+        graphEdgeRows(offsets, targets, weights);
+        for (int i = 0; i < m_graph.size(); ++i)
+        {
+            for (int e = offsets[i]; e < offsets[i+1]; ++e)
             {
-                for (jt=m_graph.begin(); jt!=m_graph.end(); jt++)
-                {
-                    source=(*it)->name();
-                    target=(*jt)->name();
-                    m_label = "";
-                    weight= edgeExists( source,target ) ;
-                    if  (  weight !=0 )
-                    {
-                        ++edgeCount;
-                        m_color = (*it)->outLinkColor( target );
-                        m_label = edgeLabel(source, target);
-                        m_label=htmlEscaped(m_label);
-                        qDebug()<< "Graph::graphSaveToGraphMLFormat() - edge no "
-                                << edgeCount
-                                << " from n1=" << source << " to n2=" << target
-                                << " with weight " << weight
-                                << " and color " << m_color.toUtf8() ;
-                        outText << "    <edge id=\""<< "e"+QString::number(edgeCount)
-                                << "\" directed=\"" << "true" << "\" source=\"" << source
-                                << "\" target=\"" << target << "\"";
-
-                        openToken = true;
-                        if ( weight != 0 ) {
-                            outText << "> \n";
-                            outText << "      <data key=\"d8\">" << weight<<"</data>" <<" \n";
-                            openToken=false;
-                        }
-                        if (  QString::compare ( initEdgeColor, m_color,  Qt::CaseInsensitive) != 0) {
-                            if (openToken)
-                                outText << "> \n";
-                            outText << "      <data key=\"d9\">" << m_color <<"</data>" <<" \n";
-                            openToken=false;
-                        }
-                        if (  !m_label.isEmpty()) {
-                            if (openToken)
-                                outText << "> \n";
-                            outText << "      <data key=\"d10\">" << m_label<<"</data>" <<" \n";
-                            openToken=false;
-                        }
-
-                        if (openToken)
-                            outText << "/> \n";
-                        else
-                            outText << "    </edge>\n";
-
-                    }
-
+                // In undirected graphs, write each edge once
+                if ( !directed && targets[e] < i )
+                    continue;
+                source=m_graph[i]->name();
+                target=m_graph[ targets[e] ]->name();
+                weight= weights[e];
+                ++edgeCount;
+                m_color = m_graph[i]->outLinkColor( target );
+                m_label = edgeLabel(source, target);
+                m_label=htmlEscaped(m_label);
+                outText << "    <edge id=\""<< "e" << edgeCount
+                        << "\" directed=\"" << ( directed ? "true" : "false" )
+                        << "\" source=\"" << source
+                        << "\" target=\"" << target << "\"";
+
+                openToken = true;
+                if ( weight != 0 ) {
+                    outText << "> \n";
+                    outText << "      <data key=\"d8\">" << weight<<"</data>" <<" \n";
+                    openToken=false;
                 }
-            }
-        }
-        else {
-            for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it)
-            {
-                for (jt=it; jt!=m_graph.end(); jt++)
-                {
-                    source=(*it)->name();
-                    target=(*jt)->name();
-                    weight= edgeExists( source,target );
-                    m_label = "";
-                    if  (  weight  !=0 )
-                    {
-                        ++edgeCount;
-                        m_color = (*it)->outLinkColor( target );
-                        m_label = edgeLabel(source, target);
-                        m_label=htmlEscaped(m_label);
-                        qDebug()<< "Graph::graphSaveToGraphMLFormat() - edge no "
-                                << edgeCount
-                                << " from n1=" << source << " to n2=" << target
-                                << " with weight " << weight
-                                << " and color " << m_color.toUtf8() ;
-                        outText << "    <edge id=\""<< "e"+QString::number(edgeCount)
-                                << "\" directed=\"" << "false" << "\" source=\"" << source
-                                << "\" target=\"" << target << "\"";
-
-                        openToken = true;
-                        if ( weight !=0 ) {
-                            outText << "> \n";
-                            outText << "      <data key=\"d8\">" << weight<<"</data>" <<" \n";
-                            openToken=false;
-                        }
-                        if (  QString::compare ( initEdgeColor, m_color,  Qt::CaseInsensitive) != 0) {
-                            if (openToken)
-                                outText << "> \n";
-                            outText << "      <data key=\"d9\">" << m_color <<"</data>" <<" \n";
-                            openToken=false;
-                        }
-                        if (  !m_label.isEmpty()) {
-                            if (openToken)
-                                outText << "> \n";
-                            outText << "      <data key=\"d10\">" << m_label<<"</data>" <<" \n";
-                            openToken=false;
-                        }
-                        if (openToken)
-                            outText << "/> \n";
-                        else
-                            outText << "    </edge>\n";
-
-                    }
-
+                if (  QString::compare ( initEdgeColor, m_color,  Qt::CaseInsensitive) != 0) {
+                    if (openToken)
+                        outText << "> \n";
+                    outText << "      <data key=\"d9\">" << m_color <<"</data>" <<" \n";
+                    openToken=false;
+                }
+                if (  !m_label.isEmpty()) {
+                    if (openToken)
+                        outText << "> \n";
+                    outText << "      <data key=\"d10\">" << m_label<<"</data>" <<" \n";
+                    openToken=false;
                 }
+
+                if (openToken)
+                    outText << "/> \n";
+                else
+                    outText << "    </edge>\n";
             }
         }
 
@@ -16325,8 +20433,12 @@ bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
     }
     outText << "</graphml>\n";
 
-    f.close();
     relationSet(relationPrevious, false);
+    if ( !outText.finish() ) {
+        emit statusMessage ( tr("Error. Could not write to ") + fileName );
+        return false;
+    }
+    f.close();
 
     emit statusMessage( tr( "File %1 saved" ).arg( fileNameNoPath ) );
 
@@ -16334,6 +20446,243 @@ bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
 }
 
 
+
+/**
+ * @brief Saves the current graph to fileName as a native SocNetV binary
+ * snapshot (see GraphBinaryFile): all vertices with their attributes and
+ * positions, the edges of every relation, whether each one is enabled, and
+ * the prominence index results cached for the current graph version.
+ * @param fileName
+ * @return
+ */
+bool Graph::graphSaveToBinaryFormat (const QString &fileName) {
+
+    qDebug () << "Graph::graphSaveToBinaryFormat() - file:" << fileName;
+
+    GraphBinaryFile file;
+    VList::const_iterator it;
+
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+        GraphBinaryFile::Vertex v;
+        v.name = (*it)->name();
+        v.size = (*it)->size();
+        v.numberSize = (*it)->numberSize();
+        v.labelSize = (*it)->labelSize();
+        v.color = file.stringAdd( (*it)->color() );
+        v.numberColor = file.stringAdd( (*it)->numberColor() );
+        v.label = file.stringAdd( (*it)->label() );
+        v.labelColor = file.stringAdd( (*it)->labelColor() );
+        v.shape = file.stringAdd( (*it)->shape() );
+        v.iconPath = file.stringAdd( (*it)->shapeIconPath() );
+        v.flags = (*it)->isEnabled() ? GraphBinaryFile::Enabled : 0;
+        v.reserved = 0;
+        v.x = (*it)->x() / canvasWidth;
+        v.y = (*it)->y() / canvasHeight;
+        file.vertexAppend(v);
+    }
+
+    // The edges of each vertex, per relation, sorted by target index
+    QVector<GraphBinaryFile::Edge> row;
+    for (int relation = 0; relation < relations(); ++relation) {
+        file.relationAppend( m_relationsList[relation] );
+        for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
+            row.clear();
+            const H_edges &outEdges = (*it)->outEdgesRelation(relation);
+            H_edges::const_iterator e;
+            for (e = outEdges.constBegin(); e != outEdges.constEnd(); ++e) {
+                const int target = e.key();
+                GraphBinaryFile::Edge edge;
+                edge.target = vpos.value(target);
+                edge.color = file.stringAdd( (*it)->outLinkColor(target) );
+                edge.label = file.stringAdd( (*it)->outEdgeLabel(target) );
+                edge.flags = e.value().second ? GraphBinaryFile::Enabled : 0;
+                edge.weight = e.value().first;
+                row.append(edge);
+            }
+            std::sort( row.begin(), row.end(),
+                       [] (const GraphBinaryFile::Edge &a, const GraphBinaryFile::Edge &b) {
+                return a.target < b.target;
+            } );
+            for (int i = 0; i < row.size(); ++i) {
+                file.edgeAppend( row[i] );
+            }
+            file.rowEnd();
+        }
+    }
+
+    // The results held for this graph version, with the solver options
+    // they depend on, so that they are only reused under the same options.
+    const QList<QPair<int,int> > entries = m_resultCache.entries(m_graphVersion);
+    if ( ! entries.isEmpty() ) {
+        QByteArray results;
+        QDataStream out( &results, QIODevice::WriteOnly );
+        out.setVersion(QDataStream::Qt_5_0);
+        out << (qint32) entries.size();
+        for (int i = 0; i < entries.size(); ++i) {
+            const int index = entries[i].first;
+            const int parameters = entries[i].second;
+            out << (qint32) index << (qint32) parameters
+                << resultStoreEntry(index, parameters);
+            GraphResultCache::write( out,
+                                     *m_resultCache.find(index, parameters, m_graphVersion) );
+        }
+        file.setResults(results);
+    }
+
+    file.setGraph( graphName(),
+                   graphIsDirected() ? GraphBinaryFile::Directed : 0,
+                   relationCurrent() );
+
+    if ( ! file.save(fileName) ) {
+        emit statusMessage ( tr("Error. Could not write to %1: %2")
+                             .arg(fileName).arg( file.errorString() ) );
+        return false;
+    }
+
+    QString fileNameNoPath=fileName.split("/").last();
+    emit statusMessage( tr( "Binary snapshot saved into file %1" ).arg( fileNameNoPath ) );
+
+    return true;
+}
+
+
+
+/**
+ * @brief Loads a native SocNetV binary snapshot written by graphSaveToBinaryFormat().
+ * The file is mapped and its records are replayed into one bulk build,
+ * without the parser thread. Results stored in the snapshot become available
+ * to the prominence index reports without recomputing them.
+ * Called from graphLoad().
+ * @param fileName
+ * @return
+ */
+bool Graph::graphLoadFromBinaryFormat (const QString &fileName) {
+
+    qDebug () << "Graph::graphLoadFromBinaryFormat() - file:" << fileName;
+
+    GraphBinaryFile file;
+    if ( ! file.open(fileName) ) {
+        graphBulkBegin();
+        graphFileLoaded(FileType::UNRECOGNIZED, QString(), QString(), 0, 0, 0,
+                        file.errorString());
+        return false;
+    }
+
+    const int N = file.vertices();
+    quint64 arcs = 0;
+    for (int relation = 0; relation < file.relations(); ++relation) {
+        arcs += file.edgeCount(relation);
+    }
+
+    graphBulkBegin(N, (int) arcs, true);
+
+    for (int relation = 0; relation < file.relations(); ++relation) {
+        relationAdd( file.relationName(relation) );
+    }
+
+    for (int i = 0; i < N; ++i) {
+        const GraphBinaryFile::Vertex &v = file.vertex(i);
+        vertexCreate( v.name,
+                      v.size,
+                      file.string(v.color),
+                      file.string(v.numberColor),
+                      v.numberSize,
+                      file.string(v.label),
+                      file.string(v.labelColor),
+                      v.labelSize,
+                      QPointF( v.x * canvasWidth, v.y * canvasHeight ),
+                      file.string(v.shape),
+                      file.string(v.iconPath),
+                      false );
+        if ( ! ( v.flags & GraphBinaryFile::Enabled ) ) {
+            const int name = v.name;
+            m_graph[ vpos[name] ]->setEnabled(false);
+            graphBulkDefer( [=] () {
+                emit setVertexVisibility( name, false );
+            } );
+        }
+    }
+
+    // Undirected graphs store both arcs of each edge; create it once.
+    const bool directed = ( file.flags() & GraphBinaryFile::Directed );
+    for (int relation = 0; relation < file.relations(); ++relation) {
+        relationSet(relation);
+        const quint32 *offsets = file.offsets(relation);
+        const GraphBinaryFile::Edge *edges = file.edges(relation);
+        for (int i = 0; i < N; ++i) {
+            const int source = file.vertex(i).name;
+            for (quint32 e = offsets[i]; e < offsets[i+1]; ++e) {
+                if ( ! directed && edges[e].target < i ) {
+                    continue;
+                }
+                edgeCreate( source,
+                            file.vertex( edges[e].target ).name,
+                            edges[e].weight,
+                            file.string( edges[e].color ),
+                            directed ? EdgeType::Directed : EdgeType::Undirected,
+                            directed,
+                            false,
+                            file.string( edges[e].label ),
+                            false );
+            }
+        }
+        // Filter the edges out again, once both arcs of each exist
+        for (int i = 0; i < N; ++i) {
+            const int source = file.vertex(i).name;
+            for (quint32 e = offsets[i]; e < offsets[i+1]; ++e) {
+                if ( edges[e].flags & GraphBinaryFile::Enabled ) {
+                    continue;
+                }
+                const int target = file.vertex( edges[e].target ).name;
+                if ( m_graph[ vpos[source] ]->setOutEdgeFiltered( target, edges[e].weight, false ) ) {
+                    graphBulkDefer( [=] () {
+                        emit setEdgeVisibility( relation, source, target, false );
+                    } );
+                }
+            }
+        }
+    }
+    relationSet( file.currentRelation() );
+
+    graphFileLoaded( FileType::BINARY,
+                     fileName,
+                     file.graphName(),
+                     N,
+                     (int) arcs,
+                     directed ? EdgeType::Directed : EdgeType::Undirected,
+                     QString() );
+
+    // Restore the results computed on the network that was saved
+    const QByteArray results = file.results();
+    if ( ! results.isEmpty() ) {
+        QDataStream in( results );
+        in.setVersion(QDataStream::Qt_5_0);
+        qint32 count = 0, index = 0, parameters = 0;
+        QString entry;
+        in >> count;
+        for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            GraphResultCache::Result result;
+            in >> index >> parameters >> entry;
+            if ( ! GraphResultCache::read(in, result) ) {
+                break;
+            }
+            if ( entry != resultStoreEntry(index, parameters)
+                 || result.scores.size() != 2 * m_graph.size() ) {
+                continue;
+            }
+            qDebug () << "Graph::graphLoadFromBinaryFormat() - restored results of index"
+                      << index << "parameters" << parameters;
+            GraphResultCache::Result &slot =
+                    m_resultCache.insert(index, parameters, m_graphVersion);
+            result.version = m_graphVersion;
+            slot = result;
+        }
+    }
+
+    return true;
+}
+
+
 /**
  * @brief Sets the directory where reports are saved
  * This is used when exporting prominence distribution images to be used in
@@ -16342,7 +20691,22 @@ bool Graph::graphSaveToGraphMLFormat (const QString &fileName,
  */
 void Graph::setReportsDataDir(const QString &dir) {
     m_reportsDataDir = dir;
+    m_resultStore.setDirectory(dir);
+}
+
 
+
+/**
+ * @brief Enables or disables the on-disk result store under the reports
+ * data dir. When enabled, computed distances, centralities, cliques and
+ * clustering results are saved, keyed by a content hash of the network and
+ * the analysis parameters, and restored when the same network is analysed
+ * again, i.e. after re-opening its file.
+ * @param toggle
+ */
+void Graph::setReportsResultStore(const bool &toggle) {
+    qDebug() << "Graph::setReportsResultStore() - toggle" << toggle;
+    m_resultStore.setEnabled(toggle);
 }
 /**
  * @brief Sets the precision (number of fraction digits) the app will use
@@ -20220,6 +24584,9 @@ void Graph::writeMatrix (const QString &fn,
                          const QString &varLocation,
                          const bool &simpler) {
 
+    GraphTraceScope trace("Graph::writeMatrix");
+    trace.setInput( vertices(), edgesEnabled() );
+
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -20570,19 +24937,29 @@ void Graph::writeMatrix (const QString &fn,
  * @brief Writes the matrix M as HTML <table> to specified text stream outText
  * It is the same as Matrix::printHTMLTable except that
  * this method omits disabled vertices, thus the table header is correct
+ * M may be a Matrix or any MatrixT variant.
+ * If the matrix has more than MATRIX_HTML_PAGE_SIZE actors and outText writes
+ * to a file, the matrix is written in pages of MATRIX_HTML_PAGE_SIZE rows and
+ * columns, in a subdir next to that file, and the table is an index of the
+ * pages. This keeps every page small enough to open at once in the report
+ * viewer, however large the network.
  * @param outText
- * @param M
+ * @param matrix
  * @param markDiag
  * @param plain
  * @param printInfinity
  */
+template <class M>
 void Graph::writeMatrixHTMLTable(QTextStream& outText,
-                                 Matrix &M,
+                                 const M &matrix,
                                  const bool &markDiag,
                                  const bool &plain,
                                  const bool &printInfinity,
                                  const bool &dropIsolates) {
 
+    GraphTraceScope trace("Graph::writeMatrixHTMLTable");
+    trace.setInput( matrix.rows(), edgesEnabled() );
+
     Q_UNUSED(plain);
 
     qDebug () << "Graph::writeMatrixHTMLTable() -"
@@ -20590,24 +24967,206 @@ void Graph::writeMatrixHTMLTable(QTextStream& outText,
               << "plain" << plain
               << " dropIsolates " << dropIsolates;
 
-    int rowCount=0, i=0, j=0;
-    int N = vertices();
-    qreal maxVal, minVal, element;
+    qreal maxVal, minVal;
     bool hasRealNumbers=false;
 
-    VList::const_iterator it, jt;
-
-    QString pMsg = tr("Writing matrix to file. \nPlease wait...");
-    emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N, pMsg );
+    VList::const_iterator it;
 
-    M.findMinMaxValues(minVal, maxVal, hasRealNumbers);
+    // The actors of the matrix rows and columns, in order
+    QVector<int> names;
+    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
+        if ( ! (*it)->isEnabled() || (dropIsolates && (*it)->isIsolated() ) ) {
+            continue;
+        }
+        names << (*it)->name();
+    }
+    const int N = names.size();
+    const int pages = ( N + MATRIX_HTML_PAGE_SIZE - 1 ) / MATRIX_HTML_PAGE_SIZE;
 
-    outText <<  ( (hasRealNumbers) ? qSetRealNumberPrecision(3) : qSetRealNumberPrecision(0) ) ;
+    matrix.findMinMaxValues(minVal, maxVal, hasRealNumbers);
 
     qDebug () << "Graph::writeMatrixHTMLTable() - minVal" << minVal
               << "maxVal" << maxVal << "hasRealNumbers" << hasRealNumbers;
 
+    QString pagesSubDir, pagesDirPath, reportFileName;
+    QFile *reportFile = qobject_cast<QFile *>( outText.device() );
+    if ( pages > 1 && reportFile ) {
+        QFileInfo reportInfo( reportFile->fileName() );
+        reportFileName = reportInfo.fileName();
+        pagesSubDir = reportInfo.completeBaseName() + "_pages";
+        pagesDirPath = reportInfo.absolutePath() + "/" + pagesSubDir;
+        if ( !QDir().mkpath( pagesDirPath ) ) {
+            qDebug () << "Graph::writeMatrixHTMLTable() - ERROR creating pages subdir"
+                      << pagesDirPath << "- writing one table";
+            pagesSubDir = QString();
+        }
+    }
+
+    if ( pagesSubDir.isEmpty() ) {
+
+        QString pMsg = tr("Writing matrix to file. \nPlease wait...");
+        emit statusMessage( pMsg );
+        graphProgressCreate(N, pMsg );
+
+        outText <<  ( (hasRealNumbers) ? qSetRealNumberPrecision(3) : qSetRealNumberPrecision(0) ) ;
+
+        writeMatrixHTMLTableRows(outText, matrix, names, 0, N, 0, N,
+                                 markDiag, printInfinity);
+
+        outText << qSetFieldWidth(0) << endl ;
+    }
+    else {
+
+        QString pMsg = tr("Writing matrix to %1 pages. \nPlease wait...").arg(pages * pages);
+        emit statusMessage( pMsg );
+        graphProgressCreate(pages * pages, pMsg );
+
+        // The page with rows block r and columns block c
+        const auto pageName = [](const int &r, const int &c) {
+            return QString("page-%1-%2.html").arg(r + 1).arg(c + 1);
+        };
+        const auto blockName = [&names, &N](const int &b) {
+            return QString("%1 - %2").arg( names[ b * MATRIX_HTML_PAGE_SIZE ] )
+                    .arg( names[ qMin( N, ( b + 1 ) * MATRIX_HTML_PAGE_SIZE ) - 1 ] );
+        };
+
+        for (int r = 0; r < pages; ++r) {
+            for (int c = 0; c < pages; ++c) {
+                QFile pageFile( pagesDirPath + "/" + pageName(r, c) );
+                if ( !pageFile.open( QIODevice::WriteOnly | QIODevice::Text ) )  {
+                    emit statusMessage ( tr("Error. Could not write to ") + pageFile.fileName() );
+                    continue;
+                }
+                QTextStream pageText( &pageFile );
+                pageText.setCodec("UTF-8");
+
+                pageText << htmlHead;
+                pageText << "<h1>"
+                         << tr("Rows %1, columns %2").arg( blockName(r) ).arg( blockName(c) )
+                         << "</h1>";
+
+                pageText << "<p>"
+                         << "<a href=\"../" << reportFileName << "\">" << tr("Index") << "</a>";
+                if ( r > 0 )
+                    pageText << " | <a href=\"" << pageName(r - 1, c) << "\">" << tr("Previous rows") << "</a>";
+                if ( r + 1 < pages )
+                    pageText << " | <a href=\"" << pageName(r + 1, c) << "\">" << tr("Next rows") << "</a>";
+                if ( c > 0 )
+                    pageText << " | <a href=\"" << pageName(r, c - 1) << "\">" << tr("Previous columns") << "</a>";
+                if ( c + 1 < pages )
+                    pageText << " | <a href=\"" << pageName(r, c + 1) << "\">" << tr("Next columns") << "</a>";
+                pageText << "</p>";
+
+                pageText <<  ( (hasRealNumbers) ? qSetRealNumberPrecision(3) : qSetRealNumberPrecision(0) ) ;
+
+                writeMatrixHTMLTableRows(pageText, matrix, names,
+                                         r * MATRIX_HTML_PAGE_SIZE,
+                                         qMin( N, ( r + 1 ) * MATRIX_HTML_PAGE_SIZE ),
+                                         c * MATRIX_HTML_PAGE_SIZE,
+                                         qMin( N, ( c + 1 ) * MATRIX_HTML_PAGE_SIZE ),
+                                         markDiag, printInfinity);
+
+                pageText << qSetFieldWidth(0) << htmlEnd;
+                pageFile.close();
+
+                graphProgressUpdate( r * pages + c + 1 );
+            }
+        }
+
+        outText << "<p class=\"description\">"
+                << tr("This %1 x %1 matrix is too large for one table. "
+                      "It is written in %2 pages of up to %3 rows and columns, "
+                      "in the %4 folder. Click a cell of the index below to open "
+                      "the page with these rows and columns.")
+                   .arg(N).arg(pages * pages).arg(MATRIX_HTML_PAGE_SIZE).arg(pagesSubDir)
+                << "</p>";
+
+        outText << "<table  border=\"1\" cellspacing=\"0\" cellpadding=\"0\" class=\"stripes\">"
+                << "<thead>"
+                << "<tr>"
+                << "<th>"
+                << tr("<sub>Rows</sub>/<sup>Columns</sup>")
+                << "</th>";
+        for (int c = 0; c < pages; ++c) {
+            outText << "<th>" << blockName(c) << "</th>";
+        }
+        outText << "</tr>"
+                << "</thead>"
+                << "<tbody>";
+        for (int r = 0; r < pages; ++r) {
+            outText << "<tr class=" << ((r%2==0) ? "odd" :"even" )<< ">";
+            outText << "<td class=\"header\">" << blockName(r) << "</td>";
+            for (int c = 0; c < pages; ++c) {
+                outText << "<td>"
+                        << "<a href=\"" << pagesSubDir << "/" << pageName(r, c) << "\">"
+                        << r + 1 << "," << c + 1
+                        << "</a>"
+                        << "</td>";
+            }
+            outText << "</tr>";
+        }
+        outText << "</tbody></table>";
+        outText << endl;
+    }
+
+
+    outText << "<p>"
+       << "<span class=\"info\">"
+       << ("Values: ")
+       <<"</span>"
+       << ( (hasRealNumbers) ? ("real numbers (printed decimals 3)") : ("integers only" ) )
+       << "<br />"
+       << "<span class=\"info\">"
+       << ("- Max value: ")
+       <<"</span>"
+       << ( ( maxVal==RAND_MAX ) ?
+                ( (printInfinity) ? infinity : QString::number(maxVal) ) +
+                " (=not connected nodes, in distance matrix)" : QString::number(maxVal) )
+       << "<br />"
+       << "<span class=\"info\">"
+       << ("- Min value: ")
+       <<"</span>"
+       << ( ( minVal==RAND_MAX ) ?
+                ( (printInfinity) ? infinity : QString::number(minVal) ) +
+                + " (usually denotes unconnected nodes, in distance matrix)" : QString::number(minVal ) )
+       << "</p>";
+
+
+
+    graphProgressKill();
+
+}
+
+
+
+/**
+ * @brief Writes the rows firstRow ... lastRow-1 and the columns firstColumn ...
+ * lastColumn-1 of matrix as an HTML <table>, for writeMatrixHTMLTable().
+ * names are the actors of all rows and columns.
+ * In the whole table, it updates the progress box with every row.
+ * @param outText
+ * @param matrix
+ * @param names
+ * @param firstRow
+ * @param lastRow
+ * @param firstColumn
+ * @param lastColumn
+ * @param markDiag
+ * @param printInfinity
+ */
+template <class M>
+void Graph::writeMatrixHTMLTableRows(QTextStream &outText,
+                                     const M &matrix,
+                                     const QVector<int> &names,
+                                     const int &firstRow, const int &lastRow,
+                                     const int &firstColumn, const int &lastColumn,
+                                     const bool &markDiag,
+                                     const bool &printInfinity) {
+
+    const bool wholeTable = ( firstRow == 0 && lastRow == names.size()
+                              && firstColumn == 0 && lastColumn == names.size() );
+    qreal element;
+
     outText << "<table  border=\"1\" cellspacing=\"0\" cellpadding=\"0\" class=\"stripes\">"
             << "<thead>"
             << "<tr>"
@@ -20615,47 +25174,34 @@ void Graph::writeMatrixHTMLTable(QTextStream& outText,
             << tr("<sub>Actor</sup>/<sup>Actor</sup>")
             << "</th>";
 
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-
-        if ( ! (*it)->isEnabled() || (dropIsolates && (*it)->isIsolated() ) ) {
-            continue;
-        }
+    for (int j = firstColumn; j < lastColumn; ++j) {
         outText <<"<th>"
-                << (*it)->name()
+                << names[j]
                 << "</th>";
     }
     outText << "</tr>"
             << "</thead>"
             << "<tbody>";
 
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
-
-        if ( ! (*it)->isEnabled() || (dropIsolates && (*it)->isIsolated() ) ) {
-            continue;
-        }
+    outText << fixed << right;
 
-        rowCount++;
+    for (int i = firstRow; i < lastRow; ++i) {
 
-        emit signalProgressBoxUpdate(rowCount);
+        if ( wholeTable ) {
+            graphProgressUpdate(i + 1);
+        }
 
-        outText << "<tr class=" << ((rowCount%2==0) ? "even" :"odd" )<< ">";
+        outText << "<tr class=" << (((i + 1)%2==0) ? "even" :"odd" )<< ">";
 
         outText <<"<td class=\"header\">"
-               << (*it)->name()
+               << names[i]
                << "</td>";
 
-        for (jt=m_graph.cbegin(); jt!=m_graph.cend(); ++jt){
-
-            if ( ! (*jt)->isEnabled() || (dropIsolates && (*jt)->isIsolated() ) ) {
-                continue;
-            }
-            outText << fixed << right;
-
-            outText <<"<td" << ((markDiag && (*it)->name() ==(*jt)->name() )? " class=\"diag\">" : ">");
+        for (int j = firstColumn; j < lastColumn; ++j) {
 
-            element = M.item(i,j);
+            outText <<"<td" << ((markDiag && i == j )? " class=\"diag\">" : ">");
 
-            qDebug () << "Graph::writeMatrixHTMLTable() - M(" <<i<<","<<j<<") =" <<  M.item(i,j);
+            element = matrix.item(i,j);
 
             if ( ( element == RAND_MAX ) && printInfinity) {
                 // print inf symbol instead of RAND_MAX (distances matrix).
@@ -20665,78 +25211,194 @@ void Graph::writeMatrixHTMLTable(QTextStream& outText,
                 outText << element ;
             }
 
-
             outText << "</td>";
-            j++;
         }
         outText <<"</tr>";
-        i++;
-        j=0;
     }
     outText << "</tbody></table>";
+}
 
 
 
-    outText << qSetFieldWidth(0) << endl ;
 
 
-    outText << "<p>"
-       << "<span class=\"info\">"
-       << ("Values: ")
-       <<"</span>"
-       << ( (hasRealNumbers) ? ("real numbers (printed decimals 3)") : ("integers only" ) )
-       << "<br />"
-       << "<span class=\"info\">"
-       << ("- Max value: ")
-       <<"</span>"
-       << ( ( maxVal==RAND_MAX ) ?
-                ( (printInfinity) ? infinity : QString::number(maxVal) ) +
-                " (=not connected nodes, in distance matrix)" : QString::number(maxVal) )
-       << "<br />"
-       << "<span class=\"info\">"
-       << ("- Min value: ")
-       <<"</span>"
-       << ( ( minVal==RAND_MAX ) ?
-                ( (printInfinity) ? infinity : QString::number(minVal) ) +
-                + " (usually denotes unconnected nodes, in distance matrix)" : QString::number(minVal ) )
-       << "</p>";
+/**
+ * @brief Exports the adjacency matrix of the enabled vertices to a given writer.
+ * The dense matrix skips the runs of zeros in one go, and the sparse one
+ * writes the Matrix Market header and a 1-based "row column value" line for
+ * each edge.
+ * @param os
+ * @param saveEdgeWeights
+ * @param sparse
+ */
+void Graph::writeMatrixAdjacencyTo(GraphFileWriter& os,
+                                   const bool &saveEdgeWeights,
+                                   const bool &sparse){
+    qDebug("Graph: adjacencyMatrix(), writing matrix with %i vertices", vertices());
+
+    vector<int> offsets, targets;
+    vector<qreal> weights;
+    graphEdgeRows(offsets, targets, weights);
+
+    // The row and column of each enabled vertex, or -1
+    const int N = m_graph.size();
+    vector<int> index(N, -1);
+    int enabled = 0, nonZero = 0;
+    for (int i = 0; i < N; ++i) {
+        if ( m_graph[i]->isEnabled() ) {
+            index[i] = enabled++;
+        }
+    }
+    for (int i = 0; i < N; ++i) {
+        if ( index[i] < 0 ) continue;
+        for (int e = offsets[i]; e < offsets[i+1]; ++e) {
+            if ( index[ targets[e] ] >= 0 ) ++nonZero;
+        }
+    }
+
+    if ( sparse ) {
+        os << "%%MatrixMarket matrix coordinate real general\n";
+        os << enabled << " " << enabled << " " << nonZero << "\n";
+    }
+
+    for (int i = 0; i < N; ++i) {
+        if ( index[i] < 0 ) continue;
+        int column = 0;
+        for (int e = offsets[i]; e < offsets[i+1]; ++e) {
+            const int j = index[ targets[e] ];
+            if ( j < 0 ) continue;
+            if ( sparse ) {
+                os << index[i] + 1 << " " << j + 1 << " "
+                   << ( (saveEdgeWeights) ? weights[e] : (qreal) 1 ) << "\n";
+            }
+            else {
+                os.writeRepeated("0 ", 2, j - column);
+                os << ( (saveEdgeWeights) ? weights[e] : (qreal) 1 ) << " ";
+                column = j + 1;
+            }
+        }
+        if ( !sparse ) {
+            os.writeRepeated("0 ", 2, enabled - column);
+            os << "\n";
+        }
+    }
 
+}
 
 
-    emit signalProgressBoxKill();
 
+/**
+ * @brief Fills offsets, targets and weights with the out-edges of every vertex
+ * in the current relation, as edgeExists() reports them: the edges of the
+ * vertex at position i go to the positions targets[offsets[i]] ...
+ * targets[offsets[i+1]-1], in increasing order, with their weights.
+ * Unlike graphCSR(), disabled vertices keep their edges, as the savers expect.
+ * @param offsets
+ * @param targets
+ * @param weights
+ */
+void Graph::graphEdgeRows(vector<int> &offsets,
+                          vector<int> &targets,
+                          vector<qreal> &weights) const {
+    const int N = m_graph.size();
+    const int relation = m_curRelation;
+    vector< pair<int,qreal> > row;
+    offsets.assign(1, 0);
+    targets.clear();
+    weights.clear();
+    for (int i = 0; i < N; ++i) {
+        row.clear();
+        const H_edges &edges = m_graph[i]->outEdgesRelation(relation);
+        int previousKey = -1;
+        for (H_edges::const_iterator it = edges.cbegin(); it != edges.cend(); ++it) {
+            // Entries with the same key are adjacent; like hasEdgeTo(),
+            // only the first one counts.
+            if ( it.key() == previousKey ) {
+                continue;
+            }
+            previousKey = it.key();
+            if ( !it.value().second || it.value().first == 0 ) {
+                continue;
+            }
+            const int j = vpos.value( it.key(), -1 );
+            if ( j < 0 ) {
+                continue;
+            }
+            row.push_back( make_pair(j, it.value().first) );
+        }
+        sort( row.begin(), row.end(),
+              [](const pair<int,qreal> &a, const pair<int,qreal> &b) {
+                  return a.first < b.first;
+              } );
+        for (size_t k = 0; k < row.size(); ++k) {
+            targets.push_back( row[k].first );
+            weights.push_back( row[k].second );
+        }
+        offsets.push_back( (int) targets.size() );
+    }
 }
 
 
 
 
-
-/** 
-    Exports the adjacency matrix to a given textstream
-*/
-void Graph::writeMatrixAdjacencyTo(QTextStream& os,
-                                   const bool &saveEdgeWeights){
-    qDebug("Graph: adjacencyMatrix(), writing matrix with %i vertices", vertices());
-    VList::const_iterator it, it1;
-    qreal weight=RAND_MAX;
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        if ( ! (*it)->isEnabled() ) continue;
-        for (it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1){
-            if ( ! (*it1)->isEnabled() ) continue;
-            if ( (weight = edgeExists( (*it)->name(), (*it1)->name() )  ) !=0 ) {
-                //os << static_cast<int> (weight) << " ";
-                os << ((saveEdgeWeights) ? weight : 1 ) << " ";
+/**
+ * @brief The adjacency matrix of the enabled vertices, as the edge rows of
+ * Graph::graphEdgeRows(), so that writeMatrixHTMLTable() can write it
+ * without an N x N matrix or an edgeExists() call per pair.
+ */
+class GraphEdgeRowsMatrix {
+public:
+    explicit GraphEdgeRowsMatrix(const Graph &graph) {
+        vector<int> offsets, targets;
+        vector<qreal> weights;
+        graph.graphEdgeRows(offsets, targets, weights);
+        const int N = (int) offsets.size() - 1;
+        vector<int> index(N, -1);
+        m_size = 0;
+        for (int i = 0; i < N; ++i) {
+            if ( graph.m_graph[i]->isEnabled() ) {
+                index[i] = m_size++;
+            }
+        }
+        m_offsets.assign(1, 0);
+        for (int i = 0; i < N; ++i) {
+            if ( index[i] < 0 ) continue;
+            for (int e = offsets[i]; e < offsets[i+1]; ++e) {
+                if ( index[ targets[e] ] >= 0 ) {
+                    m_targets.push_back( index[ targets[e] ] );
+                    m_weights.push_back( weights[e] );
+                }
             }
-            else
-                os << "0 ";
+            m_offsets.push_back( (int) m_targets.size() );
         }
-        os << endl;
     }
 
-}
-
+    qreal item(const int &i, const int &j) const {
+        vector<int>::const_iterator begin = m_targets.cbegin() + m_offsets[i];
+        vector<int>::const_iterator end = m_targets.cbegin() + m_offsets[i+1];
+        vector<int>::const_iterator it = lower_bound(begin, end, j);
+        return ( it != end && *it == j ) ? m_weights[ it - m_targets.cbegin() ] : 0;
+    }
 
+    void findMinMaxValues(qreal &min, qreal &max, bool &hasRealNumbers) const {
+        // the missing entries are zeros
+        max = 0;
+        min = ( (qint64) m_targets.size() < (qint64) m_size * m_size ) ? 0 : RAND_MAX;
+        hasRealNumbers = false;
+        for (size_t e = 0; e < m_weights.size(); ++e) {
+            if ( fmod( m_weights[e], 1.0 ) != 0 ) {
+                hasRealNumbers = true;
+            }
+            max = qMax( max, m_weights[e] );
+            min = qMin( min, m_weights[e] );
+        }
+    }
 
+private:
+    int m_size;
+    vector<int> m_offsets, m_targets;
+    vector<qreal> m_weights;
+};
 
 
 
@@ -20746,6 +25408,9 @@ void Graph::writeMatrixAdjacencyTo(QTextStream& os,
 void Graph::writeMatrixAdjacency (const QString fn,
                                   const bool &markDiag) {
 
+    GraphTraceScope trace("Graph::writeMatrixAdjacency");
+    trace.setInput( vertices(), edgesEnabled() );
+
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -20759,17 +25424,8 @@ void Graph::writeMatrixAdjacency (const QString fn,
 
     QTextStream outText( &file ); outText.setCodec("UTF-8");
 
-    int sum=0;
-    qreal weight=0;
-    int rowCount=0;
     int N = vertices();
 
-    VList::const_iterator it, it1;
-
-    QString pMsg = tr("Writing Adjacency Matrix to file. \nPlease wait...");
-    emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N, pMsg );
-
     outText << htmlHead;
 
     outText << "<h1>";
@@ -20798,62 +25454,7 @@ void Graph::writeMatrixAdjacency (const QString fn,
 
 
 
-    outText << "<table  border=\"1\" cellspacing=\"0\" cellpadding=\"0\" class=\"stripes\">"
-            << "<thead>"
-            << "<tr>"
-            << "<th>"
-            << tr("<sub>Actor</sup>/<sup>Actor</sup>")
-            << "</th>";
-
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        if ( ! (*it)->isEnabled() ) continue;
-        outText <<"<th>"
-                << (*it)->name()
-                << "</th>";
-    }
-    outText << "</tr>"
-            << "</thead>"
-            << "<tbody>";
-
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-
-        rowCount++;
-
-        emit signalProgressBoxUpdate(rowCount);
-
-        if ( ! (*it)->isEnabled() ) continue;
-
-        outText << "<tr class=" << ((rowCount%2==0) ? "even" :"odd" )<< ">";
-
-        outText <<"<td class=\"header\">"
-               << (*it)->name()
-               << "</td>";
-
-        for (it1=m_graph.cbegin(); it1!=m_graph.cend(); ++it1){
-
-            if ( ! (*it1)->isEnabled() ) continue;
-
-            outText <<"<td" << ((markDiag && (*it)->name() ==(*it1)->name() )? " class=\"diag\">" : ">");
-            if ( (weight =  edgeExists ( (*it)->name(), (*it1)->name() )  )!=0 ) {
-                sum++;
-                outText << (weight);
-
-            }
-            else {
-                outText << 0 ;
-
-            }
-            outText << "</td>";
-
-        }
-        outText <<"</tr>";
-
-    }
-    outText << "</tbody></table>";
-
-    qDebug("Graph: Found a total of %i edge",sum);
-    if ( sum != edgesEnabled() ) qDebug ("Error in edge count found!!!");
-    else qDebug("Edge count OK!");
+    writeMatrixHTMLTable(outText, GraphEdgeRowsMatrix(*this), markDiag, false, false);
 
 
     outText << "<p>&nbsp;</p>";
@@ -20870,8 +25471,6 @@ void Graph::writeMatrixAdjacency (const QString fn,
 
     file.close();
 
-    emit signalProgressBoxKill();
-
 }
 
 
@@ -20884,6 +25483,9 @@ void Graph::writeMatrixAdjacency (const QString fn,
 */
 void Graph::writeMatrixAdjacencyPlot (const QString fn,
                                       const bool &simpler) {
+
+    GraphTraceScope trace("Graph::writeMatrixAdjacencyPlot");
+    trace.setInput( vertices(), edgesEnabled() );
     QElapsedTimer computationTimer;
     computationTimer.start();
 
@@ -20903,7 +25505,7 @@ void Graph::writeMatrixAdjacencyPlot (const QString fn,
     int progressCounter = 0;
     QString pMsg = tr("Plotting Adjacency Matrix. \nPlease wait...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N, pMsg );
+    graphProgressCreate(N, pMsg );
 
     if (!simpler) {
         outText << htmlHead;
@@ -20944,7 +25546,7 @@ void Graph::writeMatrixAdjacencyPlot (const QString fn,
 
         for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
 
-            emit signalProgressBoxUpdate(++progressCounter);
+            graphProgressUpdate(++progressCounter);
 
             if ( ! (*it)->isEnabled() ) {
                 continue;
@@ -20980,7 +25582,7 @@ void Graph::writeMatrixAdjacencyPlot (const QString fn,
         outText << "<p class=\"pre\">";
         for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
 
-            emit signalProgressBoxUpdate(++progressCounter);
+            graphProgressUpdate(++progressCounter);
 
             if ( ! (*it)->isEnabled() ) {
                 continue;
@@ -21025,12 +25627,65 @@ void Graph::writeMatrixAdjacencyPlot (const QString fn,
 
     file.close();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
+
+}
+
+
+
+
+/**
+ * @brief Sets the density (non-zeros / N^2) below which
+ * graphMatrixAdjacencyCreate() keeps only the sparse adjacency matrix SAM,
+ * for callers that can work with it.
+ * @param density
+ */
+void Graph::setGraphMatrixAdjacencySparseDensity(const qreal &density) {
+    qDebug() << "Graph::setGraphMatrixAdjacencySparseDensity() -" << density;
+    m_graphMatrixAdjacencySparseDensity = ( density >= 0 ) ? density : 0.05;
+}
+
+
+
+/**
+ * @brief Sets the Barnes-Hut opening angle theta of the Eades and
+ * Fruchterman-Reingold layouts. A quadtree cell whose size is less than theta
+ * times its distance from a vertex repels it as a whole, from its centroid.
+ * Zero (or less) sums the repulsion of every vertex exactly.
+ * @param theta
+ */
+void Graph::setLayoutForceDirectedTheta(const qreal &theta) {
+    qDebug() << "Graph::setLayoutForceDirectedTheta() -" << theta;
+    m_layoutForceDirectedTheta = qMax( (qreal) 0, theta );
+}
+
 
+
+/**
+ * @brief Sets the maximum number of frames per second that the iterative
+ * layouts send to GraphicsWidget while they run, as signalNodePositions().
+ * Zero means compute only: the nodes move once, when the layout is done.
+ * @param fps
+ */
+void Graph::setLayoutFrameRate(const int &fps) {
+    qDebug() << "Graph::setLayoutFrameRate() -" << fps;
+    m_layoutFrameRate = qMax( 0, fps );
 }
 
 
 
+/**
+ * @brief Sets the number of vertices above which the iterative layouts
+ * compute only and draw at the end, regardless of the frame rate.
+ * Zero means no limit.
+ * @param maxVertices
+ */
+void Graph::setLayoutAnimateMaxVertices(const int &maxVertices) {
+    qDebug() << "Graph::setLayoutAnimateMaxVertices() -" << maxVertices;
+    m_layoutAnimateMaxVertices = qMax( 0, maxVertices );
+}
+
+
 
 /**
  * @brief  Creates an adjacency matrix AM
@@ -21038,102 +25693,149 @@ void Graph::writeMatrixAdjacencyPlot (const QString fn,
  *  and AM(i,j)=0 if i not connected to j
  *  Used in Graph::centralityInformation(), Graph::graphWalksMatrixCreate
  *  and Graph::graphMatrixAdjacencyInvert()
+ *  The matrix is first built into the sparse matrix SAM, see
+ *  graphMatrixAdjacencySparseCreate(). If sparseAllowed is true and the
+ *  density of SAM is below m_graphMatrixAdjacencySparseDensity, the dense AM
+ *  is not built at all (it is cleared) and m_graphMatrixAdjacencySparse is
+ *  set; otherwise SAM is expanded into AM.
  * @param dropIsolates
  * @param considerWeights
  * @param inverseWeights
  * @param symmetrize
+ * @param sparseAllowed
  */
 void Graph::graphMatrixAdjacencyCreate(const bool dropIsolates,
                                        const bool considerWeights,
                                        const bool inverseWeights,
-                                       const bool symmetrize ){
+                                       const bool symmetrize,
+                                       const bool sparseAllowed){
+
+    GraphTraceScope trace("Graph::graphMatrixAdjacencyCreate");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("dropIsolates=%1 considerWeights=%2 inverseWeights=%3 "
+                            "symmetrize=%4 sparseAllowed=%5")
+                    .arg(dropIsolates).arg(considerWeights).arg(inverseWeights)
+                    .arg(symmetrize).arg(sparseAllowed) );
     qDebug() << "Graph::graphMatrixAdjacencyCreate() "
+             << "sparseAllowed" << sparseAllowed;
+
+    graphMatrixAdjacencySparseCreate(dropIsolates, considerWeights,
+                                     inverseWeights, symmetrize);
+
+    m_graphMatrixAdjacencySparse =
+            sparseAllowed && SAM.density() < m_graphMatrixAdjacencySparseDensity;
+
+    qDebug() << "Graph::graphMatrixAdjacencyCreate() - sparse" << m_graphMatrixAdjacencySparse;
+
+    if ( m_graphMatrixAdjacencySparse ) {
+        AM.clear();
+    }
+    else {
+        SAM.toDense(AM);
+    }
+
+    calculatedAdjacencyMatrix=true;
+}
+
+
+
+/**
+ * @brief Creates the sparse adjacency matrix SAM, with the same
+ *  elements as AM (see graphMatrixAdjacencyCreate), from the CSR snapshot
+ *  in O(N+E). The dense AM is left untouched.
+ *  If symmetrize is true, both SAM(i,j) and SAM(j,i), i<j, get the weight of
+ *  the arc j->i if it exists, else the weight of i->j.
+ * @param dropIsolates
+ * @param considerWeights
+ * @param inverseWeights
+ * @param symmetrize
+ */
+void Graph::graphMatrixAdjacencySparseCreate(const bool &dropIsolates,
+                                             const bool &considerWeights,
+                                             const bool &inverseWeights,
+                                             const bool &symmetrize){
+    qDebug() << "Graph::graphMatrixAdjacencySparseCreate() "
              << "dropIsolates" << dropIsolates
              << "considerWeights" << considerWeights
              << "inverseWeights" << inverseWeights
              << "symmetrize" << symmetrize;
-    qreal m_weight=RAND_MAX;
-    int i=0, j=0;
-    int N = vertices(dropIsolates,false,true), progressCounter=0;
-    VList::const_iterator it, jt;
 
-    qDebug() << "Graph::graphMatrixAdjacencyCreate() -resizing AM to"<< N;
-    AM.resize(N, N);
+    const GraphCSR &csr = graphCSR();
+    const int V = csr.vertices();
+    int N = 0, progressCounter=0;
 
-    QString pMsg = tr ("Creating Adjacency Matrix. \nPlease wait...");
-    emit statusMessage (pMsg);
-    emit signalProgressBoxCreate(N, pMsg);
+    // Matrix index of each CSR vertex, -1 if it is left out
+    QVector<int> index(V, -1);
+    for (int v = 0; v < V; ++v) {
+        if ( ! csr.isEnabled(v) || ( m_graph[v]->isIsolated() && dropIsolates) ) {
+            continue;
+        }
+        index[v] = N++;
+    }
 
-    for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
+    auto cellValue = [&considerWeights, &inverseWeights] (const qreal &weight) -> qreal {
+        if ( weight == 0 ) {
+            return 0.0;
+        }
+        if (!considerWeights) {
+            return 1.0;
+        }
+        return (inverseWeights) ? 1.0 / weight : weight;
+    };
+
+    qDebug() << "Graph::graphMatrixAdjacencySparseCreate() - building SAM of size"<< N;
 
-        qDebug() << "Graph::graphMatrixAdjacencyCreate() - i" << i << "name"<< (*it)->name();
+    QString pMsg = tr ("Creating Adjacency Matrix. \nPlease wait...");
+    emit statusMessage (pMsg);
+    graphProgressCreate(N, pMsg);
 
-        emit signalProgressBoxUpdate(++progressCounter);
+    SAM.resize(N, N);
+    SAM.reserve( (symmetrize) ? 2 * csr.edges() : csr.edges() );
 
-        if ( ! (*it)->isEnabled() || ( (*it)->isIsolated() && dropIsolates) ) {
-            qDebug() << "Graph::graphMatrixAdjacencyCreate() - SKIP i" << i << "name"<< (*it)->name();
+    for (int v = 0; v < V; ++v) {
+        const int i = index[v];
+        if ( i < 0 ) {
             continue;
         }
+        graphProgressUpdate(++progressCounter);
 
-        j=i;
-
-        for (jt=it; jt!=m_graph.end(); jt++){
-
-            qDebug() << "Graph::graphMatrixAdjacencyCreate() - j" << j << "name"<< (*jt)->name();
-
-            if ( ! (*jt)->isEnabled() || ( (*jt)->isIsolated() && dropIsolates) ) {
-                qDebug() << "Graph::graphMatrixAdjacencyCreate() - SKIP j" << j << "name" << (*jt)->name();
-                continue;
+        if ( !symmetrize ) {
+            for (int e = csr.outBegin(v); e < csr.outEnd(v); ++e) {
+                const int j = index[ csr.outTarget(e) ];
+                if ( j >= 0 ) {
+                    SAM.appendItem(i, j, cellValue( csr.outWeight(e) ) );
+                }
             }
+            continue;
+        }
 
-            if ( (m_weight = edgeExists ( (*it)->name(), (*jt)->name() )  ) !=0 ) {
-                if (!considerWeights) {
-                    AM.setItem(i,j, 1 );
-                }
-                else {
-                    if (inverseWeights)
-                        AM.setItem(i,j, 1.0 / m_weight );
-                    else
-                        AM.setItem(i,j, m_weight );
-                }
+        // merge the sorted out- and in-rows of v
+        int eo = csr.outBegin(v), ei = csr.inBegin(v);
+        const int eoEnd = csr.outEnd(v), eiEnd = csr.inEnd(v);
+        while ( eo < eoEnd || ei < eiEnd ) {
+            const int uo = ( eo < eoEnd ) ? csr.outTarget(eo) : V;
+            const int ui = ( ei < eiEnd ) ? csr.inSource(ei) : V;
+            const int u = qMin(uo, ui);
+            const qreal out = ( uo == u ) ? cellValue( csr.outWeight(eo++) ) : 0;
+            const qreal in = ( ui == u ) ? cellValue( csr.inWeight(ei++) ) : 0;
+            const int j = index[u];
+            if ( j < 0 ) {
+                continue;
             }
-            else{
-                AM.setItem(i,j, 0);
+            if ( i < j ) {
+                SAM.appendItem(i, j, ( in != 0 ) ? in : out );
             }
-
-            qDebug()<<" AM("<< i << ","<< j << ") = " <<  AM.item(i,j);
-
-            if (i != j ) {
-                if ( (m_weight = edgeExists ( (*jt)->name(), (*it)->name() )  ) !=0 ) {
-                    if (!considerWeights) {
-                        AM.setItem(j,i, 1 );
-                    }
-                    else {
-                        if (inverseWeights)
-                            AM.setItem(j,i, 1.0 / m_weight );
-                        else
-                            AM.setItem(j,i, m_weight );
-                    }
-                    if (symmetrize && (AM.item(i,j) != AM.item(j,i)) ) {
-                        AM.setItem(i,j, AM.item(j,i) );
-                    }
-                }
-                else {
-                    AM.setItem(j,i, 0);
-                    if (symmetrize && (AM.item(i,j) != AM.item(j,i)) )
-                        AM.setItem(j,i, AM.item(i,j) );
-
-                }
-                qDebug()<<" AM("<< j << ","<< i << ") = " <<  AM.item(j,i);
+            else {
+                SAM.appendItem(i, j, ( out != 0 ) ? out : in );
             }
-            j++;
         }
-        i++;
     }
+    SAM.finish();
 
-    calculatedAdjacencyMatrix=true;
+    qDebug() << "Graph::graphMatrixAdjacencySparseCreate() - SAM non-zeros" << SAM.nonZeros()
+             << "density" << SAM.density();
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
 }
 
@@ -21189,6 +25891,9 @@ bool Graph::graphMatrixAdjacencyInvert(const QString &method){
 void Graph::writeMatrixAdjacencyInvert(const QString &fn,
                                        const QString &method)
 {
+
+    GraphTraceScope trace("Graph::writeMatrixAdjacencyInvert");
+    trace.setInput( vertices(), edgesEnabled() );
     qDebug("Graph::writeMatrixAdjacencyInvert() ");
     int i=0, j=0;
     VList::const_iterator it, it1;
@@ -21239,6 +25944,9 @@ void Graph::writeMatrixAdjacencyInvert(const QString &fn,
  * @param fn
  */
 void Graph::writeMatrixDegreeText(const QString &fn) {
+
+    GraphTraceScope trace("Graph::writeMatrixDegreeText");
+    trace.setInput( vertices(), edgesEnabled() );
     qDebug("Graph::writeMatrixDegreeText() ");
     //    int i=0, j=0;
     //    VList::const_iterator it, it1;
@@ -21267,6 +25975,9 @@ void Graph::writeMatrixDegreeText(const QString &fn) {
  * @param fn
  */
 void Graph::writeMatrixLaplacianPlainText(const QString &fn) {
+
+    GraphTraceScope trace("Graph::writeMatrixLaplacianPlainText");
+    trace.setInput( vertices(), edgesEnabled() );
     qDebug("Graph::writeMatrixLaplacianPlainText() ");
     //    int i=0, j=0;
     //    VList::const_iterator it, it1;
@@ -21325,12 +26036,38 @@ void Graph::layoutRandom(){
     QString pMsg = tr("Embedding Random Layout. \n"
                      "Please wait...");
     emit statusMessage(  pMsg  );
-    emit signalProgressBoxCreate (N,pMsg);
+    graphProgressCreate(N,pMsg);
+
+    randomizeThings();
+
+    // Draw the positions in blocks of vertices, each block from its own
+    // stream of m_random, so that they do not depend on the number of threads.
+    const int blockSize = 4096;
+    const int blocks = ( N + blockSize - 1 ) / blockSize;
+    vector<GraphRandom> streams;
+    streams.reserve(blocks);
+    GraphRandom rng(m_random);
+    for (int b = 0; b < blocks; ++b) {
+        rng.jump();
+        streams.push_back(rng);
+    }
+    rng.jump();
+    m_random = rng;
+
+    vector<double> positionsX(N), positionsY(N);
+    graphParallelFor( blocks, graphWorkerThreads(blocks),
+                      [&](const int &, const int &b) {
+        const int last = qMin( N, ( b + 1 ) * blockSize );
+        for (int i = b * blockSize; i < last; ++i) {
+            positionsX[i] = canvasRandomX( streams[b] );
+            positionsY[i] = canvasRandomY( streams[b] );
+        }
+    }, false );
 
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
-        emit signalProgressBoxUpdate (++progressCounter);
-        new_x= canvasRandomX();
-        new_y= canvasRandomY();
+        new_x= positionsX[ progressCounter ];
+        new_y= positionsY[ progressCounter ];
+        graphProgressUpdate(++progressCounter);
         (*it)->setX( new_x );
         (*it)->setY( new_y );
         qDebug()<< "Graph::layoutRandom() - "
@@ -21339,7 +26076,7 @@ void Graph::layoutRandom(){
         emit setNodePos((*it)->name(),  new_x,  new_y);
     }
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
     graphSetModified(GraphChange::ChangedPositions);
 }
@@ -21374,14 +26111,16 @@ void Graph::layoutRadialRandom(const bool &guides){
     QString pMsg = tr("Embedding Random Radial layout. \n"
                       "Please wait ....");
     emit statusMessage(  pMsg );
-    emit signalProgressBoxCreate(N,pMsg );
+    graphProgressCreate(N,pMsg );
+
+    randomizeThings();
 
 
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
-        randomDecimal = (qreal ) ( rand() % 100 ) / 100.0;
+        randomDecimal = (qreal ) ( m_random.bounded(100) ) / 100.0;
         new_radius=(maxRadius- (randomDecimal - offset)*maxRadius);
 
         qDebug () << "Vertice " << (*it)->name()
@@ -21406,7 +26145,7 @@ void Graph::layoutRadialRandom(const bool &guides){
         }
     }
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
     graphSetModified(GraphChange::ChangedPositions);
 }
 
@@ -21430,11 +26169,11 @@ void Graph::layoutCircular (const double &x0, const double &y0,
 
     QString pMsg=tr("Applying circular layout. \nPlease wait...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(N, pMsg);
+    graphProgressCreate(N, pMsg);
 
     for (it=m_graph.cbegin(); it!=m_graph.cend(); ++it){
 
-        emit signalProgressBoxUpdate(++progressCounter);
+        graphProgressUpdate(++progressCounter);
 
         if ( ! (*it)->isEnabled() ) {
             qDebug() << "  vertex i" << (*it)->name() << " disabled. Continue";
@@ -21458,7 +26197,7 @@ void Graph::layoutCircular (const double &x0, const double &y0,
 
     }
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
     graphSetModified(GraphChange::ChangedPositions);
 
@@ -21514,7 +26253,14 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
                                      const bool considerWeights,
                                      const bool inverseWeights,
                                      const bool dropIsolates) {
-    qDebug() << "Graph::layoutByProminenceIndex - "
+
+    GraphTraceScope trace("Graph::layoutByProminenceIndex");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("prominenceIndex=%1 layoutType=%2 considerWeights=%3 "
+                            "inverseWeights=%4 dropIsolates=%5")
+                    .arg(prominenceIndex).arg(layoutType).arg(considerWeights)
+                    .arg(inverseWeights).arg(dropIsolates) );
+    qCHotDebug(lcGraph) << "Graph::layoutByProminenceIndex - "
                 << "index = " << prominenceIndex
                 << "type = " << layoutType;
 
@@ -21604,7 +26350,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
     }
     }
     emit statusMessage(  pMsg );
-    emit signalProgressBoxCreate(N,pMsg);
+    graphProgressCreate(N,pMsg);
 
     for  (it=m_graph.cbegin(); it!=m_graph.cend(); ++it) {
 
@@ -21689,13 +26435,13 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
 
         norm = std/maxC;
 
-        emit signalProgressBoxUpdate( ++progressCounter);
+        graphProgressUpdate( ++progressCounter);
 
         switch (layoutType){
 
         case 0: { // radial
 
-            qDebug () << "vertex" << (*it)->name()
+            qCHotDebug(lcGraph) << "vertex" << (*it)->name()
                       << "pos x" << (*it)->x() << "y"<< (*it)->y()
                       << "C" << C << "stdC" << std << "maxC"<< maxC
                       << "norm (std/maxC)" << norm
@@ -21706,7 +26452,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
             switch (static_cast<int> (ceil(maxC)) ){
 
             case 0: {
-                qDebug("maxC=0.   Using maxRadius");
+                qCHotDebug(lcGraph, "maxC=0.   Using maxRadius");
                 new_radius=maxRadius;
                 break;
             }
@@ -21722,7 +26468,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
             new_x=x0 + new_radius * cos(i * rad);
             new_y=y0 + new_radius * sin(i * rad);
 
-            qDebug() << "Finished calculation. "
+            qCHotDebug(lcGraph) << "Finished calculation. "
                         "new radial pos: x"<< new_x << "y" << new_y;
 
             //Move vertex to new position
@@ -21740,7 +26486,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
 
         case 1: { // level
 
-            qDebug()<< "vertex" << (*it)->name()
+            qCHotDebug(lcGraph)<< "vertex" << (*it)->name()
                     << "pos x"<< (*it)->x() << "y"<<  (*it)->y()
                     << "C" << C << "stdC" << std  << "maxC "<<	maxC
                     << "norm (std/maxC)" << norm
@@ -21753,7 +26499,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
             switch ( static_cast<int> (ceil(maxC)) ){
 
             case 0: {
-                qDebug("maxC=0.   Using maxHeight");
+                qCHotDebug(lcGraph, "maxC=0.   Using maxHeight");
                 new_y=maxHeight;
                 break;
             }
@@ -21765,9 +26511,9 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
 
             };
 
-            new_x=offset/2.0 + rand() % ( static_cast<int> (maxWidth) );
+            new_x=offset/2.0 + m_random.bounded( static_cast<int> (maxWidth) );
 
-            qDebug() << "Finished calculation. "
+            qCHotDebug(lcGraph) << "Finished calculation. "
                         "new level pos: x"<< new_x << "y" << new_y;
 
             //Move vertex to new position
@@ -21786,7 +26532,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
 
         case 2: { // node size
 
-            qDebug () << "vertex" << (*it)->name()
+            qCHotDebug(lcGraph) << "vertex" << (*it)->name()
                       << "C=" << C << ", stdC=" << std  << "maxC" << maxC
                       << "initVertexSize " << initVertexSize
                       << "norm (stdC/maxC) " << norm
@@ -21796,7 +26542,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
             switch (static_cast<int> (ceil(maxC) )){
 
             case 0: {
-                qDebug()<<"maxC=0.   Using initVertexSize";
+                qCHotDebug(lcGraph)<<"maxC=0.   Using initVertexSize";
                 new_size=initVertexSize;
                 break;
             }
@@ -21809,7 +26555,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
             };
 
             //set new vertex size and emit signal to change node size
-            qDebug() << "Finished calculation. "
+            qCHotDebug(lcGraph) << "Finished calculation. "
                      << "new vertex size "<< new_size << " call setSize()";
             (*it)->setSize(new_size);
             emit setNodeSize((*it)->name(),  new_size);
@@ -21819,7 +26565,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
 
         case 3: { // node color
 
-            qDebug () << "vertex" << (*it)->name()
+            qCHotDebug(lcGraph) << "vertex" << (*it)->name()
                       << "C=" << C << ", stdC=" << std << "maxC" << maxC
                       << "initVertexColor " << initVertexColor
                       << "norm (stdC/maxC) " << norm;
@@ -21827,7 +26573,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
             //Calculate new node color
             switch (static_cast<int> (ceil(maxC) )){
             case 0: {
-                qDebug()<<"maxC=0.   Using initVertexColor";
+                qCHotDebug(lcGraph)<<"maxC=0.   Using initVertexColor";
                 new_color = QColor (initVertexColor);
                 break;
             }
@@ -21840,7 +26586,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
             };
 
             //change vertex color and emit signal to change node color as well
-            qDebug ()<< "new vertex color "<< new_color << " call setSize()";
+            qCHotDebug(lcGraph)<< "new vertex color "<< new_color << " call setSize()";
             (*it)->setColor(new_color.name());
 
             emit setNodeColor((*it)->name(),  new_color.name());
@@ -21851,7 +26597,7 @@ void Graph::layoutByProminenceIndex (int prominenceIndex, int layoutType,
         };
     }
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 
     graphSetModified(GraphChange::ChangedPositions);
 
@@ -21883,16 +26629,8 @@ void Graph::layoutForceDirectedSpringEmbedder(const int maxIterations){
 
     int iteration = 1 ;
     int progressCounter=0;
-    qreal dist = 0;
-    qreal f_rep=0, f_att=0;
-    QPointF DV;
     qreal c4=0.1; //normalization factor for final displacement
 
-
-    VList::const_iterator v1;
-    VList::const_iterator v2;
-
-
     /**
      * compute max spring length as function of canvas area divided by the
      * total vertices area
@@ -21904,6 +26642,9 @@ void Graph::layoutForceDirectedSpringEmbedder(const int maxIterations){
              << " naturalLength " << naturalLength;
 
 
+    QVector<QPointF> startPositions;
+    layoutPositionsSave(startPositions);
+
     /* apply an initial random layout */
     //layoutCircular(canvasWidth/2.0, canvasHeight/2.0, naturalLength/2.0 ,false);
     layoutRandom();
@@ -21911,103 +26652,42 @@ void Graph::layoutForceDirectedSpringEmbedder(const int maxIterations){
     QString pMsg  = tr ( "Embedding Eades Spring-Gravitational model. \n"
                          "Please wait ....");
     emit statusMessage( pMsg  );
-    emit signalProgressBoxCreate (maxIterations, pMsg );
-
-    for ( iteration=1; iteration <= maxIterations ; iteration++) {
-
-        //setup init disp
-        for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1)
-        {
-            (*v1) -> disp().rx() = 0;
-            (*v1) -> disp().ry() = 0;
-            qDebug() << " 0000 s " << (*v1)->name() << " zeroing rx/ry";
-        }
+    graphProgressCreate(maxIterations, pMsg );
 
-        for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1)
-        {
-            qDebug() << "*********  Calculate forces for source s  "
-                     << (*v1) -> name()
-                     <<" pos "<< (*v1) -> x()<< ", "<< (*v1) -> y();
-
-            if ( ! (*v1)->isEnabled() ) {
-                qDebug() << "  vertex s disabled. Continue";
-                continue;
-            }
-
-            for (v2=m_graph.cbegin(); v2!=m_graph.cend(); ++v2)
-            {
-                if ( ! (*v2)->isEnabled() ) {
-                    qDebug() << "   t " << (*v1)->name() << " disabled. Continue";
-                    continue;
-                }
-
-                if (v2 == v1) {
-                    qDebug() << "   s==t, continuing";
-                    continue;
-                }
-
-                DV.setX( (*v2) -> x() - (*v1)->x());
-                DV.setY( (*v2) -> y() - (*v1)->y());
-
-                dist = graphDistanceEuclidean(DV);
-
-                /**
-                  *  calculate electric (repulsive) forces between
-                  *  all vertices.
-                  */
-                f_rep = layoutForceDirected_F_rep ("Eades", dist, naturalLength) ;
-                (*v1)->disp().rx() += sign( DV.x() ) * f_rep ;
-                (*v1)->disp().ry() += sign( DV.y() ) * f_rep  ;
-                qDebug() <<"  s = "<< (*v1)->name()
-                        <<" pushed away from t = " << (*v2) -> name()
-                       << " dist " <<dist
-                       << " f_rep=" << f_rep
-                       << " sign * f_repx " << sign( DV.x() ) * f_rep
-                       << " sign * f_repy " << sign( DV.y() ) * f_rep ;
+    vector<int> layoutVertices, layoutOffsets, layoutTargets;
+    layoutForceDirected_graph(layoutVertices, layoutOffsets, layoutTargets);
 
-                /**
-                * calculate spring forces between adjacent nodes
-                * that pull them together (if d > naturalLength)
-                * or push them apart (if d < naturalLength)
-                */
-                if ( this->edgeExists( (*v1) ->name(), (*v2) -> name()) ) {
+    GraphLayoutEngine engine;
+    layoutForceDirected_engine(engine, "Eades", naturalLength, layoutOffsets, layoutTargets);
+    layoutForceDirected_positions(engine, layoutVertices);
 
-                    f_att = layoutForceDirected_F_att ("Eades", dist, naturalLength) ;
-
-                    (*v1)->disp().rx() += sign( DV.x() ) * f_att ;
-                    (*v1)->disp().ry() += sign( DV.y() ) * f_att ;
-                    (*v2)->disp().rx() -= sign( DV.x() ) * f_att ;
-                    (*v2)->disp().ry() -= sign( DV.y() ) * f_att ;
-
-                    qDebug() << "  s= "<<(*v1)->name()
-                             << " attracted by t= "<< (*v2)->name()
-                             << " dist " <<dist
-                             << " f_att="<< f_att
-                             << " sdx * f_att " <<sign( DV.x() ) * f_att
-                             << " sdy * f_att " <<sign( DV.y() ) * f_att
-                             << " disp_s.x="<< (*v2)->disp().rx()
-                             << " disp_s.y="<< (*v2)->disp().ry()
-                             << " disp_t.x="<< (*v2)->disp().rx()
-                             << " disp_t.y="<< (*v2)->disp().ry();
+    for ( iteration=1; iteration <= maxIterations ; iteration++) {
 
-                }  // end if edgeExists
+        engine.computeDisplacements();
 
-            } //end for v2
+        engine.moveByFactor(c4);
 
-            qDebug() << "  >>> final s = "<< (*v1)->name()
-                     << " disp_s.x="<< (*v1)->disp().rx()
-                     << " disp_s.y="<< (*v1)->disp().ry();
+        if ( layoutFrameDue( engine.size() ) ) {
+            layoutPositionsEmit( layoutVertices, engine.x(), engine.y() );
+        }
 
-        } // end for v1
+        graphProgressUpdate( ++progressCounter );
 
+        if ( graphCancelled() ) {
+            break;
+        }
 
-        layoutForceDirected_Eades_moveNodes(c4) ;
+    } //end iterations
 
-        emit signalProgressBoxUpdate( ++progressCounter );
+    if ( graphCancelled() ) {
+        graphProgressKill();
+        layoutPositionsRestore(startPositions);
+        return;
+    }
 
-    } //end iterations
+    layoutForceDirected_apply(engine, layoutVertices);
 
-    emit signalProgressBoxKill();
+    graphProgressKill();
 }
 
 
@@ -22024,10 +26704,12 @@ void Graph::layoutForceDirectedSpringEmbedder(const int maxIterations){
  * @param maxIterations
  */
 void Graph::layoutForceDirectedFruchtermanReingold(const int maxIterations){
+
+    GraphTraceScope trace("Graph::layoutForceDirectedFruchtermanReingold");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("maxIterations=%1")
+                    .arg(maxIterations) );
     int progressCounter=0;
-    qreal dist = 0;
-    qreal f_att, f_rep;
-    QPointF DV;   //difference vector
 
     qreal V = (qreal) vertices() ;
     qreal C=0.9; //this is found experimentally
@@ -22035,108 +26717,269 @@ void Graph::layoutForceDirectedFruchtermanReingold(const int maxIterations){
     // we add vertexWidth to it
     qreal optimalDistance= C * computeOptimalDistance(V);
 
-    VList::const_iterator v1, v2;
     int iteration = 1 ;
 
     /* apply an initial circular layout */
     //layoutCircular(canvasWidth/2.0, canvasHeight/2.0, optimalDistance/2.0,false);
     //layoutRandom();
 
-    qDebug() << "Graph: layoutForceDirectedFruchtermanReingold() ";
-    qDebug () << "Graph: Setting optimalDistance = "<<  optimalDistance
-              << "...following Fruchterman-Reingold (1991) formula ";
+    qCHotDebug(lcGraph) << "Graph: layoutForceDirectedFruchtermanReingold() ";
+    qCHotDebug(lcGraph) << "Graph: Setting optimalDistance = "<<  optimalDistance
+              << "...following Fruchterman-Reingold (1991) formula ";
+
+    qCHotDebug(lcGraph) << "Graph: canvasWidth " << canvasWidth << " canvasHeight " << canvasHeight;
+
+
+    QString pMsg = tr( "Embedding Fruchterman & Reingold forces model. \n"
+                       "Please wait ...");
+    emit statusMessage( pMsg );
+
+    graphProgressCreate(maxIterations,pMsg );
+
+    QVector<QPointF> startPositions;
+    layoutPositionsSave(startPositions);
+
+    vector<int> layoutVertices, layoutOffsets, layoutTargets;
+    layoutForceDirected_graph(layoutVertices, layoutOffsets, layoutTargets);
+
+    GraphLayoutEngine engine;
+    layoutForceDirected_engine(engine, "FR", optimalDistance, layoutOffsets, layoutTargets);
+    layoutForceDirected_positions(engine, layoutVertices);
+
+    for ( iteration=1; iteration <= maxIterations ; iteration++) {
+
+        engine.computeDisplacements();
+
+        // limit the max displacement to the temperature t
+        // prevent placement outside of the frame/canvas
+        engine.moveByTemperature( layoutForceDirected_FR_temperature (iteration) );
+
+        if ( layoutFrameDue( engine.size() ) ) {
+            layoutPositionsEmit( layoutVertices, engine.x(), engine.y() );
+        }
+
+        graphProgressUpdate( ++progressCounter );
+
+        if ( graphCancelled() ) {
+            // the vertices themselves have not moved yet
+            graphProgressKill();
+            layoutPositionsRestore(startPositions);
+            return;
+        }
+    }
+
+    layoutForceDirected_apply(engine, layoutVertices);
+
+    graphProgressKill();
+}
+
+
+
+/**
+ * @brief Embeds a multilevel Force Directed Placement layout, in the style of
+ * FM^3 (Hachul & Juenger, 2004) and sfdp (Hu, 2005), with the forces of the
+ * Eades or the Fruchterman-Reingold model.
+ * The network is coarsened repeatedly by matching each vertex with its lightest
+ * unmatched neighbor; a vertex whose neighbors are all taken joins the lightest
+ * neighboring group instead. The coarsest graph starts from random positions and
+ * gets maxIterations iterations. Then every level is prolonged to the next
+ * finer one, placing each vertex near its group, and refined with a tenth of
+ * maxIterations iterations, at a temperature that starts at the optimal
+ * distance of the level and cools to zero.
+ * @param model "Eades" or "FR"
+ * @param maxIterations
+ */
+void Graph::layoutForceDirectedMultilevel(const QString model,
+                                          const int maxIterations) {
+
+    GraphTraceScope trace("Graph::layoutForceDirectedMultilevel");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("model=%1 maxIterations=%2")
+                    .arg(model).arg(maxIterations) );
+
+    const bool eades = ( model == "Eades" );
+    const qreal C = eades ? 1.0 : 0.9;
+    const qreal c4 = 0.1;   // Eades normalization factor for the displacement
+    const int coarsestSize = 50;
+    const int refineIterations = qMax( 5, maxIterations / 10 );
 
-    qDebug() << "Graph: canvasWidth " << canvasWidth << " canvasHeight " << canvasHeight;
+    qDebug() << "Graph::layoutForceDirectedMultilevel() - model" << model
+             << "maxIterations" << maxIterations;
 
+    randomizeThings();
 
-    QString pMsg = tr( "Embedding Fruchterman & Reingold forces model. \n"
-                       "Please wait ...");
-    emit statusMessage( pMsg );
+    // Level 0 is the network itself, with symmetric arcs
+    vector<int> layoutVertices;
+    vector< vector<int> > offsets(1), targets(1), parents;
+    layoutForceDirected_graph(layoutVertices, offsets[0], targets[0], true);
 
-    emit signalProgressBoxCreate(maxIterations,pMsg );
+    const int n0 = (int) layoutVertices.size();
+    if ( n0 == 0 ) {
+        return;
+    }
 
-    for ( iteration=1; iteration <= maxIterations ; iteration++) {
+    vector<int> mass(n0, 1);
 
-        //setup init disp
-        for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1)
-        {
-            (*v1)->disp().rx() = 0;
-            (*v1)->disp().ry() = 0;
-            //qDebug() << " 0000 s " << (*v1)->name() << " zeroing rx/ry";
-        }
+    // Coarsen, while it pays
+    while ( (int) offsets.back().size() - 1 > coarsestSize ) {
 
-        for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1)
-        {
-            //            qDebug() << "*****  Calculate forces for s " << (*v1)->name()
-            //                     << " vpos " <<  vpos[(*v1)->name()]
-            //                     << " pos "<< (*v1)->x() << ", "<< (*v1)->y();
+        const vector<int> &off = offsets.back();
+        const vector<int> &tgt = targets.back();
+        const int n = (int) off.size() - 1;
 
-            if ( ! (*v1)->isEnabled() ) {
-                //                qDebug() << "  vertex s " << (*v1)->name() << " disabled. Continue";
+        vector<int> order(n);
+        for (int u = 0; u < n; ++u) {
+            order[u] = u;
+        }
+        for (int u = n - 1; u > 0; --u) {
+            std::swap( order[u], order[ m_random.bounded(u + 1) ] );
+        }
+
+        vector<int> parent(n, -1);
+        vector<int> groupMass;
+        for (const int &u : order) {
+            if ( parent[u] >= 0 ) {
                 continue;
             }
+            int match = -1, group = -1;
+            for (int e = off[u]; e < off[u+1]; ++e) {
+                const int v = tgt[e];
+                if ( parent[v] < 0 ) {
+                    if ( match < 0 || mass[v] < mass[match] ) {
+                        match = v;
+                    }
+                }
+                else if ( group < 0 || groupMass[ parent[v] ] < groupMass[group] ) {
+                    group = parent[v];
+                }
+            }
+            if ( match >= 0 ) {
+                parent[u] = parent[match] = (int) groupMass.size();
+                groupMass.push_back( mass[u] + mass[match] );
+            }
+            else if ( group >= 0 ) {
+                parent[u] = group;
+                groupMass[group] += mass[u];
+            }
+            else {
+                parent[u] = (int) groupMass.size();
+                groupMass.push_back( mass[u] );
+            }
+        }
 
-            for (v2=m_graph.cbegin(); v2!=m_graph.cend(); ++v2)
-            {
-                //                qDebug () << "  t = "<< (*v2)->name()
-                //                          << "  pos (" <<  (*v2)->x() << "," << (*v2)->y() << ")";
+        const int coarse = (int) groupMass.size();
+        if ( coarse > 0.9 * n ) {
+            break;   // mostly isolates or a matching that barely shrinks
+        }
 
-                if ( ! (*v2)->isEnabled() ) {
-                    //                    qDebug()<< " t "<< (*v2)->name()<< " disabled. Continue";
-                    continue;
+        // The arcs between the groups, once per pair and direction
+        vector< vector<int> > rows(coarse);
+        for (int u = 0; u < n; ++u) {
+            for (int e = off[u]; e < off[u+1]; ++e) {
+                if ( parent[u] != parent[ tgt[e] ] ) {
+                    rows[ parent[u] ].push_back( parent[ tgt[e] ] );
                 }
+            }
+        }
+        vector<int> coarseOffsets(coarse + 1, 0), coarseTargets;
+        for (int g = 0; g < coarse; ++g) {
+            std::sort( rows[g].begin(), rows[g].end() );
+            rows[g].erase( std::unique( rows[g].begin(), rows[g].end() ), rows[g].end() );
+            coarseTargets.insert( coarseTargets.end(), rows[g].begin(), rows[g].end() );
+            coarseOffsets[g+1] = (int) coarseTargets.size();
+        }
 
-                if (v2 == v1) {
-                    //                    qDebug() << "  s==t, continuing";
-                    continue;
-                }
+        parents.push_back( parent );
+        offsets.push_back( coarseOffsets );
+        targets.push_back( coarseTargets );
+        mass = groupMass;
+    }
 
-                DV.setX( (*v2)->x() - (*v1)->x() );
-                DV.setY( (*v2)->y() - (*v1)->y() );
+    const int levels = (int) offsets.size();
+    qDebug() << "Graph::layoutForceDirectedMultilevel() - levels" << levels
+             << "coarsest vertices" << offsets.back().size() - 1;
 
-                dist = graphDistanceEuclidean( DV );
+    QString pMsg = tr( "Embedding multilevel force-directed layout. \n"
+                       "Please wait ...");
+    emit statusMessage( pMsg );
+    graphProgressCreate( maxIterations + ( levels - 1 ) * refineIterations, pMsg );
+    int progressCounter = 0;
 
-                //calculate repulsive force from _near_ vertices
-                f_rep = layoutForceDirected_F_rep( "FR", dist, optimalDistance);
-                (*v1)->disp().rx() += sign( DV.x() ) * f_rep;
-                (*v1)->disp().ry() += sign( DV.y() ) * f_rep ;
+    QVector<QPointF> startPositions;
+    layoutPositionsSave(startPositions);
 
-                //                qDebug()<< " dist( " << (*v1)->name() <<  "," <<  (*v2)->name() <<  " = "
-                //                        << dist
-                //                        << " f_rep " << f_rep
-                //                        << " disp_s.x="<< (*v1)->disp().rx()
-                //                        << " disp_s.y="<< (*v1)->disp().ry();
+    // Start the coarsest level from random positions
+    GraphLayoutEngine engine;
+    layoutForceDirected_engine(engine, model, C * computeOptimalDistance(offsets.back().size() - 1),
+                               offsets.back(), targets.back());
+    for (int u = 0; u < engine.size(); ++u) {
+        engine.x()[u] = canvasRandomX();
+        engine.y()[u] = canvasRandomY();
+    }
 
-                if ( edgeExists ((*v1)->name(), (*v2)->name()) ) {
-                    //calculate attracting force
-                    f_att = layoutForceDirected_F_att ("FR", dist, optimalDistance);
-                    (*v1)->disp().rx() += sign( DV.x() ) * f_att;
-                    (*v1)->disp().ry() += sign( DV.y() ) * f_att;
-                    (*v2)->disp().rx() -= sign( DV.x() ) * f_att ;
-                    (*v2)->disp().ry() -= sign( DV.y() ) * f_att ;
+    qreal temperature = 0;
 
-                    qDebug() << "  s= "<<(*v1)->name()
-                             << " attracted by t= "<< (*v2)->name()
-                             <<"  optimalDistance =" << optimalDistance
-                            << " f_att " << f_att
-                            << " disp_s.x="<< (*v1)->disp().rx()
-                            << " disp_s.y="<< (*v1)->disp().ry()
-                            << " disp_t.x="<< (*v2)->disp().rx()
-                            << " disp_t.y="<< (*v2)->disp().ry();
-                } //endif
+    for (int level = levels - 1; level >= 0; --level) {
 
-            }//end for v2
+        const int n = engine.size();
+        const qreal optimalDistance = C * computeOptimalDistance(n);
+        const int iterations = ( level == levels - 1 ) ? maxIterations : refineIterations;
 
-        } //end for v1
+        for (int iteration = 1; iteration <= iterations; ++iteration) {
 
-        // limit the max displacement to the temperature t
-        // prevent placement outside of the frame/canvas
-        layoutForceDirected_FR_moveNodes( layoutForceDirected_FR_temperature (iteration) );
+            engine.computeDisplacements();
+
+            if ( eades ) {
+                engine.moveByFactor(c4);
+            }
+            else {
+                temperature = ( level == levels - 1 )
+                        ? layoutForceDirected_FR_temperature(iteration)
+                        : optimalDistance * ( iterations - iteration + 1 ) / iterations;
+                engine.moveByTemperature(temperature);
+            }
+
+            // only the finest level has the positions of the vertices
+            if ( level == 0 && layoutFrameDue( engine.size() ) ) {
+                layoutPositionsEmit( layoutVertices, engine.x(), engine.y() );
+            }
+
+            graphProgressUpdate( ++progressCounter );
+
+            if ( graphCancelled() ) {
+                break;
+            }
+        }
+
+        if ( level == 0 || graphCancelled() ) {
+            break;
+        }
 
-        emit signalProgressBoxUpdate( ++progressCounter );
+        // Prolong to the finer level: each vertex starts near its group
+        const vector<int> &parent = parents[level - 1];
+        const qreal jitter = C * computeOptimalDistance( (int) parent.size() ) / 2.0;
+        vector<qreal> fineX( parent.size() ), fineY( parent.size() );
+        for (size_t u = 0; u < parent.size(); ++u) {
+            fineX[u] = canvasVisibleX( engine.x()[ parent[u] ] + jitter * ( 2.0 * m_random.uniform() - 1.0 ) );
+            fineY[u] = canvasVisibleY( engine.y()[ parent[u] ] + jitter * ( 2.0 * m_random.uniform() - 1.0 ) );
+        }
+        layoutForceDirected_engine(engine, model, C * computeOptimalDistance( (int) parent.size() ),
+                                   offsets[level - 1], targets[level - 1]);
+        engine.x().swap(fineX);
+        engine.y().swap(fineY);
     }
 
-    emit signalProgressBoxKill();
+    if ( graphCancelled() ) {
+        graphProgressKill();
+        layoutPositionsRestore(startPositions);
+        return;
+    }
+
+    layoutForceDirected_apply(engine, layoutVertices);
+
+    graphProgressKill();
+
+    graphSetModified(GraphChange::ChangedPositions);
 }
 
 
@@ -22161,7 +27004,14 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
                                            const bool dropIsolates,
                                            const QString  &initialPositions){
 
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
+    GraphTraceScope trace("Graph::layoutForceDirectedKamadaKawai");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("maxIterations=%1 considerWeights=%2 inverseWeights=%3 "
+                            "dropIsolates=%4 initialPositions=%5")
+                    .arg(maxIterations).arg(considerWeights).arg(inverseWeights)
+                    .arg(dropIsolates).arg(initialPositions) );
+
+    qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - "
                << "maxIter " << maxIterations;
 
     VList::const_iterator v1, v2;
@@ -22209,10 +27059,14 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
 
     // Compute graph-theoretic distances dij for 1 <= i!=j <= n
 
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - Compute dij, where (i,j) in E";
+    qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - Compute dij, where (i,j) in E";
 
     graphMatrixDistanceGeodesicCreate(considerWeights,inverseWeights, dropIsolates);
 
+    if ( graphCancelled() ) {
+        return;
+    }
+
     // Compute original spring length
     // lij for 1 <= i!=j <= n using the formula:
     // lij = L x dij
@@ -22221,19 +27075,18 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
     // diameter D of the graph and the length L of a side of the display square:
     // L = L0 / D
 
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
+    qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - "
                "Compute lij = L x dij. lij will be symmmetric.";
 
     D = graphDiameter(considerWeights,inverseWeights);
     L0 = canvasMinDimension()-100;
     L = L0 / D;
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - L="
+    qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - L="
             << L0 << "/" <<D << "=" <<L;
 
-    l.zeroMatrix(DM.rows(), DM.cols());
     l=DM;
     l.multiplyScalar(L);
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - l=" ;
+    qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - l=" ;
     //l.printMatrixConsole();
 
 
@@ -22241,7 +27094,7 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
     // kij = K / dij ^2
     // kij is the strength of the spring between pi and pj, K a constant
 
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
+    qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - "
                "Compute kij = K / dij ^2. kij will be symmmetric. ";
 
     k.zeroMatrix(DM.rows(), DM.cols());
@@ -22253,15 +27106,18 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
             k.setItem(i,j, K / (DM.item(i,j) * DM.item(i,j)));
         }
     }
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - k=" ;
+    qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - k=" ;
     //k.printMatrixConsole();
 
 
     // initialize p1, p2, ... pn
-    qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
+    qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - "
                "Set particles to initial positions p" ;
     i=0;
 
+    QVector<QPointF> startPositions;
+    layoutPositionsSave(startPositions);
+
     if (initialPositions == "circle") {
         double x0=0, y0=0;
         x0=canvasWidth/2.0;
@@ -22278,17 +27134,25 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
     QString pMsg = tr("Embedding Kamada & Kawai spring model.\n"
                       "Please wait...");
     emit statusMessage( pMsg );
-    emit signalProgressBoxCreate(maxIterations, pMsg);
+    graphProgressCreate(maxIterations, pMsg);
 
     // while ( max_D_i > e )
     while (Delta_max > epsilon) {
 
         progressCounter++;
 
-        emit signalProgressBoxUpdate( progressCounter );
+        graphProgressUpdate( progressCounter );
+
+        if ( graphCancelled() ) {
+            qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - "
+                       "Cancelled. RETURN";
+            graphProgressKill();
+            layoutPositionsRestore(startPositions);
+            return;
+        }
 
         if (progressCounter == maxIterations) {
-            qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
+            qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - "
                        "Reached maxIterations. BREAK";
             break;
         }
@@ -22300,7 +27164,7 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
         // compute partial derivatives of E by xm and ym for every particle m
         // using equations 7 and 8
 
-        qDebug()<< "Graph::layoutForceDirectedKamadaKawai() -  Iteration"
+        qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() -  Iteration"
                 << progressCounter
                 <<  "Choose particle with largest Delta_m = max Delta_i ";
 
@@ -22313,14 +27177,14 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
             xm = (*v1)->x();
             ym = (*v1)->y();
 
-            qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
+            qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - "
                        "Compute partial derivatives E for particle" << pn
                     << " vpos m" <<  m
                     << " pos"<< xm << ", "<< ym;
 
 
             if ( ! (*v1)->isEnabled() ) {
-                qDebug() << "  particle " << pn
+                qCHotDebug(lcGraph) << "  particle " << pn
                          << " vpos m " << m << " disabled. Continue";
                 continue;
             }
@@ -22334,16 +27198,16 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
                 xi = (*v2)->x();
                 yi = (*v2)->y();
 
-                qDebug () << "  particle vpos i"<< i
+                qCHotDebug(lcGraph) << "  particle vpos i"<< i
                           << "  pos (" <<  xi << "," << yi << ")";
 
                 if ( ! (*v2)->isEnabled() ) {
-                    qDebug()<< " i "<< (*v2)->name()<< " disabled. Continue";
+                    qCHotDebug(lcGraph)<< " i "<< (*v2)->name()<< " disabled. Continue";
                     continue;
                 }
 
                 if (m == i) {
-                    qDebug() << "  m==i, continuing";
+                    qCHotDebug(lcGraph) << "  m==i, continuing";
                     continue;
                 }
 
@@ -22355,11 +27219,11 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
 
             Delta_m = sqrt (partDrvtEx * partDrvtEx + partDrvtEy * partDrvtEy);
 
-            qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - m" << m << " Delta_m"
+            qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - m" << m << " Delta_m"
                     << Delta_m;
 
             if (Delta_m > Delta_max) {
-                qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - m" << m << " Delta_m > Delta_max. "
+                qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - m" << m << " Delta_m > Delta_max. "
                         << " Setting new Delta_max = "
                         << Delta_m;
 
@@ -22377,7 +27241,7 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
 
 
         if (pnm < 0) {
-            qDebug () << "Graph::layoutForceDirectedKamadaKawai() - "
+            qCHotDebug(lcGraph) << "Graph::layoutForceDirectedKamadaKawai() - "
                          "No particle left with Delta_m > epsilon -- BREAK";
             break;
         }
@@ -22389,7 +27253,7 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
         xm = xpm;
         ym = ypm;
 
-        qDebug () << "Graph::layoutForceDirectedKamadaKawai() - m"<< m
+        qCHotDebug(lcGraph) << "Graph::layoutForceDirectedKamadaKawai() - m"<< m
                   << " has max Delta_m"<< Delta_max
                   << " Starting minimizing Delta_m - "
                 << " initial m pos " << xm << ym;
@@ -22400,12 +27264,12 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
         // while ( D_m > e)
         do {
             if (minimizationIterations > 10) {
-                qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
+                qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - "
                          "Reached minimizationIterations threshold. BREAK";
                 break;
             }
             minimizationIterations++;
-            qDebug () << "Graph::layoutForceDirectedKamadaKawai() - "
+            qCHotDebug(lcGraph) << "Graph::layoutForceDirectedKamadaKawai() - "
                         "Started minimizing Delta_m for m"<< m
                       << "First compute dx and dy by solving equations 11 and 12 ";
 
@@ -22426,16 +27290,16 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
                 xi = (*v2)->x();
                 yi = (*v2)->y();
 
-                qDebug () << "  m"<< m << "  i"<< i
+                qCHotDebug(lcGraph) << "  m"<< m << "  i"<< i
                           << "  pos_i (" <<  xi << "," << yi << ")";
 
                 if ( ! (*v2)->isEnabled() ) {
-                    qDebug()<< " i "<< (*v2)->name()<< " disabled. Continue";
+                    qCHotDebug(lcGraph)<< " i "<< (*v2)->name()<< " disabled. Continue";
                     continue;
                 }
 
                 if (i == m) {
-                    qDebug() << "  m==i, continuing";
+                    qCHotDebug(lcGraph) << "  m==i, continuing";
                     continue;
                 }
                 partDrvDenom = pow ( sqrt( (xm - xi) * (xm - xi) + (ym - yi)*(ym - yi) ) , 3 );
@@ -22457,34 +27321,34 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
 
             Delta_m = sqrt (partDrvtEx_m * partDrvtEx_m + partDrvtEy_m * partDrvtEy_m);
 
-            qDebug () << "Graph::layoutForceDirectedKamadaKawai() - m"<< m << " new Delta_m"
+            qCHotDebug(lcGraph) << "Graph::layoutForceDirectedKamadaKawai() - m"<< m << " new Delta_m"
                   << Delta_m;
 
             LIN_EQ_COEF.setItem(0,0,partDrvtExSec_m);
             LIN_EQ_COEF.setItem(0,1,partDrvtExEySec_m);
             LIN_EQ_COEF.setItem(1,0,partDrvtEyExSec_m);
             LIN_EQ_COEF.setItem(1,1,partDrvtEySec_m);
-            qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - "
+            qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - "
                      " Jacobian Matrix of coefficients for linear system (eq. 11 & 12) is:";
             //LIN_EQ_COEF.printMatrixConsole();
             b[0] = - partDrvtEx_m;
             b[1] = - partDrvtEy_m;
-            qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - right hand vector is: \n"
+            qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - right hand vector is: \n"
                   << b[0] << " \n" << b[1];
-            qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - solving linear system...";
+            qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - solving linear system...";
             LIN_EQ_COEF.solve(b);
-            qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - solved linear system.";
+            qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - solved linear system.";
             dx=b[0];
             dy=b[1];
-            qDebug()<< "Graph::layoutForceDirectedKamadaKawai() - Solution \n b[0] = dx =" << dx
+            qCHotDebug(lcGraph)<< "Graph::layoutForceDirectedKamadaKawai() - Solution \n b[0] = dx =" << dx
                     << "\n b[1] = dy =" << dy;
 
-            qDebug () << "Graph::layoutForceDirectedKamadaKawai() - m"<< m
+            qCHotDebug(lcGraph) << "Graph::layoutForceDirectedKamadaKawai() - m"<< m
                       << " current m pos " << xm << ym
                       << " new m pos " << xm +dx << ym+dy;
 
             if ( (xm + dx) < 50 || (xm + dx) > (canvasWidth-50) ) {
-                qDebug () << "Graph::layoutForceDirectedKamadaKawai() - "
+                qCHotDebug(lcGraph) << "Graph::layoutForceDirectedKamadaKawai() - "
                            "new xm out of canvas, setting random x";
                 xm = canvasRandomX();
             }
@@ -22492,20 +27356,20 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
                 xm = xm + dx;
             }
             if ( (ym + dy) < 50 || (ym + dy) > (canvasHeight-50) ) {
-                qDebug () << "Graph::layoutForceDirectedKamadaKawai() - "
+                qCHotDebug(lcGraph) << "Graph::layoutForceDirectedKamadaKawai() - "
                            "new ym out of canvas, setting random y";
                 ym = canvasRandomY();
             }
             else {
                 ym = ym + dy;
             }
-            qDebug () << "Graph::layoutForceDirectedKamadaKawai() - m"<< m
+            qCHotDebug(lcGraph) << "Graph::layoutForceDirectedKamadaKawai() - m"<< m
                       << " new m pos " << xm  << ym;
 
             // TODO CHECK IF WE HAVE REACHED A FIXED POINT LOOP
 
         } while (Delta_m > epsilon);
-        qDebug () << "Graph::layoutForceDirectedKamadaKawai() - Finished minimizing Delta_m "
+        qCHotDebug(lcGraph) << "Graph::layoutForceDirectedKamadaKawai() - Finished minimizing Delta_m "
                    "for particle" << pnm << "vpos" << m
                   << "Minimized Delta_m"<< Delta_m
                   << "moving it to new pos" << xm << ym;
@@ -22515,14 +27379,17 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
 
     } // end while (Delta_max > epsilon) {
 
-    qDebug () << "Graph::layoutForceDirectedKamadaKawai() - "
+    qCHotDebug(lcGraph) << "Graph::layoutForceDirectedKamadaKawai() - "
                  "Delta_max =< epsilon -- RETURN";
 
+    QVector<int> nodes;
+    QVector<QPointF> positions;
     for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1) {
-
-        emit setNodePos( (*v1)->name(),  (*v1)->pos().x(),  (*v1)->pos().y());
+        nodes << (*v1)->name();
+        positions << (*v1)->pos();
     }
-    emit signalProgressBoxKill();
+    emit signalNodePositions( nodes, positions );
+    graphProgressKill();
 
     graphSetModified(GraphChange::ChangedPositions);
 
@@ -22532,6 +27399,306 @@ void Graph::layoutForceDirectedKamadaKawai(const int maxIterations,
 
 
 
+/**
+ * @brief Embeds the Kamada-Kawai model by stress majorization (Gansner, Koren
+ * & North, 2004), which minimizes the same energy: the sum over all pairs of
+ * w_ij * ( |p_i - p_j| - l_ij )^2, where l_ij = L * d_ij and w_ij = d_ij^-2.
+ * Instead of moving one particle at a time with Newton-Raphson, every
+ * iteration moves all particles at once, in parallel, to
+ * p_i = sum_j w_ij * ( p_j + l_ij * (p_i - p_j) / |p_i - p_j| ) / sum_j w_ij.
+ * If pivots is zero, all pairs are used, with the geodesic distances matrix DM.
+ * Otherwise, the sparse stress model of Ortmann, Klimenta & Brandes (2016)
+ * is used: every particle keeps the pairs with its neighbors, and one pair with
+ * each pivot. The pivots are chosen far apart (max-min) and are weighted by the
+ * number of particles closest to them. Only the pivots need SSSP runs, and
+ * memory grows with (pivots + edges) * N instead of N^2.
+ * Pairs in different components get the distance D + 1, D the diameter.
+ * Stops after maxIterations or when the stress improves less than 1e-4.
+ * @param maxIterations
+ * @param considerWeights
+ * @param inverseWeights
+ * @param initialPositions "current", "circle" or "random"
+ * @param pivots the number of pivots, 0 for all pairs
+ */
+void Graph::layoutForceDirectedStressMajorization(const int maxIterations,
+                                                  const bool considerWeights,
+                                                  const bool inverseWeights,
+                                                  const QString &initialPositions,
+                                                  const int pivots) {
+
+    GraphTraceScope trace("Graph::layoutForceDirectedStressMajorization");
+    trace.setInput( vertices(), edgesEnabled(),
+                    QString("maxIterations=%1 considerWeights=%2 inverseWeights=%3 "
+                            "initialPositions=%4 pivots=%5")
+                    .arg(maxIterations).arg(considerWeights).arg(inverseWeights)
+                    .arg(initialPositions).arg(pivots) );
+
+    qDebug() << "Graph::layoutForceDirectedStressMajorization() - maxIterations"
+             << maxIterations << "pivots" << pivots;
+
+    const qreal epsilon = 0.0001;
+    const qreal L0 = canvasMinDimension() - 100;
+
+    vector<int> layoutVertices, offsets, targets;
+    layoutForceDirected_graph(layoutVertices, offsets, targets, true);
+
+    const int n = (int) layoutVertices.size();
+    if ( n < 2 ) {
+        return;
+    }
+
+    const bool allPairs = ( pivots <= 0 || pivots >= n );
+
+    // The pairs of each particle i are termsOffsets[i] .. termsOffsets[i+1]-1,
+    // with the other particle, the target distance and the weight.
+    // With all pairs, the distances come straight from DM instead.
+    vector<int> termsOffsets, termsOther;
+    vector<qreal> termsDistance, termsWeight;
+    qreal D = 0;
+
+    if ( allPairs ) {
+        graphMatrixDistanceGeodesicCreate(considerWeights, inverseWeights, false);
+        if ( graphCancelled() ) {
+            return;
+        }
+        D = graphDiameter(considerWeights, inverseWeights);
+        if ( DM.rows() != n ) {
+            qDebug() << "Graph::layoutForceDirectedStressMajorization() - "
+                        "distance matrix size mismatch. RETURN";
+            return;
+        }
+    }
+    else {
+        const GraphCSR &csr = graphCSR();
+
+        // Choose the pivots far apart: each one is the particle farthest
+        // from the pivots chosen so far.
+        GraphGeodesicWorkspace ws;
+        ws.init(csr.vertices(), false);
+
+        vector<int> pivotList;
+        vector< vector<qreal> > pivotDistance;
+        vector<qreal> nearest(n, RAND_MAX);
+        vector<int> region(n, 0);
+        int next = m_random.bounded(n);
+
+        QString pMsg = tr("Computing the distances from %1 pivots.\n"
+                          "Please wait...").arg(pivots);
+        emit statusMessage( pMsg );
+        graphProgressCreate(pivots, pMsg);
+
+        for (int p = 0; p < pivots; ++p) {
+            ws.reset(false);
+            if ( considerWeights ) {
+                dijkstra( layoutVertices[next], ws, csr, false, inverseWeights );
+            }
+            else {
+                BFS( layoutVertices[next], ws, csr, false );
+            }
+            vector<qreal> row(n);
+            for (int i = 0; i < n; ++i) {
+                row[i] = ws.dist[ layoutVertices[i] ];
+                if ( row[i] != RAND_MAX && row[i] > D ) {
+                    D = row[i];
+                }
+            }
+            pivotList.push_back(next);
+            pivotDistance.push_back(row);
+
+            int farthest = 0;
+            for (int i = 0; i < n; ++i) {
+                if ( row[i] < nearest[i] ) {
+                    nearest[i] = row[i];
+                    region[i] = p;
+                }
+                if ( nearest[i] > nearest[farthest] ) {
+                    farthest = i;
+                }
+            }
+            graphProgressUpdate( p + 1 );
+            if ( nearest[farthest] == 0 || graphCancelled() ) {
+                break;   // every particle is a pivot
+            }
+            next = farthest;
+        }
+        graphProgressKill();
+
+        if ( graphCancelled() ) {
+            emit statusMessage( tr("Layout cancelled.") );
+            return;
+        }
+
+        vector<int> regionSize( pivotList.size(), 0 );
+        for (int i = 0; i < n; ++i) {
+            regionSize[ region[i] ]++;
+        }
+
+        D = qMax( (qreal) 1, D );
+
+        termsOffsets.assign(n + 1, 0);
+        for (int i = 0; i < n; ++i) {
+            // adjacent particles
+            for (int e = offsets[i]; e < offsets[i+1]; ++e) {
+                const int j = targets[e];
+                qreal d = 1;
+                if ( considerWeights ) {
+                    qreal w = csr.edgeWeight( layoutVertices[i], layoutVertices[j] );
+                    if ( w == 0 ) {
+                        w = csr.edgeWeight( layoutVertices[j], layoutVertices[i] );
+                    }
+                    d = inverseWeights ? 1.0 / qAbs(w) : qAbs(w);
+                }
+                termsOther.push_back(j);
+                termsDistance.push_back(d);
+                termsWeight.push_back( 1.0 / ( d * d ) );
+            }
+            // pivots, unless adjacent
+            for (size_t p = 0; p < pivotList.size(); ++p) {
+                const int j = pivotList[p];
+                const qreal dp = pivotDistance[p][i];
+                if ( j == i || ( dp == 1 && !considerWeights ) ) {
+                    continue;
+                }
+                const qreal d = ( dp == RAND_MAX ) ? D + 1 : dp;
+                termsOther.push_back(j);
+                termsDistance.push_back(d);
+                termsWeight.push_back( regionSize[p] / ( d * d ) );
+            }
+            termsOffsets[i+1] = (int) termsOther.size();
+        }
+    }
+
+    const qreal L = L0 / qMax( (qreal) 1, D );
+    qDebug() << "Graph::layoutForceDirectedStressMajorization() - L ="
+             << L0 << "/" << D << "=" << L;
+
+    QVector<QPointF> startPositions;
+    layoutPositionsSave(startPositions);
+
+    if (initialPositions == "circle") {
+        layoutCircular(canvasWidth/2.0, canvasHeight/2.0, L0/2, false);
+    }
+    else if (initialPositions == "random") {
+        layoutRandom();
+    }
+
+    vector<qreal> x(n), y(n), nextX(n), nextY(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = m_graph[ layoutVertices[i] ]->x();
+        y[i] = m_graph[ layoutVertices[i] ]->y();
+    }
+
+    QString pMsg = tr("Embedding Kamada & Kawai spring model by stress majorization.\n"
+                      "Please wait...");
+    emit statusMessage( pMsg );
+    graphProgressCreate(maxIterations, pMsg);
+
+    const int blockSize = 256;
+    const int blocks = ( n + blockSize - 1 ) / blockSize;
+    const int threads = graphWorkerThreads(blocks);
+    vector<qreal> blockStress(blocks, 0);
+    qreal stress = 0, previousStress = 0;
+
+    for (int iteration = 1; iteration <= maxIterations; ++iteration) {
+
+        graphParallelFor( blocks, threads, [&](const int &, const int &b) {
+            const int last = qMin( n, ( b + 1 ) * blockSize );
+            qreal sum = 0;
+            for (int i = b * blockSize; i < last; ++i) {
+                qreal sumX = 0, sumY = 0, sumW = 0;
+                const int count = allPairs ? n : termsOffsets[i+1] - termsOffsets[i];
+                for (int t = 0; t < count; ++t) {
+                    int j = 0;
+                    qreal d = 0, w = 0;
+                    if ( allPairs ) {
+                        j = t;
+                        if ( j == i ) {
+                            continue;
+                        }
+                        d = qMin( DM.item(i, j), DM.item(j, i) );
+                        if ( d <= 0 || d >= RAND_MAX ) {
+                            d = D + 1;
+                        }
+                        w = 1.0 / ( d * d );
+                    }
+                    else {
+                        j = termsOther[ termsOffsets[i] + t ];
+                        d = termsDistance[ termsOffsets[i] + t ];
+                        w = termsWeight[ termsOffsets[i] + t ];
+                    }
+                    const qreal l = L * d;
+                    const qreal dx = x[i] - x[j], dy = y[i] - y[j];
+                    const qreal dist = qSqrt( dx * dx + dy * dy );
+                    if ( dist > 0 ) {
+                        sumX += w * ( x[j] + l * dx / dist );
+                        sumY += w * ( y[j] + l * dy / dist );
+                    }
+                    else {
+                        // coincident particles: split them along x
+                        sumX += w * ( x[j] + ( i < j ? -l : l ) );
+                        sumY += w * y[j];
+                    }
+                    sumW += w;
+                    sum += w * ( dist - l ) * ( dist - l );
+                }
+                nextX[i] = ( sumW > 0 ) ? sumX / sumW : x[i];
+                nextY[i] = ( sumW > 0 ) ? sumY / sumW : y[i];
+            }
+            blockStress[b] = sum;
+        }, false );
+
+        x.swap(nextX);
+        y.swap(nextY);
+
+        stress = 0;
+        for (int b = 0; b < blocks; ++b) {
+            stress += blockStress[b];
+        }
+
+        graphProgressUpdate( iteration );
+
+        if ( graphCancelled() ) {
+            graphProgressKill();
+            layoutPositionsRestore(startPositions);
+            return;
+        }
+
+        qDebug() << "Graph::layoutForceDirectedStressMajorization() - iteration"
+                 << iteration << "stress" << stress;
+
+        if ( iteration > 1 && previousStress - stress < epsilon * previousStress ) {
+            break;
+        }
+        previousStress = stress;
+    }
+
+    // Center the layout on the canvas, keeping the particles in its usable area
+    qreal minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+    for (int i = 1; i < n; ++i) {
+        minX = qMin( minX, x[i] );
+        maxX = qMax( maxX, x[i] );
+        minY = qMin( minY, y[i] );
+        maxY = qMax( maxY, y[i] );
+    }
+    const qreal shiftX = canvasWidth / 2.0 - ( minX + maxX ) / 2.0;
+    const qreal shiftY = canvasHeight / 2.0 - ( minY + maxY ) / 2.0;
+
+    for (int i = 0; i < n; ++i) {
+        x[i] = canvasVisibleX( x[i] + shiftX );
+        y[i] = canvasVisibleY( y[i] + shiftY );
+        m_graph[ layoutVertices[i] ]->setX( x[i] );
+        m_graph[ layoutVertices[i] ]->setY( y[i] );
+    }
+    layoutPositionsEmit( layoutVertices, x, y );
+
+    graphProgressKill();
+
+    graphSetModified(GraphChange::ChangedPositions);
+}
+
+
+
+
 
 
 /**
@@ -22543,7 +27710,7 @@ qreal Graph::layoutForceDirected_FR_temperature(const int iteration) const{
 
     qreal temperature=5.8309518948453; //limits the displacement of the vertex
 
-    qDebug() << "Graph::layoutForceDirected_FR_temperature(): cool iteration " << iteration;
+    qCHotDebug(lcGraph) << "Graph::layoutForceDirected_FR_temperature(): cool iteration " << iteration;
     // For the temperature (which limits the displacement of each vertex),
     // Fruchterman & Reingold suggested in their paper that it might start
     // at an initial high value (i.e. "one tenth the width of the frame"
@@ -22564,7 +27731,7 @@ qreal Graph::layoutForceDirected_FR_temperature(const int iteration) const{
         temp = temperature;
     }
 
-    qDebug() << "Graph::layoutForceDirected_FR_temperature() - iteration " << iteration
+    qCHotDebug(lcGraph) << "Graph::layoutForceDirected_FR_temperature() - iteration " << iteration
              << " temp " << temp;
     return temp;
 
@@ -22588,54 +27755,205 @@ qreal Graph::computeOptimalDistance(const int &V){
 
 
 
-qreal Graph::layoutForceDirected_F_att( const QString model, const qreal &dist,
-                                        const qreal &optimalDistance) {
-    qreal f_att;
-    if (model == "Eades") {
-        qreal c_spring=2;
-        f_att = c_spring * log10 ( dist / optimalDistance );
+/**
+ * @brief Computes the layout graph of the force-directed models: the enabled
+ * vertices, by vpos, and the arcs of the current relation between them, as
+ * offsets and targets into the list of vertices. Loops and zero-weight arcs are dropped.
+ * @param vertices
+ * @param offsets
+ * @param targets
+ * @param symmetric if true, every arc is also added in the opposite direction,
+ * and each adjacent pair appears once per row
+ */
+void Graph::layoutForceDirected_graph(vector<int> &vertices,
+                                      vector<int> &offsets,
+                                      vector<int> &targets,
+                                      const bool &symmetric) {
+
+    const GraphCSR &csr = graphCSR();
+    const int N = csr.vertices();
+
+    vector<int> index(N, -1);
+    vertices.clear();
+    for (int s = 0; s < N; ++s) {
+        if ( csr.isEnabled(s) ) {
+            index[s] = (int) vertices.size();
+            vertices.push_back(s);
+        }
+    }
+
+    const int n = (int) vertices.size();
+    vector< vector<int> > rows(n);
+    for (int k = 0; k < n; ++k) {
+        const int s = vertices[k];
+        for (int e = csr.outBegin(s); e < csr.outEnd(s); ++e) {
+            const int t = index[ csr.outTarget(e) ];
+            if ( t < 0 || t == k || csr.outWeight(e) == 0 ) {
+                continue;
+            }
+            rows[k].push_back(t);
+            if ( symmetric ) {
+                rows[t].push_back(k);
+            }
+        }
     }
-    else {   // model -> FR
-        f_att= ( dist * dist ) / optimalDistance;
+
+    offsets.assign(n + 1, 0);
+    targets.clear();
+    for (int k = 0; k < n; ++k) {
+        if ( symmetric ) {
+            std::sort( rows[k].begin(), rows[k].end() );
+            rows[k].erase( std::unique( rows[k].begin(), rows[k].end() ), rows[k].end() );
+        }
+        targets.insert( targets.end(), rows[k].begin(), rows[k].end() );
+        offsets[k+1] = (int) targets.size();
     }
+}
+
+
 
-    return f_att;
+/**
+ * @brief Sets up the layout engine for the Eades or the Fruchterman-Reingold
+ * model, on points 0..n-1 joined by the arcs offsets/targets, which come from
+ * layoutForceDirected_graph(). The points are kept inside the usable area of
+ * the canvas, and their repulsion uses m_layoutForceDirectedTheta.
+ * The positions of the engine are left to the caller.
+ * @param engine
+ * @param model "Eades" or "FR"
+ * @param optimalDistance
+ * @param offsets
+ * @param targets
+ */
+void Graph::layoutForceDirected_engine(GraphLayoutEngine &engine,
+                                       const QString model,
+                                       const qreal &optimalDistance,
+                                       const vector<int> &offsets,
+                                       const vector<int> &targets) {
+    engine.setModel( ( model == "Eades" ) ? GraphLayoutEngine::Eades
+                                          : GraphLayoutEngine::FruchtermanReingold,
+                     optimalDistance,
+                     m_layoutForceDirectedTheta );
+    engine.setBounds( 50.0, canvasWidth - 50.0, 50.0, canvasHeight - 50.0 );
+    engine.setArcs( offsets, targets );
+    m_layoutFrameTimer.invalidate();
 }
 
 
-qreal Graph::layoutForceDirected_F_rep( const QString model, const qreal &dist,
-                                        const qreal &optimalDistance) {
-    qreal f_rep;
-    if (model == "Eades") {
-        if (dist !=0){
-            qreal c_rep= 1.0;
-            f_rep =  c_rep / (dist * dist);
-            if ( dist > (2.0 * optimalDistance)   ) {
-                //neglect vertices outside circular area of radius 2 * optimalDistance
-                f_rep=0;
-            }
-        }
-        else {
-            f_rep = optimalDistance ; //move away
-        }
 
+/**
+ * @brief Copies the positions of the given vertices into the layout engine.
+ * @param engine
+ * @param vertices
+ */
+void Graph::layoutForceDirected_positions(GraphLayoutEngine &engine,
+                                          const vector<int> &vertices) const {
+    const int n = (int) vertices.size();
+    for (int k = 0; k < n; ++k) {
+        engine.x()[k] = m_graph[ vertices[k] ]->x();
+        engine.y()[k] = m_graph[ vertices[k] ]->y();
     }
-    else {  // model -> FR
-        // To speed up our algorithm we use the grid-variant algorithm.
-        if ( (2.0 * optimalDistance) < dist ) {
-            //neglect vertices outside circular area of radius 2*optimalDistance
-            f_rep=0;
-        }
-        else {
-            // repelsive forces are computed only for vertices within a circular area
-            // of radius 2*optimalDistance
-            f_rep = (optimalDistance * optimalDistance  /  dist) ;
-        }
+}
+
+
+
+/**
+ * @brief Writes the positions of the layout engine back to the given vertices
+ * and moves their nodes on the canvas.
+ * @param engine
+ * @param vertices
+ */
+void Graph::layoutForceDirected_apply(const GraphLayoutEngine &engine,
+                                      const vector<int> &vertices) {
+    const int n = (int) vertices.size();
+    for (int k = 0; k < n; ++k) {
+        GraphVertex *v = m_graph[ vertices[k] ];
+        v->setX( engine.x()[k] );
+        v->setY( engine.y()[k] );
+    }
+    layoutPositionsEmit( vertices, engine.x(), engine.y() );
+}
+
+
+
+/**
+ * @brief Returns true if an iterative layout on the given number of vertices
+ * should send a frame now, that is if animation is on, the graph is not
+ * larger than m_layoutAnimateMaxVertices and 1/m_layoutFrameRate seconds have
+ * passed since the last frame. The first call of a layout only starts the clock.
+ * @param vertices
+ * @return bool
+ */
+bool Graph::layoutFrameDue(const int &vertices) {
+    if ( m_layoutFrameRate <= 0 ||
+         ( m_layoutAnimateMaxVertices > 0 && vertices > m_layoutAnimateMaxVertices ) ) {
+        return false;
+    }
+    if ( ! m_layoutFrameTimer.isValid() ||
+         m_layoutFrameTimer.elapsed() >= 1000 / m_layoutFrameRate ) {
+        const bool first = ! m_layoutFrameTimer.isValid();
+        m_layoutFrameTimer.start();
+        return ! first;
+    }
+    return false;
+}
+
+
+
+/**
+ * @brief Sends the positions x, y of the given vertices (by vpos) to
+ * GraphicsWidget in one batch, with signalNodePositions().
+ * The vertices themselves are not changed.
+ * @param vertices
+ * @param x
+ * @param y
+ */
+void Graph::layoutPositionsEmit(const vector<int> &vertices,
+                                const vector<qreal> &x,
+                                const vector<qreal> &y) {
+    const int n = (int) vertices.size();
+    QVector<int> nodes(n);
+    QVector<QPointF> positions(n);
+    for (int k = 0; k < n; ++k) {
+        nodes[k] = m_graph[ vertices[k] ]->name();
+        positions[k] = QPointF( x[k], y[k] );
+    }
+    emit signalNodePositions( nodes, positions );
+}
+
+
+
+/**
+ * @brief Saves the positions of all vertices, so that a cancelled layout can
+ * put them back with layoutPositionsRestore().
+ * @param positions
+ */
+void Graph::layoutPositionsSave(QVector<QPointF> &positions) const {
+    positions.resize( m_graph.size() );
+    for (int i = 0; i < m_graph.size(); ++i) {
+        positions[i] = m_graph[i]->pos();
     }
+}
+
 
-    return -f_rep;
+
+/**
+ * @brief Moves all vertices, and their nodes on the canvas, back to the
+ * positions saved by layoutPositionsSave(), discarding a cancelled layout.
+ * @param positions
+ */
+void Graph::layoutPositionsRestore(const QVector<QPointF> &positions) {
+    QVector<int> nodes( positions.size() );
+    for (int i = 0; i < positions.size(); ++i) {
+        m_graph[i]->setX( positions[i].x() );
+        m_graph[i]->setY( positions[i].y() );
+        nodes[i] = m_graph[i]->name();
+    }
+    emit signalNodePositions( nodes, positions );
+    emit statusMessage( tr("Layout cancelled.") );
 }
 
+
+
 /**
  * @brief Graph::sign
  * returns the sign of number D as integer (1 or -1)
@@ -22717,90 +28035,6 @@ qreal Graph::graphDistanceEuclidean (const QPointF & a){
 
 
 
-void Graph::layoutForceDirected_Eades_moveNodes(const qreal &c4) {
-    qDebug() << "\n *****  layoutForceDirected_Eades_moveNodes() " ;
-    QPointF newPos;
-    qreal xvel = 0, yvel = 0;
-    VList::const_iterator v1;
-
-    for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1)
-    {
-        // calculate new overall velocity vector
-        xvel =  c4 * (*v1)->disp().rx();
-        yvel =  c4 * (*v1)->disp().ry();
-        qDebug() << " ##### source vertex  " <<  (*v1)->name()
-                 << " xvel,yvel = ("<< xvel << ", "<< yvel << ")";
-
-        //fix Qt error a positive QPoint to the floor
-        // when we ask for setNodePos to happen.
-        if ( xvel < 1 && xvel > 0 )
-            xvel = 1 ;
-        if ( yvel < 1 && yvel > 0 )
-            yvel = 1 ;
-
-        //Move source node to new position according to overall velocity
-        newPos = QPointF( (qreal) (*v1)->x() + xvel, (qreal) (*v1)->y() + yvel);
-
-        qDebug() << " source vertex v1 " << (*v1)->name()
-                 << " current pos: (" <<  (*v1)->x()
-                 << " , " << (*v1)->y()
-                 << " Possible new pos (" <<  newPos.x()
-                 << " , " <<  newPos.y();
-
-        // check if new pos is out of usable screen and adjust
-        newPos.rx() = canvasVisibleX(newPos.x());
-        newPos.ry() = canvasVisibleY(newPos.y());
-
-        qDebug() << "  Final new pos (" <<  newPos.x() << ","
-                 << newPos.y()<< ")";
-        (*v1)->setX(  newPos.x() );
-        (*v1)->setY(  newPos.y() );
-        emit setNodePos((*v1)->name(),  newPos.x(),  newPos.y());
-        //vertexPosSet();
-
-    }
-
-}
-
-/**
- * @brief Graph::layoutForceDirected_FR_moveNodes
- * @param temperature
- */
-void Graph::layoutForceDirected_FR_moveNodes(const qreal &temperature) {
-
-    qDebug() << "\n\n *****  layoutForceDirected_FR_moveNodes() \n\n " ;
-    qDebug () << " temperature " << temperature;
-    QPointF newPos;
-    qreal xvel = 0, yvel = 0;
-    VList::const_iterator v1;
-
-    for (v1=m_graph.cbegin(); v1!=m_graph.cend(); ++v1)
-    {
-        // compute the new position
-        // limit the maximum displacement to a maximum temperature
-        xvel = sign((*v1)->disp().rx()) * qMin( qAbs((*v1)->disp().rx()), temperature) ;
-        yvel = sign((*v1)->disp().ry()) * qMin( qAbs((*v1)->disp().ry()), temperature) ;
-        newPos = QPointF((*v1)->x()+ xvel, (*v1)->y()+yvel);
-        qDebug()<< " source vertex v1 " << (*v1)->name()
-                << " current pos: (" << (*v1)->x() << "," << (*v1)->y() << ")"
-                << "Possible new pos (" <<  newPos.x() << ","
-                << newPos.y()<< ")";
-
-        newPos.rx() = canvasVisibleX (newPos.x());
-        newPos.ry() = canvasVisibleY (newPos.y());
-
-        //Move node to new position
-        qDebug()<< " final new pos "
-                <<  newPos.x() << ","
-                << newPos.y()<< ")";
-        (*v1)->setX(  newPos.x() );
-        (*v1)->setY(  newPos.y() );
-        emit setNodePos((*v1)->name(),  newPos.x(),  newPos.y());
-    }
-}
-
-
-
 /**
  * @brief Helper method, return the human readable name of matrix type.
  * @param matrix
@@ -39,6 +39,9 @@
 #include <QMultiMap>
 #include <QTextStream>
 #include <QThread>
+#include <QFuture>
+#include <QAtomicInt>
+#include <QElapsedTimer>
 
 
 #include <QtCharts/QChartGlobal>
@@ -46,19 +49,39 @@
 
 //FYI: stack is a wrapper around <deque> in C++, see: www.cplusplus.com/reference/stl/stack
 #include <stack>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <random>
 #include <map>
 
 #include "global.h"
 #include "graphvertex.h"
+#include "graphcsr.h"
+#include "graphdistanceheap.h"
+#include "graphrandom.h"
+#include "graphlayoutengine.h"
+#include "graphcomponents.h"
+#include "graphdistribution.h"
+#include "graphscoreindex.h"
+#include "graphlabelindex.h"
+#include "graphneighborhood.h"
+#include "graphweightindex.h"
+#include "graphresultcache.h"
+#include "graphresultstore.h"
+#include "graphprogress.h"
 #include "matrix.h"
+#include "sparsematrix.h"
 #include "parser.h"
 #include "webcrawler.h"
+#include "webcrawlerfrontier.h"
 #include "graphicswidget.h"
 
 QT_BEGIN_NAMESPACE
 class QPointF;
 class QNetworkAccessManager;
 class QNetworkReply;
+class GraphFileWriter;
 QT_END_NAMESPACE
 
 
@@ -90,8 +113,7 @@ typedef QHash <QString, int> H_StrToInt;
 typedef QHash <int, int> H_Int;
 typedef QHash <qreal, int> H_f_i;
 typedef QPair <qreal, bool> pair_f_b;
-typedef QPair <int, pair_f_b > pair_i_fb;
-typedef QMultiHash <int, pair_i_fb > H_edges;
+typedef QMultiHash <int, pair_f_b > H_edges;
 typedef QHash<QString, bool> H_StrToBool;
 typedef QList<int> L_int;
 typedef QVector<int> V_int;
@@ -99,6 +121,48 @@ typedef QVector<QString> V_str;
 
 
 
+/**
+ * @brief Per-thread scratch space of the SSSP kernels BFS() and dijkstra().
+ * Every worker used by graphDistancesGeodesic() owns one workspace, thus
+ * the queue, stack, sigma, delta and predecessor buffers are never shared.
+ * Vertices are addressed by their dense index (vpos).
+ * The BC/SC and influence domain accumulators and the global sums are reduced by the caller
+ * after all workers have finished.
+ */
+struct GraphGeodesicWorkspace {
+    void init(const int &N, const bool &computeCentralities);
+    void reset(const bool &computeCentralities);
+
+    vector<qreal> dist;
+    vector<qreal> sigma;
+    vector<qreal> delta;
+    vector< vector<int> > Ps;
+    vector<int> Stack;
+    vector<int> Q;
+
+    // The priority queue of dijkstra()
+    GraphDistanceHeap heap;
+
+    // Stores the number of vertices at distance n from the current source
+    H_f_i sizeOfNthOrderNeighborhood;
+
+    // The maximum distance from the current source
+    qreal eccentricity;
+
+    // Accumulators, reduced over all workspaces at the end
+    vector<qreal> BC;
+    vector<qreal> SC;
+    vector<qreal> domainSize;
+    vector<qreal> domainSum;
+    qreal sumDistance;
+    qreal geodesicsCount;
+    qreal sumPC;
+    qreal sumSPC;
+    int diameter;
+};
+
+
+
 
 
 /**
@@ -138,6 +202,7 @@ typedef QVector<QString> V_str;
  */
 class Graph:  public QObject{
     Q_OBJECT
+    friend class GraphEdgeRowsMatrix;
     QThread file_parserThread;
     QThread webcrawlerThread;
 
@@ -176,6 +241,8 @@ public slots:
 
     void graphLoadedTerminateParserThreads (QString reason);
 
+    void graphCancel();
+
     void graphSelectionChanged(const QList<int> selectedVertices,
                                const QList<SelectedEdge> selectedEdges);
 
@@ -189,6 +256,13 @@ public slots:
                       const QString &label=QString(),
                       const bool &signalMW=true);
 
+    void edgeCreateList (const QVector<int> &sources, const QVector<int> &targets,
+                         const QVector<qreal> &weights,
+                         const QString &color,
+                         const int &type=0,
+                         const bool &drawArrows=true, const bool &bezier=false,
+                         const bool &uniqueEdges=true);
+
     void edgeCreateWebCrawler (const int &source, const int &target);
 
     void edgeVisibilitySet(int relation, int, int, bool);
@@ -223,8 +297,12 @@ public slots:
 
     double canvasRandomX()  const;
 
+    double canvasRandomX(GraphRandom &rng) const;
+
     double canvasRandomY()  const;
 
+    double canvasRandomY(GraphRandom &rng) const;
+
 
     void vertexIsolatedAllToggle ( const bool &toggle);
 
@@ -253,21 +331,39 @@ public slots:
             const bool &extLinksIncluded,
             const bool &extLinksCrawl,
             const bool &socialLinks,
-            const bool &delayedRequests);
+            const bool &delayedRequests,
+            const bool &checkpoints,
+            const bool &resume);
+
+    void webCrawlCheckpointWrite(const QByteArray &crawlerState);
 
-    void slotHandleCrawlerRequestReply();
+    void slotHandleCrawlerRequestReply(const QUrl &url,
+                                       const QString &locationHeader,
+                                       const QByteArray &data);
+    void webCrawlData(const QUrl &url, const QByteArray &data);
+    void webCrawlEnqueue(const QUrl &url, const int &priority = 0);
     void webSpider();
 
+    /** Slot to the background analysis job, see centralityBetweennessBackground() */
+    void backgroundAnalysisApply();
+
     QString htmlEscaped (QString str) const;
 
 
 signals:
 
-    void signalWebCrawlParse(QNetworkReply *reply);
+    void signalWebCrawlData(const QUrl &url, const QByteArray &data);
+    void signalWebCrawlCheckpoint();
+    void signalWebCrawlParse(const QUrl &url,
+                             const QString &locationHeader,
+                             const QByteArray &page);
+
+    void signalBackgroundAnalysisDone();
 
     /** Signals to MainWindow */
 
     void signalNetworkManagerRequest(const QUrl &currentUrl, const NetworkRequestType &type);
+    void signalNetworkManagerAbort(const QUrl &currentUrl);
 
     void signalProgressBoxCreate(const int max=0, const QString msg="Please wait");
 
@@ -275,6 +371,10 @@ signals:
 
     void signalProgressBoxUpdate(const int &count=0 );
 
+    void signalProgressBoxRate(const qreal &throughput, const qint64 &eta);
+
+    void signalBackgroundAnalysisFinished(const int &index, const bool &current);
+
     void signalGraphSavedStatus(const int &status);
 
     void signalGraphModified(const bool &undirected,
@@ -366,10 +466,21 @@ signals:
 
     void setEdgeVisibility (int, int, int, bool);
 
+    void setEdgesVisibility (const int &relation,
+                             const QVector<int> &sources,
+                             const QVector<int> &targets,
+                             const bool &visible);
+
     void setVertexVisibility(int, bool);
 
     void setNodePos(const int &, const qreal &, const qreal &);
 
+    void signalNodePositions(const QVector<int> &nodes, const QVector<QPointF> &positions);
+
+    void signalSceneBuildBegin(const int &items);
+
+    void signalSceneBuildEnd();
+
     void signalNodesFound(const QList<int> foundList);
 
     void setNodeSize(const int &v, const int &size);
@@ -451,7 +562,7 @@ public:
                     const int two_sm_mode,
                     const QString delimiter=QString());
 
-    void graphSave(const QString &fileName,
+    bool graphSave(const QString &fileName,
                    const int &fileType,
                    const bool &saveEdgeWeights=true);
 
@@ -460,7 +571,8 @@ public:
                                  int maxWidth=0, int maxHeight=0);
 
     bool graphSaveToAdjacencyFormat (const QString &fileName,
-                                     const bool &saveEdgeWeights=true);
+                                     const bool &saveEdgeWeights=true,
+                                     const bool &sparse=false);
 
     bool graphSaveToGraphMLFormat (const QString &fileName,
                                    QString networkName="",
@@ -468,6 +580,10 @@ public:
 
     bool graphSaveToDotFormat (QString fileName);
 
+    bool graphSaveToBinaryFormat (const QString &fileName);
+
+    bool graphLoadFromBinaryFormat (const QString &fileName);
+
     int graphFileFormat() const;
 
     bool graphFileFormatExportSupported(const int &fileFormat) const;
@@ -504,6 +620,13 @@ public:
 
     QList<int> vertexNeighborhoodList(const int &v1);
 
+    QList<int> vertexNeighborhoodHops(const int &v1, const int &hops,
+                                      const int &direction = GraphNeighborhood::Both);
+
+    int vertexNeighborhoodDistance(const int &v1, const int &v2, const int &hops);
+
+    void vertexEgoNetworkSelect(const int &v1, const int &hops);
+
     // Only in Qt 5.15
 //    QSet<int> vertexNeighborhoodSet(const int &v1);
 
@@ -522,6 +645,8 @@ public:
 
     void vertexRemove (const int &v1);
 
+    void vertexRemoveList (const QList<int> &vertexList);
+
     void vertexSizeInit (const int);
 
     void vertexSizeSet(const int &v, const int &newsize);
@@ -609,6 +734,8 @@ public:
                                 const int &type = SUBGRAPH_CLIQUE,
                                 const int &center = 0);
 
+    void verticesCreateSubgraphInduced(const QList<int> &vList);
+
 
 
 
@@ -666,8 +793,22 @@ public:
 
     void graphSetModified(const int &graphNewStatus, const bool&signalMW=true);
 
+    void graphBulkBegin(const int &vertices=0,
+                        const int &edges=0,
+                        const bool &uniqueEdges=false);
+
+    void graphBulkCommit(const int &graphNewStatus=GraphChange::ChangedVerticesEdges,
+                         const bool &signalMW=true);
+
+    bool graphBulkBuilding() const { return m_graphBulkDepth > 0; }
+
     bool graphIsModified() const ;
 
+    bool graphCancelled() const { return m_cancelRequested.loadAcquire() != 0; }
+
+    /** Number of computations reporting progress, 0 when none is running */
+    int graphProgressDepth() const { return m_progress.depth(); }
+
     bool graphSaved() const;
 
     bool graphLoaded() const;
@@ -717,7 +858,21 @@ public:
     void graphMatrixAdjacencyCreate(const bool dropIsolates=false,
                                     const bool considerWeights=true,
                                     const bool inverseWeights=false,
-                                    const bool symmetrize=false );
+                                    const bool symmetrize=false,
+                                    const bool sparseAllowed=false );
+
+    void graphMatrixAdjacencySparseCreate(const bool &dropIsolates=false,
+                                          const bool &considerWeights=true,
+                                          const bool &inverseWeights=false,
+                                          const bool &symmetrize=false );
+
+    void setGraphMatrixAdjacencySparseDensity(const qreal &density);
+
+    void setLayoutForceDirectedTheta(const qreal &theta);
+
+    void setLayoutFrameRate(const int &fps);
+
+    void setLayoutAnimateMaxVertices(const int &maxVertices);
 
     bool graphMatrixAdjacencyInvert(const QString &method="lu");
 
@@ -743,14 +898,16 @@ public:
 
     /* REPORT EXPORTS */
     void setReportsDataDir(const QString &reportsDir);
+    void setReportsResultStore(const bool &toggle);
     void setReportsRealNumberPrecision (const int & precision);
     void setReportsLabelLength(const int &length);
     void setReportsChartType(const int &type);
 
     void writeDataSetToFile(const QString dir, const QString );
 
-    void writeMatrixAdjacencyTo(QTextStream& os,
-                                const bool &saveEdgeWeights=true);
+    void writeMatrixAdjacencyTo(GraphFileWriter& os,
+                                const bool &saveEdgeWeights=true,
+                                const bool &sparse=false);
 
     void writeReciprocity( const QString fileName,
                            const bool considerWeights=false);
@@ -763,7 +920,8 @@ public:
                      const QString &varLocation="Rows",
                      const bool &simpler=false);
 
-    void writeMatrixHTMLTable(QTextStream &outText, Matrix &M,
+    template <class M>
+    void writeMatrixHTMLTable(QTextStream &outText, const M &matrix,
                               const bool &markDiag=true,
                               const bool &plain=false,
                               const bool &printInfinity=true,
@@ -830,6 +988,9 @@ public:
 
  //   friend QTextStream& operator <<  (QTextStream& os, Graph& m);
 
+    bool writeVertexIndicesTable(const QString &fileName,
+                                 const bool &parallel=true);
+
     void writeCentralityDegree(const QString,
                                const bool weights,
                                const bool dropIsolates);
@@ -909,14 +1070,48 @@ public:
 
     /* DISTANCES, CENTRALITIES & PROMINENCE MEASURES */
 
+    const GraphCSR &graphCSR();
+
+    const GraphCSR &graphCSRUnion(const GraphCSR::Reduction &reduction=GraphCSR::ReduceSum);
+
+    std::shared_ptr<const GraphCSR> graphSnapshot();
+
+    const GraphComponents &graphComponents(const bool &strong=true);
+
+    const GraphWeightIndex &graphWeightIndex();
+
+    const GraphScoreIndex &prominenceScoreIndex(const int &index);
+
+    void setCentralityBetweennessSamples(const int &samples);
+    int centralityBetweennessSamples() const { return m_centralityBetweennessSamples; }
+    bool centralityBetweennessApproximate(const bool &considerWeights,
+                                          const bool &inverseWeights,
+                                          const bool &dropIsolates);
+    bool centralityBetweennessBackground(const bool &considerWeights,
+                                         const bool &inverseWeights,
+                                         const bool &dropIsolates);
+    bool backgroundAnalysisRunning() const { return m_backgroundJob.isRunning(); }
+
+    void setDistancesStorageCompact(const bool &toggle);
+    bool distancesStorageCompact() const { return m_distancesCompact; }
+    void setDistancesIncremental(const bool &toggle, const bool &centralities=false);
+    bool distancesIncremental() const { return m_distancesIncremental; }
+    bool distancesStoreActive() const { return m_distancesStoreSize > 0; }
+    qreal distancesStoreDistance(const int &v1, const int &v2) const;
+    int distancesStoreShortestPaths(const int &v1, const int &v2) const;
+
     int graphConnectednessFull (const bool updateProgress=false) ;
 
     bool graphReachable(const int &v1, const int &v2) ;
 
+    void graphReachabilityClosure();
+
     void graphMatrixReachabilityCreate() ;
 
     int graphDiameter(const bool considerWeights, const bool inverseWeights);
 
+    void graphEccentricitiesBounded();
+
     int graphDistanceGeodesic(const int &v1,
                               const int &v2,
                               const bool &considerWeights=false,
@@ -926,7 +1121,7 @@ public:
                                        const bool inverseWeights,
                                        const bool dropIsolates);
 
-    void graphDistancesGeodesic(const bool &computeCentralities=false,
+    void graphDistancesGeodesic(const bool &centralities=false,
                                 const bool &considerWeights=false,
                                 const bool &inverseWeights=true,
                                 const bool &dropIsolates=false);
@@ -945,15 +1140,24 @@ public:
                                 const ChartType &type,
                                 const QString &distImageFileName=QString());
 
-    void prominenceDistributionBars(const H_StrToInt &discreteClasses,
+    void prominenceDistributionRange(const QVector<qreal> &values,
+                                     const QVector<int> &frequencies,
+                                     qreal &min, qreal &max,
+                                     qreal &minF, qreal &maxF) const;
+
+    QVector<QPointF> prominenceDistributionPoints(const QVector<qreal> &values,
+                                                  const QVector<int> &frequencies,
+                                                  const int &maxPoints) const;
+
+    void prominenceDistributionBars(const GraphDistribution &discreteClasses,
                                     const QString &name,
                                     const QString &distImageFileName);
 
-    void prominenceDistributionArea(const H_StrToInt &discreteClasses,
+    void prominenceDistributionArea(const GraphDistribution &discreteClasses,
                                     const QString &name,
                                     const QString &distImageFileName);
 
-    void prominenceDistributionSpline(const H_StrToInt &discreteClasses,
+    void prominenceDistributionSpline(const GraphDistribution &discreteClasses,
                                       const QString &seriesName,
                                       const QString &distImageFileName);
 
@@ -967,6 +1171,10 @@ public:
                                const bool &inverseWeights=false,
                                const bool &dropIsolates=false);
 
+    void setCentralityEigenvectorTolerance(const qreal &tolerance);
+    void setCentralityEigenvectorMaxIterations(const int &iterations);
+    void setCentralityEigenvectorLanczos(const bool &toggle);
+
     void centralityClosenessIR(const bool considerWeights=false,
                                const bool inverseWeights=false,
                                const bool dropIsolates=false);
@@ -975,6 +1183,9 @@ public:
 
     void prestigePageRank(const bool &dropIsolates=false);
 
+    void setPrestigePageRankGaussSeidel(const bool &toggle);
+    bool prestigePageRankGaussSeidel() const { return m_prestigePageRankGaussSeidel; }
+
     void prestigeProximity(const bool considerWeights=false,
                            const bool inverseWeights=false,
                            const bool dropIsolates=false);
@@ -988,6 +1199,24 @@ public:
                                 const int &length=0,
                                 const bool &updateProgress=false);
 
+    void graphWalksRow(const int &row,
+                       const int &length,
+                       QVector<qreal> &walks,
+                       const bool &cumulative=false) const;
+
+    void graphWalksColumn(const int &column,
+                          const int &length,
+                          QVector<qreal> &walks,
+                          const bool &cumulative=false) const;
+
+    void graphWalksRowsStream(const int &length,
+                              const bool &cumulative,
+                              const std::function<void (const int &, const QVector<qreal> &)> &consumer);
+
+    void writeWalksMatrixStream(QTextStream &outText,
+                                const int &length,
+                                const bool &htmlTable);
+
     void writeWalksTotalMatrixPlainText(const QString &fn);
 
     void writeWalksOfLengthMatrixPlainText(const QString &fn, const int &length);
@@ -1007,7 +1236,7 @@ public:
     qreal numberOfTriples(int v1);
 
     /* CLIQUES, CLUSTERING, TRIADS */
-    void graphCliques(QSet<int> R=QSet<int>(), QSet<int> P=QSet<int>(), QSet<int> X=QSet<int>() );
+    void graphCliques();
 
     void graphCliqueAdd (const QList<int> &clique);
 
@@ -1031,7 +1260,6 @@ public:
 
     bool graphTriadCensus();
 
-    void triadType_examine_MAN_label(int, int, int, GraphVertex*,  GraphVertex*, GraphVertex* );
     //	void eccentr_JordanCenter();    // TODO
 
 
@@ -1064,29 +1292,57 @@ public:
 
     void layoutForceDirectedFruchtermanReingold(const int maxIterations);
 
+    void layoutForceDirectedMultilevel(const QString model,
+                                       const int maxIterations);
+
     void layoutForceDirectedKamadaKawai(const int maxIterations=500,
                                         const bool considerWeights=false,
                                         const bool inverseWeights=false,
                                         const bool dropIsolates=false,
                                         const QString &initialPositions="current");
 
+    void layoutForceDirectedStressMajorization(const int maxIterations=500,
+                                               const bool considerWeights=false,
+                                               const bool inverseWeights=false,
+                                               const QString &initialPositions="current",
+                                               const int pivots=0);
+
     qreal graphDistanceEuclidean(const QPointF &a, const QPointF &b);
 
     qreal graphDistanceEuclidean(const QPointF &a);
 
     int sign(const qreal &D);
 
-    qreal layoutForceDirected_F_rep(const QString model,
-                                    const qreal &dist,
-                                    const qreal &optimalDistance);
+    void layoutForceDirected_graph(vector<int> &vertices,
+                                   vector<int> &offsets,
+                                   vector<int> &targets,
+                                   const bool &symmetric=false);
 
-    qreal layoutForceDirected_F_att(const QString model,
-                                    const qreal &dist,
-                                    const qreal &optimalDistance) ;
+    void layoutForceDirected_engine(GraphLayoutEngine &engine,
+                                    const QString model,
+                                    const qreal &optimalDistance,
+                                    const vector<int> &offsets,
+                                    const vector<int> &targets);
 
-    void layoutForceDirected_Eades_moveNodes(const qreal &c4);
+    void layoutForceDirected_positions(GraphLayoutEngine &engine,
+                                       const vector<int> &vertices) const;
 
-    void layoutForceDirected_FR_moveNodes(const qreal &temperature) ;
+    void layoutForceDirected_apply(const GraphLayoutEngine &engine,
+                                   const vector<int> &vertices);
+
+    bool layoutFrameDue(const int &vertices);
+
+    void layoutPositionsEmit(const vector<int> &vertices,
+                             const vector<qreal> &x,
+                             const vector<qreal> &y);
+
+    void layoutPositionsSave(QVector<QPointF> &positions) const;
+
+    void layoutPositionsRestore(const QVector<QPointF> &positions);
+
+    void layoutPositionsSave(QVector<QPointF> &positions) const;
+
+    void layoutPositionsRestore(const QVector<QPointF> &positions);
 
     qreal layoutForceDirected_FR_temperature(const int iteration) const;
 
@@ -1103,12 +1359,19 @@ public:
 
     /* CRAWLER */
     void webCrawlTerminateThreads (QString reason);
+    QString webCrawlCheckpointFile(const QUrl &startUrl) const;
+    void webCrawlCheckpoint();
+    bool webCrawlCheckpointRead(const QString &fileName, QByteArray &crawlerState);
 
 
 
     /**RANDOM NETWORKS*/
     void randomizeThings();
 
+    void setRandomSeed(const quint64 &seed);
+
+    quint64 randomSeed() const { return m_randomSeed; }
+
     void randomNetErdosCreate (  const int &N,
                                  const QString &model,
                                  const int &m,
@@ -1151,9 +1414,6 @@ public:
      */
     H_Int vpos;
 
-    // Stores the number of vertices at distance n from a given vertex
-    H_f_i sizeOfNthOrderNeighborhood;
-
     /* maps have O(logN) lookup complexity */
     /* Consider using tr1::hashmap which has O(1) lookup, but this is not ISO C++ yet :(   */
 
@@ -1175,17 +1435,89 @@ private:
                   const QString &color
                   );
 
-    /** methods used by graphDistancesGeodesic()  */
-    void BFS(const int &s,
-             const int &si,
-             const bool &computeCentralities=false,
-             const bool &dropIsolates=false);
+    void graphProgressCreate(const int max=0, const QString msg="Please wait");
+    void graphProgressUpdate(const int &count);
+    void graphProgressKill();
+    void graphCancelReset();
+
+    void graphEdgeRows(vector<int> &offsets,
+                       vector<int> &targets,
+                       vector<qreal> &weights) const;
 
-    void dijkstra(const int &s,
-                  const int &si,
+    template <class M>
+    void writeMatrixHTMLTableRows(QTextStream &outText, const M &matrix,
+                                  const QVector<int> &names,
+                                  const int &firstRow, const int &lastRow,
+                                  const int &firstColumn, const int &lastColumn,
+                                  const bool &markDiag,
+                                  const bool &printInfinity);
+
+    /** methods used by graphDistancesGeodesic()  */
+    bool distancesStoreInit(const int &N);
+    void distancesStoreClear();
+    qint64 distancesStoreBytes() const;
+
+    void graphDistancesGeodesicWorkers(const GraphCSR &csr,
+                                       const QVector<int> &sources,
+                                       vector<GraphGeodesicWorkspace> &workspaces,
+                                       const bool &computeCentralities,
+                                       const bool &considerWeights,
+                                       const bool &inverseWeights,
+                                       const bool &dependenciesOnly=false,
+                                       const bool &reportProgress=true,
+                                       const QAtomicInt *abort=nullptr);
+
+    void centralityBetweennessApply(const vector<qreal> &sumsBC,
+                                    const vector<qreal> &sumsSC,
+                                    const qreal &scale,
+                                    const bool &dropIsolates);
+
+    void graphDistancesGeodesicFinish(const bool &computeCentralities,
+                                      const bool &considerWeights,
+                                      const bool &inverseWeights,
+                                      const bool &dropIsolates);
+
+    void distancesIncrementalArc(const int &source, const int &target);
+    bool distancesIncrementalRepair(const bool &centralities);
+
+    void graphDistancesGeodesicSource(const int &si,
+                                      GraphGeodesicWorkspace &ws,
+                                      const GraphCSR &csr,
+                                      const bool &computeCentralities,
+                                      const bool &considerWeights,
+                                      const bool &inverseWeights,
+                                      const bool &dependenciesOnly=false);
+
+    void BFS(const int &si,
+             GraphGeodesicWorkspace &ws,
+             const GraphCSR &csr,
+             const bool &computeCentralities=false);
+
+    void dijkstra(const int &si,
+                  GraphGeodesicWorkspace &ws,
+                  const GraphCSR &csr,
                   const bool &computeCentralities=false,
-                  const bool &inverseWeights=false,
-                  const bool &dropIsolates=false);
+                  const bool &inverseWeights=false);
+
+    void deltaStepping(const int &si,
+                       vector<qreal> &dist,
+                       const GraphCSR &csr,
+                       const bool &inverseWeights=false);
+
+    void graphWalksVector(const int &index,
+                          const int &length,
+                          QVector<qreal> &walks,
+                          const bool &cumulative,
+                          const bool &column) const;
+
+    int graphWorkerThreads(const int &items) const;
+
+    void graphParallelFor(const int &items,
+                          const int &threads,
+                          const std::function<void (const int &worker, const int &item)> &work,
+                          const bool &reportProgress=true);
+
+    void clusteringCoefficientsCompute();
 
     void minmax(qreal C,
                 GraphVertex *v,
@@ -1194,12 +1526,46 @@ private:
                 int &maxNode, int &minNode
               );
 
+    qreal prominenceScore(GraphVertex *vertex, const int &index) const;
+
+    bool resultCacheRestore(const int &index, const int &parameters);
+
+    void resultCacheStore(const int &index, const int &parameters);
+
+    void resultCacheFields(const int &index,
+                           QList<qreal*> &reals,
+                           QList<int*> &ints,
+                           GraphDistribution *&distribution);
+
+    void resultCacheVertex(GraphVertex *vertex, const int &index,
+                           qreal &raw, qreal &standard, const bool &save);
+
+    void resultCacheCapture(const int &index, GraphResultCache::Result &result);
+
+    QString resultStoreEntry(const int &index, const int &parameters) const;
+
+    void resultCacheApply(const int &index, const GraphResultCache::Result &result);
+
+    const QByteArray &graphContentHash();
+
+    void geodesicsStoreWrite(const bool &computeCentralities, const int &parameters);
+
+    bool geodesicsStoreRead(const bool &computeCentralities, const int &parameters);
+
+    bool tieCountersValid() const {
+        return m_tieCountersValid && m_tieCountersVersion == m_graphVersion;
+    }
+    void graphTieCountersCompute();
+    void graphTieCountersPair(const int &v1, const int &v2, const int &sign,
+                              const int &flipSource=-1, const int &flipTarget=-1);
+    void graphTieCountersUpdated();
+
     void resolveClasses ( qreal C,
-                          H_StrToInt &discreteClasses,
+                          GraphDistribution &discreteClasses,
                           int &classes);
 
     void resolveClasses ( qreal C,
-                           H_StrToInt &discreteClasses,
+                           GraphDistribution &discreteClasses,
                            int &classes, int name);
 
 
@@ -1209,18 +1575,31 @@ private:
 
     WebCrawler *web_crawler;                     // Our web crawler threaded class. This will parse the downloaded HTML.
 
-    QQueue<QUrl> *urlQueue;                     // A queue where the crawler will put urls for the network manager to download
+    WebCrawlerFrontier m_crawler_frontier;      // The urls the crawler found and we will download
+    QElapsedTimer m_crawler_clock;
+    qint64 m_crawler_wake_at;                    // When the spider timer will fire, or -1
+    quint64 m_crawler_run;                       // Increased on each crawl, so that stale spider timers do nothing
 
     int m_crawler_max_urls;                      // maximum urls we'll visit (max nodes in the resulted network)
-    int m_crawler_delayed_requests;              // Controls if we will wait between requests
+    int m_crawler_delayed_requests;              // Controls if we will wait between requests to the same host
     int m_crawler_visited_urls;                  // A counter of the urls visited.
+    int m_crawler_max_requests;                  // Max requests in flight
+    int m_crawler_max_host_requests;             // Max requests in flight to the same host
+    int m_crawler_max_frontier;                  // Max urls in the frontier, when there is no maxNodes limit
+
+    QUrl m_crawler_start_url;
+    bool m_crawler_checkpoints;                  // Controls if we save checkpoints while crawling
+    bool m_crawler_checkpoint_pending;           // True while the crawler writes its part of a checkpoint
+    int m_crawler_checkpoint_pages;              // Pages visited between checkpoints
+    int m_crawler_checkpoint_at;                 // The visited urls count of the next checkpoint
+    QHash<QByteArray, int> m_crawler_checkpoint_inflight;   // The urls in flight when the checkpoint began
 
 
     QList<QString> m_relationsList;
 
     QList<int> m_graphFileFormatExportSupported;
 
-    QList<int> triadTypeFreqs;                  //stores triad type frequencies
+    QList<qint64> triadTypeFreqs;                  //stores triad type frequencies
 
     QList<int> m_verticesList;
     QList<int> m_verticesIsolatedList;
@@ -1237,7 +1616,6 @@ private:
     QHash <int, int> m_vertexPairsUnilaterallyConnected;
 
     QMultiMap <int, L_int > m_cliques;
-    QHash <int, QSet<int> > neighboursHash;
 
     QList <qreal> m_clusteringLevel;
     QMap <int, V_int> m_clustersPerSequence;
@@ -1246,19 +1624,133 @@ private:
     QMap<int, V_str> m_clusterPairNamesPerSeq;
 
     Matrix  SIGMA, DM, sumM, invAM, AM, invM, WM;
-    Matrix XM, XSM, XRM, CLQM;
-
-    stack<int> Stack;
+    Matrix XM, XSM;
+    MatrixByte XRM;         // reachability flags
+    MatrixCount CLQM;       // clique co-membership counts
+
+    /** Sparse adjacency matrix, always built by graphMatrixAdjacencyCreate().
+     *  When m_graphMatrixAdjacencySparse is true, the dense AM was not built. */
+    SparseMatrix SAM;
+    bool m_graphMatrixAdjacencySparse;
+    qreal m_graphMatrixAdjacencySparseDensity;
+
+    /** Barnes-Hut opening angle of the force-directed layouts, 0 for exact repulsion */
+    qreal m_layoutForceDirectedTheta;
+    int m_layoutFrameRate;
+    int m_layoutAnimateMaxVertices;
+    QElapsedTimer m_layoutFrameTimer;
+
+    std::shared_ptr<GraphCSR> m_csr;            // CSR snapshot of the current relation, see graphCSR()
+    std::shared_ptr<GraphCSR> m_csrUnion;       // CSR snapshot of the union of all relations, see graphCSRUnion()
+    GraphProgress m_progress;                   // progress of the running computation, see graphProgressUpdate()
+    GraphComponents m_components;               // Strong/weak components, see graphComponents()
+    GraphLabelIndex m_labelIndex;               // Vertices by label, see vertexExists(label)
+    GraphNeighborhood m_neighborhood;           // Bounded k-hop queries, see vertexNeighborhoodHops()
+    GraphWeightIndex m_weightIndex;             // Edges of the current relation by weight, see graphWeightIndex()
+    quint64 m_componentsArcVersion;             // Version at which edgeAdd() last updated m_components
+    QHash<int, GraphScoreIndex> m_prominenceScoreIndex; // Sorted scores per prominence index, see prominenceScoreIndex()
+    GraphResultCache m_resultCache;     // Prominence index results per parameters, see resultCacheRestore()
+    GraphResultStore m_resultStore;     // Opt-in on-disk results, keyed by graphContentHash()
+    QByteArray m_graphContentHash;
+    quint64 m_graphContentHashVersion;
+    int m_graphContentHashRelation;
+    quint64 m_graphVersion;                     // Bumped on every structural change, invalidates m_csr
+
+    /** Compact geodesic store, used instead of the per-vertex distance and
+     *  shortest paths hashes when m_distancesCompact is true.
+     *  Row-major N x N, indexed by vpos. Unreachable pairs are +infinity. */
+    bool m_distancesCompact;
+
+    /** Number of sampled sources for approximate BC/SC. Zero means exact. */
+    int m_centralityBetweennessSamples;
+    int m_centralityBetweennessSampled;
+
+    /** If true, PageRank uses Gauss-Seidel sweeps instead of Jacobi iterations */
+    bool m_prestigePageRankGaussSeidel;
+
+    /** Eigenvector centrality solver: tolerance, products budget and method */
+    qreal m_centralityEigenvectorTolerance;
+    int m_centralityEigenvectorMaxIterations;
+    bool m_centralityEigenvectorLanczos;
+
+    bool calculatedBCApproximate;
+    bool calculatedEccentricity;
+    int m_distancesStoreSize;
+    int m_distancesStoreRelation;
+    vector<float> m_distancesStore;
+    vector<quint32> m_sigmasStore;
+
+    /** Influence range and domain of each vertex (by vpos), as found by the
+     *  geodesic pass: number of vertices reached from / reaching it and the
+     *  sum of their distances. Used by centralityClosenessIR() and prestigeProximity() */
+    vector<qreal> m_geodesicRangeSize, m_geodesicRangeSum;
+    vector<qreal> m_geodesicDomainSize, m_geodesicDomainSum;
+
+    /** Largest distance from each vertex and the raw (not halved) betweenness
+     *  and stress sums of the geodesic pass, kept for distancesIncrementalRepair() */
+    vector<qreal> m_geodesicRangeMax;
+    vector<qreal> m_geodesicBC, m_geodesicSC;
+
+    /** Incremental geodesic distances after edge edits, see distancesIncrementalRepair().
+     *  m_distancesIncrementalBase is the graph the distances were computed on,
+     *  m_distancesIncrementalArcs the arcs (by vpos) edited since. */
+    bool m_distancesIncremental;
+    bool m_distancesIncrementalCentralities;
+    quint64 m_distancesIncrementalVersion;
+    int m_distancesIncrementalRelation;
+    std::shared_ptr<const GraphCSR> m_distancesIncrementalBase;
+    QVector< QPair<int,int> > m_distancesIncrementalArcs;
+
+    /** Background analysis job on a graph snapshot, see centralityBetweennessBackground() */
+    QFuture<void> m_backgroundJob;
+    QAtomicInt m_backgroundAbort;
+
+    /** Set by graphCancel() to stop the running analysis, see graphCancelled() */
+    QAtomicInt m_cancelRequested;
+    std::shared_ptr<const GraphCSR> m_backgroundSnapshot;
+    vector<qreal> m_backgroundBC, m_backgroundSC;
+    int m_backgroundParameters;
+    bool m_backgroundDropIsolates;
+
+    /** Bulk construction state, see graphBulkBegin(). While building, the
+     *  signals to GW are queued in m_graphBulkDeferred, in the order they were raised */
+    void graphBulkDefer(const std::function<void ()> &emission);
+    int m_graphBulkDepth;
+    bool m_graphBulkUniqueEdges;
+    vector< std::function<void ()> > m_graphBulkDeferred;
+
+    /** PRNG of the random network generators and layouts, see randomizeThings().
+     *  A seed of 0 means a time-based seed, thus output that is not reproducible */
+    mutable GraphRandom m_random;
+    quint64 m_randomSeed;
+
+    /** Transitive closure, see graphReachabilityClosure() */
+    bool reachabilityClosureReaches(const int &i, const int &j) const {
+        if ( m_reachComponent[i] < 0 ) {
+            return false;
+        }
+        return ( m_reachRows[ (size_t) m_reachComponent[i] * m_reachWords + ( j >> 6 ) ]
+                 >> ( j & 63 ) ) & 1;
+    }
+    bool m_reachValid;
+    int m_reachRelation;
+    quint64 m_reachVersion;
+    int m_reachWords;
+    QVector<int> m_reachComponent;
+    vector<quint64> m_reachRows;
 
     /** used in resolveClasses and graphDistancesGeodesic() */
-    H_StrToInt discreteDPs, discreteSDCs, discreteCCs, discreteBCs, discreteSCs;
-    H_StrToInt discreteIRCCs, discreteECs, discreteEccentricities;
-    H_StrToInt discretePCs, discreteICs,  discretePRPs, discretePPs, discreteEVCs;
+    GraphDistribution discreteDPs, discreteSDCs, discreteCCs, discreteBCs, discreteSCs;
+    GraphDistribution discreteIRCCs, discreteECs, discreteEccentricities;
+    GraphDistribution discretePCs, discreteICs,  discretePRPs, discretePPs, discreteEVCs;
 
     QString m_reportsDataDir;
     int m_reportsRealPrecision;
     int m_reportsLabelLength;
     ChartType m_reportsChartType;
+    int m_reportsChartPoints;       // Max points of a distribution line or area chart, see GraphDistribution::downsample()
+    int m_reportsChartImagePoints;  // Likewise, for the large chart image of the HTML reports
+    int m_reportsChartBars;         // Max bars of a distribution bar chart, see GraphDistribution::bin()
 
     int m_fieldWidth, m_curRelation, m_fileFormat, m_vertexClicked;
 
@@ -1306,7 +1798,6 @@ private:
     int classesPRP, maxNodePRP, minNodePRP;
     int classesPP, maxNodePP, minNodePP;
     int classesEVC, maxNodeEVC, minNodeEVC;
-    qreal sizeOfComponent;
 
     /** General & initialisation variables */
 
@@ -1326,6 +1817,14 @@ private:
     int m_graphReciprocityPairsReciprocated;
     int m_graphReciprocityPairsTotal;
 
+    // Running tie counters of the current relation, kept up to date by the
+    // edge edits, behind graphReciprocity(), graphIsSymmetric() and edgesEnabled()
+    bool m_tieCountersValid;
+    quint64 m_tieCountersVersion;               // Graph version the counters describe
+    quint64 m_tieCountersArcVersion;            // Version at which an edge edit last updated them
+    qreal m_tiesWeight, m_tiesWeightReciprocated;
+    int m_tiesNonSymmetric, m_tiePairs, m_tiePairsReciprocated, m_tieArcs;
+
     bool m_graphHasVertexCustomIcons;
 
     int outboundEdgesVert, inboundEdgesVert, reciprocalEdgesVert;
@@ -1334,17 +1833,13 @@ private:
     bool calculatedEdges;
     bool calculatedVertices, calculatedVerticesList, calculatedVerticesSet;
     bool calculatedAdjacencyMatrix, calculatedDistances, calculatedCentralities;
+    int m_graphDistancesParameters, m_graphCentralitiesParameters;
     bool calculatedIsolates;
-    bool calculatedEVC;
-    bool calculatedDP, calculatedDC, calculatedPP;
-    bool calculatedIRCC, calculatedIC, calculatedPRP;
     bool calculatedTriad;
     bool calculatedGraphSymmetry, calculatedGraphReciprocity;
     bool calculatedGraphDensity, calculatedGraphWeighted;
     bool m_graphIsDirected, m_graphIsSymmetric, m_graphIsWeighted, m_graphIsConnected;
 
-    int csRecDepth;
-
     QString VERSION, fileName, m_graphName, initEdgeColor, initVertexColor,
         initVertexNumberColor, initVertexLabelColor;
     QString initVertexShape, initVertexIconPath;
@@ -0,0 +1,94 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphattributes.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphattributes.h"
+
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+
+
+namespace {
+
+QReadWriteLock s_lock;
+QHash<QString, quint32> s_ids;
+QVector<QString> s_values(1);
+
+}
+
+
+
+/**
+ * @brief Returns the id of value, adding it to the table if it is new
+ * @param value
+ * @return
+ */
+quint32 GraphAttributes::id(const QString &value) {
+    if ( value.isEmpty() ) {
+        return 0;
+    }
+    {
+        QReadLocker locker(&s_lock);
+        QHash<QString, quint32>::const_iterator it = s_ids.constFind(value);
+        if ( it != s_ids.constEnd() ) {
+            return it.value();
+        }
+    }
+    QWriteLocker locker(&s_lock);
+    QHash<QString, quint32>::const_iterator it = s_ids.constFind(value);
+    if ( it != s_ids.constEnd() ) {
+        return it.value();
+    }
+    const quint32 id = s_values.size();
+    s_values.append(value);
+    s_ids.insert(value, id);
+    return id;
+}
+
+
+
+/**
+ * @brief Returns the attribute with the given id
+ * @param id
+ * @return
+ */
+QString GraphAttributes::value(const quint32 &id) {
+    QReadLocker locker(&s_lock);
+    return ( id < (quint32) s_values.size() ) ? s_values.at(id) : QString();
+}
+
+
+
+/**
+ * @brief Returns the number of attributes in the table, the empty one included
+ * @return
+ */
+int GraphAttributes::size() {
+    QReadLocker locker(&s_lock);
+    return s_values.size();
+}
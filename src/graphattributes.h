@@ -0,0 +1,52 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphattributes.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHATTRIBUTES_H
+#define GRAPHATTRIBUTES_H
+
+#include <QtGlobal>
+#include <QString>
+
+
+/**
+ * @brief The GraphAttributes class
+ * The one table of the visual attributes of all vertices and edges: colors,
+ * shapes and icon paths. A network uses a handful of them, so each vertex
+ * keeps the small id of its attributes instead of a string of its own.
+ * Ids are never reused, the id of the empty string is 0, and the table is
+ * shared by all threads.
+ */
+class GraphAttributes
+{
+public:
+    static quint32 id(const QString &value);
+    static QString value(const quint32 &id);
+    static int size();
+};
+
+#endif // GRAPHATTRIBUTES_H
@@ -0,0 +1,491 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphbatch.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphbatch.h"
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QDebug>
+
+#include <iostream>
+
+#include "global.h"
+#include "graph.h"
+#include "compressedfile.h"
+#include "graphtrace.h"
+#include "graphscheduler.h"
+
+using namespace std;
+
+
+/**
+ * @brief The indices GraphBatch can compute, with the keys of --compute
+ */
+static const char *batchIndices[] = {
+    "dc", "cc", "ircc", "bc", "sc", "ec", "pc", "ic", "evc",
+    "dp", "prp", "pp", "clc", "ecc"
+};
+
+
+/**
+ * @brief Constructs a batch run from the command line arguments
+ * @param arguments
+ * @param parent
+ */
+GraphBatch::GraphBatch(const QStringList &arguments, QObject *parent) :
+    QObject(parent),
+    m_arguments(arguments),
+    m_graph(nullptr),
+    m_codecName("UTF-8"),
+    m_threads(0),
+    m_twoModeMode(1),
+    m_considerWeights(false),
+    m_inverseWeights(false),
+    m_dropIsolates(false),
+    m_quiet(false)
+{
+}
+
+
+GraphBatch::~GraphBatch() {
+    delete m_graph;
+}
+
+
+/**
+ * @brief Returns true if the program was called with --batch, so that main()
+ * can decide before creating any QApplication.
+ * @param argc
+ * @param argv
+ * @return
+ */
+bool GraphBatch::isBatch(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if ( qstrcmp(argv[i], "--batch") == 0 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @brief Returns the help text of the batch mode options
+ * @return
+ */
+QString GraphBatch::usage() {
+    return QString(
+                "socnetv --batch file [options]\n"
+                "Loads the network file without a GUI, computes and writes, then exits.\n"
+                "--compute list 	Comma separated indices to compute, or all:\n"
+                "               	dc,cc,ircc,bc,sc,ec,pc,ic,evc,dp,prp,pp,clc,ecc\n"
+                "--out file     	Writes the vertex indices table (.csv, .tsv, .gz, .zst)\n"
+                "--save file    	Saves the network (.graphml, .net, .adj, .mtx, .dot, .snb)\n"
+                "--threads n    	Uses at most n worker threads\n"
+                "--weights      	Considers edge weights\n"
+                "--inverse-weights	Considers inverse edge weights as distances\n"
+                "--drop-isolates	Drops isolated vertices from the indices\n"
+                "--codec name   	Codec of the network file (default UTF-8)\n"
+                "--delimiter d  	Column delimiter of edge list files (default space)\n"
+                "--two-mode 1|2 	Mode to read two-mode sociomatrix files\n"
+                "--quiet        	Prints errors only\n"
+                "Exits with 0 on success, 1 on usage errors, 2 if the file could\n"
+                "not be loaded and 3 if a file could not be written.\n");
+}
+
+
+/**
+ * @brief Returns the FileType of a network file from its extension, ignoring
+ * any compression suffix, as MainWindow does when opening a file.
+ * @param fileName
+ * @return
+ */
+int GraphBatch::fileFormatForFileName(const QString &fileName) {
+    const QString name = CompressedFile::fileNameWithoutCompression(fileName).toLower();
+    if ( name.endsWith(".graphml") || name.endsWith(".xml") ) {
+        return FileType::GRAPHML;
+    }
+    else if ( name.endsWith(".net") || name.endsWith(".paj") || name.endsWith(".pajek") ) {
+        return FileType::PAJEK;
+    }
+    else if ( name.endsWith(".dl") || name.endsWith(".dat") ) {
+        return FileType::UCINET;
+    }
+    else if ( name.endsWith(".sm") || name.endsWith(".csv") || name.endsWith(".adj")
+              || name.endsWith(".txt") || name.endsWith(".mtx") ) {
+        return FileType::ADJACENCY;
+    }
+    else if ( name.endsWith(".dot") ) {
+        return FileType::GRAPHVIZ;
+    }
+    else if ( name.endsWith(".gml") ) {
+        return FileType::GML;
+    }
+    else if ( name.endsWith(".list") || name.endsWith(".lst") ) {
+        return FileType::EDGELIST_SIMPLE;
+    }
+    else if ( name.endsWith(".wlist") || name.endsWith(".wlst") ) {
+        return FileType::EDGELIST_WEIGHTED;
+    }
+    else if ( name.endsWith(".2sm") || name.endsWith(".aff") ) {
+        return FileType::TWOMODE;
+    }
+    else if ( name.endsWith(".snb") ) {
+        return FileType::BINARY;
+    }
+    return FileType::UNRECOGNIZED;
+}
+
+
+/**
+ * @brief Prints text to the standard error, unless --quiet
+ * @param text
+ */
+void GraphBatch::message(const QString &text) const {
+    if ( !m_quiet ) {
+        cerr << qPrintable(text) << "\n";
+    }
+}
+
+
+/**
+ * @brief Reads the options following --batch
+ * @param error set to the reason, if the arguments are not valid
+ * @return
+ */
+bool GraphBatch::parseArguments(QString &error) {
+    for (int i = 1; i < m_arguments.size(); ++i) {
+        const QString argument = m_arguments.at(i);
+        const bool hasValue = ( i + 1 < m_arguments.size() );
+
+        if ( argument == "--batch" ) {
+            if ( !hasValue ) {
+                error = tr("--batch needs a network file");
+                return false;
+            }
+            m_inputFileName = m_arguments.at(++i);
+        }
+        else if ( argument == "--compute" && hasValue ) {
+            const QStringList keys = m_arguments.at(++i).toLower()
+                    .split(',', QString::SkipEmptyParts);
+            for (const QString &key : keys) {
+                if ( key.trimmed() == "all" ) {
+                    for (const char *index : batchIndices) {
+                        m_indices << index;
+                    }
+                }
+                else {
+                    m_indices << key.trimmed();
+                }
+            }
+        }
+        else if ( argument == "--out" && hasValue ) {
+            m_outputFileName = m_arguments.at(++i);
+        }
+        else if ( argument == "--save" && hasValue ) {
+            m_saveFileName = m_arguments.at(++i);
+        }
+        else if ( argument == "--threads" && hasValue ) {
+            bool ok = false;
+            m_threads = m_arguments.at(++i).toInt(&ok);
+            if ( !ok || m_threads < 1 ) {
+                error = tr("--threads needs a positive number");
+                return false;
+            }
+        }
+        else if ( argument == "--codec" && hasValue ) {
+            m_codecName = m_arguments.at(++i);
+        }
+        else if ( argument == "--delimiter" && hasValue ) {
+            m_delimiter = m_arguments.at(++i);
+        }
+        else if ( argument == "--two-mode" && hasValue ) {
+            m_twoModeMode = m_arguments.at(++i).toInt();
+            if ( m_twoModeMode != 1 && m_twoModeMode != 2 ) {
+                error = tr("--two-mode must be 1 or 2");
+                return false;
+            }
+        }
+        else if ( argument == "--weights" ) {
+            m_considerWeights = true;
+        }
+        else if ( argument == "--inverse-weights" ) {
+            m_considerWeights = true;
+            m_inverseWeights = true;
+        }
+        else if ( argument == "--drop-isolates" ) {
+            m_dropIsolates = true;
+        }
+        else if ( argument == "--quiet" ) {
+            m_quiet = true;
+        }
+        else {
+            error = tr("Unknown or incomplete option: %1").arg(argument);
+            return false;
+        }
+    }
+
+    if ( m_inputFileName.isEmpty() ) {
+        error = tr("No network file given");
+        return false;
+    }
+    for (const QString &key : m_indices) {
+        bool known = false;
+        for (const char *index : batchIndices) {
+            known = known || ( key == QLatin1String(index) );
+        }
+        if ( !known ) {
+            error = tr("Unknown index: %1").arg(key);
+            return false;
+        }
+    }
+    if ( !m_indices.isEmpty() && m_outputFileName.isEmpty() ) {
+        error = tr("--compute needs --out");
+        return false;
+    }
+    if ( !m_saveFileName.isEmpty()
+         && !m_graph->graphFileFormatExportSupported( fileFormatForFileName(m_saveFileName) ) ) {
+        error = tr("Cannot save networks in the format of %1").arg(m_saveFileName);
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Sets on graph the vertex and edge defaults of MainWindow, which the
+ * parser and the generators use for the new vertices and edges, and turns off
+ * the layout animation.
+ * @param graph
+ */
+void GraphBatch::graphInit(Graph *graph) {
+    graph->vertexShapeSetDefault("circle");
+    graph->vertexSizeInit(10);
+    graph->vertexColorInit("red");
+    graph->vertexNumberSizeInit(0);
+    graph->vertexNumberColorInit("#333");
+    graph->vertexLabelSizeInit(8);
+    graph->vertexLabelColorInit("#8d8d8d");
+    graph->edgeColorInit("#666666");
+    // There is no canvas to animate the layouts on
+    graph->setLayoutFrameRate(0);
+}
+
+
+/**
+ * @brief Loads a network file into graph, and waits in a local event loop
+ * until the parser thread has reported the result.
+ * @param graph
+ * @param fileName
+ * @param fileFormat
+ * @param codecName
+ * @param twoModeMode
+ * @param delimiter
+ * @param error set to the parser message, if the file was not loaded
+ * @return true if the file was loaded
+ */
+bool GraphBatch::graphLoad(Graph *graph,
+                           const QString &fileName,
+                           const int &fileFormat,
+                           const QString &codecName,
+                           const int &twoModeMode,
+                           const QString &delimiter,
+                           QString &error) {
+    bool loaded = false;
+    bool finished = false;
+    QEventLoop loop;
+    QMetaObject::Connection connection =
+            connect(graph, &Graph::signalGraphLoaded,
+                    &loop, [&](const int &fileType, const QString &, const QString &,
+                               const int &, const int &, const QString &reason) {
+        finished = true;
+        loaded = ( fileType != FileType::UNRECOGNIZED );
+        error = reason;
+        loop.quit();
+    });
+
+    graph->graphLoad( fileName,
+                      codecName,
+                      fileFormat,
+                      ( fileFormat == FileType::TWOMODE ) ? twoModeMode : 0,
+                      delimiter );
+
+    // Binary snapshots are loaded before graphLoad() returns
+    if ( !finished ) {
+        loop.exec();
+    }
+    disconnect(connection);
+    return loaded;
+}
+
+
+/**
+ * @brief Loads the input network file
+ * @return true if the file was loaded
+ */
+bool GraphBatch::load() {
+    const int fileFormat = fileFormatForFileName(m_inputFileName);
+    if ( fileFormat == FileType::UNRECOGNIZED ) {
+        cerr << qPrintable( tr("Unknown network file format: %1").arg(m_inputFileName) ) << "\n";
+        return false;
+    }
+
+    const QString delimiter = ( fileFormat == FileType::EDGELIST_SIMPLE
+                                || fileFormat == FileType::EDGELIST_WEIGHTED )
+            ? ( m_delimiter.isEmpty() ? QString(" ") : m_delimiter )
+            : QString();
+
+    QString error;
+    if ( !graphLoad( m_graph, m_inputFileName, fileFormat, m_codecName,
+                     m_twoModeMode, delimiter, error ) ) {
+        cerr << qPrintable( tr("Could not load %1: %2").arg(m_inputFileName).arg(error) ) << "\n";
+        return false;
+    }
+    message( tr("Loaded %1: %2 vertices, %3 edges")
+             .arg(m_inputFileName)
+             .arg(m_graph->vertices())
+             .arg(m_graph->edgesEnabled()) );
+    return true;
+}
+
+
+/**
+ * @brief Computes the index with the given --compute key
+ * The indices computed by graphDistancesGeodesic() all come from one run.
+ * @param index
+ */
+void GraphBatch::compute(const QString &index) {
+    message( tr("Computing %1").arg(index.toUpper()) );
+    if ( index == "dc" ) {
+        m_graph->centralityDegree(m_considerWeights, m_dropIsolates);
+    }
+    else if ( index == "cc" || index == "bc" || index == "sc" || index == "ec"
+              || index == "pc" || index == "ecc" ) {
+        m_graph->graphDistancesGeodesic(true, m_considerWeights, m_inverseWeights,
+                                        m_dropIsolates);
+    }
+    else if ( index == "ircc" ) {
+        m_graph->centralityClosenessIR(m_considerWeights, m_inverseWeights, m_dropIsolates);
+    }
+    else if ( index == "ic" ) {
+        m_graph->centralityInformation(m_considerWeights, m_inverseWeights);
+    }
+    else if ( index == "evc" ) {
+        m_graph->centralityEigenvector(m_considerWeights, m_inverseWeights, m_dropIsolates);
+    }
+    else if ( index == "dp" ) {
+        m_graph->prestigeDegree(m_considerWeights, m_dropIsolates);
+    }
+    else if ( index == "prp" ) {
+        m_graph->prestigePageRank(m_dropIsolates);
+    }
+    else if ( index == "pp" ) {
+        m_graph->prestigeProximity(m_considerWeights, m_inverseWeights, m_dropIsolates);
+    }
+    else if ( index == "clc" ) {
+        m_graph->clusteringCoefficient(false);
+    }
+}
+
+
+/**
+ * @brief Runs the batch: load, compute, write and save
+ * @return the exit status of the process
+ */
+int GraphBatch::exec() {
+
+    GraphTraceScope trace("GraphBatch::exec");
+
+    m_graph = new Graph();
+
+    QString error;
+    if ( !parseArguments(error) ) {
+        cerr << qPrintable(error) << "\n\n" << qPrintable( usage() );
+        return UsageError;
+    }
+
+    if ( m_threads > 0 ) {
+        GraphScheduler::setThreads(m_threads);
+    }
+
+    if ( !m_quiet ) {
+        connect(m_graph, &Graph::statusMessage, this, &GraphBatch::message);
+    }
+
+    graphInit(m_graph);
+
+    if ( !load() ) {
+        return LoadError;
+    }
+
+    // The indices from distances share one geodesic pass, which the
+    // influence range closeness and the proximity prestige reuse
+    GraphTaskGraph tasks;
+    int distances = -1;
+    for (const QString &index : m_indices) {
+        const bool fromDistances = ( index == "cc" || index == "bc" || index == "sc"
+                                     || index == "ec" || index == "pc" || index == "ecc" );
+        if ( fromDistances ) {
+            if ( distances < 0 ) {
+                distances = tasks.add( index, [this, index]() { compute(index); } );
+            }
+            continue;
+        }
+        QList<int> dependencies;
+        if ( ( index == "ircc" || index == "pp" ) && distances >= 0 ) {
+            dependencies << distances;
+        }
+        tasks.add( index, [this, index]() { compute(index); }, dependencies );
+    }
+    tasks.run();
+
+    // Every computation must close the progress frame it opened, or the
+    // graphCancel() of one run would outlive it
+    Q_ASSERT_X( m_graph->graphProgressDepth() == 0, "GraphBatch::exec",
+                "a computation left its progress open" );
+    if ( m_graph->graphProgressDepth() != 0 ) {
+        qWarning() << "GraphBatch::exec() - progress depth"
+                   << m_graph->graphProgressDepth() << "after the run";
+    }
+
+    if ( !m_outputFileName.isEmpty() ) {
+        if ( !m_graph->writeVertexIndicesTable(m_outputFileName) ) {
+            cerr << qPrintable( tr("Could not write %1").arg(m_outputFileName) ) << "\n";
+            return WriteError;
+        }
+    }
+
+    if ( !m_saveFileName.isEmpty() ) {
+        if ( !m_graph->graphSave(m_saveFileName, fileFormatForFileName(m_saveFileName)) ) {
+            cerr << qPrintable( tr("Could not save %1").arg(m_saveFileName) ) << "\n";
+            return WriteError;
+        }
+    }
+
+    return Success;
+}
@@ -0,0 +1,105 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphbatch.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHBATCH_H
+#define GRAPHBATCH_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+
+class Graph;
+
+
+/**
+ * @brief The GraphBatch class
+ * Runs SocNetV without a GUI: loads a network file into a Graph, computes the
+ * requested vertex indices, writes them and/or saves the network, and exits.
+ * There is no MainWindow nor GraphicsWidget, only a QCoreApplication, i.e.
+ *  socnetv --batch in.graphml --compute bc,cc,prp --threads 32 --out results.csv
+ * exec() returns the exit status of the process, see GraphBatch::ExitStatus.
+ */
+class GraphBatch : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    enum ExitStatus {
+        Success     = 0,
+        UsageError  = 1,
+        LoadError   = 2,
+        WriteError  = 3
+    };
+
+    explicit GraphBatch(const QStringList &arguments, QObject *parent = nullptr);
+    ~GraphBatch();
+
+    static bool isBatch(int argc, char *argv[]);
+
+    static QString usage();
+
+    static int fileFormatForFileName(const QString &fileName);
+
+    static void graphInit(Graph *graph);
+
+    static bool graphLoad(Graph *graph,
+                          const QString &fileName,
+                          const int &fileFormat,
+                          const QString &codecName,
+                          const int &twoModeMode,
+                          const QString &delimiter,
+                          QString &error);
+
+    int exec();
+
+private:
+    bool parseArguments(QString &error);
+    bool load();
+    void compute(const QString &index);
+    void message(const QString &text) const;
+
+    QStringList m_arguments;
+    Graph *m_graph;
+
+    QString m_inputFileName;
+    QString m_outputFileName;
+    QString m_saveFileName;
+    QString m_codecName;
+    QString m_delimiter;
+    QStringList m_indices;
+    int m_threads;
+    int m_twoModeMode;
+    bool m_considerWeights;
+    bool m_inverseWeights;
+    bool m_dropIsolates;
+    bool m_quiet;
+};
+
+#endif // GRAPHBATCH_H
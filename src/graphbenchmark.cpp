@@ -0,0 +1,513 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphbenchmark.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphbenchmark.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QDebug>
+
+#include <iostream>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#include "global.h"
+#include "compressedfile.h"
+#include "graph.h"
+#include "graphbatch.h"
+#include "graphtrace.h"
+#include "graphscheduler.h"
+
+using namespace std;
+
+
+/**
+ * @brief Constructs a benchmark run from the command line arguments
+ * @param arguments
+ * @param parent
+ */
+GraphBenchmark::GraphBenchmark(const QStringList &arguments, QObject *parent) :
+    QObject(parent),
+    m_arguments(arguments),
+    m_seed(1),
+    m_threads(0),
+    m_vertices(0),
+    m_edges(0),
+    m_failed(false),
+    m_graph(nullptr)
+{
+    m_sizes << 500 << 2000 << 8000;
+    m_generators << "erdos" << "scalefree" << "smallworld";
+}
+
+
+GraphBenchmark::~GraphBenchmark() {
+    delete m_graph;
+}
+
+
+/**
+ * @brief Returns true if the program was called with --benchmark
+ * @param argc
+ * @param argv
+ * @return
+ */
+bool GraphBenchmark::isBenchmark(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if ( qstrcmp(argv[i], "--benchmark") == 0 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @brief Returns the help text of the benchmark options
+ * @return
+ */
+QString GraphBenchmark::usage() {
+    return QString(
+                "socnetv --benchmark [options]\n"
+                "Times the analyses, layouts and parsers on random networks, without a GUI.\n"
+                "--sizes list   	Comma separated numbers of vertices (default 500,2000,8000)\n"
+                "--generators list	Any of erdos,scalefree,smallworld (default all)\n"
+                "--seed n       	Seed of the generators (default 1)\n"
+                "--threads n    	Uses at most n worker threads\n"
+                "--out file     	Writes the CSV results to file instead of the standard output\n");
+}
+
+
+/**
+ * @brief Returns the peak resident memory of the process so far, in KiB,
+ * or 0 where it is not known.
+ * @return
+ */
+qint64 GraphBenchmark::peakMemory() {
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if ( getrusage(RUSAGE_SELF, &usage) == 0 ) {
+#ifdef Q_OS_MACOS
+        return (qint64) usage.ru_maxrss / 1024;   // bytes on macOS
+#else
+        return (qint64) usage.ru_maxrss;
+#endif
+    }
+#endif
+    return 0;
+}
+
+
+/**
+ * @brief Reads the options following --benchmark
+ * @param error set to the reason, if the arguments are not valid
+ * @return
+ */
+bool GraphBenchmark::parseArguments(QString &error) {
+    for (int i = 1; i < m_arguments.size(); ++i) {
+        const QString argument = m_arguments.at(i);
+        const bool hasValue = ( i + 1 < m_arguments.size() );
+
+        if ( argument == "--benchmark" ) {
+            continue;
+        }
+        else if ( argument == "--sizes" && hasValue ) {
+            m_sizes.clear();
+            const QStringList sizes = m_arguments.at(++i).split(',', QString::SkipEmptyParts);
+            for (const QString &size : sizes) {
+                bool ok = false;
+                const int N = size.toInt(&ok);
+                if ( !ok || N < 10 ) {
+                    error = tr("--sizes needs numbers of at least 10 vertices");
+                    return false;
+                }
+                m_sizes << N;
+            }
+        }
+        else if ( argument == "--generators" && hasValue ) {
+            m_generators = m_arguments.at(++i).toLower().split(',', QString::SkipEmptyParts);
+            for (const QString &generator : m_generators) {
+                if ( generator != "erdos" && generator != "scalefree"
+                     && generator != "smallworld" ) {
+                    error = tr("Unknown generator: %1").arg(generator);
+                    return false;
+                }
+            }
+        }
+        else if ( argument == "--seed" && hasValue ) {
+            bool ok = false;
+            m_seed = m_arguments.at(++i).toULongLong(&ok);
+            if ( !ok ) {
+                error = tr("--seed needs a number");
+                return false;
+            }
+        }
+        else if ( argument == "--threads" && hasValue ) {
+            bool ok = false;
+            m_threads = m_arguments.at(++i).toInt(&ok);
+            if ( !ok || m_threads < 1 ) {
+                error = tr("--threads needs a positive number");
+                return false;
+            }
+        }
+        else if ( argument == "--out" && hasValue ) {
+            m_outputFileName = m_arguments.at(++i);
+        }
+        else {
+            error = tr("Unknown or incomplete option: %1").arg(argument);
+            return false;
+        }
+    }
+    if ( m_sizes.isEmpty() || m_generators.isEmpty() ) {
+        error = tr("Nothing to benchmark");
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Replaces the network with a new random one of N vertices and an
+ * average degree of about 10, created from the benchmark seed.
+ * @param generator erdos, scalefree or smallworld
+ * @param N
+ */
+void GraphBenchmark::generate(const QString &generator, const int &N) {
+    m_graph->clear();
+    m_graph->setRandomSeed(m_seed);
+
+    if ( generator == "erdos" ) {
+        m_graph->randomNetErdosCreate(N, "G(n,p)", 0, 10.0 / ( N - 1 ), "graph", false);
+    }
+    else if ( generator == "scalefree" ) {
+        m_graph->randomNetScaleFreeCreate(N, 1, 5, 5, 1.0, "graph");
+    }
+    else {
+        m_graph->randomNetSmallWorldCreate(N, 10, 0.1, "graph");
+    }
+
+    m_vertices = m_graph->vertices();
+    m_edges = m_graph->edgesEnabled();
+}
+
+
+/**
+ * @brief Times work once on the current network, and writes its CSV row.
+ * @param benchmark
+ * @param generator
+ * @param items the number of items work processes, for the throughput
+ * @param work
+ */
+void GraphBenchmark::run(const QString &benchmark,
+                         const QString &generator,
+                         const qint64 &items,
+                         const std::function<void()> &work) {
+    cerr << qPrintable( tr("%1 on %2 of %3 vertices...")
+                        .arg(benchmark).arg(generator).arg(m_vertices) ) << "\n";
+
+    QElapsedTimer timer;
+    timer.start();
+    work();
+    const qreal seconds = timer.nsecsElapsed() / 1e9;
+
+    QTextStream out(&m_output);
+    out << QCoreApplication::applicationVersion() << ','
+        << benchmark << ','
+        << generator << ','
+        << m_seed << ','
+        << m_vertices << ','
+        << m_edges << ','
+        << GraphScheduler::threads() << ','
+        << QString::number(seconds, 'f', 6) << ','
+        << items << ','
+        << QString::number( ( seconds > 0 ) ? items / seconds : 0, 'f', 1 ) << ','
+        << peakMemory() << '\n';
+}
+
+
+/**
+ * @brief Times the analyses on the current network
+ * @param generator
+ */
+void GraphBenchmark::runAnalyses(const QString &generator) {
+    run("graphDistancesGeodesic", generator, m_vertices, [this]() {
+        m_graph->graphDistancesGeodesic(true, false, true, false);
+    });
+    run("graphCliques", generator, m_vertices, [this]() {
+        m_graph->graphCliques();
+    });
+    run("graphTriadCensus", generator, m_edges, [this]() {
+        m_graph->graphTriadCensus();
+    });
+    run("prestigePageRank", generator, m_edges, [this]() {
+        m_graph->prestigePageRank(false);
+    });
+    run("centralityEigenvector", generator, m_edges, [this]() {
+        m_graph->centralityEigenvector(false, false, false);
+    });
+}
+
+
+/**
+ * @brief Times the force-directed layouts on the current network.
+ * Kamada-Kawai with all pairs needs the N x N distance matrix, thus it runs
+ * only up to 2000 vertices, while stress majorization uses 50 pivots.
+ * @param generator
+ */
+void GraphBenchmark::runLayouts(const QString &generator) {
+    const int iterations = 100;
+    run("layoutForceDirectedSpringEmbedder", generator, iterations, [this, iterations]() {
+        m_graph->layoutForceDirectedSpringEmbedder(iterations);
+    });
+    run("layoutForceDirectedFruchtermanReingold", generator, iterations, [this, iterations]() {
+        m_graph->layoutForceDirectedFruchtermanReingold(iterations);
+    });
+    run("layoutForceDirectedMultilevel", generator, iterations, [this, iterations]() {
+        m_graph->layoutForceDirectedMultilevel("FR", iterations);
+    });
+    if ( m_vertices <= 2000 ) {
+        run("layoutForceDirectedKamadaKawai", generator, iterations, [this, iterations]() {
+            m_graph->layoutForceDirectedKamadaKawai(iterations, false, false, false, "random");
+        });
+    }
+    run("layoutForceDirectedStressMajorization", generator, iterations, [this, iterations]() {
+        m_graph->layoutForceDirectedStressMajorization(iterations, false, false, "random", 50);
+    });
+}
+
+
+/**
+ * @brief Saves the current network in every format SocNetV writes, plus the
+ * edge lists, and times loading each file into a new Graph.
+ * Adjacency matrices grow with N^2, thus they are only used up to 2000 vertices.
+ * GML and UCINET files cannot be written, thus their parsers are not timed.
+ * @param generator
+ */
+void GraphBenchmark::runParsers(const QString &generator) {
+    QTemporaryDir dir;
+    if ( !dir.isValid() ) {
+        cerr << qPrintable( tr("Could not create a temporary directory") ) << "\n";
+        return;
+    }
+
+    struct Format {
+        const char *benchmark;
+        const char *fileName;
+        int fileType;
+    };
+    const Format formats[] = {
+        { "Parser::loadGraphML", "network.graphml", FileType::GRAPHML },
+        { "Parser::loadPajek", "network.net", FileType::PAJEK },
+        { "Parser::loadAdjacency", "network.sm", FileType::ADJACENCY },
+        { "Parser::loadDot", "network.dot", FileType::GRAPHVIZ },
+        { "Parser::loadEdgeListSimple", "network.lst", FileType::EDGELIST_SIMPLE },
+        { "Parser::loadEdgeListWeighed", "network.wlst", FileType::EDGELIST_WEIGHTED },
+        { "Graph::graphLoadFromBinaryFormat", "network.snb", FileType::BINARY }
+    };
+
+    for (const Format &format : formats) {
+        const QString fileName = dir.filePath(format.fileName);
+
+        if ( format.fileType == FileType::ADJACENCY && m_vertices > 2000 ) {
+            continue;
+        }
+
+        bool saved = false;
+        if ( format.fileType == FileType::EDGELIST_SIMPLE
+             || format.fileType == FileType::EDGELIST_WEIGHTED ) {
+            QFile file(fileName);
+            if ( file.open( QIODevice::WriteOnly | QIODevice::Text ) ) {
+                QTextStream outText(&file);
+                const QList<int> vertices = m_graph->verticesList();
+                for (const int &v1 : vertices) {
+                    const QList<int> neighbors = m_graph->vertexNeighborhoodList(v1);
+                    for (const int &v2 : neighbors) {
+                        outText << v1 << ' ' << v2;
+                        if ( format.fileType == FileType::EDGELIST_WEIGHTED ) {
+                            outText << ' ' << m_graph->edgeWeight(v1, v2);
+                        }
+                        outText << '\n';
+                    }
+                }
+                outText.flush();
+                saved = ( outText.status() == QTextStream::Ok );
+            }
+        }
+        else {
+            saved = m_graph->graphSave(fileName, format.fileType);
+        }
+        if ( !saved ) {
+            cerr << qPrintable( tr("Could not write %1").arg(fileName) ) << "\n";
+            continue;
+        }
+
+        run(format.benchmark, generator, m_edges, [&]() {
+            Graph graph;
+            GraphBatch::graphInit(&graph);
+            QString error;
+            const QString delimiter = ( format.fileType == FileType::EDGELIST_SIMPLE
+                                        || format.fileType == FileType::EDGELIST_WEIGHTED )
+                    ? QString(" ") : QString();
+            if ( !GraphBatch::graphLoad(&graph, fileName, format.fileType, "UTF-8",
+                                        0, delimiter, error) ) {
+                cerr << qPrintable( tr("Could not load %1: %2").arg(fileName).arg(error) ) << "\n";
+            }
+        });
+    }
+}
+
+
+/**
+ * @brief Saves the current network as a Pajek file, padded with comment
+ * lines to an exact multiple of CompressedFile::chunkSize(), compresses it
+ * with every compression this build supports, and times loading it back.
+ * The decoder must then flush its last, full, chunk without more input.
+ * A file which does not load back, or loads with another number of
+ * vertices, fails the benchmark run.
+ * @param generator
+ */
+void GraphBenchmark::runCompressed(const QString &generator) {
+    QTemporaryDir dir;
+    if ( !dir.isValid() ) {
+        cerr << qPrintable( tr("Could not create a temporary directory") ) << "\n";
+        return;
+    }
+
+    const QString plainFileName = dir.filePath("network.net");
+    QFile plain(plainFileName);
+    if ( !m_graph->graphSave(plainFileName, FileType::PAJEK)
+         || !plain.open( QIODevice::ReadOnly ) ) {
+        cerr << qPrintable( tr("Could not write %1").arg(plainFileName) ) << "\n";
+        m_failed = true;
+        return;
+    }
+    QByteArray data = plain.readAll();
+    plain.close();
+
+    const int chunk = CompressedFile::chunkSize();
+    const int padded = qMax( 1, ( data.size() + 3 + chunk - 1 ) / chunk ) * chunk;
+    if ( !data.endsWith('\n') ) {
+        data.append('\n');
+    }
+    data.append('%');
+    data.append( QByteArray( padded - data.size() - 1, ' ' ) );
+    data.append('\n');
+
+    const CompressedFile::Compression compressions[] = { CompressedFile::Gzip,
+                                                         CompressedFile::Zstd };
+    for (const CompressedFile::Compression &compression : compressions) {
+        if ( !CompressedFile::isSupported(compression) ) {
+            continue;
+        }
+        const QString fileName = dir.filePath( compression == CompressedFile::Gzip
+                                               ? "network.net.gz" : "network.net.zst" );
+        CompressedFile file(fileName);
+        file.setCompression(compression);
+        if ( !file.open( QIODevice::WriteOnly )
+             || file.write(data) != data.size() ) {
+            cerr << qPrintable( tr("Could not write %1").arg(fileName) ) << "\n";
+            m_failed = true;
+            continue;
+        }
+        file.close();
+
+        const QString benchmark = "Parser::loadPajek."
+                + CompressedFile::compressionName(compression);
+        run(benchmark, generator, data.size(), [&]() {
+            Graph graph;
+            GraphBatch::graphInit(&graph);
+            QString error;
+            if ( !GraphBatch::graphLoad(&graph, fileName, FileType::PAJEK, "UTF-8",
+                                        0, QString(), error) ) {
+                cerr << qPrintable( tr("Could not load %1: %2").arg(fileName).arg(error) ) << "\n";
+                m_failed = true;
+            }
+            else if ( graph.vertices() != m_graph->vertices() ) {
+                cerr << qPrintable( tr("%1 loaded %2 vertices instead of %3")
+                                    .arg(fileName).arg( graph.vertices() )
+                                    .arg( m_graph->vertices() ) ) << "\n";
+                m_failed = true;
+            }
+        });
+    }
+}
+
+
+/**
+ * @brief Runs every benchmark on every generator and size
+ * @return the exit status of the process
+ */
+int GraphBenchmark::exec() {
+
+    QString error;
+    if ( !parseArguments(error) ) {
+        cerr << qPrintable(error) << "\n\n" << qPrintable( usage() );
+        return GraphBatch::UsageError;
+    }
+
+    if ( m_threads > 0 ) {
+        GraphScheduler::setThreads(m_threads);
+    }
+
+    if ( m_outputFileName.isEmpty() ) {
+        m_output.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+    else {
+        m_output.setFileName(m_outputFileName);
+        if ( !m_output.open(QIODevice::WriteOnly | QIODevice::Text) ) {
+            cerr << qPrintable( tr("Could not write %1").arg(m_outputFileName) ) << "\n";
+            return GraphBatch::WriteError;
+        }
+    }
+
+    m_output.write("version,benchmark,generator,seed,vertices,edges,threads,"
+                   "seconds,items,items_per_second,peak_rss_kib\n");
+
+    m_graph = new Graph();
+    GraphBatch::graphInit(m_graph);
+
+    for (const QString &generator : m_generators) {
+        for (const int &N : m_sizes) {
+            run("randomNetCreate", generator, N, [&]() {
+                generate(generator, N);
+            });
+            runAnalyses(generator);
+            runLayouts(generator);
+            runParsers(generator);
+            runCompressed(generator);
+            m_output.flush();
+        }
+    }
+
+    m_output.close();
+    return m_failed ? GraphBatch::LoadError : GraphBatch::Success;
+}
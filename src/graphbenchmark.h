@@ -0,0 +1,98 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphbenchmark.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHBENCHMARK_H
+#define GRAPHBENCHMARK_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QFile>
+
+#include <functional>
+
+
+class Graph;
+
+
+/**
+ * @brief The GraphBenchmark class
+ * Times the hot paths of SocNetV without a GUI, on random networks created
+ * with fixed seeds by the Erdos-Renyi, scale-free and small-world generators
+ * at several sizes: geodesic distances and centralities, clique and triad
+ * census, PageRank, eigenvector centrality, the force-directed layouts and
+ * the parser of every format SocNetV can also write, also from gzip and zstd
+ * compressed files, which must load back.
+ * Every run is a CSV row with the wall time, throughput and the peak resident
+ * memory of the process so far, so that releases can be compared:
+ *  socnetv --benchmark --sizes 1000,10000 --out benchmark.csv
+ * qmake also adds a "make benchmark" target, see socnetv.pro.
+ */
+class GraphBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GraphBenchmark(const QStringList &arguments, QObject *parent = nullptr);
+    ~GraphBenchmark();
+
+    static bool isBenchmark(int argc, char *argv[]);
+
+    static QString usage();
+
+    static qint64 peakMemory();
+
+    int exec();
+
+private:
+    bool parseArguments(QString &error);
+    void generate(const QString &generator, const int &N);
+    void run(const QString &benchmark,
+             const QString &generator,
+             const qint64 &items,
+             const std::function<void()> &work);
+    void runAnalyses(const QString &generator);
+    void runLayouts(const QString &generator);
+    void runParsers(const QString &generator);
+    void runCompressed(const QString &generator);
+
+    QStringList m_arguments;
+    QList<int> m_sizes;
+    QStringList m_generators;
+    QString m_outputFileName;
+    QFile m_output;
+    quint64 m_seed;
+    int m_threads;
+    int m_vertices;
+    int m_edges;
+    bool m_failed;
+    Graph *m_graph;
+};
+
+#endif // GRAPHBENCHMARK_H
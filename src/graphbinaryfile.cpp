@@ -0,0 +1,530 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphbinaryfile.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphbinaryfile.h"
+
+#include <QtDebug>
+#include <QSaveFile>
+#include <QSet>
+
+#include <climits>
+#include <cstring>
+
+
+static const quint32 BINARY_FILE_MAGIC = 0x42564e53;      // "SNVB"
+static const quint32 BINARY_FILE_FORMAT = 2;
+static const quint32 BINARY_FILE_BYTE_ORDER = 0x01020304;
+
+
+/**
+ * @brief The file header. The positions are byte offsets from the start
+ * of the file, all multiples of 8.
+ */
+struct GraphBinaryFile::Header {
+    quint32 magic;
+    quint32 format;
+    quint32 byteOrder;
+    quint32 flags;
+    quint32 vertices;
+    quint32 relations;
+    quint32 currentRelation;
+    quint32 graphName;
+    quint32 strings;
+    quint32 reserved;
+    quint64 stringOffsetsPos;   // strings + 1 offsets into the string data
+    quint64 stringDataPos;      // UTF-8
+    quint64 stringDataSize;
+    quint64 verticesPos;
+    quint64 relationsPos;
+    quint64 resultsPos;         // a QDataStream written by Graph
+    quint64 resultsSize;
+    quint64 fileSize;
+};
+
+
+/**
+ * @brief An entry of the relation table. Each relation has vertices + 1 row
+ * offsets into its edge records, like GraphCSR.
+ */
+struct GraphBinaryFile::Relation {
+    quint32 name;
+    quint32 reserved;
+    quint64 offsetsPos;
+    quint64 edgesPos;
+    quint64 edges;
+};
+
+
+static_assert( sizeof(GraphBinaryFile::Vertex) == 64, "unexpected Vertex record size" );
+static_assert( sizeof(GraphBinaryFile::Edge) == 24, "unexpected Edge record size" );
+
+
+static quint64 binaryFileAlign(const quint64 &pos) {
+    return ( pos + 7 ) & ~( (quint64) 7 );
+}
+
+
+/**
+ * @brief Writes bytes of data, followed by zeros up to the next multiple of 8
+ */
+static bool binaryFileWrite(QSaveFile &file, const void *data, const quint64 &bytes) {
+    static const char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    if ( bytes > 0 && file.write( (const char *) data, bytes ) != (qint64) bytes ) {
+        return false;
+    }
+    const quint64 padding = binaryFileAlign(bytes) - bytes;
+    return padding == 0 || file.write( zeros, padding ) == (qint64) padding;
+}
+
+
+
+GraphBinaryFile::GraphBinaryFile() :
+    m_flags(0),
+    m_currentRelation(0),
+    m_graphNameId(0),
+    m_data(nullptr),
+    m_size(0),
+    m_vertexCount(0),
+    m_relationCount(0),
+    m_vertexTable(nullptr),
+    m_relationTable(nullptr),
+    m_resultsPos(0),
+    m_resultsSize(0)
+{
+    m_stringOffsets << 0;
+}
+
+
+GraphBinaryFile::~GraphBinaryFile() {
+    close();
+}
+
+
+
+/**
+ * @brief Adds a string to the string table, once, and returns its id
+ * @param str
+ * @return quint32
+ */
+quint32 GraphBinaryFile::stringAdd(const QString &str) {
+    QHash<QString, quint32>::const_iterator it = m_stringIds.constFind(str);
+    if ( it != m_stringIds.constEnd() ) {
+        return it.value();
+    }
+    const quint32 id = m_stringIds.size();
+    m_stringData.append( str.toUtf8() );
+    m_stringOffsets << m_stringData.size();
+    m_stringIds.insert(str, id);
+    return id;
+}
+
+
+
+/**
+ * @brief Sets the graph name, the Flags and the relation the snapshot opens with
+ * @param name
+ * @param flags
+ * @param currentRelation
+ */
+void GraphBinaryFile::setGraph(const QString &name,
+                               const int &flags,
+                               const int &currentRelation) {
+    m_graphNameId = stringAdd(name);
+    m_flags = flags;
+    m_currentRelation = currentRelation;
+}
+
+
+
+/**
+ * @brief Starts the edges of a new relation. The edges of each vertex, in the
+ * order of the vertex table, are appended with edgeAppend() and closed with rowEnd().
+ * @param name
+ */
+void GraphBinaryFile::relationAppend(const QString &name) {
+    RelationRows relation;
+    relation.name = stringAdd(name);
+    relation.offsets.reserve( m_vertices.size() + 1 );
+    relation.offsets << 0;
+    m_relations.append(relation);
+}
+
+
+
+/**
+ * @brief Closes the row of edges of the next vertex in the current relation
+ */
+void GraphBinaryFile::rowEnd() {
+    RelationRows &relation = m_relations.last();
+    relation.offsets << relation.edges.size();
+}
+
+
+
+/**
+ * @brief Writes the snapshot built so far to fileName.
+ * The file is replaced only if it has been written completely.
+ * @param fileName
+ * @return bool
+ */
+bool GraphBinaryFile::save(const QString &fileName) {
+
+    const quint64 N = m_vertices.size();
+    const quint64 R = m_relations.size();
+
+    Header header;
+    std::memset( &header, 0, sizeof(Header) );
+    header.magic = BINARY_FILE_MAGIC;
+    header.format = BINARY_FILE_FORMAT;
+    header.byteOrder = BINARY_FILE_BYTE_ORDER;
+    header.flags = m_flags;
+    if ( ! m_results.isEmpty() ) {
+        header.flags |= Results;
+    }
+    header.vertices = N;
+    header.relations = R;
+    header.currentRelation = m_currentRelation;
+    header.graphName = m_graphNameId;
+    header.strings = m_stringIds.size();
+
+    quint64 pos = sizeof(Header);
+    header.stringOffsetsPos = pos;
+    pos += binaryFileAlign( m_stringOffsets.size() * sizeof(quint32) );
+    header.stringDataPos = pos;
+    header.stringDataSize = m_stringData.size();
+    pos += binaryFileAlign( header.stringDataSize );
+    header.verticesPos = pos;
+    pos += binaryFileAlign( N * sizeof(Vertex) );
+    header.relationsPos = pos;
+    pos += binaryFileAlign( R * sizeof(Relation) );
+
+    QVector<Relation> table( R );
+    for (quint64 r = 0; r < R; ++r) {
+        const RelationRows &relation = m_relations[r];
+        if ( (quint64) relation.offsets.size() != N + 1 ) {
+            return fail( QString("relation %1 does not have a row of edges "
+                                 "for every vertex").arg(r) );
+        }
+        table[r].name = relation.name;
+        table[r].reserved = 0;
+        table[r].offsetsPos = pos;
+        pos += binaryFileAlign( ( N + 1 ) * sizeof(quint32) );
+        table[r].edgesPos = pos;
+        table[r].edges = relation.edges.size();
+        pos += binaryFileAlign( table[r].edges * sizeof(Edge) );
+    }
+
+    header.resultsPos = pos;
+    header.resultsSize = m_results.size();
+    pos += binaryFileAlign( header.resultsSize );
+    header.fileSize = pos;
+
+    qDebug() << "GraphBinaryFile::save() - file" << fileName
+             << "vertices" << N << "relations" << R
+             << "strings" << header.strings << "bytes" << header.fileSize;
+
+    QSaveFile file ( fileName );
+    if ( ! file.open( QIODevice::WriteOnly ) ) {
+        return fail( file.errorString() );
+    }
+
+    bool ok = binaryFileWrite( file, &header, sizeof(Header) )
+            && binaryFileWrite( file, m_stringOffsets.constData(),
+                                m_stringOffsets.size() * sizeof(quint32) )
+            && binaryFileWrite( file, m_stringData.constData(), m_stringData.size() )
+            && binaryFileWrite( file, m_vertices.constData(), N * sizeof(Vertex) )
+            && binaryFileWrite( file, table.constData(), R * sizeof(Relation) );
+    for (quint64 r = 0; ok && r < R; ++r) {
+        const RelationRows &relation = m_relations[r];
+        ok = binaryFileWrite( file, relation.offsets.constData(),
+                              ( N + 1 ) * sizeof(quint32) )
+                && binaryFileWrite( file, relation.edges.constData(),
+                                    relation.edges.size() * sizeof(Edge) );
+    }
+    ok = ok && binaryFileWrite( file, m_results.constData(), m_results.size() );
+
+    if ( ! ok || ! file.commit() ) {
+        return fail( file.errorString() );
+    }
+    return true;
+}
+
+
+
+/**
+ * @brief Maps a snapshot file and checks that all its records are consistent,
+ * so that callers may use them without further checks.
+ * @param fileName
+ * @return false if the file is not a valid snapshot, see errorString()
+ */
+bool GraphBinaryFile::open(const QString &fileName) {
+
+    close();
+
+    m_file.setFileName(fileName);
+    if ( ! m_file.open( QIODevice::ReadOnly ) ) {
+        return fail( m_file.errorString() );
+    }
+    m_size = m_file.size();
+    if ( m_size < sizeof(Header) ) {
+        return fail( "The file is too short to be a SocNetV binary snapshot." );
+    }
+    m_data = m_file.map( 0, m_size );
+    if ( m_data == nullptr ) {
+        return fail( QString("Cannot map the file: %1").arg( m_file.errorString() ) );
+    }
+
+    Header header;
+    std::memcpy( &header, m_data, sizeof(Header) );
+
+    if ( header.magic != BINARY_FILE_MAGIC ) {
+        return fail( "The file is not a SocNetV binary snapshot." );
+    }
+    if ( header.byteOrder != BINARY_FILE_BYTE_ORDER ) {
+        return fail( "The snapshot was written on a machine with a different byte order." );
+    }
+    if ( header.format != BINARY_FILE_FORMAT ) {
+        return fail( QString("Unsupported snapshot format version %1.").arg(header.format) );
+    }
+    if ( header.fileSize != m_size ) {
+        return fail( "The snapshot is truncated." );
+    }
+
+    const quint64 N = header.vertices;
+    const quint64 R = header.relations;
+    const quint32 S = header.strings;
+
+    // strings
+    if ( ! inRange( header.stringOffsetsPos, ( (quint64) S + 1 ) * sizeof(quint32) )
+         || ! inRange( header.stringDataPos, 0 )
+         || header.stringDataSize > m_size - header.stringDataPos
+         || header.graphName >= S ) {
+        return fail( "Corrupt string table." );
+    }
+    const quint32 *stringOffsets =
+            reinterpret_cast<const quint32 *>( m_data + header.stringOffsetsPos );
+    const char *stringData =
+            reinterpret_cast<const char *>( m_data + header.stringDataPos );
+    if ( stringOffsets[0] != 0 || stringOffsets[S] != header.stringDataSize ) {
+        return fail( "Corrupt string table." );
+    }
+    m_strings.resize(S);
+    for (quint32 s = 0; s < S; ++s) {
+        if ( stringOffsets[s+1] < stringOffsets[s] ) {
+            return fail( "Corrupt string table." );
+        }
+        m_strings[s] = QString::fromUtf8( stringData + stringOffsets[s],
+                                          stringOffsets[s+1] - stringOffsets[s] );
+    }
+
+    // vertices
+    if ( N > (quint64) INT_MAX || ! inRange( header.verticesPos, N * sizeof(Vertex) ) ) {
+        return fail( "Corrupt vertex table." );
+    }
+    m_vertexTable = reinterpret_cast<const Vertex *>( m_data + header.verticesPos );
+    QSet<int> names;
+    names.reserve(N);
+    for (quint64 i = 0; i < N; ++i) {
+        const Vertex &v = m_vertexTable[i];
+        if ( v.name <= 0 || names.contains(v.name)
+             || v.color >= S || v.numberColor >= S || v.label >= S
+             || v.labelColor >= S || v.shape >= S || v.iconPath >= S ) {
+            return fail( QString("Corrupt vertex record %1.").arg(i) );
+        }
+        names.insert(v.name);
+    }
+
+    // relations
+    if ( R > (quint64) INT_MAX || ! inRange( header.relationsPos, R * sizeof(Relation) )
+         || ( R > 0 && header.currentRelation >= R ) ) {
+        return fail( "Corrupt relation table." );
+    }
+    m_relationTable = reinterpret_cast<const Relation *>( m_data + header.relationsPos );
+    for (quint64 r = 0; r < R; ++r) {
+        const Relation &relation = m_relationTable[r];
+        if ( relation.name >= S
+             || ! inRange( relation.offsetsPos, ( N + 1 ) * sizeof(quint32) )
+             || relation.edges > m_size
+             || ! inRange( relation.edgesPos, relation.edges * sizeof(Edge) ) ) {
+            return fail( QString("Corrupt relation %1.").arg(r) );
+        }
+        const quint32 *rows = reinterpret_cast<const quint32 *>( m_data + relation.offsetsPos );
+        const Edge *edges = reinterpret_cast<const Edge *>( m_data + relation.edgesPos );
+        if ( rows[0] != 0 || rows[N] != relation.edges ) {
+            return fail( QString("Corrupt edges of relation %1.").arg(r) );
+        }
+        for (quint64 i = 0; i < N; ++i) {
+            if ( rows[i+1] < rows[i] ) {
+                return fail( QString("Corrupt edges of relation %1.").arg(r) );
+            }
+        }
+        for (quint64 e = 0; e < relation.edges; ++e) {
+            if ( edges[e].target < 0 || (quint64) edges[e].target >= N
+                 || edges[e].color >= S || edges[e].label >= S ) {
+                return fail( QString("Corrupt edges of relation %1.").arg(r) );
+            }
+        }
+        // Rows are sorted by target, so that a repeated edge is next to the
+        // first one. The loader trusts them to create each edge once.
+        for (quint64 i = 0; i < N; ++i) {
+            for (quint64 e = (quint64) rows[i] + 1; e < rows[i+1]; ++e) {
+                if ( edges[e].target <= edges[e-1].target ) {
+                    return fail( QString("Repeated or unsorted edges of vertex %1 "
+                                         "in relation %2.").arg(i).arg(r) );
+                }
+            }
+        }
+    }
+
+    // results
+    if ( ( header.flags & Results )
+         && ( ! inRange( header.resultsPos, 0 )
+              || header.resultsSize > m_size - header.resultsPos ) ) {
+        return fail( "Corrupt results section." );
+    }
+
+    m_flags = header.flags;
+    m_vertexCount = N;
+    m_relationCount = R;
+    m_currentRelation = header.currentRelation;
+    m_graphName = m_strings[header.graphName];
+    m_resultsPos = header.resultsPos;
+    m_resultsSize = ( header.flags & Results ) ? header.resultsSize : 0;
+
+    qDebug() << "GraphBinaryFile::open() - file" << fileName
+             << "vertices" << m_vertexCount << "relations" << m_relationCount
+             << "strings" << S << "bytes" << m_size;
+
+    return true;
+}
+
+
+
+/**
+ * @brief Unmaps and closes the file opened by open()
+ */
+void GraphBinaryFile::close() {
+    if ( m_data != nullptr ) {
+        m_file.unmap( const_cast<uchar *>(m_data) );
+        m_data = nullptr;
+    }
+    if ( m_file.isOpen() ) {
+        m_file.close();
+    }
+    m_size = 0;
+    m_vertexCount = 0;
+    m_relationCount = 0;
+    m_vertexTable = nullptr;
+    m_relationTable = nullptr;
+    m_resultsPos = 0;
+    m_resultsSize = 0;
+    m_strings.clear();
+}
+
+
+
+/**
+ * @brief Returns the name of relation r
+ * @param r
+ * @return QString
+ */
+QString GraphBinaryFile::relationName(const int &r) const {
+    return m_strings[ m_relationTable[r].name ];
+}
+
+
+/**
+ * @brief Returns the vertices + 1 row offsets into edges(r) of relation r
+ * @param r
+ * @return const quint32*
+ */
+const quint32 *GraphBinaryFile::offsets(const int &r) const {
+    return reinterpret_cast<const quint32 *>( m_data + m_relationTable[r].offsetsPos );
+}
+
+
+/**
+ * @brief Returns the edge records of relation r, row by row
+ * @param r
+ * @return const Edge*
+ */
+const GraphBinaryFile::Edge *GraphBinaryFile::edges(const int &r) const {
+    return reinterpret_cast<const Edge *>( m_data + m_relationTable[r].edgesPos );
+}
+
+
+/**
+ * @brief Returns the number of edge records of relation r
+ * @param r
+ * @return quint64
+ */
+quint64 GraphBinaryFile::edgeCount(const int &r) const {
+    return m_relationTable[r].edges;
+}
+
+
+
+/**
+ * @brief Returns the results section, without copying it out of the mapping.
+ * The data is valid until the file is closed.
+ * @return QByteArray
+ */
+QByteArray GraphBinaryFile::results() const {
+    if ( m_resultsSize == 0 ) {
+        return QByteArray();
+    }
+    return QByteArray::fromRawData( reinterpret_cast<const char *>( m_data + m_resultsPos ),
+                                    m_resultsSize );
+}
+
+
+
+/**
+ * @brief Records an error and closes the file
+ * @param message
+ * @return false
+ */
+bool GraphBinaryFile::fail(const QString &message) {
+    qDebug() << "GraphBinaryFile - error:" << message;
+    m_errorString = message;
+    close();
+    return false;
+}
+
+
+
+/**
+ * @brief Returns true if bytes at pos lie inside the mapped file and pos is
+ * a multiple of 8
+ * @param pos
+ * @param bytes
+ * @return bool
+ */
+bool GraphBinaryFile::inRange(const quint64 &pos, const quint64 &bytes) const {
+    return ( pos % 8 ) == 0 && pos <= m_size && bytes <= m_size - pos;
+}
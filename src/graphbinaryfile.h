@@ -0,0 +1,179 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphbinaryfile.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHBINARYFILE_H
+#define GRAPHBINARYFILE_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+
+/**
+ * @brief The GraphBinaryFile class
+ * Reads and writes the native SocNetV binary snapshot format (.snb).
+ * A snapshot holds the vertex table, the edges of each relation in
+ * compressed-sparse-row form, their weights, colors and labels, the vertex
+ * positions relative to the canvas, and optionally the results of the
+ * prominence indices computed on the network (see GraphResultCache).
+ * All sections are fixed-size records at 8-byte aligned offsets, in the byte
+ * order of the machine that wrote the file. The reader maps the file with
+ * QFile::map and hands out pointers straight into the mapping, so opening a
+ * snapshot costs a validation pass over its records and nothing more.
+ * Strings (colors, labels, shapes, icons and names) are stored once in a
+ * string table and referenced by id.
+ * Each row of edges is sorted by target, without repeats, and every vertex
+ * and edge record keeps whether it is enabled, i.e. not filtered out.
+ */
+class GraphBinaryFile
+{
+public:
+    enum Flags {
+        Directed = 1,
+        Results  = 2
+    };
+
+    /** Flags of the vertex and edge records */
+    enum RecordFlags {
+        Enabled = 1
+    };
+
+    struct Vertex {
+        qint32 name;
+        qint32 size;
+        qint32 numberSize;
+        qint32 labelSize;
+        quint32 color;          // string ids
+        quint32 numberColor;
+        quint32 label;
+        quint32 labelColor;
+        quint32 shape;
+        quint32 iconPath;
+        quint32 flags;          // RecordFlags
+        quint32 reserved;
+        double x;               // relative to the canvas width
+        double y;               // relative to the canvas height
+    };
+
+    struct Edge {
+        qint32 target;          // index of the target in the vertex table
+        quint32 color;          // string ids
+        quint32 label;
+        quint32 flags;          // RecordFlags
+        double weight;
+    };
+
+    GraphBinaryFile();
+    ~GraphBinaryFile();
+
+    /* Writing */
+    quint32 stringAdd(const QString &str);
+
+    void setGraph(const QString &name, const int &flags, const int &currentRelation);
+
+    void vertexAppend(const Vertex &vertex) { m_vertices.append(vertex); }
+
+    void relationAppend(const QString &name);
+
+    void edgeAppend(const Edge &edge) { m_relations.last().edges.append(edge); }
+
+    void rowEnd();
+
+    void setResults(const QByteArray &results) { m_results = results; }
+
+    bool save(const QString &fileName);
+
+    /* Reading */
+    bool open(const QString &fileName);
+
+    void close();
+
+    int flags() const { return m_flags; }
+    int vertices() const { return m_vertexCount; }
+    int relations() const { return m_relationCount; }
+    int currentRelation() const { return m_currentRelation; }
+    QString graphName() const { return m_graphName; }
+
+    const Vertex &vertex(const int &i) const { return m_vertexTable[i]; }
+
+    QString relationName(const int &r) const;
+    const quint32 *offsets(const int &r) const;
+    const Edge *edges(const int &r) const;
+    quint64 edgeCount(const int &r) const;
+
+    const QString &string(const quint32 &id) const { return m_strings[id]; }
+
+    QByteArray results() const;
+
+    QString errorString() const { return m_errorString; }
+
+private:
+    struct Header;
+    struct Relation;
+
+    struct RelationRows {
+        quint32 name;
+        QVector<quint32> offsets;
+        QVector<Edge> edges;
+    };
+
+    bool fail(const QString &message);
+    bool inRange(const quint64 &pos, const quint64 &bytes) const;
+
+    QString m_errorString;
+
+    // writing
+    QHash<QString, quint32> m_stringIds;
+    QVector<quint32> m_stringOffsets;
+    QByteArray m_stringData;
+    QVector<Vertex> m_vertices;
+    QVector<RelationRows> m_relations;
+    QByteArray m_results;
+
+    // reading and writing
+    int m_flags;
+    int m_currentRelation;
+    quint32 m_graphNameId;
+    QString m_graphName;
+
+    // reading
+    QFile m_file;
+    const uchar *m_data;
+    quint64 m_size;
+    int m_vertexCount;
+    int m_relationCount;
+    const Vertex *m_vertexTable;
+    const Relation *m_relationTable;
+    quint64 m_resultsPos, m_resultsSize;
+    QVector<QString> m_strings;
+};
+
+#endif // GRAPHBINARYFILE_H
@@ -0,0 +1,248 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphcliques.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphcliques.h"
+
+#include <QtDebug>
+#include <QtAlgorithms>
+
+#include "graphcsr.h"
+
+
+
+/**
+ * @brief Builds the symmetric adjacency and the degeneracy ordering.
+ * Only enabled vertices take part. Disabled vertices get no neighbors and
+ * are left out of the ordering.
+ * @param csr
+ */
+GraphCliqueCensus::GraphCliqueCensus(const GraphCSR &csr) {
+
+    const int N = csr.vertices();
+    int i=0, j=0, e=0;
+
+    qDebug() << "GraphCliqueCensus::GraphCliqueCensus() - vertices" << N;
+
+    m_names = csr.names();
+    m_adjacency.resize(N);
+    m_rank.fill(-1, N);
+
+    for ( i = 0; i < N; ++i ) {
+        if ( ! csr.isEnabled(i) ) {
+            continue;
+        }
+        for ( e = csr.outBegin(i); e < csr.outEnd(i); ++e ) {
+            j = csr.outTarget(e);
+            if ( j == i || ! csr.isEnabled(j) ) {
+                continue;
+            }
+            if ( csr.edgeWeight(j, i) == csr.outWeight(e) ) {
+                m_adjacency[i].append(j);
+            }
+        }
+    }
+
+    // Degeneracy ordering (Matula & Beck): repeatedly remove a vertex of
+    // minimum remaining degree, using buckets of vertices per degree.
+    int maxDegree = 0;
+    QVector<int> degree(N, 0);
+    for ( i = 0; i < N; ++i ) {
+        degree[i] = m_adjacency[i].size();
+        if ( degree[i] > maxDegree ) {
+            maxDegree = degree[i];
+        }
+    }
+
+    QVector< QVector<int> > buckets(maxDegree + 1);
+    for ( i = 0; i < N; ++i ) {
+        if ( csr.isEnabled(i) ) {
+            buckets[ degree[i] ].append(i);
+        }
+    }
+
+    QVector<bool> removed(N, false);
+    int d = 0;
+    while ( d <= maxDegree ) {
+        if ( buckets[d].isEmpty() ) {
+            d++;
+            continue;
+        }
+        i = buckets[d].takeLast();
+        // stale entry, the vertex has moved to a lower bucket
+        if ( removed[i] || degree[i] != d ) {
+            continue;
+        }
+        removed[i] = true;
+        m_rank[i] = m_order.size();
+        m_order.append(i);
+        for ( int k = 0; k < m_adjacency[i].size(); ++k ) {
+            j = m_adjacency[i][k];
+            if ( removed[j] ) {
+                continue;
+            }
+            degree[j]--;
+            buckets[ degree[j] ].append(j);
+            if ( degree[j] < d ) {
+                d = degree[j];
+            }
+        }
+    }
+
+    qDebug() << "GraphCliqueCensus::GraphCliqueCensus() - ordered"
+             << m_order.size() << "vertices, max degree" << maxDegree;
+}
+
+
+
+/**
+ * @brief Finds all maximal cliques whose earliest vertex, in degeneracy
+ * order, is the vertex at the given position. Thread-safe.
+ * @param position the position of the vertex in the degeneracy order
+ * @param cliques the found cliques are appended here, as vertex numbers
+ */
+void GraphCliqueCensus::find(const int &position,
+                             QList< QList<int> > &cliques) const {
+
+    const int v = m_order[position];
+    const QVector<int> &nbs = m_adjacency[v];
+    const int d = nbs.size();
+    int a=0, b=0, k=0;
+
+    SubProblem sp;
+    sp.words = ( d + 63 ) / 64;
+    sp.local = nbs;
+    sp.adjacency.fill( Bits(sp.words, 0), d );
+    sp.cliques = &cliques;
+    sp.root = v;
+
+    Bits P(sp.words, 0), X(sp.words, 0);
+
+    // Local adjacency: merge each sorted neighbor row with the sorted nbs
+    for ( a = 0; a < d; ++a ) {
+        const QVector<int> &row = m_adjacency[ nbs[a] ];
+        b = 0;
+        k = 0;
+        while ( b < d && k < row.size() ) {
+            if ( nbs[b] < row[k] ) {
+                b++;
+            }
+            else if ( row[k] < nbs[b] ) {
+                k++;
+            }
+            else {
+                sp.adjacency[a][ b >> 6 ] |= ( Q_UINT64_C(1) << ( b & 63 ) );
+                b++;
+                k++;
+            }
+        }
+        // later neighbors are candidates, earlier ones are excluded
+        if ( m_rank[ nbs[a] ] > position ) {
+            P[ a >> 6 ] |= ( Q_UINT64_C(1) << ( a & 63 ) );
+        }
+        else {
+            X[ a >> 6 ] |= ( Q_UINT64_C(1) << ( a & 63 ) );
+        }
+    }
+
+    expand(sp, P, X);
+}
+
+
+
+/**
+ * @brief The recursive step of Bron–Kerbosch with Tomita pivoting, over the
+ * local vertices of a subproblem.
+ * @param sp
+ * @param P candidates
+ * @param X excluded
+ */
+void GraphCliqueCensus::expand(SubProblem &sp, const Bits &P, const Bits &X) const {
+
+    const int W = sp.words;
+    int w=0, u=0, best=-1, bestCount=-1, count=0;
+    bool emptyP = true, emptyX = true;
+
+    for ( w = 0; w < W; ++w ) {
+        if ( P[w] ) emptyP = false;
+        if ( X[w] ) emptyX = false;
+    }
+
+    if ( emptyP ) {
+        if ( emptyX ) {
+            // R is a maximal clique
+            QList<int> clique;
+            clique << m_names[ sp.root ];
+            for ( int k = 0; k < sp.R.size(); ++k ) {
+                clique << m_names[ sp.local[ sp.R[k] ] ];
+            }
+            sp.cliques->append(clique);
+        }
+        return;
+    }
+
+    // Pivot: the vertex u of P ∪ X with the most neighbors in P
+    for ( w = 0; w < W; ++w ) {
+        quint64 bits = P[w] | X[w];
+        while ( bits ) {
+            u = w * 64 + qCountTrailingZeroBits(bits);
+            bits &= bits - 1;
+            count = 0;
+            for ( int k = 0; k < W; ++k ) {
+                count += qPopulationCount( P[k] & sp.adjacency[u][k] );
+            }
+            if ( count > bestCount ) {
+                bestCount = count;
+                best = u;
+            }
+        }
+    }
+
+    Bits nextP(W), nextX(W), p(P), x(X);
+
+    // Branch only on the candidates that are not neighbors of the pivot
+    for ( w = 0; w < W; ++w ) {
+        quint64 bits = P[w] & ~sp.adjacency[best][w];
+        while ( bits ) {
+            u = w * 64 + qCountTrailingZeroBits(bits);
+            bits &= bits - 1;
+
+            for ( int k = 0; k < W; ++k ) {
+                nextP[k] = p[k] & sp.adjacency[u][k];
+                nextX[k] = x[k] & sp.adjacency[u][k];
+            }
+
+            sp.R.append(u);
+            expand(sp, nextP, nextX);
+            sp.R.removeLast();
+
+            // move u from P to X
+            p[ u >> 6 ] &= ~( Q_UINT64_C(1) << ( u & 63 ) );
+            x[ u >> 6 ] |= ( Q_UINT64_C(1) << ( u & 63 ) );
+        }
+    }
+}
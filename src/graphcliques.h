@@ -0,0 +1,81 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphcliques.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHCLIQUES_H
+#define GRAPHCLIQUES_H
+
+#include <QtGlobal>
+#include <QList>
+#include <QVector>
+
+class GraphCSR;
+
+
+/**
+ * @brief The GraphCliqueCensus class
+ * Enumerates all maximal cliques of the symmetric part of a GraphCSR snapshot,
+ * where two vertices are adjacent if they are mutually connected with the
+ * same weight (as in GraphVertex::neighborhoodList()).
+ *
+ * Implements the Bron–Kerbosch algorithm with Tomita pivoting, run once per
+ * vertex in degeneracy order (Eppstein, Löffler & Strash, 2010). Each of these
+ * subproblems only involves the neighborhood of its vertex, so P and X are
+ * word-packed bitsets over that neighborhood and the subproblems can be solved
+ * concurrently, one per call to find().
+ */
+class GraphCliqueCensus
+{
+public:
+    GraphCliqueCensus(const GraphCSR &csr);
+
+    /** Number of vertices, that is subproblems */
+    int vertices() const { return m_order.size(); }
+
+    void find(const int &position, QList< QList<int> > &cliques) const;
+
+private:
+    typedef QVector<quint64> Bits;
+
+    struct SubProblem {
+        int words;
+        QVector<int> local;          // global index of each local vertex
+        QVector<Bits> adjacency;     // local adjacency rows
+        QVector<int> R;
+        QList< QList<int> > *cliques;
+        int root;
+    };
+
+    void expand(SubProblem &sp, const Bits &P, const Bits &X) const;
+
+    QVector<int> m_names;
+    QVector< QVector<int> > m_adjacency;   // sorted symmetric neighbors
+    QVector<int> m_order;                  // vertices in degeneracy order
+    QVector<int> m_rank;                   // position of each vertex in m_order
+};
+
+#endif // GRAPHCLIQUES_H
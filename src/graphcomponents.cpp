@@ -0,0 +1,311 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphcomponents.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphcomponents.h"
+
+#include <QtDebug>
+#include <vector>
+
+#include "graphcsr.h"
+
+
+
+GraphComponents::GraphComponents() :
+    m_built(false),
+    m_strongValid(false),
+    m_relation(-1),
+    m_version(0),
+    m_enabledVertices(0),
+    m_strongCount(0),
+    m_weakCount(0)
+{
+}
+
+
+
+/**
+ * @brief Frees all components
+ */
+void GraphComponents::clear() {
+    m_built = false;
+    m_strongValid = false;
+    m_relation = -1;
+    m_version = 0;
+    m_enabledVertices = 0;
+    m_strongCount = 0;
+    m_weakCount = 0;
+    m_strong.clear();
+    m_strongMembers.clear();
+    m_strongOffsets.clear();
+    m_parent.clear();
+    m_size.clear();
+}
+
+
+
+/**
+ * @brief Computes the strong and the weak components of the snapshot csr
+ * @param csr
+ */
+void GraphComponents::build(const GraphCSR &csr) {
+
+    const int N = csr.vertices();
+    int i = 0, e = 0, j = 0;
+
+    qDebug() << "GraphComponents::build() - vertices" << N
+             << "relation" << csr.relation()
+             << "version" << csr.version();
+
+    clear();
+
+    m_parent.resize(N);
+    m_size.fill(1, N);
+
+    for ( i = 0; i < N; ++i ) {
+        if ( ! csr.isEnabled(i) ) {
+            m_parent[i] = -1;
+            continue;
+        }
+        m_parent[i] = i;
+        m_enabledVertices++;
+    }
+
+    m_weakCount = m_enabledVertices;
+
+    for ( i = 0; i < N; ++i ) {
+        if ( ! csr.isEnabled(i) ) {
+            continue;
+        }
+        for ( e = csr.outBegin(i); e < csr.outEnd(i); ++e ) {
+            j = csr.outTarget(e);
+            if ( csr.isEnabled(j) ) {
+                weakUnion(i, j);
+            }
+        }
+    }
+
+    m_relation = csr.relation();
+    m_version = csr.version();
+    m_built = true;
+
+    buildStrong(csr);
+
+    qDebug() << "GraphComponents::build() - strong components" << m_strongCount
+             << "weak components" << m_weakCount;
+}
+
+
+
+/**
+ * @brief Recomputes the strong components of the snapshot csr with an
+ * iterative Tarjan search. The weak components are left untouched.
+ * @param csr
+ */
+void GraphComponents::buildStrong(const GraphCSR &csr) {
+
+    const int N = csr.vertices();
+    const int *offsets = csr.outOffsets();
+    const int *targets = csr.outTargets();
+
+    std::vector<int> index(N, -1), low(N, 0), edgePos(N, 0);
+    std::vector<int> stack, callStack;
+    std::vector<char> onStack(N, 0);
+    stack.reserve(N);
+    callStack.reserve(N);
+
+    int counter = 0, root = 0, v = 0, w = 0, c = 0;
+
+    m_strongCount = 0;
+    m_strong.fill(-1, N);
+
+    for ( root = 0; root < N; ++root ) {
+
+        if ( ! csr.isEnabled(root) || index[root] != -1 ) {
+            continue;
+        }
+
+        index[root] = low[root] = counter++;
+        edgePos[root] = offsets[root];
+        stack.push_back(root);
+        onStack[root] = 1;
+        callStack.push_back(root);
+
+        while ( ! callStack.empty() ) {
+
+            v = callStack.back();
+
+            if ( edgePos[v] < offsets[v+1] ) {
+                w = targets[ edgePos[v]++ ];
+                if ( ! csr.isEnabled(w) ) {
+                    continue;
+                }
+                if ( index[w] == -1 ) {
+                    index[w] = low[w] = counter++;
+                    edgePos[w] = offsets[w];
+                    stack.push_back(w);
+                    onStack[w] = 1;
+                    callStack.push_back(w);
+                }
+                else if ( onStack[w] ) {
+                    low[v] = qMin( low[v], index[w] );
+                }
+                continue;
+            }
+
+            callStack.pop_back();
+            if ( ! callStack.empty() ) {
+                low[ callStack.back() ] = qMin( low[ callStack.back() ], low[v] );
+            }
+
+            if ( low[v] == index[v] ) {
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = 0;
+                    m_strong[w] = m_strongCount;
+                } while ( w != v );
+                m_strongCount++;
+            }
+        }
+    }
+
+    // Group the members of each component
+    m_strongOffsets.fill(0, m_strongCount + 1);
+    for ( v = 0; v < N; ++v ) {
+        if ( m_strong[v] >= 0 ) {
+            m_strongOffsets[ m_strong[v] + 1 ]++;
+        }
+    }
+    for ( c = 0; c < m_strongCount; ++c ) {
+        m_strongOffsets[c+1] += m_strongOffsets[c];
+    }
+    QVector<int> fill = m_strongOffsets;
+    m_strongMembers.resize( m_strongOffsets[m_strongCount] );
+    for ( v = 0; v < N; ++v ) {
+        if ( m_strong[v] >= 0 ) {
+            m_strongMembers[ fill[ m_strong[v] ]++ ] = v;
+        }
+    }
+
+    m_strongValid = true;
+}
+
+
+
+/**
+ * @brief Merges the arc i -> j, just added to the graph, into the components
+ * and moves them to the new graph version.
+ * The weak components are updated in place. The strong components stay
+ * valid only if i and j were already strongly connected; otherwise they
+ * are marked stale and must be rebuilt with buildStrong().
+ * If either index is out of the snapshot (for instance a vertex was added
+ * meanwhile) the components are cleared.
+ * @param i
+ * @param j
+ * @param version
+ */
+void GraphComponents::arcAdded(const int &i, const int &j, const quint64 &version) {
+
+    if ( ! m_built ) {
+        return;
+    }
+
+    if ( i < 0 || j < 0 || i >= vertices() || j >= vertices() ) {
+        qDebug() << "GraphComponents::arcAdded() - unknown vertex index, clearing";
+        clear();
+        return;
+    }
+
+    m_version = version;
+
+    if ( m_parent[i] < 0 || m_parent[j] < 0 ) {
+        // arcs from or to disabled vertices do not count
+        return;
+    }
+
+    weakUnion(i, j);
+
+    if ( m_strongValid && m_strong[i] != m_strong[j] ) {
+        m_strongValid = false;
+    }
+}
+
+
+
+/**
+ * @brief Returns the representative vertex of the weak component of i
+ * @param i
+ * @return
+ */
+int GraphComponents::weakComponent(const int &i) const {
+    int r = i;
+    if ( m_parent[r] < 0 ) {
+        return -1;
+    }
+    while ( m_parent[r] != r ) {
+        r = m_parent[r];
+    }
+    return r;
+}
+
+
+
+/**
+ * @brief Finds the root of i, halving the path on the way
+ * @param i
+ * @return
+ */
+int GraphComponents::weakFind(const int &i) {
+    int r = i;
+    while ( m_parent[r] != r ) {
+        m_parent[r] = m_parent[ m_parent[r] ];
+        r = m_parent[r];
+    }
+    return r;
+}
+
+
+
+/**
+ * @brief Joins the weak components of i and j, the smaller under the larger
+ * @param i
+ * @param j
+ */
+void GraphComponents::weakUnion(const int &i, const int &j) {
+    int a = weakFind(i);
+    int b = weakFind(j);
+    if ( a == b ) {
+        return;
+    }
+    if ( m_size[a] < m_size[b] ) {
+        qSwap(a, b);
+    }
+    m_parent[b] = a;
+    m_size[a] += m_size[b];
+    m_weakCount--;
+}
@@ -0,0 +1,124 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphcomponents.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHCOMPONENTS_H
+#define GRAPHCOMPONENTS_H
+
+#include <QtGlobal>
+#include <QVector>
+
+class GraphCSR;
+
+
+/**
+ * @brief The GraphComponents class
+ * Strong and weak components of a GraphCSR snapshot, over its enabled vertices.
+ *
+ * Strong components are found with an iterative Tarjan search, in linear time.
+ * They are numbered in the order Tarjan completes them, which is a reverse
+ * topological order of the condensation: every arc between two components
+ * goes from a higher to a lower component number.
+ *
+ * Weak components are kept in a union-find forest (union by size, path
+ * halving on union), so that arcs added to the graph afterwards can be merged
+ * in with arcAdded() without a rebuild. An added arc keeps the strong components
+ * valid only if both ends were already in the same component.
+ *
+ * Disabled vertices belong to no component.
+ */
+class GraphComponents
+{
+public:
+    GraphComponents();
+
+    void build(const GraphCSR &csr);
+
+    void buildStrong(const GraphCSR &csr);
+
+    void clear();
+
+    bool isValid(const int &relation, const quint64 &version) const {
+        return m_built && m_relation == relation && m_version == version;
+    }
+
+    void setVersion(const quint64 &version) { m_version = version; }
+
+    quint64 version() const { return m_version; }
+
+    void arcAdded(const int &i, const int &j, const quint64 &version);
+
+    /** Number of vertices (enabled or not) */
+    int vertices() const { return m_parent.size(); }
+
+    /** Number of enabled vertices */
+    int enabledVertices() const { return m_enabledVertices; }
+
+    bool isStrongValid() const { return m_strongValid; }
+
+    int strongComponents() const { return m_strongCount; }
+
+    /** Returns the strong component of vertex i, or -1 if i is disabled */
+    int strongComponent(const int &i) const { return m_strong[i]; }
+
+    const QVector<int> &strongComponentOf() const { return m_strong; }
+
+    /** Vertices of strong component c are
+     *  strongMembers()[ strongOffsets()[c] .. strongOffsets()[c+1] ) */
+    const QVector<int> &strongMembers() const { return m_strongMembers; }
+    const QVector<int> &strongOffsets() const { return m_strongOffsets; }
+
+    int weakComponents() const { return m_weakCount; }
+
+    /** Returns the representative vertex of the weak component of i,
+     *  or -1 if i is disabled */
+    int weakComponent(const int &i) const;
+
+    bool isStronglyConnected() const { return m_strongCount < 2; }
+    bool isWeaklyConnected() const { return m_weakCount < 2; }
+
+private:
+    bool m_built;
+    bool m_strongValid;
+    int m_relation;
+    quint64 m_version;
+    int m_enabledVertices;
+
+    int m_strongCount;
+    QVector<int> m_strong;
+    QVector<int> m_strongMembers;
+    QVector<int> m_strongOffsets;
+
+    int m_weakCount;
+    QVector<int> m_parent;
+    QVector<int> m_size;
+
+    int weakFind(const int &i);
+    void weakUnion(const int &i, const int &j);
+};
+
+#endif // GRAPHCOMPONENTS_H
@@ -0,0 +1,437 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphcsr.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphcsr.h"
+
+#include <QtDebug>
+#include <QtAlgorithms>     // qPopulationCount
+#include <algorithm>
+
+#include "graphvertex.h"
+
+// Vector path of the merge in intersectionCount(), when the compiler targets it
+#if defined(__AVX2__)
+#define SOCNETV_CSR_AVX2
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define SOCNETV_CSR_NEON
+#include <arm_neon.h>
+#endif
+
+
+
+GraphCSR::GraphCSR() :
+    m_built(false),
+    m_relation(-1),
+    m_reduction(ReduceNone),
+    m_version(0),
+    m_maxWeight(0)
+{
+}
+
+
+
+/**
+ * @brief Drops all arrays and marks the snapshot as invalid.
+ */
+void GraphCSR::clear() {
+    m_built = false;
+    m_relation = -1;
+    m_reduction = ReduceNone;
+    m_version = 0;
+    m_maxWeight = 0;
+    m_names.clear();
+    m_enabled.clear();
+    m_outOffsets.clear();
+    m_outTargets.clear();
+    m_outWeights.clear();
+    m_inOffsets.clear();
+    m_inSources.clear();
+    m_inWeights.clear();
+}
+
+
+
+/**
+ * @brief Builds the snapshot from the given vertex list.
+ *
+ * Only the enabled out-edges of the given relation are stored. Disabled vertices
+ * keep their index but get an empty row, while edges pointing to a disabled
+ * vertex are kept, as the traversal routines do.
+ * The inbound arrays are the transpose of the outbound ones, computed with a
+ * counting sort, so that both sides are sorted by neighbor index.
+ *
+ * @param vertices  the list of vertices, in index order
+ * @param vpos      maps vertex numbers to their index in the vertices list
+ * @param relation  the relation to snapshot
+ * @param version   the graph version this snapshot corresponds to
+ */
+void GraphCSR::build(const QList<GraphVertex*> &vertices,
+                     const QHash<int,int> &vpos,
+                     const int &relation,
+                     const quint64 &version) {
+
+    const int N = vertices.size();
+
+    qDebug() << "GraphCSR::build() - vertices" << N
+             << "relation" << relation
+             << "version" << version;
+
+    clear();
+
+    m_names.resize(N);
+    m_enabled.resize(N);
+    m_outOffsets.resize(N+1);
+    m_inOffsets.fill(0, N+1);
+
+    QVector< QPair<int,qreal> > row;
+
+    QList<GraphVertex*>::const_iterator it;
+    int i = 0;
+
+    for ( it = vertices.cbegin(); it != vertices.cend(); ++it, ++i ) {
+
+        m_names[i] = (*it)->name();
+        m_enabled[i] = (*it)->isEnabled();
+        m_outOffsets[i] = m_outTargets.size();
+
+        if ( ! m_enabled[i] ) {
+            continue;
+        }
+
+        row.clear();
+
+        const H_edges &edges = (*it)->outEdgesRelation(relation);
+        H_edges::const_iterator e;
+        for ( e = edges.cbegin(); e != edges.cend(); ++e ) {
+            if ( ! e.value().second ) {
+                continue;
+            }
+            QHash<int,int>::const_iterator p = vpos.constFind( e.key() );
+            if ( p == vpos.cend() ) {
+                continue;
+            }
+            row.append( qMakePair( p.value(), e.value().first ) );
+        }
+
+        std::sort( row.begin(), row.end(),
+                   [](const QPair<int,qreal> &a, const QPair<int,qreal> &b) {
+                        return a.first < b.first;
+                   } );
+
+        for ( int k = 0; k < row.size(); ++k ) {
+            m_outTargets.append( row[k].first );
+            m_outWeights.append( row[k].second );
+            m_inOffsets[ row[k].first + 1 ]++;
+            if ( row[k].second > m_maxWeight ) {
+                m_maxWeight = row[k].second;
+            }
+        }
+    }
+    m_outOffsets[N] = m_outTargets.size();
+
+    buildInbound();
+
+    m_relation = relation;
+    m_reduction = ReduceNone;
+    m_version = version;
+    m_built = true;
+
+    qDebug() << "GraphCSR::build() - finished. arcs" << m_outTargets.size();
+}
+
+
+
+/**
+ * @brief Builds the snapshot of the union of all relations.
+ *
+ * There is one arc i -> j if there is an enabled edge i -> j in any of the
+ * given relations, and its weight is the sum or the max of the weights of
+ * these edges, or their count, according to reduction.
+ * Each row is accumulated in dense scratch arrays, so the build visits each
+ * edge once and allocates nothing per vertex.
+ *
+ * @param vertices  the list of vertices, in index order
+ * @param vpos      maps vertex numbers to their index in the vertices list
+ * @param relations the number of relations
+ * @param reduction how to combine the weights of parallel edges, ReduceSum, ReduceMax or ReduceCount
+ * @param version   the graph version this snapshot corresponds to
+ */
+void GraphCSR::buildUnion(const QList<GraphVertex*> &vertices,
+                          const QHash<int,int> &vpos,
+                          const int &relations,
+                          const Reduction &reduction,
+                          const quint64 &version) {
+
+    const int N = vertices.size();
+
+    qDebug() << "GraphCSR::buildUnion() - vertices" << N
+             << "relations" << relations
+             << "reduction" << reduction
+             << "version" << version;
+
+    clear();
+
+    m_names.resize(N);
+    m_enabled.resize(N);
+    m_outOffsets.resize(N+1);
+    m_inOffsets.fill(0, N+1);
+
+    QVector<qreal> sum(N, 0);
+    QVector<int> seen(N, -1);
+    QVector<int> row;
+
+    QList<GraphVertex*>::const_iterator it;
+    int i = 0;
+
+    for ( it = vertices.cbegin(); it != vertices.cend(); ++it, ++i ) {
+
+        m_names[i] = (*it)->name();
+        m_enabled[i] = (*it)->isEnabled();
+        m_outOffsets[i] = m_outTargets.size();
+
+        if ( ! m_enabled[i] ) {
+            continue;
+        }
+
+        row.clear();
+
+        for ( int relation = 0; relation < relations; ++relation ) {
+            const H_edges &edges = (*it)->outEdgesRelation(relation);
+            H_edges::const_iterator e;
+            for ( e = edges.cbegin(); e != edges.cend(); ++e ) {
+                if ( ! e.value().second ) {
+                    continue;
+                }
+                QHash<int,int>::const_iterator p = vpos.constFind( e.key() );
+                if ( p == vpos.cend() ) {
+                    continue;
+                }
+                const int j = p.value();
+                const qreal w = ( reduction == ReduceCount ) ? 1 : e.value().first;
+                if ( seen[j] != i ) {
+                    seen[j] = i;
+                    sum[j] = w;
+                    row.append(j);
+                }
+                else if ( reduction == ReduceMax ) {
+                    sum[j] = qMax( sum[j], w );
+                }
+                else {
+                    sum[j] += w;
+                }
+            }
+        }
+
+        std::sort( row.begin(), row.end() );
+
+        for ( int k = 0; k < row.size(); ++k ) {
+            m_outTargets.append( row[k] );
+            m_outWeights.append( sum[ row[k] ] );
+            m_inOffsets[ row[k] + 1 ]++;
+            if ( sum[ row[k] ] > m_maxWeight ) {
+                m_maxWeight = sum[ row[k] ];
+            }
+        }
+    }
+
+    m_outOffsets[N] = m_outTargets.size();
+
+    buildInbound();
+
+    m_relation = AllRelations;
+    m_reduction = reduction;
+    m_version = version;
+    m_built = true;
+
+    qDebug() << "GraphCSR::buildUnion() - finished. arcs" << m_outTargets.size();
+}
+
+
+
+/**
+ * @brief Computes the inbound arrays as the transpose of the outbound ones,
+ * once m_inOffsets holds the in-degree of each vertex at index + 1.
+ */
+void GraphCSR::buildInbound() {
+
+    const int N = m_names.size();
+
+    // Transpose: prefix sums of in-degrees, then scatter in source order,
+    // which keeps every inbound row sorted by source index.
+    for ( int j = 0; j < N; ++j ) {
+        m_inOffsets[j+1] += m_inOffsets[j];
+    }
+
+    const int E = m_outTargets.size();
+    m_inSources.resize(E);
+    m_inWeights.resize(E);
+
+    QVector<int> cursor = m_inOffsets;
+
+    for ( int s = 0; s < N; ++s ) {
+        for ( int e = m_outOffsets[s]; e < m_outOffsets[s+1]; ++e ) {
+            int pos = cursor[ m_outTargets[e] ]++;
+            m_inSources[pos] = s;
+            m_inWeights[pos] = m_outWeights[e];
+        }
+    }
+
+}
+
+
+
+/**
+ * @brief Returns the weight of the arc i -> j, or 0 if there is none.
+ * Uses binary search on the sorted row of i.
+ * @param i source index
+ * @param j target index
+ * @return qreal
+ */
+qreal GraphCSR::edgeWeight(const int &i, const int &j) const {
+    const int *first = m_outTargets.constData() + m_outOffsets[i];
+    const int *last = m_outTargets.constData() + m_outOffsets[i+1];
+    const int *p = std::lower_bound(first, last, j);
+    if ( p != last && *p == j ) {
+        return m_outWeights[ p - m_outTargets.constData() ];
+    }
+    return 0;
+}
+
+
+
+/**
+ * @brief Fills row with the neighbors of i that are mutually connected to it
+ * with the same weight, in index order and without i itself.
+ * This is the same neighborhood as GraphVertex::neighborhoodList().
+ * @param i
+ * @param row
+ */
+void GraphCSR::mutualNeighbors(const int &i, QVector<int> &row) const {
+    row.clear();
+    for ( int e = m_outOffsets[i]; e < m_outOffsets[i+1]; ++e ) {
+        const int j = m_outTargets[e];
+        if ( j != i && edgeWeight(j, i) == m_outWeights[e] ) {
+            row.append(j);
+        }
+    }
+}
+
+
+
+/**
+ * @brief Returns the number of common elements of two sorted arrays, without
+ * repeated elements, such as the rows of the CSR.
+ * When one array is much shorter than the other, each of its elements is
+ * looked up by galloping through the longer one. Otherwise the arrays are
+ * merged a block at a time where AVX2 or NEON is available: every element of
+ * a block of a is compared with every element of a block of b, by rotating
+ * the latter, and the block with the smaller last element is passed over.
+ * The rest is finished by a branch-free scalar merge.
+ * @param a first sorted array
+ * @param aSize
+ * @param b second sorted array
+ * @param bSize
+ * @return int
+ */
+int GraphCSR::intersectionCount(const int *a, const int &aSize,
+                                const int *b, const int &bSize) {
+    if ( aSize == 0 || bSize == 0 ) {
+        return 0;
+    }
+    if ( aSize > bSize ) {
+        return intersectionCount(b, bSize, a, aSize);
+    }
+
+    int count = 0;
+
+    if ( aSize * 32 < bSize ) {
+        const int *first = b;
+        const int *last = b + bSize;
+        for ( int x = 0; x < aSize && first != last; ++x ) {
+            int step = 1;
+            const int *hi = first;
+            while ( hi < last && *hi < a[x] ) {
+                first = hi;
+                hi = ( last - hi > step ) ? hi + step : last;
+                step <<= 1;
+            }
+            first = std::lower_bound(first, hi, a[x]);
+            if ( first != last && *first == a[x] ) {
+                count++;
+                ++first;
+            }
+        }
+        return count;
+    }
+
+    int x = 0, y = 0;
+
+#if defined(SOCNETV_CSR_AVX2)
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while ( x + 8 <= aSize && y + 8 <= bSize ) {
+        const __m256i va = _mm256_loadu_si256( reinterpret_cast<const __m256i *>(a + x) );
+        __m256i vb = _mm256_loadu_si256( reinterpret_cast<const __m256i *>(b + y) );
+        __m256i match = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; ++r) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            match = _mm256_or_si256( match, _mm256_cmpeq_epi32(va, vb) );
+        }
+        count += qPopulationCount( static_cast<quint32>(
+                        _mm256_movemask_ps( _mm256_castsi256_ps(match) ) ) );
+        const int aLast = a[x + 7];
+        const int bLast = b[y + 7];
+        x += ( aLast <= bLast ) ? 8 : 0;
+        y += ( bLast <= aLast ) ? 8 : 0;
+    }
+#elif defined(SOCNETV_CSR_NEON)
+    while ( x + 4 <= aSize && y + 4 <= bSize ) {
+        const int32x4_t va = vld1q_s32(a + x);
+        int32x4_t vb = vld1q_s32(b + y);
+        uint32x4_t match = vceqq_s32(va, vb);
+        for (int r = 1; r < 4; ++r) {
+            vb = vextq_s32(vb, vb, 1);
+            match = vorrq_u32( match, vceqq_s32(va, vb) );
+        }
+        count += static_cast<int>( vaddvq_u32( vshrq_n_u32(match, 31) ) );
+        const int aLast = a[x + 3];
+        const int bLast = b[y + 3];
+        x += ( aLast <= bLast ) ? 4 : 0;
+        y += ( bLast <= aLast ) ? 4 : 0;
+    }
+#endif
+
+    while ( x < aSize && y < bSize ) {
+        const int u = a[x];
+        const int v = b[y];
+        count += ( u == v );
+        x += ( u <= v );
+        y += ( v <= u );
+    }
+    return count;
+}
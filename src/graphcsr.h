@@ -0,0 +1,152 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphcsr.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+#ifndef GRAPHCSR_H
+#define GRAPHCSR_H
+
+#include <QtGlobal>
+#include <QList>
+#include <QHash>
+#include <QVector>
+
+class GraphVertex;
+
+
+/**
+ * @brief The GraphCSR class
+ * An immutable compressed-sparse-row snapshot of the adjacency of a Graph.
+ * Vertices are addressed by their dense index 0..N-1, which is the same as
+ * their position inside Graph::m_graph (that is, vpos[name]).
+ * The snapshot holds only the enabled edges of a single relation, together with
+ * the transposed (inbound) adjacency. Each row is sorted by neighbor index.
+ * It is built once per graph version by Graph::graphCSR() and must not be used
+ * after the graph has changed, unless it is held through Graph::graphSnapshot().
+ * A snapshot may also hold the union of all relations, see buildUnion() and
+ * Graph::graphCSRUnion().
+ */
+class GraphCSR
+{
+public:
+    /** How the weights of the edges of a pair in different relations are combined */
+    enum Reduction {
+        ReduceNone,     // a single relation
+        ReduceSum,
+        ReduceMax,
+        ReduceCount
+    };
+
+    /** The relation of a snapshot of the union of all relations */
+    static const int AllRelations = -2;
+
+    GraphCSR();
+
+    void build(const QList<GraphVertex*> &vertices,
+               const QHash<int,int> &vpos,
+               const int &relation,
+               const quint64 &version);
+
+    void buildUnion(const QList<GraphVertex*> &vertices,
+                    const QHash<int,int> &vpos,
+                    const int &relations,
+                    const Reduction &reduction,
+                    const quint64 &version);
+
+    void clear();
+
+    bool isValid(const int &relation, const quint64 &version,
+                 const Reduction &reduction = ReduceNone) const {
+        return m_built && m_relation == relation && m_version == version
+                && m_reduction == reduction;
+    }
+
+    int relation() const { return m_relation; }
+    Reduction reduction() const { return m_reduction; }
+    quint64 version() const { return m_version; }
+
+    /** Number of vertices (enabled or not) in the snapshot */
+    int vertices() const { return m_names.size(); }
+
+    /** Number of arcs (directed edges) in the snapshot */
+    int edges() const { return m_outTargets.size(); }
+
+    /** Returns the vertex number (name) of the vertex at index i */
+    int name(const int &i) const { return m_names[i]; }
+    const QVector<int> &names() const { return m_names; }
+
+    /** Returns true if the vertex at index i is enabled */
+    bool isEnabled(const int &i) const { return m_enabled[i]; }
+
+    int outDegree(const int &i) const { return m_outOffsets[i+1] - m_outOffsets[i]; }
+    int outBegin(const int &i) const { return m_outOffsets[i]; }
+    int outEnd(const int &i) const { return m_outOffsets[i+1]; }
+    int outTarget(const int &e) const { return m_outTargets[e]; }
+    qreal outWeight(const int &e) const { return m_outWeights[e]; }
+
+    int inDegree(const int &i) const { return m_inOffsets[i+1] - m_inOffsets[i]; }
+    int inBegin(const int &i) const { return m_inOffsets[i]; }
+    int inEnd(const int &i) const { return m_inOffsets[i+1]; }
+    int inSource(const int &e) const { return m_inSources[e]; }
+    qreal inWeight(const int &e) const { return m_inWeights[e]; }
+
+    const int *outTargets() const { return m_outTargets.constData(); }
+    const qreal *outWeights() const { return m_outWeights.constData(); }
+    const int *outOffsets() const { return m_outOffsets.constData(); }
+    const int *inSources() const { return m_inSources.constData(); }
+    const qreal *inWeights() const { return m_inWeights.constData(); }
+    const int *inOffsets() const { return m_inOffsets.constData(); }
+
+    qreal edgeWeight(const int &i, const int &j) const;
+
+    void mutualNeighbors(const int &i, QVector<int> &row) const;
+
+    qreal maxWeight() const { return m_maxWeight; }
+
+    static int intersectionCount(const int *a, const int &aSize,
+                                 const int *b, const int &bSize);
+
+private:
+    void buildInbound();
+
+    bool m_built;
+    int m_relation;
+    Reduction m_reduction;
+    quint64 m_version;
+    qreal m_maxWeight;
+
+    QVector<int> m_names;
+    QVector<bool> m_enabled;
+
+    QVector<int> m_outOffsets;
+    QVector<int> m_outTargets;
+    QVector<qreal> m_outWeights;
+
+    QVector<int> m_inOffsets;
+    QVector<int> m_inSources;
+    QVector<qreal> m_inWeights;
+};
+
+#endif // GRAPHCSR_H
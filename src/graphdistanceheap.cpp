@@ -0,0 +1,162 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphdistanceheap.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+#include "graphdistanceheap.h"
+
+
+GraphDistanceHeap::GraphDistanceHeap()
+{
+}
+
+
+
+/**
+ * @brief Prepares the heap for vertex indices 0..N-1 and empties it.
+ * @param N
+ */
+void GraphDistanceHeap::resize(const int &N) {
+    m_items.clear();
+    m_keys.clear();
+    m_items.reserve(N);
+    m_keys.reserve(N);
+    m_pos.assign(N, -1);
+}
+
+
+
+/**
+ * @brief Empties the heap, in time proportional to its current size.
+ */
+void GraphDistanceHeap::clear() {
+    for (vector<int>::const_iterator it = m_items.cbegin(); it != m_items.cend(); ++it) {
+        m_pos[*it] = -1;
+    }
+    m_items.clear();
+    m_keys.clear();
+}
+
+
+
+/**
+ * @brief Inserts the vertex index i with the given key or, if i is already
+ * in the heap, decreases its key. A larger key than the current one is ignored.
+ * @param i
+ * @param key
+ */
+void GraphDistanceHeap::push(const int &i, const qreal &key) {
+    int slot = m_pos[i];
+    if ( slot < 0 ) {
+        slot = (int) m_items.size();
+        m_items.push_back(i);
+        m_keys.push_back(key);
+        m_pos[i] = slot;
+    }
+    else if ( key < m_keys[slot] ) {
+        m_keys[slot] = key;
+    }
+    else {
+        return;
+    }
+    siftUp(slot);
+}
+
+
+
+/**
+ * @brief Removes and returns the vertex index with the minimum key.
+ * The heap must not be empty.
+ * @return int
+ */
+int GraphDistanceHeap::pop() {
+    const int top = m_items[0];
+    m_pos[top] = -1;
+    const int last = (int) m_items.size() - 1;
+    if ( last > 0 ) {
+        place( 0, m_items[last], m_keys[last] );
+    }
+    m_items.pop_back();
+    m_keys.pop_back();
+    if ( last > 1 ) {
+        siftDown(0);
+    }
+    return top;
+}
+
+
+
+void GraphDistanceHeap::place(const int &slot, const int &item, const qreal &key) {
+    m_items[slot] = item;
+    m_keys[slot] = key;
+    m_pos[item] = slot;
+}
+
+
+
+void GraphDistanceHeap::siftUp(int slot) {
+    const int item = m_items[slot];
+    const qreal key = m_keys[slot];
+    int parent = 0;
+    while ( slot > 0 ) {
+        parent = ( slot - 1 ) / 4;
+        if ( ! ( key < m_keys[parent]
+                 || ( key == m_keys[parent] && item < m_items[parent] ) ) ) {
+            break;
+        }
+        place( slot, m_items[parent], m_keys[parent] );
+        slot = parent;
+    }
+    place( slot, item, key );
+}
+
+
+
+void GraphDistanceHeap::siftDown(int slot) {
+    const int size = (int) m_items.size();
+    int child = 0, best = 0, end = 0;
+    while ( true ) {
+        child = 4 * slot + 1;
+        if ( child >= size ) {
+            break;
+        }
+        best = slot;
+        end = qMin( child + 4, size );
+        for ( ; child < end; ++child ) {
+            if ( less(child, best) ) {
+                best = child;
+            }
+        }
+        if ( best == slot ) {
+            break;
+        }
+        // swap slot and best
+        const int item = m_items[slot];
+        const qreal key = m_keys[slot];
+        place( slot, m_items[best], m_keys[best] );
+        place( best, item, key );
+        slot = best;
+    }
+}
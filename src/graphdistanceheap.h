@@ -0,0 +1,83 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphdistanceheap.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+#ifndef GRAPHDISTANCEHEAP_H
+#define GRAPHDISTANCEHEAP_H
+
+#include <QtGlobal>
+#include <vector>
+
+using namespace std;
+
+
+/**
+ * @brief The GraphDistanceHeap class
+ * An indexed 4-ary min-heap of vertex indices 0..N-1 keyed by their tentative
+ * distance, with decrease-key. Every index is in the heap at most once, so
+ * Graph::dijkstra() settles each vertex exactly once, without the stale
+ * entries of a lazy-deletion priority queue.
+ * Ties are broken by the lower index.
+ * The heap only keeps its items and keys; it does not own the distances.
+ */
+class GraphDistanceHeap
+{
+public:
+    GraphDistanceHeap();
+
+    void resize(const int &N);
+
+    void clear();
+
+    bool isEmpty() const { return m_items.empty(); }
+
+    int size() const { return (int) m_items.size(); }
+
+    /** Returns true if the vertex index i is in the heap */
+    bool contains(const int &i) const { return m_pos[i] >= 0; }
+
+    /** Returns the minimum key, the heap must not be empty */
+    qreal topKey() const { return m_keys[0]; }
+
+    void push(const int &i, const qreal &key);
+
+    int pop();
+
+private:
+    bool less(const int &a, const int &b) const {
+        return m_keys[a] < m_keys[b]
+                || ( m_keys[a] == m_keys[b] && m_items[a] < m_items[b] );
+    }
+    void place(const int &slot, const int &item, const qreal &key);
+    void siftUp(int slot);
+    void siftDown(int slot);
+
+    vector<int> m_items;      // heap slots: vertex indices
+    vector<qreal> m_keys;     // heap slots: keys of m_items
+    vector<int> m_pos;        // slot of each vertex index, -1 if not in the heap
+};
+
+#endif // GRAPHDISTANCEHEAP_H
@@ -0,0 +1,336 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphdistribution.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+
+#include "graphdistribution.h"
+
+#include <QtDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+// Significant digits of a class key: mantissas are in [10^5, 10^6)
+static const qint64 DISTRIBUTION_MANTISSA_MIN = 100000;
+static const qint64 DISTRIBUTION_MANTISSA_END = 1000000;
+
+// Offset keeping the decimal exponent of a key nonnegative
+static const int DISTRIBUTION_EXPONENT_OFFSET = 400;
+
+
+
+GraphDistribution::GraphDistribution()
+{
+}
+
+
+
+/**
+ * @brief Removes all classes
+ */
+void GraphDistribution::clear() {
+    m_frequencies.clear();
+}
+
+
+
+/**
+ * @brief Returns the class key of score: its decimal exponent and its
+ * 6-digit mantissa packed into one integer, signed like the score.
+ * Zero (and NaN) map to 0.
+ * Keys compare like the rounded scores they stand for.
+ * @param score
+ * @return
+ */
+qint64 GraphDistribution::classKey(const qreal &score) {
+    if ( score == 0 || std::isnan(score) ) {
+        return 0;
+    }
+    const qreal magnitude = std::fabs(score);
+    if ( std::isinf(magnitude) ) {
+        return ( score > 0 ) ? std::numeric_limits<qint64>::max()
+                             : -std::numeric_limits<qint64>::max();
+    }
+    int exponent = (int) std::floor( std::log10(magnitude) );
+    qint64 mantissa = std::llround( magnitude * std::pow(10.0, 5 - exponent) );
+    // log10 may be off by one near powers of ten, and rounding may carry
+    if ( mantissa >= DISTRIBUTION_MANTISSA_END ) {
+        exponent++;
+        mantissa = std::llround( magnitude * std::pow(10.0, 5 - exponent) );
+    }
+    else if ( mantissa < DISTRIBUTION_MANTISSA_MIN ) {
+        exponent--;
+        mantissa = std::llround( magnitude * std::pow(10.0, 5 - exponent) );
+    }
+    const qint64 key = (qint64) ( exponent + DISTRIBUTION_EXPONENT_OFFSET )
+            * DISTRIBUTION_MANTISSA_END + mantissa;
+    return ( score > 0 ) ? key : -key;
+}
+
+
+
+/**
+ * @brief Returns the (rounded) score a class key stands for
+ * @param key
+ * @return
+ */
+qreal GraphDistribution::classValue(const qint64 &key) {
+    if ( key == 0 ) {
+        return 0;
+    }
+    if ( key == std::numeric_limits<qint64>::max() ) {
+        return std::numeric_limits<qreal>::infinity();
+    }
+    if ( key == -std::numeric_limits<qint64>::max() ) {
+        return -std::numeric_limits<qreal>::infinity();
+    }
+    const qint64 magnitude = ( key > 0 ) ? key : -key;
+    const int exponent = (int) ( magnitude / DISTRIBUTION_MANTISSA_END )
+            - DISTRIBUTION_EXPONENT_OFFSET;
+    const qint64 mantissa = magnitude % DISTRIBUTION_MANTISSA_END;
+    // Divide by an exact power of ten rather than multiply by its inverse
+    const int shift = 5 - exponent;
+    const qreal value = ( shift >= 0 )
+            ? (qreal) mantissa / std::pow(10.0, shift)
+            : (qreal) mantissa * std::pow(10.0, -shift);
+    return ( key > 0 ) ? value : -value;
+}
+
+
+
+/**
+ * @brief Counts score in its class
+ * @param score
+ * @return true if score opened a new class
+ */
+bool GraphDistribution::add(const qreal &score) {
+    const qint64 key = classKey(score);
+    QHash<qint64, int>::iterator it = m_frequencies.find(key);
+    if ( it == m_frequencies.end() ) {
+        m_frequencies.insert(key, 1);
+        return true;
+    }
+    ++it.value();
+    return false;
+}
+
+
+
+/**
+ * @brief Returns how many scores were counted in the class of score
+ * @param score
+ * @return
+ */
+int GraphDistribution::frequency(const qreal &score) const {
+    return m_frequencies.value( classKey(score), 0 );
+}
+
+
+
+/**
+ * @brief Returns the classes ordered from the smallest to the largest value,
+ * with their frequencies
+ * @param values
+ * @param frequencies
+ */
+void GraphDistribution::sorted(QVector<qreal> &values,
+                               QVector<int> &frequencies) const {
+    std::vector<qint64> keys;
+    keys.reserve( m_frequencies.size() );
+    QHash<qint64, int>::const_iterator it;
+    for ( it = m_frequencies.constBegin(); it != m_frequencies.constEnd(); ++it) {
+        keys.push_back( it.key() );
+    }
+    std::sort(keys.begin(), keys.end());
+
+    values.resize( (int) keys.size() );
+    frequencies.resize( (int) keys.size() );
+    for (int i = 0; i < (int) keys.size(); ++i) {
+        values[i] = classValue( keys[i] );
+        frequencies[i] = m_frequencies.value( keys[i] );
+    }
+}
+
+
+
+/**
+ * @brief Returns at most maxPoints of the sorted classes values and
+ * frequencies, as returned by sorted(), chosen with the
+ * Largest-Triangle-Three-Buckets algorithm (Steinarsson, 2013), so that a
+ * line chart of them keeps the shape of the full distribution.
+ * The first and the last class are always kept. The others are split in
+ * maxPoints-2 buckets, and each bucket keeps the class that makes the largest
+ * triangle with the class kept before it and the average of the next bucket.
+ * @param allValues
+ * @param allFrequencies
+ * @param maxPoints
+ * @param values
+ * @param frequencies
+ */
+void GraphDistribution::downsample(const QVector<qreal> &allValues,
+                                   const QVector<int> &allFrequencies,
+                                   const int &maxPoints,
+                                   QVector<qreal> &values,
+                                   QVector<int> &frequencies) {
+    const int N = allValues.size();
+    if ( maxPoints < 3 || N <= maxPoints ) {
+        values = allValues;
+        frequencies = allFrequencies;
+        return;
+    }
+
+    values.clear();
+    frequencies.clear();
+    values.reserve(maxPoints);
+    frequencies.reserve(maxPoints);
+
+    const double every = (double) ( N - 2 ) / ( maxPoints - 2 );
+    int a = 0;
+    values.append( allValues[0] );
+    frequencies.append( allFrequencies[0] );
+
+    for (int b = 0; b < maxPoints - 2; ++b) {
+        // the average of the next bucket
+        const int nextBegin = (int) std::floor( ( b + 1 ) * every ) + 1;
+        const int nextEnd = qMin( (int) std::floor( ( b + 2 ) * every ) + 1, N );
+        double avgX = 0, avgY = 0;
+        for (int i = nextBegin; i < nextEnd; ++i) {
+            avgX += allValues[i];
+            avgY += allFrequencies[i];
+        }
+        const int count = nextEnd - nextBegin;
+        if ( count > 0 ) {
+            avgX /= count;
+            avgY /= count;
+        }
+        else {
+            avgX = allValues[N-1];
+            avgY = allFrequencies[N-1];
+        }
+
+        // the class of this bucket with the largest triangle
+        const int begin = (int) std::floor( b * every ) + 1;
+        const int end = qMin( (int) std::floor( ( b + 1 ) * every ) + 1, N - 1 );
+        const double ax = allValues[a], ay = allFrequencies[a];
+        double maxArea = -1;
+        int chosen = begin;
+        for (int i = begin; i < end; ++i) {
+            const double area = std::fabs( ( ax - avgX ) * ( allFrequencies[i] - ay )
+                                           - ( ax - allValues[i] ) * ( avgY - ay ) );
+            if ( area > maxArea ) {
+                maxArea = area;
+                chosen = i;
+            }
+        }
+        values.append( allValues[chosen] );
+        frequencies.append( allFrequencies[chosen] );
+        a = chosen;
+    }
+
+    values.append( allValues[N-1] );
+    frequencies.append( allFrequencies[N-1] );
+}
+
+
+
+/**
+ * @brief Returns the sorted classes, as returned by sorted(), grouped in at
+ * most bins classes of equal
+ * width, from the smallest to the largest value. Each bin holds the total
+ * frequency of its classes, at the value of its center. Empty bins are left
+ * out. If there are no more classes than bins, the classes are returned as is.
+ * @param allValues
+ * @param allFrequencies
+ * @param bins
+ * @param values
+ * @param frequencies
+ */
+void GraphDistribution::bin(const QVector<qreal> &allValues,
+                            const QVector<int> &allFrequencies,
+                            const int &bins,
+                            QVector<qreal> &values,
+                            QVector<int> &frequencies) {
+    const int N = allValues.size();
+    if ( bins < 1 || N <= bins ) {
+        values = allValues;
+        frequencies = allFrequencies;
+        return;
+    }
+
+    const qreal min = allValues.first();
+    const qreal width = ( allValues.last() - min ) / bins;
+
+    QVector<int> binFrequencies(bins, 0);
+    for (int i = 0; i < N; ++i) {
+        const int bin = ( width > 0 ) ? qMin( (int) ( ( allValues[i] - min ) / width ), bins - 1 )
+                                      : 0;
+        binFrequencies[bin] += allFrequencies[i];
+    }
+
+    values.clear();
+    frequencies.clear();
+    for (int bin = 0; bin < bins; ++bin) {
+        if ( binFrequencies[bin] == 0 ) {
+            continue;
+        }
+        values.append( min + ( bin + 0.5 ) * width );
+        frequencies.append( binFrequencies[bin] );
+    }
+}
+
+
+
+/**
+ * @brief Writes the table to a stream, see GraphResultStore
+ * @param out
+ */
+void GraphDistribution::write(QDataStream &out) const {
+    out << (qint32) m_frequencies.size();
+    for (QHash<qint64, int>::const_iterator it = m_frequencies.constBegin();
+         it != m_frequencies.constEnd(); ++it) {
+        out << it.key() << (qint32) it.value();
+    }
+}
+
+
+
+/**
+ * @brief Reads a table written by write()
+ * @param in
+ */
+void GraphDistribution::read(QDataStream &in) {
+    m_frequencies.clear();
+    qint32 classes = 0, frequency = 0;
+    qint64 key = 0;
+    in >> classes;
+    for (qint32 i = 0; i < classes && in.status() == QDataStream::Ok; ++i) {
+        in >> key >> frequency;
+        m_frequencies.insert(key, frequency);
+    }
+}
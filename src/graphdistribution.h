@@ -0,0 +1,90 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphdistribution.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHDISTRIBUTION_H
+#define GRAPHDISTRIBUTION_H
+
+#include <QtGlobal>
+#include <QDataStream>
+#include <QHash>
+#include <QVector>
+
+
+/**
+ * @brief The GraphDistribution class
+ * A frequency table of the scores of a prominence index, used for the
+ * prominence classes and the distribution charts.
+ * Each score is filed under an integer class key which holds the score
+ * rounded to 6 significant digits, the precision the scores were bucketed
+ * with when they were keyed by QString::number(). Keys are ordered like
+ * the scores they stand for, so the table is sorted by simple integer
+ * comparison.
+ */
+class GraphDistribution
+{
+public:
+    GraphDistribution();
+
+    void clear();
+
+    bool add(const qreal &score);
+
+    /** Returns the number of classes (distinct rounded scores) */
+    int classes() const { return m_frequencies.size(); }
+
+    bool isEmpty() const { return m_frequencies.isEmpty(); }
+
+    int frequency(const qreal &score) const;
+
+    void sorted(QVector<qreal> &values, QVector<int> &frequencies) const;
+
+    static void downsample(const QVector<qreal> &allValues,
+                           const QVector<int> &allFrequencies,
+                           const int &maxPoints,
+                           QVector<qreal> &values,
+                           QVector<int> &frequencies);
+
+    static void bin(const QVector<qreal> &allValues,
+                    const QVector<int> &allFrequencies,
+                    const int &bins,
+                    QVector<qreal> &values,
+                    QVector<int> &frequencies);
+
+    void write(QDataStream &out) const;
+
+    void read(QDataStream &in);
+
+    static qint64 classKey(const qreal &score);
+
+    static qreal classValue(const qint64 &key);
+
+private:
+    QHash<qint64, int> m_frequencies;
+};
+
+#endif // GRAPHDISTRIBUTION_H
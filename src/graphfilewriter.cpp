@@ -0,0 +1,340 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphfilewriter.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphfilewriter.h"
+
+#include <QIODevice>
+#include <QThread>
+#include <QMutexLocker>
+#include <QtDebug>
+
+#include <cstdio>
+#include <cstring>
+
+
+static const int FILE_WRITER_BUFFER_SIZE = 1 << 20;
+static const int FILE_WRITER_MAX_PENDING = 4;
+
+
+/**
+ * @brief The background thread of a GraphFileWriter.
+ * Writes the submitted buffers to the device, in order, and hands them back.
+ */
+class GraphFileWriterThread : public QThread
+{
+public:
+    explicit GraphFileWriterThread(GraphFileWriter *owner) : m_owner(owner) {}
+
+protected:
+    void run() override {
+        QMutexLocker locker(&m_owner->m_mutex);
+        for (;;) {
+            while ( m_owner->m_pending.isEmpty() && !m_owner->m_closing ) {
+                m_owner->m_bufferReady.wait(&m_owner->m_mutex);
+            }
+            if ( m_owner->m_pending.isEmpty() ) {
+                return;
+            }
+            QByteArray buffer = m_owner->m_pending.dequeue();
+            const bool failed = !m_owner->m_error.isEmpty();
+            locker.unlock();
+
+            QString error;
+            if ( !failed
+                 && m_owner->m_device->write( buffer.constData(), buffer.size() ) != buffer.size() ) {
+                error = m_owner->m_device->errorString();
+                if ( error.isEmpty() ) {
+                    error = QObject::tr("Could not write to the file.");
+                }
+            }
+
+            locker.relock();
+            if ( !error.isEmpty() ) {
+                m_owner->m_error = error;
+            }
+            m_owner->m_free.enqueue(buffer);
+            m_owner->m_bufferWritten.wakeAll();
+        }
+    }
+
+private:
+    GraphFileWriter *m_owner;
+};
+
+
+
+/**
+ * @brief Starts a writer on the open device.
+ * @param device
+ */
+GraphFileWriter::GraphFileWriter(QIODevice *device) :
+    m_device(device),
+    m_buffer(FILE_WRITER_BUFFER_SIZE, Qt::Uninitialized),
+    m_used(0),
+    m_finished(false),
+    m_closing(false)
+{
+    m_thread = new GraphFileWriterThread(this);
+    m_thread->start();
+}
+
+
+GraphFileWriter::~GraphFileWriter() {
+    finish();
+}
+
+
+
+/**
+ * @brief Writes what is left, and waits for the background thread to end.
+ * Call it before closing the device.
+ * @return false if any write failed
+ */
+bool GraphFileWriter::finish() {
+    if ( !m_finished ) {
+        m_finished = true;
+        bufferSubmit();
+        {
+            QMutexLocker locker(&m_mutex);
+            m_closing = true;
+            m_bufferReady.wakeAll();
+        }
+        m_thread->wait();
+        delete m_thread;
+        m_thread = 0;
+    }
+    QMutexLocker locker(&m_mutex);
+    if ( !m_error.isEmpty() ) {
+        qDebug() << "GraphFileWriter::finish() - error:" << m_error;
+    }
+    return m_error.isEmpty();
+}
+
+
+QString GraphFileWriter::errorString() const {
+    QMutexLocker locker(&m_mutex);
+    return m_error;
+}
+
+
+
+/**
+ * @brief Returns room for size more bytes in the buffer, submitting the
+ * buffer if it is full. The caller must fill them.
+ * @param size
+ * @return
+ */
+char *GraphFileWriter::reserve(const int &size) {
+    if ( m_used + size > m_buffer.size() ) {
+        bufferSubmit();
+        if ( size > m_buffer.size() ) {
+            m_buffer.resize(size);
+        }
+    }
+    char *room = m_buffer.data() + m_used;
+    m_used += size;
+    return room;
+}
+
+
+/**
+ * @brief Hands the used part of the buffer to the background thread, and
+ * takes a written buffer back, waiting if too many are pending.
+ */
+void GraphFileWriter::bufferSubmit() {
+    if ( m_used == 0 ) {
+        return;
+    }
+    m_buffer.resize(m_used);
+    QMutexLocker locker(&m_mutex);
+    while ( m_pending.size() >= FILE_WRITER_MAX_PENDING ) {
+        m_bufferWritten.wait(&m_mutex);
+    }
+    m_pending.enqueue(m_buffer);
+    m_bufferReady.wakeOne();
+    if ( !m_free.isEmpty() ) {
+        m_buffer = m_free.dequeue();
+    }
+    else {
+        m_buffer = QByteArray();
+    }
+    locker.unlock();
+    m_buffer.resize( qMax( m_buffer.size(), FILE_WRITER_BUFFER_SIZE ) );
+    m_used = 0;
+}
+
+
+
+void GraphFileWriter::write(const char *data, const int &size) {
+    if ( size > 0 ) {
+        std::memcpy( reserve(size), data, size );
+    }
+}
+
+
+/**
+ * @brief Writes data count times, i.e. the zeros of a dense matrix row.
+ * @param data
+ * @param size
+ * @param count
+ */
+void GraphFileWriter::writeRepeated(const char *data, const int &size, int count) {
+    const int perBlock = qMax( 1, FILE_WRITER_BUFFER_SIZE / ( 4 * qMax(1, size) ) );
+    while ( count > 0 ) {
+        const int block = qMin( count, perBlock );
+        char *room = reserve( block * size );
+        for (int k = 0; k < block; ++k) {
+            std::memcpy( room + k * size, data, size );
+        }
+        count -= block;
+    }
+}
+
+
+
+GraphFileWriter &GraphFileWriter::operator<<(const char *text) {
+    write( text, (int) std::strlen(text) );
+    return *this;
+}
+
+
+GraphFileWriter &GraphFileWriter::operator<<(const char &c) {
+    *reserve(1) = c;
+    return *this;
+}
+
+
+GraphFileWriter &GraphFileWriter::operator<<(const QByteArray &text) {
+    write( text.constData(), text.size() );
+    return *this;
+}
+
+
+/**
+ * @brief Writes text encoded in UTF-8, straight into the buffer.
+ * @param text
+ * @return
+ */
+GraphFileWriter &GraphFileWriter::operator<<(const QString &text) {
+    const int size = text.size();
+    const QChar *data = text.constData();
+    // At most 3 bytes per UTF-16 unit; a surrogate pair takes 4 bytes for 2 units.
+    char *room = reserve( 3 * size );
+    char *out = room;
+    for (int i = 0; i < size; ++i) {
+        const ushort u = data[i].unicode();
+        if ( u < 0x80 ) {
+            *out++ = (char) u;
+        }
+        else if ( u < 0x800 ) {
+            *out++ = (char) ( 0xc0 | ( u >> 6 ) );
+            *out++ = (char) ( 0x80 | ( u & 0x3f ) );
+        }
+        else if ( QChar::isHighSurrogate(u) && i + 1 < size
+                  && QChar::isLowSurrogate( data[i+1].unicode() ) ) {
+            const uint code = QChar::surrogateToUcs4( u, data[++i].unicode() );
+            *out++ = (char) ( 0xf0 | ( code >> 18 ) );
+            *out++ = (char) ( 0x80 | ( ( code >> 12 ) & 0x3f ) );
+            *out++ = (char) ( 0x80 | ( ( code >> 6 ) & 0x3f ) );
+            *out++ = (char) ( 0x80 | ( code & 0x3f ) );
+        }
+        else if ( QChar::isSurrogate(u) ) {
+            // unpaired surrogate: the replacement character, as QString::toUtf8()
+            *out++ = (char) 0xef;
+            *out++ = (char) 0xbf;
+            *out++ = (char) 0xbd;
+        }
+        else {
+            *out++ = (char) ( 0xe0 | ( u >> 12 ) );
+            *out++ = (char) ( 0x80 | ( ( u >> 6 ) & 0x3f ) );
+            *out++ = (char) ( 0x80 | ( u & 0x3f ) );
+        }
+    }
+    // give back the unused room
+    m_used -= (int) ( ( room + 3 * size ) - out );
+    return *this;
+}
+
+
+GraphFileWriter &GraphFileWriter::operator<<(const int &value) {
+    const int n = formatNumber( reserve(12), value );
+    m_used -= 12 - n;
+    return *this;
+}
+
+
+GraphFileWriter &GraphFileWriter::operator<<(const qreal &value) {
+    const int n = formatNumber( reserve(32), value );
+    m_used -= 32 - n;
+    return *this;
+}
+
+
+
+/**
+ * @brief Formats value in decimal into out, which must have room for 12 bytes.
+ * @param out
+ * @param value
+ * @return the number of bytes written
+ */
+int GraphFileWriter::formatNumber(char *out, const int &value) {
+    char digits[12];
+    int n = 0, size = 0;
+    // negate in unsigned arithmetic, so INT_MIN works too
+    uint v = ( value < 0 ) ? 0u - (uint) value : (uint) value;
+    do {
+        digits[n++] = (char) ( '0' + v % 10 );
+        v /= 10;
+    } while ( v > 0 );
+    if ( value < 0 ) {
+        out[size++] = '-';
+    }
+    while ( n > 0 ) {
+        out[size++] = digits[--n];
+    }
+    return size;
+}
+
+
+/**
+ * @brief Formats a real number with 6 significant digits, as QTextStream,
+ * into out, which must have room for 32 bytes.
+ * The decimal point is always '.', whatever the C locale.
+ * @param out
+ * @param value
+ * @return the number of bytes written
+ */
+int GraphFileWriter::formatNumber(char *out, const qreal &value) {
+    const int n = qMin( 31, std::snprintf( out, 32, "%g", value ) );
+    for (int k = 0; k < n; ++k) {
+        if ( out[k] == ',' ) {
+            out[k] = '.';
+        }
+    }
+    return n;
+}
@@ -0,0 +1,98 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphfilewriter.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHFILEWRITER_H
+#define GRAPHFILEWRITER_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+
+class QIODevice;
+class GraphFileWriterThread;
+
+
+/**
+ * @brief The GraphFileWriter class
+ * A buffered UTF-8 text writer for the network and matrix files, used in place
+ * of QTextStream by the Graph::graphSaveTo*() methods.
+ * Text and numbers are formatted straight into a large buffer, without
+ * temporary strings. Full buffers are written to the device by a background
+ * thread, and recycled, so formatting runs in parallel with the writing
+ * (and the compression, if the device is a CompressedFile).
+ * Numbers are formatted as QTextStream does by default, i.e. reals with 6
+ * significant digits.
+ * The device must stay open, and must not be used otherwise, until finish().
+ */
+class GraphFileWriter
+{
+public:
+    explicit GraphFileWriter(QIODevice *device);
+    ~GraphFileWriter();
+
+    GraphFileWriter &operator<<(const char *text);
+    GraphFileWriter &operator<<(const char &c);
+    GraphFileWriter &operator<<(const QByteArray &text);
+    GraphFileWriter &operator<<(const QString &text);
+    GraphFileWriter &operator<<(const int &value);
+    GraphFileWriter &operator<<(const qreal &value);
+
+    void write(const char *data, const int &size);
+    void writeRepeated(const char *data, const int &size, int count);
+
+    bool finish();
+    QString errorString() const;
+
+    static int formatNumber(char *out, const int &value);
+    static int formatNumber(char *out, const qreal &value);
+
+private:
+    friend class GraphFileWriterThread;
+
+    char *reserve(const int &size);
+    void bufferSubmit();
+
+    QIODevice *m_device;
+    QByteArray m_buffer;
+    int m_used;
+    bool m_finished;
+
+    GraphFileWriterThread *m_thread;
+    mutable QMutex m_mutex;
+    QWaitCondition m_bufferReady;
+    QWaitCondition m_bufferWritten;
+    QQueue<QByteArray> m_pending;
+    QQueue<QByteArray> m_free;
+    bool m_closing;
+    QString m_error;
+};
+
+#endif // GRAPHFILEWRITER_H
@@ -79,6 +79,7 @@ GraphicsEdge::GraphicsEdge(GraphicsWidget *gw,
     m_offsetFromTargetNode=target->size()+m_minOffsetFromNode;  // offsets edge from the centre of target node
 
     m_arrowSize=4;                   // controls the width of the edge arrow
+    m_relation=0;                    // the relation of the edge, set by GraphicsWidget
 
     m_weight = weight ;              // saves the weight/value of this edge
 
@@ -642,6 +643,14 @@ void GraphicsEdge::paint(QPainter *painter, const QStyleOptionGraphicsItem *opti
         setZValue(ZValueEdge);
         setState(EDGE_STATE_REGULAR);
     }
+    // Too short on screen for arrows and curves: a cosmetic hairline
+    const qreal lod = option->levelOfDetailFromTransform( painter->worldTransform() );
+    if ( source != target && line_length * lod < LOD_EDGE_MIN_LENGTH ) {
+        painter->setPen( QPen( m_color, 0 ) );
+        painter->drawLine( sourcePoint, targetPoint );
+        return;
+    }
+
     // set painter pen to correct edge pen
     painter->setPen(pen());
 
@@ -82,6 +82,9 @@ public:
     int sourceNodeNumber();
     int targetNodeNumber();
 
+    void setRelation(const int &relation) { m_relation = relation; }
+    int relation() const { return m_relation; }
+
     qreal dx() const;
 
     qreal dy() const;
@@ -173,6 +176,7 @@ private:
     int m_edgeDirType;
 
     qreal angle, line_length, line_dx, line_dy;
+    int m_relation;
 
     bool m_Bezier, m_drawArrows, m_drawWeightNumber;
     bool m_drawLabel, m_hoverHighlighting;
@@ -45,6 +45,12 @@ public:
     enum { Type = UserType + 6 };
     int type() const { return Type; }
 
+    void paint(QPainter *painter,
+
+               const QStyleOptionGraphicsItem *option,
+
+               QWidget *widget);
+
     ~GraphicsEdgeLabel();
 private:
 };
@@ -0,0 +1,387 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphicsedgelayer.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+#include "graphicsedgelayer.h"
+
+#include <QPainter>
+#include <QPen>
+#include <QtMath>
+#include <QDebug>
+
+#include "graphicsnode.h"
+#include "graphicsedge.h"   // ZValueEdge
+#include "global.h"
+
+SOCNETV_USE_NAMESPACE
+
+
+GraphicsEdgeLayer::GraphicsEdgeLayer() :
+    m_relation(0),
+    m_dirty(true),
+    m_cellSize(1),
+    m_gridColumns(0),
+    m_gridRows(0)
+{
+    setZValue(ZValueEdge);
+    setAcceptHoverEvents(false);
+    qDebug() << "GraphicsEdgeLayer() - initialized";
+}
+
+
+
+/**
+ * @brief Removes all edges
+ */
+void GraphicsEdgeLayer::clear() {
+    m_edges.clear();
+    m_index.clear();
+    invalidate();
+}
+
+
+
+/**
+ * @brief Sets the relation whose edges are drawn
+ * @param relation
+ */
+void GraphicsEdgeLayer::setRelation(const int &relation) {
+    m_relation = relation;
+    invalidate();
+}
+
+
+
+/**
+ * @brief Adds an edge, or replaces the edge with the same key
+ */
+void GraphicsEdgeLayer::addEdge(const quint64 &key,
+                                const int &relation,
+                                GraphicsNode *source,
+                                GraphicsNode *target,
+                                const QString &color,
+                                const qreal &weight,
+                                const int &type) {
+    Edge edge = { key, relation, source, target, QColor(color), weight, type, true };
+    QHash<quint64, int>::const_iterator it = m_index.constFind(key);
+    if ( it != m_index.constEnd() ) {
+        m_edges[ it.value() ] = edge;
+    }
+    else {
+        m_index.insert( key, (int) m_edges.size() );
+        m_edges.push_back(edge);
+    }
+    invalidate();
+}
+
+
+
+/**
+ * @brief Removes the edge with the given key. Returns false if there is none.
+ */
+bool GraphicsEdgeLayer::removeEdge(const quint64 &key) {
+    QHash<quint64, int>::iterator it = m_index.find(key);
+    if ( it == m_index.end() ) {
+        return false;
+    }
+    const int pos = it.value();
+    m_index.erase(it);
+    if ( pos != (int) m_edges.size() - 1 ) {
+        m_edges[pos] = m_edges.back();
+        m_index[ m_edges[pos].key ] = pos;
+    }
+    m_edges.pop_back();
+    invalidate();
+    return true;
+}
+
+
+
+/**
+ * @brief Removes every edge from or to node, before the node is deleted.
+ */
+void GraphicsEdgeLayer::removeNodeEdges(GraphicsNode *node) {
+    for (int pos = (int) m_edges.size() - 1; pos >= 0; --pos) {
+        if ( m_edges[pos].source == node || m_edges[pos].target == node ) {
+            removeEdge( m_edges[pos].key );
+        }
+    }
+}
+
+
+
+int GraphicsEdgeLayer::directionType(const quint64 &key) const {
+    QHash<quint64, int>::const_iterator it = m_index.constFind(key);
+    return ( it != m_index.constEnd() ) ? m_edges[ it.value() ].type : 0;
+}
+
+
+bool GraphicsEdgeLayer::setDirectionType(const quint64 &key, const int &type) {
+    QHash<quint64, int>::const_iterator it = m_index.constFind(key);
+    if ( it == m_index.constEnd() ) {
+        return false;
+    }
+    m_edges[ it.value() ].type = type;
+    return true;
+}
+
+
+bool GraphicsEdgeLayer::setColor(const quint64 &key, const QString &color) {
+    QHash<quint64, int>::const_iterator it = m_index.constFind(key);
+    if ( it == m_index.constEnd() ) {
+        return false;
+    }
+    m_edges[ it.value() ].color = QColor(color);
+    invalidate();
+    return true;
+}
+
+
+bool GraphicsEdgeLayer::setWeight(const quint64 &key, const qreal &weight) {
+    QHash<quint64, int>::const_iterator it = m_index.constFind(key);
+    if ( it == m_index.constEnd() ) {
+        return false;
+    }
+    m_edges[ it.value() ].weight = weight;
+    return true;
+}
+
+
+bool GraphicsEdgeLayer::setEdgeVisible(const quint64 &key, const bool &toggle) {
+    QHash<quint64, int>::const_iterator it = m_index.constFind(key);
+    if ( it == m_index.constEnd() ) {
+        return false;
+    }
+    m_edges[ it.value() ].visible = toggle;
+    invalidate();
+    return true;
+}
+
+
+
+/**
+ * @brief Called when nodes have moved, to redraw the edges at their new ends.
+ */
+void GraphicsEdgeLayer::nodesMoved() {
+    invalidate();
+}
+
+
+
+/**
+ * @brief Marks the layer for a rebuild at the next paint or lookup.
+ * The geometry change is announced once per rebuild, since announcing it
+ * asks for the bounding rect, and thus for a rebuild.
+ */
+void GraphicsEdgeLayer::invalidate() {
+    if ( ! m_dirty ) {
+        prepareGeometryChange();
+        m_dirty = true;
+    }
+    update();
+}
+
+
+
+/**
+ * @brief Rebuilds the bounds, the line batches and the grid of the visible
+ * edges of the current relation.
+ * Every edge is entered in the grid cells its segment passes through,
+ * walking it in steps of half a cell.
+ */
+void GraphicsEdgeLayer::rebuild() const {
+
+    m_dirty = false;
+    m_batchColors.clear();
+    m_batches.clear();
+    m_gridOffsets.clear();
+    m_gridEdges.clear();
+    m_gridColumns = m_gridRows = 0;
+
+    QHash<QRgb, int> batchIndex;
+    vector<int> active;
+    qreal minX = 0, minY = 0, maxX = 0, maxY = 0;
+
+    for (size_t pos = 0; pos < m_edges.size(); ++pos) {
+        const Edge &edge = m_edges[pos];
+        if ( ! edge.visible || edge.relation != m_relation
+             || ! edge.source->isVisible() || ! edge.target->isVisible() ) {
+            continue;
+        }
+        const QPointF s = edge.source->pos(), t = edge.target->pos();
+        if ( active.empty() ) {
+            minX = maxX = s.x();
+            minY = maxY = s.y();
+        }
+        minX = qMin( minX, qMin( s.x(), t.x() ) );
+        maxX = qMax( maxX, qMax( s.x(), t.x() ) );
+        minY = qMin( minY, qMin( s.y(), t.y() ) );
+        maxY = qMax( maxY, qMax( s.y(), t.y() ) );
+
+        int batch = batchIndex.value( edge.color.rgba(), -1 );
+        if ( batch < 0 ) {
+            batch = m_batches.size();
+            batchIndex.insert( edge.color.rgba(), batch );
+            m_batchColors << edge.color;
+            m_batches << QVector<QLineF>();
+        }
+        m_batches[batch] << QLineF(s, t);
+        active.push_back( (int) pos );
+    }
+
+    if ( active.empty() ) {
+        m_bounds = QRectF();
+        return;
+    }
+
+    m_bounds = QRectF( QPointF(minX, minY), QPointF(maxX, maxY) ).adjusted(-1, -1, 1, 1);
+
+    // About one cell per edge
+    const qreal side = qMax( m_bounds.width(), m_bounds.height() );
+    m_cellSize = qMax( (qreal) 1, side / qSqrt( (qreal) active.size() ) );
+    m_gridColumns = (int) ( m_bounds.width() / m_cellSize ) + 1;
+    m_gridRows = (int) ( m_bounds.height() / m_cellSize ) + 1;
+
+    vector< pair<int,int> > entries;   // (cell, edge)
+    entries.reserve( active.size() * 2 );
+    for (const int &pos : active) {
+        const QPointF s = m_edges[pos].source->pos(), t = m_edges[pos].target->pos();
+        const qreal length = QLineF(s, t).length();
+        const int steps = (int) ( 2.0 * length / m_cellSize ) + 1;
+        int lastCell = -1;
+        for (int k = 0; k <= steps; ++k) {
+            const QPointF p = s + ( t - s ) * ( (qreal) k / steps );
+            const int column = qBound( 0, (int) ( ( p.x() - m_bounds.left() ) / m_cellSize ), m_gridColumns - 1 );
+            const int row = qBound( 0, (int) ( ( p.y() - m_bounds.top() ) / m_cellSize ), m_gridRows - 1 );
+            const int cell = row * m_gridColumns + column;
+            if ( cell != lastCell ) {
+                entries.push_back( make_pair(cell, pos) );
+                lastCell = cell;
+            }
+        }
+    }
+
+    m_gridOffsets.assign( m_gridColumns * m_gridRows + 1, 0 );
+    for (const pair<int,int> &entry : entries) {
+        m_gridOffsets[ entry.first + 1 ]++;
+    }
+    for (size_t c = 1; c < m_gridOffsets.size(); ++c) {
+        m_gridOffsets[c] += m_gridOffsets[c-1];
+    }
+    m_gridEdges.resize( entries.size() );
+    vector<int> next( m_gridOffsets.begin(), m_gridOffsets.end() - 1 );
+    for (const pair<int,int> &entry : entries) {
+        m_gridEdges[ next[ entry.first ]++ ] = entry.second;
+    }
+}
+
+
+
+/**
+ * @brief Finds the visible edge of the current relation nearest to p, within
+ * tolerance, and returns its source and target node numbers.
+ * @param p the point, in scene coordinates
+ * @param tolerance
+ * @param source
+ * @param target
+ * @return true if an edge was found
+ */
+bool GraphicsEdgeLayer::edgeAt(const QPointF &p, const qreal &tolerance,
+                               int &source, int &target) const {
+    if ( m_dirty ) {
+        rebuild();
+    }
+    if ( m_gridColumns == 0 || ! m_bounds.adjusted(-tolerance, -tolerance,
+                                                   tolerance, tolerance).contains(p) ) {
+        return false;
+    }
+
+    const int firstColumn = qBound( 0, (int) ( ( p.x() - tolerance - m_bounds.left() ) / m_cellSize ), m_gridColumns - 1 );
+    const int lastColumn  = qBound( 0, (int) ( ( p.x() + tolerance - m_bounds.left() ) / m_cellSize ), m_gridColumns - 1 );
+    const int firstRow    = qBound( 0, (int) ( ( p.y() - tolerance - m_bounds.top() ) / m_cellSize ), m_gridRows - 1 );
+    const int lastRow     = qBound( 0, (int) ( ( p.y() + tolerance - m_bounds.top() ) / m_cellSize ), m_gridRows - 1 );
+
+    int nearest = -1;
+    qreal nearestDistance = tolerance;
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const int cell = row * m_gridColumns + column;
+            for (int e = m_gridOffsets[cell]; e < m_gridOffsets[cell+1]; ++e) {
+                const Edge &edge = m_edges[ m_gridEdges[e] ];
+                const QPointF s = edge.source->pos(), t = edge.target->pos();
+                const QPointF st = t - s;
+                const qreal length2 = st.x() * st.x() + st.y() * st.y();
+                qreal u = 0;
+                if ( length2 > 0 ) {
+                    u = qBound( (qreal) 0, QPointF::dotProduct( p - s, st ) / length2, (qreal) 1 );
+                }
+                const qreal distance = QLineF( p, s + st * u ).length();
+                if ( distance <= nearestDistance ) {
+                    nearest = m_gridEdges[e];
+                    nearestDistance = distance;
+                }
+            }
+        }
+    }
+
+    if ( nearest < 0 ) {
+        return false;
+    }
+    source = m_edges[nearest].source->nodeNumber();
+    target = m_edges[nearest].target->nodeNumber();
+    return true;
+}
+
+
+
+QRectF GraphicsEdgeLayer::boundingRect() const {
+    if ( m_dirty ) {
+        rebuild();
+    }
+    return m_bounds;
+}
+
+
+
+/**
+ * @brief The layer has no shape, thus it is never the item under the mouse.
+ */
+QPainterPath GraphicsEdgeLayer::shape() const {
+    return QPainterPath();
+}
+
+
+
+void GraphicsEdgeLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *) {
+    if ( m_dirty ) {
+        rebuild();
+    }
+    for (int b = 0; b < m_batches.size(); ++b) {
+        painter->setPen( QPen( m_batchColors[b], 0 ) );
+        painter->drawLines( m_batches[b] );
+    }
+}
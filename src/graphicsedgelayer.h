@@ -0,0 +1,128 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphicsedgelayer.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+#ifndef GRAPHICSEDGELAYER_H
+#define GRAPHICSEDGELAYER_H
+
+
+#include <QGraphicsItem>
+#include <QColor>
+#include <QHash>
+#include <QVector>
+#include <QLineF>
+#include <vector>
+
+class GraphicsNode;
+
+using namespace std;
+
+static const int TypeEdgeLayer = QGraphicsItem::UserType+8;
+
+
+/**
+ * @brief The GraphicsEdgeLayer class
+ * A single scene item that draws all edges of the current relation, for very
+ * large networks, instead of one GraphicsEdge item per edge.
+ * Edges are kept by the keys of GraphicsWidget::createEdgeKey() and
+ * read the positions of their GraphicsNode ends when painted. They are drawn
+ * as hairlines, without arrows, weights or labels, in one batch of lines
+ * per color; with an OpenGL viewport the batches go to the GL paint engine.
+ * The item has an empty shape, so clicks go through it; edgeAt() finds the
+ * edge near a point through a uniform grid of the edge segments.
+ */
+class GraphicsEdgeLayer : public QGraphicsItem {
+
+public:
+    GraphicsEdgeLayer();
+
+    enum { Type = UserType + 8 };
+    int type() const { return Type; }
+
+    void clear();
+
+    void setRelation(const int &relation);
+
+    void addEdge(const quint64 &key,
+                 const int &relation,
+                 GraphicsNode *source,
+                 GraphicsNode *target,
+                 const QString &color,
+                 const qreal &weight,
+                 const int &type);
+
+    bool removeEdge(const quint64 &key);
+
+    void removeNodeEdges(GraphicsNode *node);
+
+    bool contains(const quint64 &key) const { return m_index.contains(key); }
+
+    int directionType(const quint64 &key) const;
+    bool setDirectionType(const quint64 &key, const int &type);
+    bool setColor(const quint64 &key, const QString &color);
+    bool setWeight(const quint64 &key, const qreal &weight);
+    bool setEdgeVisible(const quint64 &key, const bool &toggle);
+
+    void nodesMoved();
+
+    bool edgeAt(const QPointF &p, const qreal &tolerance,
+                int &source, int &target) const;
+
+    QRectF boundingRect() const;
+    QPainterPath shape() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+
+private:
+    struct Edge {
+        quint64 key;
+        int relation;
+        GraphicsNode *source;
+        GraphicsNode *target;
+        QColor color;
+        qreal weight;
+        int type;
+        bool visible;
+    };
+
+    void invalidate();
+    void rebuild() const;
+
+    int m_relation;
+    vector<Edge> m_edges;
+    QHash<quint64, int> m_index;    // key -> position in m_edges
+
+    // Rebuilt lazily, when edges or nodes change
+    mutable bool m_dirty;
+    mutable QRectF m_bounds;
+    mutable QVector<QColor> m_batchColors;
+    mutable QVector< QVector<QLineF> > m_batches;
+    mutable qreal m_cellSize;
+    mutable int m_gridColumns, m_gridRows;
+    mutable vector<int> m_gridOffsets;   // cell -> first entry in m_gridEdges
+    mutable vector<int> m_gridEdges;     // positions in m_edges, grouped by cell
+};
+
+#endif // GRAPHICSEDGELAYER_H
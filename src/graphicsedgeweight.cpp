@@ -29,6 +29,9 @@
 #include "graphicsedge.h"
 #include <QDebug>
 #include <QFont>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include "global.h"
 
 
 GraphicsEdgeWeight::GraphicsEdgeWeight( GraphicsEdge *link , int size, QString labelText)
@@ -42,6 +45,21 @@ GraphicsEdgeWeight::GraphicsEdgeWeight( GraphicsEdge *link , int size, QString l
 }
 
 
+/**
+ * @brief Paints the text only if it is large enough to be read at the
+ * current zoom level of the view.
+ */
+void GraphicsEdgeWeight::paint(QPainter *painter,
+                               const QStyleOptionGraphicsItem *option,
+                               QWidget *widget) {
+    const qreal lod = option->levelOfDetailFromTransform( painter->worldTransform() );
+    if ( font().pointSizeF() * lod < LOD_TEXT_MIN_SIZE ) {
+        return;
+    }
+    QGraphicsTextItem::paint(painter, option, widget);
+}
+
+
 GraphicsEdgeWeight::~GraphicsEdgeWeight()
 {
 }
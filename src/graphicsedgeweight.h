@@ -45,6 +45,12 @@ public:
     enum { Type = UserType + 5 };
     int type() const { return Type; }
 
+    void paint(QPainter *painter,
+
+               const QStyleOptionGraphicsItem *option,
+
+               QWidget *widget);
+
     ~GraphicsEdgeWeight();
 private:
 };
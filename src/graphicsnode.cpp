@@ -38,6 +38,7 @@
 #include "graphicsedge.h"
 #include "graphicsnodelabel.h"
 #include "graphicsnodenumber.h"
+#include "global.h"
 
 
 
@@ -347,6 +348,14 @@ void GraphicsNode::paint(QPainter *painter, const QStyleOptionGraphicsItem *opti
         setZValue(ZValueNode);
     }
 
+    const qreal lod = option->levelOfDetailFromTransform( painter->worldTransform() );
+
+    // Too small on screen to tell shapes apart: a plain square is enough
+    if ( 2 * m_size * lod < LOD_NODE_MIN_SIZE ) {
+        painter->fillRect( QRectF(-m_size, -m_size, 2*m_size, 2*m_size), painter->brush() );
+        return;
+    }
+
     if (m_shape == "custom") {
         QPixmap pix(m_iconPath);
         painter->drawPixmap(-m_size, -m_size, 2*m_size, 2*m_size, pix);
@@ -369,7 +378,8 @@ void GraphicsNode::paint(QPainter *painter, const QStyleOptionGraphicsItem *opti
     }
 
     //@TODO FIX NUMBER SIZE WHEN TOGGLING IN/OUT OF NODE SHAPE
-    if (m_hasNumberInside && m_hasNumber) {
+    if (m_hasNumberInside && m_hasNumber &&
+            ( (m_numSize)? m_numSize : 0.66*m_size ) * lod >= LOD_TEXT_MIN_SIZE ) {
         // m_path->setFillRule(Qt::WindingFill);
         painter->setPen(QPen(QColor(m_numColor), 0));
         if (m_num > 999) {
@@ -414,6 +424,7 @@ QVariant GraphicsNode::itemChange(GraphicsItemChange change, const QVariant &val
             edge->adjust();
         foreach (GraphicsEdge *edge, outEdgeList) //Move each outEdge of this node
             edge->adjust();
+        graphicsWidget->nodeMoved();   // and the edges of the edge layer, if any
         //Move its graphic number
         if ( m_hasNumber )
         {
@@ -556,6 +567,7 @@ void GraphicsNode::addLabel ()  {
     m_label = new  GraphicsNodeLabel (this, m_labelText, m_labelSize);
     m_label -> setDefaultTextColor (m_labelColor);
     m_label -> setPos( m_size, m_labelDistance+m_size);
+    m_label -> setFlag( ItemHasNoContents, flags() & ItemHasNoContents );
     m_hasLabel = true;
 }
 
@@ -666,6 +678,7 @@ void GraphicsNode::addNumber () {
     m_number= new  GraphicsNodeNumber ( this, QString::number(m_num), m_numSize);
     m_number -> setDefaultTextColor (m_numColor);
     m_number -> setPos(m_size+m_numberDistance, 0);
+    m_number -> setFlag( ItemHasNoContents, flags() & ItemHasNoContents );
 
 }
 
@@ -776,6 +789,22 @@ void GraphicsNode::setNumberDistance(const int &distance) {
 
 
 
+/**
+ * @brief Toggles painting by the GraphicsNodeLayer: the node and its number and
+ * label items keep taking part in hit tests, but paint nothing themselves.
+ * @param toggle
+ */
+void GraphicsNode::setPaintedByLayer(const bool &toggle) {
+    setFlag(ItemHasNoContents, toggle);
+    foreach (QGraphicsItem *child, childItems()) {
+        child->setFlag(ItemHasNoContents, toggle);
+    }
+}
+
+
+
+
+
 GraphicsNode::~GraphicsNode(){
     qDebug() << "GraphicsNode::~GraphicsNode() - self-destructing node "<< nodeNumber()
                 << "inEdgeList.size = " << inEdgeList.size()
@@ -102,6 +102,7 @@ public:
 
     void setShape (const QString, const QString &iconPath=QString());
     QString nodeShape() {return m_shape;}
+    QString iconPath() const {return m_iconPath;}
 
     void setColor(const QString &colorStr);
     void setColor(QColor color);
@@ -125,6 +126,11 @@ public:
     void setNumberSize(const int &size);
     void setNumberDistance(const int &distance);
     void setNumberColor(const QString &color);
+    bool numberInside() const { return m_hasNumber && m_hasNumberInside; }
+    int numberSize() const { return m_numSize; }
+    QString numberColor() const { return m_numColor; }
+
+    void setPaintedByLayer(const bool &toggle);
 
     void setEdgeHighLighting(const bool &toggle) ;
 
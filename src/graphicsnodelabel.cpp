@@ -29,6 +29,9 @@
 #include "graphicsnode.h"
 #include <QFont>
 #include <QDebug>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include "global.h"
 
 GraphicsNodeLabel::GraphicsNodeLabel(GraphicsNode *jim , const QString &text,  const int &size) :
     QGraphicsTextItem(jim) {
@@ -54,5 +57,20 @@ void GraphicsNodeLabel::removeRefs(){
 }
 
 
+/**
+ * @brief Paints the text only if it is large enough to be read at the
+ * current zoom level of the view.
+ */
+void GraphicsNodeLabel::paint(QPainter *painter,
+                              const QStyleOptionGraphicsItem *option,
+                              QWidget *widget) {
+    const qreal lod = option->levelOfDetailFromTransform( painter->worldTransform() );
+    if ( font().pointSizeF() * lod < LOD_TEXT_MIN_SIZE ) {
+        return;
+    }
+    QGraphicsTextItem::paint(painter, option, widget);
+}
+
+
 GraphicsNodeLabel::~GraphicsNodeLabel(){
 }
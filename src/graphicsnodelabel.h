@@ -42,6 +42,9 @@ public:
  	enum { Type = UserType + 4 };
 	int type() const { return Type; }
     void setSize(const int &size);
+    void paint(QPainter *painter,
+               const QStyleOptionGraphicsItem *option,
+               QWidget *widget);
     ~GraphicsNodeLabel();
 	GraphicsNode* node() { return source; }
 private:
@@ -0,0 +1,432 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphicsnodelayer.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphicsnodelayer.h"
+
+#include <QStyleOptionGraphicsItem>
+#include <QGraphicsTextItem>
+#include <QTextDocument>
+#include <QFontMetricsF>
+#include <QStringBuilder>
+#include <QtMath>
+#include <QDebug>
+
+#include "graphicsnode.h"
+#include "graphicsnodenumber.h"
+#include "graphicsnodelabel.h"
+#include "global.h"
+
+SOCNETV_USE_NAMESPACE
+
+
+// Zoom levels are rounded to powers of two, from 1/4 to 8
+static const int NODE_LAYER_MIN_ZOOM_EXP = -2;
+static const int NODE_LAYER_MAX_ZOOM_EXP = 3;
+static const int NODE_LAYER_ATLAS_WIDTH = 1024;
+
+
+GraphicsNodeLayer::GraphicsNodeLayer(const QHash<int, GraphicsNode*> *nodes) :
+    m_nodes(nodes),
+    m_dirty(true)
+{
+    setZValue(ZValueNode);
+    setAcceptHoverEvents(false);
+    setFlag(ItemUsesExtendedStyleOption);
+    qDebug() << "GraphicsNodeLayer() - initialized";
+}
+
+
+
+/**
+ * @brief Called when nodes were added, removed or changed their position or
+ * appearance. Marks the layer for a rebuild at the next paint.
+ */
+void GraphicsNodeLayer::nodesChanged() {
+    if ( ! m_dirty ) {
+        prepareGeometryChange();
+        m_dirty = true;
+    }
+    update();
+}
+
+
+
+/**
+ * @brief Returns the id of the appearance of node, registering it if new.
+ */
+int GraphicsNodeLayer::appearanceId(GraphicsNode *node) const {
+    const QString key = node->nodeShape() % '|' % node->color() % '|'
+            % QString::number( node->size() ) % '|' % node->iconPath();
+    int id = m_appearanceIndex.value(key, -1);
+    if ( id < 0 ) {
+        id = (int) m_appearanceNodes.size();
+        m_appearanceIndex.insert(key, id);
+        m_appearanceNodes.push_back(node);
+    }
+    else {
+        m_appearanceNodes[id] = node;
+    }
+    return id;
+}
+
+
+
+/**
+ * @brief Returns the id of a text style, registering it if new, and adds the
+ * characters of text to its glyph atlas.
+ */
+int GraphicsNodeLayer::styleId(const QFont &font, const QColor &color,
+                               const QString &text) const {
+    const QString key = font.key() % '|' % color.name(QColor::HexArgb);
+    int id = m_styleIndex.value(key, -1);
+    if ( id < 0 ) {
+        id = (int) m_styleFonts.size();
+        m_styleIndex.insert(key, id);
+        m_styleFonts.push_back(font);
+        m_styleColors.push_back(color);
+        m_styleChars.push_back(QString());
+    }
+    bool added = false;
+    for (const QChar &c : text) {
+        if ( ! m_styleChars[id].contains(c) ) {
+            m_styleChars[id].append(c);
+            added = true;
+        }
+    }
+    if ( added ) {
+        for (int bucket = 0; bucket <= NODE_LAYER_MAX_ZOOM_EXP - NODE_LAYER_MIN_ZOOM_EXP; ++bucket) {
+            m_atlases.remove( ( (quint64) id << 8 ) | bucket );
+        }
+    }
+    return id;
+}
+
+
+
+/**
+ * @brief Collects the visible nodes, their appearances, texts and bounds.
+ * The texts of a node are its number, inside or next to it, and its label,
+ * placed where GraphicsNode and the text items would draw them.
+ */
+void GraphicsNodeLayer::rebuild() const {
+
+    m_dirty = false;
+    m_visible.clear();
+    m_rects.clear();
+    m_appearances.clear();
+    m_texts.clear();
+    m_bounds = QRectF();
+
+    // Do not let the caches grow forever, i.e. while resizing nodes
+    if ( m_appearanceIndex.size() > 4096 ) {
+        m_appearanceIndex.clear();
+        m_appearanceNodes.clear();
+        m_sprites.clear();
+    }
+    if ( m_styleIndex.size() > 1024 ) {
+        m_styleIndex.clear();
+        m_styleFonts.clear();
+        m_styleColors.clear();
+        m_styleChars.clear();
+        m_atlases.clear();
+    }
+
+    m_visible.reserve( m_nodes->size() );
+    m_rects.reserve( m_nodes->size() );
+    m_appearances.reserve( m_nodes->size() );
+    m_texts.reserve( m_nodes->size() );
+
+    QHash<int, GraphicsNode*>::const_iterator it;
+    for (it = m_nodes->constBegin(); it != m_nodes->constEnd(); ++it) {
+        GraphicsNode *node = it.value();
+        if ( ! node->isVisible() ) {
+            continue;
+        }
+        QRectF rect = node->sceneBoundingRect();
+        vector<Text> texts;
+
+        if ( node->numberInside() ) {
+            // as in GraphicsNode::paint()
+            const int size = node->size();
+            const int numSize = node->numberSize();
+            const int number = node->nodeNumber();
+            qreal fontSize = (numSize) ? numSize : 0.66 * size;
+            qreal x = -0.33 * size;
+            if ( number > 999 ) {
+                fontSize = (numSize) ? numSize - 1 : 0.4 * size;
+                x = -0.8 * size;
+            }
+            else if ( number > 99 ) {
+                fontSize = (numSize) ? numSize - 1 : 0.5 * size;
+                x = -0.6 * size;
+            }
+            else if ( number > 9 ) {
+                x = -0.5 * size;
+            }
+            const QString text = QString::number(number);
+            const QFont font("Sans Serif", (int) fontSize, QFont::Normal);
+            Text t = { styleId( font, QColor( node->numberColor() ), text ),
+                       node->pos() + QPointF( x, size / 3 ),
+                       text };
+            texts.push_back(t);
+        }
+
+        foreach (QGraphicsItem *child, node->childItems()) {
+            if ( ! child->isVisible()
+                 || ( child->type() != TypeNumber && child->type() != TypeLabel ) ) {
+                continue;
+            }
+            QGraphicsTextItem *item = static_cast<QGraphicsTextItem *>(child);
+            const QString text = item->toPlainText();
+            const qreal margin = item->document()->documentMargin();
+            Text t = { styleId( item->font(), item->defaultTextColor(), text ),
+                       item->scenePos()
+                       + QPointF( margin, margin + QFontMetricsF( item->font() ).ascent() ),
+                       text };
+            texts.push_back(t);
+            rect |= item->sceneBoundingRect();
+        }
+
+        m_visible.push_back(node);
+        m_rects.push_back(rect);
+        m_appearances.push_back( appearanceId(node) );
+        m_texts.push_back(texts);
+        m_bounds |= rect;
+    }
+
+    if ( ! m_bounds.isNull() ) {
+        m_bounds.adjust(-1, -1, 1, 1);
+    }
+}
+
+
+
+/**
+ * @brief Returns the sprite of an appearance at a zoom bucket, rendering it
+ * the first time, the same way GraphicsNode::paint() draws the node.
+ */
+const GraphicsNodeLayer::Sprite &GraphicsNodeLayer::sprite(const int &appearance,
+                                                           const int &bucket) {
+    const quint64 key = ( (quint64) appearance << 8 ) | bucket;
+    QHash<quint64, Sprite>::const_iterator it = m_sprites.constFind(key);
+    if ( it != m_sprites.constEnd() ) {
+        return it.value();
+    }
+
+    GraphicsNode *node = m_appearanceNodes[appearance];
+    const qreal scale = qPow( 2, bucket + NODE_LAYER_MIN_ZOOM_EXP );
+    const QRectF rect = node->boundingRect().adjusted(-1, -1, 1, 1);
+    const int size = node->size();
+    const QString shape = node->nodeShape();
+
+    Sprite sprite;
+    sprite.pixmap = QPixmap( qMax( 1, qCeil( rect.width() * scale ) ),
+                             qMax( 1, qCeil( rect.height() * scale ) ) );
+    sprite.pixmap.fill(Qt::transparent);
+    sprite.center = rect.center();
+
+    QPainter painter(&sprite.pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.scale(scale, scale);
+    painter.translate( -rect.topLeft() );
+    if ( shape == "custom" || shape == "person" || shape == "person-b"
+         || shape == "bugs" || shape == "heart" || shape == "dice" ) {
+        painter.drawPixmap( -size, -size, 2*size, 2*size, QPixmap( node->iconPath() ) );
+    }
+    else {
+        painter.setBrush( QColor( node->color() ) );
+        painter.setPen( QPen( QColor("#222"), 0 ) );
+        painter.drawPath( node->shape() );
+    }
+    painter.end();
+
+    return m_sprites.insert(key, sprite).value();
+}
+
+
+
+/**
+ * @brief Returns the glyph atlas of a text style at a zoom bucket, rendering
+ * its characters in rows the first time.
+ */
+const GraphicsNodeLayer::GlyphAtlas &GraphicsNodeLayer::glyphAtlas(const int &style,
+                                                                   const int &bucket) {
+    const quint64 key = ( (quint64) style << 8 ) | bucket;
+    QHash<quint64, GlyphAtlas>::const_iterator it = m_atlases.constFind(key);
+    if ( it != m_atlases.constEnd() ) {
+        return it.value();
+    }
+
+    const qreal scale = qPow( 2, bucket + NODE_LAYER_MIN_ZOOM_EXP );
+    const QFont &font = m_styleFonts[style];
+    const QString &chars = m_styleChars[style];
+    const QFontMetricsF fm(font);
+    const int padding = 1;
+    const int cellHeight = qCeil( ( fm.ascent() + fm.descent() ) * scale ) + 2 * padding;
+
+    GlyphAtlas atlas;
+    atlas.ascent = fm.ascent();
+    atlas.padding = padding / scale;
+
+    // lay out the cells in rows
+    int x = 0, y = 0;
+    for (const QChar &c : chars) {
+        const qreal advance = fm.width(c);
+        const int cellWidth = qCeil( advance * scale ) + 2 * padding;
+        if ( x > 0 && x + cellWidth > NODE_LAYER_ATLAS_WIDTH ) {
+            x = 0;
+            y += cellHeight;
+        }
+        atlas.glyphs.insert( c, QRectF( x, y, cellWidth, cellHeight ) );
+        atlas.advances.insert( c, advance );
+        x += cellWidth;
+    }
+
+    atlas.pixmap = QPixmap( ( y > 0 ) ? NODE_LAYER_ATLAS_WIDTH : qMax(1, x),
+                            y + cellHeight );
+    atlas.pixmap.fill(Qt::transparent);
+
+    QPainter painter(&atlas.pixmap);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setFont(font);
+    painter.setPen( m_styleColors[style] );
+    for (const QChar &c : chars) {
+        const QRectF cell = atlas.glyphs.value(c);
+        painter.save();
+        painter.translate( cell.x() + padding, cell.y() + padding );
+        painter.scale(scale, scale);
+        painter.drawText( QPointF( 0, fm.ascent() ), QString(c) );
+        painter.restore();
+    }
+    painter.end();
+
+    return m_atlases.insert(key, atlas).value();
+}
+
+
+
+QRectF GraphicsNodeLayer::boundingRect() const {
+    if ( m_dirty ) {
+        rebuild();
+    }
+    return m_bounds;
+}
+
+
+
+/**
+ * @brief The layer has no shape; the GraphicsNode items below it take the clicks.
+ */
+QPainterPath GraphicsNodeLayer::shape() const {
+    return QPainterPath();
+}
+
+
+
+/**
+ * @brief Paints the nodes, and then their texts, intersecting the exposed
+ * rect, in one batch of pixmap fragments per sprite and per glyph atlas.
+ */
+void GraphicsNodeLayer::paint(QPainter *painter,
+                              const QStyleOptionGraphicsItem *option,
+                              QWidget *) {
+    if ( m_dirty ) {
+        rebuild();
+    }
+
+    const qreal lod = option->levelOfDetailFromTransform( painter->worldTransform() );
+    const int zoomExp = qBound( NODE_LAYER_MIN_ZOOM_EXP,
+                                (int) qCeil( qLn( qMax( lod, (qreal) 0.001 ) ) / qLn(2.0) ),
+                                NODE_LAYER_MAX_ZOOM_EXP );
+    const int bucket = zoomExp - NODE_LAYER_MIN_ZOOM_EXP;
+    const qreal unscale = 1.0 / qPow( 2, zoomExp );
+    const QRectF &exposed = option->exposedRect;
+
+    vector<int> nodeBatch( m_appearanceNodes.size(), -1 );
+    vector<Sprite> nodeSprites;
+    vector< QVector<QPainter::PixmapFragment> > nodeFragments;
+
+    vector<int> textBatch( m_styleFonts.size(), -1 );
+    vector<GlyphAtlas> textAtlases;
+    vector< QVector<QPainter::PixmapFragment> > textFragments;
+
+    for (size_t i = 0; i < m_visible.size(); ++i) {
+        if ( ! m_rects[i].intersects(exposed) ) {
+            continue;
+        }
+
+        const int appearance = m_appearances[i];
+        if ( nodeBatch[appearance] < 0 ) {
+            nodeBatch[appearance] = (int) nodeSprites.size();
+            nodeSprites.push_back( sprite(appearance, bucket) );
+            nodeFragments.push_back( QVector<QPainter::PixmapFragment>() );
+        }
+        const Sprite &s = nodeSprites[ nodeBatch[appearance] ];
+        nodeFragments[ nodeBatch[appearance] ]
+                << QPainter::PixmapFragment::create( m_visible[i]->pos() + s.center,
+                                                     QRectF( QPointF(0, 0), s.pixmap.size() ),
+                                                     unscale, unscale );
+
+        for (const Text &text : m_texts[i]) {
+            if ( m_styleFonts[text.style].pointSizeF() * lod < LOD_TEXT_MIN_SIZE ) {
+                continue;
+            }
+            if ( textBatch[text.style] < 0 ) {
+                textBatch[text.style] = (int) textAtlases.size();
+                textAtlases.push_back( glyphAtlas(text.style, bucket) );
+                textFragments.push_back( QVector<QPainter::PixmapFragment>() );
+            }
+            const GlyphAtlas &atlas = textAtlases[ textBatch[text.style] ];
+            QVector<QPainter::PixmapFragment> &fragments = textFragments[ textBatch[text.style] ];
+            qreal x = text.baseline.x();
+            const qreal top = text.baseline.y() - atlas.ascent - atlas.padding;
+            for (const QChar &c : text.text) {
+                const QRectF cell = atlas.glyphs.value(c);
+                if ( cell.isValid() ) {
+                    const QPointF center( x - atlas.padding + cell.width() * unscale / 2,
+                                          top + cell.height() * unscale / 2 );
+                    fragments << QPainter::PixmapFragment::create( center, cell, unscale, unscale );
+                }
+                x += atlas.advances.value(c);
+            }
+        }
+    }
+
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+    for (size_t b = 0; b < nodeSprites.size(); ++b) {
+        painter->drawPixmapFragments( nodeFragments[b].constData(),
+                                      nodeFragments[b].size(),
+                                      nodeSprites[b].pixmap );
+    }
+    for (size_t b = 0; b < textAtlases.size(); ++b) {
+        painter->drawPixmapFragments( textFragments[b].constData(),
+                                      textFragments[b].size(),
+                                      textAtlases[b].pixmap );
+    }
+}
@@ -0,0 +1,122 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphicsnodelayer.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHICSNODELAYER_H
+#define GRAPHICSNODELAYER_H
+
+
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QPixmap>
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QVector>
+#include <vector>
+
+class GraphicsNode;
+
+using namespace std;
+
+static const int TypeNodeLayer = QGraphicsItem::UserType+9;
+
+
+/**
+ * @brief The GraphicsNodeLayer class
+ * A single scene item that paints all nodes, with their numbers and labels,
+ * for very large networks. The GraphicsNode items stay in the scene, so that
+ * they can still be clicked, hovered and dragged, but they have no contents.
+ * Every distinct node appearance (shape, color, size, icon) is rendered once
+ * to a sprite, and every text style to a glyph atlas, at the zoom level of the
+ * view rounded to a power of two. All nodes of each appearance, and all glyphs
+ * of each style, are then drawn with a single drawPixmapFragments() call;
+ * with an OpenGL viewport each such call is one textured draw.
+ */
+class GraphicsNodeLayer : public QGraphicsItem {
+
+public:
+    GraphicsNodeLayer(const QHash<int, GraphicsNode*> *nodes);
+
+    enum { Type = UserType + 9 };
+    int type() const { return Type; }
+
+    void nodesChanged();
+
+    QRectF boundingRect() const;
+    QPainterPath shape() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+
+private:
+    struct Sprite {
+        QPixmap pixmap;
+        QPointF center;   // center of the pixmap, relative to the node position
+    };
+    struct GlyphAtlas {
+        QPixmap pixmap;
+        QHash<QChar, QRectF> glyphs;   // source rects, in pixels
+        QHash<QChar, qreal> advances;
+        qreal ascent;
+        qreal padding;
+    };
+    struct Text {
+        int style;
+        QPointF baseline;
+        QString text;
+    };
+
+    void rebuild() const;
+    int appearanceId(GraphicsNode *node) const;
+    int styleId(const QFont &font, const QColor &color, const QString &text) const;
+    const Sprite &sprite(const int &appearance, const int &bucket);
+    const GlyphAtlas &glyphAtlas(const int &style, const int &bucket);
+
+    const QHash<int, GraphicsNode*> *m_nodes;
+
+    mutable bool m_dirty;
+    mutable QRectF m_bounds;
+
+    // visible nodes, with their scene bounding rects and appearances
+    mutable vector<GraphicsNode*> m_visible;
+    mutable vector<QRectF> m_rects;
+    mutable vector<int> m_appearances;
+    mutable vector< vector<Text> > m_texts;
+
+    // distinct appearances and text styles, in order of appearance
+    mutable QHash<QString, int> m_appearanceIndex;
+    mutable vector<GraphicsNode*> m_appearanceNodes;  // a node with each appearance
+    mutable QHash<QString, int> m_styleIndex;
+    mutable vector<QFont> m_styleFonts;
+    mutable vector<QColor> m_styleColors;
+    mutable vector<QString> m_styleChars;
+
+    // rendered sprites and atlases, by (id, zoom bucket)
+    mutable QHash<quint64, Sprite> m_sprites;
+    mutable QHash<quint64, GlyphAtlas> m_atlases;
+};
+
+#endif // GRAPHICSNODELAYER_H
@@ -28,6 +28,9 @@
 #include "graphicsnode.h"
 #include <QFont>
 #include <QDebug>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include "global.h"
 
 
 GraphicsNodeNumber::GraphicsNodeNumber( GraphicsNode *jim , const QString &labelText, const int &size)
@@ -52,6 +55,21 @@ void GraphicsNodeNumber::removeRefs(){
 
 }
 
+/**
+ * @brief Paints the text only if it is large enough to be read at the
+ * current zoom level of the view.
+ */
+void GraphicsNodeNumber::paint(QPainter *painter,
+                               const QStyleOptionGraphicsItem *option,
+                               QWidget *widget) {
+    const qreal lod = option->levelOfDetailFromTransform( painter->worldTransform() );
+    if ( font().pointSizeF() * lod < LOD_TEXT_MIN_SIZE ) {
+        return;
+    }
+    QGraphicsTextItem::paint(painter, option, widget);
+}
+
+
 GraphicsNodeNumber::~GraphicsNodeNumber(){
 
 }
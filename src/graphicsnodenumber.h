@@ -44,6 +44,9 @@ public:
 	int type() const { return Type; }
 	GraphicsNode* node() { return source; }
     void setSize(const int size);
+    void paint(QPainter *painter,
+               const QStyleOptionGraphicsItem *option,
+               QWidget *widget);
     ~GraphicsNodeNumber();
 private:
 	GraphicsNode *source;
@@ -48,6 +48,8 @@
 #include "graphicsguide.h"
 #include "graphicsedgeweight.h"
 #include "graphicsedgelabel.h"
+#include "graphicsedgelayer.h"
+#include "graphicsnodelayer.h"
 
 /** 
     Constructor method. Called when a GraphicsWidget object is created in MW
@@ -69,6 +71,12 @@ GraphicsWidget::GraphicsWidget(QGraphicsScene *sc, MainWindow* m_parent)  :
         m_currentRotationAngle = 0;
 
         clickedEdge=0;
+        m_edgeLayer=0;
+        m_edgeLayerEnabled=false;
+        m_nodeLayer=0;
+        m_nodeLayerEnabled=false;
+        m_sceneBuilding=false;
+        m_sceneBuildIndexMethod=QGraphicsScene::BspTreeIndex;
         edgesHash.reserve(150000);
         nodeHash.reserve(10000);
 
@@ -108,16 +116,78 @@ void GraphicsWidget::toggleOpenGL(const bool &enabled)
 
 
 /**
- * @brief creates a QString of the edge name - used for indexing edgesHash
+ * @brief Returns the key of the edge v1->v2 in relation, used for indexing
+ * edgesHash. The relation, source and target are packed in one 64-bit
+ * integer, 16 bits for the relation and 24 bits for each node number,
+ * thus no strings are built for edge lookups.
  * @param v1
  * @param v2
- * @param relation
+ * @param relation if -1, the current relation
  * @return
  */
-QString GraphicsWidget::createEdgeName(const int &v1, const int &v2, const int &relation) {
-    edgeName = QString::number((relation != -1) ? relation : m_curRelation) + QString(":")
-            + QString::number(v1) + QString(">")+ QString::number(v2);
-    return edgeName;
+quint64 GraphicsWidget::createEdgeKey(const int &v1, const int &v2, const int &relation) const {
+    const quint64 rel = (quint64) ( (relation != -1) ? relation : m_curRelation );
+    return ( ( rel & 0xFFFF ) << 48 )
+            | ( ( (quint64) v1 & 0xFFFFFF ) << 24 )
+            | ( (quint64) v2 & 0xFFFFFF );
+}
+
+
+
+/**
+ * @brief Toggles the bulk edge layer mode, for very large networks: all edges
+ * are drawn by a single GraphicsEdgeLayer item, without arrows, weights or
+ * labels, instead of one GraphicsEdge item each.
+ * Applies to the edges drawn after the next clear(), i.e. the next network.
+ * Called from MW on startup and from the Settings dialog.
+ * @param toggle
+ */
+void GraphicsWidget::setEdgeLayer(const bool &toggle) {
+    qDebug() << "GW::setEdgeLayer()" << toggle;
+    m_edgeLayerEnabled = toggle;
+}
+
+
+
+/**
+ * @brief Toggles the node layer mode: all nodes, numbers and labels are painted
+ * by a single GraphicsNodeLayer item, from cached sprites and glyph atlases,
+ * while the GraphicsNode items only take the mouse events.
+ * Meant for large networks on the OpenGL viewport, see toggleOpenGL().
+ * Nodes are not highlighted on mouse over in this mode.
+ * Called from MW on startup and from the Settings dialog.
+ * @param toggle
+ */
+void GraphicsWidget::setNodeLayer(const bool &toggle) {
+    qDebug() << "GW::setNodeLayer()" << toggle;
+    m_nodeLayerEnabled = toggle;
+    if ( toggle && !m_nodeLayer ) {
+        m_nodeLayer = new GraphicsNodeLayer(&nodeHash);
+        scene()->addItem(m_nodeLayer);
+    }
+    else if ( !toggle && m_nodeLayer ) {
+        scene()->removeItem(m_nodeLayer);
+        delete m_nodeLayer;
+        m_nodeLayer = 0;
+    }
+    foreach ( GraphicsNode *node, nodeHash) {
+        node->setPaintedByLayer(toggle);
+    }
+}
+
+
+
+/**
+ * @brief Called from GraphicsNode when it moves, so that the edge and node
+ * layers, if any, redraw at the new position.
+ */
+void GraphicsWidget::nodeMoved() {
+    if ( m_edgeLayer ) {
+        m_edgeLayer->nodesMoved();
+    }
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
 }
 
 
@@ -146,6 +216,17 @@ void GraphicsWidget::clear() {
     m_selectedNodes.clear();
     m_selectedEdges.clear();
     scene()->clear();
+    // the scene deleted the edge and node layers too
+    m_edgeLayer = 0;
+    if ( m_edgeLayerEnabled ) {
+        m_edgeLayer = new GraphicsEdgeLayer();
+        scene()->addItem(m_edgeLayer);
+    }
+    m_nodeLayer = 0;
+    if ( m_nodeLayerEnabled ) {
+        m_nodeLayer = new GraphicsNodeLayer(&nodeHash);
+        scene()->addItem(m_nodeLayer);
+    }
     m_curRelation=0;
     clickedEdge=0;
     firstNode=0;
@@ -163,6 +244,9 @@ void GraphicsWidget::clear() {
 void GraphicsWidget::relationSet(int relation) {
     qDebug() << "GraphicsWidget::relationSet() to " << relation;
     m_curRelation = relation;
+    if ( m_edgeLayer ) {
+        m_edgeLayer->setRelation(relation);
+    }
 }
 
 
@@ -227,6 +311,11 @@ void GraphicsWidget::drawNode( const QPointF &p,
 
     // Add new node to a container to ease finding, edge creation etc
     nodeHash.insert(num, jim);
+
+    if ( m_nodeLayer ) {
+        jim->setPaintedByLayer(true);
+        m_nodeLayer->nodesChanged();
+    }
 }
 
 
@@ -257,14 +346,26 @@ void GraphicsWidget::drawEdge(const int &source, const int &target,
                               const bool &bezier,
                               const bool &weightNumbers){
 
-    edgeName = createEdgeName(source, target);
+    edgeKey = createEdgeKey(source, target);
 
-    qDebug()<<"GW::drawEdge() - "<< edgeName
+    qDebug()<<"GW::drawEdge() - "<< edgeKey
            << "weight:"<<weight
            << "label:" << label
            << "direction type:" << type
            << " - nodeHash reports "<< nodeHash.size()<<" nodes.";
 
+    if ( m_edgeLayer ) {
+        if ( type != EdgeType::Reciprocated ) {
+            m_edgeLayer->addEdge(edgeKey, m_curRelation,
+                                 nodeHash.value(source), nodeHash.value(target),
+                                 color, weight, type);
+        }
+        else {
+            m_edgeLayer->setDirectionType( createEdgeKey(target, source), type );
+        }
+        return;
+    }
+
     if ( type != EdgeType::Reciprocated ) {
 
         GraphicsEdge *edge=new GraphicsEdge (
@@ -277,15 +378,16 @@ void GraphicsWidget::drawEdge(const int &source, const int &target,
                     (source==target) ? true: bezier,
                     weightNumbers,
                     m_edgeHighlighting);
+        edge->setRelation(m_curRelation);
 
-        edgesHash.insert(edgeName, edge);
+        edgesHash.insert(edgeKey, edge);
     }
     else {
         // if type is EdgeType::Reciprocated, we just need to change the direction type
         // of the existing opposite edge.
-        edgeName = createEdgeName(target,source);
-        qDebug()<< "GW::drawEdge() - Reciprocating existing directed edge"<<edgeName;
-        edgesHash.value(edgeName)->setDirectionType(type);
+        edgeKey = createEdgeKey(target,source);
+        qDebug()<< "GW::drawEdge() - Reciprocating existing directed edge"<<edgeKey;
+        edgesHash.value(edgeKey)->setDirectionType(type);
 
     }
     //	qDebug()<< "Scene items now: "<< scene()->items().size() << " - GW items now: "<< items().size();
@@ -394,6 +496,70 @@ void GraphicsWidget::moveNode(const int &num, const qreal &x, const qreal &y){
 
 
 
+/**
+ * @brief Moves a batch of nodes at once, i.e. one frame of a layout.
+ * The view is repainted once, after all nodes and their edges have moved.
+ * Called from Graph::signalNodePositions
+ * @param nodes
+ * @param positions
+ */
+void GraphicsWidget::moveNodes(const QVector<int> &nodes, const QVector<QPointF> &positions){
+    qDebug() << "GW: moveNodes() -" << nodes.size() << "nodes";
+    setUpdatesEnabled(false);
+    for (int i = 0; i < nodes.size(); ++i) {
+        GraphicsNode *node = nodeHash.value(nodes[i], nullptr);
+        if ( node ) {
+            node->setPos( positions[i] );
+        }
+    }
+    setUpdatesEnabled(true);
+}
+
+
+
+/**
+ * @brief Prepares the scene for the creation of many items in a row,
+ * i.e. when Graph replays the drawNode/drawEdge signals queued during a bulk
+ * build (file loading, random networks, etc).
+ * Switches the scene index off, so that adding items does not update the BSP
+ * tree each time, and disables view updates until sceneBuildEnd().
+ * Called from Graph::graphBulkCommit()
+ * @param items the number of items to expect
+ */
+void GraphicsWidget::sceneBuildBegin(const int &items) {
+    qDebug() << "GW::sceneBuildBegin() - items:" << items;
+    if ( m_sceneBuilding ) {
+        return;
+    }
+    m_sceneBuilding = true;
+    m_sceneBuildIndexMethod = scene()->itemIndexMethod();
+    scene()->setItemIndexMethod(QGraphicsScene::NoIndex);
+    nodeHash.reserve( nodeHash.size() + items );
+    edgesHash.reserve( edgesHash.size() + items );
+    setUpdatesEnabled(false);
+}
+
+
+
+/**
+ * @brief Ends the scene population started with sceneBuildBegin():
+ * Restores the scene index method, which indexes all new items in one pass,
+ * and repaints the view once.
+ */
+void GraphicsWidget::sceneBuildEnd() {
+    qDebug() << "GW::sceneBuildEnd() - nodes:" << nodeHash.size()
+             << "edges:" << edgesHash.size();
+    if ( !m_sceneBuilding ) {
+        return;
+    }
+    m_sceneBuilding = false;
+    scene()->setItemIndexMethod(m_sceneBuildIndexMethod);
+    setUpdatesEnabled(true);
+    viewport()->update();
+}
+
+
+
 /**
  * @brief Removes a node from the scene.
  * Called from Graph signalEraseNode(int)
@@ -432,23 +598,39 @@ void GraphicsWidget::removeEdge(const int &source,
                                 const int &target,
                                 const bool &removeOpposite){
 
-    edgeName = createEdgeName(source,target);
+    edgeKey = createEdgeKey(source,target);
 
-    qDebug() << "GW::removeEdge() - " << edgeName
+    qDebug() << "GW::removeEdge() - " << edgeKey
              << "removeOpposite"<<removeOpposite
              << " scene items: " << scene()->items().size()
              << " view items: " << items().size()
              << " edgesHash.count: " << edgesHash.count();
 
-    if ( edgesHash.contains(edgeName) ) {
-        int directionType = edgesHash.value(edgeName)->directionType();
-        delete edgesHash.value(edgeName);
+    if ( m_edgeLayer ) {
+        const int directionType = m_edgeLayer->directionType(edgeKey);
+        if ( m_edgeLayer->removeEdge(edgeKey) ) {
+            if ( directionType == EdgeType::Reciprocated && !removeOpposite ) {
+                drawEdge(target, source, 1, "");
+            }
+        }
+        else {
+            edgeKey = createEdgeKey(target, source);
+            if ( m_edgeLayer->directionType(edgeKey) == EdgeType::Reciprocated ) {
+                m_edgeLayer->setDirectionType(edgeKey, EdgeType::Directed);
+            }
+        }
+        return;
+    }
+
+    if ( edgesHash.contains(edgeKey) ) {
+        int directionType = edgesHash.value(edgeKey)->directionType();
+        delete edgesHash.value(edgeKey);
         if (directionType == EdgeType::Reciprocated) {
             if (!removeOpposite) {
                 drawEdge(target, source, 1,"");
             }
         }
-            qDebug() << "GW::removeEdge() - Deleted edge" << edgeName
+            qDebug() << "GW::removeEdge() - Deleted edge" << edgeKey
                  << " scene items: " << scene()->items().size()
                  << " view items: " << items().size()
                  << " edgesHash.count: " << edgesHash.count();
@@ -456,13 +638,13 @@ void GraphicsWidget::removeEdge(const int &source,
     }
     else {
         //check opposite edge. If it exists, then transform it to directed
-        edgeName = createEdgeName(target, source);
+        edgeKey = createEdgeKey(target, source);
         qDebug() << "GW::removeEdge() - Edge did not exist, checking for opposite:"
-                 << edgeName;
-        if ( edgesHash.contains(edgeName) ) {
+                 << edgeKey;
+        if ( edgesHash.contains(edgeKey) ) {
             qDebug() << "GW::removeEdge() - Opposite edge exists. Check if it is reciprocated";
-            if ( edgesHash.value(edgeName)->directionType() == EdgeType::Reciprocated ) {
-                edgesHash.value(edgeName)->setDirectionType(EdgeType::Directed);
+            if ( edgesHash.value(edgeKey)->directionType() == EdgeType::Reciprocated ) {
+                edgesHash.value(edgeKey)->setDirectionType(EdgeType::Directed);
                 return;
             }
         }
@@ -491,6 +673,12 @@ void GraphicsWidget::removeItem( GraphicsNode *node){
         secondDoubleClick = false;
         emit setCursor(Qt::ArrowCursor);
     }
+    if ( m_edgeLayer ) {
+        m_edgeLayer->removeNodeEdges(node);
+    }
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     nodeHash.remove(i);
     scene()->removeItem(node);
     node->deleteLater ();
@@ -513,9 +701,9 @@ void GraphicsWidget::removeItem( GraphicsNode *node){
 void GraphicsWidget::removeItem( GraphicsEdge * edge){
     qDebug() << "GW::removeItem(edge) - calling edgeClicked(0)" ;
     setEdgeClicked(0);
-    edgeName = createEdgeName(edge->sourceNodeNumber(), edge->targetNodeNumber() ) ;
+    edgeKey = createEdgeKey(edge->sourceNodeNumber(), edge->targetNodeNumber(), edge->relation() ) ;
     qDebug() << "GW::removeItem(edge) - removing edge from edges hash" ;
-    edgesHash.remove(edgeName);
+    edgesHash.remove(edgeKey);
     qDebug() << "GW::removeItem(edge) - removing edge scene" ;
     scene()->removeItem(edge);
     qDebug() << "GW::removeItem(edge) - calling edge->deleteLater()" ;
@@ -604,6 +792,9 @@ void GraphicsWidget::removeItem( GraphicsNodeNumber *nodeNumber){
  */
 bool GraphicsWidget::setNodeColor(const int &nodeNumber,
                                   const QString &color){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug() << "GW::setNodeColor() : " << color;
     nodeHash.value(nodeNumber) -> setColor(color);
     return true;
@@ -621,6 +812,9 @@ bool GraphicsWidget::setNodeColor(const int &nodeNumber,
 bool GraphicsWidget::setNodeShape(const int &nodeNumber,
                                   const QString &shape,
                                   const QString &iconPath){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug() << "GW::setNodeShape() : " << shape;
     nodeHash.value(nodeNumber) -> setShape(shape,iconPath);
     return true;
@@ -635,6 +829,9 @@ bool GraphicsWidget::setNodeShape(const int &nodeNumber,
  * @param toggle
  */
 void GraphicsWidget::setNodeLabelsVisibility (const bool &toggle){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug()<< "GW::setNodeLabelsVisibility()" << toggle;
     foreach ( GraphicsNode *m_node, nodeHash) {
         m_node->setLabelVisibility(toggle);
@@ -650,6 +847,9 @@ void GraphicsWidget::setNodeLabelsVisibility (const bool &toggle){
  * @return
  */
 bool GraphicsWidget::setNodeLabel(const int &nodeNumber, const QString &label){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug() << "GW::setNodeLabel() : " << label;
     nodeHash.value(nodeNumber) -> setLabelText (label);
     return true;
@@ -664,6 +864,9 @@ bool GraphicsWidget::setNodeLabel(const int &nodeNumber, const QString &label){
  * @param numIn
  */
 void   GraphicsWidget::setNumbersInsideNodes(const bool &toggle){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug()<< "GW::setNumbersInsideNodes" << toggle;
     foreach ( GraphicsNode *m_node, nodeHash) {
         m_node->setNumberInside(toggle);
@@ -707,6 +910,9 @@ void GraphicsWidget::setInitZoomIndex(int zoomIndex) {
 *	Changes the visibility of a Node
 */
 void GraphicsWidget::setNodeVisibility(int number, bool toggle){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     if  ( nodeHash.contains (number) ) {
         qDebug() << "GW::setNodeVisibility() - node"
                  << number << " set to " << toggle;
@@ -725,6 +931,9 @@ void GraphicsWidget::setNodeVisibility(int number, bool toggle){
  * @return
  */
 bool GraphicsWidget::setNodeSize(const int &number, const int &size ){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug () << "GW::setNodeSize() node: "<< number
               << " new size "<< size;
     if  ( nodeHash.contains (number) ) {
@@ -752,6 +961,9 @@ bool GraphicsWidget::setNodeSize(const int &number, const int &size ){
  * @return
  */
 void GraphicsWidget::setNodeSizeAll(const int &size ){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug() << "GW::setAllNodeSize() ";
     foreach ( GraphicsNode *m_node, nodeHash ) {
             qDebug() << "GW::setAllNodeSize(): "<< m_node->nodeNumber() << " to new size " << size ;
@@ -767,6 +979,9 @@ void GraphicsWidget::setNodeSizeAll(const int &size ){
  * @param toggle
  */
 void GraphicsWidget::setNodeNumberVisibility(const bool &toggle){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug()<< "GW::setNodeNumberVisibility()" << toggle;
     foreach ( GraphicsNode *m_node, nodeHash) {
         m_node->setNumberVisibility(toggle);
@@ -783,6 +998,9 @@ void GraphicsWidget::setNodeNumberVisibility(const bool &toggle){
  * @param color
  */
 void GraphicsWidget::setNodeNumberColor(const int &nodeNumber, const QString &color) {
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug () << " GraphicsWidget::setNodeNumberColor() - node:"<< nodeNumber
               << " new number color"<< color;
     if  ( nodeHash.contains (nodeNumber) ) {
@@ -800,6 +1018,9 @@ void GraphicsWidget::setNodeNumberColor(const int &nodeNumber, const QString &co
  * @param size
  */
 bool GraphicsWidget::setNodeNumberSize(const int &number, const int &size){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug () << " GraphicsWidget::setNodeNumberSize() - node: "<< number
               << " new number size "<< size;
     if  ( nodeHash.contains (number) ) {
@@ -821,6 +1042,9 @@ bool GraphicsWidget::setNodeNumberSize(const int &number, const int &size){
  * @param distance
  */
 bool GraphicsWidget::setNodeNumberDistance(const int &number, const int &distance ){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug () << "GW::setNodeNumberDistance() - node: "<< number
               << " new number distance "<< distance;
     if  ( nodeHash.contains (number) ) {
@@ -843,6 +1067,9 @@ bool GraphicsWidget::setNodeNumberDistance(const int &number, const int &distanc
  * @param color
  */
 bool GraphicsWidget::setNodeLabelColor(const int &number, const QString &color){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug () << "GW::setNodeLabelColor() - node number: "<< number
               << " new Label color"<< color;
     if  ( nodeHash.contains (number) ) {
@@ -862,6 +1089,9 @@ bool GraphicsWidget::setNodeLabelColor(const int &number, const QString &color){
  * @param size
  */
 bool GraphicsWidget::setNodeLabelSize(const int &number, const int &size){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug () << "GW::setNodeLabelSize() - node number: "<< number
               << " new Label size "<< size;
     if  ( nodeHash.contains (number) ) {
@@ -885,6 +1115,9 @@ bool GraphicsWidget::setNodeLabelSize(const int &number, const int &size){
  * @param distance
  */
 bool GraphicsWidget::setNodeLabelDistance( const int &number, const int &distance ){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug () << "GW::setNodeLabelDistance() - node number: "<< number
               << " new label distance "<< distance;
     if  ( nodeHash.contains (number) ) {
@@ -930,6 +1163,9 @@ GraphicsNode* GraphicsWidget::hasNode( QString text ){
  * @param list
  */
 void GraphicsWidget::setNodesMarked(QList<int> list){
+    if ( m_nodeLayer ) {
+        m_nodeLayer->nodesChanged();
+    }
     qDebug() << "GW::setNodesMarked()" << list;
     foreach ( int nodeNumber, list) {
         if  ( nodeHash.contains (nodeNumber) ) {
@@ -956,11 +1192,11 @@ void GraphicsWidget::setEdgeLabel(const int &source,
                                   const int &target,
                                   const QString &label){
 
-    edgeName = createEdgeName( source, target );
+    edgeKey = createEdgeKey( source, target );
 
-    qDebug()<<"GW::setEdgeLabel() -" << edgeName <<  " new label "  << label;
-    if  ( edgesHash.contains (edgeName) ) {
-        edgesHash.value(edgeName) -> setLabel(label);
+    qDebug()<<"GW::setEdgeLabel() -" << edgeKey <<  " new label "  << label;
+    if  ( edgesHash.contains (edgeKey) ) {
+        edgesHash.value(edgeKey) -> setLabel(label);
     }
 
 
@@ -978,11 +1214,15 @@ void GraphicsWidget::setEdgeColor(const int &source,
                                   const int &target,
                                   const QString &color){
 
-    edgeName =  createEdgeName( source, target );
+    edgeKey = createEdgeKey( source, target );
 
-    qDebug()<<"GW::setEdgeColor() -" << edgeName <<  " new color "  << color;
-    if  ( edgesHash.contains (edgeName) ) {
-        edgesHash.value(edgeName) -> setColor(color);
+    qDebug()<<"GW::setEdgeColor() -" << edgeKey <<  " new color "  << color;
+    if ( m_edgeLayer ) {
+        m_edgeLayer->setColor(edgeKey, color);
+        return;
+    }
+    if  ( edgesHash.contains (edgeKey) ) {
+        edgesHash.value(edgeKey) -> setColor(color);
     }
 
 }
@@ -1007,13 +1247,17 @@ bool GraphicsWidget::setEdgeDirectionType(const int &source,
              << "->" << target
              << "type" << dirType;
 
-    edgeName = createEdgeName( source, target );
-    qDebug()<<"GW::setEdgeDirectionType() - checking edgesHash for:" << edgeName ;
+    edgeKey = createEdgeKey( source, target );
+    qDebug()<<"GW::setEdgeDirectionType() - checking edgesHash for:" << edgeKey ;
 
-    if  ( edgesHash.contains (edgeName) ) {
+    if ( m_edgeLayer ) {
+        return m_edgeLayer->setDirectionType(edgeKey, dirType);
+    }
+
+    if  ( edgesHash.contains (edgeKey) ) {
         qDebug()<<"GW::setEdgeDirectionType() - edge exists in edgesHash. "
                   << " Transforming it to reciprocated";
-        edgesHash.value(edgeName) -> setDirectionType(dirType);
+        edgesHash.value(edgeKey) -> setDirectionType(dirType);
 
         return true;
     }
@@ -1035,22 +1279,26 @@ bool GraphicsWidget::setEdgeWeight(const int &source,
                                    const int &target,
                                    const qreal &weight){
 
-    edgeName = createEdgeName( source, target );
+    edgeKey = createEdgeKey( source, target );
 
-    qDebug()<<"GW::setEdgeWeight() -" << edgeName <<  " new weight "  << weight;
-    if  ( edgesHash.contains (edgeName) ) {
-        edgesHash.value(edgeName) -> setWeight(weight);
+    qDebug()<<"GW::setEdgeWeight() -" << edgeKey <<  " new weight "  << weight;
+    if ( m_edgeLayer ) {
+        return m_edgeLayer->setWeight(edgeKey, weight)
+                || m_edgeLayer->setWeight( createEdgeKey(target, source), weight );
+    }
+    if  ( edgesHash.contains (edgeKey) ) {
+        edgesHash.value(edgeKey) -> setWeight(weight);
         return true;
     }
 
     else {
         //check opposite edge. If it exists, then transform it to directed
-        edgeName = createEdgeName(target, source);
+        edgeKey = createEdgeKey(target, source);
         qDebug() << "GW::setEdgeWeight() - Edge did not exist, checking for opposite:"
-                 << edgeName;
-        if ( edgesHash.contains(edgeName) ) {
+                 << edgeKey;
+        if ( edgesHash.contains(edgeKey) ) {
             qDebug() << "GW::setEdgeWeight() - Opposite edge exists. Check if it is reciprocated";
-            edgesHash.value(edgeName) -> setWeight(weight);
+            edgesHash.value(edgeKey) -> setWeight(weight);
             return true;
         }
         qDebug() << "GW::setEdgeWeight() - No such edge to delete";
@@ -1097,12 +1345,11 @@ void GraphicsWidget::setEdgeOffsetFromNode(const int &source,
 
     if (source && target) {
 
-        QString edgeName =  QString::number(m_curRelation) + QString(":") +
-                QString::number( source ) + QString(">")+ QString::number( target );
+        edgeKey = createEdgeKey( source, target );
 
-        qDebug()<<"GW::setEdgeWeight() -" << edgeName <<  " new offset "  << offset;
-        if  ( edgesHash.contains (edgeName) ) {
-            edgesHash.value(edgeName) -> setMinimumOffsetFromNode(offset);
+        qDebug()<<"GW::setEdgeWeight() -" << edgeKey <<  " new offset "  << offset;
+        if  ( edgesHash.contains (edgeKey) ) {
+            edgesHash.value(edgeKey) -> setMinimumOffsetFromNode(offset);
             return;
         }
 
@@ -1183,32 +1430,55 @@ void   GraphicsWidget::setEdgeHighlighting(const bool &toggle){
  */
 void GraphicsWidget::setEdgeVisibility(int relation, int source, int target, bool toggle){
 
-    edgeName = createEdgeName( source, target, relation );
+    if ( m_edgeLayer ) {
+        if ( ! m_edgeLayer->setEdgeVisible( createEdgeKey( source, target, relation ), toggle ) ) {
+            m_edgeLayer->setEdgeVisible( createEdgeKey( target, source, relation ), toggle );
+        }
+        return;
+    }
 
-    qDebug()<<"GW::setEdgeVisibility() - trying to set edge"<<edgeName<<"to"<<toggle;
+    GraphicsEdge *edge = edgesHash.value( createEdgeKey( source, target, relation ), nullptr );
 
-    if  ( edgesHash.contains (edgeName) ) {
-        qDebug()<<"GW::setEdgeVisibility() - edge" << edgeName
-               << "set to" << toggle;
-        edgesHash.value(edgeName) -> setVisible(toggle);
-        edgesHash.value(edgeName) -> setEnabled(toggle);
-        return;
+    if ( ! edge ) {
+        // check the opposite, reciprocated edge
+        edge = edgesHash.value( createEdgeKey( target, source, relation ), nullptr );
     }
-    edgeName = createEdgeName( target, source, relation );
-    qDebug()<<"GW: setEdgeVisibility() - trying to set edge"<<edgeName<<"to"<<toggle;
-    if  ( edgesHash.contains (edgeName) ) {
-        qDebug()<<"GW::setEdgeVisibility() - reciprocated edge" << edgeName
-               << "set to" << toggle;
-        edgesHash.value(edgeName) -> setVisible(toggle);
-        edgesHash.value(edgeName) -> setEnabled(toggle);
+
+    if  ( edge ) {
+        qDebug()<<"GW::setEdgeVisibility() - edge" << source << "->" << target
+               << "relation" << relation << "set to" << toggle;
+        edge -> setVisible(toggle);
+        edge -> setEnabled(toggle);
         return;
     }
-    qDebug()<<"GW::setEdgeVisibility() - Cannot find edge" << edgeName << "or the opposite in the edgesHash";
+    qDebug()<<"GW::setEdgeVisibility() - Cannot find edge" << source << "->" << target
+           << "or the opposite in the edgesHash";
 
 }
 
 
 
+/**
+ * @brief Changes the visibility of many edges at once, i.e. the edges
+ * Graph::edgeFilterByWeight() has flipped.
+ * @param relation
+ * @param sources
+ * @param targets
+ * @param toggle
+ */
+void GraphicsWidget::setEdgesVisibility(const int &relation,
+                                        const QVector<int> &sources,
+                                        const QVector<int> &targets,
+                                        const bool &toggle){
+    qDebug()<<"GW::setEdgesVisibility() - edges" << sources.size()
+           << "relation" << relation << "set to" << toggle;
+    for (int i = 0; i < sources.size(); ++i) {
+        setEdgeVisibility( relation, sources[i], targets[i], toggle );
+    }
+}
+
+
+
 /**
  * @brief Changes the visibility of all items of certain type (i.e. number, label, edge, etc)
  * @param type
@@ -1419,6 +1689,7 @@ void GraphicsWidget::mousePressEvent( QMouseEvent * e ) {
     if (this->dragMode() == QGraphicsView::RubberBandDrag ) {
 
         QPointF p = mapToScene(e->pos());
+        int source=0, target=0;
 
 //        qDebug() << "GW::mousePressEvent() - Single click on a node at:"
 //             << e->pos() << "~"<< p;
@@ -1480,6 +1751,16 @@ void GraphicsWidget::mousePressEvent( QMouseEvent * e ) {
                 return;
             }
         }
+        else if ( m_edgeLayer && m_edgeLayer->edgeAt( p, 4 / m_currentScaleFactor,
+                                                      source, target ) ) {
+            //
+            // user clicked on an edge of the edge layer
+            //
+            qDebug() << "GW::mousePressEvent() - Single click on layer edge"
+                     << source << "->" << target << "at:" << e->pos() << "~"<< p;
+            clickedEdge=0;
+            emit userClickedEdge(source, target, e->button()==Qt::RightButton);
+        }
         else {
             if ( e->button() == Qt::RightButton   ) {
                 //
@@ -41,8 +41,10 @@ class GraphicsNodeLabel;
 class GraphicsGuide;
 class GraphicsEdgeWeight;
 class GraphicsEdgeLabel;
+class GraphicsEdgeLayer;
+class GraphicsNodeLayer;
 
-typedef QHash<QString, GraphicsEdge*> H_StrToEdge;
+typedef QHash<quint64, GraphicsEdge*> H_KeyToEdge;
 typedef QHash <int, GraphicsNode*> H_NumToNode;
 
 using namespace std;
@@ -63,9 +65,13 @@ public:
     void clear();
 
     void toggleOpenGL(const bool &enabled=false);
-    QString createEdgeName(const int &v1,
-                           const int &v2,
-                           const int &relation=-1);
+
+    void setEdgeLayer(const bool &toggle);
+    void setNodeLayer(const bool &toggle);
+    void nodeMoved();
+    quint64 createEdgeKey(const int &v1,
+                          const int &v2,
+                          const int &relation=-1) const;
 
     void setInitNodeSize(int);
 
@@ -126,6 +132,9 @@ public slots:
     void setNodeVisibility(int, bool );	//Called from Graph via MW
     void setNodeClicked(GraphicsNode *);
     void moveNode(const int &num, const qreal &x, const qreal &y);
+    void moveNodes(const QVector<int> &nodes, const QVector<QPointF> &positions);
+    void sceneBuildBegin(const int &items);
+    void sceneBuildEnd();
 
     bool setNodeSize(const int &nodeNumber, const int &size=0);
     void setNodeSizeAll(const int &size=0);
@@ -162,6 +171,11 @@ public slots:
 
     void setEdgeVisibility (int relation, int, int, bool);
 
+    void setEdgesVisibility (const int &relation,
+                             const QVector<int> &sources,
+                             const QVector<int> &targets,
+                             const bool &toggle);
+
     bool setEdgeDirectionType(const int &,
                               const int &,
                               const int &dirType=false);
@@ -218,7 +232,13 @@ signals:
 private:
 
     H_NumToNode nodeHash;	//This is used in drawEdge() method
-    H_StrToEdge edgesHash; // helper hash to easily find edges
+    H_KeyToEdge edgesHash; // helper hash to easily find edges
+    GraphicsEdgeLayer *m_edgeLayer; // draws all edges, in bulk edge layer mode
+    bool m_edgeLayerEnabled;
+    GraphicsNodeLayer *m_nodeLayer; // paints all nodes, in node layer mode
+    bool m_nodeLayerEnabled;
+    bool m_sceneBuilding; // between sceneBuildBegin() and sceneBuildEnd()
+    QGraphicsScene::ItemIndexMethod m_sceneBuildIndexMethod;
     QList<int> m_selectedNodes;
     QList<SelectedEdge> m_selectedEdges;
     int m_curRelation, m_nodeSize;
@@ -228,7 +248,7 @@ private:
     double m_currentScaleFactor;
     qreal fX,fY, factor;
     QString m_nodeLabel, m_numberColor, m_labelColor;
-    QString edgeName;
+    quint64 edgeKey;
     bool transformationActive;
     bool secondDoubleClick, clickedEdgeExists;
     bool m_nodeNumbersInside, m_nodeNumberVisibility, m_nodeLabelVisibility;
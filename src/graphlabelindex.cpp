@@ -0,0 +1,198 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphlabelindex.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphlabelindex.h"
+
+#include <QtDebug>
+
+
+
+GraphLabelIndex::GraphLabelIndex() :
+    m_trigramsBuilt(false)
+{
+}
+
+
+
+/**
+ * @brief Drops all labels and the trigram index.
+ */
+void GraphLabelIndex::clear() {
+    m_labels.clear();
+    m_vertices.clear();
+    m_trigrams.clear();
+    m_trigramsBuilt = false;
+}
+
+
+
+/**
+ * @brief Indexes vertex name by label, replacing its previous label, if any.
+ * Empty labels are not indexed.
+ * @param name
+ * @param label
+ */
+void GraphLabelIndex::insert(const int &name, const QString &label) {
+    remove(name);
+    if ( label.isEmpty() ) {
+        return;
+    }
+    const QString folded = label.toCaseFolded();
+    m_labels.insert(name, folded);
+    m_vertices[folded].append(name);
+    if ( m_trigramsBuilt ) {
+        trigramsInsert(name, folded);
+    }
+}
+
+
+
+/**
+ * @brief Removes vertex name from the index
+ * @param name
+ */
+void GraphLabelIndex::remove(const int &name) {
+    QHash<int, QString>::iterator it = m_labels.find(name);
+    if ( it == m_labels.end() ) {
+        return;
+    }
+    const QString folded = it.value();
+    m_labels.erase(it);
+    QHash<QString, QVector<int> >::iterator v = m_vertices.find(folded);
+    if ( v != m_vertices.end() ) {
+        v.value().removeOne(name);
+        if ( v.value().isEmpty() ) {
+            m_vertices.erase(v);
+        }
+    }
+    if ( m_trigramsBuilt ) {
+        trigramsRemove(name, folded);
+    }
+}
+
+
+
+/**
+ * @brief Returns the first vertex indexed with label, ignoring case, or -1
+ * @param label
+ * @return
+ */
+int GraphLabelIndex::find(const QString &label) const {
+    QHash<QString, QVector<int> >::const_iterator v = m_vertices.constFind( label.toCaseFolded() );
+    return ( v != m_vertices.constEnd() ) ? v.value().first() : -1;
+}
+
+
+
+/**
+ * @brief Returns the vertices whose labels contain text, ignoring case.
+ * Each label holding all the trigrams of text is a candidate, then checked
+ * against text; only the smallest trigram set is scanned.
+ * Texts shorter than a trigram are searched in all labels.
+ * @param text
+ * @return
+ */
+QList<int> GraphLabelIndex::search(const QString &text) {
+    QList<int> found;
+    const QString folded = text.toCaseFolded();
+
+    if ( folded.size() < 3 ) {
+        QHash<int, QString>::const_iterator it;
+        for (it = m_labels.constBegin(); it != m_labels.constEnd(); ++it) {
+            if ( it.value().contains(folded) ) {
+                found << it.key();
+            }
+        }
+        return found;
+    }
+
+    if ( !m_trigramsBuilt ) {
+        qDebug() << "GraphLabelIndex::search() - building trigrams of" << m_labels.size() << "labels";
+        QHash<int, QString>::const_iterator it;
+        for (it = m_labels.constBegin(); it != m_labels.constEnd(); ++it) {
+            trigramsInsert(it.key(), it.value());
+        }
+        m_trigramsBuilt = true;
+    }
+
+    const QSet<int> *smallest = nullptr;
+    for (int i = 0; i + 3 <= folded.size(); ++i) {
+        QHash<quint64, QSet<int> >::const_iterator t = m_trigrams.constFind( trigram(folded, i) );
+        if ( t == m_trigrams.constEnd() ) {
+            return found;
+        }
+        if ( !smallest || t.value().size() < smallest->size() ) {
+            smallest = &t.value();
+        }
+    }
+
+    QSet<int>::const_iterator c;
+    for (c = smallest->constBegin(); c != smallest->constEnd(); ++c) {
+        if ( m_labels.value(*c).contains(folded) ) {
+            found << *c;
+        }
+    }
+    return found;
+}
+
+
+
+/**
+ * @brief Returns the key of the trigram of text at position i
+ * @param text
+ * @param i
+ * @return
+ */
+quint64 GraphLabelIndex::trigram(const QString &text, const int &i) {
+    return ( (quint64) text.at(i).unicode() << 32 )
+            | ( (quint64) text.at(i+1).unicode() << 16 )
+            | (quint64) text.at(i+2).unicode();
+}
+
+
+
+void GraphLabelIndex::trigramsInsert(const int &name, const QString &folded) {
+    for (int i = 0; i + 3 <= folded.size(); ++i) {
+        m_trigrams[ trigram(folded, i) ].insert(name);
+    }
+}
+
+
+
+void GraphLabelIndex::trigramsRemove(const int &name, const QString &folded) {
+    for (int i = 0; i + 3 <= folded.size(); ++i) {
+        QHash<quint64, QSet<int> >::iterator t = m_trigrams.find( trigram(folded, i) );
+        if ( t == m_trigrams.end() ) {
+            continue;
+        }
+        t.value().remove(name);
+        if ( t.value().isEmpty() ) {
+            m_trigrams.erase(t);
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphlabelindex.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHLABELINDEX_H
+#define GRAPHLABELINDEX_H
+
+#include <QtGlobal>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+
+/**
+ * @brief The GraphLabelIndex class
+ * The vertices of a Graph by their label, case-insensitively.
+ * find() looks up a whole label in O(1). search() finds the labels that
+ * contain a text through an index of the trigrams (three character
+ * substrings) of the labels, which is built on the first search and kept
+ * up to date afterwards, since a plain lookup needs none of that memory.
+ * Graph updates it in vertexCreate(), vertexLabelSet() and vertexRemove().
+ */
+class GraphLabelIndex
+{
+public:
+    GraphLabelIndex();
+
+    void insert(const int &name, const QString &label);
+    void remove(const int &name);
+    void clear();
+
+    int find(const QString &label) const;
+    QList<int> search(const QString &text);
+
+    /** Number of labelled vertices */
+    int size() const { return m_labels.size(); }
+
+private:
+    static quint64 trigram(const QString &text, const int &i);
+    void trigramsInsert(const int &name, const QString &folded);
+    void trigramsRemove(const int &name, const QString &folded);
+
+    QHash<int, QString> m_labels;                // vertex -> case folded label
+    QHash<QString, QVector<int> > m_vertices;     // case folded label -> vertices, in insertion order
+    QHash<quint64, QSet<int> > m_trigrams;       // trigram -> vertices, see search()
+    bool m_trigramsBuilt;
+};
+
+#endif // GRAPHLABELINDEX_H
@@ -0,0 +1,324 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphlayoutengine.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphlayoutengine.h"
+
+#include <QtConcurrent>
+#include <QVector>
+#include <cmath>
+
+
+/** Points per block of the parallel force pass */
+static const int FORCE_BLOCK = 256;
+
+
+/** Returns the sign of d as -1, 0 or 1, without branches */
+static inline qreal signOf(const qreal &d) {
+    return (qreal) ( ( d > 0 ) - ( d < 0 ) );
+}
+
+
+GraphLayoutEngine::GraphLayoutEngine() :
+    m_model(FruchtermanReingold),
+    m_optimalDistance(1),
+    m_theta(0),
+    m_minX(0), m_maxX(0), m_minY(0), m_maxY(0)
+{
+    m_incidentOffsets.push_back(0);
+}
+
+
+
+/**
+ * @brief Sets the force model, its optimal distance (or natural spring length)
+ * and the Barnes-Hut opening angle theta, 0 for the exact repulsion.
+ * @param model
+ * @param optimalDistance
+ * @param theta
+ */
+void GraphLayoutEngine::setModel(const int &model,
+                                 const qreal &optimalDistance,
+                                 const qreal &theta) {
+    m_model = model;
+    m_optimalDistance = optimalDistance;
+    m_theta = theta;
+}
+
+
+
+/**
+ * @brief Sets the area the points are kept in when they move.
+ */
+void GraphLayoutEngine::setBounds(const qreal &minX, const qreal &maxX,
+                                  const qreal &minY, const qreal &maxY) {
+    m_minX = minX;
+    m_maxX = maxX;
+    m_minY = minY;
+    m_maxY = maxY;
+}
+
+
+
+/**
+ * @brief Sets the points 0..n-1 and the arcs between them: the arcs of point s
+ * go to targets[offsets[s]] .. targets[offsets[s+1]-1].
+ * The positions are resized to n, and need to be set through x() and y().
+ * @param offsets
+ * @param targets
+ */
+void GraphLayoutEngine::setArcs(const vector<int> &offsets, const vector<int> &targets) {
+
+    const int n = (int) offsets.size() - 1;
+
+    m_incidentOffsets.assign(n + 1, 0);
+    for (int s = 0; s < n; ++s) {
+        for (int e = offsets[s]; e < offsets[s+1]; ++e) {
+            m_incidentOffsets[ s + 1 ]++;
+            m_incidentOffsets[ targets[e] + 1 ]++;
+        }
+    }
+    for (int s = 0; s < n; ++s) {
+        m_incidentOffsets[s+1] += m_incidentOffsets[s];
+    }
+
+    m_incident.resize( m_incidentOffsets[n] );
+    vector<int> next( m_incidentOffsets.begin(), m_incidentOffsets.end() - 1 );
+    for (int s = 0; s < n; ++s) {
+        for (int e = offsets[s]; e < offsets[s+1]; ++e) {
+            m_incident[ next[s]++ ] = targets[e];
+            m_incident[ next[ targets[e] ]++ ] = s;
+        }
+    }
+
+    m_points.resize(n);
+    for (int s = 0; s < n; ++s) {
+        m_points[s] = s;
+    }
+
+    m_x.resize(n);
+    m_y.resize(n);
+    m_dispX.assign(n, 0);
+    m_dispY.assign(n, 0);
+}
+
+
+
+/**
+ * @brief Returns the repulsive force between two points at distance dist,
+ * as a negative number.
+ * Eades: c_rep / dist^2. Fruchterman-Reingold: optimalDistance^2 / dist.
+ * In both, points farther than 2 * optimalDistance are neglected, which is the
+ * grid variant of Fruchterman and Reingold.
+ * @param model
+ * @param dist
+ * @param optimalDistance
+ * @return qreal
+ */
+qreal GraphLayoutEngine::repulsion(const int &model,
+                                   const qreal &dist,
+                                   const qreal &optimalDistance) {
+    qreal f_rep = 0;
+    if ( dist > 2.0 * optimalDistance ) {
+        return 0;
+    }
+    if ( model == Eades ) {
+        const qreal c_rep = 1.0;
+        f_rep = ( dist != 0 ) ? c_rep / ( dist * dist ) : optimalDistance; //move away
+    }
+    else {
+        f_rep = optimalDistance * optimalDistance / dist;
+    }
+    return -f_rep;
+}
+
+
+
+/**
+ * @brief Returns the attractive force between two adjacent points at distance dist.
+ * Eades: a logarithmic spring, c_spring * log10(dist / naturalLength), which
+ * pushes apart closer points. Fruchterman-Reingold: dist^2 / optimalDistance.
+ * @param model
+ * @param dist
+ * @param optimalDistance
+ * @return qreal
+ */
+qreal GraphLayoutEngine::attraction(const int &model,
+                                    const qreal &dist,
+                                    const qreal &optimalDistance) {
+    if ( model == Eades ) {
+        const qreal c_spring = 2;
+        return c_spring * log10( dist / optimalDistance );
+    }
+    return ( dist * dist ) / optimalDistance;
+}
+
+
+
+/**
+ * @brief Adds to (fx, fy) the repulsion of the points begin..end-1 of the tree
+ * on the point (sx, sy). Coincident points, the point itself included, add nothing.
+ * The loop runs in four independent lanes, without branches.
+ */
+void GraphLayoutEngine::repulsionLeaf(const int &begin, const int &end,
+                                      const qreal &sx, const qreal &sy,
+                                      qreal &fx, qreal &fy) const {
+
+    const qreal *px = m_tree.x();
+    const qreal *py = m_tree.y();
+    const qreal k = m_optimalDistance;
+    const qreal cutoff2 = 4.0 * k * k;
+    const bool eades = ( m_model == Eades );
+
+    qreal ax[4] = { 0, 0, 0, 0 };
+    qreal ay[4] = { 0, 0, 0, 0 };
+
+    int i = begin;
+    for ( ; i + 4 <= end; i += 4) {
+        for (int j = 0; j < 4; ++j) {
+            const qreal dx = px[i+j] - sx;
+            const qreal dy = py[i+j] - sy;
+            const qreal d2 = dx * dx + dy * dy;
+            const qreal f = eades ? -1.0 / d2 : - k * k / std::sqrt(d2);
+            const qreal f_rep = ( d2 > 0 && d2 <= cutoff2 ) ? f : 0;
+            ax[j] += signOf(dx) * f_rep;
+            ay[j] += signOf(dy) * f_rep;
+        }
+    }
+    for ( ; i < end; ++i) {
+        const qreal dx = px[i] - sx;
+        const qreal dy = py[i] - sy;
+        const qreal d2 = dx * dx + dy * dy;
+        if ( d2 > 0 && d2 <= cutoff2 ) {
+            const qreal f_rep = eades ? -1.0 / d2 : - k * k / std::sqrt(d2);
+            ax[0] += signOf(dx) * f_rep;
+            ay[0] += signOf(dy) * f_rep;
+        }
+    }
+
+    fx += ( ax[0] + ax[1] ) + ( ax[2] + ax[3] );
+    fy += ( ay[0] + ay[1] ) + ( ay[2] + ay[3] );
+}
+
+
+
+/**
+ * @brief Computes the displacement of every point for one iteration, from the
+ * current positions. The points are handled in parallel blocks.
+ */
+void GraphLayoutEngine::computeDisplacements() {
+
+    const int n = size();
+
+    m_tree.build(m_x, m_y, m_points);
+
+    const qreal k = m_optimalDistance;
+    const qreal cutoff = 2.0 * k;
+
+    QVector<int> blocks;
+    for (int first = 0; first < n; first += FORCE_BLOCK) {
+        blocks << first;
+    }
+
+    QtConcurrent::blockingMap(blocks, [&](const int &first) {
+
+        const int last = qMin( n, first + FORCE_BLOCK );
+
+        for (int s = first; s < last; ++s) {
+
+            const qreal sx = m_x[s], sy = m_y[s];
+            qreal fx = 0, fy = 0;
+
+            // repulsive forces
+            m_tree.visit( sx, sy, m_theta, cutoff,
+                          [&](const qreal &cx, const qreal &cy, const int &mass) {
+                const qreal dx = cx - sx, dy = cy - sy;
+                const qreal f_rep = mass * repulsion( m_model, std::sqrt( dx * dx + dy * dy ), k );
+                fx += signOf(dx) * f_rep;
+                fy += signOf(dy) * f_rep;
+            },
+                          [&](const int &begin, const int &end) {
+                repulsionLeaf(begin, end, sx, sy, fx, fy);
+            } );
+
+            // attractive forces between adjacent points
+            for (int e = m_incidentOffsets[s]; e < m_incidentOffsets[s+1]; ++e) {
+                const int t = m_incident[e];
+                const qreal dx = m_x[t] - sx, dy = m_y[t] - sy;
+                const qreal d2 = dx * dx + dy * dy;
+                if ( d2 == 0 ) {
+                    continue;
+                }
+                const qreal f_att = attraction( m_model, std::sqrt(d2), k );
+                fx += signOf(dx) * f_att;
+                fy += signOf(dy) * f_att;
+            }
+
+            m_dispX[s] = fx;
+            m_dispY[s] = fy;
+        }
+    });
+}
+
+
+
+/**
+ * @brief Moves every point by its displacement, limited to the temperature
+ * on each axis, as in Fruchterman-Reingold, and keeps it inside the bounds.
+ * @param temperature
+ */
+void GraphLayoutEngine::moveByTemperature(const qreal &temperature) {
+    const int n = size();
+    for (int s = 0; s < n; ++s) {
+        const qreal xvel = signOf( m_dispX[s] ) * qMin( qAbs( m_dispX[s] ), temperature );
+        const qreal yvel = signOf( m_dispY[s] ) * qMin( qAbs( m_dispY[s] ), temperature );
+        m_x[s] = qMin( m_maxX, qMax( m_minX, m_x[s] + xvel ) );
+        m_y[s] = qMin( m_maxY, qMax( m_minY, m_y[s] + yvel ) );
+    }
+}
+
+
+
+/**
+ * @brief Moves every point by c4 times its displacement, as in Eades,
+ * and keeps it inside the bounds.
+ * @param c4
+ */
+void GraphLayoutEngine::moveByFactor(const qreal &c4) {
+    const int n = size();
+    for (int s = 0; s < n; ++s) {
+        qreal xvel = c4 * m_dispX[s];
+        qreal yvel = c4 * m_dispY[s];
+        // a positive move below one pixel would be floored away on the canvas
+        if ( xvel < 1 && xvel > 0 )
+            xvel = 1;
+        if ( yvel < 1 && yvel > 0 )
+            yvel = 1;
+        m_x[s] = qMin( m_maxX, qMax( m_minX, m_x[s] + xvel ) );
+        m_y[s] = qMin( m_maxY, qMax( m_minY, m_y[s] + yvel ) );
+    }
+}
@@ -0,0 +1,108 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphlayoutengine.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHLAYOUTENGINE_H
+#define GRAPHLAYOUTENGINE_H
+
+#include <QtGlobal>
+#include <vector>
+
+#include "graphquadtree.h"
+
+using namespace std;
+
+
+/**
+ * @brief The GraphLayoutEngine class
+ * Runs the iterations of the Eades and Fruchterman-Reingold force-directed
+ * models on contiguous arrays of positions and displacements, instead of
+ * on the GraphVertex objects, which are only written back when the layout is done.
+ * Points are 0..n-1, joined by the arcs given to setArcs(). The forces of each
+ * point are computed in parallel blocks: the repulsion through a Barnes-Hut
+ * GraphQuadTree, with a leaf kernel that runs over the contiguous positions
+ * in lanes of four, so that the compiler can vectorize it, and the attraction
+ * along the arcs incident to the point.
+ */
+class GraphLayoutEngine
+{
+public:
+    enum Model {
+        Eades = 0,
+        FruchtermanReingold = 1
+    };
+
+    GraphLayoutEngine();
+
+    void setModel(const int &model, const qreal &optimalDistance, const qreal &theta);
+
+    void setBounds(const qreal &minX, const qreal &maxX,
+                   const qreal &minY, const qreal &maxY);
+
+    void setArcs(const vector<int> &offsets, const vector<int> &targets);
+
+    /** Number of points, as given to setArcs() */
+    int size() const { return (int) m_incidentOffsets.size() - 1; }
+
+    /** Positions of the points, to read and write between iterations */
+    vector<qreal> &x() { return m_x; }
+    vector<qreal> &y() { return m_y; }
+    const vector<qreal> &x() const { return m_x; }
+    const vector<qreal> &y() const { return m_y; }
+
+    void computeDisplacements();
+
+    void moveByTemperature(const qreal &temperature);
+
+    void moveByFactor(const qreal &c4);
+
+    static qreal repulsion(const int &model, const qreal &dist, const qreal &optimalDistance);
+
+    static qreal attraction(const int &model, const qreal &dist, const qreal &optimalDistance);
+
+private:
+    void repulsionLeaf(const int &begin, const int &end,
+                       const qreal &sx, const qreal &sy,
+                       qreal &fx, qreal &fy) const;
+
+    int m_model;
+    qreal m_optimalDistance;
+    qreal m_theta;
+    qreal m_minX, m_maxX, m_minY, m_maxY;
+
+    vector<qreal> m_x, m_y;
+    vector<qreal> m_dispX, m_dispY;
+
+    // both ends of every arc, with multiplicity: arc s->t is in the rows of s and t
+    vector<int> m_incidentOffsets;
+    vector<int> m_incident;
+
+    vector<int> m_points;
+    GraphQuadTree m_tree;
+};
+
+#endif // GRAPHLAYOUTENGINE_H
@@ -0,0 +1,271 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphneighborhood.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphneighborhood.h"
+
+#include "graphcsr.h"
+
+#include <QtDebug>
+
+
+
+GraphNeighborhood::GraphNeighborhood() :
+    m_epoch(0)
+{
+}
+
+
+
+/**
+ * @brief Starts a new query on n vertices.
+ * Grows the arrays if the graph has grown and moves to the next stamp, so
+ * that every vertex is unvisited again. Only when the stamp wraps around,
+ * once every 2^32 queries, are the arrays cleared.
+ * @param n
+ */
+void GraphNeighborhood::prepare(const int &n) {
+    if ( m_stamp.size() < n ) {
+        m_stamp.resize(n);
+        m_dist.resize(n);
+        m_stampBack.resize(n);
+        m_distBack.resize(n);
+    }
+    if ( ++m_epoch == 0 ) {
+        m_stamp.fill(0);
+        m_stampBack.fill(0);
+        m_epoch = 1;
+    }
+    m_queue.clear();
+    m_queueBack.clear();
+    m_hopSizes.clear();
+}
+
+
+
+/**
+ * @brief Visits the neighbors of the vertices of the current level of queue,
+ * that is from head to its end, and appends the unvisited ones at distance d.
+ * If otherStamp is given, the vertices already reached from the other side
+ * close a path, and best keeps the shortest one.
+ * @param csr
+ * @param outbound follow the outbound arcs
+ * @param inbound follow the inbound arcs
+ * @param queue
+ * @param head
+ * @param stamp
+ * @param dist
+ * @param otherStamp
+ * @param otherDist
+ * @param d
+ * @param best
+ */
+void GraphNeighborhood::expandLevel(const GraphCSR &csr,
+                                    const bool &outbound, const bool &inbound,
+                                    QVector<int> &queue, int &head,
+                                    QVector<quint32> &stamp, QVector<int> &dist,
+                                    const QVector<quint32> *otherStamp,
+                                    const QVector<int> *otherDist,
+                                    const int &d, int &best) {
+
+    auto visit = [&](const int &w) {
+        if ( stamp[w] == m_epoch || !csr.isEnabled(w) ) {
+            return;
+        }
+        stamp[w] = m_epoch;
+        dist[w] = d;
+        queue.append(w);
+        if ( otherStamp && (*otherStamp)[w] == m_epoch ) {
+            const int length = d + (*otherDist)[w];
+            if ( best < 0 || length < best ) {
+                best = length;
+            }
+        }
+    };
+
+    const int levelEnd = queue.size();
+    for ( ; head < levelEnd; ++head ) {
+        const int u = queue[head];
+        if ( outbound ) {
+            for (int e = csr.outBegin(u); e < csr.outEnd(u); ++e) {
+                visit( csr.outTarget(e) );
+            }
+        }
+        if ( inbound ) {
+            for (int e = csr.inBegin(u); e < csr.inEnd(u); ++e) {
+                visit( csr.inSource(e) );
+            }
+        }
+    }
+}
+
+
+
+/**
+ * @brief Finds the vertices within hops from source, by breadth-first search.
+ * The result is in vertices(), hops() and hopSizes(), until the next query.
+ * @param csr
+ * @param source the CSR index of the source vertex
+ * @param hops the maximum distance
+ * @param direction
+ * @return the number of vertices found, source included
+ */
+int GraphNeighborhood::query(const GraphCSR &csr, const int &source,
+                             const int &hops, const Direction &direction) {
+
+    prepare( csr.vertices() );
+
+    if ( source < 0 || source >= csr.vertices() || !csr.isEnabled(source) ) {
+        qDebug() << "GraphNeighborhood::query() - invalid source" << source;
+        return 0;
+    }
+
+    m_stamp[source] = m_epoch;
+    m_dist[source] = 0;
+    m_queue.append(source);
+    m_hopSizes.append(1);
+
+    int head = 0, best = -1;
+    for (int d = 1; d <= hops && head < m_queue.size(); ++d) {
+        const int levelEnd = m_queue.size();
+        expandLevel(csr, direction != In, direction != Out,
+                    m_queue, head, m_stamp, m_dist, nullptr, nullptr, d, best);
+        if ( m_queue.size() == levelEnd ) {
+            break;
+        }
+        m_hopSizes.append( m_queue.size() - levelEnd );
+    }
+
+    return m_queue.size();
+}
+
+
+
+/**
+ * @brief Returns the distance from source to target, if it is at most hops,
+ * or -1 otherwise.
+ * Searches from both ends at once, one level at a time, each time expanding
+ * the side with the smaller frontier, and stops as soon as the two searches
+ * meet. Thus it visits about two balls of radius hops/2, instead of one of
+ * radius hops. The backward search follows the arcs in reverse.
+ * It reuses the arrays of query(), so the results of the last query are lost.
+ * @param csr
+ * @param source the CSR index of the source vertex
+ * @param target the CSR index of the target vertex
+ * @param hops the maximum distance
+ * @param direction
+ * @return
+ */
+int GraphNeighborhood::distance(const GraphCSR &csr, const int &source,
+                                const int &target, const int &hops,
+                                const Direction &direction) {
+
+    prepare( csr.vertices() );
+
+    const int n = csr.vertices();
+    if ( source < 0 || source >= n || target < 0 || target >= n
+         || !csr.isEnabled(source) || !csr.isEnabled(target) ) {
+        return -1;
+    }
+    if ( source == target ) {
+        return 0;
+    }
+
+    m_stamp[source] = m_epoch;
+    m_dist[source] = 0;
+    m_queue.append(source);
+    m_stampBack[target] = m_epoch;
+    m_distBack[target] = 0;
+    m_queueBack.append(target);
+
+    int headForward = 0, headBack = 0;
+    int depthForward = 0, depthBack = 0;
+    int best = -1;
+
+    while ( depthForward + depthBack < hops ) {
+        const int frontierForward = m_queue.size() - headForward;
+        const int frontierBack = m_queueBack.size() - headBack;
+        if ( frontierForward == 0 || frontierBack == 0 ) {
+            return -1;
+        }
+        if ( frontierForward <= frontierBack ) {
+            ++depthForward;
+            expandLevel(csr, direction != In, direction != Out,
+                        m_queue, headForward, m_stamp, m_dist,
+                        &m_stampBack, &m_distBack, depthForward, best);
+        }
+        else {
+            ++depthBack;
+            expandLevel(csr, direction != Out, direction != In,
+                        m_queueBack, headBack, m_stampBack, m_distBack,
+                        &m_stamp, &m_dist, depthBack, best);
+        }
+        // Every shorter path would have met in an earlier level
+        if ( best >= 0 ) {
+            return best;
+        }
+    }
+
+    return -1;
+}
+
+
+
+/**
+ * @brief Returns the number of arcs among the vertices of the last query,
+ * that is the arcs of its ego network.
+ * @param csr the snapshot of the last query
+ * @return
+ */
+int GraphNeighborhood::egoArcs(const GraphCSR &csr) const {
+    int arcs = 0;
+    for (int k = 0; k < m_queue.size(); ++k) {
+        const int u = m_queue[k];
+        for (int e = csr.outBegin(u); e < csr.outEnd(u); ++e) {
+            if ( contains( csr.outTarget(e) ) ) {
+                ++arcs;
+            }
+        }
+    }
+    return arcs;
+}
+
+
+
+/**
+ * @brief Returns the density of the ego network of the last query,
+ * that is egoArcs() / ( N * (N-1) ), N the number of its vertices.
+ * @param csr the snapshot of the last query
+ * @return
+ */
+qreal GraphNeighborhood::egoDensity(const GraphCSR &csr) const {
+    const qreal n = m_queue.size();
+    if ( n < 2 ) {
+        return 0;
+    }
+    return egoArcs(csr) / ( n * ( n - 1 ) );
+}
@@ -0,0 +1,105 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphneighborhood.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHNEIGHBORHOOD_H
+#define GRAPHNEIGHBORHOOD_H
+
+#include <QtGlobal>
+#include <QVector>
+
+class GraphCSR;
+
+
+/**
+ * @brief The GraphNeighborhood class
+ * Bounded breadth-first queries around a vertex of a GraphCSR snapshot:
+ * the vertices within k hops (the k-hop neighborhood and its ego network)
+ * and the distance between two vertices up to k hops, by a bidirectional
+ * search that meets in the middle.
+ * The visited marks are stamped with a query counter, so that a new query
+ * does not clear them, and the arrays are kept between the queries. Hence
+ * a query costs as much as the part of the graph it reaches, not the size
+ * of the graph, once the arrays have grown to the number of vertices.
+ * Vertices are addressed by their CSR index. Disabled vertices are skipped.
+ */
+class GraphNeighborhood
+{
+public:
+    /** Which arcs a query follows */
+    enum Direction {
+        Out,    // outbound arcs
+        In,     // inbound arcs
+        Both    // both, as if the graph was undirected
+    };
+
+    GraphNeighborhood();
+
+    int query(const GraphCSR &csr, const int &source, const int &hops,
+              const Direction &direction = Both);
+
+    int distance(const GraphCSR &csr, const int &source, const int &target,
+                 const int &hops, const Direction &direction = Out);
+
+    /** The vertices of the last query(), in breadth-first order, source first */
+    const QVector<int> &vertices() const { return m_queue; }
+
+    /** The number of vertices at each hop of the last query, index 0 the source */
+    const QVector<int> &hopSizes() const { return m_hopSizes; }
+
+    /** Returns true if the vertex at index i was reached by the last query */
+    bool contains(const int &i) const {
+        return i >= 0 && i < m_stamp.size() && m_stamp[i] == m_epoch;
+    }
+
+    /** Returns the hops from the source to vertex i in the last query, or -1 */
+    int hops(const int &i) const { return contains(i) ? m_dist[i] : -1; }
+
+    int egoArcs(const GraphCSR &csr) const;
+
+    qreal egoDensity(const GraphCSR &csr) const;
+
+private:
+    void prepare(const int &n);
+    void expandLevel(const GraphCSR &csr, const bool &outbound, const bool &inbound,
+                     QVector<int> &queue, int &head,
+                     QVector<quint32> &stamp, QVector<int> &dist,
+                     const QVector<quint32> *otherStamp, const QVector<int> *otherDist,
+                     const int &d, int &best);
+
+    quint32 m_epoch;
+    QVector<quint32> m_stamp;       // m_epoch if the vertex was reached forwards
+    QVector<int> m_dist;
+    QVector<int> m_queue;
+    QVector<int> m_hopSizes;
+
+    QVector<quint32> m_stampBack;   // m_epoch if the vertex was reached backwards, see distance()
+    QVector<int> m_distBack;
+    QVector<int> m_queueBack;
+};
+
+#endif // GRAPHNEIGHBORHOOD_H
@@ -0,0 +1,143 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphprogress.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphprogress.h"
+
+
+/**
+ * @brief Creates a reporter which publishes at most every interval msecs
+ * @param interval
+ */
+GraphProgress::GraphProgress(const int &interval) :
+    m_interval(interval),
+    m_total(0),
+    m_value(0),
+    m_published(0)
+{
+    m_timer.start();
+}
+
+
+/**
+ * @brief Starts a computation of total steps, saving the running one, if any.
+ * Call it from the thread which drives the computation.
+ * @param total
+ */
+void GraphProgress::start(const int &total) {
+    Saved saved;
+    saved.value = m_value.loadAcquire();
+    saved.total = m_total;
+    saved.timer = m_timer;
+    m_saved.append(saved);
+
+    m_total = total;
+    m_value.storeRelease(0);
+    m_timer.start();
+    // so that the first update is published at once
+    m_published.storeRelease( -m_interval );
+}
+
+
+/**
+ * @brief Ends the current computation, and goes back to the one it was part of.
+ */
+void GraphProgress::finish() {
+    if ( m_saved.isEmpty() ) {
+        return;
+    }
+    const Saved saved = m_saved.takeLast();
+    m_total = saved.total;
+    m_value.storeRelease( saved.value );
+    m_timer = saved.timer;
+}
+
+
+/**
+ * @brief Sets the number of steps done.
+ * @param value
+ * @return true if the progress should be published now
+ */
+bool GraphProgress::update(const int &value) {
+    m_value.storeRelease(value);
+    return due(value);
+}
+
+
+/**
+ * @brief Adds count steps done; safe to call from many threads at once.
+ * @param count
+ * @return true if the progress should be published now
+ */
+bool GraphProgress::add(const int &count) {
+    return due( m_value.fetchAndAddOrdered(count) + count );
+}
+
+
+/**
+ * @brief Returns true if value finishes the computation, or if interval msecs
+ * have passed since the last publish. Only one of the threads which ask at the
+ * same time gets true.
+ * @param value
+ * @return
+ */
+bool GraphProgress::due(const int &value) {
+    const qint64 now = m_timer.elapsed();
+    if ( m_total > 0 && value >= m_total ) {
+        m_published.storeRelease(now);
+        return true;
+    }
+    const qint64 last = m_published.loadAcquire();
+    if ( now - last < m_interval ) {
+        return false;
+    }
+    return m_published.testAndSetOrdered(last, now);
+}
+
+
+/**
+ * @brief Returns the steps done per second, since the computation started.
+ * @return
+ */
+qreal GraphProgress::throughput() const {
+    const qint64 elapsed = m_timer.elapsed();
+    return ( elapsed > 0 ) ? 1000.0 * value() / elapsed : 0;
+}
+
+
+/**
+ * @brief Returns the estimated msecs left, or -1 if it is not known yet.
+ * @return
+ */
+qint64 GraphProgress::eta() const {
+    const int done = value();
+    if ( done <= 0 || m_total <= 0 ) {
+        return -1;
+    }
+    const qint64 elapsed = m_timer.elapsed();
+    return qMax( (qint64) 0, elapsed * ( m_total - done ) / done );
+}
@@ -0,0 +1,86 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphprogress.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHPROGRESS_H
+#define GRAPHPROGRESS_H
+
+#include <QtGlobal>
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QVector>
+
+
+/**
+ * @brief The GraphProgress class
+ * Keeps the progress of the running computation of a Graph in an atomic
+ * counter, which loops on any thread may update at no cost, and decides when
+ * the progress is worth publishing to the GUI: at most once every interval
+ * msecs, and when the computation is done.
+ * It also estimates the throughput and the time left.
+ * Computations may nest: start() saves the progress of the outer one, and
+ * finish() restores it.
+ */
+class GraphProgress
+{
+public:
+    explicit GraphProgress(const int &interval = 100);
+
+    void start(const int &total);
+    void finish();
+
+    bool update(const int &value);
+    bool add(const int &count = 1);
+
+    int value() const { return m_value.loadAcquire(); }
+    int total() const { return m_total; }
+
+    /** Number of computations running, including the nested ones */
+    int depth() const { return m_saved.size(); }
+
+    qreal throughput() const;
+    qint64 eta() const;
+
+private:
+    bool due(const int &value);
+
+    struct Saved {
+        int value;
+        int total;
+        QElapsedTimer timer;
+    };
+
+    int m_interval;
+    int m_total;
+    QAtomicInt m_value;
+    QAtomicInteger<qint64> m_published;
+    QElapsedTimer m_timer;
+    QVector<Saved> m_saved;
+};
+
+#endif // GRAPHPROGRESS_H
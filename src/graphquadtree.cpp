@@ -0,0 +1,239 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphquadtree.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphquadtree.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+/** Leaves hold at most this many points, unless they reach the depth limit */
+static const int LEAF_CAPACITY = 8;
+
+/** Coincident points end up in one leaf at this depth */
+static const int MAX_DEPTH = 32;
+
+
+GraphQuadTree::GraphQuadTree()
+{
+}
+
+
+
+/**
+ * @brief Empties the tree.
+ */
+void GraphQuadTree::clear() {
+    m_cells.clear();
+    m_points.clear();
+    m_px.clear();
+    m_py.clear();
+}
+
+
+
+/**
+ * @brief Builds the tree over the given points, with positions (x[i], y[i]).
+ * @param x
+ * @param y
+ * @param points the indices of the points to insert
+ */
+void GraphQuadTree::build(const vector<qreal> &x,
+                          const vector<qreal> &y,
+                          const vector<int> &points) {
+    clear();
+
+    if ( points.empty() ) {
+        return;
+    }
+
+    m_points = points;
+    m_px.resize( points.size() );
+    m_py.resize( points.size() );
+
+    qreal minX = x[ points[0] ], maxX = minX;
+    qreal minY = y[ points[0] ], maxY = minY;
+    for (size_t k = 0; k < points.size(); ++k) {
+        m_px[k] = x[ points[k] ];
+        m_py[k] = y[ points[k] ];
+        minX = qMin( minX, m_px[k] );
+        maxX = qMax( maxX, m_px[k] );
+        minY = qMin( minY, m_py[k] );
+        maxY = qMax( maxY, m_py[k] );
+    }
+
+    m_cells.reserve( 2 * points.size() / LEAF_CAPACITY + 1 );
+    buildCell( minX, minY, qMax( qMax( maxX - minX, maxY - minY ), (qreal) 1 ),
+               0, (int) points.size(), 0 );
+}
+
+
+
+/**
+ * @brief Builds the cell of the given square over the points begin..end-1 of
+ * m_points, which it reorders by quadrant, and returns its index in m_cells.
+ */
+int GraphQuadTree::buildCell(const qreal &x0, const qreal &y0, const qreal &size,
+                             const int &begin, const int &end, const int &depth) {
+
+    const int index = (int) m_cells.size();
+    m_cells.push_back( Cell() );
+
+    Cell cell;
+    cell.x0 = x0;
+    cell.y0 = y0;
+    cell.size = size;
+    cell.mass = end - begin;
+    cell.begin = begin;
+    cell.end = end;
+    cell.child[0] = cell.child[1] = cell.child[2] = cell.child[3] = -1;
+
+    qreal sumX = 0, sumY = 0;
+    for (int k = begin; k < end; ++k) {
+        sumX += m_px[k];
+        sumY += m_py[k];
+    }
+    cell.cx = sumX / cell.mass;
+    cell.cy = sumY / cell.mass;
+
+    if ( cell.mass > LEAF_CAPACITY && depth < MAX_DEPTH ) {
+
+        // Partition the points by quadrant: 0 = (low x, low y), 1 = (high x, low y),
+        // 2 = (low x, high y), 3 = (high x, high y)
+        const qreal half = size / 2.0;
+        const qreal midX = x0 + half, midY = y0 + half;
+        int bounds[5];
+        bounds[0] = begin;
+        bounds[4] = end;
+
+        auto partition = [&](const int &from, const int &to,
+                             const bool &byX, const qreal &mid) {
+            int i = from, j = to;
+            while ( i < j ) {
+                if ( ( byX ? m_px[i] : m_py[i] ) < mid ) {
+                    ++i;
+                }
+                else {
+                    --j;
+                    std::swap( m_points[i], m_points[j] );
+                    std::swap( m_px[i], m_px[j] );
+                    std::swap( m_py[i], m_py[j] );
+                }
+            }
+            return i;
+        };
+
+        bounds[2] = partition( begin, end, false, midY );
+        bounds[1] = partition( begin, bounds[2], true, midX );
+        bounds[3] = partition( bounds[2], end, true, midX );
+
+        for (int q = 0; q < 4; ++q) {
+            if ( bounds[q] < bounds[q+1] ) {
+                cell.child[q] = buildCell( ( q & 1 ) ? midX : x0,
+                                           ( q & 2 ) ? midY : y0,
+                                           half,
+                                           bounds[q], bounds[q+1], depth + 1 );
+            }
+        }
+    }
+
+    m_cells[index] = cell;
+    return index;
+}
+
+
+
+/**
+ * @brief Walks the tree from the point (px, py).
+ * A cell stands for its points when its size is less than theta times the
+ * distance from (px, py) to its centroid, and (px, py) is outside it; then
+ * cell(cx, cy, mass) gets the centroid and the number of points. Otherwise the
+ * walk goes down to the leaves, whose points begin..end-1 of x(), y() and
+ * points() go to leaf(begin, end); the point at (px, py) itself is among them.
+ * If cutoff > 0, the cells farther than cutoff from (px, py) are skipped, but
+ * the points of a leaf still need to be checked against it.
+ * A theta of 0 reports all the leaves within the cutoff, that is the exact sum.
+ * @param px
+ * @param py
+ * @param theta
+ * @param cutoff
+ * @param cell
+ * @param leaf
+ */
+void GraphQuadTree::visit(const qreal &px,
+                          const qreal &py,
+                          const qreal &theta,
+                          const qreal &cutoff,
+                          const std::function<void (const qreal &,
+                                                    const qreal &,
+                                                    const int &)> &cell,
+                          const std::function<void (const int &,
+                                                    const int &)> &leaf) const {
+    if ( m_cells.empty() ) {
+        return;
+    }
+
+    const qreal cutoff2 = cutoff * cutoff;
+    int stack[ 4 * MAX_DEPTH + 4 ];
+    int top = 0;
+    stack[top++] = 0;
+
+    while ( top > 0 ) {
+
+        const Cell &c = m_cells[ stack[--top] ];
+
+        // distance from the point to the square of the cell
+        const qreal dx = qMax( qMax( c.x0 - px, px - ( c.x0 + c.size ) ), (qreal) 0 );
+        const qreal dy = qMax( qMax( c.y0 - py, py - ( c.y0 + c.size ) ), (qreal) 0 );
+        if ( cutoff > 0 && dx * dx + dy * dy > cutoff2 ) {
+            continue;
+        }
+
+        const bool isLeaf = ( c.child[0] < 0 && c.child[1] < 0
+                              && c.child[2] < 0 && c.child[3] < 0 );
+
+        if ( isLeaf ) {
+            leaf( c.begin, c.end );
+            continue;
+        }
+
+        if ( theta > 0 && ( dx > 0 || dy > 0 ) ) {
+            const qreal cdx = c.cx - px, cdy = c.cy - py;
+            if ( c.size * c.size < theta * theta * ( cdx * cdx + cdy * cdy ) ) {
+                cell( c.cx, c.cy, c.mass );
+                continue;
+            }
+        }
+
+        for (int q = 0; q < 4; ++q) {
+            if ( c.child[q] >= 0 ) {
+                stack[top++] = c.child[q];
+            }
+        }
+    }
+}
@@ -0,0 +1,94 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphquadtree.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHQUADTREE_H
+#define GRAPHQUADTREE_H
+
+#include <QtGlobal>
+#include <vector>
+#include <functional>
+
+using namespace std;
+
+
+/**
+ * @brief The GraphQuadTree class
+ * A Barnes-Hut quadtree over the positions of a set of vertices, used by the
+ * force-directed layouts to sum the repulsive forces in O(N log N) instead of O(N^2).
+ * Every cell keeps the number of vertices inside it and their centroid.
+ * visit() walks the tree from a given point and reports either whole cells that
+ * are far enough to stand for all their vertices, or the points of the leaves,
+ * as ranges of the contiguous arrays x(), y() and points().
+ * Points are addressed by the indices given to build().
+ */
+class GraphQuadTree
+{
+public:
+    GraphQuadTree();
+
+    void build(const vector<qreal> &x,
+               const vector<qreal> &y,
+               const vector<int> &points);
+
+    void clear();
+
+    bool isEmpty() const { return m_cells.empty(); }
+
+    void visit(const qreal &px,
+               const qreal &py,
+               const qreal &theta,
+               const qreal &cutoff,
+               const std::function<void (const qreal &cx,
+                                         const qreal &cy,
+                                         const int &mass)> &cell,
+               const std::function<void (const int &begin,
+                                         const int &end)> &leaf) const;
+
+    /** Positions and indices of the points, grouped by leaf */
+    const qreal *x() const { return m_px.data(); }
+    const qreal *y() const { return m_py.data(); }
+    const int *points() const { return m_points.data(); }
+
+private:
+    struct Cell {
+        qreal x0, y0, size;     // the square of the cell
+        qreal cx, cy;           // centroid of its points
+        int mass;               // number of points
+        int child[4];           // -1 if none, all -1 in leaves
+        int begin, end;         // the points of a leaf in m_points
+    };
+
+    int buildCell(const qreal &x0, const qreal &y0, const qreal &size,
+                  const int &begin, const int &end, const int &depth);
+
+    vector<Cell> m_cells;
+    vector<int> m_points;       // point indices, grouped by leaf
+    vector<qreal> m_px, m_py;   // their positions, in the same order
+};
+
+#endif // GRAPHQUADTREE_H
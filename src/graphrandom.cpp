@@ -0,0 +1,124 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphrandom.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphrandom.h"
+
+
+static inline quint64 rotl(const quint64 &x, const int &k) {
+    return ( x << k ) | ( x >> ( 64 - k ) );
+}
+
+
+GraphRandom::GraphRandom(const quint64 &seed)
+{
+    this->seed(seed);
+}
+
+
+
+/**
+ * @brief Restarts the generator from the given seed.
+ * The four words of the state are filled by splitmix64, as the xoshiro
+ * authors recommend, so that any seed (even 0) gives a good state.
+ * @param seed
+ */
+void GraphRandom::seed(const quint64 &seed) {
+    quint64 z = seed;
+    for (int i = 0; i < 4; ++i) {
+        z += 0x9e3779b97f4a7c15ULL;
+        quint64 x = z;
+        x = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+        x = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebULL;
+        m_state[i] = x ^ ( x >> 31 );
+    }
+}
+
+
+
+/**
+ * @brief Returns the next random 64-bit number.
+ * @return quint64
+ */
+GraphRandom::result_type GraphRandom::operator()() {
+    const quint64 result = rotl( m_state[1] * 5, 7 ) * 9;
+    const quint64 t = m_state[1] << 17;
+
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+
+    m_state[2] ^= t;
+    m_state[3] = rotl( m_state[3], 45 );
+
+    return result;
+}
+
+
+
+/**
+ * @brief Advances the generator by 2^128 draws, as if operator() had been
+ * called that many times.
+ */
+void GraphRandom::jump() {
+    static const quint64 JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                    0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+    quint64 s[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; ++i) {
+        for (int b = 0; b < 64; ++b) {
+            if ( JUMP[i] & ( (quint64) 1 << b ) ) {
+                s[0] ^= m_state[0];
+                s[1] ^= m_state[1];
+                s[2] ^= m_state[2];
+                s[3] ^= m_state[3];
+            }
+            (*this)();
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        m_state[i] = s[i];
+    }
+}
+
+
+
+/**
+ * @brief Returns the k-th independent stream of this generator, that is a
+ * copy jumped k+1 times. This generator is not changed.
+ * Stream k never overlaps this generator or any other stream for 2^128 draws.
+ * It takes k+1 jumps; callers that need many streams should jump() a copy instead.
+ * @param k
+ * @return GraphRandom
+ */
+GraphRandom GraphRandom::stream(const int &k) const {
+    GraphRandom rng(*this);
+    for (int i = 0; i <= k; ++i) {
+        rng.jump();
+    }
+    return rng;
+}
@@ -0,0 +1,88 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphrandom.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHRANDOM_H
+#define GRAPHRANDOM_H
+
+#include <QtGlobal>
+
+using namespace std;
+
+
+/**
+ * @brief The GraphRandom class
+ * A seedable 64-bit pseudo-random number generator (xoshiro256**), owned by
+ * Graph and used by the random network generators and the random layouts.
+ * The same seed always gives the same sequence, on every platform.
+ * A generator can jump ahead by 2^128 draws, so stream(k) returns independent,
+ * non-overlapping generators, one per block of work, that parallel code can use
+ * without locking and still give the same output for any number of threads.
+ * It meets the UniformRandomBitGenerator requirements, so it works with the
+ * std random distributions too.
+ */
+class GraphRandom
+{
+public:
+    typedef quint64 result_type;
+
+    GraphRandom(const quint64 &seed = 0);
+
+    void seed(const quint64 &seed);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~( (result_type) 0 ); }
+
+    result_type operator()();
+
+    /** Returns a random integer in 0..n-1, for n > 0 */
+    int bounded(const int &n) {
+        return (int) ( ( ( (*this)() >> 32 ) * (quint64) n ) >> 32 );
+    }
+
+    /** Returns a random integer in 0..n-1, for n > 0, without modulo bias */
+    quint64 bounded64(const quint64 &n) {
+        const quint64 threshold = ( 0 - n ) % n;
+        quint64 x = 0;
+        while ( ( x = (*this)() ) < threshold ) { }
+        return x % n;
+    }
+
+    /** Returns a random real in [0,1) */
+    qreal uniform() {
+        return (qreal) ( (*this)() >> 11 ) * ( 1.0 / 9007199254740992.0 );
+    }
+
+    void jump();
+
+    GraphRandom stream(const int &k) const;
+
+private:
+    quint64 m_state[4];
+};
+
+#endif // GRAPHRANDOM_H
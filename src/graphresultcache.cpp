@@ -0,0 +1,223 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphresultcache.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphresultcache.h"
+
+#include <QtDebug>
+#include <QList>
+
+
+
+GraphResultCache::GraphResultCache()
+{
+}
+
+
+
+/**
+ * @brief Packs the parameters of a prominence index computation into a key
+ * @param considerWeights
+ * @param inverseWeights
+ * @param dropIsolates
+ * @return int
+ */
+int GraphResultCache::parameters(const bool &considerWeights,
+                                 const bool &inverseWeights,
+                                 const bool &dropIsolates) {
+    return ( considerWeights ? ConsiderWeights : 0 )
+            | ( ( considerWeights && inverseWeights ) ? InverseWeights : 0 )
+            | ( dropIsolates ? DropIsolates : 0 );
+}
+
+
+
+/**
+ * @brief Drops all results
+ */
+void GraphResultCache::clear() {
+    m_results.clear();
+    m_live.clear();
+}
+
+
+
+/**
+ * @brief Drops the results of index for all parameters, i.e. when an option
+ * of its algorithm has changed
+ * @param index
+ */
+void GraphResultCache::remove(const int &index) {
+    for (int parameters = 0; parameters < 8; ++parameters) {
+        m_results.remove( key(index, parameters) );
+    }
+    m_live.remove(index);
+}
+
+
+
+/**
+ * @brief Returns true if the results stored in the vertices for this index
+ * were computed with these parameters on this graph version
+ * @param index
+ * @param parameters
+ * @param version
+ * @return bool
+ */
+bool GraphResultCache::isLive(const int &index,
+                              const int &parameters,
+                              const quint64 &version) const {
+    if ( m_live.value(index, -1) != parameters ) {
+        return false;
+    }
+    return find(index, parameters, version) != nullptr;
+}
+
+
+
+/**
+ * @brief Records that the vertices now hold the results of this index
+ * computed with these parameters
+ * @param index
+ * @param parameters
+ */
+void GraphResultCache::setLive(const int &index, const int &parameters) {
+    m_live.insert(index, parameters);
+}
+
+
+
+/**
+ * @brief Records that the vertices no longer hold any cached results of index,
+ * i.e. because another computation has overwritten their scores
+ * @param index
+ */
+void GraphResultCache::clearLive(const int &index) {
+    m_live.remove(index);
+}
+
+
+
+/**
+ * @brief Returns the result of index for these parameters, or nullptr
+ * if there is none for this graph version
+ * @param index
+ * @param parameters
+ * @param version
+ * @return const Result*
+ */
+const GraphResultCache::Result *GraphResultCache::find(const int &index,
+                                                       const int &parameters,
+                                                       const quint64 &version) const {
+    QHash<int, Result>::const_iterator it = m_results.constFind( key(index, parameters) );
+    if ( it == m_results.constEnd() || it.value().version != version ) {
+        return nullptr;
+    }
+    return &it.value();
+}
+
+
+
+/**
+ * @brief Returns a fresh result slot for index and parameters on this version.
+ * Results of older graph versions are dropped first.
+ * @param index
+ * @param parameters
+ * @param version
+ * @return Result&
+ */
+GraphResultCache::Result &GraphResultCache::insert(const int &index,
+                                                   const int &parameters,
+                                                   const quint64 &version) {
+    QList<int> stale;
+    for (QHash<int, Result>::const_iterator it = m_results.constBegin();
+         it != m_results.constEnd(); ++it) {
+        if ( it.value().version != version ) {
+            stale << it.key();
+        }
+    }
+    for (int i = 0; i < stale.size(); ++i) {
+        m_results.remove( stale[i] );
+    }
+    if ( ! stale.isEmpty() ) {
+        qDebug() << "GraphResultCache::insert() - dropped" << stale.size()
+                 << "results of older graph versions";
+    }
+
+    Result &result = m_results[ key(index, parameters) ];
+    result.version = version;
+    result.reals.clear();
+    result.ints.clear();
+    result.scores.clear();
+    result.distribution.clear();
+    return result;
+}
+
+
+
+/**
+ * @brief Returns the index and parameters of every result held for this
+ * graph version
+ * @param version
+ * @return QList of (index, parameters) pairs
+ */
+QList<QPair<int,int> > GraphResultCache::entries(const quint64 &version) const {
+    QList<QPair<int,int> > list;
+    for (QHash<int, Result>::const_iterator it = m_results.constBegin();
+         it != m_results.constEnd(); ++it) {
+        if ( it.value().version == version ) {
+            list << qMakePair( it.key() >> 3, it.key() & 7 );
+        }
+    }
+    return list;
+}
+
+
+
+/**
+ * @brief Writes a result, without its version, to a stream, see GraphResultStore
+ * @param out
+ * @param result
+ */
+void GraphResultCache::write(QDataStream &out, const Result &result) {
+    out << result.reals << result.ints << result.scores;
+    result.distribution.write(out);
+}
+
+
+
+/**
+ * @brief Reads a result written by write()
+ * @param in
+ * @param result
+ * @return false if the stream is corrupt
+ */
+bool GraphResultCache::read(QDataStream &in, Result &result) {
+    in >> result.reals >> result.ints >> result.scores;
+    result.distribution.read(in);
+    return in.status() == QDataStream::Ok;
+}
@@ -0,0 +1,108 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphresultcache.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHRESULTCACHE_H
+#define GRAPHRESULTCACHE_H
+
+#include <QtGlobal>
+#include <QDataStream>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QVector>
+
+#include "graphdistribution.h"
+
+
+/**
+ * @brief The GraphResultCache class
+ * Keeps the results of the prominence indices of a Graph, keyed by
+ * the index, the parameters it was computed with (weights, inverse weights,
+ * drop isolates) and the structural version of the graph.
+ * Results for different parameters of the same index live side by side,
+ * so asking again for a report with other options does not evict them.
+ * Entries computed for an older graph version are dropped on the next insert.
+ * The cache also remembers which parameters the results currently stored
+ * in the vertices belong to (the "live" results of each index).
+ */
+class GraphResultCache
+{
+public:
+    enum Parameter {
+        ConsiderWeights = 1,
+        InverseWeights  = 2,
+        DropIsolates    = 4
+    };
+
+    struct Result {
+        quint64 version;
+        QVector<qreal> reals;       // graph-wide statistics
+        QVector<int> ints;          // classes, max and min vertex
+        QVector<qreal> scores;      // raw and std score of each vertex
+        GraphDistribution distribution;
+    };
+
+    GraphResultCache();
+
+    static int parameters(const bool &considerWeights,
+                          const bool &inverseWeights,
+                          const bool &dropIsolates);
+
+    void clear();
+
+    void remove(const int &index);
+
+    bool isLive(const int &index, const int &parameters, const quint64 &version) const;
+
+    void setLive(const int &index, const int &parameters);
+
+    void clearLive(const int &index);
+
+    const Result *find(const int &index, const int &parameters, const quint64 &version) const;
+
+    Result &insert(const int &index, const int &parameters, const quint64 &version);
+
+    QList<QPair<int,int> > entries(const quint64 &version) const;
+
+    static void write(QDataStream &out, const Result &result);
+
+    static bool read(QDataStream &in, Result &result);
+
+    /** Number of results held, for all indices and parameters */
+    int size() const { return m_results.size(); }
+
+private:
+    static int key(const int &index, const int &parameters) {
+        return ( index << 3 ) | parameters;
+    }
+
+    QHash<int, Result> m_results;
+    QHash<int, int> m_live;
+};
+
+#endif // GRAPHRESULTCACHE_H
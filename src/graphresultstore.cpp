@@ -0,0 +1,175 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphresultstore.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphresultstore.h"
+
+#include <QtDebug>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+
+static const quint32 RESULT_STORE_MAGIC = 0x534e5652;     // "SNVR"
+static const quint32 RESULT_STORE_FORMAT = 1;
+
+
+
+GraphResultStore::GraphResultStore() :
+    m_enabled(false)
+{
+}
+
+
+
+/**
+ * @brief Enables or disables the store. When disabled, nothing is read or written.
+ * @param toggle
+ */
+void GraphResultStore::setEnabled(const bool &toggle) {
+    m_enabled = toggle;
+}
+
+
+
+/**
+ * @brief Sets the directory under which the store keeps its files,
+ * that is the reports data dir.
+ * @param dir
+ */
+void GraphResultStore::setDirectory(const QString &dir) {
+    m_directory = dir;
+}
+
+
+
+/**
+ * @brief Returns the file of an entry. Entry names may hold any character,
+ * so the file is named by their hash.
+ * @param graphHash
+ * @param entry
+ * @return QString
+ */
+QString GraphResultStore::filePath(const QByteArray &graphHash,
+                                   const QString &entry) const {
+    const QByteArray entryHash =
+            QCryptographicHash::hash( entry.toUtf8(), QCryptographicHash::Sha1 ).toHex();
+    return QDir(m_directory).filePath( QString("socnetv-results/%1/%2.dat")
+                                       .arg( QString::fromLatin1( graphHash.toHex() ) )
+                                       .arg( QString::fromLatin1( entryHash ) ) );
+}
+
+
+
+/**
+ * @brief Reads an entry of the network with the given hash.
+ * The reader gets the stream positioned right after the header and returns
+ * false if it cannot make sense of the payload.
+ * @param graphHash
+ * @param entry
+ * @param reader
+ * @return true if the entry was found and read
+ */
+bool GraphResultStore::read(const QByteArray &graphHash,
+                            const QString &entry,
+                            const std::function<bool(QDataStream &)> &reader) const {
+    if ( ! m_enabled || m_directory.isEmpty() || graphHash.isEmpty() ) {
+        return false;
+    }
+
+    QFile file ( filePath(graphHash, entry) );
+    if ( ! file.open( QIODevice::ReadOnly ) ) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0, format = 0;
+    QByteArray hash;
+    QString name;
+    in >> magic >> format >> hash >> name;
+    if ( in.status() != QDataStream::Ok || magic != RESULT_STORE_MAGIC
+         || format != RESULT_STORE_FORMAT || hash != graphHash || name != entry ) {
+        qDebug() << "GraphResultStore::read() - ignoring stale file" << file.fileName();
+        return false;
+    }
+
+    if ( ! reader(in) || in.status() != QDataStream::Ok ) {
+        qDebug() << "GraphResultStore::read() - corrupt entry" << entry;
+        return false;
+    }
+
+    qDebug() << "GraphResultStore::read() - read" << entry << "from" << file.fileName();
+    return true;
+}
+
+
+
+/**
+ * @brief Writes an entry of the network with the given hash.
+ * The file is replaced atomically, so a failed write keeps the old entry.
+ * @param graphHash
+ * @param entry
+ * @param writer
+ * @return true if the entry was written
+ */
+bool GraphResultStore::write(const QByteArray &graphHash,
+                             const QString &entry,
+                             const std::function<void(QDataStream &)> &writer) const {
+    if ( ! m_enabled || m_directory.isEmpty() || graphHash.isEmpty() ) {
+        return false;
+    }
+
+    const QString fileName = filePath(graphHash, entry);
+    if ( ! QDir().mkpath( QFileInfo(fileName).absolutePath() ) ) {
+        qDebug() << "GraphResultStore::write() - cannot create dir for" << fileName;
+        return false;
+    }
+
+    QSaveFile file ( fileName );
+    if ( ! file.open( QIODevice::WriteOnly ) ) {
+        qDebug() << "GraphResultStore::write() - cannot open" << fileName;
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << RESULT_STORE_MAGIC << RESULT_STORE_FORMAT << graphHash << entry;
+
+    writer(out);
+
+    if ( out.status() != QDataStream::Ok || ! file.commit() ) {
+        qDebug() << "GraphResultStore::write() - failed writing" << fileName;
+        return false;
+    }
+
+    qDebug() << "GraphResultStore::write() - wrote" << entry << "to" << fileName;
+    return true;
+}
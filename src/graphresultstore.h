@@ -0,0 +1,77 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphresultstore.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHRESULTSTORE_H
+#define GRAPHRESULTSTORE_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+
+#include <functional>
+
+
+/**
+ * @brief The GraphResultStore class
+ * An opt-in on-disk store of analysis results, so that re-opening the same
+ * network does not recompute them. Each result (an "entry", i.e. the
+ * proximity prestige computed with weights) is kept in its own file under
+ * <reports data dir>/socnetv-results/<graph hash>/, where the graph hash is
+ * a content hash of the network the result was computed on.
+ * Graph supplies the payload of each entry through a QDataStream.
+ * Files carry a header with the format version, the graph hash and the
+ * entry name, and are ignored if any of them does not match.
+ */
+class GraphResultStore
+{
+public:
+    GraphResultStore();
+
+    void setEnabled(const bool &toggle);
+    bool isEnabled() const { return m_enabled; }
+
+    void setDirectory(const QString &dir);
+    QString directory() const { return m_directory; }
+
+    bool read(const QByteArray &graphHash,
+              const QString &entry,
+              const std::function<bool(QDataStream &)> &reader) const;
+
+    bool write(const QByteArray &graphHash,
+               const QString &entry,
+               const std::function<void(QDataStream &)> &writer) const;
+
+private:
+    QString filePath(const QByteArray &graphHash, const QString &entry) const;
+
+    bool m_enabled;
+    QString m_directory;
+};
+
+#endif // GRAPHRESULTSTORE_H
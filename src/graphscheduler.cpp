@@ -0,0 +1,409 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphscheduler.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphscheduler.h"
+
+#include <QDebug>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtConcurrent>
+
+#include <memory>
+#include <vector>
+
+
+namespace {
+
+/** The items a worker has still to do, first..end-1 */
+struct GraphSchedulerRange {
+    QMutex lock;
+    int next = 0;
+    int end = 0;
+};
+
+/** Shared by the workers of one parallelFor(), which may outlive it */
+struct GraphSchedulerState {
+    explicit GraphSchedulerState(const int &workers) : ranges(workers) {}
+
+    std::vector<GraphSchedulerRange> ranges;
+    GraphScheduler::RangeWork work;
+    int grain = 1;
+    const QAtomicInt *abort = nullptr;
+    QAtomicInt done;
+
+    // Workers which started after the caller finished must not run
+    QMutex lock;
+    QWaitCondition finished;
+    bool closed = false;
+    int running = 0;
+};
+
+
+/**
+ * Takes up to grain items from the range of worker w, or steals the upper
+ * half of the largest range left. Returns false when there is nothing left.
+ */
+bool graphSchedulerTake(GraphSchedulerState &state, const int &w,
+                        int &first, int &last) {
+    GraphSchedulerRange &own = state.ranges[w];
+    const int workers = (int) state.ranges.size();
+
+    while ( true ) {
+        {
+            QMutexLocker locker(&own.lock);
+            if ( own.next < own.end ) {
+                first = own.next;
+                last = qMin( own.end, own.next + state.grain );
+                own.next = last;
+                return true;
+            }
+        }
+
+        int victim = -1, largest = 0;
+        for (int v = 0; v < workers; ++v) {
+            if ( v == w ) {
+                continue;
+            }
+            QMutexLocker locker(&state.ranges[v].lock);
+            const int left = state.ranges[v].end - state.ranges[v].next;
+            if ( left > largest ) {
+                largest = left;
+                victim = v;
+            }
+        }
+        if ( victim < 0 ) {
+            return false;
+        }
+
+        int stolenFirst = 0, stolenEnd = 0;
+        {
+            GraphSchedulerRange &range = state.ranges[victim];
+            QMutexLocker locker(&range.lock);
+            const int left = range.end - range.next;
+            if ( left <= 0 ) {
+                continue;   // someone else was faster
+            }
+            stolenEnd = range.end;
+            stolenFirst = ( left <= state.grain ) ? range.next : range.end - left / 2;
+            range.end = stolenFirst;
+        }
+
+        QMutexLocker locker(&own.lock);
+        own.next = stolenFirst;
+        own.end = stolenEnd;
+    }
+}
+
+
+void graphSchedulerWork(GraphSchedulerState &state, const int &w,
+                        const GraphScheduler::Progress &progress) {
+    int first = 0, last = 0;
+    while ( ( state.abort == nullptr || ! state.abort->loadAcquire() )
+            && graphSchedulerTake(state, w, first, last) ) {
+        state.work(w, first, last);
+        state.done.fetchAndAddRelease(last - first);
+        if ( progress ) {
+            progress( state.done.loadAcquire() );
+        }
+    }
+}
+
+
+/** A ready task of GraphTaskGraph::run(), handed to a free pool thread */
+class GraphTaskRunnable : public QRunnable {
+public:
+    explicit GraphTaskRunnable(const std::function<void ()> &work) : m_work(work) {}
+    void run() override { m_work(); }
+private:
+    std::function<void ()> m_work;
+};
+
+} // namespace
+
+
+
+/**
+ * @brief Sets the number of threads of the shared pool.
+ * @param threads if 0 or less, QThread::idealThreadCount()
+ */
+void GraphScheduler::setThreads(const int &threads) {
+    const int count = ( threads > 0 ) ? threads : QThread::idealThreadCount();
+    qDebug() << "GraphScheduler::setThreads()" << count;
+    QThreadPool::globalInstance()->setMaxThreadCount( qMax(1, count) );
+}
+
+
+/**
+ * @brief Returns the number of threads of the shared pool
+ * @return int
+ */
+int GraphScheduler::threads() {
+    return qMax( 1, QThreadPool::globalInstance()->maxThreadCount() );
+}
+
+
+/**
+ * @brief Returns the number of workers to use for the given number of
+ * independent work items: at most threads() and at most items.
+ * @param items
+ * @return int
+ */
+int GraphScheduler::workers(const int &items) {
+    return qMax( 1, qMin( threads(), items ) );
+}
+
+
+/**
+ * @brief Calls work(worker, first, last) for consecutive ranges of at most
+ * grain items, until all items 0..items-1 are done, on workers threads.
+ * Each worker passes its own number 0..workers-1, so that it can write to
+ * per-worker state. Worker 0 is the calling thread, which also calls
+ * progress(done) with the number of finished items, if given, after every
+ * range and, while it waits for the other workers, every 50 msecs.
+ * If abort is not null and set, the workers stop taking new ranges.
+ * Returns when all workers have stopped.
+ * @param items
+ * @param workers see workers()
+ * @param work
+ * @param grain
+ * @param progress
+ * @param abort
+ */
+void GraphScheduler::parallelFor(const int &items,
+                                 const int &workers,
+                                 const RangeWork &work,
+                                 const int &grain,
+                                 const Progress &progress,
+                                 const QAtomicInt *abort) {
+    if ( items <= 0 ) {
+        return;
+    }
+
+    const int count = qMax( 1, qMin( workers, items ) );
+
+    std::shared_ptr<GraphSchedulerState> state =
+            std::make_shared<GraphSchedulerState>(count);
+    state->work = work;
+    state->grain = qMax( 1, grain );
+    state->abort = abort;
+    for (int w = 0; w < count; ++w) {
+        state->ranges[w].next = (int) ( (qint64) items * w / count );
+        state->ranges[w].end = (int) ( (qint64) items * ( w + 1 ) / count );
+    }
+
+    for (int w = 1; w < count; ++w) {
+        QtConcurrent::run( [state, w]() {
+            {
+                QMutexLocker locker(&state->lock);
+                if ( state->closed ) {
+                    return;
+                }
+                state->running++;
+            }
+            graphSchedulerWork( *state, w, Progress() );
+            QMutexLocker locker(&state->lock);
+            state->running--;
+            state->finished.wakeAll();
+        } );
+    }
+
+    graphSchedulerWork( *state, 0, progress );
+
+    QMutexLocker locker(&state->lock);
+    state->closed = true;
+    while ( state->running > 0 ) {
+        if ( progress ) {
+            state->finished.wait( &state->lock, 50 );
+            locker.unlock();
+            progress( state->done.loadAcquire() );
+            locker.relock();
+        }
+        else {
+            state->finished.wait( &state->lock );
+        }
+    }
+    locker.unlock();
+
+    if ( progress ) {
+        progress( state->done.loadAcquire() );
+    }
+}
+
+
+/**
+ * @brief Runs task on the shared pool and returns its future, which the
+ * GUI may watch with a QFutureWatcher.
+ * @param task
+ * @return QFuture<void>
+ */
+QFuture<void> GraphScheduler::run(const std::function<void ()> &task) {
+    return QtConcurrent::run( task );
+}
+
+
+
+/**
+ * @brief Adds a task which runs after the given earlier tasks
+ * @param name
+ * @param work
+ * @param dependencies the numbers of the tasks to run before it. Numbers of
+ * tasks not added yet are dropped.
+ * @param concurrent if true, the task may run alongside others
+ * @return int the number of the task
+ */
+int GraphTaskGraph::add(const QString &name,
+                        const std::function<void ()> &work,
+                        const QList<int> &dependencies,
+                        const bool &concurrent) {
+    Task task;
+    task.name = name;
+    task.work = work;
+    task.concurrent = concurrent;
+    for (const int &d : dependencies) {
+        if ( d >= 0 && d < m_tasks.size() && ! task.dependencies.contains(d) ) {
+            task.dependencies << d;
+        }
+        else {
+            qDebug() << "GraphTaskGraph::add() -" << name << "ignoring dependency" << d;
+        }
+    }
+    m_tasks << task;
+    return m_tasks.size() - 1;
+}
+
+
+/**
+ * @brief Runs all tasks, each one after its dependencies, and returns when
+ * they are done. The calling thread runs one ready task itself and hands
+ * the other ready ones to the pool, but only to threads which are free at
+ * once: tasks are never queued behind busy threads, i.e. parallelFor()
+ * workers or other task graphs, which would leave the caller waiting with
+ * nobody to run them. The tasks no thread takes stay ready, and the calling
+ * thread runs them itself, one after the other.
+ */
+void GraphTaskGraph::run() const {
+
+    // Shared with the pool threads, which may still unlock it after run() returns
+    struct RunState {
+        QMutex lock;
+        QWaitCondition changed;
+        QVector<int> waiting;
+        QVector< QList<int> > dependents;
+        QList<int> ready;
+        int done = 0;
+        bool exclusiveRunning = false;
+    };
+
+    const int n = m_tasks.size();
+
+    std::shared_ptr<RunState> state = std::make_shared<RunState>();
+    state->waiting.resize(n);
+    state->dependents.resize(n);
+    for (int i = 0; i < n; ++i) {
+        state->waiting[i] = m_tasks[i].dependencies.size();
+        for (const int &d : m_tasks[i].dependencies) {
+            state->dependents[d] << i;
+        }
+        if ( state->waiting[i] == 0 ) {
+            state->ready << i;
+        }
+    }
+
+    // Called with the lock held, when task i is done
+    auto finish = [](RunState &s, const bool &concurrent, const int &i) {
+        s.done++;
+        if ( ! concurrent ) {
+            s.exclusiveRunning = false;
+        }
+        for (const int &d : s.dependents[i]) {
+            if ( --s.waiting[d] == 0 ) {
+                s.ready << d;
+            }
+        }
+        s.changed.wakeAll();
+    };
+
+    QMutexLocker locker(&state->lock);
+
+    while ( state->done < n ) {
+
+        int own = -1;
+        for (int k = 0; k < state->ready.size(); ) {
+            const int i = state->ready[k];
+            const Task &task = m_tasks[i];
+            if ( ! task.concurrent && state->exclusiveRunning ) {
+                ++k;
+                continue;
+            }
+            if ( own < 0 ) {
+                own = i;
+            }
+            else {
+                GraphTaskRunnable *runnable = new GraphTaskRunnable( [state, finish, &task, i]() {
+                    task.work();
+                    QMutexLocker taskLocker(&state->lock);
+                    finish(*state, task.concurrent, i);
+                } );
+                if ( ! QThreadPool::globalInstance()->tryStart(runnable) ) {
+                    delete runnable;
+                    ++k;
+                    continue;
+                }
+            }
+            if ( ! task.concurrent ) {
+                state->exclusiveRunning = true;
+            }
+            state->ready.removeAt(k);
+        }
+
+        if ( own >= 0 ) {
+            qDebug() << "GraphTaskGraph::run() -" << m_tasks[own].name;
+            locker.unlock();
+            m_tasks[own].work();
+            locker.relock();
+            finish(*state, m_tasks[own].concurrent, own);
+            continue;
+        }
+
+        state->changed.wait(&state->lock);
+    }
+}
+
+
+/**
+ * @brief Runs a copy of the tasks on the shared pool, see run()
+ * @return QFuture<void> finished when all tasks are done
+ */
+QFuture<void> GraphTaskGraph::start() const {
+    const GraphTaskGraph tasks = *this;
+    return GraphScheduler::run( [tasks]() { tasks.run(); } );
+}
@@ -0,0 +1,109 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphscheduler.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHSCHEDULER_H
+#define GRAPHSCHEDULER_H
+
+#include <QtGlobal>
+#include <QAtomicInt>
+#include <QFuture>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+
+/**
+ * @brief The GraphScheduler class
+ * The one pool of worker threads shared by all parallel analyses of SocNetV:
+ * the global QThreadPool, whose size is set once with setThreads(), from the
+ * settings dialog or socnetv --batch --threads, so that nested or concurrent
+ * kernels never start more threads than that.
+ * parallelFor() splits a range of items into one contiguous range per worker.
+ * A worker takes grain items at a time from the front of its own range and,
+ * when it runs out, steals the upper half of the largest range left (work
+ * stealing), so that workers stay busy even when the cost per item varies.
+ * The calling thread is worker 0, thus a parallelFor() called from inside a
+ * pool thread cannot starve for threads.
+ */
+class GraphScheduler
+{
+public:
+    typedef std::function<void (const int &worker, const int &first, const int &last)> RangeWork;
+    typedef std::function<void (const int &done)> Progress;
+
+    static void setThreads(const int &threads);
+    static int threads();
+    static int workers(const int &items);
+
+    static void parallelFor(const int &items,
+                            const int &workers,
+                            const RangeWork &work,
+                            const int &grain = 1,
+                            const Progress &progress = Progress(),
+                            const QAtomicInt *abort = nullptr);
+
+    static QFuture<void> run(const std::function<void ()> &task);
+};
+
+
+/**
+ * @brief The GraphTaskGraph class
+ * A set of dependent analyses, i.e. geodesic distances before closeness and
+ * betweenness, or the adjacency matrix before similarities. Every task runs
+ * after all its dependencies, which must have been added before it, so there
+ * are no cycles. Tasks that touch the shared state of a Graph run one at a time;
+ * only tasks added as concurrent may run alongside others, on the
+ * GraphScheduler pool. run() blocks, start() returns a future for the GUI.
+ */
+class GraphTaskGraph
+{
+public:
+    int add(const QString &name,
+            const std::function<void ()> &work,
+            const QList<int> &dependencies = QList<int>(),
+            const bool &concurrent = false);
+
+    int size() const { return m_tasks.size(); }
+    QString name(const int &task) const { return m_tasks[task].name; }
+
+    void run() const;
+    QFuture<void> start() const;
+
+private:
+    struct Task {
+        QString name;
+        std::function<void ()> work;
+        QList<int> dependencies;
+        bool concurrent;
+    };
+    QVector<Task> m_tasks;
+};
+
+#endif // GRAPHSCHEDULER_H
@@ -0,0 +1,166 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphscoreindex.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+
+#include "graphscoreindex.h"
+
+#include <QtDebug>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+
+
+GraphScoreIndex::GraphScoreIndex() :
+    m_built(false),
+    m_version(0)
+{
+}
+
+
+
+/**
+ * @brief Frees the index
+ */
+void GraphScoreIndex::clear() {
+    m_built = false;
+    m_version = 0;
+    m_scores.clear();
+    m_names.clear();
+}
+
+
+
+/**
+ * @brief Sorts the vertices names by their scores
+ * @param scores the score of each vertex
+ * @param names the vertex number of each score
+ * @param version the graph version the scores belong to
+ */
+void GraphScoreIndex::build(const QVector<qreal> &scores,
+                            const QVector<int> &names,
+                            const quint64 &version) {
+    const int N = scores.size();
+
+    std::vector<int> order(N);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](const int &a, const int &b) {
+        return ( scores[a] < scores[b] ) ||
+                ( scores[a] == scores[b] && names[a] < names[b] );
+    });
+
+    m_scores.resize(N);
+    m_names.resize(N);
+    for (int i = 0; i < N; ++i) {
+        m_scores[i] = scores[ order[i] ];
+        m_names[i] = names[ order[i] ];
+    }
+
+    m_version = version;
+    m_built = true;
+
+    qDebug() << "GraphScoreIndex::build() - vertices" << N
+             << "version" << version;
+}
+
+
+
+/**
+ * @brief Returns the smallest score, or 0 if the index is empty
+ * @return
+ */
+qreal GraphScoreIndex::minScore() const {
+    return m_scores.isEmpty() ? 0 : m_scores.first();
+}
+
+
+
+/**
+ * @brief Returns the largest score, or 0 if the index is empty
+ * @return
+ */
+qreal GraphScoreIndex::maxScore() const {
+    return m_scores.isEmpty() ? 0 : m_scores.last();
+}
+
+
+
+/**
+ * @brief Appends to names the vertices scoring more than (or, if orEqual,
+ * at least) threshold, from the smallest score up
+ * @param threshold
+ * @param orEqual
+ * @param names
+ */
+void GraphScoreIndex::above(const qreal &threshold,
+                            const bool &orEqual,
+                            QList<int> &names) const {
+    const qreal *first = m_scores.constData();
+    const qreal *last = first + m_scores.size();
+    const qreal *from = orEqual ? std::lower_bound(first, last, threshold)
+                                : std::upper_bound(first, last, threshold);
+    for (int i = from - first; i < m_scores.size(); ++i) {
+        names << m_names[i];
+    }
+}
+
+
+
+/**
+ * @brief Appends to names the vertices scoring less than (or, if orEqual,
+ * at most) threshold, from the smallest score up
+ * @param threshold
+ * @param orEqual
+ * @param names
+ */
+void GraphScoreIndex::below(const qreal &threshold,
+                            const bool &orEqual,
+                            QList<int> &names) const {
+    const qreal *first = m_scores.constData();
+    const qreal *last = first + m_scores.size();
+    const qreal *to = orEqual ? std::upper_bound(first, last, threshold)
+                              : std::lower_bound(first, last, threshold);
+    for (int i = 0; i < to - first; ++i) {
+        names << m_names[i];
+    }
+}
+
+
+
+/**
+ * @brief Appends to names the k vertices with the largest scores,
+ * from the largest score down
+ * @param k
+ * @param names
+ */
+void GraphScoreIndex::top(const int &k, QList<int> &names) const {
+    const int end = qMax(0, m_scores.size() - k);
+    for (int i = m_scores.size() - 1; i >= end; --i) {
+        names << m_names[i];
+    }
+}
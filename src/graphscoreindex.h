@@ -0,0 +1,86 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphscoreindex.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHSCOREINDEX_H
+#define GRAPHSCOREINDEX_H
+
+#include <QtGlobal>
+#include <QList>
+#include <QVector>
+
+
+/**
+ * @brief The GraphScoreIndex class
+ * The vertices of a Graph sorted by their score in one prominence index,
+ * from the smallest to the largest score (ties by vertex number).
+ * Threshold searches and top-k queries take O(log N + k).
+ * It is built by Graph::prominenceScoreIndex() for one graph version and
+ * must not be used after the graph or the scores have changed.
+ */
+class GraphScoreIndex
+{
+public:
+    GraphScoreIndex();
+
+    void build(const QVector<qreal> &scores,
+               const QVector<int> &names,
+               const quint64 &version);
+
+    void clear();
+
+    bool isValid(const quint64 &version) const {
+        return m_built && m_version == version;
+    }
+
+    quint64 version() const { return m_version; }
+
+    /** Number of vertices in the index */
+    int size() const { return m_scores.size(); }
+
+    /** Returns the i-th smallest score and the vertex (name) that holds it */
+    qreal score(const int &i) const { return m_scores[i]; }
+    int name(const int &i) const { return m_names[i]; }
+
+    qreal minScore() const;
+    qreal maxScore() const;
+
+    void above(const qreal &threshold, const bool &orEqual, QList<int> &names) const;
+
+    void below(const qreal &threshold, const bool &orEqual, QList<int> &names) const;
+
+    void top(const int &k, QList<int> &names) const;
+
+private:
+    bool m_built;
+    quint64 m_version;
+
+    QVector<qreal> m_scores;
+    QVector<int> m_names;
+};
+
+#endif // GRAPHSCOREINDEX_H
@@ -0,0 +1,336 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphtrace.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "graphtrace.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QHash>
+#include <QVector>
+#include <QAtomicInteger>
+#include <QThread>
+#include <QThreadPool>
+#include <QSysInfo>
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <ctime>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+
+Q_LOGGING_CATEGORY(lcGraph, "socnetv.graph")
+Q_LOGGING_CATEGORY(lcGraphVertex, "socnetv.graph.vertex")
+Q_LOGGING_CATEGORY(lcParser, "socnetv.parser")
+
+
+namespace {
+
+struct GraphTracePhase {
+    GraphTracePhase() : count(0), total(0), max(0) {}
+    qint64 count;
+    qint64 total;
+    qint64 max;
+};
+
+QMutex graphTraceMutex;
+
+// The runs kept for the profiler, oldest first
+const int graphTraceMaxRuns = 10000;
+QVector<GraphTrace::Run> graphTraceRuns;
+
+// Bytes held by Matrix buffers and distance stores, and their peak
+QAtomicInteger<qint64> graphTraceMemoryInUse(0);
+QAtomicInteger<qint64> graphTraceMemoryPeak(0);
+
+void graphTraceMemoryPeakAtLeast(const qint64 &bytes) {
+    qint64 peak = graphTraceMemoryPeak.loadAcquire();
+    while ( bytes > peak && !graphTraceMemoryPeak.testAndSetOrdered(peak, bytes, peak) ) {
+    }
+}
+
+// Keyed by the phase literal itself, which is unique and lives forever
+QHash<const char *, GraphTracePhase> &graphTracePhases() {
+    static QHash<const char *, GraphTracePhase> phases;
+    return phases;
+}
+
+}
+
+
+
+/**
+ * @brief Adds a run of phase that took nsecs
+ * @param phase
+ * @param nsecs
+ */
+void GraphTrace::record(const char *phase, const qint64 &nsecs) {
+    QMutexLocker locker(&graphTraceMutex);
+    GraphTracePhase &p = graphTracePhases()[phase];
+    p.count++;
+    p.total += nsecs;
+    p.max = qMax( p.max, nsecs );
+}
+
+
+/**
+ * @brief Keeps run for the profiler, dropping the oldest runs past 10000
+ * @param run
+ */
+void GraphTrace::recordRun(const Run &run) {
+    QMutexLocker locker(&graphTraceMutex);
+    if ( graphTraceRuns.size() >= graphTraceMaxRuns ) {
+        graphTraceRuns.remove(0, graphTraceRuns.size() - graphTraceMaxRuns + 1);
+    }
+    graphTraceRuns.append(run);
+}
+
+
+/**
+ * @brief Returns the runs recorded so far, oldest first
+ * @return
+ */
+QVector<GraphTrace::Run> GraphTrace::runs() {
+    QMutexLocker locker(&graphTraceMutex);
+    return graphTraceRuns;
+}
+
+
+/**
+ * @brief Returns the runs recorded so far as a JSON document, together with
+ * the version of SocNetV and the system they ran on, to attach to bug reports.
+ * Durations are in nanoseconds and memory in bytes.
+ * @return
+ */
+QByteArray GraphTrace::runsJson() {
+    QJsonArray array;
+    const QVector<Run> list = runs();
+    for (const Run &run : list) {
+        QJsonObject object;
+        object["phase"] = run.phase;
+        object["parameters"] = run.parameters;
+        object["started"] = run.started.toString(Qt::ISODate);
+        object["vertices"] = run.vertices;
+        object["edges"] = run.edges;
+        object["wall_ns"] = run.wallNsecs;
+        object["cpu_ns"] = run.cpuNsecs;
+        object["threads"] = run.threads;
+        object["peak_bytes"] = run.peakBytes;
+        array.append(object);
+    }
+
+    QJsonObject system;
+    system["os"] = QSysInfo::prettyProductName();
+    system["kernel"] = QSysInfo::kernelType() + " " + QSysInfo::kernelVersion();
+    system["cpu_architecture"] = QSysInfo::currentCpuArchitecture();
+    system["ideal_threads"] = QThread::idealThreadCount();
+    system["qt"] = QString(qVersion());
+
+    QJsonObject document;
+    document["application"] = QString("SocNetV");
+    document["version"] = QCoreApplication::applicationVersion();
+    document["created"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    document["system"] = system;
+    document["runs"] = array;
+    return QJsonDocument(document).toJson(QJsonDocument::Indented);
+}
+
+
+/**
+ * @brief Forgets all phases and runs recorded so far
+ */
+void GraphTrace::clear() {
+    QMutexLocker locker(&graphTraceMutex);
+    graphTracePhases().clear();
+    graphTraceRuns.clear();
+}
+
+
+/**
+ * @brief Returns a plain text table of the phases recorded so far, with their
+ * runs, total, mean and max durations in msecs, longest total first.
+ * Nested phases are included in their parents' durations.
+ * @return
+ */
+QString GraphTrace::report() {
+    QVector< QPair<const char *, GraphTracePhase> > phases;
+    {
+        QMutexLocker locker(&graphTraceMutex);
+        QHash<const char *, GraphTracePhase>::const_iterator it;
+        for (it = graphTracePhases().constBegin(); it != graphTracePhases().constEnd(); ++it) {
+            phases.append( qMakePair( it.key(), it.value() ) );
+        }
+    }
+    std::sort( phases.begin(), phases.end(),
+               [](const QPair<const char *, GraphTracePhase> &a,
+                  const QPair<const char *, GraphTracePhase> &b) {
+        return a.second.total > b.second.total;
+    } );
+
+    QString text = QString("%1 %2 %3 %4 %5\n")
+            .arg( "Phase", -48 )
+            .arg( "Runs", 8 )
+            .arg( "Total ms", 12 )
+            .arg( "Mean ms", 12 )
+            .arg( "Max ms", 12 );
+    for (int i = 0; i < phases.size(); ++i) {
+        const GraphTracePhase &p = phases[i].second;
+        text += QString("%1 %2 %3 %4 %5\n")
+                .arg( QString::fromLatin1( phases[i].first ), -48 )
+                .arg( p.count, 8 )
+                .arg( p.total / 1e6, 12, 'f', 3 )
+                .arg( p.total / 1e6 / p.count, 12, 'f', 3 )
+                .arg( p.max / 1e6, 12, 'f', 3 );
+    }
+    return text;
+}
+
+
+
+/**
+ * @brief Counts bytes newly held by a Matrix buffer or a distance store
+ * @param bytes
+ */
+void GraphTrace::memoryAllocated(const qint64 &bytes) {
+    graphTraceMemoryPeakAtLeast( graphTraceMemoryInUse.fetchAndAddOrdered(bytes) + bytes );
+}
+
+
+/**
+ * @brief Counts bytes given back by a Matrix buffer or a distance store
+ * @param bytes
+ */
+void GraphTrace::memoryReleased(const qint64 &bytes) {
+    graphTraceMemoryInUse.fetchAndAddOrdered(-bytes);
+}
+
+
+/**
+ * @brief Returns the bytes held by Matrix buffers and distance stores now
+ * @return
+ */
+qint64 GraphTrace::memoryInUse() {
+    return graphTraceMemoryInUse.loadAcquire();
+}
+
+
+/**
+ * @brief Starts measuring a new peak from the bytes in use now
+ * @return the peak measured so far, to be given back to memoryPeakMerge()
+ */
+qint64 GraphTrace::memoryPeakRestart() {
+    return graphTraceMemoryPeak.fetchAndStoreOrdered( memoryInUse() );
+}
+
+
+/**
+ * @brief Ends the peak started by memoryPeakRestart(), and merges in the
+ * peak it returned, so that enclosing runs still see their own peak.
+ * @param peak
+ * @return the peak since memoryPeakRestart()
+ */
+qint64 GraphTrace::memoryPeakMerge(const qint64 &peak) {
+    const qint64 current = graphTraceMemoryPeak.loadAcquire();
+    graphTraceMemoryPeakAtLeast(peak);
+    return current;
+}
+
+
+/**
+ * @brief Returns the CPU time used by all threads of the process, in nsecs
+ * @return
+ */
+qint64 GraphTrace::cpuNsecs() {
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if ( getrusage(RUSAGE_SELF, &usage) == 0 ) {
+        return ( (qint64) usage.ru_utime.tv_sec + usage.ru_stime.tv_sec ) * 1000000000
+                + ( (qint64) usage.ru_utime.tv_usec + usage.ru_stime.tv_usec ) * 1000;
+    }
+#endif
+    return (qint64) ( std::clock() * ( 1e9 / CLOCKS_PER_SEC ) );
+}
+
+
+
+
+/**
+ * @brief Starts timing phase
+ * @param phase
+ */
+GraphTraceScope::GraphTraceScope(const char *phase) :
+    m_phase(phase),
+    m_started( QDateTime::currentDateTime() ),
+    m_vertices(-1),
+    m_edges(-1),
+    m_cpu( GraphTrace::cpuNsecs() ),
+    m_peakSaved( GraphTrace::memoryPeakRestart() )
+{
+    m_timer.start();
+}
+
+
+/**
+ * @brief Records the run of the phase
+ */
+GraphTraceScope::~GraphTraceScope() {
+    const qint64 nsecs = m_timer.nsecsElapsed();
+    GraphTrace::record( m_phase, nsecs );
+
+    GraphTrace::Run run;
+    run.phase = QString::fromLatin1(m_phase);
+    run.parameters = m_parameters;
+    run.started = m_started;
+    run.vertices = m_vertices;
+    run.edges = m_edges;
+    run.wallNsecs = nsecs;
+    run.cpuNsecs = GraphTrace::cpuNsecs() - m_cpu;
+    run.threads = QThreadPool::globalInstance()->maxThreadCount();
+    run.peakBytes = GraphTrace::memoryPeakMerge(m_peakSaved);
+    GraphTrace::recordRun(run);
+}
+
+
+/**
+ * @brief Sets the number of vertices and edges the run works on, and its
+ * parameters, i.e. "considerWeights=1 dropIsolates=0"
+ * @param vertices
+ * @param edges
+ * @param parameters
+ */
+void GraphTraceScope::setInput(const int &vertices, const int &edges,
+                               const QString &parameters) {
+    m_vertices = vertices;
+    m_edges = edges;
+    m_parameters = parameters;
+}
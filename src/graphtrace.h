@@ -0,0 +1,133 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphtrace.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHTRACE_H
+#define GRAPHTRACE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QVector>
+#include <QByteArray>
+#include <QLoggingCategory>
+
+
+/**
+ * Logging categories of the hot paths: per vertex and per edge operations of
+ * Graph and GraphVertex, and the per line and per element work of Parser.
+ * Their messages go through qCHotDebug(), which compiles to nothing unless
+ * SOCNETV_HOT_PATH_LOGGING is defined (debug builds, or qmake
+ * CONFIG+=socnetv_hot_path_logging), so release builds do not even format
+ * the arguments. At run time, they can be filtered with QT_LOGGING_RULES,
+ * i.e. QT_LOGGING_RULES="socnetv.parser.debug=false"
+ */
+Q_DECLARE_LOGGING_CATEGORY(lcGraph)
+Q_DECLARE_LOGGING_CATEGORY(lcGraphVertex)
+Q_DECLARE_LOGGING_CATEGORY(lcParser)
+
+#ifdef SOCNETV_HOT_PATH_LOGGING
+#define qCHotDebug(...) qCDebug(__VA_ARGS__)
+#else
+#define qCHotDebug(...) while (false) qCDebug(__VA_ARGS__)
+#endif
+
+
+
+/**
+ * @brief The GraphTrace class
+ * Collects, per phase (i.e. an analysis, a layout, loading a file), how many
+ * times it ran and how long it took, from GraphTraceScope timers.
+ * It is thread-safe and always on: phases are coarse, so timing them costs
+ * nothing measurable. report() formats the table, longest phases first;
+ * MainWindow shows it from the Help menu, and socnetv --trace prints it on exit.
+ * Every run is also kept, with its input size, parameters, CPU time, threads
+ * and the peak bytes held by Matrix buffers and distance stores, for the
+ * Analysis Profiler of MainWindow and its JSON export.
+ */
+class GraphTrace
+{
+public:
+    struct Run {
+        QString phase;
+        QString parameters;
+        QDateTime started;
+        int vertices;
+        int edges;
+        qint64 wallNsecs;
+        qint64 cpuNsecs;
+        int threads;
+        qint64 peakBytes;
+    };
+
+    static void record(const char *phase, const qint64 &nsecs);
+    static void recordRun(const Run &run);
+    static QVector<Run> runs();
+    static QByteArray runsJson();
+    static void clear();
+    static QString report();
+
+    static void memoryAllocated(const qint64 &bytes);
+    static void memoryReleased(const qint64 &bytes);
+    static qint64 memoryInUse();
+    static qint64 memoryPeakRestart();
+    static qint64 memoryPeakMerge(const qint64 &peak);
+
+    static qint64 cpuNsecs();
+};
+
+
+
+/**
+ * @brief The GraphTraceScope class
+ * Times the scope it is declared in, as the given phase of GraphTrace.
+ * The phase must be a string literal. Call setInput() to record the size of
+ * the network and the parameters of the run.
+ */
+class GraphTraceScope
+{
+public:
+    explicit GraphTraceScope(const char *phase);
+    ~GraphTraceScope();
+
+    void setInput(const int &vertices, const int &edges,
+                  const QString &parameters = QString());
+
+private:
+    Q_DISABLE_COPY(GraphTraceScope)
+    const char *m_phase;
+    QElapsedTimer m_timer;
+    QDateTime m_started;
+    QString m_parameters;
+    int m_vertices;
+    int m_edges;
+    qint64 m_cpu;
+    qint64 m_peakSaved;
+};
+
+#endif // GRAPHTRACE_H
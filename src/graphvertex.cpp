@@ -29,11 +29,15 @@
 
 #include "graph.h"
 #include "graphvertex.h"
+#include "graphtrace.h"
 
 #include "graphicsnode.h"
 
 
 
+const H_edges GraphVertex::m_noEdges;
+
+
 GraphVertex::GraphVertex(Graph* parentGraph,
                          const int &name,
                          const int &val,
@@ -49,44 +53,35 @@ GraphVertex::GraphVertex(Graph* parentGraph,
                          const QString &shape,
                          const QString &iconPath ): m_graph (parentGraph)
 { 
-    qDebug() << "GraphVertex::GraphVertex() - vertex:"<<  name << "initializing...";
+    qCHotDebug(lcGraphVertex) << "GraphVertex::GraphVertex() - vertex:"<<  name << "initializing...";
 
     m_name=name;
 	m_value=val;
 	m_size=size;
-	m_color=color;
-	m_numberColor=numColor;
+	m_color=GraphAttributes::id(color);
+	m_numberColor=GraphAttributes::id(numColor);
 	m_numberSize=numSize;
 	m_label=label;
-	m_labelColor=labelColor;
+	m_labelColor=GraphAttributes::id(labelColor);
 	m_labelSize=labelSize;
-	m_shape=shape;
-    m_iconPath=iconPath;
+	m_shape=GraphAttributes::id(shape);
+    m_iconPath=GraphAttributes::id(iconPath);
+    m_outLinkColor=NoColor;
 	m_x=p.x();
 	m_y=p.y();
     //FIXME m_outLinkColors list need update when we remove vertices/edges
-    //m_outLinkColors.reserve(2000);
-    m_outEdgeLabels.reserve(2000);
-    m_outEdges.reserve(2000);
-    m_inEdges.reserve(2000);
-    m_neighborhoodList.reserve(1000);
 
     m_outEdgesCounter = 0;
     m_inEdgesCounter = 0;
     m_outDegree = 0;
     m_inDegree = 0;
     m_localDegree = 0;
-    m_Eccentricity = 0;
-    m_distanceSum = 0;
-    m_DC=0; m_SDC=0; m_DP=0; m_SDP=0; m_CC=0; m_SCC=0; m_BC=0; m_SBC=0;
-    m_SC=0; m_SSC=0; m_IRCC=0; m_SIRCC=0;
-    m_CLC=0; m_hasCLC=false;
+    m_outEdgesNonSym = 0;
+    m_inEdgesNonSym = 0;
+    m_outEdgesSym = 0;
     m_curRelation=relation;
     m_enabled = true;
-
-    connect (this, SIGNAL (setEdgeVisibility ( int, int, int, bool) ),
-             m_graph, SLOT (edgeVisibilitySet (int, int, int, bool)) );
-
+    m_isolated = false;
 
 }
 
@@ -95,37 +90,120 @@ GraphVertex::GraphVertex(Graph* parentGraph,
  * @brief constructor with default values
  * @param name
  */
-GraphVertex::GraphVertex(const int &name) {
-    qDebug() << "GraphVertex::GraphVertex() - "<<  name << " using default values";
+GraphVertex::GraphVertex(const int &name) : m_graph(nullptr) {
+    qCHotDebug(lcGraphVertex) << "GraphVertex::GraphVertex() - "<<  name << " using default values";
     m_name=name;
 	m_value=1;
 	m_size=9;
-	m_color="black";
+	m_color=GraphAttributes::id("black");
+	m_numberColor=0;
+	m_numberSize=0;
+	m_numberDistance=0;
 	m_label="";
-	m_labelColor="black";
-	m_shape="circle";
+	m_labelColor=GraphAttributes::id("black");
+	m_labelSize=0;
+	m_labelDistance=0;
+	m_shape=GraphAttributes::id("circle");
+    m_iconPath=0;
+    m_outLinkColor=NoColor;
+    m_x=0;
+    m_y=0;
     m_outEdgesCounter=0;
     m_inEdgesCounter=0;
-    m_Eccentricity=0;
-    m_DC=0; m_SDC=0; m_DP=0; m_SDP=0; m_CC=0; m_SCC=0; m_BC=0; m_SBC=0;
-    m_IRCC=0; m_SIRCC=0; m_SC=0; m_SSC=0;
+    m_outDegree = 0;
+    m_inDegree = 0;
+    m_localDegree = 0;
+    m_outEdgesNonSym = 0;
+    m_inEdgesNonSym = 0;
+    m_outEdgesSym = 0;
     m_curRelation=0;
+    m_enabled = true;
+    m_isolated = false;
+}
+
+
+/**
+ * @brief Returns the scores of this vertex, allocating them on the first call
+ * @return
+ */
+GraphVertexScores &GraphVertex::scores() {
+    if ( !m_scores ) {
+        m_scores.reset( new GraphVertexScores );
+    }
+    return *m_scores;
 }
 
 
 /**
-* @brief Changes the current relation of this vertex to newRel
+ * @brief Tells Graph that the outbound edge to target in the given relation
+ * has been enabled or disabled, to update the canvas
+ * @param relation
+ * @param target
+ * @param visible
+ */
+void GraphVertex::edgeVisibilityChanged(const int &relation, const int &target, const bool &visible) {
+    if ( m_graph ) {
+        m_graph->edgeVisibilitySet(relation, m_name, target, visible);
+    }
+}
+
+
+/**
+ * @brief Sets the color of the outbound edge to v2. Only the colors which
+ * differ from the color of the first edge of this vertex are kept per edge.
+ * @param v2
+ * @param color
+ */
+void GraphVertex::setOutLinkColor(const int &v2, const QString &color) {
+    const quint32 id = GraphAttributes::id(color);
+    if ( m_outLinkColor == NoColor ) {
+        m_outLinkColor = id;
+    }
+    if ( id == m_outLinkColor ) {
+        m_outLinkColors.remove(v2);
+    }
+    else {
+        m_outLinkColors.insert(v2, id);
+    }
+}
+
+
+/**
+ * @brief Returns the color of the outbound edge to v2, black if it has none
+ * @param v2
+ * @return
+ */
+QString GraphVertex::outLinkColor(const int &v2) const {
+    const quint32 id = m_outLinkColors.value(v2, m_outLinkColor);
+    return ( id != 0 && id != NoColor ) ? GraphAttributes::value(id) : QString("black");
+}
+
+
+/**
+ * @brief Sets the label of the outbound edge to v2. Empty labels are not kept.
+ * @param v2
+ * @param label
+ */
+void GraphVertex::setOutEdgeLabel(const int &v2, const QString &label) {
+    if ( label.isEmpty() ) {
+        m_outEdgeLabels.remove(v2);
+    }
+    else {
+        m_outEdgeLabels.insert(v2, label);
+    }
+}
+
+
+/**
+* @brief Changes the current relation of this vertex to newRel.
+* The edges are kept in one partition per relation, so this only selects
+* the partition the edge methods work on, without touching any edge.
 * @param newRel
 */
 void GraphVertex::relationSet(int newRel) {
-    qDebug() << "GraphVertex::relationSet() - vertex:" << name()
+    qCHotDebug(lcGraphVertex) << "GraphVertex::relationSet() - vertex:" << name()
              << "current relation:" << m_curRelation
              << "setting new relation: " << newRel;
-    // first make false all edges of current relation
-    edgeFilterByRelation(m_curRelation, false);
-    // then make true all edges of new relation
-    edgeFilterByRelation(newRel, true);
-    // update current relation
     m_curRelation=newRel;
 }
 
@@ -135,26 +213,76 @@ void GraphVertex::relationSet(int newRel) {
  * @return
  */
 QString GraphVertex::colorToPajek(){
-    if (m_color.startsWith("#")) {
-        return  ("RGB"+m_color.right( m_color.size()-1 )).toUpper()  ;
+    const QString vertexColor = color();
+    if (vertexColor.startsWith("#")) {
+        return  ("RGB"+vertexColor.right( vertexColor.size()-1 )).toUpper()  ;
     }
-    return m_color;
+    return vertexColor;
 }
 
 
 
+/**
+ * @brief Returns the outbound edges of the given relation, growing the
+ * partitions if the relation is new to this vertex
+ * @param relation
+ * @return
+ */
+H_edges &GraphVertex::outEdgesOf(const int &relation) {
+    if ( relation >= m_outEdges.size() ) {
+        m_outEdges.resize(relation + 1);
+    }
+    return m_outEdges[relation];
+}
+
+
+/**
+ * @brief Returns the inbound edges of the given relation, growing the
+ * partitions if the relation is new to this vertex
+ * @param relation
+ * @return
+ */
+H_edges &GraphVertex::inEdgesOf(const int &relation) {
+    if ( relation >= m_inEdges.size() ) {
+        m_inEdges.resize(relation + 1);
+    }
+    return m_inEdges[relation];
+}
+
+
+/**
+ * @brief Returns the outbound edges of the given relation, keyed by target
+ * @param relation
+ * @return
+ */
+const H_edges &GraphVertex::outEdgesRelation(const int &relation) const {
+    return ( relation >= 0 && relation < m_outEdges.size() ) ? m_outEdges.at(relation)
+                                                             : m_noEdges;
+}
+
+
+/**
+ * @brief Returns the inbound edges of the given relation, keyed by source
+ * @param relation
+ * @return
+ */
+const H_edges &GraphVertex::inEdgesRelation(const int &relation) const {
+    return ( relation >= 0 && relation < m_inEdges.size() ) ? m_inEdges.at(relation)
+                                                            : m_noEdges;
+}
+
+
 /**
  * @brief Adds an outbound edge to vertex v2 with weight w
  * @param target
  * @param weight
  */
 void GraphVertex::edgeAddTo (const int &v2, const qreal &weight, const QString &color, const QString &label) {
-    qDebug() <<"GraphVertex::edgeAddTo() - new outbound edge"
+    qCHotDebug(lcGraphVertex) <<"GraphVertex::edgeAddTo() - new outbound edge"
             << name() << " -> "<< v2 << " weight "<< weight
                << " relation " << m_curRelation;
     // do not use [] operator - silently creates an item if key do not exist
-    m_outEdges.insert(
-                v2, pair_i_fb(m_curRelation, pair_f_b(weight, true) ) );
+    outEdgesOf(m_curRelation).insert( v2, pair_f_b(weight, true) );
     setOutLinkColor(v2, color);
     setOutEdgeLabel(v2, label);
 }
@@ -166,32 +294,47 @@ void GraphVertex::edgeAddTo (const int &v2, const qreal &weight, const QString &
  * @param status
  */
 void GraphVertex::setOutEdgeEnabled (const int target, bool status){
-    qDebug () << "GraphVertex::setOutEdgeEnabled - set outEdge to " << target
+    qCHotDebug(lcGraphVertex) << "GraphVertex::setOutEdgeEnabled - set outEdge to " << target
               << " as " << status
                  << ". Finding outLink...";
-    QMutableHashIterator < int, pair_i_fb > it1 (m_outEdges);
-    int linkTarget=0;
-    qreal weight =0;
-    int relation = 0;
-    while ( it1.hasNext()) {
-        it1.next();
-        relation = it1.value().first;
-        if ( relation == m_curRelation ) {
-            linkTarget=it1.key();
-            if ( linkTarget == target ) {
-                weight = it1.value().second.first;
-                qDebug() << " *** vertex " << m_name << " connected to "
-                         << linkTarget << " relation " << relation
-                         << " weight " << weight
-                         << " status " << it1.value().second.second;
-                it1.setValue(pair_i_fb(m_curRelation, pair_f_b(weight, status) ));
-                emit setEdgeVisibility (m_curRelation, m_name, target, status );
-            }
+    H_edges &edges = outEdgesOf(m_curRelation);
+    H_edges::iterator it1=edges.find(target);
+    while (it1 != edges.end() && it1.key() == target ) {
+        qCHotDebug(lcGraphVertex) << " *** vertex " << m_name << " connected to "
+                 << target << " relation " << m_curRelation
+                 << " weight " << it1.value().first
+                 << " status " << it1.value().second;
+        if ( it1.value().second != status ) {
+            it1.value().second = status;
+            edgeVisibilityChanged( m_curRelation, target, status );
         }
-        else {
+        ++it1;
+    }
+}
 
+
+/**
+ * @brief Enables or disables the outbound edges to target with the given weight,
+ * in the current relation.
+ * Unlike setOutEdgeEnabled(), the change is not reported to Graph, since
+ * the caller (Graph::edgeFilterByWeight) reports all its changes at once.
+ * @param target
+ * @param weight
+ * @param status
+ * @return true if any edge changed
+ */
+bool GraphVertex::setOutEdgeFiltered(const int &target, const qreal &weight, const bool &status) {
+    bool changed = false;
+    H_edges &edges = outEdgesOf(m_curRelation);
+    H_edges::iterator it1 = edges.find(target);
+    while (it1 != edges.end() && it1.key() == target ) {
+        if ( it1.value().first == weight && it1.value().second != status ) {
+            it1.value().second = status;
+            changed = true;
         }
+        ++it1;
     }
+    return changed;
 }
 
 
@@ -201,35 +344,21 @@ void GraphVertex::setOutEdgeEnabled (const int target, bool status){
  * @param weight
  */
 void GraphVertex::edgeAddFrom (const int &v1, const qreal &weight) {
-    qDebug() <<"GraphVertex::edgeAddFrom() - new inbound edge"
+    qCHotDebug(lcGraphVertex) <<"GraphVertex::edgeAddFrom() - new inbound edge"
             << name() << " <- "<< v1 << " weight "<< weight
                << " relation " << m_curRelation;
-    m_inEdges.insert(
-                v1, pair_i_fb (m_curRelation, pair_f_b(weight, true) ) );
+    inEdgesOf(m_curRelation).insert( v1, pair_f_b(weight, true) );
 }
 
 
 
 void GraphVertex::changeOutEdgeWeight(const int &target, const qreal &weight){
-    qDebug() << "GraphVertex::changeEdgeWeightTo " << target << " weight " << weight ;
-    qDebug() << " *** m_outEdges.count " <<
-                m_outEdges.count();
-    qDebug() << "first find and remove old relation-weight pair" ;
-    H_edges::iterator it1=m_outEdges.find(target);
-    while (it1 != m_outEdges.end() ) {
-        if ( it1.key() == target && it1.value().first == m_curRelation ) {
-            it1=m_outEdges.erase(it1);
-        }
-        else {
-            ++it1;
-        }
-    }
-    qDebug() << " *** m_outEdges.count " <<
-                m_outEdges.count();
-    qDebug() << " create new relation-weight pair ";
-    m_outEdges.insert(
-                target, pair_i_fb(m_curRelation, pair_f_b(weight, true) ) );
-    qDebug() << " *** m_outEdges.count " << m_outEdges.count();
+    qCHotDebug(lcGraphVertex) << "GraphVertex::changeEdgeWeightTo " << target << " weight " << weight ;
+    H_edges &edges = outEdgesOf(m_curRelation);
+    qCHotDebug(lcGraphVertex) << "first remove old weight, then insert the new one" ;
+    edges.remove(target);
+    edges.insert( target, pair_f_b(weight, true) );
+    qCHotDebug(lcGraphVertex) << " *** outEdges count " << edges.count();
 }
 
 
@@ -239,30 +368,12 @@ void GraphVertex::changeOutEdgeWeight(const int &target, const qreal &weight){
  * @param v2
  */
 void GraphVertex::edgeRemoveTo (const int v2) {
-    qDebug() << "GraphVertex: edgeRemoveTo() - vertex " << m_name
-             << " has " <<outEdges() << " out-links. Removing link to "<< v2 ;
-
-    if (outEdges()>0) {
-        qDebug() << "GraphVertex::edgeRemoveTo() - checking all_outEdges";
-        H_edges::iterator it1=m_outEdges.find(v2);
-        while (it1 != m_outEdges.end() && it1.key() == v2 ) {
-            if ( it1.value().first == m_curRelation ) {
-                qDebug() << " *** vertex " << m_name << " connected to "
-                         << it1.key() << " relation " << it1.value().first
-                         << " weight " << it1.value().second.first
-                         << " enabled ? " << it1.value().second.second
-                         << " Erasing outEdge from m_outEdges ";
-                it1=m_outEdges.erase(it1);
-            }
-            else {
-                ++it1;
-            }
-        }
-        qDebug() << "GraphVertex::edgeRemoveTo() - vertex " <<  m_name << " now has " <<  outEdges() << " out-edges";
-	}
-	else {
-        qDebug() << "GraphVertex::edgeRemoveTo() - vertex " <<  m_name << " has no edges" ;
-	}
+    qCHotDebug(lcGraphVertex) << "GraphVertex: edgeRemoveTo() - vertex " << m_name
+             << " removing link to "<< v2 ;
+    const int removed = outEdgesOf(m_curRelation).remove(v2);
+    qCHotDebug(lcGraphVertex) << "GraphVertex::edgeRemoveTo() - vertex " <<  m_name
+                              << " removed " << removed << " out-edges";
+    Q_UNUSED(removed);
 }
 
 
@@ -271,120 +382,37 @@ void GraphVertex::edgeRemoveTo (const int v2) {
  * @param v2
  */
 void GraphVertex::edgeRemoveFrom(const int v2){
-    qDebug() << "GraphVertex::edgeRemoveFrom() - vertex " << m_name
-             << " has " <<  inEdges() << "  in-edges. RemovingEdgeFrom " << v2 ;
-
-    if (inEdges()>0) {
-        qDebug() << "GraphVertex::edgeRemoveFrom() - checking all_inEdges";
-        H_edges::iterator it=m_inEdges.find(v2);
-        while (it != m_inEdges.end() ) {
-            if ( it.key() == v2 && it.value().first == m_curRelation ) {
-                qDebug() << " *** vertex " << m_name << " connected from  "
-                         << it.key() << " relation " << it.value().first
-                         << " weight " << it.value().second.first
-                         << " enabled ? " << it.value().second.second
-                         << " Erasing inEdge from m_inEdges ";
-                it=m_inEdges.erase(it);
-            }
-            else {
-                ++it;
-            }
-        }
-        qDebug() << "GraphVertex::edgeRemoveFrom() - vertex " << m_name << " now has "
-                 << inEdges() << " in-links"  ;
-	}
-	else {
-        qDebug() << "GraphVertex::edgeRemoveFrom() - vertex " << m_name << " has no edges";
-	}
+    qCHotDebug(lcGraphVertex) << "GraphVertex::edgeRemoveFrom() - vertex " << m_name
+             << " removing edge from " << v2 ;
+    const int removed = inEdgesOf(m_curRelation).remove(v2);
+    qCHotDebug(lcGraphVertex) << "GraphVertex::edgeRemoveFrom() - vertex " << m_name
+                              << " removed " << removed << " in-edges";
+    Q_UNUSED(removed);
 }
 
 
 
-/**
- * @brief Filters out edges over or under a specified weight (m_threshold)
- * @param m_threshold
- * @param overThreshold
- */
-void GraphVertex::edgeFilterByWeight(qreal m_threshold, bool overThreshold){
-	qDebug() << "GraphVertex::edgeFilterByWeight of vertex " << this->m_name;
-	int target=0;
-    qreal weight=0;
-    QMutableHashIterator < int, pair_i_fb > it (m_outEdges);
-    while ( it.hasNext()) {
-        it.next();
-        if ( it.value().first == m_curRelation ) {
-            target=it.key();
-            weight = it.value().second.first;
-            if (overThreshold) {
-                if ( weight >= m_threshold ) {
-                    qDebug() << "GraphVertex::edgeFilterByWeight() - edge  to " << target
-                    << " has weight " << weight
-                    << ". It will be disabled. Emitting signal to Graph....";
-                    it.setValue(pair_i_fb(m_curRelation, pair_f_b(weight, false) ));
-                    emit setEdgeVisibility (m_curRelation, m_name, target, false );
-                }
-                else {
-                    qDebug() << "GraphVertex::edgeFilterByWeight() - edge  to " << target
-                    << " has weight " << weight << ". It will be enabled. Emitting signal to Graph....";
-                    it.setValue(pair_i_fb(m_curRelation, pair_f_b(weight, true) ));
-                    emit setEdgeVisibility (m_curRelation, m_name, target, true );
-                }
-            }
-            else {
-                 if ( weight <= m_threshold ) {
-                    qDebug() << "GraphVertex::edgeFilterByWeight() - edge  to " << target
-                    << " has weight " << weight << ". It will be disabled. Emitting signal to Graph....";
-                    it.setValue(pair_i_fb(m_curRelation, pair_f_b(weight, false) ));
-                    emit setEdgeVisibility (m_curRelation, m_name, target, false );
-                }
-                else {
-                    qDebug() << "GraphVertex::edgeFilterByWeight() - edge  to " << target
-                    << " has weight " << weight << ". It will be enabled. Emitting signal to Graph....";
-                    it.setValue(pair_i_fb(m_curRelation, pair_f_b(weight, true) ));
-                    emit setEdgeVisibility (m_curRelation, m_name, target, true );
-                }
-            }
-
-        }
-    }
-}
-
-
-
-
-
-
-
 /**
  * @brief Filters out unilateral (non-reciprocal) edges
    If allRelations is true, then all relations are checked
  * @param toggle
  */
 void GraphVertex::edgeFilterUnilateral(const bool &toggle){
-    qDebug() << "GraphVertex::edgeFilterUnilateral() of vertex " << this->m_name;
+    qCHotDebug(lcGraphVertex) << "GraphVertex::edgeFilterUnilateral() of vertex " << this->m_name;
     int target=0;
-    qreal weight=0;
-    QMutableHashIterator < int, pair_i_fb > it (m_outEdges);
-    while ( it.hasNext()) {
-        it.next();
-        if ( it.value().first == m_curRelation ) {
-            target=it.key();
-            weight = it.value().second.first;
-            if (hasEdgeFrom(target)==0) {   // \todo != weight would be more precise?
-                    if ( !toggle ) {
-                        qDebug() << "GraphVertex::edgeFilterUnilateral() - unilateral edge to " << target
-                        << " has weight " << weight
-                        << ". It will be disabled. Emitting signal to Graph....";
-                        it.setValue(pair_i_fb(m_curRelation, pair_f_b(weight, false) ));
-                        emit setEdgeVisibility (m_curRelation, m_name, target, false );
-                    }
-                    else {
-                        qDebug() << "GraphVertex::edgeFilterUnilateral() - unilateral edge to " << target
-                        << " has weight " << weight << ". It will be enabled. Emitting signal to Graph....";
-                        it.setValue(pair_i_fb(m_curRelation, pair_f_b(weight, true) ));
-                        emit setEdgeVisibility (m_curRelation, m_name, target, true );
-                    }
+    H_edges &edges = outEdgesOf(m_curRelation);
+    for (H_edges::iterator it = edges.begin(); it != edges.end(); ++it) {
+        target=it.key();
+        if (hasEdgeFrom(target)==0) {   // \todo != weight would be more precise?
+            if ( it.value().second == toggle ) {
+                continue;
             }
+            qCHotDebug(lcGraphVertex) << "GraphVertex::edgeFilterUnilateral() - unilateral edge to " << target
+                     << " has weight " << it.value().first
+                     << ". It will be" << ( toggle ? "enabled" : "disabled" )
+                     << ". Emitting signal to Graph....";
+            it.value().second = toggle;
+            edgeVisibilityChanged( m_curRelation, target, toggle );
         }
     }
 }
@@ -392,33 +420,23 @@ void GraphVertex::edgeFilterUnilateral(const bool &toggle){
 
 
 /**
- * @brief Filters out all edges of a given relation
+ * @brief Enables or disables all edges of a given relation
  * @param relation
  */
 void GraphVertex::edgeFilterByRelation(int relation, bool status ){
-    qDebug() << "GraphVertex::edgeFilterByRelation() - Vertex" << name()
+    qCHotDebug(lcGraphVertex) << "GraphVertex::edgeFilterByRelation() - Vertex" << name()
                 << "Setting edges of relation" << relation << "to" << status;
-    int target=0;
-    qreal weight =0;
-    int edgeRelation=0;
-    QMutableHashIterator < int, pair_i_fb > it1 (m_outEdges);
-    while ( it1.hasNext()) {
-        it1.next();
-        edgeRelation = it1.value().first;
-        if ( edgeRelation == relation ) {
-            target=it1.key();
-            weight = it1.value().second.first;
-            qDebug() << "GraphVertex::edgeFilterByRelation() - outLink"
-                     << m_name << " -> " << target
-                     << " of relation" << relation
-                     << "Emitting to GW to be" << status ;
-            it1.setValue(pair_i_fb(relation, pair_f_b(weight, status) ));
-            emit setEdgeVisibility ( relation, m_name, target, status );
-        }
-        else {
-
-        }
-
+    if ( relation < 0 || relation >= m_outEdges.size() ) {
+        return;
+    }
+    H_edges &edges = m_outEdges[relation];
+    for (H_edges::iterator it1 = edges.begin(); it1 != edges.end(); ++it1) {
+        qCHotDebug(lcGraphVertex) << "GraphVertex::edgeFilterByRelation() - outLink"
+                 << m_name << " -> " << it1.key()
+                 << " of relation" << relation
+                 << "Emitting to GW to be" << status ;
+        it1.value().second = status;
+        edgeVisibilityChanged( relation, it1.key(), status );
     }
 }
 
@@ -431,18 +449,11 @@ void GraphVertex::edgeFilterByRelation(int relation, bool status ){
  */
 int GraphVertex::outEdges() {
     m_outEdgesCounter = 0;
-    int relation=0;
-    bool edgeStatus = false;
-    H_edges::const_iterator it1=m_outEdges.constBegin();
-    while (it1 != m_outEdges.constEnd() ) {
-        relation = it1.value().first;
-        if ( relation == m_curRelation ) {
-            edgeStatus=it1.value().second.second;
-            if ( edgeStatus == true) {
-                m_outEdgesCounter++;
-            }
+    const H_edges &edges = outEdgesRelation(m_curRelation);
+    for (H_edges::const_iterator it1 = edges.constBegin(); it1 != edges.constEnd(); ++it1) {
+        if ( it1.value().second ) {
+            m_outEdgesCounter++;
         }
-        ++it1;
     }
     return m_outEdgesCounter;
 }
@@ -461,75 +472,27 @@ int GraphVertex::outEdgesConst() const {
 
 /**
  * @brief Returns a qhash of all enabled outEdges in the active relation
+ * If allRelations is true, returns the enabled outEdges of all relations,
+ * one per target, the first relation first.
  * @return  QHash<int,qreal>*
  */
 QHash<int,qreal> GraphVertex::outEdgesEnabledHash(const bool &allRelations){
-    //qDebug() << " GraphVertex::outEdgesEnabledHash() vertex " << this->name();
     QHash<int,qreal> enabledOutEdges;
-    qreal m_weight=0;
-    int relation = 0;
-    bool edgeStatus=false;
-    H_edges::const_iterator it1=m_outEdges.constBegin();
-    while (it1 != m_outEdges.constEnd() ) {
-        relation = it1.value().first;
-        if (!allRelations) {
-            if ( relation == m_curRelation ) {
-                edgeStatus=it1.value().second.second;
-                if ( edgeStatus == true) {
-                    m_weight=it1.value().second.first;
-                    enabledOutEdges.insert(it1.key(), m_weight);
-                    //                qDebug() <<  " GraphVertex::outEdgesEnabledHash() count:"
-                    //                             << enabledOutEdges->count();
-                }
+    const int first = allRelations ? 0 : m_curRelation;
+    const int last = allRelations ? m_outEdges.size() - 1 : m_curRelation;
+    for (int relation = first; relation <= last; ++relation) {
+        const H_edges &edges = outEdgesRelation(relation);
+        H_edges::const_iterator it1;
+        for (it1 = edges.constBegin(); it1 != edges.constEnd(); ++it1) {
+            if ( it1.value().second && !enabledOutEdges.contains( it1.key() ) ) {
+                enabledOutEdges.insert(it1.key(), it1.value().first);
             }
         }
-        else {
-            if ( !enabledOutEdges.contains(it1.key() )) {
-                edgeStatus=it1.value().second.second;
-                if ( edgeStatus == true) {
-                    m_weight=it1.value().second.first;
-                    enabledOutEdges.insert(it1.key(), m_weight);
-                    //                qDebug() <<  " GraphVertex::outEdgesEnabledHash() count:"
-                    //                             << enabledOutEdges->count();
-                }
-            }
-        }
-        ++it1;
     }
-//    qDebug() << " GraphVertex::outEdgesEnabledHash() vertex " << this->name()
-//                << " outEdges count:"
-//                 << enabledOutEdges->count();
     return enabledOutEdges;
 }
 
 
-/**
- * @brief  Returns a qhash of all edges to neighbors in all relations
- * @return
- */
-QHash<int, qreal>* GraphVertex::outEdgesAllRelationsUniqueHash() {
-    qDebug() << "GraphVertex::outEdgesAllRelationsUniqueHash() - v " << this->name();
-    QHash<int,qreal> *outEdgesAll = new QHash<int,qreal>;
-    qreal m_weight=0;
-    H_edges::const_iterator it1=m_outEdges.constBegin();
-    while (it1 != m_outEdges.constEnd() ) {
-        if ( !outEdgesAll->contains(it1.key() )) {
-                m_weight=it1.value().second.first;
-                outEdgesAll->insert(it1.key(), m_weight);
-                qDebug() <<  "GraphVertex::outEdgesAllRelationsUniqueHash() -"
-                          << this->name() << "->" << it1.key()
-                          << "relation"<< it1.value().first;
-
-        }
-        ++it1;
-    }
-    qDebug() << "GraphVertex::outEdgesAllRelationsUniqueHash() - v " << this->name()
-                << " outEdges count:"
-                 << outEdgesAll->count();
-    return outEdgesAll;
-
-}
-
 /**
  * @brief Returns a qhash of all reciprocal edges to neighbors in the active relation
  * @return  QHash<int,qreal>*
@@ -537,32 +500,18 @@ QHash<int, qreal>* GraphVertex::outEdgesAllRelationsUniqueHash() {
 QHash<int, qreal> GraphVertex::reciprocalEdgesHash(){
     m_reciprocalEdges.clear();
     qreal m_weight=0;
-    int relation = 0;
-    bool edgeStatus=false;
-    H_edges::const_iterator it1=m_outEdges.constBegin();
-//    qDebug() << "GraphVertex::reciprocalEdgesHash() - of vertex "
-//             << this->name()
-//                << " - outEdges " <<  m_outEdges.count()
-//                << " - Checking all edges for reciprocality";
-
-    while (it1 != m_outEdges.constEnd() ) {
-        relation = it1.value().first;
-        if ( relation == m_curRelation ) {
-            edgeStatus=it1.value().second.second;
-            if ( edgeStatus == true) {
-                m_weight=it1.value().second.first;
-                if (this->hasEdgeFrom (it1.key()) == m_weight ) {
-//                    qDebug() << "GraphVertex::reciprocalEdgesHash() - of vertex "
-//                             << this->name()
-//                             << "Found reciprocal edge with   " << it1.key();
-                    m_reciprocalEdges.insert(it1.key(), m_weight);
-                }
+    const H_edges &edges = outEdgesRelation(m_curRelation);
+    H_edges::const_iterator it1;
+    for (it1 = edges.constBegin(); it1 != edges.constEnd(); ++it1) {
+        if ( it1.value().second ) {
+            m_weight=it1.value().first;
+            if (this->hasEdgeFrom (it1.key()) == m_weight ) {
+                m_reciprocalEdges.insert(it1.key(), m_weight);
             }
         }
-        ++it1;
     }
 
-    qDebug() << "GraphVertex::reciprocalEdgesHash() - vertex" << this->name()
+    qCHotDebug(lcGraphVertex) << "GraphVertex::reciprocalEdgesHash() - vertex" << this->name()
              <<  "reciprocalEdges:"
               << m_reciprocalEdges.count();
 
@@ -581,36 +530,15 @@ QHash<int, qreal> GraphVertex::reciprocalEdgesHash(){
 QList<int> GraphVertex::neighborhoodList(){
 
     m_neighborhoodList.clear();
-    qreal m_weight=0;
-    int relation = 0;
-    bool edgeStatus=false;
-    H_edges::const_iterator it1=m_outEdges.constBegin();
-    while (it1 != m_outEdges.constEnd() ) {
-        relation = it1.value().first;
-        if ( relation == m_curRelation ) {
-            edgeStatus=it1.value().second.second;
-            if ( edgeStatus == true) {
-                m_weight=it1.value().second.first;
-                if ( this->name() != it1.key() && this->hasEdgeFrom (it1.key()) == m_weight ) {
-                    m_neighborhoodList << it1.key();
-//                qDebug() <<  "GraphVertex::neighborhoodList() - mutually connected neighbor="
-//                          << it1.key()
-//                          << " m_neighborhoodList.count()"
-//                          << m_neighborhoodList.count();
-                }
-            }
+    const H_edges &edges = outEdgesRelation(m_curRelation);
+    H_edges::const_iterator it1;
+    for (it1 = edges.constBegin(); it1 != edges.constEnd(); ++it1) {
+        if ( it1.value().second
+             && this->name() != it1.key()
+             && this->hasEdgeFrom (it1.key()) == it1.value().first ) {
+            m_neighborhoodList << it1.key();
         }
-        ++it1;
     }
-
-//    qDebug() << "GraphVertex::neighborhoodList() - of vertex " << this->name()
-//             <<  "final list"
-//              <<m_neighborhoodList
-//                 <<" count"
-//                 << m_neighborhoodList.count();
-
-//    qDebug() <<  "GraphVertex::neighborhoodList() - reporting localDegree "
-//                 << this->localDegree();
     return m_neighborhoodList;
 }
 
@@ -622,18 +550,11 @@ QList<int> GraphVertex::neighborhoodList(){
  */
 int GraphVertex::inEdges() {
     m_inEdgesCounter = 0;
-    int relation=0;
-    bool edgeStatus = false;
-    H_edges::const_iterator it1=m_inEdges.constBegin();
-    while (it1 != m_inEdges.constEnd() ) {
-        relation = it1.value().first;
-        if ( relation == m_curRelation ) {
-            edgeStatus=it1.value().second.second;
-            if ( edgeStatus == true) {
-                m_inEdgesCounter++;
-            }
+    const H_edges &edges = inEdgesRelation(m_curRelation);
+    for (H_edges::const_iterator it1 = edges.constBegin(); it1 != edges.constEnd(); ++it1) {
+        if ( it1.value().second ) {
+            m_inEdgesCounter++;
         }
-        ++it1;
     }
     return m_inEdgesCounter;
 }
@@ -648,22 +569,13 @@ int GraphVertex::inEdges() {
  * @return  QHash<int,qreal>*
  */
 QHash<int,qreal>* GraphVertex::inEdgesEnabledHash() {
-    qDebug() << "GraphVertex::inEdgesEnabledHash()";
+    qCHotDebug(lcGraphVertex) << "GraphVertex::inEdgesEnabledHash()";
     QHash<int,qreal> *enabledInEdges = new QHash<int,qreal>;
-    qreal m_weight=0;
-    int relation = 0;
-    bool edgeStatus=false;
-    H_edges::const_iterator it1=m_inEdges.constBegin();
-    while (it1 != m_inEdges.constEnd() ) {
-        relation = it1.value().first;
-        if ( relation == m_curRelation ) {
-            edgeStatus=it1.value().second.second;
-            if ( edgeStatus == true) {
-                m_weight=it1.value().second.first;
-                enabledInEdges->insert(it1.key(), m_weight);
-            }
+    const H_edges &edges = inEdgesRelation(m_curRelation);
+    for (H_edges::const_iterator it1 = edges.constBegin(); it1 != edges.constEnd(); ++it1) {
+        if ( it1.value().second ) {
+            enabledInEdges->insert(it1.key(), it1.value().first);
         }
-        ++it1;
     }
 
     return enabledInEdges;
@@ -687,22 +599,13 @@ int GraphVertex::inEdgesConst() const {
  * @return int
  */
 int GraphVertex::degreeOut() {
-    qDebug() << "GraphVertex::degreeOut()";
+    qCHotDebug(lcGraphVertex) << "GraphVertex::degreeOut()";
     m_outDegree=0;
-    qreal m_weight=0;
-    int relation = 0;
-    bool edgeStatus=false;
-    H_edges::const_iterator it1=m_outEdges.constBegin();
-    while (it1 != m_outEdges.constEnd() ) {
-        relation = it1.value().first;
-        if ( relation == m_curRelation ) {
-            edgeStatus=it1.value().second.second;
-            if ( edgeStatus == true) {
-                m_weight=it1.value().second.first;
-                m_outDegree += m_weight;
-            }
+    const H_edges &edges = outEdgesRelation(m_curRelation);
+    for (H_edges::const_iterator it1 = edges.constBegin(); it1 != edges.constEnd(); ++it1) {
+        if ( it1.value().second ) {
+            m_outDegree += it1.value().first;
         }
-        ++it1;
     }
     return m_outDegree;
 }
@@ -716,22 +619,13 @@ int GraphVertex::outDegreeConst() {
  * @return int
  */
 int GraphVertex::degreeIn() {
-    qDebug() << "GraphVertex::degreeIn()";
+    qCHotDebug(lcGraphVertex) << "GraphVertex::degreeIn()";
     m_inDegree=0;
-    qreal m_weight=0;
-    int relation = 0;
-    bool edgeStatus=false;
-    H_edges::const_iterator it1=m_inEdges.constBegin();
-    while (it1 != m_inEdges.constEnd() ) {
-        relation = it1.value().first;
-        if ( relation == m_curRelation ) {
-            edgeStatus=it1.value().second.second;
-            if ( edgeStatus == true) {
-                m_weight=it1.value().second.first;
-                m_inDegree += m_weight;
-            }
+    const H_edges &edges = inEdgesRelation(m_curRelation);
+    for (H_edges::const_iterator it1 = edges.constBegin(); it1 != edges.constEnd(); ++it1) {
+        if ( it1.value().second ) {
+            m_inDegree += it1.value().first;
         }
-        ++it1;
     }
 
     return m_inDegree;
@@ -746,25 +640,17 @@ int GraphVertex::inDegreeConst() {
 /**
     localDegree is the degreeOut + degreeIn minus the edges counted twice.
 */
-int GraphVertex::localDegree(){  int v2=0;
-    int relation = 0;
-    bool edgeStatus=false;
+int GraphVertex::localDegree(){
     m_localDegree = (degreeOut() + degreeIn() );
 
-    H_edges::const_iterator it1=m_outEdges.constBegin();
-    while (it1 != m_outEdges.constEnd() ) {
-        relation = it1.value().first;
-        if ( relation == m_curRelation ) {
-            edgeStatus=it1.value().second.second;
-            if ( edgeStatus == true) {
-                v2=it1.key();
-                if (this->hasEdgeFrom (v2) ) m_localDegree--;
-            }
+    const H_edges &edges = outEdgesRelation(m_curRelation);
+    for (H_edges::const_iterator it1 = edges.constBegin(); it1 != edges.constEnd(); ++it1) {
+        if ( it1.value().second && this->hasEdgeFrom ( it1.key() ) ) {
+            m_localDegree--;
         }
-        ++it1;
     }
 
-	qDebug() << "GraphVertex:: localDegree() for " << this->name()  << "is " << m_localDegree;
+	qCHotDebug(lcGraphVertex) << "GraphVertex:: localDegree() for " << this->name()  << "is " << m_localDegree;
 	return m_localDegree;
 }
 
@@ -773,93 +659,78 @@ int GraphVertex::localDegree(){  int v2=0;
  * @brief GraphVertex::hasEdgeTo
  * Checks if this vertex is outlinked to v2 and returns the weight of the edge
  * only if the outbound edge is enabled.
+ * If allRelations is true, returns the weight of the edge in the first
+ * relation having one, enabled or not.
  * @param v2
  * @return
  */
 qreal GraphVertex::hasEdgeTo(const int &v2, const bool &allRelations){
-    qreal m_weight=0;
-    bool edgeStatus=false;
-    H_edges::const_iterator it1=m_outEdges.find(v2);
-    while (it1 != m_outEdges.end() && it1.key() == v2 ) {
-        if (!allRelations) {
-            if ( it1.value().first == m_curRelation  ) {
-                edgeStatus=it1.value().second.second;
-                if ( edgeStatus == true) {
-                    m_weight=it1.value().second.first;
-//                    qDebug()<< "GraphVertex::hasEdgeTo() - "<<  this->name()
-//                            << "->" << v2 << " = "<< m_weight;
-                    return m_weight;
-                }
-                else {
-//                    qDebug()<< "GraphVertex::hasEdgeTo() - "<<  this->name()
-//                            << "->" << v2 << " = "<< m_weight
-//                            << " but edgeStatus " << edgeStatus;
-                    return 0;
-                }
-            }
+    if (!allRelations) {
+        const H_edges &edges = outEdgesRelation(m_curRelation);
+        H_edges::const_iterator it1 = edges.constFind(v2);
+        if ( it1 != edges.constEnd() && it1.value().second ) {
+            return it1.value().first;
         }
-        else {
-                m_weight=it1.value().second.first;
-//                qDebug()<< "GraphVertex::hasEdgeTo() - "<<  this->name()
-//                        << "->" << v2 << " = "<< m_weight
-//                        << "relation"<<it1.value().first;
-                return m_weight;
+        return 0;
+    }
+    for (int relation = 0; relation < m_outEdges.size(); ++relation) {
+        H_edges::const_iterator it1 = m_outEdges.at(relation).constFind(v2);
+        if ( it1 != m_outEdges.at(relation).constEnd() ) {
+            return it1.value().first;
         }
-        ++it1;
     }
-
 	return 0;
 }
 
 
+/**
+ * @brief Returns true if the outbound edge to v2 in the current relation is
+ * enabled. Unlike hasEdgeTo(), weight is set to the edge weight even if the
+ * edge is disabled, and a zero-weight edge is told from a missing one.
+ * @param v2
+ * @param weight
+ * @return
+ */
+bool GraphVertex::outEdgeStatus(const int &v2, qreal &weight){
+    weight = 0;
+    const H_edges &edges = outEdgesRelation(m_curRelation);
+    H_edges::const_iterator it1 = edges.constFind(v2);
+    if ( it1 != edges.constEnd() ) {
+        weight = it1.value().first;
+        return it1.value().second;
+    }
+    return false;
+}
+
+
+
 /**
  * @brief GraphVertex::hasEdgeFrom
  * Checks if this vertex is inLinked from v2 and returns the weight of the link
  * only if the inLink is enabled.
+ * If allRelations is true, returns the weight of the link in the first
+ * relation having one, enabled or not.
  * @param v2
  * @return
  */
 qreal GraphVertex::hasEdgeFrom(const int &v2, const bool &allRelations){
-    qreal m_weight=0;
-    bool edgeStatus=false;
-    H_edges::iterator it1=m_inEdges.find(v2);
-    while (it1 != m_inEdges.end() && it1.key() == v2) {
-        if (!allRelations) {
-            if ( it1.value().first == m_curRelation  ) {
-                edgeStatus=it1.value().second.second;
-                if ( edgeStatus == true) {
-                    m_weight=it1.value().second.first;
-//                    qDebug()<< "GraphVertex::hasEdgeFrom() - "<<  this->name()
-//                            << "<-" << v2 << " = "<< m_weight;
-                    return m_weight;
-                }
-                else {
-//                    qDebug()<< "GraphVertex::hasEdgeFrom() - "<<  this->name()
-//                            << "<-" << v2 << " = "<< m_weight
-//                            << " but edgeStatus " << edgeStatus;
-                    return 0;
-                }
-            }
+    if (!allRelations) {
+        const H_edges &edges = inEdgesRelation(m_curRelation);
+        H_edges::const_iterator it1 = edges.constFind(v2);
+        if ( it1 != edges.constEnd() && it1.value().second ) {
+            return it1.value().first;
         }
-        else {
-                m_weight=it1.value().second.first;
-//                qDebug()<< "GraphVertex::hasEdgeFrom() - "<<  this->name()
-//                        << "<-" << v2 << " = "<< m_weight
-//                           << "relation"<<it1.value().first;
-                return m_weight;
-
-
-
+        return 0;
+    }
+    for (int relation = 0; relation < m_inEdges.size(); ++relation) {
+        H_edges::const_iterator it1 = m_inEdges.at(relation).constFind(v2);
+        if ( it1 != m_inEdges.at(relation).constEnd() ) {
+            return it1.value().first;
         }
-        ++it1;
     }
-    //qDebug()<< "GraphVertex::hasEdgeFrom() - a ("  <<  this->name()  << ", " << v2 << ") = 0 ";
     return 0;
 }
 
-
-
-
 /**
  * @brief Sets distance to vertex v1 to dist
  * @param v1
@@ -885,9 +756,13 @@ void GraphVertex::reserveDistance (const int &N) {
 /**
  * @brief Returns geodesic distance to vertex v1
  * If d to v1 has not been set previously, then return RAND_MAX
+ * If the parent graph uses the compact geodesic store, reads from there.
  * @param v1
  */
 qreal GraphVertex::distance (const int &v1) {
+    if ( m_graph->distancesStoreActive() ) {
+        return m_graph->distancesStoreDistance(m_name, v1);
+    }
     qreal d=RAND_MAX;
     int relation=0;
     H_distance::const_iterator it1=m_distance.constFind(v1);
@@ -932,9 +807,13 @@ void GraphVertex::setShortestPaths (const int &v1, const int &sp) {
 /**
  * @brief Returns number of shortest paths to vertex v1
  * If it has not been set previously, then return 0
+ * If the parent graph uses the compact geodesic store, reads from there.
  * @param v1
  */
 int GraphVertex::shortestPaths (const int &v1) {
+    if ( m_graph->distancesStoreActive() ) {
+        return m_graph->distancesStoreShortestPaths(m_name, v1);
+    }
     int sp=0;
     int relation=0;
     H_shortestPaths::const_iterator it1=m_shortestPaths.constFind(v1);
@@ -980,7 +859,7 @@ void GraphVertex::clearShortestPaths() {
  */
 int GraphVertex::cliques (const int &ofSize)
 {
-    return m_cliques.values( ofSize ).size();
+    return m_scores ? m_scores->cliques.values( ofSize ).size() : 0;
 }
 
 /**
@@ -988,11 +867,11 @@ int GraphVertex::cliques (const int &ofSize)
  * @param clique
  */
 void GraphVertex::cliqueAdd (const QList<int> &clique) {
-    qDebug()<<"GraphVertex::cliqueAdd() - vertex:"
+    qCHotDebug(lcGraphVertex)<<"GraphVertex::cliqueAdd() - vertex:"
            << name()
            << "in a clique with:"
            << clique;
-    m_cliques.insert(clique.size(), clique);
+    scores().cliques.insert(clique.size(), clique);
 }
 
 
@@ -1005,7 +884,7 @@ void GraphVertex::clearPs()	{
 }
 	
 void GraphVertex::appendToPs(const int &vertex ) {
-    qDebug()<<"GraphVertex::appendToPs() - vertex:"
+    qCHotDebug(lcGraphVertex)<<"GraphVertex::appendToPs() - vertex:"
            << name() << "adding" <<  vertex << " to myPs";
 	myPs.append(vertex); 
 }
@@ -1018,7 +897,7 @@ L_int GraphVertex::Ps(void) {
 
 
 GraphVertex::~GraphVertex() {
-    qDebug() << " GraphVertex::~GraphVertex() - destroying my data";
+    qCHotDebug(lcGraphVertex) << " GraphVertex::~GraphVertex() - destroying my data";
     m_outEdges.clear();
     m_outEdges.squeeze();
     m_inEdges.clear();
@@ -1042,8 +921,6 @@ GraphVertex::~GraphVertex() {
 
     m_neighborhoodList.clear();
 
-    m_cliques.clear();
-    m_cliques.squeeze();
 
 }
 
@@ -28,14 +28,17 @@
 #ifndef GRAPHVERTEX_H
 #define GRAPHVERTEX_H
 
-#include <QObject>
 #include <QString>
 #include <QStringList>
 #include <QHash>
 #include <QMultiHash>
 #include <QList>
+#include <QVector>
 #include <QPointF>
 #include <map>
+#include <memory>
+
+#include "graphattributes.h"
 
 using namespace std;
 
@@ -49,9 +52,9 @@ typedef QHash<int,QString> H_IntToStr;
 typedef QHash <QString, int> H_StrToInt;
 
 
+// The edges of a vertex in one relation: neighbor -> (weight, enabled)
 typedef QPair <qreal, bool> pair_f_b;
-typedef QPair <int, pair_f_b > pair_i_fb;
-typedef QMultiHash < int, pair_i_fb > H_edges;
+typedef QMultiHash < int, pair_f_b > H_edges;
 
 typedef QPair <int, qreal > pair_i_f;
 typedef QHash < int, pair_i_f > H_distance;
@@ -60,8 +63,27 @@ typedef QPair <int, int> pair_i_i;
 typedef QHash < int, pair_i_i > H_shortestPaths;
 
 
-class GraphVertex : public QObject{
-    Q_OBJECT
+/**
+ * @brief The scores of a vertex, kept apart from it and allocated on the
+ * first score set, so that the vertices of a bare topology do not carry them.
+ */
+struct GraphVertexScores {
+    GraphVertexScores() :
+        eccentricity(0), CLC(0), delta(0), EC(0), SEC(0),
+        DC(0), SDC(0), DP(0), SDP(0), CC(0), SCC(0), BC(0), SBC(0),
+        IRCC(0), SIRCC(0), SC(0), SSC(0), PC(0), SPC(0), IC(0), SIC(0),
+        PRC(0), SPRC(0), PP(0), SPP(0), EVC(0), SEVC(0), distanceSum(0),
+        hasCLC(false) {}
+    qreal eccentricity, CLC, delta, EC, SEC;
+    qreal DC, SDC, DP, SDP, CC, SCC, BC, SBC, IRCC, SIRCC, SC, SSC;
+    qreal PC, SPC, IC, SIC, PRC, SPRC, PP, SPP, EVC, SEVC;
+    qreal distanceSum;
+    bool hasCLC;
+    QMultiHash <int, L_int> cliques;
+};
+
+
+class GraphVertex {
 
 public:
 
@@ -99,12 +121,14 @@ public:
     void changeOutEdgeWeight (const int &target, const qreal &weight);
 
     void setOutEdgeEnabled (const int, bool);
+    bool setOutEdgeFiltered(const int &target, const qreal &weight, const bool &status);
 
     void edgeRemoveTo (const int target);
     void edgeRemoveFrom(const int source);
 
     QHash<int, qreal> outEdgesEnabledHash(const bool &allRelations=false);
-    QHash<int,qreal>* outEdgesAllRelationsUniqueHash();
+    const H_edges &outEdgesRelation(const int &relation) const;
+    const H_edges &inEdgesRelation(const int &relation) const;
     QHash<int,qreal>* inEdgesEnabledHash();
     QHash<int,qreal> reciprocalEdgesHash();
     QList<int> neighborhoodList();
@@ -133,12 +157,13 @@ public:
 
 
     /* sets eccentricity */
-    void setEccentricity (const qreal &c){ m_Eccentricity=c;}
-    qreal eccentricity() { return m_Eccentricity;}
+    void setEccentricity (const qreal &c){ scores().eccentricity=c;}
+    qreal eccentricity() { return m_scores ? m_scores->eccentricity : 0;}
 
     /* Returns true if there is an outLink from this vertex */
     bool isOutLinked() { return (outEdges() > 0) ? true:false;}
     qreal hasEdgeTo(const int &v, const bool &allRelations=false);
+    bool outEdgeStatus(const int &v, qreal &weight);
 
     /* Returns true if there is an outLink from this vertex */
     bool isInLinked() { return  (inEdges() > 0) ? true:false;}
@@ -147,7 +172,6 @@ public:
     bool isIsolated() { return !(isOutLinked() | isInLinked()) ; }
     void setIsolated(bool isolated) {m_isolated = isolated; }
 
-    void edgeFilterByWeight(qreal m_threshold, bool overThreshold);
     //	void filterEdgesByColor(qreal m_threshold, bool overThreshold);
     void edgeFilterByRelation(int relation, bool status);
     void edgeFilterUnilateral(const bool &toggle=false);
@@ -155,16 +179,18 @@ public:
     void setSize(const int &size ) { m_size=size; }
     int size()  const { return m_size; }
 
-    void setShape(const QString &shape, const QString &iconPath = QString()) { m_shape=shape; m_iconPath=iconPath;}
-    QString shape() const { return m_shape; }
-    QString shapeIconPath() {return m_iconPath; }
+    void setShape(const QString &shape, const QString &iconPath = QString()) {
+        m_shape=GraphAttributes::id(shape); m_iconPath=GraphAttributes::id(iconPath);
+    }
+    QString shape() const { return GraphAttributes::value(m_shape); }
+    QString shapeIconPath() {return GraphAttributes::value(m_iconPath); }
 
-    void setColor(const QString &color) { m_color=color; }
-    QString color() const { return m_color; }
+    void setColor(const QString &color) { m_color=GraphAttributes::id(color); }
+    QString color() const { return GraphAttributes::value(m_color); }
     QString colorToPajek();
 
-    void setNumberColor (const QString &color) { m_numberColor = color; }
-    QString numberColor() const { return m_numberColor; }
+    void setNumberColor (const QString &color) { m_numberColor = GraphAttributes::id(color); }
+    QString numberColor() const { return GraphAttributes::value(m_numberColor); }
 
     void setNumberSize (const int &size) { m_numberSize=size; }
     int numberSize() const { return m_numberSize; }
@@ -175,8 +201,8 @@ public:
     void setLabel (const QString &label) { m_label=label; }
     QString label() const { return m_label; }
 
-    void setLabelColor (const QString &labelColor) { m_labelColor=labelColor; }
-    QString labelColor() const { return m_labelColor; }
+    void setLabelColor (const QString &labelColor) { m_labelColor=GraphAttributes::id(labelColor); }
+    QString labelColor() const { return GraphAttributes::value(m_labelColor); }
 
     void setLabelSize(const int &size) { m_labelSize=size; }
     int labelSize() const { return m_labelSize; }
@@ -200,22 +226,17 @@ public:
     void set_dispY (qreal y) { m_disp.ry() = y ; }
 
 
-    void setOutLinkColor(const int &v2,
-                         const QString &color) { m_outLinkColors[v2]=color; }
-    QString outLinkColor(const int &v2) {
-        return ( m_outLinkColors.contains(v2) ) ? m_outLinkColors.value(v2) : "black";
-    }
-
+    void setOutLinkColor(const int &v2, const QString &color);
+    QString outLinkColor(const int &v2) const;
 
-    void setOutEdgeLabel(const int &v2,
-                         const QString &label) { m_outEdgeLabels[v2]=label; }
+    void setOutEdgeLabel(const int &v2, const QString &label);
     QString outEdgeLabel(const int &v2) const {
-        return ( m_outEdgeLabels.contains(v2) ) ? m_outEdgeLabels.value(v2) : QString();
+        return m_outEdgeLabels.value(v2);
     }
 
 
-    void setDelta (const qreal &c){ m_delta=c;} 		/* Sets vertex pair dependancy */
-    qreal delta() { return m_delta;}		/* Returns vertex pair dependancy */
+    void setDelta (const qreal &c){ scores().delta=c;} 		/* Sets vertex pair dependancy */
+    qreal delta() { return m_scores ? m_scores->delta : 0;}		/* Returns vertex pair dependancy */
 
     void clearPs()	;
 
@@ -232,81 +253,78 @@ public:
     void setInEdgesNonSym(int inEdgesNonSym=-1) { m_inEdgesNonSym = (inEdgesNonSym!=-1) ?  inEdgesNonSym :  m_inEdgesNonSym+1;  }
     int inEdgesNonSym() { return m_inEdgesNonSym; }
 
-    void setDC (const qreal &c){ m_DC=c;} 	/* Sets vertex Degree Centrality*/
-    void setSDC (const qreal &c ) { m_SDC=c;}	/* Sets standard vertex Degree Centrality*/
-    qreal DC() { return m_DC;}          /* Returns vertex Degree Centrality*/
-    qreal SDC() { return m_SDC;}		/* Returns standard vertex Degree Centrality*/
-
-    void setDistanceSum (const qreal &c) { m_distanceSum = c; }
-    qreal distanceSum () { return m_distanceSum; }
-    void setCC (const qreal &c){ m_CC=c;}		/* sets vertex Closeness Centrality*/
-    void setSCC (const qreal &c ) { m_SCC=c;}	/* sets standard vertex Closeness Centrality*/
-    qreal CC() { return m_CC;}		/* Returns vertex Closeness Centrality*/
-    qreal SCC() { return m_SCC; }		/* Returns standard vertex Closeness Centrality*/
-
-    void setIRCC (const qreal &c){ m_IRCC=c;}		/* sets vertex IRCC */
-    void setSIRCC (const qreal &c ) { m_SIRCC=c;}	/* sets standard vertex IRCC */
-    qreal IRCC() { return m_IRCC;}		/* Returns vertex IRCC */
-    qreal SIRCC() { return m_SIRCC; }		/* Returns standard vertex IRCC*/
-
-    void setBC(const qreal &c){ m_BC=c;}		/* sets s vertex Betweenness Centrality*/
-    void setSBC (const qreal &c ) { m_SBC=c;}	/* sets standard vertex Betweenness Centrality*/
-    qreal BC() { return m_BC;}		/* Returns vertex Betweenness Centrality*/
-    qreal SBC() { return m_SBC; }		/* Returns standard vertex Betweenness Centrality*/
-
-    void setSC (const qreal &c){ m_SC=c;}  	/* sets vertex Stress Centrality*/
-    void setSSC (const qreal &c ) { m_SSC=c;}	/* sets standard vertex Stress Centrality*/
-    qreal SC() { return m_SC;}		/* Returns vertex Stress Centrality*/
-    qreal SSC() { return m_SSC; }		/* Returns standard vertex Stress Centrality*/
-
-    void setEC(const qreal &dist) { m_EC=dist;}	/* Sets max Geodesic Distance to all other vertices*/
-    void setSEC(const qreal &c) {m_SEC=c;}
-    qreal EC() { return m_EC;}		/* Returns max Geodesic Distance to all other vertices*/
-    qreal SEC() { return m_SEC;}
-
-    void setPC (const qreal &c){ m_PC=c;}		/* sets vertex Power Centrality*/
-    void setSPC (const qreal &c ) { m_SPC=c;}	/* sets standard vertex Power Centrality*/
-    qreal PC() { return m_PC;}		/* Returns vertex Power Centrality*/
-    qreal SPC() { return m_SPC; }		/* Returns standard vertex Power Centrality*/
-
-    void setIC (const qreal &c){ m_IC=c;}		/* sets vertex Information Centrality*/
-    void setSIC (const qreal &c ) { m_SIC=c;}	/* sets standard vertex Information Centrality*/
-    qreal IC() { return m_IC;}		/* Returns vertex Information  Centrality*/
-    qreal SIC() { return m_SIC; }		/* Returns standard vertex Information Centrality*/
-
-    void setDP (const qreal &c){ m_DP=c;} 	/* Sets vertex Degree Prestige */
-    void setSDP (const qreal &c ) { m_SDP=c;}	/* Sets standard vertex Degree Prestige */
-    qreal DP() { return m_DP;}		/* Returns vertex Degree Prestige */
-    qreal SDP() { return m_SDP;}		/* Returns standard vertex Degree Prestige */
-
-    void setPRP (const qreal &c){ m_PRC=c;}		/* sets vertex PageRank*/
-    void setSPRP (const qreal &c ) { m_SPRC=c;}	/* sets standard vertex PageRank*/
-    qreal PRP() { return m_PRC;}		/* Returns vertex PageRank */
-    qreal SPRP() { return m_SPRC; }		/* Returns standard vertex PageRank*/
-
-    void setPP (const qreal &c){ m_PP=c;}		/* sets vertex Proximity Prestige */
-    void setSPP (const qreal &c ) { m_SPP=c;}	/* sets standard vertex Proximity Prestige */
-    qreal PP() { return m_PP;}		/* Returns vertex Proximity Prestige */
-    qreal SPP() { return m_SPP; }		/* Returns standard vertex Proximity Prestige */
-
-    qreal CLC() { return m_CLC;	}
-    void setCLC(const qreal &clucof)  { m_CLC=clucof; m_hasCLC=true; }
-    bool hasCLC() {  return m_hasCLC; }
-
-    void setEVC (const qreal &c){ m_EVC=c;} 	/* Sets vertex Degree Centrality*/
-    void setSEVC (const qreal &c ) { m_SEVC=c;}	/* Sets standard vertex Degree Centrality*/
-    qreal EVC() { return m_EVC;}		/* Returns vertex Degree Centrality*/
-    qreal SEVC() { return m_SEVC;}		/* Returns standard vertex Degree Centrality*/
+    void setDC (const qreal &c){ scores().DC=c;} 	/* Sets vertex Degree Centrality*/
+    void setSDC (const qreal &c ) { scores().SDC=c;}	/* Sets standard vertex Degree Centrality*/
+    qreal DC() { return m_scores ? m_scores->DC : 0;}          /* Returns vertex Degree Centrality*/
+    qreal SDC() { return m_scores ? m_scores->SDC : 0;}		/* Returns standard vertex Degree Centrality*/
+
+    void setDistanceSum (const qreal &c) { scores().distanceSum=c; }
+    qreal distanceSum () { return m_scores ? m_scores->distanceSum : 0; }
+    void setCC (const qreal &c){ scores().CC=c;}		/* sets vertex Closeness Centrality*/
+    void setSCC (const qreal &c ) { scores().SCC=c;}	/* sets standard vertex Closeness Centrality*/
+    qreal CC() { return m_scores ? m_scores->CC : 0;}		/* Returns vertex Closeness Centrality*/
+    qreal SCC() { return m_scores ? m_scores->SCC : 0; }		/* Returns standard vertex Closeness Centrality*/
+
+    void setIRCC (const qreal &c){ scores().IRCC=c;}		/* sets vertex IRCC */
+    void setSIRCC (const qreal &c ) { scores().SIRCC=c;}	/* sets standard vertex IRCC */
+    qreal IRCC() { return m_scores ? m_scores->IRCC : 0;}		/* Returns vertex IRCC */
+    qreal SIRCC() { return m_scores ? m_scores->SIRCC : 0; }		/* Returns standard vertex IRCC*/
+
+    void setBC(const qreal &c){ scores().BC=c;}		/* sets s vertex Betweenness Centrality*/
+    void setSBC (const qreal &c ) { scores().SBC=c;}	/* sets standard vertex Betweenness Centrality*/
+    qreal BC() { return m_scores ? m_scores->BC : 0;}		/* Returns vertex Betweenness Centrality*/
+    qreal SBC() { return m_scores ? m_scores->SBC : 0; }		/* Returns standard vertex Betweenness Centrality*/
+
+    void setSC (const qreal &c){ scores().SC=c;}  	/* sets vertex Stress Centrality*/
+    void setSSC (const qreal &c ) { scores().SSC=c;}	/* sets standard vertex Stress Centrality*/
+    qreal SC() { return m_scores ? m_scores->SC : 0;}		/* Returns vertex Stress Centrality*/
+    qreal SSC() { return m_scores ? m_scores->SSC : 0; }		/* Returns standard vertex Stress Centrality*/
+
+    void setEC(const qreal &dist) { scores().EC=dist;}	/* Sets max Geodesic Distance to all other vertices*/
+    void setSEC(const qreal &c) {scores().SEC=c;}
+    qreal EC() { return m_scores ? m_scores->EC : 0;}		/* Returns max Geodesic Distance to all other vertices*/
+    qreal SEC() { return m_scores ? m_scores->SEC : 0;}
+
+    void setPC (const qreal &c){ scores().PC=c;}		/* sets vertex Power Centrality*/
+    void setSPC (const qreal &c ) { scores().SPC=c;}	/* sets standard vertex Power Centrality*/
+    qreal PC() { return m_scores ? m_scores->PC : 0;}		/* Returns vertex Power Centrality*/
+    qreal SPC() { return m_scores ? m_scores->SPC : 0; }		/* Returns standard vertex Power Centrality*/
+
+    void setIC (const qreal &c){ scores().IC=c;}		/* sets vertex Information Centrality*/
+    void setSIC (const qreal &c ) { scores().SIC=c;}	/* sets standard vertex Information Centrality*/
+    qreal IC() { return m_scores ? m_scores->IC : 0;}		/* Returns vertex Information  Centrality*/
+    qreal SIC() { return m_scores ? m_scores->SIC : 0; }		/* Returns standard vertex Information Centrality*/
+
+    void setDP (const qreal &c){ scores().DP=c;} 	/* Sets vertex Degree Prestige */
+    void setSDP (const qreal &c ) { scores().SDP=c;}	/* Sets standard vertex Degree Prestige */
+    qreal DP() { return m_scores ? m_scores->DP : 0;}		/* Returns vertex Degree Prestige */
+    qreal SDP() { return m_scores ? m_scores->SDP : 0;}		/* Returns standard vertex Degree Prestige */
+
+    void setPRP (const qreal &c){ scores().PRC=c;}		/* sets vertex PageRank*/
+    void setSPRP (const qreal &c ) { scores().SPRC=c;}	/* sets standard vertex PageRank*/
+    qreal PRP() { return m_scores ? m_scores->PRC : 0;}		/* Returns vertex PageRank */
+    qreal SPRP() { return m_scores ? m_scores->SPRC : 0; }		/* Returns standard vertex PageRank*/
+
+    void setPP (const qreal &c){ scores().PP=c;}		/* sets vertex Proximity Prestige */
+    void setSPP (const qreal &c ) { scores().SPP=c;}	/* sets standard vertex Proximity Prestige */
+    qreal PP() { return m_scores ? m_scores->PP : 0;}		/* Returns vertex Proximity Prestige */
+    qreal SPP() { return m_scores ? m_scores->SPP : 0; }		/* Returns standard vertex Proximity Prestige */
+
+    qreal CLC() { return m_scores ? m_scores->CLC : 0;	}
+    void setCLC(const qreal &clucof)  { scores().CLC=clucof; scores().hasCLC=true; }
+    bool hasCLC() {  return m_scores && m_scores->hasCLC; }
+
+    void setEVC (const qreal &c){ scores().EVC=c;} 	/* Sets vertex Degree Centrality*/
+    void setSEVC (const qreal &c ) { scores().SEVC=c;}	/* Sets standard vertex Degree Centrality*/
+    qreal EVC() { return m_scores ? m_scores->EVC : 0;}		/* Returns vertex Degree Centrality*/
+    qreal SEVC() { return m_scores ? m_scores->SEVC : 0;}		/* Returns standard vertex Degree Centrality*/
 
 
     int cliques (const int &ofSize);
 
     void cliqueAdd (const QList<int> &clique);
 
-    void clearCliques() {  m_cliques.clear();    }
-
-    //Hashes of all outbound and inbound edges of this vertex.
-    H_edges m_outEdges, m_inEdges;
+    void clearCliques() {  if ( m_scores ) m_scores->cliques.clear();    }
 
     //Hash dictionary of this vertex pair-wise distances to all other vertices for each relationship
     //The key is the relationship
@@ -315,34 +333,40 @@ public:
 
     H_shortestPaths m_shortestPaths;
 
-signals:
-    void setEdgeVisibility (int, int, int, bool);
+private:
+    H_edges &outEdgesOf(const int &relation);
+    H_edges &inEdgesOf(const int &relation);
+    GraphVertexScores &scores();
+    void edgeVisibilityChanged(const int &relation, const int &target, const bool &visible);
 
-protected:
+    //The outbound and inbound edges of this vertex, one hash per relation,
+    //so that the edge methods touch only the edges of the current relation.
+    QVector<H_edges> m_outEdges, m_inEdges;
+    static const H_edges m_noEdges;
 
-private:
     Graph *m_graph;
     int m_name,  m_outEdgesCounter, m_inEdgesCounter, m_outDegree, m_inDegree, m_localDegree;
     int m_outEdgesNonSym, m_inEdgesNonSym, m_outEdgesSym;
     int m_value, m_size, m_labelSize, m_numberSize, m_numberDistance, m_labelDistance;
     int m_curRelation;
-    bool m_reciprocalLinked, m_enabled, m_hasCLC, m_isolated;
+    bool m_enabled, m_isolated;
     double m_x, m_y;
-    qreal m_Eccentricity, m_CLC;
-    qreal m_delta, m_EC, m_SEC;
-    qreal m_DC, m_SDC, m_DP, m_SDP, m_CC, m_SCC, m_BC, m_SBC, m_IRCC, m_SIRCC, m_SC, m_SSC;
-    qreal m_PC, m_SPC, m_SIC, m_IC, m_SPRC, m_PRC;
-    qreal m_PP, m_SPP, m_EVC, m_SEVC;
-    qreal m_distanceSum;
-
-    QString m_color, m_numberColor, m_label, m_labelColor, m_shape, m_iconPath;
+
+    //The ids of the visual attributes, see GraphAttributes
+    quint32 m_color, m_numberColor, m_labelColor, m_shape, m_iconPath;
+    quint32 m_outLinkColor;                     // the color of the first outbound edge
+    static const quint32 NoColor = 0xffffffff;
+    QString m_label;
     QPointF m_disp;
 
+    std::unique_ptr<GraphVertexScores> m_scores;
+
     QMultiHash<int,qreal> m_reciprocalEdges;
     L_int myPs;
-    QMultiHash <int, L_int> m_cliques;
     L_int m_neighborhoodList;
-    H_IntToStr m_outLinkColors, m_outEdgeLabels;
+    //Only the colors that differ from m_outLinkColor and the labels that are not empty
+    QHash<int, quint32> m_outLinkColors;
+    H_IntToStr m_outEdgeLabels;
 
     //FIXME vertex coords
 
@@ -0,0 +1,180 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphweightindex.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+
+#include "graphweightindex.h"
+#include "graphvertex.h"
+
+#include <QtDebug>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+
+
+GraphWeightIndex::GraphWeightIndex() :
+    m_built(false),
+    m_relation(0),
+    m_version(0),
+    m_cutValid(false),
+    m_cutOverThreshold(false),
+    m_cutPosition(0)
+{
+}
+
+
+
+/**
+ * @brief Frees the index
+ */
+void GraphWeightIndex::clear() {
+    m_built = false;
+    m_relation = 0;
+    m_version = 0;
+    m_cutValid = false;
+    m_cutPosition = 0;
+    m_weights.clear();
+    m_sources.clear();
+    m_targets.clear();
+}
+
+
+
+/**
+ * @brief Collects every edge of the given relation and sorts them by weight
+ * (ties by source position and target).
+ * @param vertices the vertices of the graph, in m_graph order
+ * @param relation
+ * @param version the graph version the edges belong to
+ */
+void GraphWeightIndex::build(const QList<GraphVertex*> &vertices,
+                             const int &relation,
+                             const quint64 &version) {
+
+    QVector<qreal> weights;
+    QVector<int> sources, targets;
+
+    int E = 0;
+    for (int i = 0; i < vertices.size(); ++i) {
+        E += vertices[i]->outEdgesRelation(relation).size();
+    }
+    weights.reserve(E);
+    sources.reserve(E);
+    targets.reserve(E);
+
+    for (int i = 0; i < vertices.size(); ++i) {
+        const H_edges &edges = vertices[i]->outEdgesRelation(relation);
+        for (H_edges::const_iterator it = edges.constBegin(); it != edges.constEnd(); ++it) {
+            weights.append( it.value().first );
+            sources.append( i );
+            targets.append( it.key() );
+        }
+    }
+
+    std::vector<int> order(E);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](const int &a, const int &b) {
+        if ( weights[a] != weights[b] ) {
+            return weights[a] < weights[b];
+        }
+        if ( sources[a] != sources[b] ) {
+            return sources[a] < sources[b];
+        }
+        return targets[a] < targets[b];
+    });
+
+    m_weights.resize(E);
+    m_sources.resize(E);
+    m_targets.resize(E);
+    for (int e = 0; e < E; ++e) {
+        m_weights[e] = weights[ order[e] ];
+        m_sources[e] = sources[ order[e] ];
+        m_targets[e] = targets[ order[e] ];
+    }
+
+    m_built = true;
+    m_relation = relation;
+    m_version = version;
+    m_cutValid = false;
+    m_cutPosition = 0;
+
+    qDebug() << "GraphWeightIndex::build() - relation" << relation
+             << "edges" << E << "version" << version;
+}
+
+
+
+/**
+ * @brief Returns the position of the first edge weighing weight or more
+ * @param weight
+ * @return
+ */
+int GraphWeightIndex::lowerBound(const qreal &weight) const {
+    return (int) ( std::lower_bound( m_weights.constBegin(), m_weights.constEnd(), weight )
+                   - m_weights.constBegin() );
+}
+
+
+
+/**
+ * @brief Returns the position of the first edge weighing more than weight
+ * @param weight
+ * @return
+ */
+int GraphWeightIndex::upperBound(const qreal &weight) const {
+    return (int) ( std::upper_bound( m_weights.constBegin(), m_weights.constEnd(), weight )
+                   - m_weights.constBegin() );
+}
+
+
+
+/**
+ * @brief Returns where a weight threshold cuts the index.
+ * If overThreshold is true, the edges over or at the threshold are filtered
+ * out and the kept edges are those before the cut. Otherwise, the edges under
+ * or at the threshold are filtered out and the kept edges start at the cut.
+ * @param threshold
+ * @param overThreshold
+ * @return
+ */
+int GraphWeightIndex::cut(const qreal &threshold, const bool &overThreshold) const {
+    return overThreshold ? lowerBound(threshold) : upperBound(threshold);
+}
+
+
+
+/**
+ * @brief Remembers the cut the edges of the relation have just been filtered by
+ * @param position
+ * @param overThreshold
+ */
+void GraphWeightIndex::setCut(const int &position, const bool &overThreshold) {
+    m_cutValid = true;
+    m_cutOverThreshold = overThreshold;
+    m_cutPosition = position;
+}
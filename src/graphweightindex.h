@@ -0,0 +1,110 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         graphweightindex.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef GRAPHWEIGHTINDEX_H
+#define GRAPHWEIGHTINDEX_H
+
+#include <QtGlobal>
+#include <QList>
+#include <QVector>
+
+class GraphVertex;
+
+
+/**
+ * @brief The GraphWeightIndex class
+ * The edges of one relation of a Graph, enabled or not, sorted by weight
+ * from the smallest to the largest. Each entry holds the position of the
+ * source in Graph::m_graph (that is, vpos[name]) and the target number.
+ * A weight threshold cuts the index in two at the position cut() returns,
+ * so Graph::edgeFilterByWeight() remembers the last cut with setCut() and,
+ * when the threshold moves, visits only the entries between the two cuts.
+ * It is built by Graph::graphWeightIndex() for one graph version and must
+ * not be used after the graph has changed, unless the change was made from
+ * the index itself and its version was moved forward with setVersion().
+ */
+class GraphWeightIndex
+{
+public:
+    GraphWeightIndex();
+
+    void build(const QList<GraphVertex*> &vertices,
+               const int &relation,
+               const quint64 &version);
+
+    void clear();
+
+    bool isValid(const int &relation, const quint64 &version) const {
+        return m_built && m_relation == relation && m_version == version;
+    }
+
+    int relation() const { return m_relation; }
+    quint64 version() const { return m_version; }
+    void setVersion(const quint64 &version) { m_version = version; }
+
+    /** Number of edges in the index */
+    int size() const { return m_weights.size(); }
+
+    /** Returns the weight, the source position and the target of the i-th lightest edge */
+    qreal weight(const int &i) const { return m_weights[i]; }
+    int source(const int &i) const { return m_sources[i]; }
+    int target(const int &i) const { return m_targets[i]; }
+
+    int lowerBound(const qreal &weight) const;
+    int upperBound(const qreal &weight) const;
+
+    int cut(const qreal &threshold, const bool &overThreshold) const;
+
+    /** Returns true if the i-th edge is kept by a cut at position c */
+    static bool isKept(const int &i, const int &c, const bool &overThreshold) {
+        return overThreshold ? ( i < c ) : ( i >= c );
+    }
+
+    void setCut(const int &position, const bool &overThreshold);
+    void resetCut() { m_cutValid = false; }
+
+    bool hasCut(const bool &overThreshold) const {
+        return m_cutValid && m_cutOverThreshold == overThreshold;
+    }
+    int cutPosition() const { return m_cutPosition; }
+
+private:
+    bool m_built;
+    int m_relation;
+    quint64 m_version;
+
+    bool m_cutValid;
+    bool m_cutOverThreshold;
+    int m_cutPosition;
+
+    QVector<qreal> m_weights;
+    QVector<int> m_sources;
+    QVector<int> m_targets;
+};
+
+#endif // GRAPHWEIGHTINDEX_H
@@ -31,6 +31,9 @@
 #include <QLocale>
 #include <iostream>			//used for cout
 #include "mainwindow.h"		//main application window
+#include "graphtrace.h"
+#include "graphbatch.h"
+#include "graphbenchmark.h"
 
 using namespace std;
 
@@ -38,7 +41,31 @@ int main(int argc, char *argv[])
 {
     Q_INIT_RESOURCE(src);
 
+    // With --batch or --benchmark, run headless: no QApplication, MainWindow
+    // or GraphicsWidget
+    const bool benchmark = GraphBenchmark::isBenchmark(argc, argv);
+    if ( benchmark || GraphBatch::isBatch(argc, argv) ) {
+        QCoreApplication app(argc, argv);
+        app.setApplicationVersion(VERSION);
+        QStringList arguments = app.arguments();
+        const bool trace = ( arguments.removeAll("--trace") > 0 );
+        int result = 0;
+        if ( benchmark ) {
+            GraphBenchmark benchmarks(arguments);
+            result = benchmarks.exec();
+        }
+        else {
+            GraphBatch batch(arguments);
+            result = batch.exec();
+        }
+        if ( trace ) {
+            cerr << "\n" << qPrintable( GraphTrace::report() );
+        }
+        return result;
+    }
+
     QApplication app(argc, argv);
+    app.setApplicationVersion(VERSION);
 
     // Todo update/remove translations
     QTranslator tor( 0 );
@@ -51,15 +78,23 @@ int main(int argc, char *argv[])
     tor.load( QString("socnetv.") + locale.name(), "." );
     app.installTranslator( &tor );
 
+    // With --trace, print how long each analysis took when we quit
+    QStringList arguments = app.arguments();
+    const bool trace = ( arguments.removeAll("--trace") > 0 );
+
     //Check if a filename is passed when this program is called.
     QString option;
-    if ( argc > 1 )     {
-        option = argv[1];
+    if ( arguments.size() > 1 )     {
+        option = arguments.at(1);
         if (option=="--help" || option=="-h" || option=="--h" || option=="-help" ) {
             cout<<"\nSocial Network Visualizer v." << qPrintable(VERSION)<< "\n"
                <<"\nUsage: socnetv [flags] [file]\n"
               <<"-h, --help 	Displays this help message\n"
-             <<"-V, --version	Displays version number\n\n"
+             <<"-V, --version	Displays version number\n"
+             <<"--trace 	Prints the time taken by each analysis on exit\n\n"
+             <<"Without a GUI:\n"
+             << qPrintable(GraphBatch::usage()) << "\n"
+             << qPrintable(GraphBenchmark::usage()) << "\n"
             <<"You can load a network from a file using \n"
             <<"socnetv file.net \n"
             <<"where file.net/csv/dot/graphml must be of valid format. See README\n\n"
@@ -95,7 +130,13 @@ int main(int argc, char *argv[])
     // Show the application
     socnetv->show();
 
-    return app.exec();
+    const int result = app.exec();
+
+    if ( trace ) {
+        cerr << "\n" << qPrintable( GraphTrace::report() );
+    }
+
+    return result;
 }
 
 
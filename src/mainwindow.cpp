@@ -61,6 +61,9 @@
 
 
 #include "chart.h"
+#include "compressedfile.h"
+#include "graphtrace.h"
+#include "graphscheduler.h"
 
 #include "forms/dialogsettings.h"
 
@@ -89,6 +92,7 @@
 #include "forms/dialogdissimilarities.h"
 
 #include "forms/dialogsysteminfo.h"
+#include "forms/dialogprofiler.h"
 
 //Assume no debugging messages
 bool printDebug = false;
@@ -135,6 +139,9 @@ MainWindow::MainWindow(const QString & m_fileName) {
 
     appSettings = initSettings();
 
+    // Size the thread pool shared by all parallel analyses
+    GraphScheduler::setThreads( appSettings["analysisThreads"].toInt() );
+
     // Get host screen width and height
     int primaryScreenWidth = QApplication::primaryScreen()->availableSize().width();
     int primaryScreenHeight = QApplication::primaryScreen()->availableSize().height();
@@ -424,6 +431,9 @@ QMap<QString,QString> MainWindow::initSettings() {
     m_dialogPreviewFile = new DialogPreviewFile(this);
     m_dialogPreviewFile->setCodecList(codecs);
 
+    // The profiler is created the first time it is shown
+    m_dialogProfiler = 0;
+
     connect (m_dialogPreviewFile, &DialogPreviewFile::loadNetworkFileWithCodec,
              this, &MainWindow::slotNetworkFileLoad );
 
@@ -489,6 +499,8 @@ QMap<QString,QString> MainWindow::initSettings() {
     appSettings["canvasIndexMethod"] = "BspTreeIndex";
     appSettings["canvasEdgeHighlighting"] = "true";
     appSettings["canvasNodeHighlighting"] = "true";
+    appSettings["canvasEdgeLayer"] = "false";
+    appSettings["canvasNodeLayer"] = "false";
     appSettings["dataDir"]= dataDir ;
     appSettings["lastUsedDirPath"]= dataDir ;
     appSettings["showRightPanel"] = "true";
@@ -499,6 +511,25 @@ QMap<QString,QString> MainWindow::initSettings() {
     appSettings["initReportsRealNumberPrecision"] = "6";
     appSettings["initReportsLabelsLength"] = "16";
     appSettings["initReportsChartType"] = "0";
+    appSettings["distancesStorageCompact"] = "false";
+    appSettings["distancesIncremental"] = "true";
+    appSettings["distancesIncrementalCentralities"] = "false";
+    appSettings["centralityBetweennessSamples"] = "0";
+    appSettings["prestigePageRankGaussSeidel"] = "false";
+    appSettings["centralityEigenvectorTolerance"] = "0.0000001";
+    appSettings["centralityEigenvectorMaxIterations"] = "500";
+    appSettings["centralityEigenvectorLanczos"] = "false";
+    appSettings["graphMatrixAdjacencySparseDensity"] = "0.05";
+    appSettings["reportsResultStore"] = "false";
+    appSettings["analysisBackground"] = "false";
+    appSettings["randomSeed"] = "0";
+    appSettings["layoutForceDirectedTheta"] = "0.5";
+    appSettings["layoutForceDirectedMultilevel"] = "false";
+    appSettings["layoutKamadaKawaiStress"] = "false";
+    appSettings["layoutKamadaKawaiStressPivots"] = "0";
+    appSettings["analysisThreads"] = "0";
+    appSettings["layoutFrameRate"] = "30";
+    appSettings["layoutAnimateMaxVertices"] = "5000";
 
     // Try to load settings configuration file
     // First check if our settings folder exist
@@ -635,6 +666,9 @@ void MainWindow::slotOpenSettingsDialog() {
     connect( m_settingsDialog, &DialogSettings::setProgressDialog,
              this, &MainWindow::slotOptionsProgressDialogVisibility);
 
+    connect( m_settingsDialog, &DialogSettings::setAnalysisThreads,
+             this, &MainWindow::slotOptionsAnalysisThreads);
+
     connect( m_settingsDialog, &DialogSettings::setPrintLogo,
              this, &MainWindow::slotOptionsEmbedLogoExporting);
 
@@ -1020,6 +1054,16 @@ void MainWindow::initActions(){
             this, SLOT(slotNetworkImportTwoModeSM()));
 
 
+    networkImportBinaryAct = new QAction( QIcon(":/images/open_48px.svg"), tr("SocNetV &Binary Snapshot (.snb)"), this);
+    networkImportBinaryAct->setStatusTip(tr("Open a SocNetV binary snapshot file"));
+    networkImportBinaryAct->setWhatsThis(tr("Import Binary Snapshot \n\n"
+                                            "Opens a network saved as a SocNetV binary snapshot. "
+                                            "Snapshots open almost instantly, even for huge networks, "
+                                            "and keep the prominence index results computed before saving."));
+    connect(networkImportBinaryAct, SIGNAL(triggered()),
+            this, SLOT(slotNetworkImportBinary()));
+
+
     networkSaveAct = new QAction(QIcon(":/images/file_download_48px.svg"), tr("&Save"),  this);
     networkSaveAct->setShortcut(Qt::CTRL+Qt::Key_S);
     networkSaveAct->setStatusTip(tr("Save social network to a file"));
@@ -1066,6 +1110,23 @@ void MainWindow::initActions(){
                                         "Exports the social network to a Pajek-formatted file"));
     connect(networkExportPajek, SIGNAL(triggered()), this, SLOT(slotNetworkExportPajek()));
 
+    networkExportBinaryAct = new QAction( QIcon(":/images/file_download_48px.svg"), tr("SocNetV &Binary Snapshot"), this);
+    networkExportBinaryAct->setStatusTip(tr("Save a binary snapshot of the network, for instant reopening"));
+    networkExportBinaryAct->setWhatsThis(tr("Export Binary Snapshot \n\n"
+                                            "Saves the network, with all relations, vertex attributes, "
+                                            "positions and the prominence index results computed so far, "
+                                            "to a SocNetV binary snapshot (.snb) file."));
+    connect(networkExportBinaryAct, SIGNAL(triggered()), this, SLOT(slotNetworkExportBinary()));
+
+    networkExportIndicesAct = new QAction( QIcon(":/images/file_download_48px.svg"), tr("Vertex &Indices Table"), this);
+    networkExportIndicesAct->setStatusTip(tr("Export the vertex indices computed so far to a CSV file"));
+    networkExportIndicesAct->setWhatsThis(tr("Export Vertex Indices Table \n\n"
+                                             "Exports the centrality and prestige indices, "
+                                             "the clustering coefficient and the eccentricity of every actor, "
+                                             "as computed so far, to one comma (.csv) or tab (.tsv) separated file, "
+                                             "with a row per actor and a column per index."));
+    connect(networkExportIndicesAct, SIGNAL(triggered()), this, SLOT(slotNetworkExportIndices()));
+
 
     networkExportListAct = new QAction( QIcon(":/images/file_download_48px.svg"), tr("&List"), this);
     networkExportListAct->setStatusTip(tr("Export to List-formatted file. "));
@@ -1481,6 +1542,19 @@ void MainWindow::initActions(){
                                            "You must have some node selected."));
     connect(editNodePropertiesAct, SIGNAL(triggered()), this, SLOT(slotEditNodePropertiesDialog()));
 
+    editNodeSelectEgoNetworkAct = new QAction(tr("Select Ego Network..."), this);
+    editNodeSelectEgoNetworkAct->setStatusTip(tr("Select the nodes within some hops "
+                                                 "from the clicked node"));
+    editNodeSelectEgoNetworkAct->setWhatsThis(tr("Select Ego Network\n\n"
+                                                 "Selects the clicked node and all nodes "
+                                                 "within the given number of hops from it, "
+                                                 "ignoring the direction of the arcs, "
+                                                 "and reports their number and density. \n"
+                                                 "You can then create a clique or star "
+                                                 "from the selected nodes."));
+    connect(editNodeSelectEgoNetworkAct, SIGNAL(triggered()),
+            this, SLOT(slotEditNodeSelectEgoNetwork()));
+
 
     editNodeSelectedToCliqueAct = new QAction(QIcon(":/images/cliquenew.png"),
                                               tr("Create a clique from selected nodes "), this);
@@ -1534,6 +1608,19 @@ void MainWindow::initActions(){
             this, SLOT(slotEditNodeSelectedToLine()));
 
 
+    editNodeSelectedToInducedAct = new QAction(QIcon(":/images/cliquenew.png"),
+                                               tr("Copy the subgraph induced by selected nodes"), this);
+    editNodeSelectedToInducedAct->setStatusTip(tr("Copy the edges between selected nodes to a new relation -- "
+                                                  "There must be some nodes selected!"));
+    editNodeSelectedToInducedAct->setWhatsThis(tr("Induced Subgraph from Selected Nodes\n\n"
+                                                  "Copies all the edges between selected nodes "
+                                                  "in the current relation to a new relation, "
+                                                  "so that they form the subgraph induced by them.\n"
+                                                  "You must have some nodes selected."));
+    connect(editNodeSelectedToInducedAct, SIGNAL(triggered()),
+            this, SLOT(slotEditNodeSelectedToInduced()));
+
+
     editNodeColorAll = new QAction(QIcon(":/images/colorize_48px.svg"), tr("Change All Nodes Color (this session)"),	this);
     editNodeColorAll->setStatusTip(tr("Choose a new color for all nodes (in this session only)."));
     editNodeColorAll->setWhatsThis(tr("Nodes Color\n\n"
@@ -3618,6 +3705,30 @@ void MainWindow::initActions(){
 
     connect(helpSystemInfoAct, SIGNAL(triggered()), this, SLOT(slotHelpSystemInfo()));
 
+    helpPerformanceTraceAct = new QAction(QIcon(":/images/about_24px.svg"), tr("Performance Trace"), this);
+    helpPerformanceTraceAct->setStatusTip(tr("Show how long each analysis, layout and file operation took"));
+    helpPerformanceTraceAct->setWhatsThis(
+                tr("<p><b>Performance Trace</b></p>"
+                   "<p>Shows, for every analysis, layout and file operation "
+                   "run so far, how many times it ran and how long it took, "
+                   "longest first. You can include it in your bug reports "
+                   "about slow computations. </p>"));
+
+    connect(helpPerformanceTraceAct, SIGNAL(triggered()), this, SLOT(slotHelpPerformanceTrace()));
+
+    helpProfilerAct = new QAction(QIcon(":/images/about_24px.svg"), tr("Analysis Profiler"), this);
+    helpProfilerAct->setStatusTip(tr("List every analysis run with its timings and memory footprint"));
+    helpProfilerAct->setWhatsThis(
+                tr("<p><b>Analysis Profiler</b></p>"
+                   "<p>Lists every analysis, layout, file operation and report "
+                   "run so far, with the size of the network, its parameters, "
+                   "wall and CPU time, the number of threads and the peak memory "
+                   "held by matrices and distance stores. </p>"
+                   "<p>You can export the list as JSON, and attach it to your "
+                   "bug reports about slow computations. </p>"));
+
+    connect(helpProfilerAct, SIGNAL(triggered()), this, SLOT(slotHelpProfiler()));
+
 
     helpAboutApp = new QAction(QIcon(":/images/about_24px.svg"), tr("About SocNetV"), this);
     helpAboutApp->setStatusTip(tr("About SocNetV"));
@@ -3666,6 +3777,7 @@ void MainWindow::initMenuBar() {
     importSubMenu->addAction(networkImportListAct);
     importSubMenu->addAction(networkImportUcinetAct);
     importSubMenu->addAction(networkImportGraphvizAct);
+    importSubMenu->addAction(networkImportBinaryAct);
     networkMenu ->addMenu (importSubMenu);
 
     networkMenu->addSeparator();
@@ -3707,6 +3819,8 @@ void MainWindow::initMenuBar() {
 
     exportSubMenu->addAction (networkExportSMAct);
     exportSubMenu->addAction (networkExportPajek);
+    exportSubMenu->addAction (networkExportBinaryAct);
+    exportSubMenu->addAction (networkExportIndicesAct);
     //exportSubMenu->addAction (networkExportList);
     //exportSubMenu->addAction (networkExportDL);
     //exportSubMenu->addAction (networkExportGW);
@@ -3765,6 +3879,7 @@ void MainWindow::initMenuBar() {
     editNodeMenu->addAction (editNodeSelectedToStarAct);
     editNodeMenu->addAction (editNodeSelectedToCycleAct);
     editNodeMenu->addAction (editNodeSelectedToLineAct);
+    editNodeMenu->addAction (editNodeSelectedToInducedAct);
 
     editNodeMenu->addSeparator();
 
@@ -4047,6 +4162,8 @@ void MainWindow::initMenuBar() {
     helpMenu->addAction (helpCheckUpdatesApp);
     helpMenu->addSeparator();
     helpMenu->addAction(helpSystemInfoAct);
+    helpMenu->addAction(helpPerformanceTraceAct);
+    helpMenu->addAction(helpProfilerAct);
     helpMenu-> addAction (helpAboutApp);
     helpMenu-> addAction (helpAboutQt);
 
@@ -5385,12 +5502,27 @@ void MainWindow::initSignalSlots() {
     connect ( activeGraph, &Graph::signalProgressBoxKill,
               this, &MainWindow::slotProgressBoxDestroy);
 
+    connect ( activeGraph, &Graph::signalProgressBoxRate,
+              this, &MainWindow::slotProgressBoxRate);
+
+    connect ( activeGraph, &Graph::signalBackgroundAnalysisFinished,
+              this, &MainWindow::slotAnalyzeBackgroundFinished);
+
     connect ( activeGraph, &Graph::signalPromininenceDistributionChartUpdate,
               this, &MainWindow::slotAnalyzeProminenceDistributionChartUpdate);
 
     connect ( activeGraph, &Graph::signalNetworkManagerRequest,
               this, &MainWindow::slotNetworkManagerRequest);
 
+    connect ( activeGraph, &Graph::signalNetworkManagerAbort,
+              this, &MainWindow::slotNetworkManagerAbort);
+
+    connect ( this, &MainWindow::signalNetworkCrawlerData,
+              activeGraph, &Graph::webCrawlData);
+
+    connect ( this, &MainWindow::signalNetworkCrawlerReply,
+              activeGraph, &Graph::slotHandleCrawlerRequestReply);
+
 
 
 
@@ -5422,6 +5554,15 @@ void MainWindow::initSignalSlots() {
     connect( activeGraph, SIGNAL( setNodePos(const int &, const qreal &, const qreal &) ),
              graphicsWidget, SLOT( moveNode(const int &, const qreal &, const qreal &) ) ) ;
 
+    connect( activeGraph, &Graph::signalNodePositions,
+             graphicsWidget, &GraphicsWidget::moveNodes );
+
+    connect( activeGraph, &Graph::signalSceneBuildBegin,
+             graphicsWidget, &GraphicsWidget::sceneBuildBegin );
+
+    connect( activeGraph, &Graph::signalSceneBuildEnd,
+             graphicsWidget, &GraphicsWidget::sceneBuildEnd );
+
     connect( activeGraph,&Graph::signalNodesFound,
              graphicsWidget,  &GraphicsWidget::setNodesMarked  );
 
@@ -5535,6 +5676,9 @@ void MainWindow::initSignalSlots() {
     connect( activeGraph, SIGNAL( setEdgeVisibility (int, int, int, bool) ),
              graphicsWidget, SLOT(  setEdgeVisibility (int, int, int, bool) ) );
 
+    connect( activeGraph, &Graph::setEdgesVisibility,
+             graphicsWidget, &GraphicsWidget::setEdgesVisibility );
+
 
     connect( graphicsWidget, &GraphicsWidget::userClickedNode,
              activeGraph, &Graph::vertexClickedSet );
@@ -5676,9 +5820,54 @@ void MainWindow::initApp(){
     activeGraph->setReportsLabelLength(appSettings["initReportsLabelsLength"].toInt());
     activeGraph->setReportsChartType(appSettings["initReportsChartType"].toInt());
 
+    activeGraph->setDistancesStorageCompact(
+                (appSettings["distancesStorageCompact"] == "true") ? true:false
+                                                                     );
+
+    activeGraph->setDistancesIncremental(
+                (appSettings["distancesIncremental"] == "true") ? true:false,
+                (appSettings["distancesIncrementalCentralities"] == "true") ? true:false
+                                                                     );
+
+    activeGraph->setCentralityBetweennessSamples(
+                appSettings["centralityBetweennessSamples"].toInt());
+
+    activeGraph->setPrestigePageRankGaussSeidel(
+                (appSettings["prestigePageRankGaussSeidel"] == "true") ? true:false
+                                                                         );
+
+    activeGraph->setCentralityEigenvectorTolerance(
+                appSettings["centralityEigenvectorTolerance"].toDouble());
+
+    activeGraph->setCentralityEigenvectorMaxIterations(
+                appSettings["centralityEigenvectorMaxIterations"].toInt());
+
+    activeGraph->setCentralityEigenvectorLanczos(
+                (appSettings["centralityEigenvectorLanczos"] == "true") ? true:false
+                                                                          );
+
+    activeGraph->setGraphMatrixAdjacencySparseDensity(
+                appSettings["graphMatrixAdjacencySparseDensity"].toDouble());
+
+    activeGraph->setReportsResultStore(
+                (appSettings["reportsResultStore"] == "true") ? true:false
+                                                                );
+
+    activeGraph->setRandomSeed( appSettings["randomSeed"].toULongLong() );
+
+    activeGraph->setLayoutForceDirectedTheta(
+                appSettings["layoutForceDirectedTheta"].toDouble());
+
+    activeGraph->setLayoutFrameRate( appSettings["layoutFrameRate"].toInt() );
+
+    activeGraph->setLayoutAnimateMaxVertices(
+                appSettings["layoutAnimateMaxVertices"].toInt() );
+
     emit signalSetReportsDataDir(appSettings["dataDir"]);
 
     /** Clear graphicsWidget and reset settings and transformations **/
+    graphicsWidget->setEdgeLayer( appSettings["canvasEdgeLayer"] == "true" );
+    graphicsWidget->setNodeLayer( appSettings["canvasNodeLayer"] == "true" );
     graphicsWidget->clear();
     rotateSlider->setValue(0);
     zoomSlider->setValue(250);
@@ -6469,43 +6658,47 @@ void MainWindow::slotNetworkFileChoose(QString m_fileName,
         // prepare supported filetype extensions
         switch (fileType){
         case FileType::GRAPHML:
-            fileType_filter = tr("GraphML (*.graphml *.xml);;All (*)");
+            fileType_filter = tr("GraphML (*.graphml *.xml *.graphml.gz *.xml.gz *.graphml.zst *.xml.zst);;All (*)");
             break;
         case FileType::PAJEK:
-            fileType_filter = tr("Pajek (*.net *.paj *.pajek);;All (*)");
+            fileType_filter = tr("Pajek (*.net *.paj *.pajek *.net.gz *.paj.gz *.pajek.gz *.net.zst *.paj.zst *.pajek.zst);;All (*)");
             break;
         case FileType::ADJACENCY:
-            fileType_filter = tr("Adjacency (*.csv *.sm *.adj *.txt);;All (*)");
+            fileType_filter = tr("Adjacency (*.csv *.sm *.adj *.txt *.csv.gz *.sm.gz *.adj.gz *.txt.gz *.csv.zst *.sm.zst *.adj.zst *.txt.zst);;All (*)");
             break;
         case FileType::GRAPHVIZ:
-            fileType_filter = tr("GraphViz (*.dot);;All (*)");
+            fileType_filter = tr("GraphViz (*.dot *.dot.gz *.dot.zst);;All (*)");
             break;
         case FileType::UCINET:
-            fileType_filter = tr("UCINET (*.dl *.dat);;All (*)");
+            fileType_filter = tr("UCINET (*.dl *.dat *.dl.gz *.dat.gz *.dl.zst *.dat.zst);;All (*)");
             break;
         case FileType::GML:
-            fileType_filter = tr("GML (*.gml);;All (*)");
+            fileType_filter = tr("GML (*.gml *.gml.gz *.gml.zst);;All (*)");
             break;
 
         case FileType::EDGELIST_WEIGHTED:
-            fileType_filter = tr("Weighted Edge List (*.txt *.list *.edgelist *.lst *.wlst);;All (*)");
+            fileType_filter = tr("Weighted Edge List (*.txt *.list *.edgelist *.lst *.wlst *.txt.gz *.list.gz *.edgelist.gz *.lst.gz *.wlst.gz *.txt.zst *.list.zst *.edgelist.zst *.lst.zst *.wlst.zst);;All (*)");
             break;
         case FileType::EDGELIST_SIMPLE:
-            fileType_filter = tr("Simple Edge List (*.txt *.list *.edgelist *.lst);;All (*)");
+            fileType_filter = tr("Simple Edge List (*.txt *.list *.edgelist *.lst *.txt.gz *.list.gz *.edgelist.gz *.lst.gz *.txt.zst *.list.zst *.edgelist.zst *.lst.zst);;All (*)");
             break;
         case FileType::TWOMODE:
-            fileType_filter = tr("Two-Mode Sociomatrix (*.2sm *.aff);;All (*)");
+            fileType_filter = tr("Two-Mode Sociomatrix (*.2sm *.aff *.2sm.gz *.aff.gz *.2sm.zst *.aff.zst);;All (*)");
+            break;
+        case FileType::BINARY:
+            fileType_filter = tr("SocNetV Binary Snapshot (*.snb);;All (*)");
             break;
         default:	//All
-            fileType_filter = tr("GraphML (*.graphml *.xml);;"
-                                 "GML (*.gml *.xml);;"
-                                 "Pajek (*.net *.pajek *.paj);;"
-                                 "UCINET (*.dl *.dat);;"
-                                 "Adjacency (*.csv *.adj *.sm *.txt);;"
-                                 "GraphViz (*.dot);;"
-                                 "Weighted Edge List (*.txt *.edgelist *.list *.lst *.wlst);;"
-                                 "Simple Edge List (*.txt *.edgelist *.list *.lst);;"
-                                 "Two-Mode Sociomatrix (*.2sm *.aff);;"
+            fileType_filter = tr("GraphML (*.graphml *.xml *.graphml.gz *.xml.gz *.graphml.zst *.xml.zst);;"
+                                 "GML (*.gml *.xml *.gml.gz *.xml.gz *.gml.zst *.xml.zst);;"
+                                 "Pajek (*.net *.pajek *.paj *.net.gz *.pajek.gz *.paj.gz *.net.zst *.pajek.zst *.paj.zst);;"
+                                 "UCINET (*.dl *.dat *.dl.gz *.dat.gz *.dl.zst *.dat.zst);;"
+                                 "Adjacency (*.csv *.adj *.sm *.txt *.csv.gz *.adj.gz *.sm.gz *.txt.gz *.csv.zst *.adj.zst *.sm.zst *.txt.zst);;"
+                                 "GraphViz (*.dot *.dot.gz *.dot.zst);;"
+                                 "Weighted Edge List (*.txt *.edgelist *.list *.lst *.wlst *.txt.gz *.edgelist.gz *.list.gz *.lst.gz *.wlst.gz *.txt.zst *.edgelist.zst *.list.zst *.lst.zst *.wlst.zst);;"
+                                 "Simple Edge List (*.txt *.edgelist *.list *.lst *.txt.gz *.edgelist.gz *.list.gz *.lst.gz *.txt.zst *.edgelist.zst *.list.zst *.lst.zst);;"
+                                 "Two-Mode Sociomatrix (*.2sm *.aff *.2sm.gz *.aff.gz *.2sm.zst *.aff.zst);;"
+                                 "SocNetV Binary Snapshot (*.snb);;"
                                  "All (*)");
             break;
 
@@ -6558,20 +6751,24 @@ void MainWindow::slotNetworkFileChoose(QString m_fileName,
      */
     if (checkSelectFileType || m_fileFormat==FileType::UNRECOGNIZED) {
 
+        // Compressed files, i.e. net.graphml.gz, are typed by the inner extension
+        const QString typeFileName = CompressedFile::fileNameWithoutCompression(m_fileName);
+
         // This happens only on application startup or on loading a recent file.
-        if ( ! m_fileName.endsWith(".graphml",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".net",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".paj",Qt::CaseInsensitive )  &&
-             ! m_fileName.endsWith(".pajek",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".dl",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".dat",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".gml",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".wlst",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".wlist",Qt::CaseInsensitive )&&
-             ! m_fileName.endsWith(".2sm",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".sm",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".csv",Qt::CaseInsensitive ) &&
-             ! m_fileName.endsWith(".aff",Qt::CaseInsensitive ))
+        if ( ! typeFileName.endsWith(".graphml",Qt::CaseInsensitive ) &&
+             ! typeFileName.endsWith(".net",Qt::CaseInsensitive ) &&
+             ! typeFileName.endsWith(".paj",Qt::CaseInsensitive )  &&
+             ! typeFileName.endsWith(".pajek",Qt::CaseInsensitive ) &&
+             ! typeFileName.endsWith(".dl",Qt::CaseInsensitive ) &&
+             ! typeFileName.endsWith(".dat",Qt::CaseInsensitive ) &&
+             ! typeFileName.endsWith(".gml",Qt::CaseInsensitive ) &&
+             ! typeFileName.endsWith(".wlst",Qt::CaseInsensitive ) &&
+             ! typeFileName.endsWith(".wlist",Qt::CaseInsensitive )&&
+             ! typeFileName.endsWith(".2sm",Qt::CaseInsensitive ) &&
+             ! typeFileName.endsWith(".sm",Qt::CaseInsensitive ) &&
+             ! typeFileName.endsWith(".csv",Qt::CaseInsensitive ) &&
+             ! typeFileName.endsWith(".aff",Qt::CaseInsensitive ) &&
+             ! typeFileName.endsWith(".snb",Qt::CaseInsensitive ))
         {
             //ambigious file type. Open an input dialog for the user to choose
             // what kind of network file this is.
@@ -6654,43 +6851,46 @@ void MainWindow::slotNetworkFileChoose(QString m_fileName,
 
         }
 
-        else if (m_fileName.endsWith(".graphml",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".xml",Qt::CaseInsensitive ) ) {
+        else if (typeFileName.endsWith(".graphml",Qt::CaseInsensitive ) ||
+                 typeFileName.endsWith(".xml",Qt::CaseInsensitive ) ) {
             m_fileFormat=FileType::GRAPHML;
         }
-        else if (m_fileName.endsWith(".net",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".paj",Qt::CaseInsensitive )  ||
-                 m_fileName.endsWith(".pajek",Qt::CaseInsensitive ) ) {
+        else if (typeFileName.endsWith(".net",Qt::CaseInsensitive ) ||
+                 typeFileName.endsWith(".paj",Qt::CaseInsensitive )  ||
+                 typeFileName.endsWith(".pajek",Qt::CaseInsensitive ) ) {
             m_fileFormat=FileType::PAJEK;
         }
-        else if (m_fileName.endsWith(".dl",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".dat",Qt::CaseInsensitive ) ) {
+        else if (typeFileName.endsWith(".dl",Qt::CaseInsensitive ) ||
+                 typeFileName.endsWith(".dat",Qt::CaseInsensitive ) ) {
             m_fileFormat=FileType::UCINET;
         }
-        else if (m_fileName.endsWith(".sm",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".csv",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".adj",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".txt",Qt::CaseInsensitive )) {
+        else if (typeFileName.endsWith(".sm",Qt::CaseInsensitive ) ||
+                 typeFileName.endsWith(".csv",Qt::CaseInsensitive ) ||
+                 typeFileName.endsWith(".adj",Qt::CaseInsensitive ) ||
+                 typeFileName.endsWith(".txt",Qt::CaseInsensitive )) {
             m_fileFormat=FileType::ADJACENCY;
         }
-        else if (m_fileName.endsWith(".dot",Qt::CaseInsensitive ) ) {
+        else if (typeFileName.endsWith(".dot",Qt::CaseInsensitive ) ) {
             m_fileFormat=FileType::GRAPHVIZ;
         }
-        else if (m_fileName.endsWith(".gml",Qt::CaseInsensitive ) ) {
+        else if (typeFileName.endsWith(".gml",Qt::CaseInsensitive ) ) {
             m_fileFormat=FileType::GML;
         }
-        else if (m_fileName.endsWith(".list",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".lst",Qt::CaseInsensitive )  ) {
+        else if (typeFileName.endsWith(".list",Qt::CaseInsensitive ) ||
+                 typeFileName.endsWith(".lst",Qt::CaseInsensitive )  ) {
             m_fileFormat=FileType::EDGELIST_SIMPLE;
         }
-        else if (m_fileName.endsWith(".wlist",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".wlst",Qt::CaseInsensitive )  ) {
+        else if (typeFileName.endsWith(".wlist",Qt::CaseInsensitive ) ||
+                 typeFileName.endsWith(".wlst",Qt::CaseInsensitive )  ) {
             m_fileFormat=FileType::EDGELIST_WEIGHTED;
         }
-        else if (m_fileName.endsWith(".2sm",Qt::CaseInsensitive ) ||
-                 m_fileName.endsWith(".aff",Qt::CaseInsensitive )  ) {
+        else if (typeFileName.endsWith(".2sm",Qt::CaseInsensitive ) ||
+                 typeFileName.endsWith(".aff",Qt::CaseInsensitive )  ) {
             m_fileFormat=FileType::TWOMODE;
         }
+        else if (typeFileName.endsWith(".snb",Qt::CaseInsensitive ) ) {
+            m_fileFormat=FileType::BINARY;
+        }
         else
             m_fileFormat=FileType::UNRECOGNIZED;
     }
@@ -6724,6 +6924,10 @@ void MainWindow::slotNetworkFileDialogFilterSelected(const QString &filter) {
         fileType=FileType::GRAPHML;
         qDebug() << "MW::slotNetworkFileDialogFilterSelected() - fileType FileType::GRAPHML";
     }
+    else if (filter.contains("Binary Snapshot",Qt::CaseInsensitive ) ) {
+        fileType=FileType::BINARY;
+        qDebug() << "MW::slotNetworkFileDialogFilterSelected() - fileType FileType::BINARY";
+    }
     else if (filter.contains("PAJEK",Qt::CaseInsensitive ) ) {
         fileType=FileType::PAJEK;
         qDebug() << "MW::slotNetworkFileDialogFilterSelected() - fileType FileType::PAJEK";
@@ -6873,10 +7077,16 @@ void MainWindow::slotNetworkSaveAs() {
     QString fn =  QFileDialog::getSaveFileName(
                 this,
                 tr("Save Network to GraphML File Named..."),
-                getLastPath(), tr("GraphML (*.graphml *.xml);;All (*)") );
+                getLastPath(), tr("GraphML (*.graphml *.xml);;"
+                                  "Compressed GraphML (*.graphml.gz *.graphml.zst);;"
+                                  "All (*)") );
 
     if (!fn.isEmpty())  {
 
+        // Keep a .gz or .zst extension, to save compressed
+        const QString compressionSuffix = fn.mid( CompressedFile::fileNameWithoutCompression(fn).size() );
+        fn.chop( compressionSuffix.size() );
+
         if  ( QFileInfo(fn).suffix().isEmpty() ){
             fn.append(".graphml");
             slotHelpMessageToUser (
@@ -6900,6 +7110,7 @@ void MainWindow::slotNetworkSaveAs() {
                         );
 
         }
+        fn.append(compressionSuffix);
         fileName=fn;
         QFileInfo fileInfo (fileName);
         fileNameNoPath = fileInfo.fileName();
@@ -7112,6 +7323,16 @@ void MainWindow::slotNetworkImportTwoModeSM(){
 
 
 
+/**
+ * @brief Opens a SocNetV binary snapshot file
+ */
+void MainWindow::slotNetworkImportBinary(){
+    bool m_checkSelectFileType = false;
+    slotNetworkFileChoose( QString(), FileType::BINARY, m_checkSelectFileType);
+}
+
+
+
 /**
  * @brief Setup a list of all text codecs supported by OS
  */
@@ -7159,9 +7380,17 @@ bool MainWindow::slotNetworkFilePreview(const QString &m_fileName,
                                         const int &m_fileFormat ){
     qDebug() << "MW::slotNetworkFilePreview() - file: "<< m_fileName;
 
+    if ( m_fileFormat == FileType::BINARY ) {
+        // Binary snapshots have no text to preview or codec to choose.
+        if (!m_fileName.isEmpty()) {
+            slotNetworkFileLoad(m_fileName, "UTF-8", m_fileFormat);
+        }
+        return true;
+    }
+
     if (!m_fileName.isEmpty()) {
         QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
-        QFile file(m_fileName);
+        CompressedFile file(m_fileName);
         if (!file.open(QFile::ReadOnly)) {
             slotHelpMessageToUserError(
                         tr("Cannot read file %1:\n%2")
@@ -7381,6 +7610,9 @@ void MainWindow::slotNetworkFileLoaded (const int &type,
     case 9:
         statusMessage( tr("Two-mode affiliation network, named %1, loaded with %2 Nodes and %3 total Edges.").arg( netName ).arg( totalNodes ).arg(totalEdges ) );
         break;
+    case 10:
+        statusMessage( tr("Binary snapshot of network named %1, loaded with %2 Nodes and %3 total Edges.").arg( netName ).arg( totalNodes ).arg(totalEdges ) );
+        break;
 
     default: // just for sanity
         QMessageBox::critical(this, "Error","Unrecognized format. \nPlease specify"
@@ -7846,7 +8078,9 @@ void MainWindow::slotNetworkExportPajek()
     QString fn =  QFileDialog::getSaveFileName(
                 this,
                 tr("Export Network to File Named..."),
-                getLastPath(), tr("Pajek (*.paj *.net *.pajek);;All (*)") );
+                getLastPath(), tr("Pajek (*.paj *.net *.pajek);;"
+                                  "Compressed Pajek (*.paj.gz *.net.gz *.paj.zst *.net.zst);;"
+                                  "All (*)") );
     if (!fn.isEmpty())  {
         if  ( QFileInfo(fn).suffix().isEmpty() ){
             QMessageBox::information(this, "Missing Extension ",
@@ -7869,6 +8103,82 @@ void MainWindow::slotNetworkExportPajek()
 
 
 
+/**
+ * @brief Exports the network to a SocNetV binary snapshot file
+ * Calls the relevant Graph method.
+ */
+void MainWindow::slotNetworkExportBinary()
+{
+    qDebug () << "MW::slotNetworkExportBinary";
+
+    if ( !activeNodes() )  {
+        slotHelpMessageToUser(USER_MSG_CRITICAL_NO_NETWORK);
+        return;
+    }
+
+    statusMessage( tr("Saving a binary snapshot of the active network..."));
+    QString fn =  QFileDialog::getSaveFileName(
+                this,
+                tr("Save Binary Snapshot to File Named..."),
+                getLastPath(), tr("SocNetV Binary Snapshot (*.snb);;All (*)") );
+    if (!fn.isEmpty())  {
+        if  ( QFileInfo(fn).suffix().isEmpty() ){
+            QMessageBox::information(this, "Missing Extension ",
+                                     tr("File extension was missing! \n"
+                                        "Appending a standard .snb to the given filename."), "OK",0);
+            fn.append(".snb");
+        }
+        fileName=fn;
+        setLastPath(fileName);
+        QFileInfo fileInfo (fileName);
+        fileNameNoPath = fileInfo.fileName();
+    }
+    else  {
+        statusMessage( tr("Saving aborted"));
+        return;
+    }
+
+    activeGraph->graphSave(fileName, FileType::BINARY);
+}
+
+
+
+/**
+ * @brief Exports the vertex indices computed so far to a CSV/TSV file
+ * Calls the relevant Graph method.
+ */
+void MainWindow::slotNetworkExportIndices()
+{
+    qDebug () << "MW::slotNetworkExportIndices";
+
+    if ( !activeNodes() )  {
+        slotHelpMessageToUser(USER_MSG_CRITICAL_NO_NETWORK);
+        return;
+    }
+
+    statusMessage( tr("Exporting the vertex indices of the active network..."));
+    QString fn =  QFileDialog::getSaveFileName(
+                this,
+                tr("Export Vertex Indices to File Named..."),
+                getLastPath(), tr("Comma Separated Values (*.csv *.csv.gz *.csv.zst);;"
+                                  "Tab Separated Values (*.tsv *.tsv.gz *.tsv.zst);;All (*)") );
+    if (fn.isEmpty())  {
+        statusMessage( tr("Saving aborted"));
+        return;
+    }
+    if  ( QFileInfo(fn).suffix().isEmpty() ){
+        QMessageBox::information(this, "Missing Extension ",
+                                 tr("File extension was missing! \n"
+                                    "Appending a standard .csv to the given filename."), "OK",0);
+        fn.append(".csv");
+    }
+    setLastPath(fn);
+
+    activeGraph->writeVertexIndicesTable(fn);
+}
+
+
+
 /**
  * @brief Exports the network to a adjacency matrix-formatted file
  * Calls the relevant Graph method.
@@ -7883,7 +8193,8 @@ void MainWindow::slotNetworkExportSM(){
     QString fn =  QFileDialog::getSaveFileName(
                 this,
                 tr("Export Network to File Named..."),
-                getLastPath(), tr("Adjacency (*.adj *.sm *.txt *.csv *.net);;All (*)") );
+                getLastPath(), tr("Adjacency (*.adj *.sm *.txt *.csv *.net *.adj.gz *.sm.gz *.adj.zst *.sm.zst);;"
+                                 "Sparse Matrix Market (*.mtx *.mtx.gz *.mtx.zst);;All (*)") );
     if (!fn.isEmpty())  {
         if  ( QFileInfo(fn).suffix().isEmpty() ){
             QMessageBox::information(this, "Missing Extension ",
@@ -8727,7 +9038,9 @@ void MainWindow::slotNetworkWebCrawler (const QUrl &startUrl,
                                         const bool &extLinksIncluded,
                                         const bool &extLinksCrawl,
                                         const bool &socialLinks,
-                                        const bool &delayedRequests
+                                        const bool &delayedRequests,
+                                        const bool &checkpoints,
+                                        const bool &resume
                                         ) {
 
     // Close the current network
@@ -8750,7 +9063,9 @@ void MainWindow::slotNetworkWebCrawler (const QUrl &startUrl,
                 extLinksIncluded,
                 extLinksCrawl,
                 socialLinks,
-                delayedRequests) ;
+                delayedRequests,
+                checkpoints,
+                resume) ;
 
 }
 
@@ -8785,8 +9100,11 @@ void MainWindow::slotNetworkManagerRequest(const QUrl &url, const NetworkRequest
 
     switch (requestType) {
     case NetworkRequestType::Crawler:
-        // Wire the reply to the activeGraph, which in turn will pass it to the web crawler
-         connect(reply, &QNetworkReply::finished, activeGraph, &Graph::slotHandleCrawlerRequestReply);
+        // Pass the page bytes to the activeGraph as they arrive,
+        // which in turn will pass them to the web crawler
+        m_crawlerReplies.insert(url, reply);
+        connect(reply, &QNetworkReply::readyRead, this, &MainWindow::slotNetworkCrawlerReadyRead);
+        connect(reply, &QNetworkReply::finished, this, &MainWindow::slotNetworkCrawlerFinished);
         break;
     default:
         break;
@@ -8807,6 +9125,60 @@ void MainWindow::slotNetworkManagerRequest(const QUrl &url, const NetworkRequest
 
 
 
+/**
+ * @brief Passes the new bytes of a page the web crawler downloads to the
+ * activeGraph, while the download goes on. The body of redirects is skipped.
+ */
+void MainWindow::slotNetworkCrawlerReadyRead() {
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if ( !reply ||
+         !reply->header(QNetworkRequest::LocationHeader).toString().isEmpty() ) {
+        return;
+    }
+    emit signalNetworkCrawlerData( reply->request().url(), reply->readAll() );
+}
+
+
+
+/**
+ * @brief Passes a finished reply of the web crawler, with its Location header
+ * and its last bytes, to the activeGraph. Then deletes the reply.
+ */
+void MainWindow::slotNetworkCrawlerFinished() {
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if ( !reply ) {
+        return;
+    }
+    const QUrl url = reply->request().url();
+    const QString locationHeader = reply->header(QNetworkRequest::LocationHeader).toString();
+    m_crawlerReplies.remove(url);
+
+    qDebug() << "MW::slotNetworkCrawlerFinished() - url:" << url.toString()
+             << "error:" << reply->error();
+
+    emit signalNetworkCrawlerReply( url,
+                                    locationHeader,
+                                    locationHeader.isEmpty() ? reply->readAll() : QByteArray() );
+    reply->deleteLater();
+}
+
+
+
+/**
+ * @brief Aborts the download of a page the web crawler does not need anymore,
+ * i.e. because it has found maxLinksPerPage links in it.
+ * @param url
+ */
+void MainWindow::slotNetworkManagerAbort(const QUrl &url) {
+    QNetworkReply *reply = m_crawlerReplies.value(url, nullptr);
+    if ( reply ) {
+        qDebug() << "MW::slotNetworkManagerAbort() - url:" << url.toString();
+        reply->abort();
+    }
+}
+
+
+
 
 
 /**
@@ -8930,6 +9302,7 @@ void MainWindow::slotEditOpenContextMenu( const QPointF &mPos) {
             contextMenu->addAction(editNodeSelectedToStarAct);
             contextMenu->addAction(editNodeSelectedToCycleAct);
             contextMenu->addAction(editNodeSelectedToLineAct);
+            contextMenu->addAction(editNodeSelectedToInducedAct);
 
         }
         else {
@@ -9126,12 +9499,8 @@ void MainWindow::slotEditNodeRemove() {
     int nodesSelected = activeGraph->graphSelectedVerticesCount();
     if ( nodesSelected > 0) {
         QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
-        int removeCounter = 0;
         qDebug() << "MW::slotEditNodeRemove() multiple selected to remove";
-        foreach (int nodeNumber, activeGraph->graphSelectedVertices() ) {
-            activeGraph->vertexRemove(nodeNumber);
-            ++removeCounter ;
-        }
+        activeGraph->vertexRemoveList( activeGraph->graphSelectedVertices() );
         editNodeRemoveAct->setText(tr("Remove Node"));
         statusMessage( tr("Removed ") + nodesSelected + tr(" nodes. Ready. ") );
         QApplication::restoreOverrideCursor();
@@ -9504,6 +9873,40 @@ void MainWindow::slotEditNodeSelectedToLine() {
 
 
 
+/**
+ * @brief Copies the subgraph induced by the selected nodes to a new relation.
+ * Calls Graph::verticesCreateSubgraph()
+ */
+void MainWindow::slotEditNodeSelectedToInduced() {
+    qDebug() << "MW::slotEditNodeSelectedToInduced()";
+    if ( !activeNodes() )  {
+        slotHelpMessageToUser(USER_MSG_CRITICAL_NO_NETWORK);
+        return;
+    }
+
+    int selectedNodesCount = activeGraph->graphSelectedVerticesCount();
+
+    if ( selectedNodesCount < 2 ) {
+        slotHelpMessageToUser(USER_MSG_INFO,tr("Not enough nodes selected."),
+                              tr("Cannot copy the induced subgraph because you have "
+                                 "not selected enough nodes."),
+                              tr("Select at least two nodes first.")
+                              );
+        return;
+    }
+
+    activeGraph->verticesCreateSubgraph(QList<int> (), SUBGRAPH_INDUCED);
+
+    slotHelpMessageToUser(USER_MSG_INFO,tr("Induced subgraph copied."),
+                          tr("The subgraph induced by ")
+                          + QString::number( selectedNodesCount )
+                          + tr(" selected nodes has been copied to a new relation.")
+                          );
+
+}
+
+
+
 /**
  * @brief Changes the color of all nodes to parameter color
  * Calls  activeGraph->vertexColorSet to do the work
@@ -9872,6 +10275,8 @@ void MainWindow::slotEditNodeOpenContextMenu() {
 
     nodeContextMenu->addAction(editNodePropertiesAct );
 
+    nodeContextMenu->addAction(editNodeSelectEgoNetworkAct );
+
     nodeContextMenu->addSeparator();
 
     nodeContextMenu->addAction(editEdgeAddAct);
@@ -9892,6 +10297,34 @@ void MainWindow::slotEditNodeOpenContextMenu() {
 
 
 
+/**
+ * @brief Asks for a number of hops and selects the ego network of the
+ * clicked node within them.
+ * Calls Graph::vertexEgoNetworkSelect()
+ */
+void MainWindow::slotEditNodeSelectEgoNetwork() {
+    qDebug() << "MW::slotEditNodeSelectEgoNetwork()";
+    if ( !activeNodes() )  {
+        slotHelpMessageToUser(USER_MSG_CRITICAL_NO_NETWORK);
+        return;
+    }
+    int v1 = activeGraph->vertexClicked();
+    bool ok=false;
+    int hops = QInputDialog::getInt(
+                this,
+                tr("Select ego network"),
+                tr("Select the nodes within how many hops from node %1?")
+                .arg(v1), 1, 1, 20, 1, &ok );
+    if (!ok) {
+        statusMessage( tr("Select ego network cancelled.") );
+        return;
+    }
+    activeGraph->vertexEgoNetworkSelect(v1, hops);
+}
+
+
+
+
 /**
  * @brief Called from Graph when the user-selected nodes/edges has changed
  * @param nodes
@@ -9922,6 +10355,10 @@ void MainWindow::slotEditSelectionChanged(const int &selNodes, const int &selEdg
         editNodeSelectedToLineAct->setText(tr("Create a line from ")
                                            + QString::number(selNodes)
                                            + tr(" selected nodes"));
+        editNodeSelectedToInducedAct->setEnabled(true);
+        editNodeSelectedToInducedAct->setText(tr("Copy the subgraph induced by ")
+                                              + QString::number(selNodes)
+                                              + tr(" selected nodes"));
     }
     else {
         editNodeRemoveAct->setText(tr("Remove Node"));
@@ -9933,6 +10370,8 @@ void MainWindow::slotEditSelectionChanged(const int &selNodes, const int &selEdg
         editNodeSelectedToCycleAct->setEnabled(false);
         editNodeSelectedToLineAct->setText(tr("Create a line from selected nodes"));
         editNodeSelectedToLineAct->setEnabled(false);
+        editNodeSelectedToInducedAct->setText(tr("Copy the subgraph induced by selected nodes"));
+        editNodeSelectedToInducedAct->setEnabled(false);
 
     }
 
@@ -11035,7 +11474,16 @@ void MainWindow::slotLayoutSpringEmbedder(){
         return;
     }
 
-    activeGraph->layoutForceDirectedSpringEmbedder(500);
+    if ( appSettings["layoutForceDirectedMultilevel"] == "true" ) {
+        activeGraph->layoutForceDirectedMultilevel("Eades", 500);
+    }
+    else {
+        activeGraph->layoutForceDirectedSpringEmbedder(500);
+    }
+
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
 
     statusMessage( tr("Spring-Gravitational (Eades) model embedded.") );
 }
@@ -11056,7 +11504,16 @@ void MainWindow::slotLayoutFruchterman(){
         return;
     }
 
-    activeGraph->layoutForceDirectedFruchtermanReingold(100);
+    if ( appSettings["layoutForceDirectedMultilevel"] == "true" ) {
+        activeGraph->layoutForceDirectedMultilevel("FR", 100);
+    }
+    else {
+        activeGraph->layoutForceDirectedFruchtermanReingold(100);
+    }
+
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
 
     statusMessage( tr("Fruchterman & Reingold model embedded.") );
 }
@@ -11076,7 +11533,18 @@ void MainWindow::slotLayoutKamadaKawai(){
         return;
     }
 
-    activeGraph->layoutForceDirectedKamadaKawai(400);
+    if ( appSettings["layoutKamadaKawaiStress"] == "true" ) {
+        activeGraph->layoutForceDirectedStressMajorization(
+                    400, false, false, "current",
+                    appSettings["layoutKamadaKawaiStressPivots"].toInt() );
+    }
+    else {
+        activeGraph->layoutForceDirectedKamadaKawai(400);
+    }
+
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
 
     statusMessage( tr("Kamada & Kawai model embedded.") );
 }
@@ -11987,6 +12455,10 @@ void MainWindow::slotAnalyzeDiameter() {
                 optionsEdgeWeightConsiderAct->isChecked(),
                 inverseWeights);
 
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
+
     if ( activeGraph->graphIsWeighted() ) {
         if (optionsEdgeWeightConsiderAct->isChecked()) {
             QMessageBox::information(this, "Diameter",
@@ -12037,6 +12509,10 @@ void MainWindow::slotAnalyzeDistanceAverage() {
                 inverseWeights,
                 editFilterNodesIsolatesAct->isChecked() );
 
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
+
     bool isConnected = activeGraph->graphIsConnected();
 
     if ( isConnected ) {
@@ -12084,6 +12560,10 @@ void MainWindow::slotAnalyzeEccentricity(){
                 inverseWeights,
                 editFilterNodesIsolatesAct->isChecked());
 
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
+
     if ( appSettings["viewReportsInSystemBrowser"] == "true" ) {
         QDesktopServices::openUrl(QUrl::fromLocalFile(fn));
     }
@@ -12381,6 +12861,10 @@ void MainWindow::slotAnalyzeCommunitiesTriadCensus() {
 
     activeGraph->writeTriadCensus(fn, considerWeights);
 
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
+
     if ( appSettings["viewReportsInSystemBrowser"] == "true" ) {
         QDesktopServices::openUrl(QUrl::fromLocalFile(fn));
     }
@@ -12753,6 +13237,10 @@ void MainWindow::slotAnalyzeCentralityCloseness(){
                 inverseWeights,
                 editFilterNodesIsolatesAct->isChecked() || dropIsolates);
 
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
+
     statusMessage(tr("Opening Closeness Centralities report..."));
 
     if ( appSettings["viewReportsInSystemBrowser"] == "true" ) {
@@ -12792,6 +13280,10 @@ void MainWindow::slotAnalyzeCentralityClosenessIR(){
                 inverseWeights,
                 editFilterNodesIsolatesAct->isChecked());
 
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
+
     statusMessage(tr("Opening Influence Range Closeness Centralities report..."));
 
     if ( appSettings["viewReportsInSystemBrowser"] == "true" ) {
@@ -12823,11 +13315,27 @@ void MainWindow::slotAnalyzeCentralityBetweenness(){
 
     askAboutWeights();
 
+    // On request, the scores are computed on a snapshot of the network,
+    // while the user keeps working. The report opens when they are ready.
+    if ( appSettings["analysisBackground"] == "true"
+         && activeGraph->centralityBetweennessBackground(
+             optionsEdgeWeightConsiderAct->isChecked(),
+             inverseWeights,
+             editFilterNodesIsolatesAct->isChecked()) ) {
+        statusMessage(tr("Computing Betweenness Centralities in the background. "
+                         "The report will open when they are ready."));
+        return;
+    }
+
     activeGraph->writeCentralityBetweenness(
                 fn, optionsEdgeWeightConsiderAct->isChecked(),
                 inverseWeights,
                 editFilterNodesIsolatesAct->isChecked());
 
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
+
     statusMessage(tr("Opening Betweenness Centralities report..."));
 
     if ( appSettings["viewReportsInSystemBrowser"] == "true" ) {
@@ -12844,6 +13352,28 @@ void MainWindow::slotAnalyzeCentralityBetweenness(){
 
 
 
+/**
+ * @brief Called when a background analysis of the network has finished.
+ * If the network has not changed meanwhile, it writes and displays the
+ * report, from the results just computed.
+ * @param index the prominence index computed
+ * @param current false if the network changed and the results were dropped
+ */
+void MainWindow::slotAnalyzeBackgroundFinished(const int &index, const bool &current) {
+    qDebug() << "MW::slotAnalyzeBackgroundFinished() - index" << index
+             << "current" << current;
+    if ( ! current ) {
+        statusMessage(tr("The network changed during the background analysis. "
+                         "Run it again to get up-to-date results."));
+        return;
+    }
+    if ( index == IndexType::BC ) {
+        slotAnalyzeCentralityBetweenness();
+    }
+}
+
+
+
 
 
 /**
@@ -12940,6 +13470,10 @@ void MainWindow::slotAnalyzePrestigeProximity(){
     activeGraph->writePrestigeProximity(fn, true, false ,
                                         editFilterNodesIsolatesAct->isChecked());
 
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
+
     statusMessage(tr("Opening Proximity Prestige report..."));
 
     if ( appSettings["viewReportsInSystemBrowser"] == "true" ) {
@@ -13087,6 +13621,10 @@ void MainWindow::slotAnalyzeCentralityStress(){
                 inverseWeights,
                 editFilterNodesIsolatesAct->isChecked());
 
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
+
     statusMessage(tr("Opening Stress Centralities report..."));
 
     if ( appSettings["viewReportsInSystemBrowser"] == "true" ) {
@@ -13126,6 +13664,10 @@ void MainWindow::slotAnalyzeCentralityPower(){
                 inverseWeights,
                 editFilterNodesIsolatesAct->isChecked());
 
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
+
     statusMessage(tr("Opening Gil-Schmidt Power Centralities report..."));
     if ( appSettings["viewReportsInSystemBrowser"] == "true" ) {
         QDesktopServices::openUrl(QUrl::fromLocalFile(fn));
@@ -13163,6 +13705,10 @@ void MainWindow::slotAnalyzeCentralityEccentricity(){
                 inverseWeights,
                 editFilterNodesIsolatesAct->isChecked());
 
+    if ( activeGraph->graphCancelled() ) {
+        return;
+    }
+
     statusMessage(tr("Opening Closeness Centralities report..."));
 
     if ( appSettings["viewReportsInSystemBrowser"] == "true" ) {
@@ -13224,21 +13770,6 @@ void MainWindow::slotAnalyzeProminenceDistributionChartUpdate(QAbstractSeries *s
     }
 
 
-    // Clear miniChart from old series.
-    miniChart->removeAllSeries();
-
-    // Remove all axes
-    miniChart->removeAllAxes();
-
-    // Add series to miniChart
-    miniChart->addSeries(series);
-
-    // Set Chart title and remove legend
-    miniChart->setTitle(series->name() + QString(" distribution"), QFont("Times",8));
-
-    miniChart->toggleLegend(false);
-
-
     QString chartHelpMsg = tr("Distribution of %1 values:\n"
                               "Min value: %2 \n"
                               "Max value: %3 \n"
@@ -13257,6 +13788,40 @@ void MainWindow::slotAnalyzeProminenceDistributionChartUpdate(QAbstractSeries *s
 
     miniChart->setWhatsThis( chartHelpMsg );
 
+    // Update the line or area series already shown in place, if any,
+    // instead of rebuilding the miniChart
+    if ( miniChart->replaceSeries(series) ) {
+        qDebug() << "MW::slotAnalyzeProminenceDistributionChartUpdate() - "
+                    "updated miniChart series in place";
+        miniChart->setTitle(series->name() + QString(" distribution"), QFont("Times",8));
+        miniChart->setAxisXRange(0, max);
+        miniChart->setAxisYRange(0, maxF+1.0);
+        series->deleteLater();
+        if ( axisX != Q_NULLPTR ) {
+            axisX->deleteLater();
+        }
+        if ( axisY != Q_NULLPTR ) {
+            axisY->deleteLater();
+        }
+        return;
+    }
+
+    // Clear miniChart from old series.
+    miniChart->removeAllSeries();
+
+    // Remove all axes
+    miniChart->removeAllAxes();
+
+    // Add series to miniChart
+    miniChart->addSeries(series);
+
+    // Set Chart title and remove legend
+    miniChart->setTitle(series->name() + QString(" distribution"), QFont("Times",8));
+
+    miniChart->toggleLegend(false);
+
+
+
     // if true, then bar chart appears with default X axis (1,2,3 ...)
     bool useDefaultAxes = false;
 
@@ -13318,6 +13883,7 @@ void MainWindow::slotAnalyzeProminenceDistributionChartUpdate(QAbstractSeries *s
 /**
  * @brief Creates a Qt Progress Dialog
  * if max = 0, then max becomes equal to active vertices*
+ * Its Cancel button asks the running analysis to stop, see Graph::graphCancel()
  * @param max
  * @param msg
  */
@@ -13332,6 +13898,8 @@ void MainWindow::slotProgressBoxCreate(const int &max, const QString &msg){
                                                            duration,
                                                            this);
         polishProgressDialog(progressBox);
+        // slotProgressBoxRate() appends the time left to it
+        progressBox->setProperty("message", msg);
 
         progressBox->setWindowModality(Qt::WindowModal);
         progressBox->setWindowModality(Qt::ApplicationModal);
@@ -13339,6 +13907,10 @@ void MainWindow::slotProgressBoxCreate(const int &max, const QString &msg){
         connect ( activeGraph, &Graph::signalProgressBoxUpdate,
                   progressBox, &QProgressDialog::setValue );
 
+        // graphCancel() only sets a flag, which the running analysis polls
+        connect ( progressBox, &QProgressDialog::canceled,
+                  activeGraph, &Graph::graphCancel, Qt::DirectConnection );
+
         progressBox->setMinimumDuration(0);
         progressBox->setAutoClose(true);
         progressBox->setAutoReset(true);
@@ -13354,6 +13926,26 @@ void MainWindow::slotProgressBoxCreate(const int &max, const QString &msg){
 }
 
 
+/**
+ * @brief Shows the throughput and the estimated time left of the running
+ * computation in the last progress dialog.
+ * @param throughput steps per second
+ * @param eta msecs left, or -1 if unknown
+ */
+void MainWindow::slotProgressBoxRate(const qreal &throughput, const qint64 &eta){
+    if ( progressDialogs.isEmpty() || eta < 0 ) {
+        return;
+    }
+    QProgressDialog *progressBox = progressDialogs.top();
+    progressBox->setLabelText( progressBox->property("message").toString()
+                               + "\n"
+                               + tr("%1 steps per second, about %2 left")
+                               .arg( throughput, 0, 'f', 1 )
+                               .arg( QTime(0, 0).addMSecs( (int) qMin( eta, (qint64) 86399999 ) )
+                                     .toString("hh:mm:ss") ) );
+}
+
+
 /**
  * @brief Destroys the first in queue Progress dialog
  */
@@ -13997,6 +14589,19 @@ void MainWindow::slotOptionsProgressDialogVisibility(bool toggle) {
 
 
 
+/**
+ * @brief Sets the number of threads shared by the parallel analyses
+ * @param threads 0 for all CPU cores
+ */
+void MainWindow::slotOptionsAnalysisThreads(const int &threads) {
+    appSettings["analysisThreads"] = QString::number(threads);
+    GraphScheduler::setThreads(threads);
+    statusMessage( tr("Analyses will run on %1 threads.")
+                   .arg( GraphScheduler::threads() ) );
+}
+
+
+
 /**
  * @brief MainWindow::slotOptionsDebugMessages
  * @param toggle
@@ -14511,6 +15116,54 @@ void MainWindow::slotHelpSystemInfo() {
 
 
 
+/**
+ * @brief Writes the performance trace of this session to a report file and
+ * shows it. See GraphTrace.
+ */
+void MainWindow::slotHelpPerformanceTrace() {
+    qDebug () << "MW: slotHelpPerformanceTrace()";
+
+    QString dateTime=QDateTime::currentDateTime().toString ( QString ("yy-MM-dd-hhmmss"));
+    QString fn = appSettings["dataDir"] + "socnetv-report-performance-trace-"+dateTime+".txt";
+
+    QFile file( fn );
+    if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )  {
+        statusMessage( tr("Error. Could not write to ") + fn );
+        return;
+    }
+    QTextStream outText( &file );
+    outText.setCodec("UTF-8");
+    outText << tr("SocNetV %1 performance trace, %2")
+               .arg(VERSION)
+               .arg( QDateTime::currentDateTime().toString ( QString ("ddd, dd.MMM.yyyy hh:mm:ss")) )
+            << "\n\n"
+            << GraphTrace::report();
+    file.close();
+
+    TextEditor *ed = new TextEditor(fn,this,false);
+    ed->show();
+    m_textEditors << ed;
+    statusMessage(tr("Performance trace saved as ") + QDir::toNativeSeparators(fn));
+}
+
+
+/**
+ * @brief Shows the Analysis Profiler, with the runs recorded so far.
+ * See DialogProfiler.
+ */
+void MainWindow::slotHelpProfiler() {
+    qDebug () << "MW: slotHelpProfiler()";
+
+    if ( !m_dialogProfiler ) {
+        m_dialogProfiler = new DialogProfiler(appSettings["dataDir"], this);
+    }
+    m_dialogProfiler->refresh();
+    m_dialogProfiler->show();
+    m_dialogProfiler->raise();
+    m_dialogProfiler->activateWindow();
+}
+
+
 /**
     Displays the following message!!
 */
@@ -41,6 +41,8 @@
 #include <QMessageBox>
 #include <QStack>
 #include <QThread>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
 //#include <QMetaType>
 
 
@@ -119,6 +121,7 @@ class DialogExportImage;
 class DialogSettings;
 
 class DialogSystemInfo;
+class DialogProfiler;
 
 class TextEditor;
 
@@ -201,6 +204,7 @@ public slots:
     void slotNetworkImportUcinet();
     void slotNetworkImportEdgeList();
     void slotNetworkImportTwoModeSM();
+    void slotNetworkImportBinary();
 
     void slotNetworkChanged(const bool &directed,
                             const int &vertices, const int &edges,
@@ -228,6 +232,8 @@ public slots:
                               const QPrinter::PrinterMode printerMode,
                               const QPageSize &pageSize);
     void slotNetworkExportPajek();
+    void slotNetworkExportBinary();
+    void slotNetworkExportIndices();
     void slotNetworkExportSM();
     bool slotNetworkExportDL();
     bool slotNetworkExportGW();
@@ -291,9 +297,14 @@ public slots:
                                const bool &extLinksIncluded,
                                const bool &extLinksCrawl,
                                const bool &socialLinks,
-                               const bool &delayedRequests);
+                               const bool &delayedRequests,
+                               const bool &checkpoints,
+                               const bool &resume);
 
     void slotNetworkManagerRequest(const QUrl &url, const NetworkRequestType &requestType);
+    void slotNetworkManagerAbort(const QUrl &url);
+    void slotNetworkCrawlerReadyRead();
+    void slotNetworkCrawlerFinished();
 
 
     //EDIT MENU
@@ -337,6 +348,8 @@ public slots:
     void slotEditNodeSelectedToStar();
     void slotEditNodeSelectedToCycle();
     void slotEditNodeSelectedToLine();
+    void slotEditNodeSelectedToInduced();
+    void slotEditNodeSelectEgoNetwork();
     void slotEditNodeColorAll(QColor color=QColor());
     void slotEditNodeSizeAll(int newSize=0, const bool &normalized=false);
     void slotEditNodeShape(const int &vertex = 0,
@@ -432,6 +445,7 @@ public slots:
     void slotAnalyzeCentralityCloseness();
     void slotAnalyzeCentralityClosenessIR();
     void slotAnalyzeCentralityBetweenness();
+    void slotAnalyzeBackgroundFinished(const int &index, const bool &current);
     void slotAnalyzeCentralityInformation();
     void slotAnalyzeCentralityEigenvector();
     void slotAnalyzeCentralityStress();
@@ -498,6 +512,7 @@ public slots:
 
     void slotOptionsEmbedLogoExporting(bool toggle);
     void slotOptionsProgressDialogVisibility(bool toggle);
+    void slotOptionsAnalysisThreads(const int &threads);
 
     void slotOptionsWindowToolbarVisibility(bool toggle);
     void slotOptionsWindowStatusbarVisibility(bool toggle);
@@ -530,6 +545,8 @@ public slots:
     void slotHelpCheckUpdateParse();
     void slotHelpCreateTips();
     void slotHelpSystemInfo();
+    void slotHelpPerformanceTrace();
+    void slotHelpProfiler();
     void slotHelpAbout();
     void slotAboutQt();
     void slotHelpMessageToUserInfo(const QString text=QString());
@@ -567,6 +584,7 @@ public slots:
 
     void slotProgressBoxCreate(const int &max=0, const QString &msg="Please wait...");
     void slotProgressBoxDestroy(const int &max=0);
+    void slotProgressBoxRate(const qreal &throughput, const qint64 &eta);
 
 protected:
     void resizeEvent( QResizeEvent * );
@@ -577,10 +595,15 @@ protected:
 signals:
     void signalRelationAddAndChange(const QString &relName, const bool &changeRelation=true);
     void signalSetReportsDataDir(const QString &dataDir );
+    void signalNetworkCrawlerData(const QUrl &url, const QByteArray &data);
+    void signalNetworkCrawlerReply(const QUrl &url,
+                                   const QString &locationHeader,
+                                   const QByteArray &data);
 
 private:
 
     QNetworkAccessManager networkManager;
+    QHash<QUrl, QNetworkReply*> m_crawlerReplies;   // The web crawler downloads in progress
 
     QGraphicsScene *scene;
     GraphicsWidget *graphicsWidget;
@@ -621,6 +644,7 @@ private:
 
     DialogSettings *m_settingsDialog;
     DialogSystemInfo *m_systemInfoDialog;
+    DialogProfiler *m_dialogProfiler;
 
     DialogPreviewFile *m_dialogPreviewFile;
     QList<QTextCodec *> codecs;
@@ -667,9 +691,10 @@ private:
     *networkCloseAct, *networkPrintAct,*networkQuitAct;
     QAction *networkExportImageAct, *networkExportPNGAct, *networkExportPajek,
     *networkExportPDFAct, *networkExportDLAct, *networkExportGWAct, *networkExportSMAct,
-    *networkExportListAct;
+    *networkExportListAct, *networkExportBinaryAct, *networkExportIndicesAct;
     QAction *networkImportPajekAct, *networkImportGMLAct, *networkImportAdjAct, *networkImportListAct,
-    *networkImportGraphvizAct , *networkImportUcinetAct, *networkImportTwoModeSM;
+    *networkImportGraphvizAct , *networkImportUcinetAct, *networkImportTwoModeSM,
+    *networkImportBinaryAct;
     QAction *networkViewFileAct, *openTextEditorAct, *networkViewSociomatrixAct,
     *networkDataSetSelectAct, *networkViewSociomatrixPlotAct;
 
@@ -686,8 +711,10 @@ private:
     QAction *editNodeSelectNoneAct, *editNodeSelectAllAct;
     QAction *editNodeSelectedToStarAct, *editNodeSelectedToCycleAct;
     QAction *editNodeSelectedToLineAct, *editNodeSelectedToCliqueAct;
+    QAction *editNodeSelectedToInducedAct;
     QAction *editNodeFindAct,*editNodeAddAct, *editNodeRemoveAct;
     QAction *editNodePropertiesAct;
+    QAction *editNodeSelectEgoNetworkAct;
     QAction *editEdgeAddAct, *editEdgeRemoveAct;
     QAction *editNodeNumbersSizeAct, *editNodeLabelsSizeAct;
     QAction *editNodeSizeAllAct, *editNodeShapeAll;
@@ -711,7 +738,7 @@ private:
     QAction *openSettingsAct;
 
     QAction *helpAboutApp, *helpAboutQt, *helpApp, *tipsApp;
-    QAction *helpSystemInfoAct, *helpCheckUpdatesApp;
+    QAction *helpSystemInfoAct, *helpPerformanceTraceAct, *helpProfilerAct, *helpCheckUpdatesApp;
 
 
 
@@ -26,15 +26,84 @@
 ********************************************************************************/
 
 #include "matrix.h"
+#include "graphtrace.h"
 
 
 
 #define TINY 1.0e-20
 
 #include <cstdlib>		//allows the use of RAND_MAX macro
+#include <algorithm>
 #include <QDebug>
 #include <QtMath>		//needed for fabs, qFloor etc
 #include <QTextStream>
+#include <QVector>
+#include <QtConcurrent>
+#include <QtAlgorithms>     // qPopulationCount
+#include <functional>
+#include <vector>
+
+// Vector paths of the product and distance kernels, when the compiler targets them
+#if !defined(QT_COORD_TYPE) && defined(__AVX2__) && defined(__FMA__)
+#define SOCNETV_GEMM_AVX2
+#include <immintrin.h>
+#elif !defined(QT_COORD_TYPE) && defined(__aarch64__) && defined(__ARM_NEON)
+#define SOCNETV_GEMM_NEON
+#include <arm_neon.h>
+#endif
+
+// Optional BLAS/LAPACK backend, enabled by CONFIG+=socnetv_blas (see socnetv.pro).
+// The Fortran entry points are declared here instead of including a vendor
+// header, so the same code links against OpenBLAS, MKL, Accelerate or the
+// reference libraries. It needs qreal to be double.
+#if defined(SOCNETV_USE_BLAS) && !defined(QT_COORD_TYPE)
+#define SOCNETV_BLAS
+extern "C" {
+void dgemm_(const char *transa, const char *transb,
+            const int *m, const int *n, const int *k,
+            const double *alpha, const double *a, const int *lda,
+            const double *b, const int *ldb,
+            const double *beta, double *c, const int *ldc);
+void dgetrf_(const int *m, const int *n, double *a, const int *lda,
+             int *ipiv, int *info);
+void dgetri_(const int *n, double *a, const int *lda, const int *ipiv,
+             double *work, const int *lwork, int *info);
+void dgetrs_(const char *trans, const int *n, const int *nrhs,
+             const double *a, const int *lda, const int *ipiv,
+             double *b, const int *ldb, int *info);
+}
+#endif
+
+
+/*
+ * Storage: all elements live in one row-major buffer of m_rows * m_cols
+ * qreals, aligned to a cache line so that the rows handed to the product
+ * kernel start on vector boundaries. m_capacity is the size of the buffer,
+ * which is reused when the matrix is resized to the same or a smaller size.
+ */
+static const int MATRIX_ALIGNMENT = 64;
+
+
+static qreal *matrixAllocate(const int &elements) {
+    if (elements <= 0) {
+        return nullptr;
+    }
+    qreal *buffer = static_cast<qreal *>(
+                qMallocAligned( sizeof(qreal) * static_cast<size_t>(elements),
+                                MATRIX_ALIGNMENT) );
+    Q_CHECK_PTR( buffer );
+    GraphTrace::memoryAllocated( sizeof(qreal) * static_cast<qint64>(elements) );
+    return buffer;
+}
+
+
+static void matrixFree(qreal *buffer, const int &elements) {
+    if ( buffer ) {
+        GraphTrace::memoryReleased( sizeof(qreal) * static_cast<qint64>(elements) );
+        qFreeAligned( buffer );
+    }
+}
+
 
 
 /**
@@ -44,10 +113,10 @@
  * @param Actors
  */
 Matrix::Matrix (int rowDim, int colDim)  : m_rows (rowDim), m_cols(colDim) {
-    row = new (nothrow) MatrixRow[ m_rows ];
-    Q_CHECK_PTR( row );
-    for (int i=0;i<m_rows; i++) {
-        row[i].resize( m_cols );
+    m_capacity = m_rows * m_cols;
+    m_data = matrixAllocate( m_capacity );
+    if ( m_data ) {
+        std::fill(m_data, m_data + m_capacity, 0.0);
     }
 }
 
@@ -57,31 +126,39 @@ Matrix::Matrix (int rowDim, int colDim)  : m_rows (rowDim), m_cols(colDim) {
 * @brief Matrix::Matrix
 * Copy constructor. Creates a Matrix identical to Matrix b
 * Allows Matrix a=b declaration
-* Every MatrixRow object holds max_int=32762
 * @param b
 */
-Matrix::Matrix(const Matrix &b) {
-    qDebug()<< "Matrix:: constructor";
-    m_rows=b.m_rows;
-    m_cols=b.m_cols ;
-    row = new MatrixRow[m_rows];
-    Q_CHECK_PTR( row );
-    for (int i=0;i<m_rows; i++) {
-        row[i].resize( m_cols );
-    }
-    for (int i=0; i<m_rows; i++) {
-        row[i]=b.row[i];
+Matrix::Matrix(const Matrix &b) : m_rows(b.m_rows), m_cols(b.m_cols) {
+    qDebug()<< "Matrix:: copy constructor";
+    m_capacity = m_rows * m_cols;
+    m_data = matrixAllocate( m_capacity );
+    if ( m_data ) {
+        std::copy(b.m_data, b.m_data + m_capacity, m_data);
     }
 }
 
 
+
+/**
+ * @brief Matrix::Matrix
+ * Move constructor. Takes over the buffer of b, which is left empty (0x0)
+ * Allows returning matrices by value without copying them.
+ * @param b
+ */
+Matrix::Matrix(Matrix &&b) noexcept
+    : m_data(b.m_data), m_rows(b.m_rows), m_cols(b.m_cols), m_capacity(b.m_capacity) {
+    b.m_data = nullptr;
+    b.m_rows = b.m_cols = b.m_capacity = 0;
+}
+
+
+
 /**
  * @brief Matrix::~Matrix
  * Destructor
  */
 Matrix::~Matrix() {
-    if ( rows() )
-        delete [] row;
+    matrixFree( m_data, m_capacity );
 }
 
 
@@ -89,31 +166,48 @@ Matrix::~Matrix() {
  * @brief Clears data
  */
 void Matrix::clear() {
-    if (m_rows > 0){
-        qDebug() << "Matrix::clear() deleting old rows";
-        m_rows=0;
-        m_cols=0;
-        delete [] row;
+    if (m_data){
+        qDebug() << "Matrix::clear() deleting old data";
+        matrixFree( m_data, m_capacity );
+        m_data = nullptr;
     }
+    m_rows=0;
+    m_cols=0;
+    m_capacity=0;
+}
+
+
+
+/**
+ * @brief Exchanges the contents of this matrix with b, in constant time
+ * @param b
+ */
+void Matrix::swap(Matrix &b) noexcept {
+    std::swap(m_data, b.m_data);
+    std::swap(m_rows, b.m_rows);
+    std::swap(m_cols, b.m_cols);
+    std::swap(m_capacity, b.m_capacity);
 }
 
 
+
 /**
- * @brief Resizes this matrix to m x n
+ * @brief Resizes this matrix to m x n and sets all its elements to zero.
  * Called before every operation on new matrices.
- * Every MatrixRow object holds max_int=32762
+ * The existing buffer is reused if it is big enough.
  * @param Actors
  */
 void Matrix::resize (const int m, const int n) {
-    qDebug() << "Matrix: resize() ";
-    clear();
+    qDebug() << "Matrix: resize() " << m << "x" << n;
+    if ( m * n > m_capacity ) {
+        clear();
+        m_capacity = m * n;
+        m_data = matrixAllocate( m_capacity );
+    }
     m_rows = m;
     m_cols = n;
-    row = new (nothrow) MatrixRow [ m_rows  ];
-    Q_CHECK_PTR( row );
-    qDebug() << "Matrix: resize() -- resizing each row";
-    for (int i=0;i<m_rows; i++) {
-        row[i].resize( m_cols );  // CHECK ME
+    if ( m_data ) {
+        std::fill(m_data, m_data + size(), 0.0);
     }
 }
 
@@ -126,7 +220,7 @@ void Matrix::resize (const int m, const int n) {
  * @param max value
  * Complexity: O(n^2)
  */
-void Matrix::findMinMaxValues (qreal &min, qreal & max, bool &hasRealNumbers){
+void Matrix::findMinMaxValues (qreal &min, qreal & max, bool &hasRealNumbers) const {
     max=0;
     min=RAND_MAX;
     hasRealNumbers = false;
@@ -181,15 +275,9 @@ void Matrix::NeighboursNearestFarthest (qreal &min, qreal & max,
  * @param dim
  */
 void Matrix::identityMatrix(int dim) {
-    qDebug() << "Matrix::identityMatrix() -- deleting old rows";
-    clear();
-    m_rows=dim;
-    m_cols=dim;
-    row = new (nothrow) MatrixRow [m_rows];
-    Q_CHECK_PTR( row );
-    //qDebug() << "Matrix: resize() -- resizing each row";
+    qDebug() << "Matrix::identityMatrix() - dim" << dim;
+    resize(dim, dim);
     for (int i=0;i<m_rows; i++) {
-        row[i].resize(m_rows);
         setItem(i,i, 1);
     }
 }
@@ -203,54 +291,7 @@ void Matrix::identityMatrix(int dim) {
  */
 void Matrix::zeroMatrix(const int m, const int n) {
     qDebug() << "Matrix::zeroMatrix() m " << m << " n " << n;
-    clear();
-    m_rows=m;
-    m_cols=n;
-    row = new (nothrow) MatrixRow [m_rows];
-    Q_CHECK_PTR( row );
-    //qDebug() << "Matrix::zeroMatrix - resizing each row";
-    for (int i=0;i<m_rows; i++) {
-        row[i].resize(m_cols);
-        for (int j=0;j<m_cols; j++) {
-            setItem(i,j, 0);
-        }
-
-    }
-
-}
-
-
-/**
- * @brief Returns the (r,c) matrix element
- * @param r
- * @param c
- * @return
- */
-qreal Matrix::item( int r, int c ){
-    return row[r].column(c);
-}
-
-
-
-/**
- * @brief Sets the (r,c) matrix element calling the setColumn method
- * @param r
- * @param c
- * @param elem
- */
-void Matrix::setItem( const int r, const int c, const qreal elem ) {
-    row [ r ].setColumn(c, elem);
-}
-
-
-
-/**
- * @brief Clears the (r,c) matrix element
- * @param r
- * @param c
- */
-void Matrix::clearItem( int r, int c ) 	{
-    row[r].clearColumn(c);
+    resize(m, n);
 }
 
 
@@ -258,7 +299,6 @@ void Matrix::clearItem( int r, int c ) 	{
 
 
 
-
 /**
  * @brief Deletes row and column and shifts rows and cols accordingly
  * @param erased row/col to delete
@@ -268,45 +308,19 @@ void Matrix::deleteRowColumn(int erased){
              << erased
              << "m_rows before" <<  m_rows;
 
+    const int oldCols = m_cols;
     --m_rows;
     m_cols = m_rows;
-    qDebug() << "Matrix:deleteRowColumn() - m_rows now " << m_rows << ". Resizing...";
-    for (int i=0;i<m_rows+1; i++) {
-        for (int j=0;j<m_rows+1; j++) {
-//            qDebug() << "Matrix:deleteRowColumn() -"
-//                        <<"item ("<< i+1 << "," << j+1 << ") ="<< item(i, j) ;
-            if (i>=m_rows || j>=m_rows) {
-                setItem( i, j, RAND_MAX) ;
-//                qDebug() << "Matrix:deleteRowColumn() -"
-//                         <<"both i,j>=m_rows, corner case (will be deleted). Setting to RAND_MAX."
-//                        << "New item value (" <<  i+1 << ", " << j+1 << ") ="<< item(i, j) ;
-            }
-            else if (i<erased && j< erased) {
-//                qDebug() << "Matrix:deleteRowColumn() -"
-//                         << "i, j < erased. Skipping. Item unchanged.";
-                continue;
-            }
-            else if (i<erased && j>=erased) {
-                setItem( i, j, item(i,j+1) ) ;
-//                qDebug() << "Matrix:deleteRowColumn() -"
-//                            <<"j>=erased, shifting column left"
-//                           << "New item value (" <<  i+1 << ", " << j+1 << ") ="<< item(i, j) ;
-            }
-            else if (i>=erased && j<erased) {
-                setItem( i, j, item(i+1,j) ) ;
-//                qDebug() << "Matrix:deleteRowColumn() -"
-//                         <<"i>=erased, shifting rows up."
-//                        << "New item value (" <<  i+1 << ", " << j+1 << ") ="<< item(i, j) ;
-            }
-            else if (i>=erased && j>=erased) {
-                setItem( i, j, item(i+1,j+1) ) ;
-//                qDebug() << "Matrix:deleteRowColumn() -"
-//                         <<"both i,j>=erased, shifting row up and column left."
-//                        << "New item value (" <<  i+1 << ", " << j+1 << ") ="<< item(i, j) ;
-            }
-
+    qDebug() << "Matrix:deleteRowColumn() - m_rows now " << m_rows << ". Compacting...";
+    // Compact in place, from stride oldCols to stride m_cols.
+    // Every target precedes its source, so a forward pass never
+    // overwrites an element that is still to be read.
+    for (int i=0;i<m_rows; i++) {
+        const int si = ( i < erased ) ? i : i+1;
+        for (int j=0;j<m_cols; j++) {
+            const int sj = ( j < erased ) ? j : j+1;
+            m_data[ i * m_cols + j ] = m_data[ si * oldCols + sj ];
         }
-        row[i].setSize(m_cols);
     }
     qDebug() << "Matrix:deleteRowColumn() - finished, new matrix:";
     //printMatrixConsole(true); // @TODO comment out to release
@@ -409,21 +423,40 @@ void Matrix::multiplyRow(int row, qreal value) {
 * @param a
 * @return
 */
-Matrix& Matrix::operator = (Matrix & a) {
+Matrix& Matrix::operator = (const Matrix & a) {
     qDebug()<< "Matrix::operator asignment =";
     if (this != &a){
-        if (a.m_rows!=m_rows) {
+        if ( a.size() > m_capacity ) {
             clear();
-            m_rows=a.m_rows;
-            m_cols=a.m_cols;
-            row=new (nothrow) MatrixRow[m_rows];
-            Q_CHECK_PTR( row );
-            for (int i=0;i<m_rows; i++) {
-                row[i].resize(m_cols); //every MatrixRow object holds max_int=32762
-            }
+            m_capacity = a.size();
+            m_data = matrixAllocate( m_capacity );
         }
-       for (int i=0;i<m_rows; i++)
-           row[i]=a.row[i];
+        m_rows=a.m_rows;
+        m_cols=a.m_cols;
+        if ( m_data ) {
+            std::copy(a.m_data, a.m_data + a.size(), m_data);
+        }
+    }
+    return *this;
+}
+
+
+
+/**
+ * @brief Move assignment. Takes over the buffer of a, which is left empty
+ * Allows A = B.transpose() and the like without copying the result.
+ * @param a
+ * @return
+ */
+Matrix& Matrix::operator = (Matrix && a) noexcept {
+    if (this != &a){
+        matrixFree( m_data, m_capacity );
+        m_data = a.m_data;
+        m_rows = a.m_rows;
+        m_cols = a.m_cols;
+        m_capacity = a.m_capacity;
+        a.m_data = nullptr;
+        a.m_rows = a.m_cols = a.m_capacity = 0;
     }
     return *this;
 }
@@ -447,6 +480,24 @@ void Matrix::sum( Matrix &a, Matrix & b)  {
 
 
 
+/**
+ * @brief Matrix subtraction into this matrix
+ * Takes two (nxn) matrices and stores their difference a-b to this
+ * In this case, you use something like: c.difference(a,b)
+ * @param a
+ * @param b
+ */
+void Matrix::difference( Matrix &a, Matrix & b)  {
+    if ( &a != this && &b != this ) {
+        resize(a.rows(), a.cols());
+    }
+    for (int i=0;i< rows();i++)
+        for (int j=0;j<cols();j++)
+            setItem(i,j, a.item(i,j)-b.item(i,j));
+}
+
+
+
 
 
 /**
@@ -472,13 +523,11 @@ void Matrix::operator +=(Matrix & b) {
   * @param b
   * @return Matrix S
 */
-Matrix& Matrix::operator +(Matrix & b) {
-    Matrix *S = new Matrix(rows(), cols());
+Matrix Matrix::operator +(Matrix & b) {
+    Matrix S(rows(), cols());
     qDebug()<< "Matrix::operator +";
-    for (int i=0;i< rows();i++)
-        for (int j=0;j<cols();j++)
-            S->setItem(i,j, item(i,j)+b.item(i,j));
-    return *S;
+    S.sum(*this, b);
+    return S;
 }
 
 
@@ -489,13 +538,165 @@ Matrix& Matrix::operator +(Matrix & b) {
   * @param b
   * @return Matrix S
 */
-Matrix& Matrix::operator -(Matrix & b) {
-    Matrix *S = new Matrix(rows(), cols() );
+Matrix Matrix::operator -(Matrix & b) {
+    Matrix S;
     qDebug()<< "Matrix::operator -";
-    for (int i=0;i< rows();i++)
-        for (int j=0;j<cols();j++)
-            S->setItem(i,j, item(i,j)-b.item(i,j));
-    return *S;
+    S.difference(*this, b);
+    return S;
+}
+
+
+
+/*
+ * Dense product kernel, used by Matrix::product() and the * operators.
+ *
+ * P = A * B is computed row-wise (i-k-j order), so that the innermost loop
+ * streams contiguous rows of B and P. Rows of A are taken four at a time
+ * (register blocking), so that each element of B loaded is used four times.
+ * The k and j loops are tiled to keep the tile of B in cache.
+ * Zero elements of A are skipped, which pays off on adjacency matrices.
+ * Row blocks are spread over the global thread pool.
+ */
+
+static const int GEMM_ROWS = 4;          // rows of A per micro-kernel call
+static const int GEMM_ROW_BLOCK = 64;    // rows of A per parallel task
+static const int GEMM_K_BLOCK = 128;     // tile height of B
+static const int GEMM_J_BLOCK = 256;     // tile width of B
+
+
+/*
+ * c_r[from..to) += a_r * b[from..to) for r = 0..rows-1
+ */
+static inline void gemmMicroKernel(qreal *c[], const qreal a[], const int &rows,
+                                   const qreal *b, const int &from, const int &to) {
+    int j = from;
+#if defined(SOCNETV_GEMM_AVX2)
+    if ( rows == GEMM_ROWS ) {
+        const __m256d a0 = _mm256_set1_pd(a[0]), a1 = _mm256_set1_pd(a[1]);
+        const __m256d a2 = _mm256_set1_pd(a[2]), a3 = _mm256_set1_pd(a[3]);
+        for ( ; j + 4 <= to; j += 4) {
+            const __m256d bj = _mm256_loadu_pd(b + j);
+            _mm256_storeu_pd(c[0] + j, _mm256_fmadd_pd(a0, bj, _mm256_loadu_pd(c[0] + j)));
+            _mm256_storeu_pd(c[1] + j, _mm256_fmadd_pd(a1, bj, _mm256_loadu_pd(c[1] + j)));
+            _mm256_storeu_pd(c[2] + j, _mm256_fmadd_pd(a2, bj, _mm256_loadu_pd(c[2] + j)));
+            _mm256_storeu_pd(c[3] + j, _mm256_fmadd_pd(a3, bj, _mm256_loadu_pd(c[3] + j)));
+        }
+    }
+#elif defined(SOCNETV_GEMM_NEON)
+    if ( rows == GEMM_ROWS ) {
+        const float64x2_t a0 = vdupq_n_f64(a[0]), a1 = vdupq_n_f64(a[1]);
+        const float64x2_t a2 = vdupq_n_f64(a[2]), a3 = vdupq_n_f64(a[3]);
+        for ( ; j + 2 <= to; j += 2) {
+            const float64x2_t bj = vld1q_f64(b + j);
+            vst1q_f64(c[0] + j, vfmaq_f64(vld1q_f64(c[0] + j), a0, bj));
+            vst1q_f64(c[1] + j, vfmaq_f64(vld1q_f64(c[1] + j), a1, bj));
+            vst1q_f64(c[2] + j, vfmaq_f64(vld1q_f64(c[2] + j), a2, bj));
+            vst1q_f64(c[3] + j, vfmaq_f64(vld1q_f64(c[3] + j), a3, bj));
+        }
+    }
+#endif
+    if ( rows == GEMM_ROWS ) {
+        qreal *c0 = c[0], *c1 = c[1], *c2 = c[2], *c3 = c[3];
+        const qreal a0 = a[0], a1 = a[1], a2 = a[2], a3 = a[3];
+        for ( ; j < to; ++j) {
+            const qreal bj = b[j];
+            c0[j] += a0 * bj;
+            c1[j] += a1 * bj;
+            c2[j] += a2 * bj;
+            c3[j] += a3 * bj;
+        }
+        return;
+    }
+    for (int r = 0; r < rows; ++r) {
+        qreal *cr = c[r];
+        const qreal ar = a[r];
+        for (int jj = from; jj < to; ++jj) {
+            cr[jj] += ar * b[jj];
+        }
+    }
+}
+
+
+/*
+ * Computes rows [first, last) of P = A * B. If symmetry is true, only the
+ * elements on and above the diagonal are computed.
+ */
+static void gemmRowBlock(Matrix &P, Matrix &A, Matrix &B,
+                         const int &first, const int &last, const bool &symmetry) {
+    const int n = A.cols();
+    const int p = B.cols();
+    qreal *c[GEMM_ROWS];
+    qreal a[GEMM_ROWS];
+
+    for (int i = first; i < last; i += GEMM_ROWS) {
+        const int rows = qMin(GEMM_ROWS, last - i);
+        for (int r = 0; r < rows; ++r) {
+            c[r] = P[i + r];
+        }
+        // in the symmetric case, the rows of this group start at column i
+        const int jStart = symmetry ? i : 0;
+        for (int j0 = jStart; j0 < p; j0 += GEMM_J_BLOCK) {
+            const int j1 = qMin(p, j0 + GEMM_J_BLOCK);
+            for (int k0 = 0; k0 < n; k0 += GEMM_K_BLOCK) {
+                const int k1 = qMin(n, k0 + GEMM_K_BLOCK);
+                for (int k = k0; k < k1; ++k) {
+                    bool zero = true;
+                    for (int r = 0; r < rows; ++r) {
+                        a[r] = A[i + r][k];
+                        zero = zero && ( a[r] == 0 );
+                    }
+                    if ( zero ) {
+                        continue;
+                    }
+                    gemmMicroKernel(c, a, rows, B[k], j0, j1);
+                }
+            }
+        }
+    }
+}
+
+
+/*
+ * P = A * B, with P already sized A.rows() x B.cols() and zeroed.
+ */
+static void gemm(Matrix &P, Matrix &A, Matrix &B, const bool &symmetry) {
+    const int m = A.rows();
+
+#ifdef SOCNETV_BLAS
+    // Row-major P = A B is, read column-major, P^T = B^T A^T
+    Q_UNUSED(symmetry);
+    const int n = B.cols(), k = A.cols();
+    if ( m == 0 || n == 0 || k == 0 ) {
+        return;
+    }
+    const char noTrans = 'N';
+    const qreal one = 1, zero = 0;
+    dgemm_(&noTrans, &noTrans, &n, &m, &k,
+           &one, B.data(), &n, A.data(), &k,
+           &zero, P.data(), &n);
+    return;
+#endif
+
+    QVector<int> blocks;
+    for (int i = 0; i < m; i += GEMM_ROW_BLOCK) {
+        blocks << i;
+    }
+
+    QtConcurrent::blockingMap(blocks, [&](const int &first) {
+        gemmRowBlock(P, A, B, first, qMin(m, first + GEMM_ROW_BLOCK), symmetry);
+    });
+
+    if ( symmetry ) {
+        // mirror the upper triangle; the j < i + GEMM_ROWS part of each row
+        // group was computed too, so only copy the strictly lower elements
+        // that were not.
+        for (int i = 0; i < m; ++i) {
+            const int computedFrom = i - ( i % GEMM_ROWS );
+            for (int j = 0; j < computedFrom; ++j) {
+                P[i][j] = P[j][i];
+            }
+        }
+    }
 }
 
 
@@ -504,34 +705,27 @@ Matrix& Matrix::operator -(Matrix & b) {
  * @brief Matrix multiplication, operator *
  * Multiplies (right) this matrix with given matrix b.
  * Allows P = A * B where A,B of same dimension
-* and returns product as a reference to the calling object
+* and returns the product by value (moved, not copied)
 * @param b
 * @param symmetry
 * @return
 */
-Matrix& Matrix::operator *(Matrix & b) {
+Matrix Matrix::operator *(Matrix & b) {
 
     qDebug()<< "Matrix::operator *";
 
-    Matrix *P = new Matrix(rows(), cols());
-
     if ( cols() != b.rows() ) {
         qDebug()<< "Matrix::product() - ERROR! Non compatible input matrices:"
                    " this("
                 << rows() << "," << cols()
                 << ") and b(" << b.rows() << ","<< b.cols();
-        return *P;
+        return Matrix(rows(), cols());
     }
 
-    for (int i=0;i< rows();i++)
-        for (int j=0;j<b.cols();j++) {
-            P->setItem(i,j,0);
-            for (int k=0;k< cols();k++) {
-                    P->setItem(i,j, P->item(i,j) + item(i,k)*b.item(k,j) );
+    Matrix P(rows(), b.cols());
+    gemm(P, *this, b, false);
 
-            }
-        }
-    return *P;
+    return P;
 }
 
 
@@ -556,17 +750,11 @@ void Matrix::operator *=(Matrix & b) {
         return;
     }
 
-    Matrix *P = new Matrix(rows(), b.cols());
+    Matrix P(rows(), b.cols());
 
-    for (int i=0;i< rows();i++) {
-        for (int j=0;j<b.cols();j++) {
-            P->setItem(i,j,0);
-            for (int k=0;k < cols();k++) {
-                    P->setItem(i,j, P->item(i,j) + item(i,k)*b.item(k,j) );
-            }
-        }
-    }
-    *this = *P;
+    gemm(P, *this, b, false);
+
+    swap(P);
 }
 
 
@@ -593,25 +781,18 @@ void Matrix::product(Matrix &A, Matrix & B, bool symmetry)  {
         return;
     }
 
-    Matrix *P = new Matrix(A.rows(), B.cols());
+    if ( &A != this && &B != this ) {
+        resize(A.rows(), B.cols());
+        gemm(*this, A, B, symmetry);
+        return;
+    }
 
-    qreal prod = 0;
+    // A or B is this matrix, so compute into a new one and take its buffer
+    Matrix P(A.rows(), B.cols());
 
-    for (int i=0;i< A.rows();i++) {
-        for (int j=0;j<B.cols();j++) {
-            if (symmetry && i > j ) continue;
-            prod = 0;
-            for (int k=0;k<A.cols();k++) {
-                prod += A.item(i,k)*B.item(k,j);
-            }
-            P->setItem(i,j, prod);
-            if (symmetry) {
-               P->setItem(j,i, prod );
-            }
-        }
-    }
-//    qDebug() << "Matrix::product() - this";
-    *this = *P;
+    gemm(P, A, B, symmetry);
+
+    swap(P);
 
     //this->printMatrixConsole();
 }
@@ -653,75 +834,56 @@ Matrix& Matrix::productSym( Matrix &a, Matrix & b)  {
  * @param symmetry
  * @return Matrix
  */
-Matrix& Matrix::pow (int n, bool symmetry)  {
-    if (rows()!= cols()) {
-        qDebug()<< "Matrix::pow() - Error. This works only for square matrix";
-        return *this;
-    }
-    qDebug()<< "Matrix::pow() ";
-    Matrix X, Y; //auxilliary matrices
-    qDebug()<< "Matrix::pow() - creating X = this";
-    X=*this; //X = this
-    //X.printMatrixConsole(true);
-    qDebug()<< "Matrix::pow() - creating Y = I";
-    Y.identityMatrix( rows() ); // y=I
-    //Y.printMatrixConsole(true);
-    return expBySquaring2 (Y, X, n, symmetry);
-
+Matrix Matrix::pow (int n, bool symmetry)  {
+    Matrix P;
+    pow(P, n, symmetry);
+    return P;
 }
 
 
 
 /**
- * @brief Recursive algorithm implementing "Exponentiation by squaring".
- * Also known as Fast Modulo Multiplication, this algorithm allows
- * fast computation of a large power n of square matrix X
- * @param Y must be the Identity matrix  on first call
- * @param X the matrix to be powered
- * @param n the power
- * @param symmetry
- * @return Matrix&
-
- * On first call, parameters must be: Y=I, X the orginal matrix to power and n the power.
- * Returns the power of matrix X to this object.
+ * @brief Computes the n-nth power of this matrix into P
+ * Uses "Exponentiation by squaring" (fast modulo multiplication):
+ * the base X is squared log2(n) times and multiplied into P for every
+ * bit set in n. Only three matrices are alive at any time, and the
+ * products are written straight into them.
  * For n > 4 it is more efficient than naively multiplying the base with itself repeatedly.
+ * @param P the result, it must not be this matrix
+ * @param n the power, n >= 1
+ * @param symmetry
  */
-Matrix& Matrix::expBySquaring2 (Matrix &Y, Matrix &X,  int n, bool symmetry) {
-    if (n==1) {
-        qDebug() <<"Matrix::expBySquaring2() - n = 1. Computing PM = X*Y where "
-                   "X = " ;
-        //X.printMatrixConsole();
-        //qDebug() <<"Matrix::expBySquaring2() - n = 1. And Y = ";
-        //Y.printMatrixConsole();
-        Matrix *PM = new Matrix(rows(), cols());
-        PM->product(X, Y, symmetry);
-        //qDebug()<<"Matrix::expBySquaring2() - n = 1. PM = X*Y ="  ;
-        //PM->printMatrixConsole();
-        return *PM;
-    }
-    else if ( n%2 == 0 ) { //even
-        qDebug()<<"Matrix::expBySquaring2() - even n =" << n
-               << "Computing PM = X * X";
-        Matrix PM(rows(), cols());
-        PM.product(X,X,symmetry);
-        //qDebug()<<"Matrix::expBySquaring2() - even n =" << n << ". PM = X * X = " ;
-        //PM.printMatrixConsole();
-        return expBySquaring2 ( Y, PM, n/2 );
-    }
-    else  { //odd
-        qDebug()<<"Matrix::expBySquaring2() - odd n =" << n
-               << "First compute PM = X * Y";
-        Matrix PM(rows(), cols());
-        Matrix PM2(rows(), cols());
-        PM.product(X,Y,symmetry);
-        //qDebug()<<"Matrix::expBySquaring2() - odd n =" << n << ". PM = X * Y = " ;
-        //PM.printMatrixConsole();
-        qDebug()<<"Matrix::expBySquaring2() - odd n =" << n
-               << "Now compute PM2 = X * X";
-        PM2.product(X,X,symmetry);
-        //qDebug()<<"Matrix::expBySquaring2() - odd n =" << n << ". PM2 = X * X = " ;
-        //PM2.printMatrixConsole();
-        return expBySquaring2 ( PM, PM2, (n-1)/2 );
+void Matrix::pow (Matrix &P, int n, bool symmetry)  {
+    if (rows()!= cols()) {
+        qDebug()<< "Matrix::pow() - Error. This works only for square matrix";
+        P = *this;
+        return;
+    }
+    qDebug()<< "Matrix::pow() - n" << n;
+
+    Matrix X(*this), T;
+    bool first = true;
+
+    while ( n > 0 ) {
+        if ( n & 1 ) {
+            if ( first ) {
+                P = X;
+                first = false;
+            }
+            else {
+                T.product(P, X, symmetry);
+                P.swap(T);
+            }
+        }
+        n >>= 1;
+        if ( n > 0 ) {
+            T.product(X, X, symmetry);
+            X.swap(T);
+        }
+    }
+    if ( first ) {
+        // n <= 0, by convention X^0 = I
+        P.identityMatrix( rows() );
     }
 }
 
@@ -915,25 +1077,120 @@ void Matrix::powerIteration (
 }
 
 
+/**
+ * @brief Computes all eigenvalues and eigenvectors of this real symmetric
+ * matrix, by the cyclic Jacobi method. This matrix is left unchanged.
+ * Meant for small matrices, i.e. the tridiagonal matrices of Lanczos.
+ * @param values output array of n eigenvalues, unsorted
+ * @param vectors output n x n matrix, whose column k is the normalized
+ * eigenvector of values[k]
+ * @param maxSweeps the maximum number of sweeps over all off-diagonal elements
+ * @return false if the method did not converge within maxSweeps
+ *
+ * Code adapted from Numerical Recipes in C, pp 467 (jacobi)
+ */
+bool Matrix::eigenSymmetric(qreal values[], Matrix &vectors, const int &maxSweeps) {
+    const int n = rows();
+    int i=0, j=0, k=0, p=0, q=0, sweep=0;
+    qreal offDiagonal=0, theta=0, t=0, c=0, s=0, tau=0, h=0, g=0;
+
+    qDebug() << "Matrix::eigenSymmetric() - n" << n;
+
+    Matrix a(n, n);
+    for (i=0;i<n;i++) {
+        for (j=0;j<n;j++) {
+            a.setItem(i, j, item(i, j));
+        }
+    }
+    vectors.identityMatrix(n);
+
+    for (sweep = 0; sweep < maxSweeps; sweep++) {
+
+        offDiagonal = 0;
+        for (p=0;p<n-1;p++) {
+            for (q=p+1;q<n;q++) {
+                offDiagonal += fabs( a.item(p, q) );
+            }
+        }
+        if ( offDiagonal < TINY ) {
+            for (i=0;i<n;i++) {
+                values[i] = a.item(i, i);
+            }
+            return true;
+        }
+
+        for (p=0;p<n-1;p++) {
+            for (q=p+1;q<n;q++) {
+                if ( fabs( a.item(p, q) ) < TINY ) {
+                    continue;
+                }
+                // Rotation that annihilates a(p,q)
+                theta = ( a.item(q, q) - a.item(p, p) ) / ( 2.0 * a.item(p, q) );
+                t = ( ( theta >= 0 ) ? 1.0 : -1.0 )
+                        / ( fabs(theta) + sqrt( theta * theta + 1.0 ) );
+                c = 1.0 / sqrt( t * t + 1.0 );
+                s = t * c;
+                tau = s / ( 1.0 + c );
+                h = t * a.item(p, q);
+
+                a.setItem( p, p, a.item(p, p) - h );
+                a.setItem( q, q, a.item(q, q) + h );
+                a.setItem( p, q, 0 );
+                a.setItem( q, p, 0 );
+
+                for (k=0;k<n;k++) {
+                    if ( k != p && k != q ) {
+                        g = a.item(k, p);
+                        h = a.item(k, q);
+                        a.setItem( k, p, g - s * ( h + g * tau ) );
+                        a.setItem( p, k, a.item(k, p) );
+                        a.setItem( k, q, h + s * ( g - h * tau ) );
+                        a.setItem( q, k, a.item(k, q) );
+                    }
+                    g = vectors.item(k, p);
+                    h = vectors.item(k, q);
+                    vectors.setItem( k, p, g - s * ( h + g * tau ) );
+                    vectors.setItem( k, q, h + s * ( g - h * tau ) );
+                }
+            }
+        }
+    }
+
+    qDebug() << "Matrix::eigenSymmetric() - no convergence after" << maxSweeps << "sweeps";
+    for (i=0;i<n;i++) {
+        values[i] = a.item(i, i);
+    }
+    return false;
+}
+
+
 
 /**
   * @brief Returns the Transpose of this matrix
   * Allows T = A.transpose()
-  * @param b
   * @return Matrix T
 */
+Matrix Matrix::transpose() {
+    Matrix T;
+    transpose(T);
+    return T;
+}
 
-Matrix& Matrix::transpose() {
-    Matrix *T = new Matrix(cols(), rows());
-    //T->zeroMatrix(cols(), rows());
-    qDebug()<< "Matrix::transpose()";
-    for (int i=0;i< cols();i++) {
-        for (int j=0;j<rows();j++) {
-            T->setItem(i,j, item(j,i));
 
+/**
+  * @brief Computes the Transpose of this matrix into T
+  * Allows A.transpose(T), reusing the buffer of T
+  * @param T
+*/
+void Matrix::transpose(Matrix &T) {
+    qDebug()<< "Matrix::transpose()";
+    T.resize(cols(), rows());
+    for (int i=0;i< rows();i++) {
+        const qreal *a = (*this)[i];
+        for (int j=0;j<cols();j++) {
+            T.setItem(j,i, a[j]);
         }
     }
-    return *T;
 }
 
 
@@ -941,18 +1198,27 @@ Matrix& Matrix::transpose() {
 
 
 /**
-  * @brief Returns the Cocitation Matrix of this matrix (C = A * A^T)
-  * Allows T = A.cocitationMatrix()
-  * @param b
-  * @return Matrix T
+  * @brief Returns the Cocitation Matrix of this matrix (C = A^T * A)
+  * Allows C = A.cocitationMatrix()
+  * @return Matrix C
 */
+Matrix Matrix::cocitationMatrix() {
+    Matrix C;
+    cocitationMatrix(C);
+    return C;
+}
+
 
-Matrix& Matrix::cocitationMatrix() {
-    Matrix *T = new Matrix(cols(), rows());
-    qDebug()<< "Matrix::cocitationMatrix() this transpose";
-    //this->transpose().printMatrixConsole();
-    T->product(this->transpose(),*this, true);
-    return *T;
+/**
+  * @brief Computes the Cocitation Matrix of this matrix (C = A^T * A) into C
+  * Allows A.cocitationMatrix(C)
+  * @param C
+*/
+void Matrix::cocitationMatrix(Matrix &C) {
+    qDebug()<< "Matrix::cocitationMatrix()";
+    Matrix T;
+    transpose(T);
+    C.product(T, *this, true);
 }
 
 
@@ -962,24 +1228,33 @@ Matrix& Matrix::cocitationMatrix() {
   * @brief Returns the Degree Matrix of this matrix.
   * The Degree Matrix is diagonal matrix which contains information about the degree
   * of each graph vertex (row of the adjacency matrix)
-  * Allows S = A.degreeMatrix()
-  * @param b
-  * @return Matrix S
+  * Allows D = A.degreeMatrix()
+  * @return Matrix D
 */
+Matrix Matrix::degreeMatrix() {
+    Matrix D;
+    degreeMatrix(D);
+    return D;
+}
+
 
-Matrix& Matrix::degreeMatrix() {
-    Matrix *S = new Matrix(rows(), cols());
+/**
+  * @brief Computes the Degree Matrix of this matrix into D
+  * Allows A.degreeMatrix(D)
+  * @param D
+*/
+void Matrix::degreeMatrix(Matrix &D) {
     qDebug()<< "Matrix::degreeMatrix()";
+    D.resize(rows(), cols());
     qreal degree=0;
     for (int i=0;i< rows();i++) {
         degree = 0;
+        const qreal *a = (*this)[i];
         for (int j=0;j<cols();j++) {
-            degree += item(i,j);
-
+            degree += a[j];
         }
-        S->setItem(i,i, degree);
+        D.setItem(i,i, degree);
     }
-    return *S;
 }
 
 
@@ -987,17 +1262,35 @@ Matrix& Matrix::degreeMatrix() {
 /**
   * @brief Returns the Laplacian of this matrix.
   * The Laplacian is a NxN matrix L = D - A where D is the degree matrix of A
-  * Allows S = A.laplacianMatrix()
-  * @param b
-  * @return Matrix S
+  * Allows L = A.laplacianMatrix()
+  * @return Matrix L
 */
+Matrix Matrix::laplacianMatrix() {
+    Matrix L;
+    laplacianMatrix(L);
+    return L;
+}
 
-Matrix& Matrix::laplacianMatrix() {
-    Matrix *S = new Matrix(rows(), cols());
-    //S->zeroMatrix(rows(), cols());
+
+/**
+  * @brief Computes the Laplacian L = D - A of this matrix into L, in one pass
+  * Allows A.laplacianMatrix(L)
+  * @param L
+*/
+void Matrix::laplacianMatrix(Matrix &L) {
     qDebug()<< "Matrix::laplacianMatrix()";
-    *S = (this->degreeMatrix()) - *this;
-    return *S;
+    L.resize(rows(), cols());
+    qreal degree=0;
+    for (int i=0;i< rows();i++) {
+        degree = 0;
+        const qreal *a = (*this)[i];
+        qreal *l = L[i];
+        for (int j=0;j<cols();j++) {
+            degree += a[j];
+            l[j] = - a[j];
+        }
+        l[i] += degree;
+    }
 }
 
 
@@ -1006,17 +1299,59 @@ Matrix& Matrix::laplacianMatrix() {
 
 
 
+#ifdef SOCNETV_BLAS
+/**
+ * @brief Inverts the n x n row-major matrix a in place, with LAPACK
+ * dgetrf/dgetri. LAPACK sees the buffer as the column-major transpose A^T,
+ * and inv(A^T) = inv(A)^T, so the buffer ends up holding inv(A) row-major.
+ * @param a
+ * @param n
+ * @return false if the matrix is singular
+ */
+static bool lapackInverse(qreal *a, const int &n) {
+    QVector<int> ipiv(n);
+    int info = 0;
+    dgetrf_(&n, &n, a, &n, ipiv.data(), &info);
+    if ( info != 0 ) {
+        return false;
+    }
+    int lwork = -1;
+    qreal optimal = 0;
+    dgetri_(&n, a, &n, ipiv.constData(), &optimal, &lwork, &info);
+    lwork = qMax( n, static_cast<int>(optimal) );
+    QVector<qreal> work(lwork);
+    dgetri_(&n, a, &n, ipiv.constData(), work.data(), &lwork, &info);
+    return ( info == 0 );
+}
+#endif
+
+
+
 /**
  * @brief Inverts given matrix A by Gauss Jordan elimination
    Input:  matrix A
    Output: matrix A becomes unit matrix
    *this becomes the invert of A and is returned back.
+   With the BLAS backend, LAPACK does the inversion instead; a singular A
+   gives a zero matrix.
  * @param A
  * @return inverse matrix of A
  */
 Matrix& Matrix::inverseByGaussJordanElimination(Matrix &A){
 	qDebug()<< "Matrix::inverseByGaussJordanElimination()";
 	int n=A.cols();
+    GraphTraceScope trace("Matrix::inverseByGaussJordanElimination");
+    trace.setInput(n, 0);
+
+#ifdef SOCNETV_BLAS
+    *this = A;
+    if ( n > 0 && ! lapackInverse(data(), n) ) {
+        qDebug()<< "Matrix::inverseByGaussJordanElimination() - matrix A singular";
+        zeroMatrix(n, n);
+    }
+    A.identityMatrix(n);
+    return *this;
+#endif
     qDebug()<<"Matrix::inverseByGaussJordanElimination() - build I size " << n
              << " This will become A^-1 in the end";
 
@@ -1271,6 +1606,22 @@ Matrix& Matrix::inverse(Matrix &a)
 {
     int i,j, n=a.rows();
     qreal d;
+    GraphTraceScope trace("Matrix::inverse");
+    trace.setInput(n, 0);
+
+#ifdef SOCNETV_BLAS
+    qDebug () << "Matrix::inverse() - inverting matrix a with LAPACK - size " << n;
+    Q_UNUSED(i); Q_UNUSED(j); Q_UNUSED(d);
+    *this = a;
+    if ( n > 0 && ! lapackInverse(data(), n) ) {
+        qDebug () << "Matrix::inverse() - matrix a singular - RETURN";
+        zeroMatrix(n, n);
+    }
+    return *this;
+#endif
+    if ( this != &a ) {
+        resize(n, n);
+    }
     //qreal *col = new qreal[n];
     qreal *col = new  (nothrow) qreal [ n ];
     Q_CHECK_PTR(col);
@@ -1281,11 +1632,15 @@ Matrix& Matrix::inverse(Matrix &a)
 
     qDebug () << "Matrix::inverse() - inverting matrix a - size " << n;
     if (n==0) {
+        delete [] col;
+        delete [] indx;
         return (*this);
     }
     if ( ! ludcmp(a,n,indx,d) )
     { //  Decompose the matrix just once.
         qDebug () << "Matrix::inverse() - matrix a singular - RETURN";
+        delete [] col;
+        delete [] indx;
         return *this;
     }
 
@@ -1305,6 +1660,8 @@ Matrix& Matrix::inverse(Matrix &a)
     }
         qDebug () << "Matrix::inverse() - finished!";
 
+    delete [] col;
+    delete [] indx;
     return *this;
 }
 
@@ -1322,415 +1679,581 @@ Matrix& Matrix::inverse(Matrix &a)
 bool Matrix::solve(qreal b[])
 {
 
-    Matrix *A = new Matrix(this->rows(), this->cols());
-
-    *A = *this;
-
-
     int n=rows();
     qreal d;
 
-//    int indx[n];
-    int *indx = new  (nothrow) int [ n ];
-    Q_CHECK_PTR(indx);
-
     qDebug () << "Matrix::solve() - solving A x  - size " << n;
     if (n==0) {
         return false;
     }
-    if ( ! ludcmp(*A,n,indx,d) )
+
+    Matrix A(*this);
+
+#ifdef SOCNETV_BLAS
+    // LAPACK factors the buffer as A^T, so solve with its transpose
+    Q_UNUSED(d);
+    QVector<int> ipiv(n);
+    int info = 0, nrhs = 1;
+    const char trans = 'T';
+    dgetrf_(&n, &n, A.data(), &n, ipiv.data(), &info);
+    if ( info != 0 ) {
+        qDebug () << "Matrix::solve() - matrix a singular - RETURN";
+        return false;
+    }
+    dgetrs_(&trans, &n, &nrhs, A.data(), &n, ipiv.constData(), b, &n, &info);
+    qDebug () << "Matrix::solve() - finished with LAPACK!";
+    return ( info == 0 );
+#endif
+
+    int *indx = new  (nothrow) int [ n ];
+    Q_CHECK_PTR(indx);
+    if ( ! ludcmp(A,n,indx,d) )
     { //  Decompose the matrix just once.
         qDebug () << "Matrix::solve() - matrix a singular - RETURN";
+        delete [] indx;
         return false ;
     }
 
     qDebug () << "Matrix::solve() - call lubksb";
-    lubksb(*A, n, indx, b);
+    lubksb(A, n, indx, b);
+    delete [] indx;
     qDebug () << "Matrix::solve() - finished!";
 
     return true;
 }
 
 
-/**
- * @brief Computes the dissimilarities matrix of the variables (rows, columns, both)
- * of this matrix using the user defined metric
- * @param metric
- * @param varLocation
- * @param diagonal
- * @param considerWeights
- * @return
+/*
+ * Kernels of Matrix::similarityMatrix() and
+ * Matrix::pearsonCorrelationCoefficients().
+ *
+ * Both compare N variables (the rows, the columns, or both, of the input)
+ * pair by pair, so they are laid out as the rows of a N x L matrix V, with
+ * L = N, or L = 2N if rows and columns are concatenated ("Both").
+ * When the diagonal is excluded, each pair (i,k) skips the coordinates of
+ * i and k, that is {i,k} or {i,k,i+N,k+N}.
+ *
+ * Only the upper triangle of pairs is computed, in blocks of rows spread
+ * over the global thread pool, and mirrored.
+ * - Dot-product measures (cosine, euclidean, pearson) come from the Gram
+ *   matrix V V^T, computed by gemm() (blocked, SIMD, or BLAS); each pair
+ *   then takes O(1) corrections for the skipped coordinates.
+ * - Matching measures on 0/1 data go through bit-packed rows and
+ *   popcounts of their AND, OR and XOR.
+ * - Matching measures on any other data count in branch-free loops over
+ *   contiguous rows, which the compiler vectorizes, tiled for cache reuse.
  */
-Matrix& Matrix::distancesMatrix(const int &metric,
-                        const QString varLocation,
-                        const bool &diagonal,
-                        const bool &considerWeights) {
-    Q_UNUSED(considerWeights);
-
-    Matrix *T = new Matrix(cols(), rows());
-
-    qDebug()<< "Matrix::distancesMatrix() -"
-            <<"metric"<< metric
-            << "varLocation"<< varLocation
-            << "diagonal"<<diagonal;
 
-    int N = 0;
-    qreal sum = 0;
-    qreal distance = 0;
-    qreal distTemp = 0;
-    qreal ties = 0;
-    qreal max = 0 ; // for Chebyshev metric
-    if (varLocation=="Rows") {
+static const int SIMILARITY_ROW_BLOCK = 16;   // rows of pairs per parallel task
+static const int SIMILARITY_K_BLOCK = 64;     // tile of partner rows
 
-        N = rows() ;
 
-        QVector<qreal> mean (N,0); // holds mean values
+/*
+ * Returns a matrix whose rows are the variables of AM: AM itself for
+ * "Rows", or V laid out from AM otherwise. If VT is given, it receives
+ * the transpose. Returns nullptr if varLocation is unknown.
+ */
+static Matrix *similarityVariables(Matrix &AM, const QString &varLocation,
+                                   Matrix &V, Matrix *VT) {
+    const int N = AM.rows();
+    Matrix *variables = &V;
+    if ( varLocation == "Rows" ) {
+        variables = &AM;
+    }
+    else if ( varLocation == "Columns" ) {
+        AM.transpose(V);
+    }
+    else if ( varLocation == "Both" ) {
+        V.resize(N, 2 * N);
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                V[i][j] = AM[i][j];
+                V[i][j + N] = AM[j][i];
+            }
+        }
+    }
+    else {
+        return nullptr;
+    }
+    if ( VT ) {
+        variables->transpose(*VT);
+    }
+    return variables;
+}
 
-        qDebug()<< "Matrix::distancesMatrix() - input matrix:";
-        //this->printMatrixConsole();
 
-        for (int i = 0 ; i < N ; i++ ) {
-            sum = 0 ;
-            for (int k = i ; k < N ; k++ ) {
-                distTemp = 0;
-                ties = 0;
-                max = 0;
-                for (int j = 0 ; j < N ; j++ ) {
+/*
+ * Writes into e[] the coordinates that pair (i,k) skips and returns their number
+ */
+static inline int similaritySkipped(const int &i, const int &k, const int &N,
+                                    const bool &both, const bool &diagonal,
+                                    int e[4]) {
+    if ( diagonal ) {
+        return 0;
+    }
+    int n = 0;
+    e[n++] = i;
+    if ( k != i ) {
+        e[n++] = k;
+    }
+    if ( both ) {
+        e[n++] = i + N;
+        if ( k != i ) {
+            e[n++] = k + N;
+        }
+    }
+    return n;
+}
 
-//                    qDebug() <<  "(i,j)" << i<< ","<<j << "(k,j)" << k<<","<<j;
 
-                    if (!diagonal && (i==j || k==j)) {
-                        continue;
-                    }
+/*
+ * Calls work(i0, i1) for consecutive row blocks of an N x N result,
+ * concurrently. Each call handles the pairs (i,k), i0 <= i < i1, k >= i.
+ */
+static void similarityForEachBlock(const int &N,
+                                   const std::function<void (const int &i0, const int &i1)> &work) {
+    QVector<int> blocks;
+    for (int i = 0; i < N; i += SIMILARITY_ROW_BLOCK) {
+        blocks << i;
+    }
+    QtConcurrent::blockingMap(blocks, [&](const int &first) {
+        work(first, qMin(N, first + SIMILARITY_ROW_BLOCK));
+    });
+}
 
-                    switch (metric) {
-                    case METRIC_JACCARD_INDEX:
-                        if (item(i,j) == item(k,j)  && (item(i,j) != 0 && item(i,j) != RAND_MAX)) {
-                            distTemp++;
-                        }
-                        if ( ( item(i,j) != 0 && item(i,j) != RAND_MAX ) ||
-                             ( item(k,j) != 0 && item(k,j) != RAND_MAX )) {
-                           ties++;
-                        }
-                        break;
-                    case METRIC_HAMMING_DISTANCE:
-                        if (item(i,j) != item(k,j) ) {
-                            distTemp++;
-                        }
-                        break;
-                    case METRIC_EUCLIDEAN_DISTANCE:
-                        if (item(i,j) == RAND_MAX || item(k,j) == RAND_MAX || distTemp == RAND_MAX) {
-                            distTemp = RAND_MAX;
-                        }
-                        else {
-//                            qDebug() <<  item(i,j) << "-" << item(k,j) <<"^2";
-                            distTemp += ( item(i,j) - item(k,j) )*( item(i,j) - item(k,j) ); //compute (x - y)^2
-                        }
-                        break;
-                    case METRIC_MANHATTAN_DISTANCE:
-                        if (item(i,j) == RAND_MAX || item(k,j) == RAND_MAX || distTemp == RAND_MAX ) {
-                            distTemp = RAND_MAX;
-                        }
-                        else {
-                            distTemp += fabs( item(i,j) - item(k,j) ); //compute |x - y|
-                        }
-                        break;
-                    case METRIC_CHEBYSHEV_MAXIMUM:
-                        if (item(i,j) == RAND_MAX || item(k,j) == RAND_MAX || distTemp == RAND_MAX) {
-                            distTemp = RAND_MAX;
-                            max = RAND_MAX;
-                        }
-                        else {
-                            distTemp =  fabs( item(i,j) - item(k,j) );
-                            max = ( distTemp  > max ) ? distTemp : max;
-                            distTemp = max;
-                        }
-                        break;
-                    default:
-                        break;
-                    }
 
-                }
+/*
+ * Returns true if every element of AM is 0 or 1
+ */
+static bool similarityBinary(Matrix &AM) {
+    const qreal *a = AM.data();
+    const int size = AM.size();
+    for (int i = 0; i < size; ++i) {
+        if ( a[i] != 0 && a[i] != 1 ) {
+            return false;
+        }
+    }
+    return true;
+}
 
-                switch (metric) {
-                case METRIC_JACCARD_INDEX:
-                    if (ties!=0)
-                        distance =  1 -  distTemp/  (  ties ) ;
-                    else
-                        distance = 1;
-                    break;
-                case METRIC_HAMMING_DISTANCE:
-                    distance = distTemp;
-                    break;
-                case METRIC_EUCLIDEAN_DISTANCE:
-                     distance = (distTemp == RAND_MAX) ? distTemp : sqrt(distTemp);
-                     break;
-                case METRIC_MANHATTAN_DISTANCE:
-                    distance = distTemp ;
-                    break;
-                case METRIC_CHEBYSHEV_MAXIMUM:
-                    distance = distTemp ;
-                    break;
-                default:
-                    break;
-                }
 
+/*
+ * Packs the rows of V into W = ceil(L/64) words each, one bit per
+ * nonzero element, and counts the nonzeros of each row
+ */
+static void similarityPack(Matrix &V, std::vector<quint64> &bits,
+                           std::vector<int> &ones, int &W) {
+    const int N = V.rows(), L = V.cols();
+    W = ( L + 63 ) >> 6;
+    bits.assign( (size_t) N * W, 0 );
+    ones.assign(N, 0);
+    for (int i = 0; i < N; ++i) {
+        quint64 *row = bits.data() + (size_t) i * W;
+        for (int j = 0; j < L; ++j) {
+            if ( V[i][j] != 0 ) {
+                row[ j >> 6 ] |= Q_UINT64_C(1) << ( j & 63 );
+                ones[i]++;
+            }
+        }
+    }
+}
 
-//                qDebug() << "distTemp("<<i+1<<","<<k+1<<") =" << distTemp
-//                         << "matchRatio("<<i+1<<","<<k+1<<") =" << distance;
 
-                T->setItem(i,k, distance);
-                T->setItem(k,i, distance);
+/*
+ * Scores a matching measure from its counts over the compared coordinates
+ */
+static inline qreal similarityScore(const int &measure,
+                                    const qreal &matches, const qreal &ties,
+                                    const qreal &magn_i, const qreal &magn_k) {
+    switch (measure) {
+    case METRIC_SIMPLE_MATCHING :
+    case METRIC_JACCARD_INDEX:
+        return matches / ties;
+    case METRIC_HAMMING_DISTANCE:
+        return matches;
+    case METRIC_COSINE_SIMILARITY:
+        // sigma(i,j) = cos(theta) = x * y / |x| * |y|
+        // Note that cosine similarity is undefined when
+        // one or both vertices has degree zero. By convention,
+        // in this case we take sigma(i,j) = 0
+        if ( !magn_i  || ! magn_k ) {
+            return 0;
+        }
+        return matches / sqrt( magn_i  * magn_k );
+    case METRIC_EUCLIDEAN_DISTANCE:
+        return sqrt( qMax( (qreal) 0, matches ) );
+    default:
+        return 0;
+    }
+}
 
-                sum += distance;
-            }
-            //compute mean match value
-            mean[i] = sum / ( N ) ;
 
-        }
 
+/*
+ * Segment kernels of the dissimilarities engine: the squared euclidean,
+ * manhattan and maximum (chebyshev) distance of a[from..to) and b[from..to)
+ */
+static inline qreal distanceSquaredSegment(const qreal *a, const qreal *b,
+                                           const int &from, const int &to) {
+    int j = from;
+    qreal sum = 0;
+#if defined(SOCNETV_GEMM_AVX2)
+    __m256d acc = _mm256_setzero_pd();
+    for (; j + 4 <= to; j += 4) {
+        const __m256d d = _mm256_sub_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j));
+        acc = _mm256_fmadd_pd(d, d, acc);
     }
-    else if (varLocation=="Columns") {
-
-        N = rows() ;
+    qreal lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    sum = ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] );
+#elif defined(SOCNETV_GEMM_NEON)
+    float64x2_t acc = vdupq_n_f64(0);
+    for (; j + 2 <= to; j += 2) {
+        const float64x2_t d = vsubq_f64(vld1q_f64(a + j), vld1q_f64(b + j));
+        acc = vfmaq_f64(acc, d, d);
+    }
+    sum = vaddvq_f64(acc);
+#endif
+    for (; j < to; ++j) {
+        sum += ( a[j] - b[j] ) * ( a[j] - b[j] );
+    }
+    return sum;
+}
 
-        QVector<qreal> mean (N,0); // holds mean values
+static inline qreal distanceManhattanSegment(const qreal *a, const qreal *b,
+                                             const int &from, const int &to) {
+    int j = from;
+    qreal sum = 0;
+#if defined(SOCNETV_GEMM_AVX2)
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    __m256d acc = _mm256_setzero_pd();
+    for (; j + 4 <= to; j += 4) {
+        const __m256d d = _mm256_sub_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j));
+        acc = _mm256_add_pd(acc, _mm256_andnot_pd(signMask, d));
+    }
+    qreal lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    sum = ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] );
+#elif defined(SOCNETV_GEMM_NEON)
+    float64x2_t acc = vdupq_n_f64(0);
+    for (; j + 2 <= to; j += 2) {
+        acc = vaddq_f64(acc, vabdq_f64(vld1q_f64(a + j), vld1q_f64(b + j)));
+    }
+    sum = vaddvq_f64(acc);
+#endif
+    for (; j < to; ++j) {
+        sum += fabs( a[j] - b[j] );
+    }
+    return sum;
+}
 
-        qDebug()<< "Matrix::distancesMatrix() -"
-                <<"input matrix";
-        //printMatrixConsole(true);
+static inline qreal distanceChebyshevSegment(const qreal *a, const qreal *b,
+                                             const int &from, const int &to) {
+    int j = from;
+    qreal max = 0;
+#if defined(SOCNETV_GEMM_AVX2)
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    __m256d acc = _mm256_setzero_pd();
+    for (; j + 4 <= to; j += 4) {
+        const __m256d d = _mm256_sub_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j));
+        acc = _mm256_max_pd(acc, _mm256_andnot_pd(signMask, d));
+    }
+    qreal lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    max = qMax( qMax(lanes[0], lanes[1]), qMax(lanes[2], lanes[3]) );
+#elif defined(SOCNETV_GEMM_NEON)
+    float64x2_t acc = vdupq_n_f64(0);
+    for (; j + 2 <= to; j += 2) {
+        acc = vmaxq_f64(acc, vabdq_f64(vld1q_f64(a + j), vld1q_f64(b + j)));
+    }
+    max = vmaxvq_f64(acc);
+#endif
+    for (; j < to; ++j) {
+        max = qMax( max, (qreal) fabs( a[j] - b[j] ) );
+    }
+    return max;
+}
 
-        for (int i = 0 ; i < N ; i++ ) {
-            sum = 0 ;
-            for (int k = i ; k < N ; k++ ) {
-                distTemp = 0;
-                ties = 0;
-                max = 0;
-                for (int j = 0 ; j < N ; j++ ) {
 
-                    if (!diagonal && (i==j || k==j))
-                        continue;
+/*
+ * The dissimilarities engine behind Matrix::distancesMatrix() and
+ * Matrix::distancesCondensed().
+ *
+ * Computes the distance of every pair (i,k), k >= i, of the rows of V with
+ * the given metric, and hands it to store(i, k, distance). The pairs are
+ * spread over the thread pool like in similarityMatrix(). When the
+ * diagonal is excluded, the coordinates each pair skips split the rows
+ * into at most five contiguous segments, each handled by a vector kernel.
+ * Elements equal to RAND_MAX stand for infinity: any such element among
+ * the compared coordinates makes the euclidean, manhattan and chebyshev
+ * distances infinite (RAND_MAX), while jaccard does not count it as a tie.
+ * Jaccard and hamming on 0/1 data use popcounts of packed rows.
+ */
+static void distancesEngine(Matrix &V, const int &metric,
+                            const bool &both, const bool &diagonal,
+                            const std::function<void (const int &i, const int &k,
+                                                      const qreal &distance)> &store) {
+    const int N = V.rows();
+    const int L = V.cols();
+    const bool infinite = ( metric == METRIC_EUCLIDEAN_DISTANCE ||
+                            metric == METRIC_MANHATTAN_DISTANCE ||
+                            metric == METRIC_CHEBYSHEV_MAXIMUM );
+    const bool binary = ( metric == METRIC_JACCARD_INDEX ||
+                          metric == METRIC_HAMMING_DISTANCE ) && similarityBinary(V);
+
+    // Infinite elements per row
+    std::vector<int> infinities(N, 0);
+    if ( infinite ) {
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < L; ++j) {
+                infinities[i] += ( V[i][j] == RAND_MAX );
+            }
+        }
+    }
 
+    int W = 0;
+    std::vector<quint64> bits;
+    std::vector<int> ones;
+    if ( binary ) {
+        similarityPack(V, bits, ones, W);
+    }
 
-                    switch (metric) {
-                    case METRIC_JACCARD_INDEX:
-                        if (item(j,i) == item(j,k)  && (item(j,i) != 0 && item(j,i) != RAND_MAX)) {
-                            distTemp++;
+    similarityForEachBlock(N, [&](const int &i0, const int &i1) {
+        int e[4];
+        int segFrom[5], segTo[5];
+        for (int k0 = i0; k0 < N; k0 += SIMILARITY_K_BLOCK) {
+            const int k1 = qMin(N, k0 + SIMILARITY_K_BLOCK);
+            for (int i = i0; i < i1; ++i) {
+                const qreal *a = V[i];
+                for (int k = qMax(i, k0); k < k1; ++k) {
+                    const qreal *b = V[k];
+                    const int skipped = similaritySkipped(i, k, N, both, diagonal, e);
+                    qreal distance = 0;
+
+                    if ( binary ) {
+                        const quint64 *x = bits.data() + (size_t) i * W;
+                        const quint64 *y = bits.data() + (size_t) k * W;
+                        int matches = 0, ties = 0, differ = 0;
+                        for (int w = 0; w < W; ++w) {
+                            matches += qPopulationCount( x[w] & y[w] );
+                            ties += qPopulationCount( x[w] | y[w] );
+                            differ += qPopulationCount( x[w] ^ y[w] );
                         }
-                        if ( ( item(j,i) != 0 && item(j,i) != RAND_MAX ) ||
-                             ( item(j,k) != 0 && item(j,k) != RAND_MAX )) {
-                           ties++;
+                        for (int s = 0; s < skipped; ++s) {
+                            const bool p = a[e[s]] != 0, q = b[e[s]] != 0;
+                            matches -= ( p && q );
+                            ties -= ( p || q );
+                            differ -= ( p != q );
                         }
-                        break;
-                    case METRIC_HAMMING_DISTANCE:
-                        if (item(j,i) != item(j,k) ) {
-                            distTemp++;
-                        }
-                        break;
-                    case METRIC_EUCLIDEAN_DISTANCE:
-                        if (item(j,i) == RAND_MAX || item(j,k) == RAND_MAX || distTemp == RAND_MAX) {
-                            distTemp = RAND_MAX;
+                        if ( metric == METRIC_JACCARD_INDEX ) {
+                            distance = ( ties != 0 ) ? 1 - (qreal) matches / ties : 1;
                         }
                         else {
-                            distTemp += ( item(j,i) - item(j,k) )*( item(j,i) - item(j,k) ); //compute (x - y)^2
+                            distance = differ;
                         }
-                        break;
-                    case METRIC_MANHATTAN_DISTANCE:
-                        if (item(j,i) == RAND_MAX || item(j,k) == RAND_MAX || distTemp == RAND_MAX ) {
-                            distTemp = RAND_MAX;
+                        store(i, k, distance);
+                        continue;
+                    }
+
+                    if ( infinite ) {
+                        int inf_i = infinities[i], inf_k = infinities[k];
+                        for (int s = 0; s < skipped; ++s) {
+                            inf_i -= ( a[e[s]] == RAND_MAX );
+                            inf_k -= ( b[e[s]] == RAND_MAX );
                         }
-                        else {
-                            distTemp += fabs( item(j,i) - item(j,k) ); //compute |x - y|
+                        if ( inf_i > 0 || inf_k > 0 ) {
+                            store(i, k, RAND_MAX);
+                            continue;
                         }
-                        break;
-                    case METRIC_CHEBYSHEV_MAXIMUM:
-                        if (item(j,i) == RAND_MAX || item(j,k) == RAND_MAX || distTemp == RAND_MAX) {
-                            distTemp = RAND_MAX;
-                            max = RAND_MAX;
+                    }
+
+                    // The compared coordinates, as contiguous segments
+                    std::sort(e, e + skipped);
+                    int segments = 0, from = 0;
+                    for (int s = 0; s < skipped; ++s) {
+                        if ( e[s] > from ) {
+                            segFrom[segments] = from;
+                            segTo[segments++] = e[s];
                         }
-                        else {
-                            distTemp =  fabs( item(j,i) - item(j,k) );
-                            max = ( distTemp  > max ) ? distTemp : max;
-                            distTemp = max;
+                        from = e[s] + 1;
+                    }
+                    if ( from < L ) {
+                        segFrom[segments] = from;
+                        segTo[segments++] = L;
+                    }
+
+                    int matches = 0, ties = 0;
+                    for (int g = 0; g < segments; ++g) {
+                        switch (metric) {
+                        case METRIC_EUCLIDEAN_DISTANCE:
+                            distance += distanceSquaredSegment(a, b, segFrom[g], segTo[g]);
+                            break;
+                        case METRIC_MANHATTAN_DISTANCE:
+                            distance += distanceManhattanSegment(a, b, segFrom[g], segTo[g]);
+                            break;
+                        case METRIC_CHEBYSHEV_MAXIMUM:
+                            distance = qMax( distance,
+                                             distanceChebyshevSegment(a, b, segFrom[g], segTo[g]) );
+                            break;
+                        case METRIC_HAMMING_DISTANCE:
+                            for (int j = segFrom[g]; j < segTo[g]; ++j) {
+                                matches += ( a[j] != b[j] );
+                            }
+                            break;
+                        case METRIC_JACCARD_INDEX:
+                            for (int j = segFrom[g]; j < segTo[g]; ++j) {
+                                const bool p = ( a[j] != 0 ) & ( a[j] != RAND_MAX );
+                                const bool q = ( b[j] != 0 ) & ( b[j] != RAND_MAX );
+                                matches += ( a[j] == b[j] ) & p;
+                                ties += p | q;
+                            }
+                            break;
+                        default:
+                            break;
                         }
+                    }
+
+                    switch (metric) {
+                    case METRIC_JACCARD_INDEX:
+                        distance = ( ties != 0 ) ? 1 - (qreal) matches / ties : 1;
+                        break;
+                    case METRIC_HAMMING_DISTANCE:
+                        distance = matches;
+                        break;
+                    case METRIC_EUCLIDEAN_DISTANCE:
+                        distance = sqrt(distance);
                         break;
                     default:
                         break;
                     }
-                }
 
-                switch (metric) {
-                case METRIC_JACCARD_INDEX:
-                    if (ties!=0)
-                        distance =  1 -  distTemp/  (  ties ) ;
-                    else
-                        distance = 1;
-                    break;
-                case METRIC_HAMMING_DISTANCE:
-                    distance = distTemp;
-                    break;
-                case METRIC_EUCLIDEAN_DISTANCE:
-                     distance = (distTemp == RAND_MAX) ? distTemp : sqrt(distTemp);
-                     break;
-                case METRIC_MANHATTAN_DISTANCE:
-                    distance = distTemp ;
-                    break;
-                case METRIC_CHEBYSHEV_MAXIMUM:
-                    distance = distTemp ;
-                    break;
-                default:
-                    break;
+                    store(i, k, distance);
                 }
+            }
+        }
+    });
+}
 
 
-//                qDebug() << "distTemp("<<i+1<<","<<k+1<<") =" << distTemp
 
-//                         << "distance("<<i+1<<","<<k+1<<") =" << distance;
+/**
+ * @brief Computes the dissimilarities matrix of the variables (rows, columns, both)
+ * of this matrix using the user defined metric
+ * Only the upper triangle is computed, concurrently, and mirrored.
+ * @param metric
+ * @param varLocation
+ * @param diagonal
+ * @param considerWeights
+ * @return
+ */
+Matrix Matrix::distancesMatrix(const int &metric,
+                        const QString varLocation,
+                        const bool &diagonal,
+                        const bool &considerWeights) {
+    Q_UNUSED(considerWeights);
 
-                T->setItem(i,k, distance);
-                T->setItem(k,i, distance);
+    qDebug()<< "Matrix::distancesMatrix() -"
+            <<"metric"<< metric
+            << "varLocation"<< varLocation
+            << "diagonal"<<diagonal;
 
-                sum += distance;
-            }
-            //compute mean match value
-            mean[i] = sum / ( N ) ;
+    Matrix T(cols(), rows());
 
-        }
+    Matrix own;
+    Matrix *variables = similarityVariables(*this, varLocation, own, nullptr);
 
+    if ( ! variables ) {
+        return T;
     }
-    else if (varLocation=="Both") {
-        Matrix CM;
-        N = rows() ;
-        int M = N * 2; // CM will have double rows
 
-        CM.zeroMatrix(M,N);
+    distancesEngine(*variables, metric, ( varLocation == "Both" ), diagonal,
+                    [&T](const int &i, const int &k, const qreal &distance) {
+                        T[i][k] = distance;
+                        T[k][i] = distance;
+                    });
 
-        QVector<qreal> mean (N,0); // holds mean values
+    qDebug() << "Matrix::distancesMatrix() - FINISHED - Returning matrix:";
+    //T.printMatrixConsole();
+    return T;
+}
 
-        //create augmented matrix (concatenated rows and columns) from input matrix
-        for (int i = 0 ; i < N  ; i++ ) {
-            for (int j = 0 ; j < N  ; j++ ) {
-                CM.setItem(j,i, item(i,j));
-                CM.setItem(j + N,i, item(j,i));
-            }
-        }
 
-        qDebug()<< "Matrix::distancesMatrix() -"
-                <<"input matrix";
-        //CM.printMatrixConsole(true);
 
+/**
+ * @brief Computes the dissimilarities of the variables (rows, columns, both)
+ * of this matrix, like distancesMatrix(), in condensed form: the strictly
+ * lower triangle D(i,j), i > j, row by row at D[i*(i-1)/2 + j], and the
+ * self-distances D(i,i) in self.
+ * Used by the hierarchical clustering, so that it needs no N x N copy.
+ * @param metric
+ * @param varLocation
+ * @param diagonal
+ * @param D
+ * @param self
+ * @return false if there is not enough memory or varLocation is unknown
+ */
+bool Matrix::distancesCondensed(const int &metric,
+                                const QString &varLocation,
+                                const bool &diagonal,
+                                std::vector<qreal> &D,
+                                std::vector<qreal> &self) {
 
-        for (int i = 0 ; i < N ; i++ ) {
+    qDebug()<< "Matrix::distancesCondensed() -"
+            <<"metric"<< metric
+            << "varLocation"<< varLocation
+            << "diagonal"<<diagonal;
 
-            for (int k = i ; k < N ; k++ ) {
+    const int N = rows();
 
-                distTemp = 0;
-                ties = 0;
-                max = 0;
-                for (int j = 0 ; j < M ; j++ ) {
+    try {
+        D.assign( (size_t) N * ( N - 1 ) / 2, 0 );
+        self.assign(N, 0);
+    }
+    catch (const std::bad_alloc &) {
+        qDebug() << "Matrix::distancesCondensed() - not enough memory";
+        return false;
+    }
 
-                    if (!diagonal) {
-                        if ( (i==j || k==j ))
-                            continue;
-                        if ( j>=N && ( (i+N)==j || (k+N)==j ))
-                            continue;
-                    }
+    Matrix own;
+    Matrix *variables = similarityVariables(*this, varLocation, own, nullptr);
 
-                    switch (metric) {
-                    case METRIC_JACCARD_INDEX:
-                        if (CM.item(j,i) == CM.item(j,k)  && (CM.item(j,i) != 0 && CM.item(j,i) != RAND_MAX)) {
-                            distTemp++;
-                        }
-                        if ( ( CM.item(j,i) != 0 && CM.item(j,i) != RAND_MAX ) ||
-                             ( CM.item(j,k) != 0 && CM.item(j,k) != RAND_MAX )) {
-                           ties++;
-                        }
-                        break;
-                    case METRIC_HAMMING_DISTANCE:
-                        if (  CM.item(j,i) != CM.item(j,k) ) {
-                            distTemp++;
-                        }
-                        break;
-                    case METRIC_EUCLIDEAN_DISTANCE:
-                        if ( CM.item(j,i) == RAND_MAX || CM.item(j,k) == RAND_MAX || distTemp == RAND_MAX) {
-                            distTemp = RAND_MAX;
-                        }
-                        else {
-                            distTemp += ( CM.item(j,i) - CM.item(j,k) )*( CM.item(j,i) - CM.item(j,k) ); //compute (x - y)^2
-                        }
-                        break;
-                    case METRIC_MANHATTAN_DISTANCE:
-                        if ( CM.item(j,i) == RAND_MAX || CM.item(j,k) == RAND_MAX || distTemp == RAND_MAX ) {
-                            distTemp = RAND_MAX;
-                        }
-                        else {
-                            distTemp += fabs( CM.item(j,i) - CM.item(j,k) ); //compute |x - y|
-                        }
-                        break;
-                    case METRIC_CHEBYSHEV_MAXIMUM:
-                        if ( CM.item(j,i) == RAND_MAX || CM.item(j,k) == RAND_MAX || distTemp == RAND_MAX) {
-                            distTemp = RAND_MAX;
-                            max = RAND_MAX;
+    if ( ! variables ) {
+        return false;
+    }
+
+    distancesEngine(*variables, metric, ( varLocation == "Both" ), diagonal,
+                    [&D, &self](const int &i, const int &k, const qreal &distance) {
+                        if ( k == i ) {
+                            self[i] = distance;
                         }
                         else {
-                            distTemp =  fabs( CM.item(j,i) - CM.item(j,k) );
-                            max = ( distTemp  > max ) ? distTemp : max;
-                            distTemp = max;
+                            D[ (size_t) k * ( k - 1 ) / 2 + i ] = distance;
                         }
-                        break;
-                    default:
-                        break;
-                    }
-
-                }
-
-
-                switch (metric) {
-                case METRIC_JACCARD_INDEX:
-                    if (ties!=0)
-                        distance =  1 -  distTemp/  (  ties ) ;
-                    else
-                        distance = 1;
-                    break;
-                case METRIC_HAMMING_DISTANCE:
-                    distance = distTemp;
-                    break;
-                case METRIC_EUCLIDEAN_DISTANCE:
-                     distance = (distTemp == RAND_MAX) ? distTemp : sqrt(distTemp);
-                     break;
-                case METRIC_MANHATTAN_DISTANCE:
-                    distance = distTemp ;
-                    break;
-                case METRIC_CHEBYSHEV_MAXIMUM:
-                    distance = distTemp ;
-                    break;
-                default:
-                    break;
-                }
-
-
+                    });
 
-//                qDebug() << "distTemp("<<i+1<<","<<k+1<<") =" << distTemp
-
-//                         << "matchRatio("<<i+1<<","<<k+1<<") =" << distance;
+    return true;
+}
 
-                T->setItem(i,k, distance);
-                T->setItem(k,i, distance);
 
-                sum += distance;
-
-            }
-            //compute mean match value
-            mean[i] = sum / ( N ) ;
 
+/**
+ * @brief Makes this the symmetric matrix of the condensed D and self,
+ * as returned by distancesCondensed()
+ * @param D
+ * @param self
+ */
+void Matrix::fromCondensed(const std::vector<qreal> &D,
+                           const std::vector<qreal> &self) {
+    const int N = self.size();
+    resize(N, N);
+    for (int i = 0; i < N; ++i) {
+        const qreal *row = D.data() + (size_t) i * ( i - 1 ) / 2;
+        for (int j = 0; j < i; ++j) {
+            (*this)[i][j] = row[j];
+            (*this)[j][i] = row[j];
         }
+        (*this)[i][i] = self[i];
     }
-    else {
-
-    }
-    qDebug() << "Matrix::distancesMatrix() - FINISHED - Returning matrix:";
-    //T->printMatrixConsole();
-    return *T;
 }
 
 
@@ -1740,6 +2263,8 @@ Matrix& Matrix::distancesMatrix(const int &metric,
  * @brief  Computes the pair-wise matching score of the rows, columns
  * or both of the given matrix AM, based on the given matching measure
  * and returns the similarity matrix.
+ * Only the upper triangle is computed, concurrently; binary data use
+ * popcounts and cosine/euclidean distances use the Gram matrix.
  * @param AM Matrix
  * @return Matrix nxn with matching scores for every pair of rows/columns of AM
  */
@@ -1756,331 +2281,184 @@ Matrix& Matrix::similarityMatrix(Matrix &AM,
             <<"measure"<< measure
             << "varLocation"<< varLocation;
 
-    int N = 0;
-    qreal sum = 0;
-    qreal matchRatio = 0;
-    qreal matches = 0;
-    qreal ties = 0;
-    qreal magn_i=0, magn_k=0;
-    if (varLocation=="Rows") {
-
-        N = AM.rows() ;
-
-        this->zeroMatrix(N,N);
+    const int N = AM.rows();
+    const bool both = ( varLocation == "Both" );
+    const bool binary = similarityBinary(AM);
+    const bool gram = ! binary && ( measure == METRIC_COSINE_SIMILARITY ||
+                                    measure == METRIC_EUCLIDEAN_DISTANCE );
 
-        QVector<qreal> mean (N,0); // holds mean values
+    Matrix own, VT;
+    Matrix *variables = similarityVariables(AM, varLocation, own, gram ? &VT : nullptr);
 
-        qDebug()<< "Matrix::similarityMatrix() -"
-                <<"input matrix";
-        //AM.printMatrixConsole(true);
-
-        for (int i = 0 ; i < N ; i++ ) {
-            sum = 0 ;
-            for (int k = i ; k < N ; k++ ) {
-                matches = 0;
-                ties = 0;
-                magn_i=0; magn_k=0;
-                for (int j = 0 ; j < N ; j++ ) {
+    if ( ! variables ) {
+        return *this;
+    }
 
-                    if (!diagonal && (i==j || k==j))
-                        continue;
+    Matrix &V = *variables;
+    const int L = V.cols();
 
-                    switch (measure) {
-                    case METRIC_SIMPLE_MATCHING :
-                        if (AM.item(i,j) == AM.item(k,j) ) {
-                            matches++;
-                        }
-                        ties++;
-                        break;
-                    case METRIC_JACCARD_INDEX:
-                        if (AM.item(i,j) == AM.item(k,j)  && AM.item(i,j) != 0) {
-                            matches++;
+    qDebug()<< "Matrix::similarityMatrix() -"
+            << "variables" << N << "length" << L
+            << "binary" << binary << "gram" << gram;
+
+    this->zeroMatrix(N,N);
+
+    Matrix &S = *this;
+
+    if ( binary ) {
+
+        // Bit-packed rows of V
+        int W = 0;
+        std::vector<quint64> bits;
+        std::vector<int> ones;
+        similarityPack(V, bits, ones, W);
+
+        similarityForEachBlock(N, [&](const int &i0, const int &i1) {
+            int e[4];
+            for (int k0 = i0; k0 < N; k0 += SIMILARITY_K_BLOCK) {
+                const int k1 = qMin(N, k0 + SIMILARITY_K_BLOCK);
+                for (int i = i0; i < i1; ++i) {
+                    const quint64 *a = bits.data() + (size_t) i * W;
+                    for (int k = qMax(i, k0); k < k1; ++k) {
+                        const quint64 *b = bits.data() + (size_t) k * W;
+                        int both11 = 0, any1 = 0, differ = 0;
+                        for (int w = 0; w < W; ++w) {
+                            both11 += qPopulationCount( a[w] & b[w] );
+                            any1 += qPopulationCount( a[w] | b[w] );
+                            differ += qPopulationCount( a[w] ^ b[w] );
                         }
-                        if (AM.item(i,j) != 0  || AM.item(k,j)  ) {
-                           ties++;
+                        int ones_i = ones[i], ones_k = ones[k];
+                        const int skipped = similaritySkipped(i, k, N, both, diagonal, e);
+                        for (int s = 0; s < skipped; ++s) {
+                            const bool x = V[i][e[s]] != 0, y = V[k][e[s]] != 0;
+                            both11 -= ( x && y );
+                            any1 -= ( x || y );
+                            differ -= ( x != y );
+                            ones_i -= x;
+                            ones_k -= y;
                         }
-                        break;
-                    case METRIC_HAMMING_DISTANCE:
-                        if (AM.item(i,j) != AM.item(k,j) ) {
-                            matches++;
+                        const int compared = L - skipped;
+                        qreal matchRatio = 0;
+                        switch (measure) {
+                        case METRIC_SIMPLE_MATCHING :
+                            matchRatio = similarityScore(measure, compared - differ, compared, 0, 0);
+                            break;
+                        case METRIC_JACCARD_INDEX:
+                            matchRatio = similarityScore(measure, both11, any1, 0, 0);
+                            break;
+                        case METRIC_HAMMING_DISTANCE:
+                            matchRatio = similarityScore(measure, differ, 0, 0, 0);
+                            break;
+                        case METRIC_COSINE_SIMILARITY:
+                            matchRatio = similarityScore(measure, both11, 0, ones_i, ones_k);
+                            break;
+                        case METRIC_EUCLIDEAN_DISTANCE:
+                            matchRatio = similarityScore(measure, differ, 0, 0, 0);
+                            break;
+                        default:
+                            break;
                         }
-                        break;
-                    case METRIC_COSINE_SIMILARITY:
-                        matches += AM.item(i,j) * AM.item(k,j); //compute x * y
-                        magn_i  += AM.item(i,j) * AM.item(i,j); //compute |x|^2
-                        magn_k  += AM.item(k,j) * AM.item(k,j); //compute |y|^2
-                        break;
-                    case METRIC_EUCLIDEAN_DISTANCE:
-                        matches += ( AM.item(i,j) - AM.item(k,j) )*( AM.item(i,j) - AM.item(k,j) ); //compute (x - y)^2
-                        break;
-                    default:
-                        break;
-                    }
-
-                }
-
-                switch (measure) {
-                case METRIC_SIMPLE_MATCHING :
-                    matchRatio=   matches/  ( ( ties  ) ) ;
-                    break;
-                case METRIC_JACCARD_INDEX:
-                    matchRatio=   matches/  ( ( ties ) ) ;
-
-                    break;
-                case METRIC_HAMMING_DISTANCE:
-                    matchRatio = matches;
-                    break;
-                case METRIC_COSINE_SIMILARITY:
-                    // sigma(i,j) = cos(theta) = x * y / |x| * |y|
-                    if ( !magn_i  || ! magn_k ) {
-                        // Note that cosine similarity is undefined when
-                        // one or both vertices has degree zero. By convention,
-                        // in this case we take sigma(i,j) = 0
-                        matchRatio = 0;
+                        S[i][k] = matchRatio;
+                        S[k][i] = matchRatio;
                     }
-                    else
-                        matchRatio = matches / sqrt( magn_i  * magn_k );
-                    break;
-                case METRIC_EUCLIDEAN_DISTANCE:
-                    matchRatio = sqrt(matches);
-                    break;
-                default:
-                    break;
                 }
-
-
-                qDebug() << "matches("<<i+1<<","<<k+1<<") =" << matches
-
-                         << "matchRatio("<<i+1<<","<<k+1<<") =" << matchRatio;
-                setItem(i,k, matchRatio);
-                setItem(k,i, matchRatio);
-
-                sum += matchRatio;
             }
-            //compute mean match value
-            mean[i] = sum / ( N ) ;
-
-        }
+        });
 
     }
-    else if (varLocation=="Columns") {
-
-        N = AM.rows() ;
+    else if ( gram ) {
 
-        this->zeroMatrix(N,N);
+        // S = V V^T, then corrections for the skipped coordinates
+        gemm(S, V, VT, true);
 
-        QVector<qreal> mean (N,0); // holds mean values
-
-        qDebug()<< "Matrix::similarityMatrix() -"
-                <<"input matrix";
-        //AM.printMatrixConsole(true);
-
-        for (int i = 0 ; i < N ; i++ ) {
-            sum = 0 ;
-            for (int k = i ; k < N ; k++ ) {
-                matches = 0;
-                ties = 0;
-                magn_i=0; magn_k=0;
-                for (int j = 0 ; j < N ; j++ ) {
-
-                    if (!diagonal && (i==j || k==j))
-                        continue;
-
-                    switch (measure) {
-                    case METRIC_SIMPLE_MATCHING :
-                        if (AM.item(j,i) == AM.item(j,k) ) {
-                            matches++;
-                        }
-                        ties++;
-                        break;
-                    case METRIC_JACCARD_INDEX:
-                        if (AM.item(j,i) == AM.item(j,k)  && AM.item(j,i) != 0) {
-                            matches++;
-                        }
-                        if (AM.item(j,i) != 0  || AM.item(j,k) !=0 ) {
-                           ties++;
-                        }
+        QVector<qreal> squares(N);
+        QVector<int> nonZeros(N, 0);
+        for (int i = 0; i < N; ++i) {
+            squares[i] = S[i][i];
+            for (int j = 0; j < L; ++j) {
+                nonZeros[i] += ( V[i][j] != 0 );
+            }
+        }
 
-                        break;
-                    case METRIC_HAMMING_DISTANCE:
-                        if (AM.item(j,i) != AM.item(j,k) ) {
-                            matches++;
-                        }
-                        break;
-                    case METRIC_COSINE_SIMILARITY:
-                        matches += AM.item(j,i) * AM.item(j,k); //compute x * y
-                        magn_i  += AM.item(j,i) * AM.item(j,i); //compute |x|^2
-                        magn_k  += AM.item(j,k) * AM.item(j,k); //compute |y|^2
-                        break;
-                    case METRIC_EUCLIDEAN_DISTANCE:
-                        matches += ( AM.item(j,i) - AM.item(j,k) )*( AM.item(j,i) - AM.item(j,k) ); //compute (x - y)^2
-                        break;
-                    default:
-                        break;
+        similarityForEachBlock(N, [&](const int &i0, const int &i1) {
+            int e[4];
+            for (int i = i0; i < i1; ++i) {
+                for (int k = i; k < N; ++k) {
+                    qreal dot = S[i][k], magn_i = squares[i], magn_k = squares[k];
+                    // the nonzeros are counted exactly, so that the convention
+                    // for zero vectors does not depend on rounding errors
+                    int nz_i = nonZeros[i], nz_k = nonZeros[k];
+                    const int skipped = similaritySkipped(i, k, N, both, diagonal, e);
+                    for (int s = 0; s < skipped; ++s) {
+                        const qreal x = V[i][e[s]], y = V[k][e[s]];
+                        dot -= x * y;
+                        magn_i -= x * x;
+                        magn_k -= y * y;
+                        nz_i -= ( x != 0 );
+                        nz_k -= ( y != 0 );
                     }
-
-
-                }
-
-                switch (measure) {
-                case METRIC_SIMPLE_MATCHING :
-                    matchRatio=   matches/  ( ( ties  ) ) ;
-                    break;
-                case METRIC_JACCARD_INDEX:
-                    matchRatio=   matches/  ( ( ties ) ) ;
-
-                    break;
-                case METRIC_HAMMING_DISTANCE:
-                    matchRatio = matches;
-                    break;
-                case METRIC_COSINE_SIMILARITY:
-                    // sigma(i,j) = cos(theta) = x * y / |x| * |y|
-                    if ( !magn_i  || ! magn_k ) {
-                        // Note that cosine similarity is undefined when
-                        // one or both vertices has degree zero. By convention,
-                        // in this case we take sigma(i,j) = 0
-                        matchRatio = 0;
+                    qreal matchRatio = 0;
+                    if ( measure == METRIC_COSINE_SIMILARITY ) {
+                        matchRatio = similarityScore(measure, dot, 0,
+                                                     nz_i ? magn_i : 0,
+                                                     nz_k ? magn_k : 0);
+                    }
+                    else {
+                        // (x - y)^2 = |x|^2 + |y|^2 - 2 x * y
+                        matchRatio = similarityScore(measure, magn_i + magn_k - 2 * dot, 0, 0, 0);
                     }
-                    else
-                        matchRatio = matches / sqrt( magn_i  * magn_k );
-                    break;
-                case METRIC_EUCLIDEAN_DISTANCE:
-                    matchRatio = sqrt(matches);
-                    break;
-                default:
-                    break;
+                    S[i][k] = matchRatio;
+                    S[k][i] = matchRatio;
                 }
-                qDebug() << "matches("<<i+1<<","<<k+1<<") =" << matches
-
-                         << "matchRatio("<<i+1<<","<<k+1<<") =" << matchRatio;
-                setItem(i,k, matchRatio);
-                setItem(k,i, matchRatio);
-
-                sum += matchRatio;
             }
-            //compute mean match value
-            mean[i] = sum / ( N ) ;
-
-        }
+        });
 
     }
-    else if (varLocation=="Both") {
-        Matrix CM;
-        N = AM.rows() ;
-        int M = N * 2; // CM will have double rows
-
-        this->zeroMatrix(N,N);
-        CM.zeroMatrix(M,N);
-
-        QVector<qreal> mean (N,0); // holds mean values
-
-
-        //create augmented matrix (concatenated rows and columns) from input matrix
-        for (int i = 0 ; i < N  ; i++ ) {
-            for (int j = 0 ; j < N  ; j++ ) {
-                CM.setItem(j,i, AM.item(i,j));
-                CM.setItem(j + N,i, AM.item(j,i));
-            }
-        }
-        qDebug()<< "Matrix::similarityMatrix() -"
-                <<"input matrix";
-        //CM.printMatrixConsole(true);
-
-
-        for (int i = 0 ; i < N ; i++ ) {
-
-            for (int k = i ; k < N ; k++ ) {
-
-                matches = 0;
-                ties = 0;
-                magn_i=0; magn_k=0;
-                for (int j = 0 ; j < M ; j++ ) {
+    else {
 
-                    if (!diagonal) {
-                        if ( (i==j || k==j ))
-                        continue;
-                        if ( j>=N && ( (i+N)==j || (k+N)==j ))
-                        continue;
-                    }
-                    switch (measure) {
-                    case METRIC_SIMPLE_MATCHING :
-                        if (CM.item(j,i) == CM.item(j,k) ) {
-                            matches++;
-                        }
-                        ties++;
-                        break;
-                    case METRIC_JACCARD_INDEX:
-                        if (CM.item(j,i) == CM.item(j,k)  && CM.item(j,i) != 0) {
-                            matches++;
+        // Counts over contiguous rows, tiled over partner rows
+        similarityForEachBlock(N, [&](const int &i0, const int &i1) {
+            int e[4];
+            for (int k0 = i0; k0 < N; k0 += SIMILARITY_K_BLOCK) {
+                const int k1 = qMin(N, k0 + SIMILARITY_K_BLOCK);
+                for (int i = i0; i < i1; ++i) {
+                    const qreal *a = V[i];
+                    for (int k = qMax(i, k0); k < k1; ++k) {
+                        const qreal *b = V[k];
+                        int equal = 0, equalNonZero = 0, anyNonZero = 0;
+                        for (int j = 0; j < L; ++j) {
+                            equal += ( a[j] == b[j] );
+                            equalNonZero += ( a[j] == b[j] ) & ( a[j] != 0 );
+                            anyNonZero += ( a[j] != 0 ) | ( b[j] != 0 );
                         }
-                        if (CM.item(j,i) != 0  || CM.item(j,k) !=0 ) {
-                           ties++;
+                        const int skipped = similaritySkipped(i, k, N, both, diagonal, e);
+                        for (int s = 0; s < skipped; ++s) {
+                            const qreal x = a[e[s]], y = b[e[s]];
+                            equal -= ( x == y );
+                            equalNonZero -= ( x == y && x != 0 );
+                            anyNonZero -= ( x != 0 || y != 0 );
                         }
-                        break;
-                    case METRIC_HAMMING_DISTANCE:
-                        if (CM.item(j,i) != CM.item(j,k) ) {
-                            matches++;
+                        const int compared = L - skipped;
+                        qreal matchRatio = 0;
+                        switch (measure) {
+                        case METRIC_SIMPLE_MATCHING :
+                            matchRatio = similarityScore(measure, equal, compared, 0, 0);
+                            break;
+                        case METRIC_JACCARD_INDEX:
+                            matchRatio = similarityScore(measure, equalNonZero, anyNonZero, 0, 0);
+                            break;
+                        case METRIC_HAMMING_DISTANCE:
+                            matchRatio = similarityScore(measure, compared - equal, 0, 0, 0);
+                            break;
+                        default:
+                            break;
                         }
-                        break;
-                    case METRIC_COSINE_SIMILARITY:
-                        matches += CM.item(j,i) * CM.item(j,k); //compute x * y
-                        magn_i  += CM.item(j,i) * CM.item(j,i); //compute |x|^2
-                        magn_k  += CM.item(j,k) * CM.item(j,k); //compute |y|^2
-                        break;
-                    case METRIC_EUCLIDEAN_DISTANCE:
-                        matches += ( CM.item(j,i) - CM.item(j,k) )*( CM.item(j,i) - CM.item(j,k) ); //compute (x - y)^2
-                        break;
-                    default:
-                        break;
-                    }
-
-
-                }
-
-                switch (measure) {
-                case METRIC_SIMPLE_MATCHING :
-                    matchRatio=   matches/  ( ( ties  ) ) ;
-                    break;
-                case METRIC_JACCARD_INDEX:
-                    matchRatio=   matches/  ( ( ties ) ) ;
-
-                    break;
-                case METRIC_HAMMING_DISTANCE:
-                    matchRatio = matches;
-                    break;
-                case METRIC_COSINE_SIMILARITY:
-                    // sigma(i,j) = cos(theta) = x * y / |x| * |y|
-                    if ( !magn_i  || ! magn_k ) {
-                        // Note that cosine similarity is undefined when
-                        // one or both vertices has degree zero. By convention,
-                        // in this case we take sigma(i,j) = 0
-                        matchRatio = 0;
+                        S[i][k] = matchRatio;
+                        S[k][i] = matchRatio;
                     }
-                    else
-                        matchRatio = matches / sqrt( magn_i  * magn_k );
-                    break;
-                case METRIC_EUCLIDEAN_DISTANCE:
-                    matchRatio = sqrt(matches);
-                    break;
-                default:
-                    break;
                 }
-
-                qDebug() << "matches("<<i+1<<","<<k+1<<") =" << matches
-
-                         << "matchRatio("<<i+1<<","<<k+1<<") =" << matchRatio;
-                setItem(i,k, matchRatio);
-                setItem(k,i, matchRatio);
-
-                sum += matchRatio;
-
             }
-            //compute mean match value
-            mean[i] = sum / ( N ) ;
-
-        }
-    }
-    else {
+        });
 
     }
 
@@ -2094,6 +2472,8 @@ Matrix& Matrix::similarityMatrix(Matrix &AM,
 /**
  * @brief  Computes the Pearson Correlation Coefficient of the rows or the columns
  * of the given matrix AM
+ * The covariances of all pairs come from the Gram matrix V V^T and the
+ * sums of each variable, corrected for the skipped coordinates of each pair.
  * @param AM Matrix
  * @return Matrix nxn with PPC values for every pair of rows/columns of AM
  */
@@ -2103,271 +2483,91 @@ Matrix& Matrix::pearsonCorrelationCoefficients(Matrix &AM,
     qDebug()<< "Matrix::pearsonCorrelationCoefficients() -"
             << "varLocation"<< varLocation;
 
-    int N = 0;
-    qreal sumi = 0;
-    qreal sumk = 0;
-    qreal varianceTimesNi = 0; // = sqrDeviationsFromMean
-    qreal varianceTimesNk = 0; // = sqrDeviationsFromMean
-    qreal covariance = 0;
-    qreal pcc = 0;
-
-
-    if (varLocation=="Rows") {
-
-        N = AM.rows() ;
-
-        this->zeroMatrix(N,N);
-
-        QVector<qreal> mean (N,0); // holds mean values
-        QVector<qreal> sigma(N,0);
-        qDebug()<< "Matrix::pearsonCorrelationCoefficients() -"
-                <<"input matrix";
-        //AM.printMatrixConsole(true);
-
-        for (int i = 0 ; i < N ; i++ ) {
-
-            for (int k = i ; k < N ; k++ ) {
-
-                qDebug() << "comparing rows i"<<i+1<<"k"<<k+1;
-
-                // compute mean and variance  values
-                sumi = 0;
-                sumk = 0;
-                for (int j = 0 ; j < N ; j++ ) {
-                    if (!diagonal && ( i==j || k==j ) )
-                        continue;
-                    sumi += AM.item(i,j);
-                    sumk += AM.item(k,j);
-                }
-                mean[i] = sumi / ( (diagonal) ? (qreal) N : (qreal) (N-2) ) ;
-                mean[k] = sumk / ( (diagonal) ? (qreal) N : (qreal) (N-2) ) ;
-                varianceTimesNi = 0;
-                varianceTimesNk = 0;
-                for (int j = 0 ; j < N ; j++ ) {
-                    if (!diagonal && ( i==j || k==j ) )
-                        continue;
-                    varianceTimesNi +=  ( AM.item(i,j)  - mean[i] ) *  ( AM.item(i,j)  - mean[i] );
-                    varianceTimesNk +=  ( AM.item(k,j)  - mean[k] ) *  ( AM.item(k,j)  - mean[k] );
-                }
-                sigma[i] = sqrt (varianceTimesNi); //actually this is sigma * sqrt (N)
-                sigma[k] = sqrt (varianceTimesNk); //actually this is sigma * sqrt (N)
-
-
-                covariance = 0;
-
-                for (int j = 0 ; j < N ; j++ ) {
-
-                    qDebug() << "AM.item(i,j)=AM.item("<<i+1<<","<<j+1<<") = "<<AM.item(i,j)
-                             << " mean(i)=mean("<<i+1<<") = "<<mean[i]
-                                << "AM.item(k,j)=AM.item("<<k+1<<","<<j+1<<") = "<<AM.item(k,j)
-                                << " mean(k)=mean("<<k+1<<") = "<<mean[k];
-
-                    if (!diagonal && (i==j ) ) {
-                        qDebug() << "skipping because i"<<i+1<<"k"<<k+1 <<"j"<<j+1;
-                        continue;
-                    }
-                    if (!diagonal && (k==j) ) {
-                        qDebug() << "skipping because i"<<i+1<<"k"<<k+1 <<"j"<<j+1;
-                        continue;
-                    }
-                    else
-                        covariance  +=  ( AM.item(i,j)  - mean[i] ) * ( AM.item(k,j)  - mean[k] ) ;
-                }
-
-
-                if ( ( sigma[i] != 0 ) && ( sigma[k] != 0  ) ) {
-                    pcc =   covariance   /  (( sigma[i] ) * ( sigma[k] )) ;
-                }
-                else {
-                    pcc = 0;
-                }
-
+    const int N = AM.rows();
+    const bool both = ( varLocation == "Both" );
 
-                qDebug() << "covariance("<<i+1<<","<<k+1<<") =" << covariance
-                         << "sigma["<<i+1<<"]" << sigma[i]
-                         << "sigma["<<k+1<<"]" << sigma[k]
-                         << "pcc("<<i+1<<","<<k+1<<") =" << pcc;
-                setItem(i,k, pcc);
-                setItem(k,i, pcc);
-            }
-
-        }
+    Matrix own, VT;
+    Matrix *variables = similarityVariables(AM, varLocation, own, &VT);
 
+    if ( ! variables ) {
+        return *this;
     }
-    else if (varLocation=="Columns") {
-
-
-        N = AM.rows() ;
-
-        this->zeroMatrix(N,N);
-
-        QVector<qreal> mean (N,0); // holds mean values
-        QVector<qreal> sigma(N,0);
-
-        qDebug()<< "Matrix::pearsonCorrelationCoefficients() -"
-                <<"input matrix";
-        //AM.printMatrixConsole(true);
-
-
-        for (int i = 0 ; i < N ; i++ ) {
-
-            for (int k = i ; k < N ; k++ ) {
-
-                qDebug() << "comparing columns i"<<i+1<<"k"<<k+1;
-
-                // compute mean and variance  values
-                sumi = 0;
-                sumk = 0;
-                for (int j = 0 ; j < N ; j++ ) {
-                    if (!diagonal && ( i==j || k==j ) )
-                        continue;
-                    sumi += AM.item(j,i);
-                    sumk += AM.item(j,k);
-                }
-                mean[i] = sumi / ( (diagonal) ? (qreal) N : (qreal) (N-2) ) ;
-                mean[k] = sumk / ( (diagonal) ? (qreal) N : (qreal) (N-2) ) ;
-                varianceTimesNi = 0;
-                varianceTimesNk = 0;
-                for (int j = 0 ; j < N ; j++ ) {
-                    if (!diagonal && ( i==j || k==j ) )
-                        continue;
-                    varianceTimesNi +=  ( AM.item(j,i)  - mean[i] ) *  ( AM.item(j,i)  - mean[i] );
-                    varianceTimesNk +=  ( AM.item(j,k)  - mean[k] ) *  ( AM.item(j,k)  - mean[k] );
-                }
-                sigma[i] = sqrt (varianceTimesNi); //actually this is sigma * sqrt (N)
-                sigma[k] = sqrt (varianceTimesNk); //actually this is sigma * sqrt (N)
-
-                covariance = 0;
-                for (int j = 0 ; j < N ; j++ ) {
-                    if (!diagonal && (i==j || k==j) ) {
-                        qDebug() << "skipping because i"<<i+1<<"k"<<k+1 <<"j"<<j+1;
-                        continue;
-                    }
-                    covariance  +=  ( AM.item(j,i)  - mean[i] ) * ( AM.item(j,k)  - mean[k] ) ;
-                }
-
 
-                if ( ( sigma[i] != 0 ) && ( sigma[k] != 0  ) ) {
-                    pcc =   covariance   /  (( sigma[i] ) * ( sigma[k] )) ;
-                }
-                else {
-                    pcc = 0;
-                }
+    Matrix &V = *variables;
+    const int L = V.cols();
 
+    this->zeroMatrix(N,N);
 
-                qDebug() << "covariance("<<i+1<<","<<k+1<<") =" << covariance
-                         << "sigma["<<i+1<<"]" << sigma[i]
-                         << "sigma["<<k+1<<"]" << sigma[k]
-                         << "pcc("<<i+1<<","<<k+1<<") =" << pcc;
+    Matrix &S = *this;
 
-                setItem(i,k, pcc);
-                setItem(k,i, pcc);
-            }
+    // S = V V^T
+    gemm(S, V, VT, true);
+    VT.clear();
 
+    QVector<qreal> sums(N, 0), squares(N);
+    for (int i = 0; i < N; ++i) {
+        const qreal *x = V[i];
+        for (int j = 0; j < L; ++j) {
+            sums[i] += x[j];
         }
-
+        squares[i] = S[i][i];
     }
-    else if (varLocation=="Both") {
-        Matrix CM;
-
-        N = AM.rows() ;
-
-        int M = N * 2; // CM will have double rows
 
-
-        this->zeroMatrix(N,N);
-
-        CM.zeroMatrix(M,N);
-
-        QVector<qreal> mean (N,0); // holds mean values
-        QVector<qreal> sigma(N,0);
-
-
-        //create augmented matrix (concatenated rows and columns) from input matrix
-        for (int i = 0 ; i < N  ; i++ ) {
-            for (int j = 0 ; j < N  ; j++ ) {
-                CM.setItem(j,i, AM.item(i,j));
-                CM.setItem(j + N,i, AM.item(j,i));
+    // The self-correlation keeps the original two-pass formula, which
+    // divides by N-2 even though only one coordinate is skipped.
+    QVector<qreal> selfCorrelation(N, 0);
+    const int skipsPerPair = diagonal ? 0 : ( both ? 4 : 2 );
+    for (int i = 0; i < N; ++i) {
+        int e[4];
+        const int skipped = similaritySkipped(i, i, N, both, diagonal, e);
+        const qreal *x = V[i];
+        qreal sum = sums[i];
+        for (int s = 0; s < skipped; ++s) {
+            sum -= x[e[s]];
+        }
+        const qreal mean = sum / (qreal) ( L - skipsPerPair );
+        qreal varianceTimesN = 0;
+        for (int j = 0; j < L; ++j) {
+            if ( std::find(e, e + skipped, j) != e + skipped ) {
+                continue;
             }
+            varianceTimesN += ( x[j] - mean ) * ( x[j] - mean );
         }
+        const qreal sigma = sqrt(varianceTimesN);
+        selfCorrelation[i] = ( sigma != 0 ) ? varianceTimesN / ( sigma * sigma ) : 0;
+    }
 
-        qDebug()<< "Matrix::pearsonCorrelationCoefficients() -"
-                <<"input matrix";
-        //CM.printMatrixConsole(true);
-
-
-        for (int i = 0 ; i < N ; i++ ) {  //a column
-
-            for (int k = i ; k < N ; k++ ) {  // next column
-
-               qDebug() << "comparing augmented columns i"<<i+1<<"k"<<k+1;
-
-                // compute mean and variance  values
-                sumi = 0;
-                sumk = 0;
-                for (int j = 0 ; j < M ; j++ ) {
-                    if (!diagonal && ( i==j || k==j || (i+N)==j || (k+N)==j  ) )
-                        continue;
-                    sumi += CM.item(j,i);
-                    sumk += CM.item(j,k);
-                }
-                mean[i] = sumi / ( (diagonal) ? (qreal) M : (qreal) (M-4) ) ;
-                mean[k] = sumk / ( (diagonal) ? (qreal) M : (qreal) (M-4) ) ;
-                varianceTimesNi = 0;
-                varianceTimesNk = 0;
-                for (int j = 0 ; j < M; j++ ) {
-                    if (!diagonal && ( i==j || k==j || (i+N)==j || (k+N)==j  ) )
-                        continue;
-                    varianceTimesNi +=  ( CM.item(j,i)  - mean[i] ) *  ( CM.item(j,i)  - mean[i] );
-                    varianceTimesNk +=  ( CM.item(j,k)  - mean[k] ) *  ( CM.item(j,k)  - mean[k] );
-                }
-                sigma[i] = sqrt (varianceTimesNi); //actually this is sigma * sqrt (N)
-                sigma[k] = sqrt (varianceTimesNk); //actually this is sigma * sqrt (N)
-
-                covariance = 0;
-
-                for (int j = 0 ; j < M ; j++ ) {
-                    qDebug() << "CM.item(j,i)=CM.item("<<j+1<<","<<i+1<<") = "<<CM.item(j,i)
-                             << " mean(i)=mean("<<i+1<<") = "<<mean[i]
-                                << "CM.item(j,k)=CM.item("<<j+1<<","<<k+1<<") = "<<CM.item(j,k)
-                                << " mean(k)=mean("<<k+1<<") = "<<mean[k];
-
-
-                    if (!diagonal) {
-                        if ( (i==j || k==j )) {
-                            qDebug() << "skipping because i"<<i+1<<"k"<<k+1 <<"j"<<j+1;
-                            continue;
-                        }
-                        if ( j>=N && ( (i+N)==j || (k+N)==j )) {
-                            qDebug() << "skipping because j>=N and i"<<i+1<<"k"<<k+1 <<"j"<<j+1;
-                            continue;
-                        }
-                    }
-
-                    covariance  +=  ( CM.item(j,i)  - mean[i] ) * ( CM.item(j,k)  - mean[k] ) ;
-                }
-
-                if ( ( sigma[i] != 0 ) && ( sigma[k] != 0  ) ) {
-                    pcc =   covariance   /  (( sigma[i] ) * ( sigma[k] )) ;
+    similarityForEachBlock(N, [&](const int &i0, const int &i1) {
+        int e[4];
+        for (int i = i0; i < i1; ++i) {
+            S[i][i] = selfCorrelation[i];
+            for (int k = i + 1; k < N; ++k) {
+                qreal sumi = sums[i], sumk = sums[k];
+                qreal sqi = squares[i], sqk = squares[k], dot = S[i][k];
+                const int skipped = similaritySkipped(i, k, N, both, diagonal, e);
+                for (int s = 0; s < skipped; ++s) {
+                    const qreal x = V[i][e[s]], y = V[k][e[s]];
+                    sumi -= x;
+                    sumk -= y;
+                    sqi -= x * x;
+                    sqk -= y * y;
+                    dot -= x * y;
                 }
-                else {
-                    pcc = 0;
+                const qreal n = L - skipped;
+                // sums of squared deviations from the mean, and covariance
+                const qreal varianceTimesNi = sqi - sumi * sumi / n;
+                const qreal varianceTimesNk = sqk - sumk * sumk / n;
+                const qreal covariance = dot - sumi * sumk / n;
+                qreal pcc = 0;
+                // a constant variable has no deviations, up to rounding
+                if ( varianceTimesNi > 1e-12 * sqi && varianceTimesNk > 1e-12 * sqk ) {
+                    pcc = covariance / sqrt( varianceTimesNi * varianceTimesNk );
                 }
-
-                qDebug() << "final covariance("<<i+1<<","<<k+1<<") =" << covariance
-                         << "sigma["<<i+1<<"]" << sigma[i]
-                         << "sigma["<<k+1<<"]" << sigma[k]
-                         << "pcc("<<i+1<<","<<k+1<<") =" << pcc;
-
-                setItem(i,k, pcc);
-                setItem(k,i, pcc);
+                S[i][k] = pcc;
+                S[k][i] = pcc;
             }
-
         }
-    }
-    else {
-
-    }
+    });
 
     return *this;
 
@@ -2376,12 +2576,13 @@ Matrix& Matrix::pearsonCorrelationCoefficients(Matrix &AM,
 
 
 /**
- * @brief Prints matrix m to given textstream
+ * @brief Prints matrix m (a Matrix or a MatrixT) to given textstream
  * @param os
  * @param m
  * @return
  */
-QTextStream& operator <<  (QTextStream& os, Matrix& m){
+template <class M>
+static QTextStream& writeMatrixText (QTextStream& os, const M& m){
     qDebug() << "Matrix: << Matrix";
     int actorNumber=1, fieldWidth = 13;
     qreal maxVal, minVal, maxAbsVal, element;
@@ -2492,6 +2693,24 @@ QTextStream& operator <<  (QTextStream& os, Matrix& m){
 
 
 
+QTextStream& operator <<  (QTextStream& os, const Matrix& m){
+    return writeMatrixText(os, m);
+}
+
+QTextStream& operator <<  (QTextStream& os, const MatrixFloat& m){
+    return writeMatrixText(os, m);
+}
+
+QTextStream& operator <<  (QTextStream& os, const MatrixByte& m){
+    return writeMatrixText(os, m);
+}
+
+QTextStream& operator <<  (QTextStream& os, const MatrixCount& m){
+    return writeMatrixText(os, m);
+}
+
+
+
 
 
 /**
@@ -35,6 +35,9 @@
 #include <QString>  //for static const QString declares below
 #include <utility>      // std::pair, std::make_pair
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 
 using namespace std; //or else compiler groans for nothrow
 
@@ -62,70 +65,6 @@ static const int METRIC_CHEBYSHEV_MAXIMUM= 7;
 
 
 
-class MatrixRow {
-public:
-    MatrixRow (int cols=0) {
-        cell=new (nothrow) qreal [m_cols=cols];
-		Q_CHECK_PTR( cell );
-        for (int i=0;i<m_cols; i++) {
-            cell[i]=0;
-        }
-	}
-
-    ~MatrixRow() {  if (m_cols) delete [] cell; m_cols=0 ; }
-	
-    MatrixRow& operator =(MatrixRow & a) {
-        if (this != &a){
-            if (a.m_cols!=m_cols) {
-                delete [] cell;
-                cell=new (nothrow) qreal[m_cols=a.m_cols];
-                Q_CHECK_PTR( cell);
-            }
-            for (int i=0;i<m_cols; i++) {
-                    cell[i]=a.cell[i];
-            }
-        }
-        return *this;
-    }
-	
-    qreal column ( int c ) const {
-		return cell[c];
-	}
-
-
-    qreal& operator [] (const int k) { return cell[k]; }
-
-	
-    void setColumn (int index, qreal elem) {
-		cell[index]=elem;
-	}
-
-	void clearColumn(int index){
-		cell[index]=0;
-	}	
-
-
-    void resize(int cols) {
-		delete [] cell;
-        cell=new (nothrow) qreal[m_cols=cols];
-		Q_CHECK_PTR( cell);
-        for (int i=0;i<m_cols; i++) {
-			cell[i]=0;
-		}
-    }
-	
-    void setSize(int cols){
-        m_cols=cols;
-    }
-
-private:
-    qreal *cell;
-    int m_cols;
-};
-
-
-
-
 class Matrix {
 public:
     /**default constructor - default rows = cols = 0 */
@@ -133,30 +72,39 @@ public:
 
     Matrix(const Matrix &b) ;	/* Copy constructor allows Matrix a=b  */
 
+    Matrix(Matrix &&b) noexcept;	/* Move constructor, steals the buffer of b */
+
     ~Matrix();
 
     void clear();
 
+    void swap(Matrix &b) noexcept;
+
     void resize (const int m, const int n) ;
 
-    qreal item( int r, int c ) ;
+    qreal item( const int r, const int c ) const { return m_data[ r * m_cols + c ]; }
 
-    void setItem(const int r, const int c, const qreal elem );
+    void setItem(const int r, const int c, const qreal elem ) { m_data[ r * m_cols + c ] = elem; }
 
-    //WARNING: operator() is slow! Avoid using it.
-    qreal  operator ()  (const int r, const int c) { return  row[r].column(c);  }
+    qreal  operator ()  (const int r, const int c) const { return  m_data[ r * m_cols + c ];  }
 
-    MatrixRow& operator []  (const int &r)  { return row[r]; }
+    /** Returns a pointer to the contiguous storage of row r */
+    qreal *operator []  (const int &r)  { return m_data + r * m_cols; }
+    const qreal *operator []  (const int &r) const { return m_data + r * m_cols; }
 
-    void clearItem( int r, int c ) ;
+    /** Row-major storage of the whole matrix, aligned to a cache line */
+    qreal *data() { return m_data; }
+    const qreal *data() const { return m_data; }
 
-    int cols() {return m_cols;}
+    void clearItem( const int r, const int c ) { m_data[ r * m_cols + c ] = 0; }
 
-    int rows() {return m_rows;}
+    int cols() const {return m_cols;}
 
-    int  size() { return m_rows * m_cols; }
+    int rows() const {return m_rows;}
 
-    void findMinMaxValues(qreal&min, qreal&max, bool &hasRealNumbers);
+    int  size() const { return m_rows * m_cols; }
+
+    void findMinMaxValues(qreal&min, qreal&max, bool &hasRealNumbers) const;
 
     void NeighboursNearestFarthest(qreal&min,qreal&max,
                           int &imin, int &jmin,
@@ -173,17 +121,21 @@ public:
     Matrix& subtractFromI () ;
 
 
-    Matrix& operator =(Matrix & a);
+    Matrix& operator =(const Matrix & a);
+
+    Matrix& operator =(Matrix && a) noexcept;
 
     void sum(Matrix &a, Matrix &b) ;
 
+    void difference(Matrix &a, Matrix &b) ;
+
     void operator +=(Matrix & b);
 
-    Matrix& operator +(Matrix & b);
+    Matrix operator +(Matrix & b);
 
-    Matrix& operator -(Matrix & b);
+    Matrix operator -(Matrix & b);
 
-    Matrix& operator *(Matrix & b);
+    Matrix operator *(Matrix & b);
     void operator *=(Matrix & b);
 
     void product( Matrix &A, Matrix & B, bool symmetry=false) ;
@@ -200,8 +152,8 @@ public:
             qreal out[],
             const bool &leftMultiply=false);
 
-    Matrix & pow (int n, bool symmetry=false)  ;
-    Matrix & expBySquaring2 (Matrix &Y, Matrix &X, int n, bool symmetry=false);
+    Matrix pow (int n, bool symmetry=false)  ;
+    void pow (Matrix &P, int n, bool symmetry=false)  ;
 
     qreal distanceManhattan(
             qreal x[],
@@ -220,13 +172,19 @@ public:
             int &xmini,
             const qreal eps, const int &maxIter);
 
-    Matrix& degreeMatrix();
+    bool eigenSymmetric(qreal values[], Matrix &vectors, const int &maxSweeps=50);
+
+    Matrix degreeMatrix();
+    void degreeMatrix(Matrix &D);
 
-    Matrix& laplacianMatrix();
+    Matrix laplacianMatrix();
+    void laplacianMatrix(Matrix &L);
 
-    Matrix& transpose();
+    Matrix transpose();
+    void transpose(Matrix &T);
 
-    Matrix& cocitationMatrix();
+    Matrix cocitationMatrix();
+    void cocitationMatrix(Matrix &C);
 
 
     Matrix& inverseByGaussJordanElimination(Matrix &a);
@@ -240,10 +198,19 @@ public:
     void lubksb (Matrix &a, const int &n, int indx[], qreal b[]);
 
 
-    Matrix& distancesMatrix(const int &metric,
-                            const QString varLocation,
+    Matrix distancesMatrix(const int &metric,
+                           const QString varLocation,
+                           const bool &diagonal,
+                           const bool &considerWeights);
+
+    bool distancesCondensed(const int &metric,
+                            const QString &varLocation,
                             const bool &diagonal,
-                            const bool &considerWeights);
+                            std::vector<qreal> &D,
+                            std::vector<qreal> &self);
+
+    void fromCondensed(const std::vector<qreal> &D,
+                       const std::vector<qreal> &self);
     
     Matrix& similarityMatrix(Matrix &AM,
                                const int &measure,
@@ -257,7 +224,7 @@ public:
                                            const bool &diagonal=false);
 
 
-    friend QTextStream& operator <<  (QTextStream& os, Matrix& m);
+    friend QTextStream& operator <<  (QTextStream& os, const Matrix& m);
     bool printHTMLTable(QTextStream& os,
                         const bool markDiag=false,
                         const bool &plain=false,
@@ -267,12 +234,101 @@ public:
     bool illDefined();
 
 private:
-    MatrixRow *row;
+    qreal *m_data;
     int m_rows;
     int m_cols;
+    int m_capacity;     // number of elements the buffer can hold
+
+};
+
+
+
+/**
+ * @brief The MatrixT class template
+ * A plain dense row-major matrix of T elements, for matrices that only hold
+ * 0/1 flags or small integer counts and need not spend a qreal per element:
+ * MatrixByte for the reachability matrix XRM, MatrixCount for the clique
+ * co-membership matrix CLQM, MatrixFloat where single precision suffices.
+ * It has the element access and printing interface of Matrix; use toMatrix()
+ * to run a Matrix algorithm on it.
+ */
+template <typename T>
+class MatrixT {
+public:
+    MatrixT (int rowDim=0, int colDim=0)
+        : m_rows(rowDim), m_cols(colDim),
+          m_data( static_cast<size_t>(rowDim) * colDim, T(0) ) { }
+
+    void clear() {
+        m_rows = m_cols = 0;
+        std::vector<T>().swap(m_data);
+    }
+
+    void resize (const int m, const int n) {
+        m_rows = m;
+        m_cols = n;
+        m_data.assign( static_cast<size_t>(m) * n, T(0) );
+    }
+
+    void zeroMatrix (const int m, const int n) { resize(m, n); }
+
+    void fillMatrix (const T &value) { std::fill(m_data.begin(), m_data.end(), value); }
+
+    T item( const int r, const int c ) const { return m_data[ static_cast<size_t>(r) * m_cols + c ]; }
+
+    void setItem(const int r, const int c, const T &elem ) { m_data[ static_cast<size_t>(r) * m_cols + c ] = elem; }
+
+    qreal operator () (const int r, const int c) const { return static_cast<qreal>( item(r, c) ); }
+
+    T *operator [] (const int &r) { return m_data.data() + static_cast<size_t>(r) * m_cols; }
+    const T *operator [] (const int &r) const { return m_data.data() + static_cast<size_t>(r) * m_cols; }
+
+    int cols() const {return m_cols;}
 
+    int rows() const {return m_rows;}
+
+    int size() const { return m_rows * m_cols; }
+
+    /** Same as Matrix::findMinMaxValues */
+    void findMinMaxValues(qreal &min, qreal &max, bool &hasRealNumbers) const {
+        max = 0;
+        min = RAND_MAX;
+        hasRealNumbers = false;
+        for (const T &element : m_data) {
+            const qreal value = static_cast<qreal>(element);
+            if ( std::fmod(value, 1.0) != 0 ) {
+                hasRealNumbers = true;
+            }
+            if ( value > max ) {
+                max = value;
+            }
+            if ( value < min ) {
+                min = value;
+            }
+        }
+    }
+
+    /** Copies this matrix into the qreal Matrix M */
+    void toMatrix(Matrix &M) const {
+        M.resize(m_rows, m_cols);
+        std::transform(m_data.begin(), m_data.end(), M.data(),
+                       [](const T &element) { return static_cast<qreal>(element); });
+    }
+
+private:
+    int m_rows;
+    int m_cols;
+    std::vector<T> m_data;
 };
 
+typedef MatrixT<float> MatrixFloat;       // single precision values
+typedef MatrixT<quint8> MatrixByte;       // 0/1 flags, i.e. reachability
+typedef MatrixT<qint32> MatrixCount;      // small integer counts
+
+QTextStream& operator <<  (QTextStream& os, const MatrixFloat& m);
+QTextStream& operator <<  (QTextStream& os, const MatrixByte& m);
+QTextStream& operator <<  (QTextStream& os, const MatrixCount& m);
+
 
 
 
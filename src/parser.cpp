@@ -39,13 +39,273 @@
 #include <QMessageBox>
 #include <QTextCodec>
 #include <QRegularExpression>
+#include <QtConcurrent>
 #include <list>  // used as list<int> listDummiesPajek
 #include <queue>		//for priority queue
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <memory>
 
 #include "graph.h"	//needed for setParent
+#include "compressedfile.h"
+#include "graphtrace.h"
 
 using namespace std;
 
+
+
+/**
+ * @brief Interns byte strings, i.e. the node names of an edge list, to
+ * consecutive integer ids, in order of first appearance.
+ * The keys point into the file buffer, which must outlive the dictionary.
+ * Open addressing, with linear probing.
+ */
+struct EdgeListDictionary {
+    vector<const char *> keys;
+    vector<int> lengths;
+    vector<uint> hashes;
+    vector<int> table;
+    uint mask;
+
+    EdgeListDictionary() : table(1024, -1), mask(1023) {}
+
+    static uint hash(const char *p, const int &length) {
+        uint h = 2166136261u;   // FNV-1a
+        for (int i = 0; i < length; ++i) {
+            h = ( h ^ (uchar) p[i] ) * 16777619u;
+        }
+        return h;
+    }
+
+    int size() const { return (int) keys.size(); }
+
+    int intern(const char *p, const int &length, const uint &h) {
+        uint slot = h & mask;
+        while ( table[slot] >= 0 ) {
+            const int id = table[slot];
+            if ( hashes[id] == h && lengths[id] == length
+                 && memcmp( keys[id], p, length ) == 0 ) {
+                return id;
+            }
+            slot = ( slot + 1 ) & mask;
+        }
+        const int id = size();
+        keys.push_back(p);
+        lengths.push_back(length);
+        hashes.push_back(h);
+        table[slot] = id;
+        if ( 2 * keys.size() > table.size() ) {
+            table.assign( 2 * table.size(), -1 );
+            mask = (uint) table.size() - 1;
+            for (int k = 0; k < size(); ++k) {
+                slot = hashes[k] & mask;
+                while ( table[slot] >= 0 ) {
+                    slot = ( slot + 1 ) & mask;
+                }
+                table[slot] = k;
+            }
+        }
+        return id;
+    }
+};
+
+
+/**
+ * @brief A part of an edge list file, ending at a line end, parsed on its own
+ * by edgeListParseChunk() into local node ids.
+ */
+struct EdgeListChunk {
+    const char *begin;
+    const char *end;
+    bool weighted;
+    EdgeListDictionary dictionary;
+    vector<int> tokens;          // node ids of each data line: source, target(s)
+    vector<int> lineEnds;        // the end of each data line in tokens
+    vector<qreal> weights;       // the weight of each data line, if weighted
+    int lines;                   // the lines read
+    int firstDataLine;           // the first non-comment line, -1 if none
+    const char *firstDataBegin;
+    const char *firstDataEnd;
+    int errorLine;               // a line without 3 columns (weighted), -1 if none
+    bool labels;                 // some node is named by a non-number
+};
+
+
+static inline bool edgeListIsSpace(const char &c) {
+    return c == ' ' || c == '\t' || c == '\v' || c == '\f';
+}
+
+
+/**
+ * @brief Parses a real number without allocating memory, and in the C locale,
+ * as QString::toDouble() does. Numbers with more than 15 significant digits
+ * or large exponents are handed to QByteArray::toDouble().
+ */
+static bool edgeListParseReal(const char *p, const int &length, qreal &value) {
+    int i = 0;
+    bool negative = false;
+    if ( i < length && ( p[i] == '-' || p[i] == '+' ) ) {
+        negative = ( p[i] == '-' );
+        i++;
+    }
+    qint64 mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool any = false;
+    for ( ; i < length && p[i] >= '0' && p[i] <= '9'; ++i ) {
+        if ( digits <= 15 ) {
+            mantissa = mantissa * 10 + ( p[i] - '0' );
+        }
+        digits += ( mantissa > 0 );
+        any = true;
+    }
+    if ( i < length && p[i] == '.' ) {
+        for ( ++i; i < length && p[i] >= '0' && p[i] <= '9'; ++i ) {
+            if ( digits <= 15 ) {
+                mantissa = mantissa * 10 + ( p[i] - '0' );
+            }
+            digits += ( mantissa > 0 );
+            exponent--;
+            any = true;
+        }
+    }
+    if ( any && i < length && ( p[i] == 'e' || p[i] == 'E' ) ) {
+        int e = 0, sign = 1;
+        ++i;
+        if ( i < length && ( p[i] == '-' || p[i] == '+' ) ) {
+            sign = ( p[i] == '-' ) ? -1 : 1;
+            i++;
+        }
+        bool exponentDigits = false;
+        for ( ; i < length && p[i] >= '0' && p[i] <= '9' && e < 10000; ++i ) {
+            e = e * 10 + ( p[i] - '0' );
+            exponentDigits = true;
+        }
+        if ( !exponentDigits ) {
+            any = false;
+        }
+        exponent += sign * e;
+    }
+    if ( any && i == length && digits <= 15 && exponent >= -22 && exponent <= 22 ) {
+        // exact mantissa and power of ten: one correctly rounded operation
+        static const qreal powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+                                        1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        value = ( exponent < 0 ) ? mantissa / powers[-exponent]
+                                 : mantissa * powers[exponent];
+        if ( negative ) {
+            value = -value;
+        }
+        return true;
+    }
+    bool ok = false;
+    value = QByteArray( p, length ).toDouble(&ok);
+    return ok;
+}
+
+
+/**
+ * @brief Parses the lines of a chunk of an edge list.
+ * Columns are separated by white space, as in the simplified() lines of
+ * loadEdgeListWeighed() and loadEdgeListSimple(). Weighted lists must have
+ * exactly 3 columns; the chunk stops at the first line that has not.
+ */
+static void edgeListParseChunk(EdgeListChunk &chunk) {
+    chunk.lines = 0;
+    chunk.firstDataLine = -1;
+    chunk.firstDataBegin = chunk.firstDataEnd = 0;
+    chunk.errorLine = -1;
+    chunk.labels = false;
+
+    const char *p = chunk.begin;
+    const char *tokenBegin[3];
+    int tokenLength[3];
+
+    while ( p < chunk.end ) {
+        const char *lineBegin = p;
+        while ( p < chunk.end && *p != '\n' && *p != '\r' ) {
+            ++p;
+        }
+        const char *lineEnd = p;
+        if ( p < chunk.end ) {
+            if ( *p == '\r' && p + 1 < chunk.end && p[1] == '\n' ) {
+                ++p;
+            }
+            ++p;
+        }
+        chunk.lines++;
+
+        const char *q = lineBegin;
+        while ( q < lineEnd && edgeListIsSpace(*q) ) {
+            ++q;
+        }
+        // comments and empty lines, as in Parser::isComment()
+        if ( q == lineEnd || *q == '#' || *q == '%'
+             || ( q + 1 < lineEnd && q[0] == '/' && ( q[1] == '/' || q[1] == '*' ) ) ) {
+            continue;
+        }
+        if ( chunk.firstDataLine < 0 ) {
+            chunk.firstDataLine = chunk.lines;
+            chunk.firstDataBegin = lineBegin;
+            chunk.firstDataEnd = lineEnd;
+        }
+
+        int columns = 0;
+        while ( q < lineEnd ) {
+            const char *t = q;
+            bool digits = true;
+            while ( q < lineEnd && !edgeListIsSpace(*q) ) {
+                digits = digits && ( *q >= '0' && *q <= '9' );
+                ++q;
+            }
+            const int length = (int) ( q - t );
+            if ( chunk.weighted ) {
+                if ( columns < 3 ) {
+                    tokenBegin[columns] = t;
+                    tokenLength[columns] = length;
+                    if ( columns < 2 && !digits ) {
+                        chunk.labels = true;
+                    }
+                }
+            }
+            else {
+                if ( !digits || ( length == 1 && *t == '0' ) ) {
+                    chunk.labels = true;
+                }
+                chunk.tokens.push_back(
+                            chunk.dictionary.intern( t, length,
+                                                     EdgeListDictionary::hash(t, length) ) );
+            }
+            columns++;
+            while ( q < lineEnd && edgeListIsSpace(*q) ) {
+                ++q;
+            }
+        }
+
+        if ( chunk.weighted ) {
+            if ( columns != 3 ) {
+                chunk.errorLine = chunk.lines;
+                return;
+            }
+            for (int c = 0; c < 2; ++c) {
+                chunk.tokens.push_back(
+                            chunk.dictionary.intern( tokenBegin[c], tokenLength[c],
+                                                     EdgeListDictionary::hash( tokenBegin[c],
+                                                                               tokenLength[c] ) ) );
+            }
+            qreal weight = 1.0;
+            if ( ! edgeListParseReal( tokenBegin[2], tokenLength[2], weight ) ) {
+                weight = 1.0;
+            }
+            chunk.weights.push_back(weight);
+        }
+        chunk.lineEnds.push_back( (int) chunk.tokens.size() );
+    }
+}
+
+
+
+
 Parser::Parser()
 {
     qDebug() << "Parser::Parser() - running on thread "  << this->thread() ;
@@ -78,6 +338,8 @@ Parser::~Parser () {
 
 /**
  * @brief Loads the network calling one of the load* methods
+ * The loaders read the file through a CompressedFile, so gzip and zstd
+ * compressed files of any format are decompressed while they are parsed.
  */
 void Parser::load(const QString fn,
                   const QString m_codec,
@@ -95,6 +357,8 @@ void Parser::load(const QString fn,
                   const int sm_mode,
                   const QString delim)  {
 
+    GraphTraceScope trace("Parser::load");
+
 
     qDebug()<< "**** Parser::load() - On a new thread " << this->thread();
 
@@ -113,7 +377,7 @@ void Parser::load(const QString fn,
     bezier=false;
     fileName=fn;
     userSelectedCodecName = m_codec;
-    networkName=(fileName.split ("/")).last();
+    networkName=(CompressedFile::fileNameWithoutCompression(fileName).split ("/")).last();
     gwWidth=width;
     gwHeight=height;
     randX=0;
@@ -136,23 +400,33 @@ void Parser::load(const QString fn,
 
     errorMessage=QString();
 
+    // Compressed files are decompressed on the fly by the loaders,
+    // see CompressedFile. Fail early if this build cannot read them.
+    const CompressedFile::Compression compression = CompressedFile::detect(fileName);
+    if ( ! CompressedFile::isSupported(compression) ) {
+        loadFileError( tr("This file is compressed with %1, but this build "
+                          "of SocNetV cannot read %1 compressed files.")
+                       .arg(CompressedFile::compressionName(compression)) );
+        return;
+    }
+
     switch (fileFormat){
     case FileType::GRAPHML:
         qDebug()<< "Parser::load() - calling loadGraphML()";
         if (loadGraphML()){
-            qDebug()<< "Parser::load() - that was GRAPHML-formatted file";
+            qCHotDebug(lcParser)<< "Parser::load() - that was GRAPHML-formatted file";
         }
         break;
     case FileType::PAJEK:
         qDebug()<< "Parser::load() - calling loadPajek()";
         if ( loadPajek() ) {
-            qDebug()<< "Parser::load() - that was PAJEK formatted file";
+            qCHotDebug(lcParser)<< "Parser::load() - that was PAJEK formatted file";
         }
         break;
     case FileType::ADJACENCY:
         qDebug()<< "Parser::load() - calling loadAdjacency()";
         if (loadAdjacency() ) {
-            qDebug()<< "Parser::load() - that was ADJACENCY-formatted file";
+            qCHotDebug(lcParser)<< "Parser::load() - that was ADJACENCY-formatted file";
         }
         break;
     case FileType::GRAPHVIZ:
@@ -164,42 +438,42 @@ void Parser::load(const QString fn,
     case FileType::UCINET:
         qDebug()<< "Parser::load() - calling loadDL()";
         if (loadDL() ){
-            qDebug()<< "Parser::load() - that was UCINET-formatted file";
+            qCHotDebug(lcParser)<< "Parser::load() - that was UCINET-formatted file";
         }
         break;
 
     case FileType::GML:
         qDebug()<< "Parser::load() - calling loadGML()";
         if (loadGML() ){
-            qDebug()<< "Parser::load() - that was GML-formatted file";
+            qCHotDebug(lcParser)<< "Parser::load() - that was GML-formatted file";
         }
         break;
 
     case FileType::EDGELIST_WEIGHTED:
         qDebug()<< "Parser::load() - calling loadEdgeListWeighted()";
         if (loadEdgeListWeighed(delimiter) ){
-            qDebug()<< "Parser::load() - that was weighted EDGELIST-formatted file";
+            qCHotDebug(lcParser)<< "Parser::load() - that was weighted EDGELIST-formatted file";
                     }
         break;
 
     case FileType::EDGELIST_SIMPLE:
         qDebug()<< "Parser::load() - calling loadEdgeListSimple()";
         if (loadEdgeListSimple(delimiter) ){
-            qDebug()<< "Parser::load() - that was simple EDGELIST-formatted file";
+            qCHotDebug(lcParser)<< "Parser::load() - that was simple EDGELIST-formatted file";
         }
         break;
 
     case FileType::TWOMODE:
         qDebug()<< "Parser::load() - calling loadTwoModeSociomatrix()";
         if (loadTwoModeSociomatrix() ){
-            qDebug()<< "Parser::load() - that was weigted TWOMODE-formatted file";
+            qCHotDebug(lcParser)<< "Parser::load() - that was weigted TWOMODE-formatted file";
         }
         break;
 
     default:	//GraphML
         qDebug()<< "Parser::load() - default case - calling loadGraphML()";
         if (loadGraphML() ){
-            qDebug()<< "Parser::load() - that was GRAPHML-formatted file";
+            qCHotDebug(lcParser)<< "Parser::load() - that was GRAPHML-formatted file";
         }
         break;
     }
@@ -254,7 +528,7 @@ void Parser::createRandomNodes(const int &fixedNum,
     qDebug() << "Parser::createRandomNodes()";
     if (newNodes != 1 ) {
         for (int i=0; i<newNodes; i++) {
-            qDebug() << "Parser::createRandomNodes() - Multiple nodes. "
+            qCHotDebug(lcParser) << "Parser::createRandomNodes() - Multiple nodes. "
                         "Creating node: "<< i+1;
             emit createNodeAtPosRandom(false);
         }
@@ -275,7 +549,7 @@ void Parser::createRandomNodes(const int &fixedNum,
 bool Parser::loadDL(){
 
     qDebug() << "Parser::loadDL() - Reading UCINET formatted file ";
-    QFile file ( fileName );
+    CompressedFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly )) {
         errorMessage = tr("Cannot open UCINET file ");
         return false;
@@ -340,7 +614,7 @@ bool Parser::loadDL(){
 
         if ( lineCounter == 1) {
             if (!str.startsWith("DL",Qt::CaseInsensitive)  )  {
-                qDebug() << "Parser::loadDL() - Not a DL file. Aborting!";
+                qCHotDebug(lcParser) << "Parser::loadDL() - Not a DL file. Aborting!";
                 errorMessage = tr("File does not start with DL in line 1");
                 file.close();
                 return false;
@@ -357,7 +631,7 @@ bool Parser::loadDL(){
         if (  str.startsWith("DL",Qt::CaseInsensitive) ) {
 
             if ( str.contains(",") ) {
-                qDebug() << "Parser::loadDL() - DL starting line contains a comma" ;
+                qCHotDebug(lcParser) << "Parser::loadDL() - DL starting line contains a comma" ;
                 // If it is a DL file and contains a comma in the first line,
                 // then the line might declare some keywords (N, NM, FORMAT)
                 // this happens in R's sna output files
@@ -369,7 +643,7 @@ bool Parser::loadDL(){
             // if the line contains DL, does not contain any comma
             // but contains at least one "=" then we have keywords space separated.
             else if (str.contains("=")){
-                qDebug() << "Parser::loadDL() - DL starting line contains a = but not a comma" ;
+                qCHotDebug(lcParser) << "Parser::loadDL() - DL starting line contains a = but not a comma" ;
                 // this is space separated
                 lineElement = str.split(" ", QString::SkipEmptyParts);
                 readDLKeywords(lineElement, totalNodes, NM, NR, NC, fullmatrixFormat, edgelist1Format);
@@ -397,7 +671,7 @@ bool Parser::loadDL(){
 
             // check if this line contains precisely one "="
             if ( str.count("=",Qt::CaseInsensitive) == 1 ) {
-                 qDebug() << "Parser::loadDL() - Line contains just one = " ;
+                 qCHotDebug(lcParser) << "Parser::loadDL() - Line contains just one = " ;
                 // then one of the above keywords is declared here
                 tempList = str.split("=", QString::SkipEmptyParts);
 
@@ -405,66 +679,66 @@ bool Parser::loadDL(){
                 value= tempList[1].simplified();
 
                 if (  label == "n" || label  == "N" ) {
-                    qDebug() << "Parser::loadDL() - N is declared to be : "
+                    qCHotDebug(lcParser) << "Parser::loadDL() - N is declared to be : "
                              << value ;
                     totalNodes=value.toInt(&intOK,10);
                     if (!intOK) {
-                        qDebug() << "Parser::loadDL() - N conversion error..." ;
+                        qCHotDebug(lcParser) << "Parser::loadDL() - N conversion error..." ;
                         //emit something here...
                         errorMessage = tr("Cannot convert N value to integer");
                         return false;
                     }
                 }
                 else if (  label == "nm" || label  == "NM" ) {
-                    qDebug() << "Parser::loadDL() - NM is declared to be : "
+                    qCHotDebug(lcParser) << "Parser::loadDL() - NM is declared to be : "
                              << value ;
                     NM = value.toInt(&intOK,10);
                     if (!intOK) {
-                        qDebug() << "Parser::loadDL() - NM conversion error..." ;
+                        qCHotDebug(lcParser) << "Parser::loadDL() - NM conversion error..." ;
                         //emit something here...
                         errorMessage = tr("Cannot convert NM value to integer");
                         return false;
                     }
                 }
                 else if (  label == "nr" || label  == "NR" ) {
-                    qDebug() << "Parser::loadDL() - NR is declared to be : "
+                    qCHotDebug(lcParser) << "Parser::loadDL() - NR is declared to be : "
                              << value ;
                     NR = value.toInt(&intOK,10);
                     if (!intOK) {
-                        qDebug() << "Parser::loadDL() - NR conversion error..." ;
+                        qCHotDebug(lcParser) << "Parser::loadDL() - NR conversion error..." ;
                         //emit something here...
                         errorMessage = tr("Cannot convert NR value to integer");
                         return false;
                     }
                 }
                 else if (  label == "nc" || label  == "NC" ) {
-                    qDebug() << "Parser::loadDL() - NC is declared to be : "
+                    qCHotDebug(lcParser) << "Parser::loadDL() - NC is declared to be : "
                              << value ;
                     NC = value.toInt(&intOK,10);
                     if (!intOK) {
-                        qDebug() << "Parser::loadDL() - NC conversion error..." ;
+                        qCHotDebug(lcParser) << "Parser::loadDL() - NC conversion error..." ;
                         //emit something here...
                         errorMessage = tr("Cannot convert NC value to integer");
                         return false;
                     }
                 }
                 else if (  label == "format" || label  == "FORMAT" ) {
-                    qDebug() << "Parser::loadDL() - FORMAT is declared to be : "
+                    qCHotDebug(lcParser) << "Parser::loadDL() - FORMAT is declared to be : "
                              << value ;
                     if (value.contains("FULLMATRIX",Qt::CaseInsensitive)) {
                         fullmatrixFormat=true;
-                        qDebug() << "Parser::loadDL() - FORMAT fullmatrix detected" ;
+                        qCHotDebug(lcParser) << "Parser::loadDL() - FORMAT fullmatrix detected" ;
                     }
                     else if (value.contains("edgelist",Qt::CaseInsensitive) ){
                         edgelist1Format=true;
-                        qDebug() << "Parser::loadDL() - FORMAT edgelist detected" ;
+                        qCHotDebug(lcParser) << "Parser::loadDL() - FORMAT edgelist detected" ;
                     }
                 }
             } // end if count 1 "=" in line (network properties)
 
             // check if this line contains more than one "="
             else if  ( str.count("=",Qt::CaseInsensitive) > 1 ) {
-                qDebug() << "Parser::loadDL() - Line contains multiple = " ;
+                qCHotDebug(lcParser) << "Parser::loadDL() - Line contains multiple = " ;
                  if (str.contains(",")) {
                     // this is comma separated
                     lineElement = str.split(",", QString::SkipEmptyParts);
@@ -488,37 +762,37 @@ bool Parser::loadDL(){
         else if (str.startsWith( "labels", Qt::CaseInsensitive)
                  || str.startsWith( "row labels", Qt::CaseInsensitive)) {
             rowLabels_flag=true; colLabels_flag=false; data_flag=false;relation_flag=false;
-            qDebug() << "Parser::loadDL() - START LABELS RECOGNITION "
+            qCHotDebug(lcParser) << "Parser::loadDL() - START LABELS RECOGNITION "
                          "AND NODE CREATION";
             continue;
         }
         else if (str.startsWith( "COLUMN LABELS", Qt::CaseInsensitive)) {
             colLabels_flag=true; rowLabels_flag=false; data_flag=false;relation_flag=false;
-            qDebug() << "Parser::loadDL() - START COLUMN LABELS RECOGNITION "
+            qCHotDebug(lcParser) << "Parser::loadDL() - START COLUMN LABELS RECOGNITION "
                         "AND NODE CREATION";
             continue;
         }
         else if ( str.startsWith( "data:", Qt::CaseInsensitive)
                   || str.startsWith( "data :", Qt::CaseInsensitive) ) {
             data_flag=true; rowLabels_flag=false;colLabels_flag=false; relation_flag=false;
-            qDebug() << "Parser::loadDL() - START DATA RECOGNITION "
+            qCHotDebug(lcParser) << "Parser::loadDL() - START DATA RECOGNITION "
                         "AND EDGE CREATION";
             continue;
         }
         else if (str.startsWith( "LEVEL LABELS", Qt::CaseInsensitive) ) {
             relation_flag=true; data_flag=false; rowLabels_flag=false; colLabels_flag=false;
-            qDebug() << "Parser::loadDL() - START RELATIONS RECOGNITION";
+            qCHotDebug(lcParser) << "Parser::loadDL() - START RELATIONS RECOGNITION";
             continue;
         }
         else if ( str.startsWith( "matrix labels:", Qt::CaseInsensitive)
                   || str.startsWith( "matrix labels :", Qt::CaseInsensitive) ) {
             data_flag=false; rowLabels_flag=false;colLabels_flag=false; relation_flag=false;
-            qDebug() << "Parser::loadDL() - matrix labels not supported";
+            qCHotDebug(lcParser) << "Parser::loadDL() - matrix labels not supported";
             continue;
         }
 
         else if (str.isEmpty()){
-            qDebug() << "Parser::loadDL() - EMPTY STRING - CONTINUE";
+            qCHotDebug(lcParser) << "Parser::loadDL() - EMPTY STRING - CONTINUE";
             continue;
         }
 
@@ -529,11 +803,11 @@ bool Parser::loadDL(){
             label=str;
 
             if ( rowLabels.contains(label) ) {
-                qDebug() << "Parser::loadDL() - label exists. CONTINUE";
+                qCHotDebug(lcParser) << "Parser::loadDL() - label exists. CONTINUE";
                 continue;
             }
             else{
-                qDebug() << "Parser::loadDL() - Adding label " << label
+                qCHotDebug(lcParser) << "Parser::loadDL() - Adding label " << label
                          << " to rowLabels";
                 rowLabels << label;
             }
@@ -545,11 +819,11 @@ bool Parser::loadDL(){
             label=str;
 
             if ( colLabels.contains(label) ) {
-                qDebug() << "Parser::loadDL() - col label exists. CONTINUE";
+                qCHotDebug(lcParser) << "Parser::loadDL() - col label exists. CONTINUE";
                 continue;
             }
             else{
-                qDebug() << "Parser::loadDL() - Adding col label " << label
+                qCHotDebug(lcParser) << "Parser::loadDL() - Adding col label " << label
                          << " to colLabels";
                 colLabels << label;
             }
@@ -558,11 +832,11 @@ bool Parser::loadDL(){
         else if ( relation_flag ){
             relation=str;
             if ( relationsList.contains(relation) ) {
-                qDebug() << "Parser::loadDL() -relation exists. CONTINUE";
+                qCHotDebug(lcParser) << "Parser::loadDL() -relation exists. CONTINUE";
                 continue;
             }
             else{
-                qDebug() << "Parser::loadDL() - adding relation "<< relation
+                qCHotDebug(lcParser) << "Parser::loadDL() - adding relation "<< relation
                          << " to relationsList and emitting addRelation ";
                 relationsList << relation;
                 emit addRelation( relation );
@@ -575,10 +849,10 @@ bool Parser::loadDL(){
             if (!nodesCreated_flag) {
 
                 // check if there were NR and NC declared (then this is two-mode)
-                qDebug() << "Parser::loadDL() - check if NR != 0 (two mode net).";
+                qCHotDebug(lcParser) << "Parser::loadDL() - check if NR != 0 (two mode net).";
                 if (NR != 0 && NC != 0) {
                     twoMode_flag=true;
-                    qDebug() << "Parser::loadDL() - this is a two-mode net.";
+                    qCHotDebug(lcParser) << "Parser::loadDL() - this is a two-mode net.";
                     //emit something
 //                    errorMessage = tr("UCINET declared NR=") + QString::number(NR)
 //                            + tr(" and NC=") + QString::number(NC)
@@ -589,7 +863,7 @@ bool Parser::loadDL(){
                 // check if we have found row labels
                 if ( rowLabels.count() == 0 ) {
                     // no labels found
-                    qDebug() << "Parser::loadDL() -Nodes have not been created yet."
+                    qCHotDebug(lcParser) << "Parser::loadDL() -Nodes have not been created yet."
                              << "No node labels found."
                              << "Calling createRandomNodes(N) for all" ;
                     createRandomNodes(1, QString(), totalNodes);
@@ -600,7 +874,7 @@ bool Parser::loadDL(){
                     // only one label line was found
                     // probably contains a comma to separate labels
                     // split it
-                    qDebug() << "Parser::loadDL() -Nodes have not been created yet."
+                    qCHotDebug(lcParser) << "Parser::loadDL() -Nodes have not been created yet."
                              << "One row for labels found."
                              << "Splitting at a comma and calling createRandomNodes(1) for each label" ;
                     tempList = rowLabels[0].split(",", QString::SkipEmptyParts);
@@ -614,7 +888,7 @@ bool Parser::loadDL(){
                 else {
                     // multiple label lines were found
 
-                    qDebug() << "Parser::loadDL() -Nodes have not been created yet."
+                    qCHotDebug(lcParser) << "Parser::loadDL() -Nodes have not been created yet."
                              << "Multiple label lines were found."
                              << "Calling createRandomNodes(1) for each label" ;
                     for (QStringList::Iterator it1 = rowLabels.begin(); it1!=rowLabels.end(); ++it1)   {
@@ -629,7 +903,7 @@ bool Parser::loadDL(){
                     // check if we have found col labels
                     if ( colLabels.count() == 0 ) {
                         // no  col labels found
-                        qDebug() << "Parser::loadDL() -Nodes have not been created yet."
+                        qCHotDebug(lcParser) << "Parser::loadDL() -Nodes have not been created yet."
                                  << "No node labels found."
                                  << "Calling createRandomNodes(NC) for all columns" ;
                         createRandomNodes(totalNodes, QString(), NC);
@@ -639,7 +913,7 @@ bool Parser::loadDL(){
                         // only one col label line was found
                         // probably contains a comma to separate labels
                         // split it
-                        qDebug() << "Parser::loadDL() -Nodes have not been created yet."
+                        qCHotDebug(lcParser) << "Parser::loadDL() -Nodes have not been created yet."
                                  << "One line for col label found."
                                  << "Splitting at a comma and calling createRandomNodes(1) for each label" ;
                         tempList = colLabels[0].split(",", QString::SkipEmptyParts);
@@ -652,7 +926,7 @@ bool Parser::loadDL(){
                     }
                     else {
                         // multiple  col label lines were found
-                        qDebug() << "Parser::loadDL() -Nodes have not been created yet."
+                        qCHotDebug(lcParser) << "Parser::loadDL() -Nodes have not been created yet."
                                  << "Multiple col label lines were found."
                                  << "Calling createRandomNodes(1) for each label" ;
                         for (QStringList::Iterator it1 = colLabels.begin(); it1!=colLabels.end(); ++it1)   {
@@ -671,20 +945,20 @@ bool Parser::loadDL(){
 
                 if (!twoMode_flag) {
 
-                    qDebug() << "Parser::loadDL() - reading edges in fullmatrix format";
+                    qCHotDebug(lcParser) << "Parser::loadDL() - reading edges in fullmatrix format";
 
                     //SPLIT EACH LINE (ON EMPTY SPACE CHARACTERS)
                     if (!prevLineStr.isEmpty()) {
                         str=(prevLineStr.append(" ")).append(str) ;
-                        qDebug() << "Parser::loadDL() -prevLineStr not empty - "
+                        qCHotDebug(lcParser) << "Parser::loadDL() -prevLineStr not empty - "
                                     "prepending it to str - new str: \n" << str;
                         str=str.simplified();
                     }
-                    qDebug() << "Parser::loadDL() - splitting str to elements ";
+                    qCHotDebug(lcParser) << "Parser::loadDL() - splitting str to elements ";
                     lineElement=str.split(QRegExp("\\s+"), QString::SkipEmptyParts);
-                    qDebug() << "Parser::loadDL() - line elements " << lineElement.count();
+                    qCHotDebug(lcParser) << "Parser::loadDL() - line elements " << lineElement.count();
                     if (lineElement.count() < totalNodes ) {
-                        qDebug() << "Parser::loadDL() -This line has "
+                        qCHotDebug(lcParser) << "Parser::loadDL() -This line has "
                                  << lineElement.count()
                                  << " elements, expected "
                                  << totalNodes << " - appending next line";
@@ -694,10 +968,10 @@ bool Parser::loadDL(){
                     prevLineStr.clear();
                     target=1;
                     if (source==1 && relationCounter>0){
-                        qDebug() << "Parser::loadDL() - we are at source 1. "
+                        qCHotDebug(lcParser) << "Parser::loadDL() - we are at source 1. "
                                     "Checking relationList";
                         relation = relationsList[ relationCounter ];
-                        qDebug() << "Parser::loadDL() - "
+                        qCHotDebug(lcParser) << "Parser::loadDL() - "
                                     "WE ARE THE FIRST DATASET/MATRIX"
                                  << " source node counter is " << source
                                  << " and relation to " << relation<< ": "
@@ -708,7 +982,7 @@ bool Parser::loadDL(){
                         source=1;
                         relationCounter++;
                         relation = relationsList[ relationCounter ];
-                        qDebug() << "Parser::loadDL() - "
+                        qCHotDebug(lcParser) << "Parser::loadDL() - "
                                     "LOOKS LIKE WE ENTERED A NEW DATASET/MATRIX "
                                  << " init source node counter to " << source
                                  << " and relation to " << relation << ": "
@@ -716,7 +990,7 @@ bool Parser::loadDL(){
                         emit relationSet (relationCounter);
                     }
                     else {
-                        qDebug() << "Parser::loadDL() - source node counter is " << source;
+                        qCHotDebug(lcParser) << "Parser::loadDL() - source node counter is " << source;
                     }
 
                     for (QStringList::Iterator it1 = lineElement.begin(); it1!=lineElement.end(); ++it1)   {
@@ -731,7 +1005,7 @@ bool Parser::loadDL(){
 
                         if ( edgeWeight ){
 
-                            qDebug() << "Parser::loadDL() - relation "
+                            qCHotDebug(lcParser) << "Parser::loadDL() - relation "
                                      << relationCounter
                                      << " found edge from "
                                      << source << " to " << target
@@ -741,7 +1015,7 @@ bool Parser::loadDL(){
                             emit edgeCreate( source, target, edgeWeight, initEdgeColor,
                                              EdgeType::Directed, arrows, bezier);
                             totalLinks++;
-                            qDebug() << "Parser::loadDL() - TotalLinks= " << totalLinks;
+                            qCHotDebug(lcParser) << "Parser::loadDL() - TotalLinks= " << totalLinks;
 
                         }
                         target++;
@@ -753,12 +1027,12 @@ bool Parser::loadDL(){
                 else {
                     // two-mode
                     target=NR+1;
-                    qDebug() << "Parser::loadDL() - this is a two-mode fullmatrix file. "
+                    qCHotDebug(lcParser) << "Parser::loadDL() - this is a two-mode fullmatrix file. "
                                 "Splitting str to elements:";
                     lineElement=str.split(QRegExp("\\s+"), QString::SkipEmptyParts);
-                    qDebug()<< "Parser::loadDL() - lineElement:" << lineElement;
+                    qCHotDebug(lcParser)<< "Parser::loadDL() - lineElement:" << lineElement;
                     if (lineElement.count() != NC) {
-                        qDebug() << "Parser::loadDL() - Not a two-mode fullmatrix UCINET "
+                        qCHotDebug(lcParser) << "Parser::loadDL() - Not a two-mode fullmatrix UCINET "
                                     "formatted file. Aborting!!";
                         file.close();
                         //emit something...
@@ -779,7 +1053,7 @@ bool Parser::loadDL(){
 
                         if ( edgeWeight ){
 
-                            qDebug() << "Parser::loadDL() - relation "
+                            qCHotDebug(lcParser) << "Parser::loadDL() - relation "
                                      << relationCounter
                                      << " found edge from "
                                      << source << " to " << target
@@ -789,7 +1063,7 @@ bool Parser::loadDL(){
                             emit edgeCreate( source, target, edgeWeight, initEdgeColor,
                                              EdgeType::Directed, arrows, bezier);
                             totalLinks++;
-                            qDebug() << "Parser::loadDL() - TotalLinks= " << totalLinks;
+                            qCHotDebug(lcParser) << "Parser::loadDL() - TotalLinks= " << totalLinks;
 
                         }
                         target++;
@@ -806,10 +1080,10 @@ bool Parser::loadDL(){
                 // read edges in edgelist1 format
 
                 lineElement=str.split(QRegExp("\\s+"), QString::SkipEmptyParts);
-                qDebug() << "Parser::loadDL() - edgelist str line:"<< str;
-                qDebug() << "Parser::loadDL() - edgelist data element:"<< lineElement;
+                qCHotDebug(lcParser) << "Parser::loadDL() - edgelist str line:"<< str;
+                qCHotDebug(lcParser) << "Parser::loadDL() - edgelist data element:"<< lineElement;
                 if ( lineElement.count() != 3 ) {
-                    qDebug() << "Parser::loadDL() - Not an edgelist1 UCINET "
+                    qCHotDebug(lcParser) << "Parser::loadDL() - Not an edgelist1 UCINET "
                                 "formatted file. Aborting!!";
                     file.close();
                     //emit something...
@@ -821,21 +1095,21 @@ bool Parser::loadDL(){
                 source =  (lineElement[0]).toInt(&intOK);
                 target =  (lineElement[1]).toInt(&intOK);
 
-                qDebug() << "Parser::loadDL() - source node "
+                qCHotDebug(lcParser) << "Parser::loadDL() - source node "
                          << source  << " target node " << target;
 
                 edgeWeight=(lineElement[2]).toDouble(&conversionOK);
 
                 if (conversionOK) {
-                    qDebug() << "Parser::loadDL() -list file declares edge weight: "
+                    qCHotDebug(lcParser) << "Parser::loadDL() -list file declares edge weight: "
                              << edgeWeight;
                 }
                 else {
                     edgeWeight=1.0;
-                    qDebug () << "	list file NOT declaring edge weight. Setting default: " << edgeWeight;
+                    qCHotDebug(lcParser) << "	list file NOT declaring edge weight. Setting default: " << edgeWeight;
                 }
 
-                qDebug() << "Parser::loadDL() - Creating link "
+                qCHotDebug(lcParser) << "Parser::loadDL() - Creating link "
                          << source << " -> "<< target << " weight= "<< edgeWeight
                          <<  " TotalLinks=  " << totalLinks+1;
                 emit edgeCreate(source, target, edgeWeight, initEdgeColor, EdgeType::Directed,
@@ -900,7 +1174,7 @@ bool Parser::readDLKeywords(QStringList &strList,
             // remove DL
             tempStr.remove("DL",Qt::CaseInsensitive);
             tempStr=tempStr.simplified();
-            qDebug() << "Parser::readDLKeywords() - element contained DL. Removed it:"
+            qCHotDebug(lcParser) << "Parser::readDLKeywords() - element contained DL. Removed it:"
                      << tempStr;
         }
 
@@ -908,7 +1182,7 @@ bool Parser::readDLKeywords(QStringList &strList,
         if ( tempStr.count() > 0  ) {
 
             if (tempStr.contains("=",Qt::CaseInsensitive)) {
-                qDebug() << "Parser::readDLKeywords() - splitting element at = sign";
+                qCHotDebug(lcParser) << "Parser::readDLKeywords() - splitting element at = sign";
 
                 tempList = tempStr.split("=", QString::SkipEmptyParts);
 
@@ -916,59 +1190,59 @@ bool Parser::readDLKeywords(QStringList &strList,
                 value= tempList[1].simplified();
 
                 if (  label == "n" || label  == "N" ) {
-                    qDebug() << "Parser::readDLKeywords() - N is declared to be : "
+                    qCHotDebug(lcParser) << "Parser::readDLKeywords() - N is declared to be : "
                              << value ;
                     N=value.toInt(&intOK,10);
                     if (!intOK) {
-                        qDebug() << "Parser::loadDL() - N conversion error..." ;
+                        qCHotDebug(lcParser) << "Parser::loadDL() - N conversion error..." ;
                         //emit something here...
                         errorMessage = tr("Cannot convert N value to integer");
                         return false;
                     }
                 }
                 else if (  label == "nm" || label  == "NM" ) {
-                    qDebug() << "Parser::readDLKeywords() - NM is declared to be : "
+                    qCHotDebug(lcParser) << "Parser::readDLKeywords() - NM is declared to be : "
                              << value ;
                     NM = value.toInt(&intOK,10);
                     if (!intOK) {
-                        qDebug() << "Parser::readDLKeywords() - NM conversion error..." ;
+                        qCHotDebug(lcParser) << "Parser::readDLKeywords() - NM conversion error..." ;
                         //emit something here...
                         errorMessage = tr("Cannot convert NM value to integer");
                         return false;
                     }
                 }
                 else if (  label == "nr" || label  == "NR" ) {
-                    qDebug() << "Parser::readDLKeywords() - NR is declared to be : "
+                    qCHotDebug(lcParser) << "Parser::readDLKeywords() - NR is declared to be : "
                              << value ;
                     NR = value.toInt(&intOK,10);
                     if (!intOK) {
-                        qDebug() << "Parser::readDLKeywords() - NR conversion error..." ;
+                        qCHotDebug(lcParser) << "Parser::readDLKeywords() - NR conversion error..." ;
                         //emit something here...
                         errorMessage = tr("Cannot convert NR value to integer");
                         return false;
                     }
                 }
                 else if (  label == "nc" || label  == "NC" ) {
-                    qDebug() << "Parser::readDLKeywords() - NC is declared to be : "
+                    qCHotDebug(lcParser) << "Parser::readDLKeywords() - NC is declared to be : "
                              << value ;
                     NC = value.toInt(&intOK,10);
                     if (!intOK) {
-                        qDebug() << "Parser::readDLKeywords() - NC conversion error..." ;
+                        qCHotDebug(lcParser) << "Parser::readDLKeywords() - NC conversion error..." ;
                         //emit something here...
                         errorMessage = tr("Cannot convert NC value to integer");
                         return false;
                     }
                 }
                 else if (  label == "format" || label  == "FORMAT" ) {
-                    qDebug() << "Parser::readDLKeywords() - FORMAT is declared to be : "
+                    qCHotDebug(lcParser) << "Parser::readDLKeywords() - FORMAT is declared to be : "
                              << value ;
                     if (value.contains("FULLMATRIX",Qt::CaseInsensitive)) {
                         fullmatrixFormat=true;
-                        qDebug() << "Parser::readDLKeywords() - FORMAT fullmatrix detected" ;
+                        qCHotDebug(lcParser) << "Parser::readDLKeywords() - FORMAT fullmatrix detected" ;
                     }
                     else if (value.contains("edgelist",Qt::CaseInsensitive) ){
                         edgelist1Format=true;
-                        qDebug() << "Parser::readDLKeywords() - FORMAT edgelist detected" ;
+                        qCHotDebug(lcParser) << "Parser::readDLKeywords() - FORMAT edgelist detected" ;
                     }
                 } // end format
             } // end if contains =
@@ -989,13 +1263,77 @@ bool Parser::readDLKeywords(QStringList &strList,
 
 
 
+/**
+ * @brief Splits a line of a Pajek edges, arcs or matrix section on white space,
+ * if it has only numbers.
+ * Returns false for empty lines and lines with anything else, i.e. headers,
+ * comments or edge attributes, which are left to the general parser.
+ * @param line
+ * @param tokens
+ * @return
+ */
+static bool pajekNumericTokens(const QString &line, QVector<QStringRef> &tokens) {
+    tokens.clear();
+    const QChar *data = line.constData();
+    const int size = line.size();
+    int p = 0;
+    while ( p < size ) {
+        while ( p < size && data[p].isSpace() ) {
+            ++p;
+        }
+        if ( p == size ) {
+            break;
+        }
+        const int begin = p;
+        while ( p < size && !data[p].isSpace() ) {
+            const ushort c = data[p].unicode();
+            if ( !( ( c >= '0' && c <= '9' ) || c == '.' || c == '-' || c == '+'
+                    || c == 'e' || c == 'E' ) ) {
+                return false;
+            }
+            ++p;
+        }
+        tokens.append( QStringRef(&line, begin, p - begin) );
+    }
+    return !tokens.isEmpty();
+}
+
+
+/**
+ * @brief Parses a node number of a Pajek line: digits only, as toInt() would.
+ * @param token
+ * @param value
+ * @return false if the token is not a plain number, or too long for an int
+ */
+static bool pajekTokenToInt(const QStringRef &token, int &value) {
+    if ( token.isEmpty() || token.size() > 9 ) {
+        return false;
+    }
+    int v = 0;
+    for (int k = 0; k < token.size(); ++k) {
+        const ushort c = token.at(k).unicode();
+        if ( c < '0' || c > '9' ) {
+            return false;
+        }
+        v = v * 10 + ( c - '0' );
+    }
+    value = v;
+    return true;
+}
+
+
+
 /**
     Tries to load the file as Pajek-formatted network. If not it returns -1
+    Lines of the *Edges, *Arcs, *Arcslist and *Matrix sections which have only
+    numbers are split in place, without simplified() and regular expressions,
+    and their edges are sent to Graph in batches, with edgeCreateList().
+    Any other line goes through the general parser, after the pending batch.
 */
 bool Parser::loadPajek(){
 
     qDebug ("\n\nParser: loadPajek");
-    QFile file ( fileName );
+    CompressedFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly ))  {
         errorMessage = tr("Cannot open Pajek file");
         return false;
@@ -1030,9 +1368,122 @@ bool Parser::loadPajek(){
     //if j + miss < nodeNum, it creates (nodeNum-miss) dummy nodes which are deleted in the end.
     relationsList.clear();
 
+    // The edges of the numeric lines not yet sent to Graph
+    QVector<QStringRef> tokens;
+    QVector<int> batchSources, batchTargets;
+    QVector<qreal> batchWeights;
+    int batchType = EdgeType::Directed;
+    bool weightOk = false;
+
+    auto edgeBatchFlush = [&] () {
+        if ( batchSources.isEmpty() ) {
+            return;
+        }
+        emit edgeCreateList(batchSources, batchTargets, batchWeights,
+                            initEdgeColor, batchType,
+                            ( batchType == EdgeType::Directed ), false, false);
+        batchSources.clear();
+        batchTargets.clear();
+        batchWeights.clear();
+    };
+
+    auto edgeBatchAppend = [&] (const int &type, const int &s, const int &t, const qreal &w) {
+        if ( type != batchType ) {
+            edgeBatchFlush();
+            batchType = type;
+        }
+        batchSources.append(s);
+        batchTargets.append(t);
+        batchWeights.append(w);
+    };
+
 
     while ( !ts.atEnd() )   {
-        str= ts.readLine();
+        ts.readLineInto(&str);
+
+        // Fast path for numeric lines, once all nodes have been created.
+        // It must do exactly what the general parser below does with them.
+        if ( ( edges_flag || arcs_flag || arcslist_flag || matrix_flag )
+             && j > 0 && j == totalNodes
+             && pajekNumericTokens(str, tokens) ) {
+            bool handled = false;
+            if ( edges_flag != arcs_flag ) {
+                // source target [weight]
+                if ( tokens.size() >= 2 && tokens.size() <= 3
+                     && pajekTokenToInt(tokens[0], source) && source > 0
+                     && pajekTokenToInt(tokens[1], target) && target > 0 ) {
+                    weightOk = true;
+                    edgeWeight = ( tokens.size() == 3 ) ? tokens[2].toDouble(&weightOk) : 1.0;
+                    handled = weightOk;
+                }
+                if ( handled ) {
+                    edgeColor=initEdgeColor;
+                    edgeLabel=initEdgeLabel;
+                    bezier=false;
+                    if ( edges_flag ) {
+                        arrows=false;
+                        edgeBatchAppend(EdgeType::Undirected, source, target, edgeWeight);
+                        totalLinks=totalLinks+2;
+                    }
+                    else {
+                        arrows=true;
+                        has_arcs=true;
+                        edgeBatchAppend(EdgeType::Directed, source, target, edgeWeight);
+                        totalLinks++;
+                    }
+                }
+            }
+            else if ( arcslist_flag ) {
+                // source target1 target2 ...
+                QStringRef first = tokens[0];
+                if ( first.startsWith( QLatin1Char('-') ) ) {
+                    first = QStringRef( first.string(), first.position() + 1, first.size() - 1 );
+                }
+                handled = pajekTokenToInt(first, source);
+                for (int k = 1; handled && k < tokens.size(); ++k) {
+                    handled = pajekTokenToInt(tokens[k], target);
+                }
+                if ( handled ) {
+                    fileContainsLinkColors=false;
+                    edgeColor=initEdgeColor;
+                    has_arcs=true;
+                    arrows=true;
+                    bezier=false;
+                    for (int k = 1; k < tokens.size(); ++k) {
+                        pajekTokenToInt(tokens[k], target);
+                        edgeBatchAppend(EdgeType::Directed, source, target, edgeWeight);
+                        totalLinks++;
+                    }
+                }
+            }
+            else if ( matrix_flag ) {
+                // a row of weights, where "0" is no edge
+                i++;
+                source= i;
+                fileContainsLinkColors=false;
+                edgeColor=initEdgeColor;
+                has_arcs=true;
+                arrows=true;
+                bezier=false;
+                for (int t = 0; t < tokens.size(); ++t) {
+                    if ( tokens[t].size() == 1 && tokens[t].at(0) == QLatin1Char('0') ) {
+                        continue;
+                    }
+                    edgeWeight = tokens[t].toFloat(&weightOk);
+                    edgeBatchAppend(EdgeType::Directed, source, t + 1, edgeWeight);
+                    totalLinks++;
+                }
+                handled = true;
+            }
+            if ( handled ) {
+                lineCounter++;
+                continue;
+            }
+        }
+
+        // Keep the edges in file order
+        edgeBatchFlush();
+
         str = str.simplified();
 
         if ( isComment(str)  )
@@ -1052,7 +1503,7 @@ bool Parser::loadPajek(){
                  || ( !str.startsWith("*network",Qt::CaseInsensitive)
                     && !str.startsWith("*vertices",Qt::CaseInsensitive) )
                  ) {
-                qDebug()<< "*** Parser:loadPajek(): Not a Pajek-formatted file. Aborting!!";
+                qCHotDebug(lcParser)<< "*** Parser:loadPajek(): Not a Pajek-formatted file. Aborting!!";
                 file.close();
                 errorMessage = tr("Not a Pajek-formatted file. "
                                   "First not-comment line does not start with "
@@ -1069,7 +1520,7 @@ bool Parser::loadPajek(){
                   )
                 )
             {
-                qDebug("*** Parser-loadPajek(): Not a Pajek file. Aborting!");
+                qCHotDebug(lcParser, "*** Parser-loadPajek(): Not a Pajek file. Aborting!");
                 errorMessage = tr("Not a Pajek-formatted file. "
                                   "First not-comment line does not start with "
                                   "Network or Vertices");
@@ -1079,11 +1530,11 @@ bool Parser::loadPajek(){
             else if (str.startsWith( "*network",Qt::CaseInsensitive) )  { //NETWORK NAME
                 networkName = (str.right(str.size() - 8 )).simplified() ;
                 if (!networkName.isEmpty() ) {
-                    qDebug()<<"Parser::loadPajek(): networkName: "
+                    qCHotDebug(lcParser)<<"Parser::loadPajek(): networkName: "
                            <<networkName;
                 }
                 else {
-                    qDebug()<<"Parser::loadPajek(): set networkName to unnamed.";
+                    qCHotDebug(lcParser)<<"Parser::loadPajek(): set networkName to unnamed.";
                     networkName = "unnamed";
                 }
                 continue;
@@ -1091,10 +1542,10 @@ bool Parser::loadPajek(){
             if (str.contains( "vertices", Qt::CaseInsensitive) )  {
                 lineElement=str.split(QRegExp("\\s+"));
                 if (!lineElement[1].isEmpty()) 	totalNodes=lineElement[1].toInt(&intOk,10);
-                qDebug ("Parser-loadPajek(): Vertices %i.",totalNodes);
+                qCHotDebug(lcParser, "Parser-loadPajek(): Vertices %i.",totalNodes);
                 continue;
             }
-            qDebug("Parser-loadPajek(): headlines end here");
+            qCHotDebug(lcParser, "Parser-loadPajek(): headlines end here");
         }
         /**SPLIT EACH LINE (ON EMPTY SPACE CHARACTERS) IN SEVERAL ELEMENTS*/
         lineElement=str.split(QRegExp("\\s+"), QString::SkipEmptyParts);
@@ -1103,6 +1554,10 @@ bool Parser::loadPajek(){
             edges_flag=true; arcs_flag=false; arcslist_flag=false; matrix_flag=false;
             continue;
         }
+        else if ( str.contains( "*arcslist", Qt::CaseInsensitive) ) {
+            arcs_flag=false; edges_flag=false; arcslist_flag=true; matrix_flag=false;
+            continue;
+        }
         else if ( str.contains( "*arcs", Qt::CaseInsensitive) ) {
             arcs_flag=true; edges_flag=false; arcslist_flag=false;
             matrix_flag=false;
@@ -1111,12 +1566,12 @@ bool Parser::loadPajek(){
             if ( (pos = str.indexOf(":")) != -1 ) {
                 relation = str.right(str.size() - pos -1) ;
                 relation = relation.simplified();
-                qDebug() << "Parser::loadPajek() - adding relation "<< relation
+                qCHotDebug(lcParser) << "Parser::loadPajek() - adding relation "<< relation
                          << " to relationsList and emitting addRelation ";
                 relationsList << relation;
                 emit addRelation( relation );
                 if (relationCounter > 0) {
-                    qDebug () << "Parser::loadPajek() relationCounter "
+                    qCHotDebug(lcParser) << "Parser::loadPajek() relationCounter "
                               << relationCounter
                               << "emitting relationSet";
                     emit relationSet(relationCounter);
@@ -1127,12 +1582,8 @@ bool Parser::loadPajek(){
 
             continue;
         }
-        else if ( str.contains( "*arcslist", Qt::CaseInsensitive) ) {
-            arcs_flag=false; edges_flag=false; arcslist_flag=true; matrix_flag=false;
-            continue;
-        }
         else if ( str.contains( "*matrix", Qt::CaseInsensitive) ) {
-            qDebug() << str ;
+            qCHotDebug(lcParser) << str ;
             arcs_flag=false; edges_flag=false; arcslist_flag=false;
             matrix_flag=true;
             //check if row has label for matrix data,
@@ -1140,12 +1591,12 @@ bool Parser::loadPajek(){
             if ( (pos = str.indexOf(":")) != -1 ) {
                 relation = str.right(str.size() - pos -1) ;
                 relation = relation.simplified();
-                qDebug() << "Parser::loadPajek() - adding relation "<< relation
+                qCHotDebug(lcParser) << "Parser::loadPajek() - adding relation "<< relation
                          << " to relationsList and emitting addRelation ";
                 relationsList << relation;
                 emit addRelation( relation );
                 if (relationCounter > 0) {
-                    qDebug () << "Parser::loadPajek() relationCounter "
+                    qCHotDebug(lcParser) << "Parser::loadPajek() relationCounter "
                               << relationCounter
                               << "emitting relationSet";
                     emit relationSet(relationCounter);
@@ -1163,7 +1614,7 @@ bool Parser::loadPajek(){
             nodeNum=lineElement[0].toInt(&intOk, 10);
             //qDebug()<<"node number: "<<nodeNum;
             if (nodeNum==0) {
-                qDebug ("Node is zero numbered! Raising zero-start-flag - increasing nodenum");
+                qCHotDebug(lcParser, "Node is zero numbered! Raising zero-start-flag - increasing nodenum");
                 zero_flag=true;
             }
             if (zero_flag){
@@ -1206,7 +1657,7 @@ bool Parser::loadPajek(){
                     //qDebug()<<"nodeColor:" << nodeColor;
                     if (nodeColor.contains (".") )  nodeColor=initNodeColor;
                     if (nodeColor.startsWith("RGB")) nodeColor.replace(0,3,"#");
-                    qDebug () << " \n\n PAJEK color " << nodeColor;
+                    qCHotDebug(lcParser) << " \n\n PAJEK color " << nodeColor;
                 }
                 else { //there is no nodeColor. Use the default
                     //qDebug("No nodeColor");
@@ -1255,11 +1706,11 @@ bool Parser::loadPajek(){
                 }
             }
             /**START NODE CREATION */
-            qDebug ()<<"Creating node numbered "<< nodeNum << " Real nodes count (j)= "<< j+1;
+            qCHotDebug(lcParser)<<"Creating node numbered "<< nodeNum << " Real nodes count (j)= "<< j+1;
             j++;  //Controls the real number of nodes.
             //If the file misses some nodenumbers then we create dummies and delete them afterwards!
             if ( j + miss < nodeNum)  {
-                qDebug ()<<"MW There are "<< j << " nodes but this node has number "<< nodeNum
+                qCHotDebug(lcParser)<<"MW There are "<< j << " nodes but this node has number "<< nodeNum
                         <<"Creating node at "<< randX<<","<< randY;
                 for (int num=j; num< nodeNum; num++) {
                     //qDebug()<< "Parser-loadPajek(): Creating dummy node number num = "<< num;
@@ -1284,12 +1735,12 @@ bool Parser::loadPajek(){
                 }
             }
             else if ( j > nodeNum ) {
-                qDebug ("Error: This Pajek net declares this node with nodeNumber smaller than previous nodes. Aborting");
+                qCHotDebug(lcParser, "Error: This Pajek net declares this node with nodeNumber smaller than previous nodes. Aborting");
                 errorMessage = tr("Pajek-formatted file declares a node with "
                                   "nodeNumber smaller than previous nodes.");
                 return false;
             }
-            qDebug ()<<"emitting createNode()";
+            qCHotDebug(lcParser)<<"emitting createNode()";
             emit createNode(
                         nodeNum,initNodeSize, nodeColor,
                         initNodeNumberColor, initNodeNumberSize,
@@ -1303,13 +1754,13 @@ bool Parser::loadPajek(){
         // first check that all nodes are already created
         else {
             if (j && j!=totalNodes)  {  //if there were more or less nodes than the file declared
-                qDebug()<<"*** WARNING ***: The Pajek file declares " << totalNodes <<"  nodes, but I found " <<  j << " nodes...." ;
+                qCHotDebug(lcParser)<<"*** WARNING ***: The Pajek file declares " << totalNodes <<"  nodes, but I found " <<  j << " nodes...." ;
                 totalNodes=j;
             }
             else if (j==0) {  //if there were no nodes at all, we need to create them now.
-                qDebug()<< "The Pajek file declares "<< totalNodes<< " but I didn't found any nodes. I will create them....";
+                qCHotDebug(lcParser)<< "The Pajek file declares "<< totalNodes<< " but I didn't found any nodes. I will create them....";
                 for (int num=j+1; num<= totalNodes; num++) {
-                    qDebug() << "Parser-loadPajek(): Creating node number i = "<< num;
+                    qCHotDebug(lcParser) << "Parser-loadPajek(): Creating node number i = "<< num;
                     randX=rand()%gwWidth;
                     randY=rand()%gwHeight;
                     emit createNode(
@@ -1331,8 +1782,8 @@ bool Parser::loadPajek(){
             }
             if (edges_flag && !arcs_flag)   {  /**EDGES */
 
-                qDebug("Parser-loadPajek(): ==== Reading edges ====");
-                qDebug()<<lineElement;
+                qCHotDebug(lcParser, "Parser-loadPajek(): ==== Reading edges ====");
+                qCHotDebug(lcParser)<<lineElement;
 
                 source =  lineElement[0].toInt(&ok, 10);
                 target = lineElement[1].toInt(&ok,10);
@@ -1381,13 +1832,13 @@ bool Parser::loadPajek(){
                 }
 
                 if (lineElement.contains("l", Qt::CaseSensitive ) ) {
-                    qDebug("Parser-loadPajek(): file with link labels");
+                    qCHotDebug(lcParser, "Parser-loadPajek(): file with link labels");
                     fileContainsLinkLabels=true;
                     labelIndex=lineElement.indexOf( QRegExp("[l]"), 0 ) + 1;
                     if (labelIndex >= lineElement.count()) edgeLabel=initEdgeLabel;
                     else 	edgeLabel=lineElement [ labelIndex ];
                     if (edgeLabel.contains (".") )  edgeLabel=initEdgeLabel;
-                    qDebug()<< " edge label "<< edgeLabel;
+                    qCHotDebug(lcParser)<< " edge label "<< edgeLabel;
                 }
                 else  {
                     //qDebug("Parser-loadPajek(): file with no link labels");
@@ -1396,7 +1847,7 @@ bool Parser::loadPajek(){
 
                 arrows=false;
                 bezier=false;
-                qDebug()<< "Parser-loadPajek(): EDGES: Create edge between " << source << " - "<< target;
+                qCHotDebug(lcParser)<< "Parser-loadPajek(): EDGES: Create edge between " << source << " - "<< target;
                 emit edgeCreate(source, target, edgeWeight, edgeColor,
                                 EdgeType::Undirected, arrows, bezier, edgeLabel);
                 totalLinks=totalLinks+2;
@@ -1445,13 +1896,13 @@ bool Parser::loadPajek(){
                 }
 
                 if (lineElement.contains("l", Qt::CaseSensitive ) ) {
-                    qDebug("Parser-loadPajek(): file with link labels");
+                    qCHotDebug(lcParser, "Parser-loadPajek(): file with link labels");
                     fileContainsLinkLabels=true;
                     labelIndex=lineElement.indexOf( QRegExp("[l]"), 0 ) + 1;
                     if (labelIndex >= lineElement.count()) edgeLabel=initEdgeLabel;
                     else 	edgeLabel=lineElement.at ( labelIndex );
                     //if (edgeLabel.contains (".") )  edgeLabel=initEdgeLabel;
-                    qDebug()<< " edge label "<< edgeLabel;
+                    qCHotDebug(lcParser)<< " edge label "<< edgeLabel;
                 }
                 else  {
                     //qDebug("Parser-loadPajek(): file with no link labels");
@@ -1460,7 +1911,7 @@ bool Parser::loadPajek(){
                 arrows=true;
                 bezier=false;
                 has_arcs=true;
-                qDebug()<<"Parser-loadPajek(): ARCS: Creating arc from node "<< source << " to node "<< target << " with weight "<< weight;
+                qCHotDebug(lcParser)<<"Parser-loadPajek(): ARCS: Creating arc from node "<< source << " to node "<< target << " with weight "<< weight;
                 emit edgeCreate(source, target, edgeWeight , edgeColor,
                                 EdgeType::Directed, arrows, bezier, edgeLabel);
                 totalLinks++;
@@ -1476,7 +1927,7 @@ bool Parser::loadPajek(){
                 bezier=false;
                 for (int index = 1; index < lineElement.size(); index++) {
                     target = lineElement.at(index).toInt(&ok,10);
-                    qDebug()<<"Parser-loadPajek(): ARCS LIST: Creating ARC source "<< source << " target "<< target << " with weight "<< weight;
+                    qCHotDebug(lcParser)<<"Parser-loadPajek(): ARCS LIST: Creating ARC source "<< source << " target "<< target << " with weight "<< weight;
                     emit edgeCreate(source, target, edgeWeight, edgeColor,
                                     EdgeType::Directed, arrows, bezier);
                     totalLinks++;
@@ -1494,7 +1945,7 @@ bool Parser::loadPajek(){
                 for (target = 0; target < lineElement.size(); target ++) {
                     if ( lineElement.at(target) != "0" ) {
                         edgeWeight  = lineElement.at(target).toFloat(&ok);
-                        qDebug()<<"Parser-loadPajek():  MATRIX: Creating arc source "
+                        qCHotDebug(lcParser)<<"Parser-loadPajek():  MATRIX: Creating arc source "
                                << source << " target "<< target +1
                                << " with weight "<< weight;
                         emit edgeCreate(source, target+1, edgeWeight, edgeColor,
@@ -1505,6 +1956,7 @@ bool Parser::loadPajek(){
             } //else if matrix
         } //end if BOTH ARCS AND EDGES
     } //end WHILE
+    edgeBatchFlush();
     file.close();
     if (j==0) {
         errorMessage = tr("Could not find node declarations in this Pajek-formatted file.");
@@ -1552,7 +2004,7 @@ bool Parser::loadAdjacency(){
 
     qDebug()<< "\n\nParser: loadAdjacency()";
 
-    QFile file ( fileName );
+    CompressedFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly )) {
         return false;
     }
@@ -1600,7 +2052,7 @@ bool Parser::loadAdjacency(){
              || str.contains("xml",Qt::CaseInsensitive)
 
              ) {
-            qDebug()<< "*** Parser:loadAdjacency(): Not an Adjacency-formatted file. Aborting!!";
+            qCHotDebug(lcParser)<< "*** Parser:loadAdjacency(): Not an Adjacency-formatted file. Aborting!!";
             file.close();
 
             errorMessage = tr("Not an Adjacency-formatted file. "
@@ -1623,7 +2075,7 @@ bool Parser::loadAdjacency(){
 
         if  ( (colCount != lastCount && i>1 ) || (colCount < i) ) {
             // row columns differ from lastCaount, therefore this can't be an adjacency matrix
-            qDebug()<< "*** Parser:loadAdjacency(): Not an Adjacency-formatted file. Aborting!!";
+            qCHotDebug(lcParser)<< "*** Parser:loadAdjacency(): Not an Adjacency-formatted file. Aborting!!";
             file.close();
             errorMessage = tr("Error reading Adjacency-formatted file. "
                               "Matrix row %1 has different number of elements from previous row.").arg(i);
@@ -1663,7 +2115,7 @@ bool Parser::loadAdjacency(){
             // is the total nodes declared in this file.
             totalNodes=currentRow.count();
 
-            qDebug()<< "Parser-loadAdjacency(): Nodes to be created:"<< totalNodes;
+            qCHotDebug(lcParser)<< "Parser-loadAdjacency(): Nodes to be created:"<< totalNodes;
 
             // We know how many nodes there are in this adjacency sociomatrix
             // thus we create them, one by one.
@@ -1674,7 +2126,7 @@ bool Parser::loadAdjacency(){
                 randX=rand()%gwWidth;
                 randY=rand()%gwHeight;
 
-                qDebug()<<"Parser-loadAdjacency(): Calling createNode() for node "<< j+1
+                qCHotDebug(lcParser)<<"Parser-loadAdjacency(): Calling createNode() for node "<< j+1
                        <<" using random position:"<<randX <<", " << randY;
 
                 emit createNode( j+1,
@@ -1691,7 +2143,7 @@ bool Parser::loadAdjacency(){
                                  false
                                  );
             }
-            qDebug() << "Parser-loadAdjacency(): Finished creating nodes";
+            qCHotDebug(lcParser) << "Parser-loadAdjacency(): Finished creating nodes";
         }
 
         // Check the number of items in this line,
@@ -1723,7 +2175,7 @@ bool Parser::loadAdjacency(){
                 arrows=true;
                 bezier=false;
 
-                qDebug() << "Parser-loadAdjacency(): New edge: " << i+1 << "->" <<  j+1
+                qCHotDebug(lcParser) << "Parser-loadAdjacency(): New edge: " << i+1 << "->" <<  j+1
                          << "has weight" << edgeWeight << "TotalLinks: " << totalLinks+1;
 
                 emit edgeCreate(i+1, j+1, edgeWeight, initEdgeColor, EdgeType::Directed, arrows, bezier);
@@ -1762,7 +2214,7 @@ bool Parser::loadAdjacency(){
 */
 bool Parser::loadTwoModeSociomatrix(){
     qDebug("\n\nParser: loadTwoModeSociomatrix()");
-    QFile file ( fileName );
+    CompressedFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly )) {
         errorMessage = tr("Cannot open two-mode sociomatrix file. ") ;
         return false;
@@ -1795,7 +2247,7 @@ bool Parser::loadTwoModeSociomatrix(){
              || str.contains("graphml",Qt::CaseInsensitive)
              || str.contains("xml",Qt::CaseInsensitive)
              ) {
-            qDebug()<< "*** Parser:loadTwoModeSociomatrix(): Not a two mode sociomatrix-formatted file. Aborting!!";
+            qCHotDebug(lcParser)<< "*** Parser:loadTwoModeSociomatrix(): Not a two mode sociomatrix-formatted file. Aborting!!";
             file.close();
             errorMessage = tr("Not a two-mode sociomatrix formatted file. "
                              "Non-comment line %1 includes keywords reserved by other file formats (i.e vertices, graphml, network, graph, digraph, DL, xml)")
@@ -1813,7 +2265,7 @@ bool Parser::loadTwoModeSociomatrix(){
         qDebug() << str;
         qDebug() << "newCount "<<newCount << " nodes. We are at i = " << i;
         if  ( (newCount != lastCount && i>1 )  ) { // line element count differ
-            qDebug()<< "*** Parser:loadTwoModeSociomatrix(): Not a Sociomatrix-formatted file. Aborting!!";
+            qCHotDebug(lcParser)<< "*** Parser:loadTwoModeSociomatrix(): Not a Sociomatrix-formatted file. Aborting!!";
             file.close();
             errorMessage = tr("Row %1 has fewer or more elements than previous line.").arg(i);
             return false;
@@ -1833,16 +2285,16 @@ bool Parser::loadTwoModeSociomatrix(){
         qDebug()<< "Parser-loadTwoModeSociomatrix(): reading actor affiliations...";
         for (QStringList::Iterator it1 = lineElement.begin(); it1!=lineElement.end(); ++it1)   {
             if ( (*it1)!="0"){
-                qDebug() << "Parser-loadTwoModeSociomatrix(): there is an 1 from "<< i << " to "<<  j;
+                qCHotDebug(lcParser) << "Parser-loadTwoModeSociomatrix(): there is an 1 from "<< i << " to "<<  j;
                 firstModeMultiMap.insert(i, j);
                 secondModeMultiMap.insert(j, i);
                 for (int k = 1; k < i ; ++k) {
-                    qDebug() << "Checking earlier discovered actor k = " << k;
+                    qCHotDebug(lcParser) << "Checking earlier discovered actor k = " << k;
                     if ( firstModeMultiMap.contains(k, j) ) {
                         arrows=true;
                         bezier=false;
                         edgeWeight = 1;
-                        qDebug() << " Actor " << i << " on the same event as actor " << k << ". Creating edge ";
+                        qCHotDebug(lcParser) << " Actor " << i << " on the same event as actor " << k << ". Creating edge ";
                         emit edgeCreate(i, k, edgeWeight, initEdgeColor,
                                         EdgeType::Undirected, arrows, bezier);
                         totalLinks++;
@@ -1871,9 +2323,94 @@ bool Parser::loadTwoModeSociomatrix(){
 
 
 
+/**
+ * @brief A read-only sequential device which decodes another device with a
+ * text codec, one chunk at a time, and hands out the text as UTF-8.
+ * The encoding in the XML declaration, if any, is rewritten to UTF-8, so that
+ * a QXmlStreamReader reading this device does not decode the text again.
+ * Used by loadGraphML() when the user selected another codec than the one
+ * the document declares.
+ */
+class GraphMLTranscodingDevice : public QIODevice
+{
+public:
+    GraphMLTranscodingDevice(QIODevice *source, QTextCodec *codec) :
+        m_source(source),
+        m_decoder(codec->makeDecoder()),
+        m_position(0),
+        m_firstChunk(true)
+    {
+    }
+
+    ~GraphMLTranscodingDevice() override {
+        delete m_decoder;
+    }
+
+    bool isSequential() const override {
+        return true;
+    }
+
+    bool atEnd() const override {
+        return m_position >= m_buffer.size() && m_source->atEnd();
+    }
+
+    qint64 bytesAvailable() const override {
+        return ( m_buffer.size() - m_position ) + QIODevice::bytesAvailable();
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override {
+        while ( m_position >= m_buffer.size() && ! m_source->atEnd() ) {
+            decodeChunk();
+        }
+        const qint64 bytes = qMin( maxSize, (qint64) ( m_buffer.size() - m_position ) );
+        if ( bytes <= 0 ) {
+            return -1;
+        }
+        std::memcpy( data, m_buffer.constData() + m_position, bytes );
+        m_position += bytes;
+        return bytes;
+    }
+
+    qint64 writeData(const char *, qint64) override {
+        return -1;
+    }
+
+private:
+    static const int CHUNK_SIZE = 1 << 20;
+
+    void decodeChunk() {
+        QString text = m_decoder->toUnicode( m_source->read(CHUNK_SIZE) );
+        if ( m_firstChunk && text.startsWith( QLatin1String("<?xml") ) ) {
+            const int end = text.indexOf( QLatin1String("?>") );
+            if ( end > 0 ) {
+                QString declaration = text.left(end);
+                declaration.replace(
+                            QRegularExpression("encoding\\s*=\\s*([\"'])[^\"']*\\1"),
+                            "encoding=\"UTF-8\"" );
+                text.replace(0, end, declaration);
+            }
+        }
+        m_firstChunk = false;
+        m_buffer = text.toUtf8();
+        m_position = 0;
+    }
+
+    QIODevice *m_source;
+    QTextDecoder *m_decoder;
+    QByteArray m_buffer;
+    int m_position;
+    bool m_firstChunk;
+};
+
+
+
 /**
  * @brief Tries to load a file as GraphML (not GML) formatted network.
  * If not GraphML, it returns false
+ * The file is streamed to the xml reader, which keeps only a small buffer.
+ * If the user selected another codec than the one the document declares,
+ * the stream is transcoded on the fly, see GraphMLTranscodingDevice.
  * @return
  */
 bool Parser::loadGraphML(){
@@ -1896,46 +2433,41 @@ bool Parser::loadGraphML(){
     arrows=true;
     edgeDirType=EdgeType::Directed;
 
-    QFile file ( fileName );
+    CompressedFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly )) {
         return false;
     }
 
     fileDirPath= QFileInfo(fileName).canonicalPath();
 
-    //QXmlStreamReader *xml = new QXmlStreamReader();
+    unique_ptr<GraphMLTranscodingDevice> transcoder;
     QXmlStreamReader xml;
 
-    qDebug() << " Parser::loadGraphML(): read file to a byte array";
-    QByteArray encodedData = file.readAll();
-    QByteArray userSelectedCodec =userSelectedCodecName.toLatin1();
-    xml.addData(encodedData);
-
     qDebug() << " Parser::loadGraphML(): test if XML document encoding == userCodec";
 
-    xml.readNext();
-    if (xml.isStartDocument()) {
+    // Read just the XML declaration, without consuming the file
+    QXmlStreamReader declaration( file.peek(4096) );
+    declaration.readNext();
+    if (declaration.isStartDocument()) {
         qDebug()<< " Parser::loadGraphML(): Testing XML document " << " version "
-                << xml.documentVersion()
-                << " encoding " << xml.documentEncoding()
+                << declaration.documentVersion()
+                << " encoding " << declaration.documentEncoding()
                 << " userSelectedCodecName.toUtf8() "
                 << userSelectedCodecName.toUtf8();
-         if ( xml.documentEncoding().toString() != userSelectedCodecName) {
-                qDebug() << " Parser::loadGraphML(): Conflicting encodings. "
-                         << " Re-reading data with userCodec";
-                xml.clear();
-                QTextStream in(&encodedData);
-                in.setAutoDetectUnicode(false);
-                QTextCodec *codec = QTextCodec::codecForName( userSelectedCodec );
-                in.setCodec(codec);
-                QString decodedData = in.readAll();
-                xml.addData(decodedData);
-         }
-         else {
-             qDebug() << " Parser::loadGraphML(): Testing XML: OK";
-             xml.clear();
-             xml.addData(encodedData);
-         }
+    }
+    QTextCodec *codec = QTextCodec::codecForName( userSelectedCodecName.toLatin1() );
+    if ( declaration.isStartDocument()
+         && declaration.documentEncoding().toString() != userSelectedCodecName
+         && codec != nullptr ) {
+        qDebug() << " Parser::loadGraphML(): Conflicting encodings. "
+                 << " Transcoding data with userCodec";
+        transcoder.reset( new GraphMLTranscodingDevice(&file, codec) );
+        transcoder->open(QIODevice::ReadOnly);
+        xml.setDevice( transcoder.get() );
+    }
+    else {
+        qDebug() << " Parser::loadGraphML(): Testing XML: OK";
+        xml.setDevice(&file);
     }
 
 
@@ -1943,16 +2475,16 @@ bool Parser::loadGraphML(){
         xml.readNext();
         qDebug()<< " Parser::loadGraphML(): xml.token "<< xml.tokenString();
         if (xml.isStartDocument()) {
-            qDebug()<< " Parser::loadGraphML(): xml startDocument" << " version "
+            qCHotDebug(lcParser)<< " Parser::loadGraphML(): xml startDocument" << " version "
                     << xml.documentVersion()
                     << " encoding " << xml.documentEncoding();
         }
 
         if (xml.isStartElement()) {
-            qDebug()<< " Parser::loadGraphML(): element name "<< xml.name().toString();
+            qCHotDebug(lcParser)<< " Parser::loadGraphML(): element name "<< xml.name().toString();
 
-            if (xml.name() == "graphml") {
-                qDebug()<< " Parser::loadGraphML(): GraphML start. NamespaceUri is "
+            if (xml.name() == QLatin1String("graphml")) {
+                qCHotDebug(lcParser)<< " Parser::loadGraphML(): GraphML start. NamespaceUri is "
                         << xml.namespaceUri().toString()
                         << "Calling readGraphML()";
                 if (! readGraphML(xml) ) {
@@ -1963,16 +2495,16 @@ bool Parser::loadGraphML(){
             else {	//not a GraphML doc, return false.
                 xml.raiseError(
                             QObject::tr(" loadGraphML(): not a GraphML file."));
-                qDebug()<< "### Parser::loadGraphML(): Error in startElement "
+                qCHotDebug(lcParser)<< "### Parser::loadGraphML(): Error in startElement "
                         << " The file is not an GraphML version 1.0 file ";
                 errorMessage = tr("XML at startElement but element name not graphml.");
                 break;
             }
         }
-        else if  ( xml.tokenString() == "Invalid" ){
+        else if  ( xml.tokenType() == QXmlStreamReader::Invalid ){
             xml.raiseError(
                         QObject::tr(" loadGraphML(): invalid GraphML or encoding."));
-            qDebug()<< "### Parser::loadGraphML(): Cannot find startElement"
+            qCHotDebug(lcParser)<< "### Parser::loadGraphML(): Cannot find startElement"
                     << " The file is not valid GraphML or has invalid encoding";
             errorMessage = tr("XML tokenString at line %1 invalid.").arg(xml.lineNumber());
             break;
@@ -1984,9 +2516,9 @@ bool Parser::loadGraphML(){
     keyName.clear();
     keyType.clear();
     keyDefaultValue.clear();
+    keyRoles.clear();
     nodeHash.clear();
     edgeMissingNodesList.clear();
-    file.close();
 
     // if there was an error return false with error string
     if (xml.hasError()) {
@@ -1998,10 +2530,12 @@ bool Parser::loadGraphML(){
                     .arg(xml.name().toString())
                     .arg(xml.errorString());
         xml.clear();
+        file.close();
         return false;
     }
 
     xml.clear();
+    file.close();
 
     // if there was no error the rewind to first relation and emit signal
     emit relationSet (0);
@@ -2039,51 +2573,51 @@ bool Parser::readGraphML(QXmlStreamReader &xml){
         qDebug()<< "Parser::readGraphML() - line:" << xml.lineNumber();
 
         if (xml.isStartElement()) {	//new token (graph, node, or edge) here
-            qDebug()<< "Parser::readGraphML() - isStartElement() : "
+            qCHotDebug(lcParser)<< "Parser::readGraphML() - isStartElement() : "
                     << xml.name().toString() ;
-            if (xml.name() == "graph")	//graph definition token
+            if (xml.name() == QLatin1String("graph"))	//graph definition token
                 readGraphMLElementGraph(xml);
 
-            else if (xml.name() == "key")	{//key definition token
+            else if (xml.name() == QLatin1String("key"))	{//key definition token
                 QXmlStreamAttributes xmlStreamAttr = xml.attributes();
                 readGraphMLElementKey(  xmlStreamAttr );
             }
-            else if (xml.name() == "default") //default key value token
+            else if (xml.name() == QLatin1String("default")) //default key value token
                 readGraphMLElementDefaultValue(xml);
 
-            else if (xml.name() == "node")	//graph definition token
+            else if (xml.name() == QLatin1String("node"))	//graph definition token
                 readGraphMLElementNode(xml);
 
-            else if (xml.name() == "data")	//data definition token
+            else if (xml.name() == QLatin1String("data"))	//data definition token
                 readGraphMLElementData(xml);
 
-            else if ( xml.name() == "ShapeNode") {
+            else if ( xml.name() == QLatin1String("ShapeNode")) {
                 bool_node =  true;
             }
-            else if ( ( xml.name() == "Geometry"
-                        || xml.name() == "Fill"
-                        || xml.name() == "BorderStyle"
-                        || xml.name() == "NodeLabel"
-                        || xml.name() == "Shape"
+            else if ( ( xml.name() == QLatin1String("Geometry")
+                        || xml.name() == QLatin1String("Fill")
+                        || xml.name() == QLatin1String("BorderStyle")
+                        || xml.name() == QLatin1String("NodeLabel")
+                        || xml.name() == QLatin1String("Shape")
                         ) && 	bool_node
                       ) {
                 readGraphMLElementNodeGraphics(xml);
             }
 
-            else if (xml.name() == "edge")	{//edge definition token
+            else if (xml.name() == QLatin1String("edge"))	{//edge definition token
                 QXmlStreamAttributes xmlStreamAttr = xml.attributes();
                 readGraphMLElementEdge( xmlStreamAttr  );
             }
 
-            else if ( xml.name() == "BezierEdge") {
+            else if ( xml.name() == QLatin1String("BezierEdge")) {
                 bool_edge =  true;
             }
 
             else if (	 (
-                             xml.name() == "Path"
-                             || xml.name() == "LineStyle"
-                             || xml.name() == "Arrows"
-                             || xml.name() == "EdgeLabel"
+                             xml.name() == QLatin1String("Path")
+                             || xml.name() == QLatin1String("LineStyle")
+                             || xml.name() == QLatin1String("Arrows")
+                             || xml.name() == QLatin1String("EdgeLabel")
                              )
                          && 	bool_edge
                          ) {
@@ -2095,16 +2629,16 @@ bool Parser::readGraphML(QXmlStreamReader &xml){
         }
 
         if (xml.isEndElement()) {		//token ends here
-            qDebug()<< "Parser::readGraphML() -  element ends here: "
+            qCHotDebug(lcParser)<< "Parser::readGraphML() -  element ends here: "
                     << xml.name().toString() ;
-            if (xml.name() == "node")	//node definition end
+            if (xml.name() == QLatin1String("node"))	//node definition end
                 endGraphMLElementNode(xml);
-            else if (xml.name() == "edge")	//edge definition end
+            else if (xml.name() == QLatin1String("edge"))	//edge definition end
                 endGraphMLElementEdge(xml);
         }
 
         if (xml.hasError()) {
-            qDebug()<< "Parser::readGraphML() - xml has error:" << xml.errorString();
+            qCHotDebug(lcParser)<< "Parser::readGraphML() - xml has error:" << xml.errorString();
             return false;
         }
 
@@ -2208,6 +2742,51 @@ void Parser::readGraphMLElementKey ( QXmlStreamAttributes &xmlStreamAttr )
                 << key_type;
     }
 
+    // Resolve what this key sets, once, for readGraphMLElementData()
+    const QString name = keyName.value(key_id);
+    int role = KeyUnknown;
+    if ( key_what == "node" ) {
+        if ( name == "color" ) role = KeyNodeColor;
+        else if ( name == "label" ) role = KeyNodeLabel;
+        else if ( name == "x_coordinate" ) role = KeyNodeX;
+        else if ( name == "y_coordinate" ) role = KeyNodeY;
+        else if ( name == "size" ) role = KeyNodeSize;
+        else if ( name == "label.size" ) role = KeyNodeLabelSize;
+        else if ( name == "label.color" ) role = KeyNodeLabelColor;
+        else if ( name == "shape" ) role = KeyNodeShape;
+        else if ( name == "custom-icon" ) role = KeyNodeCustomIcon;
+    }
+    else if ( key_what == "edge" ) {
+        if ( name == "color" ) role = KeyEdgeColor;
+        else if ( name == "value" || name == "weight" ) role = KeyEdgeWeight;
+        else if ( name == "size of arrow" ) role = KeyEdgeArrowSize;
+        else if ( name == "label" ) role = KeyEdgeLabel;
+    }
+    for (int i = 0; i < keyRoles.size(); ++i) {
+        if ( keyRoles[i].first == key_id ) {
+            keyRoles[i].second = role;
+            return;
+        }
+    }
+    keyRoles << qMakePair(key_id, role);
+
+}
+
+
+
+/**
+ * @brief Returns the GraphMLKeyRole of a data key id, without copying it.
+ * Documents define a handful of keys, so a linear scan is enough.
+ * @param keyId
+ * @return int
+ */
+int Parser::graphMLKeyRole(const QStringRef &keyId) const {
+    for (int i = 0; i < keyRoles.size(); ++i) {
+        if ( keyRoles[i].first == keyId ) {
+            return keyRoles[i].second;
+        }
+    }
+    return KeyUnknown;
 }
 
 
@@ -2247,10 +2826,10 @@ void Parser::readGraphMLElementDefaultValue(QXmlStreamReader &xml) {
         qDebug()<< "Parser::readGraphMLElementDefaultValue() - initNodeCustomIcon full path:"
                 << initNodeCustomIcon ;
         if (QFileInfo(initNodeCustomIcon).exists()){
-            qDebug()<< "Parser::readGraphMLElementDefaultValue() - custom icon file exists!";
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementDefaultValue() - custom icon file exists!";
         }
         else {
-            qDebug()<< "Parser::readGraphMLElementDefaultValue() - custom icon file does not exists!";
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementDefaultValue() - custom icon file does not exists!";
             xml.raiseError(
                         QObject::tr(" Default custom icon for nodes does not exist in the filesystem. \nThe declared icon file was: \n%1").arg(initNodeCustomIcon));
         }
@@ -2380,14 +2959,15 @@ void Parser::endGraphMLElementNode(QXmlStreamReader &xml){
 // called at the start of an edge element
 void Parser::readGraphMLElementEdge(QXmlStreamAttributes &xmlStreamAttr){
 
-    edge_source = xmlStreamAttr.value("source").toString();
-    edge_target = xmlStreamAttr.value("target").toString();
-    edge_directed = xmlStreamAttr.value("directed").toString();
+    // The ids are looked up in place; they are copied only for missing nodes.
+    const QStringRef sourceId = xmlStreamAttr.value("source");
+    const QStringRef targetId = xmlStreamAttr.value("target");
+    const QStringRef directed = xmlStreamAttr.value("directed");
     qDebug()<< "Parser::readGraphMLElementEdge() - id: "
             <<	xmlStreamAttr.value("id").toString()
-                << "edge_source " << edge_source
-                << "edge_target " << edge_target
-                << "directed " << edge_directed;
+                << "edge_source " << sourceId.toString()
+                << "edge_target " << targetId.toString()
+                << "directed " << directed.toString();
 
     missingNode=false;
     edgeWeight=initEdgeWeight;
@@ -2395,7 +2975,7 @@ void Parser::readGraphMLElementEdge(QXmlStreamAttributes &xmlStreamAttr){
     edgeLabel = "";
     bool_edge= true;
 
-    if ( edge_directed=="false" || (edge_directed.contains("false"),Qt::CaseInsensitive) ) {
+    if ( directed == QLatin1String("false") ) {
         edgeDirType=EdgeType::Undirected;
         qDebug()<< "Parser::readGraphMLElementEdge() - UNDIRECTED";
     }
@@ -2403,7 +2983,24 @@ void Parser::readGraphMLElementEdge(QXmlStreamAttributes &xmlStreamAttr){
         edgeDirType=EdgeType::Directed;
         qDebug()<< "Parser::readGraphMLElementEdge() - DIRECTED";
     }
-    if (!nodeHash.contains(edge_source)) {
+    QHash<QString, int>::const_iterator sourceIt =
+            nodeHash.constFind( QString::fromRawData( sourceId.unicode(), sourceId.size() ) );
+    QHash<QString, int>::const_iterator targetIt =
+            nodeHash.constFind( QString::fromRawData( targetId.unicode(), targetId.size() ) );
+
+    if ( sourceIt != nodeHash.constEnd() && targetIt != nodeHash.constEnd() ) {
+        source = sourceIt.value();
+        target = targetIt.value();
+        qDebug()<< "Parser::readGraphMLElementEdge() - source "<< source
+                <<" - target "<< target
+                << " edgeDirType " << edgeDirType;
+        return;
+    }
+
+    edge_source = sourceId.toString();
+    edge_target = targetId.toString();
+
+    if ( sourceIt == nodeHash.constEnd() ) {
         qDebug() << "Parser::readGraphMLElementEdge() - source node id "
                  << edge_source
                  << "for edge from " << edge_source << " to " << edge_target
@@ -2414,7 +3011,7 @@ void Parser::readGraphMLElementEdge(QXmlStreamAttributes &xmlStreamAttr){
                                      +"|"+QString::number(edgeDirType));
         missingNode=true;
     }
-    if (!nodeHash.contains(edge_target)) {
+    if ( targetIt == nodeHash.constEnd() ) {
         qDebug() << "Parser::readGraphMLElementEdge() - target node id "
                  << edge_target
                  << "for edge from " << edge_source << " to " << edge_target
@@ -2426,18 +3023,6 @@ void Parser::readGraphMLElementEdge(QXmlStreamAttributes &xmlStreamAttr){
         missingNode=true;
     }
 
-    if (missingNode) {
-        return;
-    }
-
-    source = nodeHash [edge_source];
-    target = nodeHash [edge_target];
-    qDebug()<< "Parser::readGraphMLElementEdge() - source "<< edge_source
-            << " num "<< source
-            <<" - target "<< edge_target << " num "<< target
-              << " edgeDirType " << edgeDirType;
-
-
 }
 
 
@@ -2462,124 +3047,94 @@ void Parser::endGraphMLElementEdge(QXmlStreamReader &xml){
 /**
  * @brief Reads data for edges and nodes
  * called at a data element (usually nested inside a node or an edge element)
+ * The key is resolved to what it sets once, when it is defined (see
+ * graphMLKeyRole()), and the value is read in place; only string values
+ * that are kept are copied.
  * @param xml
  */
 void Parser::readGraphMLElementData (QXmlStreamReader &xml){
 
     QXmlStreamAttributes xmlStreamAttr = xml.attributes();
-    key_id = xmlStreamAttr.value("key").toString();
-    key_value=xml.text().toString();
+    const int role = graphMLKeyRole( xmlStreamAttr.value("key") );
 
-    qDebug()<< "Parser::readGraphMLElementData() - key_id: "
-            <<  key_id <<  " key_value "<< key_value;
+    QStringRef value = xml.text();
 
-    if (key_value.trimmed() == "")
+    if ( value.trimmed().isEmpty() )
     {
-        qDebug()<< "Parser::readGraphMLElementData() - empty key_value: "
-                << key_value
-                << "reading more xml.text()...";
-
         xml.readNext();
 
-        key_value=xml.text().toString();
+        value = xml.text();
 
-        qDebug()<< "Parser::readGraphMLElementData() - now key_value: " << key_value;
-
-        if (  key_value.trimmed() != "" ) {
-            //if there's simple text after the StartElement,
-            qDebug()<< "Parser::readGraphMLElementData() - key_id " << key_id
-                    << " value is simple text " <<key_value ;
-        }
-        else {  //no text, probably more tags. Return...
-            qDebug()<< "Parser::readGraphMLElementData() - key_id " << key_id
-                    << " for " <<keyFor.value(key_id)
+        if ( value.trimmed().isEmpty() ) {
+            //no text, probably more tags. Return...
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementData() - key"
+                    << xmlStreamAttr.value("key").toString()
                     << ". More elements nested here. Returning";
             return;
         }
-
     }
 
-    if (keyName.value(key_id) == "color" && keyFor.value(key_id) == "node" ) {
-        qDebug()<< "Parser::readGraphMLElementData() -Data found. Node color: "
-                << key_value << " for this node";
-        nodeColor= key_value;
-    }
-    else if (keyName.value(key_id) == "label" && keyFor.value(key_id) == "node" ){
-        qDebug()<< "Parser::readGraphMLElementData() - Data found. Node label: "
-                   ""<< key_value << " for this node";
-        nodeLabel = key_value;
-    }
-    else if (keyName.value(key_id) == "x_coordinate" && keyFor.value(key_id) == "node" ) {
-        qDebug()<< "Parser::readGraphMLElementData() - Data found. Node x: "
-                << key_value << " for this node";
+    qDebug()<< "Parser::readGraphMLElementData() - key: "
+            << xmlStreamAttr.value("key").toString()
+            << "role" << role << "value" << value.toString();
+
+    switch (role) {
+    case KeyNodeColor:
+        nodeColor = value.toString();
+        break;
+    case KeyNodeLabel:
+        nodeLabel = value.toString();
+        break;
+    case KeyNodeX:
         conv_OK=false;
-        randX= key_value.toFloat( &conv_OK ) ;
+        randX= value.toFloat( &conv_OK ) ;
         if (!conv_OK)
             randX = 0;
         else
             randX=randX * gwWidth;
-        qDebug()<< "Parser::readGraphMLElementData() - Using: "<< randX;
-    }
-    else if (keyName.value(key_id) == "y_coordinate" && keyFor.value(key_id) == "node" ) {
-        qDebug()<< "Parser::readGraphMLElementData() - Data found. Node y: "
-                << key_value << " for this node";
+        break;
+    case KeyNodeY:
         conv_OK=false;
-        randY= key_value.toFloat( &conv_OK );
+        randY= value.toFloat( &conv_OK );
         if (!conv_OK)
             randY = 0;
         else
             randY=randY * gwHeight;
-        qDebug()<< "Parser::readGraphMLElementData() - Using: "<< randY;
-    }
-    else if (keyName.value(key_id) == "size" && keyFor.value(key_id) == "node" ) {
-        qDebug()<< "Parser::readGraphMLElementData() - Data found. Node size: "
-                << key_value << " for this node";
+        break;
+    case KeyNodeSize:
         conv_OK=false;
-        nodeSize= key_value.toInt ( &conv_OK );
+        nodeSize= value.toInt ( &conv_OK );
         if (!conv_OK)
             nodeSize = initNodeSize;
-        qDebug()<< "Parser::readGraphMLElementData() - Using: "<< nodeSize;
-    }
-    else if (keyName.value(key_id) == "label.size" && keyFor.value(key_id) == "node" ) {
-        qDebug()<< "Parser::readGraphMLElementData() - Data found. Node label size: "
-                << key_value << " for this node";
+        break;
+    case KeyNodeLabelSize:
         conv_OK=false;
-        nodeLabelSize= key_value.toInt ( &conv_OK );
+        nodeLabelSize= value.toInt ( &conv_OK );
         if (!conv_OK)
             nodeLabelSize = initNodeLabelSize;
-        qDebug()<< "Parser::readGraphMLElementData() - Using: "<< nodeSize;
-    }
-    else if (keyName.value(key_id) == "label.color" && keyFor.value(key_id) == "node" ){
-        qDebug()<< "Parser::readGraphMLElementData() - Data found. Node label Color: "
-                << key_value << " for this node";
-        nodeLabelColor = key_value;
-    }
-    else if (keyName.value(key_id) == "shape" && keyFor.value(key_id) == "node" ) {
-        qDebug()<< "Parser::readGraphMLElementData() - Data found. Node shape: "
-                << key_value << " for this node";
-        nodeShape= key_value;
-    }
-    else if (keyName.value(key_id) == "custom-icon" && keyFor.value(key_id) == "node" ) {
-        qDebug()<< "Parser::readGraphMLElementData() - Data found. Node custom-icon path: "
-                << key_value << " for this node";
-        nodeIconPath = key_value;
-        nodeIconPath = fileDirPath + ("/") + nodeIconPath;
+        break;
+    case KeyNodeLabelColor:
+        nodeLabelColor = value.toString();
+        break;
+    case KeyNodeShape:
+        nodeShape= value.toString();
+        break;
+    case KeyNodeCustomIcon:
+        nodeIconPath = fileDirPath + ("/") + value.toString();
         qDebug()<< "Parser::readGraphMLElementData() - full node custom-icon path: "
                     << nodeIconPath  ;
-    }
-    else if (keyName.value(key_id) == "color" && keyFor.value(key_id) == "edge" ) {
-        qDebug()<< "Parser::readGraphMLElementData() - Data found. Edge color: "
-                << key_value << " for this edge";
-        edgeColor= key_value;
+        break;
+    case KeyEdgeColor:
+        edgeColor= value.toString();
         if (missingNode){
             edgesMissingNodesHash.insert(edge_source+"===>"+edge_target,
                                          QString::number(edgeWeight)+"|"+edgeColor
                                          +"|"+QString::number(edgeDirType));
         }
-    }
-    else if ( ( keyName.value(key_id) == "value" ||  keyName.value(key_id) == "weight" ) && keyFor.value(key_id) == "edge" ) {
+        break;
+    case KeyEdgeWeight:
         conv_OK=false;
-        edgeWeight= key_value.toDouble( &conv_OK );
+        edgeWeight= value.toDouble( &conv_OK );
         if (!conv_OK)
             edgeWeight = 1.0;
         if (missingNode){
@@ -2587,30 +3142,26 @@ void Parser::readGraphMLElementData (QXmlStreamReader &xml){
                                          QString::number(edgeWeight)+"|"+edgeColor
                                          +"|"+QString::number(edgeDirType));
         }
-        qDebug()<< "Parser::readGraphMLElementData() - Data found. Edge value: "
-                << key_value << " Using "<< edgeWeight << " for this edge";
-    }
-    else if ( keyName.value(key_id) == "size of arrow"  && keyFor.value(key_id) == "edge" ) {
+        break;
+    case KeyEdgeArrowSize: {
         conv_OK=false;
-        qreal temp = key_value.toFloat( &conv_OK );
+        qreal temp = value.toFloat( &conv_OK );
         if (!conv_OK) arrowSize = 1;
         else  arrowSize = temp;
-        qDebug()<< "Parser::readGraphMLElementData() - Data found. Edge arrow size: "
-                << key_value << " Using  "<< arrowSize << " for this edge";
+        break;
     }
-    else if (keyName.value(key_id) == "label" && keyFor.value(key_id) == "edge" ){
-        edgeLabel = key_value;
+    case KeyEdgeLabel:
+        edgeLabel = value.toString();
         if (missingNode){
             edgesMissingNodesHash.insert(edge_source+"===>"+edge_target,
                                          QString::number(edgeWeight)+"|"+edgeColor
                                          +"|"+QString::number(edgeDirType));
         }
-        qDebug()<< "Parser::readGraphMLElementData() - Data found. Edge label: "
-                << edgeLabel << " for this edge";
+        break;
+    default:
+        break;
     }
 
-
-
 }
 
 
@@ -2648,13 +3199,13 @@ void Parser::readGraphMLElementNodeGraphics(QXmlStreamReader &xml) {
             temp = xmlStreamAttr.value("width").toString().toFloat (&conv_OK) ;
             if (conv_OK)
                 nodeSize = temp;
-            qDebug()<< "Parser::readGraphMLElementNodeGraphics() - Node Size: "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementNodeGraphics() - Node Size: "
                     << temp<< " Using nodesize" << nodeSize;
         }
         if ( xmlStreamAttr.hasAttribute("shape") ) {
         //if (xmlStreamHasAttribute ( xmlStreamAttr, "shape") ) {
             nodeShape = xmlStreamAttr.value("shape").toString();
-            qDebug()<< "Parser::readGraphMLElementNodeGraphics() - Node Shape: "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementNodeGraphics() - Node Shape: "
                     << nodeShape;
         }
 
@@ -2663,7 +3214,7 @@ void Parser::readGraphMLElementNodeGraphics(QXmlStreamReader &xml) {
         if ( xmlStreamAttr.hasAttribute("color") ) {
         //if ( xmlStreamHasAttribute ( xmlStreamAttr, "color") ) {
             nodeColor= xmlStreamAttr.value("color").toString();
-            qDebug()<< "Parser::readGraphMLElementNodeGraphics() - Node color: "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementNodeGraphics() - Node color: "
                     << nodeColor;
         }
 
@@ -2675,12 +3226,12 @@ void Parser::readGraphMLElementNodeGraphics(QXmlStreamReader &xml) {
     else if (xml.name() == "NodeLabel" ) {
         key_value=xml.readElementText();  //see if there's simple text after the StartElement
         if (!xml.hasError()) {
-            qDebug()<< "Parser::readGraphMLElementNodeGraphics() - Node Label "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementNodeGraphics() - Node Label "
                     << key_value;
             nodeLabel = key_value;
         }
         else {
-            qDebug()<< "Parser::readGraphMLElementNodeGraphics() - "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementNodeGraphics() - "
                        "Cannot read Node Label. There must be more elements nested here, continuing";
         }
     }
@@ -2688,7 +3239,7 @@ void Parser::readGraphMLElementNodeGraphics(QXmlStreamReader &xml) {
         if ( xmlStreamAttr.hasAttribute("type") ) {
         //if ( xmlStreamHasAttribute ( xmlStreamAttr, "type") ) {
             nodeShape= xmlStreamAttr.value("type").toString();
-            qDebug()<< "Parser::readGraphMLElementNodeGraphics() - Node shape: "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementNodeGraphics() - Node shape: "
                     << nodeShape;
         }
 
@@ -2745,13 +3296,13 @@ void Parser::readGraphMLElementEdgeGraphics(QXmlStreamReader &xml) {
         if ( xmlStreamAttr.hasAttribute("color") ) {
         //if ( xmlStreamHasAttribute ( xmlStreamAttr, "color") ) {
             edgeColor= xmlStreamAttr.value("color").toString();
-            qDebug()<< "Parser::readGraphMLElementEdgeGraphics() - Edge color: "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementEdgeGraphics() - Edge color: "
                     << edgeColor;
         }
         if ( xmlStreamAttr.hasAttribute("type") ) {
         //if ( xmlStreamHasAttribute ( xmlStreamAttr, "type") ) {
             edgeType= xmlStreamAttr.value("type").toString();
-            qDebug()<< "Parser::readGraphMLElementEdgeGraphics() - Edge type: "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementEdgeGraphics() - Edge type: "
                     << edgeType;
         }
         if ( xmlStreamAttr.hasAttribute("width") ) {
@@ -2761,7 +3312,7 @@ void Parser::readGraphMLElementEdgeGraphics(QXmlStreamReader &xml) {
                 edgeWeight = temp;
             else
                 edgeWeight=1.0;
-            qDebug()<< "Parser::readGraphMLElementEdgeGraphics() - Edge width: "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementEdgeGraphics() - Edge width: "
                     << edgeWeight;
         }
 
@@ -2770,13 +3321,13 @@ void Parser::readGraphMLElementEdgeGraphics(QXmlStreamReader &xml) {
         if ( xmlStreamAttr.hasAttribute("source") ) {
         //if ( xmlStreamHasAttribute ( xmlStreamAttr, "source") ) {
             tempString = xmlStreamAttr.value("source").toString();
-            qDebug()<< "Parser::readGraphMLElementEdgeGraphics() - Edge source arrow type: "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementEdgeGraphics() - Edge source arrow type: "
                     << tempString;
         }
         if ( xmlStreamAttr.hasAttribute("target") ) {
         //if ( xmlStreamHasAttribute ( xmlStreamAttr, "target") ) {
             tempString = xmlStreamAttr.value("target").toString();
-            qDebug()<< "Parser::readGraphMLElementEdgeGraphics() - Edge target arrow type: "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementEdgeGraphics() - Edge target arrow type: "
                     << tempString;
         }
 
@@ -2786,13 +3337,13 @@ void Parser::readGraphMLElementEdgeGraphics(QXmlStreamReader &xml) {
     else if (xml.name() == "EdgeLabel" ) {
         key_value=xml.readElementText();  //see if there's simple text after the StartElement
         if (!xml.hasError()) {
-            qDebug()<< "Parser::readGraphMLElementEdgeGraphics() - Edge Label "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementEdgeGraphics() - Edge Label "
                     << key_value;
             //probably there's more than simple text after StartElement
             edgeLabel = key_value;
         }
         else {
-            qDebug()<< "Parser::readGraphMLElementEdgeGraphics() - "
+            qCHotDebug(lcParser)<< "Parser::readGraphMLElementEdgeGraphics() - "
                        "Can't read Edge Label. More elements nested ? Continuing with blank edge label....";
             edgeLabel = "" ;
         }
@@ -2823,7 +3374,7 @@ void Parser::createMissingNodeEdges(){
         QHash<QString, QString>::const_iterator it =
                 edgesMissingNodesHash.constBegin();
         while (it != edgesMissingNodesHash.constEnd()) {
-            qDebug()<<"Parser::createMissingNodeEdges() - creating missing edge "
+            qCHotDebug(lcParser)<<"Parser::createMissingNodeEdges() - creating missing edge "
                    << it.key() << " data " << it.value() ;
             edgeMissingNodesList = (it.key()).split("===>");
             if (! ((edgeMissingNodesList[0]).isEmpty() )
@@ -2846,7 +3397,7 @@ void Parser::createMissingNodeEdges(){
                         edgeDirType=EdgeType::Undirected;
 
                 }
-                qDebug()<<"Parser::createMissingNodeEdges() - signal edgeCreate "
+                qCHotDebug(lcParser)<<"Parser::createMissingNodeEdges() - signal edgeCreate "
                        << source << " -> " << target << " edgeDirType value " << edgeDirType;
 
                 emit edgeCreate(source, target, edgeWeight, edgeColor, edgeDirType, arrows, bezier, edgeLabel);
@@ -2867,7 +3418,7 @@ void Parser::createMissingNodeEdges(){
 bool Parser::loadGML(){
     qDebug()<< "Parser::loadGML()";
 
-    QFile file ( fileName );
+    CompressedFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly )) {
         return false;
     }
@@ -2922,7 +3473,7 @@ bool Parser::loadGML(){
              || str.contains("xml",Qt::CaseInsensitive)
              )
                ) {
-            qDebug()<< "*** Parser::loadGML(): Not a GML-formatted file. Aborting!!";
+            qCHotDebug(lcParser)<< "*** Parser::loadGML(): Not a GML-formatted file. Aborting!!";
             errorMessage = tr("Not an GML-formatted file. "
                               "Non-comment line %1 includes keywords reserved by other file formats  (i.e vertices, graphml, network, digraph, DL, xml)")
                               .arg(fileLine);
@@ -2931,27 +3482,27 @@ bool Parser::loadGML(){
         }
 
         if  ( str.startsWith("comment",Qt::CaseInsensitive) ) {
-                qDebug()<< "Parser::loadGML() - This is a comment. Continue.";
+                qCHotDebug(lcParser)<< "Parser::loadGML() - This is a comment. Continue.";
                 continue;
         }
         if  ( str.startsWith("creator",Qt::CaseInsensitive) ) {
-                qDebug()<< "Parser::loadGML() - This is a creator description. Continue.";
+                qCHotDebug(lcParser)<< "Parser::loadGML() - This is a creator description. Continue.";
                 continue;
         }
         else if  ( str.startsWith("graph",Qt::CaseInsensitive) ) {
             //describe a graph
-            qDebug()<< "Parser::loadGML() - graph description list start";
+            qCHotDebug(lcParser)<< "Parser::loadGML() - graph description list start";
             graphKey = true;
         }
         else if ( str.startsWith("directed",Qt::CaseInsensitive) ) {
             //graph attribute declarations
             if (graphKey) {
                 if ( str.contains("1")) {
-                    qDebug()<< "Parser::loadGML() - graph directed 1. A directed graph.";
+                    qCHotDebug(lcParser)<< "Parser::loadGML() - graph directed 1. A directed graph.";
                     edgeDirType=EdgeType::Directed;
                 }
                 else {
-                    qDebug()<< "Parser::loadGML() - graph directed 0. An undirected graph.";
+                    qCHotDebug(lcParser)<< "Parser::loadGML() - graph directed 0. An undirected graph.";
                 }
             }
         }
@@ -2959,7 +3510,7 @@ bool Parser::loadGML(){
             //key declarations
             if (graphKey) {
                 if ( str.contains("1")) {
-                    qDebug()<< "Parser::loadGML() - graph isPlanar 1. Planar graph.";
+                    qCHotDebug(lcParser)<< "Parser::loadGML() - graph isPlanar 1. Planar graph.";
                     isPlanar = true;
                 }
                 else {
@@ -2970,7 +3521,7 @@ bool Parser::loadGML(){
 
         else if ( str.startsWith("node",Qt::CaseInsensitive) ) {
             //node declarations
-            qDebug()<< "Parser::loadGML() - node description list starts";
+            qCHotDebug(lcParser)<< "Parser::loadGML() - node description list starts";
             nodeKey = true;
         }
         else if ( str.startsWith("id",Qt::CaseInsensitive) ) {
@@ -2984,7 +3535,7 @@ bool Parser::loadGML(){
                             .arg(fileLine);
                     return false;
                 }
-                qDebug()<< "Parser::loadGML() - id description "
+                qCHotDebug(lcParser)<< "Parser::loadGML() - id description "
                            << "This node" << totalNodes
                               <<"id"<< node_id;
             }
@@ -2994,7 +3545,7 @@ bool Parser::loadGML(){
             //describes label
             if ( nodeKey ) {
                 nodeLabel = str.split(" ",QString::SkipEmptyParts).last().remove("\"");
-                qDebug()<< "Parser::loadGML() - node label definition"
+                qCHotDebug(lcParser)<< "Parser::loadGML() - node label definition"
                            << "node" << totalNodes
                               <<"id"<< node_id
                                 << "label" << nodeLabel;
@@ -3003,7 +3554,7 @@ bool Parser::loadGML(){
             }
             else if ( edgeKey ) {
                 edgeLabel = str.split(" ",QString::SkipEmptyParts).last();
-                qDebug()<< "Parser::loadGML() - edge label definition"
+                qCHotDebug(lcParser)<< "Parser::loadGML() - edge label definition"
                            << "edge" << totalLinks
                                 << "label" << edgeLabel;
             }
@@ -3012,7 +3563,7 @@ bool Parser::loadGML(){
 
         else if ( str.startsWith("edge ",Qt::CaseInsensitive) ) {
             //edge declarations
-            qDebug()<< "Parser::loadGML() - edge description list start";
+            qCHotDebug(lcParser)<< "Parser::loadGML() - edge description list start";
             edgeKey = true;
             totalLinks++;
         }
@@ -3027,7 +3578,7 @@ bool Parser::loadGML(){
                     return false;
                 }
                 source = edge_source.toInt(0);
-                qDebug()<< "Parser::loadGML() - edge source definition"
+                qCHotDebug(lcParser)<< "Parser::loadGML() - edge source definition"
                            << "edge source" << edge_source;
             }
         }
@@ -3042,23 +3593,23 @@ bool Parser::loadGML(){
                 }
 
                 target = edge_target.toInt(0);
-                qDebug()<< "Parser::loadGML() - edge target definition"
+                qCHotDebug(lcParser)<< "Parser::loadGML() - edge target definition"
                            << "edge target" << edge_target;
             }
         }
         else if ( str.startsWith("graphics",Qt::CaseInsensitive) ) {
             //Describes graphics which are used to draw a particular object.
             if (nodeKey)  {
-                qDebug()<< "Parser::loadGML() - node graphics description list start";
+                qCHotDebug(lcParser)<< "Parser::loadGML() - node graphics description list start";
             }
             else if (edgeKey) {
-                qDebug()<< "Parser::loadGML() - edge graphics description list start";
+                qCHotDebug(lcParser)<< "Parser::loadGML() - edge graphics description list start";
             }
             graphicsKey = true;
         }
         else if ( str.startsWith("center",Qt::CaseInsensitive) ) {
             if (graphicsKey && nodeKey)  {
-                qDebug()<< "Parser::loadGML() - node graphics center start";
+                qCHotDebug(lcParser)<< "Parser::loadGML() - node graphics center start";
                 if ( str.contains("[", Qt::CaseInsensitive) ) {
                     if ( str.contains("]", Qt::CaseInsensitive) &&
                          str.contains("x", Qt::CaseInsensitive) &&
@@ -3082,7 +3633,7 @@ bool Parser::loadGML(){
                                     .arg(fileLine);
                             return false;
                         }
-                        qDebug()<< "Parser::loadGML() - node graphics center"
+                        qCHotDebug(lcParser)<< "Parser::loadGML() - node graphics center"
                                 << "x" << randX
                                 << "y" << randY;
                         fileContainsNodeCoords = true;
@@ -3099,7 +3650,7 @@ bool Parser::loadGML(){
         }
         else if ( str.startsWith("type",Qt::CaseInsensitive) ) {
             if (graphicsKey && nodeKey)  {
-                qDebug()<< "Parser::loadGML() - node graphics type start";
+                qCHotDebug(lcParser)<< "Parser::loadGML() - node graphics type start";
                 nodeShape = str.split(" ",QString::SkipEmptyParts).last();
                 if (nodeShape.isNull() || nodeShape.isEmpty() ) {
                     errorMessage = tr("Not a proper GML-formatted file. "
@@ -3112,7 +3663,7 @@ bool Parser::loadGML(){
         }
         else if ( str.startsWith("fill",Qt::CaseInsensitive) ) {
             if (graphicsKey && nodeKey)  {
-                qDebug()<< "Parser::loadGML() - node graphics fill start";
+                qCHotDebug(lcParser)<< "Parser::loadGML() - node graphics fill start";
                 nodeColor = str.split(" ",QString::SkipEmptyParts).last();
                 if (nodeColor.isNull() || nodeColor.isEmpty() ) {
                     errorMessage = tr("Not a proper GML-formatted file. "
@@ -3124,21 +3675,21 @@ bool Parser::loadGML(){
         }
         else if ( str.startsWith("]",Qt::CaseInsensitive) ) {
             if (nodeKey && graphicsKey && graphicsCenterKey ) {
-                qDebug()<< "Parser::loadGML() - node graphics center ends";
+                qCHotDebug(lcParser)<< "Parser::loadGML() - node graphics center ends";
                 graphicsCenterKey = false;
             }
             else if (graphicsKey) {
-                qDebug()<< "Parser::loadGML() - graphics list ends";
+                qCHotDebug(lcParser)<< "Parser::loadGML() - graphics list ends";
                 graphicsKey = false;
             }
             else if (nodeKey && !graphicsKey) {
-                qDebug()<< "Parser::loadGML() - node description list ends";
+                qCHotDebug(lcParser)<< "Parser::loadGML() - node description list ends";
                 nodeKey = false;
                 if (!fileContainsNodeCoords) {
                     randX=rand()%gwWidth;
                     randY=rand()%gwHeight;
                 }
-                qDebug()<<" *** Creating node "<< node_id
+                qCHotDebug(lcParser)<<" *** Creating node "<< node_id
                        << " at "<< randX <<","<< randY
                        <<" label "<<nodeLabel;
                 emit createNode(
@@ -3151,7 +3702,7 @@ bool Parser::loadGML(){
 
             }
             else if (edgeKey && !graphicsKey) {
-                qDebug()<< "Parser::loadGML() - edge description list ends";
+                qCHotDebug(lcParser)<< "Parser::loadGML() - edge description list ends";
                 edgeKey = false;
                 edgeWeight = 1;
                 edgeColor = "black";
@@ -3163,7 +3714,7 @@ bool Parser::loadGML(){
             }
 
             else if (graphKey) {
-                qDebug()<< "Parser::loadGML() - graph description list ends";
+                qCHotDebug(lcParser)<< "Parser::loadGML() - graph description list ends";
                 graphKey = false;
             }
         }
@@ -3208,7 +3759,7 @@ bool Parser::loadDot(){
     bezier=false;
     source=0, target=0;
 
-    QFile file ( fileName );
+    CompressedFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly )) return false;
     QTextStream ts( &file );
     ts.setCodec(userSelectedCodecName.toUtf8());
@@ -3241,7 +3792,7 @@ bool Parser::loadDot(){
                  || str.startsWith("<graphml",Qt::CaseInsensitive)  // GraphML
                  || str.startsWith("<?xml",Qt::CaseInsensitive)
                  ) {
-                qDebug() << "*** Parser:loadDot(): Not an GraphViz -formatted file. Aborting";
+                qCHotDebug(lcParser) << "*** Parser:loadDot(): Not an GraphViz -formatted file. Aborting";
                 file.close();
                 errorMessage = tr("Not a GraphViz-formatted file. "
                                   "First non-comment line includes keywords reserved by other file formats  (i.e vertices, graphml, network, DL, xml).");
@@ -3252,18 +3803,18 @@ bool Parser::loadDot(){
                 lineElement=str.split(" ");
                 edgeDirType=EdgeType::Directed;
                 if (lineElement[1]!="{" ) networkName=lineElement[1];
-                qDebug() << "This is a DOT DIGRAPH named " << networkName;
+                qCHotDebug(lcParser) << "This is a DOT DIGRAPH named " << networkName;
                 continue;
             }
             else if ( str.contains("graph", Qt::CaseInsensitive) ) {
                 lineElement=str.split(" ");
                 edgeDirType=EdgeType::Undirected;
                 if (lineElement[1] !="{" ) networkName=lineElement[1];
-                qDebug() << "This is a DOT GRAPH named " << networkName;
+                qCHotDebug(lcParser) << "This is a DOT GRAPH named " << networkName;
                 continue;
             }
             else {
-                qDebug()<<" *** Parser:loadDot(): Not a GraphViz file. "
+                qCHotDebug(lcParser)<<" *** Parser:loadDot(): Not a GraphViz file. "
                           "Abort: dot format can only start with \" (di)graph netname {\"";
                 errorMessage = tr("Not properly GraphViz-formatted file. "
                                   "First non-comment line should start with \" (di)graph netname {\"");
@@ -3285,11 +3836,11 @@ bool Parser::loadDot(){
                 || str.startsWith("loops",Qt::CaseInsensitive)
              ) { 	 //Default network properties
             next=str.indexOf('=', 1);
-            qDebug("Found next = at %i. Start is at %i", next, 1);
+            qCHotDebug(lcParser, "Found next = at %i. Start is at %i", next, 1);
             prop=str.mid(0, next).simplified();
-            qDebug()<<"Prop: "<<prop.toLatin1() ;
+            qCHotDebug(lcParser)<<"Prop: "<<prop.toLatin1() ;
             value=str.right(str.count()-next-1).simplified();
-            qDebug() << "Value "<< value;
+            qCHotDebug(lcParser) << "Value "<< value;
             if ( prop == "label" || prop == "name"){
                 networkLabel= value;
             }
@@ -3308,33 +3859,33 @@ bool Parser::loadDot(){
         else if ( str.startsWith("node",Qt::CaseInsensitive) )
         { 	 //Default node properties
             netProperties = false;
-            qDebug() << "* Node properties found...";
+            qCHotDebug(lcParser) << "* Node properties found...";
             start=str.indexOf('[');
             end=str.indexOf(']');
             temp=str.right(str.size()-end-1);
             str=str.mid(start+1, end-start-1);  //keep whatever is inside [ and ]
-            qDebug()<<"Properties start at "<< start<< " and end at "<< end;
-            qDebug()<<str.toLatin1();
+            qCHotDebug(lcParser)<<"Properties start at "<< start<< " and end at "<< end;
+            qCHotDebug(lcParser)<<str.toLatin1();
             str=str.simplified();
-            qDebug()<<str.toLatin1();
+            qCHotDebug(lcParser)<<str.toLatin1();
             start=0;
             end=str.count();
             readDotProperties(str, nodeValue, nodeLabel, initNodeShape, initNodeColor, fontName, fontColor );
-            qDebug ("* Finished NODE PROPERTIES");
+            qCHotDebug(lcParser, "* Finished NODE PROPERTIES");
         }
         else if ( str.startsWith("edge",Qt::CaseInsensitive) ) { //Default edge properties
             netProperties = false;
-            qDebug("* Edge properties found...");
+            qCHotDebug(lcParser, "* Edge properties found...");
             start=str.indexOf('[');
             end=str.indexOf(']');
             str=str.mid(start+1, end-start-1);  //keep whatever is inside [ and ]
-            qDebug()<<"Properties start at "<< start <<" and end at "<< end;
-            qDebug()<<str.toLatin1();
+            qCHotDebug(lcParser)<<"Properties start at "<< start <<" and end at "<< end;
+            qCHotDebug(lcParser)<<str.toLatin1();
             str=str.simplified();
-            qDebug()<<str.toLatin1();
+            qCHotDebug(lcParser)<<str.toLatin1();
             start=0;
             end=str.count();
-            qDebug ("* Finished EDGE PROPERTIES!");
+            qCHotDebug(lcParser, "* Finished EDGE PROPERTIES!");
         }
         //ti ginetai an exeis mesa sxolia ? p.x. sto telos tis grammis //
         else if ( !str.startsWith('[', Qt::CaseInsensitive)
@@ -3344,7 +3895,7 @@ bool Parser::loadDot(){
                   && !netProperties
                   )
         {
-            qDebug()<< "* A node definition must be here: \n" << str;
+            qCHotDebug(lcParser)<< "* A node definition must be here: \n" << str;
             end=str.indexOf('[');
             if (end!=-1) {
                 temp=str.right(str.size()-end-1); //keep the properties
@@ -3352,15 +3903,15 @@ bool Parser::loadDot(){
                 temp=temp.remove(';');
                 node=str.left(end-1);
                 node=node.remove('\"');
-                qDebug()<<"node named "<<node.toLatin1();
-                qDebug()<<"node properties "<<temp.toLatin1();
+                qCHotDebug(lcParser)<<"node named "<<node.toLatin1();
+                qCHotDebug(lcParser)<<"node properties "<<temp.toLatin1();
                 nodeLabel=node;  //Will change only if label exists in readDotProperties
                 readDotProperties(temp, nodeValue, nodeLabel, initNodeShape, initNodeColor, fontName, fontColor );
                 if (nodeLabel=="") nodeLabel=node;
                 totalNodes++;
                 randX=rand()%gwWidth;
                 randY=rand()%gwHeight;
-                qDebug()<<" *** Creating node "<< totalNodes
+                qCHotDebug(lcParser)<<" *** Creating node "<< totalNodes
                        << " at "<< randX <<","<< randY
                        <<" label "<<node.toLatin1()
                       << " colored "<< initNodeColor
@@ -3379,13 +3930,13 @@ bool Parser::loadDot(){
                 // Note that we push the numbered nodelabel whereas we create
                 // the node with its file specified node label.
                 nodesDiscovered.push_back( node  );
-                qDebug()<<" * Total totalNodes " << totalNodes
+                qCHotDebug(lcParser)<<" * Total totalNodes " << totalNodes
                        << " nodesDiscovered  "<< nodesDiscovered.size() ;
                 target=totalNodes;
 
             }
             else {
-                    qDebug ("* ERROR!");
+                    qCHotDebug(lcParser, "* ERROR!");
                     errorMessage = tr("Not properly GraphViz-formatted file. "
                                       "Node definition without opening [");
                     return false;
@@ -3401,18 +3952,18 @@ bool Parser::loadDot(){
                   && !netProperties
                   )
         {
-            qDebug()<< "* A node definition without properties must be here ..." << str;
+            qCHotDebug(lcParser)<< "* A node definition without properties must be here ..." << str;
             end=str.indexOf(';');
             if (end!=-1) {
                 node=str.left(str.size()-end); //keep the properties
-                qDebug()<<"node named "<<node.toLatin1();
+                qCHotDebug(lcParser)<<"node named "<<node.toLatin1();
                 node=node.remove(']').remove(';').remove('\"');
-                qDebug()<<"node named "<<node.toLatin1();
+                qCHotDebug(lcParser)<<"node named "<<node.toLatin1();
                 nodeLabel=node;
                 totalNodes++;
                 randX=rand()%gwWidth;
                 randY=rand()%gwHeight;
-                qDebug()<<" *** Creating node "<< totalNodes
+                qCHotDebug(lcParser)<<" *** Creating node "<< totalNodes
                        << " at "<< randX <<","<< randY
                        <<" label "<<node.toLatin1()
                       << " colored "<< initNodeColor
@@ -3429,30 +3980,30 @@ bool Parser::loadDot(){
                             initNodeShape,QString(),  false
                             );
                 nodesDiscovered.push_back( node  );			// Note that we push the numbered nodelabel whereas we create the node with its file specified node label.
-                qDebug()<<" * Total nodes" << totalNodes<< " nodesDiscovered  "<< nodesDiscovered.size() ;
+                qCHotDebug(lcParser)<<" * Total nodes" << totalNodes<< " nodesDiscovered  "<< nodesDiscovered.size() ;
                 target=totalNodes;
 
             }
             else
                 end=str.indexOf(';');
-            qDebug ("* Finished node!");
+            qCHotDebug(lcParser, "* Finished node!");
         }
 
         else if (str.contains('-',Qt::CaseInsensitive))
         {
             netProperties = false;
-            qDebug("* Edge definition found ...");
+            qCHotDebug(lcParser, "* Edge definition found ...");
             end=str.indexOf('[');
             if (end!=-1) {
                 temp=str.right(str.size()-end-1); //keep the properties
-                qDebug("* Edge definition found - reading properties...");
+                qCHotDebug(lcParser, "* Edge definition found - reading properties...");
                 temp=temp.remove(']');
                 temp=temp.remove(';');
-                qDebug()<<"edge properties "<<temp.toLatin1();
+                qCHotDebug(lcParser)<<"edge properties "<<temp.toLatin1();
                 readDotProperties(temp, edgeWeight, edgeLabel, edgeShape, edgeColor, fontName, fontColor );
             }
             else{
-                qDebug("* Edge definition found - no properties...");
+                qCHotDebug(lcParser, "* Edge definition found - no properties...");
                 edgeLabel="";
                 edgeColor=initEdgeColor;
                 edgeWeight=initEdgeWeight;
@@ -3462,7 +4013,7 @@ bool Parser::loadDot(){
             //FIXME Cannot parse nodes named with '-' character
             str=str.mid(0, end).remove('\"');  //keep only edges
 
-            qDebug()<<"edge "<<str.toLatin1();
+            qCHotDebug(lcParser)<<"edge "<<str.toLatin1();
 
             if (!str.contains("->",Qt::CaseInsensitive) ){  //non directed = symmetric links
                 if ( str.contains("--",Qt::CaseInsensitive) )
@@ -3478,13 +4029,13 @@ bool Parser::loadDot(){
             //Create all nodes defined in nodeSequence
             for ( QList<QString>::iterator it=nodeSequence.begin(); it!=nodeSequence.end(); it++ )  {
                 node=(*it).simplified();
-                qDebug () << " nodeSequence node "<< node;
+                qCHotDebug(lcParser) << " nodeSequence node "<< node;
                 if ( (aNum=nodesDiscovered.indexOf( node ) ) == -1) {
                     //node not discovered before
                     totalNodes++;
                     randX=rand()%gwWidth;
                     randY=rand()%gwHeight;
-                    qDebug()<<" *** Creating node "<< totalNodes
+                    qCHotDebug(lcParser)<<" *** Creating node "<< totalNodes
                            << " at "<< randX <<","<< randY
                            <<" label "<<node.toLatin1()
                           << " colored "<< nodeColor
@@ -3501,11 +4052,11 @@ bool Parser::loadDot(){
                                 initNodeShape, QString(), false
                                 );
                     nodesDiscovered.push_back( node  );
-                    qDebug()<<" * Total totalNodes "
+                    qCHotDebug(lcParser)<<" * Total totalNodes "
                            << totalNodes<< " nodesDiscovered  "<< nodesDiscovered.size() ;
                     target=totalNodes;
                     if (it!=nodeSequence.begin()) {
-                        qDebug()<<"-- Drawing Link between node "
+                        qCHotDebug(lcParser)<<"-- Drawing Link between node "
                                << source<< " and node " <<target;
                         emit edgeCreate(source,target, edgeWeight, edgeColor,
                                         edgeDirType, arrows, bezier);
@@ -3514,9 +4065,9 @@ bool Parser::loadDot(){
                 else {
                     //node discovered before
                     target=aNum+1;
-                    qDebug("# Node already exists. Vector num: %i ",target);
+                    qCHotDebug(lcParser, "# Node already exists. Vector num: %i ",target);
                     if (it!=nodeSequence.begin()) {
-                        qDebug()<<"-- Drawing Link between node "
+                        qCHotDebug(lcParser)<<"-- Drawing Link between node "
                                <<source<<" and node " << target;
                         emit edgeCreate(source,target, edgeWeight , edgeColor,
                                         edgeDirType, arrows, bezier);
@@ -3525,32 +4076,32 @@ bool Parser::loadDot(){
                 source=target;
             }
             nodeSequence.clear();
-            qDebug("Finished reading fileLine %i ",fileLine);
+            qCHotDebug(lcParser, "Finished reading fileLine %i ",fileLine);
         }
         else if ( str.contains ("[",Qt::CaseInsensitive)
              && str.contains("=")
                   && !netProperties )
         { 	 //Default node properties - no node keyword
 
-            qDebug("* Node properties found but with no Node keyword in the beginning!");
+            qCHotDebug(lcParser, "* Node properties found but with no Node keyword in the beginning!");
             start=str.indexOf('[');
             end=str.indexOf(']');
             temp=str.mid(start+1, end-start-1);  //keep whatever is inside [ and ]
-            qDebug()<<"Properties start at "<< start<< " and end at " << end;
+            qCHotDebug(lcParser)<<"Properties start at "<< start<< " and end at " << end;
             temp=temp.simplified();
-            qDebug()<<temp.toLatin1();
+            qCHotDebug(lcParser)<<temp.toLatin1();
             readDotProperties(temp, nodeValue, label, nodeShape, nodeColor, fontName, fontColor );
-            qDebug ("Finished the properties!");
+            qCHotDebug(lcParser, "Finished the properties!");
 
             if (start > 2 ) {//there is a node definition here
                 node=str.left(start).remove('\"').simplified();
-                qDebug()<<"node label: "<<node.toLatin1()<<"." ;
+                qCHotDebug(lcParser)<<"node label: "<<node.toLatin1()<<"." ;
                 if (!nodesDiscovered.contains(node)) {
-                    qDebug("not discovered node");
+                    qCHotDebug(lcParser, "not discovered node");
                     totalNodes++;
                     randX=rand()%gwWidth;
                     randY=rand()%gwHeight;
-                    qDebug()<<"***  Creating node at "<<  randX << " "<< randY<< " label "<<node.toLatin1() << " colored "<< nodeColor;
+                    qCHotDebug(lcParser)<<"***  Creating node at "<<  randX << " "<< randY<< " label "<<node.toLatin1() << " colored "<< nodeColor;
                     emit createNode(
                                 totalNodes, initNodeSize, nodeColor,
                                 initNodeNumberColor, initNodeNumberSize,
@@ -3560,16 +4111,16 @@ bool Parser::loadDot(){
                                 );
                     aNum=totalNodes;
                     nodesDiscovered.push_back( node);
-                    qDebug()<<" Total totalNodes: "<<  totalNodes<< " nodesDiscovered = "<< nodesDiscovered.size();
+                    qCHotDebug(lcParser)<<" Total totalNodes: "<<  totalNodes<< " nodesDiscovered = "<< nodesDiscovered.size();
                 }
                 else {
-                    qDebug("discovered node - skipping it!");
+                    qCHotDebug(lcParser, "discovered node - skipping it!");
                 }
             }
         }
 
         else {
-            qDebug() <<  "  Redudant data: "<< str.toLatin1();
+            qCHotDebug(lcParser) <<  "  Redudant data: "<< str.toLatin1();
         }
     }
     file.close();
@@ -3609,20 +4160,20 @@ void Parser::readDotProperties(QString str, qreal &nValue, QString &label,
 
 
         if ( str.indexOf('\"') == 0) {
-            qDebug("found text, parsing...");
+            qCHotDebug(lcParser, "found text, parsing...");
             next=str.indexOf('\"', 1);
             value=str.left(next).simplified().remove('\"');
 
             if (prop=="label") {
                 label=value.trimmed();
-                qDebug()<<"Found label "<<value.toLatin1() <<". Assigned label "<<label.toLatin1();
+                qCHotDebug(lcParser)<<"Found label "<<value.toLatin1() <<". Assigned label "<<label.toLatin1();
             }
             else if (prop=="fontname"){
-                qDebug()<<"Found fontname"<<value.toLatin1();
+                qCHotDebug(lcParser)<<"Found fontname"<<value.toLatin1();
                 fontName=value.trimmed();
             }
             str=str.right(str.count()-next-1).simplified();
-            qDebug()<<"whatsleft: "<<str.toLatin1() <<".";
+            qCHotDebug(lcParser)<<"whatsleft: "<<str.toLatin1() <<".";
         }
         else {
             if (str.isEmpty()) break;
@@ -3639,36 +4190,36 @@ void Parser::readDotProperties(QString str, qreal &nValue, QString &label,
                 value=str;
             }
 
-            qDebug()<<"Prop Value: "<<value.toLatin1() ;
+            qCHotDebug(lcParser)<<"Prop Value: "<<value.toLatin1() ;
             if (prop=="value") {
-                qDebug()<<"Found value "<<value.toLatin1();
+                qCHotDebug(lcParser)<<"Found value "<<value.toLatin1();
                 nValue=value.trimmed().toFloat(&ok);
                 if ( ok )
-                    qDebug()<<"Assigned value "<<nValue;
+                    qCHotDebug(lcParser)<<"Assigned value "<<nValue;
                 else
-                    qDebug()<<"Error in value conversion ";
+                    qCHotDebug(lcParser)<<"Error in value conversion ";
             }
             else if (prop=="color") {
                 color=value.trimmed();
-                qDebug()<<"Found color "<<value.toLatin1()  <<". Assigned color "<<color.toLatin1()<<".";
+                qCHotDebug(lcParser)<<"Found color "<<value.toLatin1()  <<". Assigned color "<<color.toLatin1()<<".";
             }
             else if (prop=="fillcolor") {
-                qDebug()<<"Found color "<<value.toLatin1();
+                qCHotDebug(lcParser)<<"Found color "<<value.toLatin1();
                 color=value.trimmed();
-                qDebug()<<"Assigned node color "<<color.toLatin1()<<".";
+                qCHotDebug(lcParser)<<"Assigned node color "<<color.toLatin1()<<".";
             }
 
             else if (prop=="fontcolor") {
-                qDebug()<<"Found fontcolor "<<value.toLatin1();
+                qCHotDebug(lcParser)<<"Found fontcolor "<<value.toLatin1();
                 fontColor=value.trimmed();
             }
             else if (prop=="shape") {
                 shape=value.trimmed();
-                qDebug()<<"Found node shape "<<shape.toLatin1();
+                qCHotDebug(lcParser)<<"Found node shape "<<shape.toLatin1();
             }
-            qDebug()<<"count"<< str.count()<<  " next "<< next;
+            qCHotDebug(lcParser)<<"count"<< str.count()<<  " next "<< next;
             str=str.right(str.count()-next-1).simplified();
-            qDebug()<<"whatsleft: "<<str.toLatin1()<<".";
+            qCHotDebug(lcParser)<<"whatsleft: "<<str.toLatin1()<<".";
             if ( (next=str.indexOf('=', 1))==-1) break;
         }
     } while (!str.isEmpty());
@@ -3718,7 +4269,11 @@ othername somename 2
 bool Parser::loadEdgeListWeighed(const QString &delimiter){
     qDebug() << "Parser::loadEdgeListWeighed() - column delimiter" << delimiter ;
 
-    QFile file ( fileName );
+    if ( edgeListFastPathSupported(delimiter) ) {
+        return loadEdgeListFast(true);
+    }
+
+    CompressedFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly ))
         return false;
     QTextStream ts( &file );
@@ -3776,7 +4331,7 @@ bool Parser::loadEdgeListWeighed(const QString &delimiter){
              || str.contains("xml",Qt::CaseInsensitive)
               )
              ) {
-            qDebug()<< "Parser::loadEdgeListWeighed() - "
+            qCHotDebug(lcParser)<< "Parser::loadEdgeListWeighed() - "
                        "Not a Weighted list-formatted file. Aborting!!";
             file.close();
             errorMessage = tr("Not an EdgeList-formatted file. "
@@ -3787,7 +4342,7 @@ bool Parser::loadEdgeListWeighed(const QString &delimiter){
         lineElement=str.split(delimiter);
 
         if ( lineElement.count()  != 3 ) {
-            qDebug()<< "*** Parser::loadEdgeListWeighed() - "
+            qCHotDebug(lcParser)<< "*** Parser::loadEdgeListWeighed() - "
                        "Not a Weighted list-formatted file. Aborting!!";
             file.close();
             errorMessage = tr("Not a properly EdgeList-formatted file. "
@@ -3808,13 +4363,13 @@ bool Parser::loadEdgeListWeighed(const QString &delimiter){
                 << edge_weight;
 
         if (!edge_source.contains(onlyDigitsExp)) {
-            qDebug()<< "Parser::loadEdgeListWeighed() - node named by non-digit only string. "
+            qCHotDebug(lcParser)<< "Parser::loadEdgeListWeighed() - node named by non-digit only string. "
                        "nodesWithLabels = true";
             nodesWithLabels = true;
         }
 
         if (!edge_target.contains(onlyDigitsExp)) {
-            qDebug()<< "Parser::loadEdgeListWeighed() - node named by non-digit only string. "
+            qCHotDebug(lcParser)<< "Parser::loadEdgeListWeighed() - node named by non-digit only string. "
                        "nodesWithLabels = true";
             nodesWithLabels = true;
         }
@@ -3868,7 +4423,7 @@ bool Parser::loadEdgeListWeighed(const QString &delimiter){
                 nodeQ.push( sourceActor );
                 nodeMap.insert(edge_source, edge_source.toInt() );
             }
-            qDebug()<< "Parser::loadEdgeListWeighed() - source, new node named"
+            qCHotDebug(lcParser)<< "Parser::loadEdgeListWeighed() - source, new node named"
                     << edge_source
                     << "totalNodes" << totalNodes
                     << "nodeMap.count"
@@ -3876,7 +4431,7 @@ bool Parser::loadEdgeListWeighed(const QString &delimiter){
 
         }
         else {
-            qDebug()<< "Parser::loadEdgeListWeighed() - source already found, continue";
+            qCHotDebug(lcParser)<< "Parser::loadEdgeListWeighed() - source already found, continue";
         }
         if ( ! nodeMap.contains(edge_target) ) {
             totalNodes++;
@@ -3894,7 +4449,7 @@ bool Parser::loadEdgeListWeighed(const QString &delimiter){
                 nodeQ.push( targetActor );
                 nodeMap.insert(edge_target, edge_target.toInt() );
             }
-            qDebug()<< "Parser::loadEdgeListWeighed() - target, new node named"
+            qCHotDebug(lcParser)<< "Parser::loadEdgeListWeighed() - target, new node named"
                     << edge_target
                     << "totalNodes" << totalNodes
                     << "nodeMap.count"
@@ -3902,23 +4457,23 @@ bool Parser::loadEdgeListWeighed(const QString &delimiter){
 
         }
         else {
-            qDebug()<< "Parser::loadEdgeListWeighed() - target already found, continue";
+            qCHotDebug(lcParser)<< "Parser::loadEdgeListWeighed() - target already found, continue";
         }
 
         edgeWeight = edge_weight.toDouble(&conversionOK);
         if (conversionOK) {
-            qDebug()<< "Parser::loadEdgeListWeighed() - read edge weight"
+            qCHotDebug(lcParser)<< "Parser::loadEdgeListWeighed() - read edge weight"
                     << edgeWeight;
         }
         else {
             edgeWeight = 1.0;
-            qDebug()<< "Parser::loadEdgeListWeighed() - error reading edge weight."
+            qCHotDebug(lcParser)<< "Parser::loadEdgeListWeighed() - error reading edge weight."
                        "Using default edgeWeight"
                     << edgeWeight;
         }
         edgeKey = edge_source + edgeKeyDelimiter + edge_target;
         if ( ! edgeList.contains( edgeKey ) ) {
-            qDebug()<< "Parser::loadEdgeListWeighed() - inserting edgeKey"
+            qCHotDebug(lcParser)<< "Parser::loadEdgeListWeighed() - inserting edgeKey"
                     << edgeKey
                     << "in edgeList with weight" << edgeWeight;
             edgeList.insert( edgeKey, edgeWeight );
@@ -3943,7 +4498,7 @@ bool Parser::loadEdgeListWeighed(const QString &delimiter){
         randY=rand()%gwHeight;
 
         if (nodesWithLabels) {
-            qDebug() << "Parser::loadEdgeListWeighed() - creating node named"
+            qCHotDebug(lcParser) << "Parser::loadEdgeListWeighed() - creating node named"
                      << node.key << "numbered" << node.value
                      << "at position" << QPointF(randX, randY);
             emit createNode( node.value,
@@ -3960,7 +4515,7 @@ bool Parser::loadEdgeListWeighed(const QString &delimiter){
         }
         else {
 
-            qDebug() << "Parser::loadEdgeListWeighed() - creating node named"
+            qCHotDebug(lcParser) << "Parser::loadEdgeListWeighed() - creating node named"
                      << node.key << "numbered" << node.key.toInt()
                      << "at position" << QPointF(randX, randY);
             emit createNode( node.key.toInt(),
@@ -4027,7 +4582,12 @@ bool Parser::loadEdgeListWeighed(const QString &delimiter){
 
 bool Parser::loadEdgeListSimple(const QString &delimiter){
     qDebug() << "Parser::loadEdgeListSimple() - column delimiter" << delimiter ;
-    QFile file ( fileName );
+
+    if ( edgeListFastPathSupported(delimiter) ) {
+        return loadEdgeListFast(false);
+    }
+
+    CompressedFile file ( fileName );
     if ( ! file.open(QIODevice::ReadOnly ))
         return false;
     QTextStream ts( &file );
@@ -4088,7 +4648,7 @@ bool Parser::loadEdgeListSimple(const QString &delimiter){
              || str.contains("xml",Qt::CaseInsensitive)
               )
              ) {
-            qDebug()<< "*** Parser:loadEdgeListSimple(): Not an EdgeList-formatted file. Aborting!!";
+            qCHotDebug(lcParser)<< "*** Parser:loadEdgeListSimple(): Not an EdgeList-formatted file. Aborting!!";
             errorMessage = tr("Not an EdgeList-formatted file. "
                               "Non-comment line %1 includes keywords reserved by other file formats (i.e vertices, graphml, network, graph, digraph, DL, xml)")
                     .arg(fileLine);
@@ -4101,7 +4661,7 @@ bool Parser::loadEdgeListSimple(const QString &delimiter){
         for (QStringList::Iterator it1 = lineElement.begin(); it1!=lineElement.end(); ++it1)   {
             edge_source = (*it1);
             if (!edge_source.contains(onlyDigitsExp)) {
-                qDebug()<< "Parser::loadEdgeListSimple() - node named by non-digit only string. "
+                qCHotDebug(lcParser)<< "Parser::loadEdgeListSimple() - node named by non-digit only string. "
                            "nodesWithLabels = true";
                 nodesWithLabels = true;
             }
@@ -4138,7 +4698,7 @@ bool Parser::loadEdgeListSimple(const QString &delimiter){
             columnCount ++;
             if (columnCount == 1) {  // source node
                 edge_source = (*it1);
-                qDebug()<< "Parser::loadEdgeListSimple() - Dissecting line - "
+                qCHotDebug(lcParser)<< "Parser::loadEdgeListSimple() - Dissecting line - "
                            "source node:"
                         << edge_source;
 
@@ -4160,7 +4720,7 @@ bool Parser::loadEdgeListSimple(const QString &delimiter){
                         nodeQ.push( sourceActor );
                         nodeMap.insert(edge_source, edge_source.toInt() );
                     }
-                    qDebug()<< "Parser::loadEdgeListSimple() - source, new node named"
+                    qCHotDebug(lcParser)<< "Parser::loadEdgeListSimple() - source, new node named"
                             << edge_source
                             << "totalNodes" << totalNodes
                             << "nodeMap.count"
@@ -4168,12 +4728,12 @@ bool Parser::loadEdgeListSimple(const QString &delimiter){
 
                 }
                 else {
-                    qDebug()<< "Parser::loadEdgeListWeighed() - source already found, continue";
+                    qCHotDebug(lcParser)<< "Parser::loadEdgeListWeighed() - source already found, continue";
                 }
             }
             else { // target nodes
                 edge_target= (*it1);
-                qDebug()<< "Parser::loadEdgeListSimple() - Dissecting line - "
+                qCHotDebug(lcParser)<< "Parser::loadEdgeListSimple() - Dissecting line - "
                            "target node:"
                         << edge_target;
 
@@ -4194,7 +4754,7 @@ bool Parser::loadEdgeListSimple(const QString &delimiter){
                         nodeQ.push( targetActor );
                         nodeMap.insert(edge_target, edge_target.toInt() );
                     }
-                    qDebug()<< "Parser::loadEdgeListSimple() - target, new node named"
+                    qCHotDebug(lcParser)<< "Parser::loadEdgeListSimple() - target, new node named"
                             << edge_target
                             << "totalNodes" << totalNodes
                             << "nodeMap.count"
@@ -4202,7 +4762,7 @@ bool Parser::loadEdgeListSimple(const QString &delimiter){
 
                 }
                 else {
-                    qDebug()<< "Parser::loadEdgeListSimple() - target already found, continue";
+                    qCHotDebug(lcParser)<< "Parser::loadEdgeListSimple() - target already found, continue";
                 }
 
             }
@@ -4210,7 +4770,7 @@ bool Parser::loadEdgeListSimple(const QString &delimiter){
             if (columnCount > 1)  {
                 edgeKey = edge_source + edgeKeyDelimiter + edge_target;
                 if ( ! edgeList.contains( edgeKey ) ) {
-                    qDebug()<< "Parser::loadEdgeListSimple() - inserting edgeKey"
+                    qCHotDebug(lcParser)<< "Parser::loadEdgeListSimple() - inserting edgeKey"
                             << edgeKey
                             << "in edgeList with initial weight" << initEdgeWeight;
                     edgeList.insert( edgeKey, initEdgeWeight );
@@ -4219,7 +4779,7 @@ bool Parser::loadEdgeListSimple(const QString &delimiter){
                 else { // if edge already discovered, then increase its weight by 1
                     edgeWeight = edgeList.value(edgeKey);
                     edgeWeight = edgeWeight + 1;
-                    qDebug()<< "Parser::loadEdgeListSimple() - edgeKey"
+                    qCHotDebug(lcParser)<< "Parser::loadEdgeListSimple() - edgeKey"
                             << edgeKey
                             << "found before, adding in edgeList with increased weight"
                             << edgeWeight;
@@ -4243,7 +4803,7 @@ bool Parser::loadEdgeListSimple(const QString &delimiter){
          randY=rand()%gwHeight;
 
          if (nodesWithLabels) {
-             qDebug() << "Parser::loadEdgeListSimple() - creating node named"
+             qCHotDebug(lcParser) << "Parser::loadEdgeListSimple() - creating node named"
                       << node.key << "numbered" << node.value
                       << "at position" << QPointF(randX, randY);
              emit createNode( node.value,
@@ -4260,7 +4820,7 @@ bool Parser::loadEdgeListSimple(const QString &delimiter){
          }
          else {
 
-             qDebug() << "Parser::loadEdgeListSimple() - creating node named"
+             qCHotDebug(lcParser) << "Parser::loadEdgeListSimple() - creating node named"
                       << node.key << "numbered" << node.key.toInt()
                       << "at position" << QPointF(randX, randY);
              emit createNode( node.key.toInt(),
@@ -4323,6 +4883,266 @@ bool Parser::loadEdgeListSimple(const QString &delimiter){
 
 
 
+/**
+ * @brief Returns true if the edge list can be read by loadEdgeListFast(), that
+ * is, if its columns are separated by spaces and its text codec is UTF-8 or
+ * Latin-1, so that lines and columns can be found in the raw bytes.
+ * @param delimiter
+ * @return
+ */
+bool Parser::edgeListFastPathSupported(const QString &delimiter) const {
+    const QString codec = userSelectedCodecName.toUpper();
+    return delimiter == " "
+            && ( codec == "UTF-8" || codec == "ISO-8859-1" || codec == "LATIN1" );
+}
+
+
+
+/**
+ * @brief Loads a simple or weighted edge list, the fast way:
+ * The file is memory-mapped and cut into chunks at line ends, which are parsed
+ * in parallel into node ids of per-chunk dictionaries. The chunks are then
+ * merged, in file order, into one dictionary, so that nodes are numbered just
+ * like loadEdgeListWeighed() and loadEdgeListSimple() number them.
+ * Duplicate edges keep their first weight in weighted lists, and add 1 to
+ * their weight in simple lists. All edges go to the Graph in one
+ * edgeCreateList() call.
+ * @param weighted
+ * @return
+ */
+bool Parser::loadEdgeListFast(const bool &weighted) {
+
+    qDebug() << "Parser::loadEdgeListFast() - weighted:" << weighted;
+
+    CompressedFile file ( fileName );
+    if ( ! file.open(QIODevice::ReadOnly ))
+        return false;
+
+    totalNodes = 0;
+    totalLinks = 0;
+    initEdgeWeight = 1.0;
+    edgeDirType = EdgeType::Directed;
+    arrows = true;
+    bezier = false;
+
+    relationsList.clear();
+
+    // Compressed files cannot be mapped; they are decompressed into memory.
+    qint64 fileSize = file.size();
+    QByteArray contents;
+    const char *data = 0;
+    if ( fileSize > 0 ) {
+        data = reinterpret_cast<const char *>( file.map(0, fileSize) );
+    }
+    if ( !data && ( fileSize > 0 || file.isCompressed() ) ) {
+        qDebug() << "Parser::loadEdgeListFast() - cannot map file, reading it";
+        contents = file.readAll();
+        data = contents.constData();
+        fileSize = contents.size();
+    }
+    const char *end = data + fileSize;
+    if ( fileSize >= 3 && memcmp( data, "\xEF\xBB\xBF", 3 ) == 0 ) {
+        data += 3;   // UTF-8 byte order mark
+    }
+    const bool utf8 = ( userSelectedCodecName.toUpper() == "UTF-8" );
+
+    // Cut the file in chunks of at least 1MB, ending at line ends
+    const qint64 minChunkSize = 1 << 20;
+    const int chunkCount = (int) qBound( (qint64) 1,
+                                         (qint64) ( end - data ) / minChunkSize,
+                                         (qint64) 4 * qMax( 1, QThread::idealThreadCount() ) );
+    QVector<EdgeListChunk> chunks(chunkCount);
+    const char *chunkBegin = data;
+    for (int c = 0; c < chunkCount; ++c) {
+        const char *chunkEnd = ( c == chunkCount - 1 )
+                ? end
+                : qMin( end, data + ( end - data ) * ( c + 1 ) / chunkCount );
+        while ( chunkEnd < end && chunkEnd > chunkBegin && chunkEnd[-1] != '\n' ) {
+            ++chunkEnd;
+        }
+        chunks[c].begin = chunkBegin;
+        chunks[c].end = qMax( chunkBegin, chunkEnd );
+        chunks[c].weighted = weighted;
+        chunkBegin = chunks[c].end;
+    }
+
+    QtConcurrent::blockingMap( chunks, edgeListParseChunk );
+
+    // The first non-comment line must not be in another format
+    int linesBefore = 0;
+    for (int c = 0; c < chunkCount; ++c) {
+        if ( chunks[c].firstDataLine >= 0 ) {
+            const QString str = ( utf8
+                                  ? QString::fromUtf8( chunks[c].firstDataBegin,
+                                                       (int) ( chunks[c].firstDataEnd - chunks[c].firstDataBegin ) )
+                                  : QString::fromLatin1( chunks[c].firstDataBegin,
+                                                         (int) ( chunks[c].firstDataEnd - chunks[c].firstDataBegin ) )
+                                  ).simplified();
+            if ( str.contains("vertices",Qt::CaseInsensitive)
+                 || str.contains("network",Qt::CaseInsensitive)
+                 || str.contains("graph",Qt::CaseInsensitive)
+                 || str.contains("digraph",Qt::CaseInsensitive)
+                 || str.contains("DL n",Qt::CaseInsensitive)
+                 || str == "DL"
+                 || str == "dl"
+                 || str.contains("list",Qt::CaseInsensitive)
+                 || str.contains("graphml",Qt::CaseInsensitive)
+                 || str.contains("xml",Qt::CaseInsensitive) ) {
+                qCHotDebug(lcParser)<< "Parser::loadEdgeListFast() - Not an EdgeList-formatted file. Aborting!!";
+                errorMessage = tr("Not an EdgeList-formatted file. "
+                                  "Non-comment line %1 includes keywords reserved by other file formats (i.e vertices, graphml, network, graph, digraph, DL, xml)")
+                        .arg( linesBefore + chunks[c].firstDataLine );
+                file.close();
+                return false;
+            }
+            break;
+        }
+        linesBefore += chunks[c].lines;
+    }
+
+    linesBefore = 0;
+    for (int c = 0; c < chunkCount; ++c) {
+        if ( chunks[c].errorLine >= 0 ) {
+            qCHotDebug(lcParser)<< "Parser::loadEdgeListFast() - Not a Weighted list-formatted file. Aborting!!";
+            errorMessage = tr("Not a properly EdgeList-formatted file. "
+                              "Row %1 has not 3 elements as expected (i.e. source, target, weight)")
+                    .arg( linesBefore + chunks[c].errorLine );
+            file.close();
+            return false;
+        }
+        linesBefore += chunks[c].lines;
+    }
+
+    // Merge the chunk dictionaries, in file order
+    EdgeListDictionary dictionary;
+    QVector< vector<int> > localToGlobal(chunkCount);
+    bool nodesWithLabels = false;
+    for (int c = 0; c < chunkCount; ++c) {
+        const EdgeListDictionary &local = chunks[c].dictionary;
+        localToGlobal[c].resize( local.size() );
+        for (int id = 0; id < local.size(); ++id) {
+            localToGlobal[c][id] = dictionary.intern( local.keys[id],
+                                                      local.lengths[id],
+                                                      local.hashes[id] );
+        }
+        nodesWithLabels = nodesWithLabels || chunks[c].labels;
+    }
+
+    qDebug() << "Parser::loadEdgeListFast() - chunks:" << chunkCount
+             << "distinct nodes:" << dictionary.size()
+             << "nodesWithLabels:" << nodesWithLabels;
+
+    // Number the nodes: by first appearance if named with labels,
+    // else by the number in the file.
+    vector<int> number( dictionary.size() );
+    vector< pair<int,int> > nodeOrder;   // (number, dictionary id)
+    nodeOrder.reserve( dictionary.size() );
+    for (int id = 0; id < dictionary.size(); ++id) {
+        if ( nodesWithLabels ) {
+            number[id] = id + 1;
+        }
+        else {
+            qint64 n = 0;
+            for (int i = 0; i < dictionary.lengths[id] && n <= INT_MAX; ++i) {
+                n = n * 10 + ( dictionary.keys[id][i] - '0' );
+            }
+            number[id] = ( n <= INT_MAX ) ? (int) n : 0;
+        }
+        nodeOrder.push_back( make_pair( number[id], id ) );
+    }
+    if ( !nodesWithLabels ) {
+        sort( nodeOrder.begin(), nodeOrder.end() );
+    }
+
+    // create nodes one by one
+    int lastNumber = -1;
+    for (const pair<int,int> &node : nodeOrder) {
+        if ( node.first == lastNumber ) {
+            continue;   // another name of the same number, i.e. 07 and 7
+        }
+        lastNumber = node.first;
+        const char *key = dictionary.keys[node.second];
+        const int length = dictionary.lengths[node.second];
+        randX=rand()%gwWidth;
+        randY=rand()%gwHeight;
+        emit createNode( node.first,
+                         initNodeSize,
+                         initNodeColor,
+                         initNodeNumberColor,
+                         initNodeNumberSize,
+                         utf8 ? QString::fromUtf8(key, length) : QString::fromLatin1(key, length),
+                         initNodeLabelColor, initNodeLabelSize,
+                         QPointF(randX, randY),
+                         initNodeShape,QString(),
+                         false
+                         );
+        totalNodes++;
+    }
+
+    // collect the edges, without duplicates
+    QVector<int> sources, targets;
+    QVector<qreal> weights;
+    QHash<quint64, int> edgeIndex;
+    int edges = 0;
+    for (int c = 0; c < chunkCount; ++c) {
+        edges += (int) chunks[c].tokens.size();
+    }
+    sources.reserve(edges);
+    targets.reserve(edges);
+    weights.reserve(edges);
+    edgeIndex.reserve(edges);
+
+    for (int c = 0; c < chunkCount; ++c) {
+        const EdgeListChunk &chunk = chunks[c];
+        int lineBegin = 0;
+        for (size_t line = 0; line < chunk.lineEnds.size(); ++line) {
+            const int lineEnd = chunk.lineEnds[line];
+            const int s = number[ localToGlobal[c][ chunk.tokens[lineBegin] ] ];
+            for (int k = lineBegin + 1; k < lineEnd; ++k) {
+                const int t = number[ localToGlobal[c][ chunk.tokens[k] ] ];
+                const quint64 key = ( (quint64) (uint) s << 32 ) | (uint) t;
+                QHash<quint64, int>::iterator it = edgeIndex.find(key);
+                if ( it == edgeIndex.end() ) {
+                    edgeIndex.insert( key, sources.size() );
+                    sources << s;
+                    targets << t;
+                    weights << ( weighted ? chunk.weights[line] : initEdgeWeight );
+                }
+                else if ( !weighted ) {
+                    // if edge already discovered, then increase its weight by 1
+                    weights[ it.value() ] += 1;
+                }
+            }
+            lineBegin = lineEnd;
+        }
+    }
+    file.close();
+
+    totalLinks = sources.size();
+
+    qDebug() << "Parser::loadEdgeListFast() - creating" << totalLinks << "edges";
+
+    emit edgeCreateList(sources, targets, weights,
+                        initEdgeColor,
+                        edgeDirType,
+                        arrows,
+                        bezier);
+
+    if (relationsList.count() == 0) {
+        emit addRelation("unnamed");
+    }
+
+    //The network has been loaded. Tell MW the statistics and network type
+    emit networkFileLoaded( weighted ? FileType::EDGELIST_WEIGHTED : FileType::EDGELIST_SIMPLE,
+                            fileName, networkName,
+                            totalNodes, totalLinks, edgeDirType);
+    qDebug() << "Parser::loadEdgeListFast() - END. Returning.";
+
+    return true;
+}
+
+
+
 
 //Returns true if QString str is a comment inside the network file.
 bool Parser::isComment(QString str){
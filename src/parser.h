@@ -34,6 +34,8 @@
 #include <QPointF>
 #include <QObject>
 #include <QMultiMap>
+#include <QVector>
+#include <QPair>
 #include <QDebug>
 class QXmlStreamReader;
 class QXmlStreamAttributes;
@@ -98,6 +100,8 @@ public:
 
     bool loadEdgeListSimple(const QString &delimiter);
     bool loadEdgeListWeighed(const QString &delimiter);
+    bool edgeListFastPathSupported(const QString &delimiter) const;
+    bool loadEdgeListFast(const bool &weighted);
 	bool loadTwoModeSociomatrix();
 
     void readDotProperties(QString str, qreal &, QString &label,
@@ -112,6 +116,7 @@ public:
 	void readGraphMLElementData (QXmlStreamReader &);
 	void readGraphMLElementUnknown (QXmlStreamReader &);
 	void readGraphMLElementKey (QXmlStreamAttributes &);
+    int graphMLKeyRole (const QStringRef &keyId) const;
 	bool xmlStreamHasAttribute( QXmlStreamAttributes &, QString ) const ;
 	void readGraphMLElementDefaultValue(QXmlStreamReader &);
 	void readGraphMLElementNodeGraphics (QXmlStreamReader &);
@@ -151,6 +156,11 @@ signals:
                      const bool &arrows, const bool &bezier,
                      const QString &edgeLabel=QString(),
                      const bool &signalMW=false);
+    void edgeCreateList (const QVector<int> &sources, const QVector<int> &targets,
+                         const QVector<qreal> &weights,
+                         const QString &color, const int &edgeDirType,
+                         const bool &arrows, const bool &bezier,
+                         const bool &uniqueEdges=true);
     void networkFileLoaded(int fileType,
                            QString fileName,
                            QString netName,
@@ -166,8 +176,27 @@ signals:
 protected:
 
 private: 
+    /** What a GraphML data key sets, resolved once per key definition */
+    enum GraphMLKeyRole {
+        KeyUnknown = 0,
+        KeyNodeColor,
+        KeyNodeLabel,
+        KeyNodeX,
+        KeyNodeY,
+        KeyNodeSize,
+        KeyNodeLabelSize,
+        KeyNodeLabelColor,
+        KeyNodeShape,
+        KeyNodeCustomIcon,
+        KeyEdgeColor,
+        KeyEdgeWeight,
+        KeyEdgeArrowSize,
+        KeyEdgeLabel
+    };
+
     QHash<QString, int> nodeHash;
 	QHash<QString, QString> keyFor, keyName, keyType, keyDefaultValue ;
+    QVector<QPair<QString, int> > keyRoles;
     QHash<QString, QString> edgesMissingNodesHash;
     QStringList edgeMissingNodesList,edgeMissingNodesListData, relationsList;
 	QMultiMap<int, int> firstModeMultiMap, secondModeMultiMap;
@@ -0,0 +1,512 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         sparsematrix.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "sparsematrix.h"
+
+#include <QtDebug>
+#include <QtConcurrent>
+#include <algorithm>
+
+#include "matrix.h"
+
+
+
+/**
+ * @brief SparseMatrix::SparseMatrix
+ * Creates an empty (all zero) sparse matrix of the given dimension
+ * @param rowDim
+ * @param colDim
+ */
+SparseMatrix::SparseMatrix(int rowDim, int colDim)
+{
+    resize(rowDim, colDim);
+    finish();
+}
+
+
+
+/**
+ * @brief Drops all elements, the matrix becomes 0x0
+ */
+void SparseMatrix::clear() {
+    resize(0, 0);
+    finish();
+}
+
+
+
+/**
+ * @brief Resizes this matrix to an empty m x n matrix, ready to be filled
+ * with appendItem(). Call finish() when done.
+ * @param m
+ * @param n
+ */
+void SparseMatrix::resize(const int m, const int n) {
+    m_rows = m;
+    m_cols = n;
+    m_filledRows = 0;
+    m_offsets.fill(0, m_rows + 1);
+    m_columns.clear();
+    m_values.clear();
+}
+
+
+
+/**
+ * @brief Reserves space for the given number of non-zero elements
+ * @param nonZeros
+ */
+void SparseMatrix::reserve(const int &nonZeros) {
+    m_columns.reserve(nonZeros);
+    m_values.reserve(nonZeros);
+}
+
+
+
+/**
+ * @brief Appends element (r,c) to the matrix.
+ * Elements must be given in row-major order: r never decreases and,
+ * within a row, c strictly increases. Zero elements are not stored.
+ * @param r
+ * @param c
+ * @param elem
+ */
+void SparseMatrix::appendItem(const int &r, const int &c, const qreal &elem) {
+    Q_ASSERT( r >= m_filledRows - 1 && r < m_rows );
+    if ( elem == 0 ) {
+        return;
+    }
+    while ( m_filledRows <= r ) {
+        m_offsets[m_filledRows++] = m_columns.size();
+    }
+    m_columns.append(c);
+    m_values.append(elem);
+}
+
+
+
+/**
+ * @brief Closes the rows of a matrix filled by appendItem().
+ */
+void SparseMatrix::finish() {
+    while ( m_filledRows <= m_rows ) {
+        m_offsets[m_filledRows++] = m_columns.size();
+    }
+}
+
+
+
+/**
+ * @brief Returns the fraction of non-zero elements, nnz / (m x n)
+ * @return
+ */
+qreal SparseMatrix::density() const {
+    if ( m_rows == 0 || m_cols == 0 ) {
+        return 0;
+    }
+    return static_cast<qreal>( nonZeros() ) / m_rows / m_cols;
+}
+
+
+
+/**
+ * @brief Returns the (r,c) element. Binary search in row r, O(log nnz(r))
+ * @param r
+ * @param c
+ * @return
+ */
+qreal SparseMatrix::item(const int r, const int c) const {
+    const int *begin = m_columns.constData() + m_offsets[r];
+    const int *end = m_columns.constData() + m_offsets[r+1];
+    const int *found = std::lower_bound(begin, end, c);
+    if ( found != end && *found == c ) {
+        return m_values[ found - m_columns.constData() ];
+    }
+    return 0;
+}
+
+
+
+/**
+ * @brief Exchanges the contents of this matrix with b, in constant time
+ * @param b
+ */
+void SparseMatrix::swap(SparseMatrix &b) noexcept {
+    std::swap(m_rows, b.m_rows);
+    std::swap(m_cols, b.m_cols);
+    std::swap(m_filledRows, b.m_filledRows);
+    m_offsets.swap(b.m_offsets);
+    m_columns.swap(b.m_columns);
+    m_values.swap(b.m_values);
+}
+
+
+
+/**
+ * @brief Calculates the matrix-by-vector product (SpMV) of this matrix
+ * Default product: out = A in
+ * if leftMultiply=true then it returns the left product out = in A
+ * @param in vector of size cols() (rows() for the left product)
+ * @param out vector of size rows() (cols() for the left product)
+ * @param leftMultiply
+ */
+void SparseMatrix::productByVector(const qreal in[],
+                                   qreal out[],
+                                   const bool &leftMultiply) const {
+    if ( !leftMultiply ) {
+        for (int i = 0; i < m_rows; ++i) {
+            qreal sum = 0;
+            for (int e = m_offsets[i]; e < m_offsets[i+1]; ++e) {
+                sum += m_values[e] * in[ m_columns[e] ];
+            }
+            out[i] = sum;
+        }
+        return;
+    }
+    std::fill(out, out + m_cols, 0.0);
+    for (int i = 0; i < m_rows; ++i) {
+        const qreal x = in[i];
+        if ( x == 0 ) {
+            continue;
+        }
+        for (int e = m_offsets[i]; e < m_offsets[i+1]; ++e) {
+            out[ m_columns[e] ] += x * m_values[e];
+        }
+    }
+}
+
+
+
+/*
+ * Sparse product kernel (Gustavson's row-by-row SpGEMM).
+ * Row i of P = A * B is the sum of the rows k of B scaled by A(i,k).
+ * They are gathered in a dense accumulator of B.cols() elements, while a
+ * marker array records the columns touched, so each row costs only the
+ * number of multiplications it needs. Row blocks are computed in parallel
+ * and concatenated.
+ */
+
+static const int SPGEMM_ROW_BLOCK = 256;
+
+struct SpGemmBlock {
+    int begin;
+    int end;
+    QVector<int> counts;
+    QVector<int> columns;
+    QVector<qreal> values;
+};
+
+
+/**
+ * @brief Computes the sparse product P = A * B into this matrix.
+ * A and B may be this matrix.
+ * @param A m x n
+ * @param B n x p
+ */
+void SparseMatrix::product(const SparseMatrix &A, const SparseMatrix &B) {
+    qDebug()<< "SparseMatrix::product() - nnz(A)" << A.nonZeros()
+            << "nnz(B)" << B.nonZeros();
+
+    if ( A.cols() != B.rows() ) {
+        qDebug()<< "SparseMatrix::product() - ERROR! Non compatible input matrices:"
+                   " a("
+                << A.rows() << "," << A.cols()
+                << ") and b(" << B.rows() << ","<< B.cols();
+        return;
+    }
+
+    const int m = A.rows();
+    const int p = B.cols();
+
+    QVector<SpGemmBlock> blocks;
+    for (int i = 0; i < m; i += SPGEMM_ROW_BLOCK) {
+        SpGemmBlock block;
+        block.begin = i;
+        block.end = qMin(i + SPGEMM_ROW_BLOCK, m);
+        blocks << block;
+    }
+
+    QtConcurrent::blockingMap(blocks, [&A, &B, p](SpGemmBlock &block) {
+        QVector<qreal> accumulator(p, 0);
+        QVector<int> marker(p, -1);
+        QVector<int> touched;
+        touched.reserve(p);
+        block.counts.reserve(block.end - block.begin);
+        for (int i = block.begin; i < block.end; ++i) {
+            touched.clear();
+            for (int ea = A.rowBegin(i); ea < A.rowEnd(i); ++ea) {
+                const int k = A.column(ea);
+                const qreal a = A.value(ea);
+                for (int eb = B.rowBegin(k); eb < B.rowEnd(k); ++eb) {
+                    const int j = B.column(eb);
+                    if ( marker[j] != i ) {
+                        marker[j] = i;
+                        accumulator[j] = 0;
+                        touched.append(j);
+                    }
+                    accumulator[j] += a * B.value(eb);
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            int count = 0;
+            for (const int &j : touched) {
+                if ( accumulator[j] != 0 ) {
+                    block.columns.append(j);
+                    block.values.append(accumulator[j]);
+                    ++count;
+                }
+            }
+            block.counts.append(count);
+        }
+    });
+
+    // A or B may be this matrix, so collect into a new one and take it
+    SparseMatrix P;
+    P.resize(m, p);
+    int nonZeros = 0;
+    for (const SpGemmBlock &block : blocks) {
+        nonZeros += block.columns.size();
+    }
+    P.reserve(nonZeros);
+    for (const SpGemmBlock &block : blocks) {
+        int e = 0;
+        for (int i = block.begin; i < block.end; ++i) {
+            P.m_offsets[i] = P.m_columns.size();
+            const int rowEnd = e + block.counts[i - block.begin];
+            for (; e < rowEnd; ++e) {
+                P.m_columns.append(block.columns[e]);
+                P.m_values.append(block.values[e]);
+            }
+        }
+    }
+    P.m_filledRows = m;
+    P.finish();
+
+    swap(P);
+}
+
+
+
+/**
+ * @brief Returns the n-nth power of this matrix
+ * @param n
+ * @return SparseMatrix
+ */
+SparseMatrix SparseMatrix::pow(int n) const {
+    SparseMatrix P;
+    pow(P, n);
+    return P;
+}
+
+
+
+/**
+ * @brief Computes the n-nth power of this square matrix into P,
+ * by exponentiation by squaring with sparse products.
+ * @param P must not be this matrix
+ * @param n the power, n >= 0
+ */
+void SparseMatrix::pow(SparseMatrix &P, int n) const {
+    if ( rows() != cols() ) {
+        qDebug()<< "SparseMatrix::pow() - Error. This works only for square matrix";
+        P = *this;
+        return;
+    }
+    qDebug()<< "SparseMatrix::pow() - n" << n;
+
+    SparseMatrix X(*this);
+    bool first = true;
+
+    while ( n > 0 ) {
+        if ( n & 1 ) {
+            if ( first ) {
+                P = X;
+                first = false;
+            }
+            else {
+                P.product(P, X);
+            }
+        }
+        n >>= 1;
+        if ( n > 0 ) {
+            X.product(X, X);
+        }
+    }
+    if ( first ) {
+        // n <= 0, by convention X^0 = I
+        P.resize(rows(), rows());
+        P.reserve(rows());
+        for (int i = 0; i < rows(); ++i) {
+            P.appendItem(i, i, 1);
+        }
+        P.finish();
+    }
+}
+
+
+
+/**
+ * @brief Returns the transpose of this matrix
+ * @return SparseMatrix T
+ */
+SparseMatrix SparseMatrix::transpose() const {
+    SparseMatrix T;
+    transpose(T);
+    return T;
+}
+
+
+
+/**
+ * @brief Computes the transpose of this matrix into T (that is, the CSC
+ * layout of this matrix), with a counting sort by column, O(nnz + n).
+ * @param T must not be this matrix
+ */
+void SparseMatrix::transpose(SparseMatrix &T) const {
+    qDebug()<< "SparseMatrix::transpose()";
+    T.m_rows = m_cols;
+    T.m_cols = m_rows;
+    T.m_offsets.fill(0, m_cols + 1);
+    T.m_columns.resize(nonZeros());
+    T.m_values.resize(nonZeros());
+    for (int e = 0; e < nonZeros(); ++e) {
+        ++T.m_offsets[ m_columns[e] + 1 ];
+    }
+    for (int c = 0; c < m_cols; ++c) {
+        T.m_offsets[c+1] += T.m_offsets[c];
+    }
+    QVector<int> next(T.m_offsets.constBegin(), T.m_offsets.constEnd() - 1);
+    for (int i = 0; i < m_rows; ++i) {
+        for (int e = m_offsets[i]; e < m_offsets[i+1]; ++e) {
+            const int slot = next[ m_columns[e] ]++;
+            T.m_columns[slot] = i;
+            T.m_values[slot] = m_values[e];
+        }
+    }
+    T.m_filledRows = T.m_rows + 1;
+}
+
+
+
+/**
+ * @brief Returns the Degree Matrix of this matrix.
+ * @return SparseMatrix D
+ */
+SparseMatrix SparseMatrix::degreeMatrix() const {
+    SparseMatrix D;
+    degreeMatrix(D);
+    return D;
+}
+
+
+
+/**
+ * @brief Computes the Degree Matrix of this matrix into D, the diagonal
+ * matrix of the row sums (as Matrix::degreeMatrix)
+ * @param D must not be this matrix
+ */
+void SparseMatrix::degreeMatrix(SparseMatrix &D) const {
+    qDebug()<< "SparseMatrix::degreeMatrix()";
+    D.resize(m_rows, m_cols);
+    D.reserve(m_rows);
+    for (int i = 0; i < m_rows; ++i) {
+        qreal degree = 0;
+        for (int e = m_offsets[i]; e < m_offsets[i+1]; ++e) {
+            degree += m_values[e];
+        }
+        D.appendItem(i, i, degree);
+    }
+    D.finish();
+}
+
+
+
+/**
+ * @brief Returns the Laplacian L = D - A of this matrix.
+ * @return SparseMatrix L
+ */
+SparseMatrix SparseMatrix::laplacianMatrix() const {
+    SparseMatrix L;
+    laplacianMatrix(L);
+    return L;
+}
+
+
+
+/**
+ * @brief Computes the Laplacian L = D - A of this square matrix into L,
+ * in one pass: each row is the negated row of A with the degree added
+ * on the diagonal.
+ * @param L must not be this matrix
+ */
+void SparseMatrix::laplacianMatrix(SparseMatrix &L) const {
+    qDebug()<< "SparseMatrix::laplacianMatrix()";
+    L.resize(m_rows, m_cols);
+    L.reserve(nonZeros() + m_rows);
+    for (int i = 0; i < m_rows; ++i) {
+        qreal degree = 0;
+        for (int e = m_offsets[i]; e < m_offsets[i+1]; ++e) {
+            degree += m_values[e];
+        }
+        bool diagonalDone = false;
+        for (int e = m_offsets[i]; e < m_offsets[i+1]; ++e) {
+            const int j = m_columns[e];
+            if ( !diagonalDone && j >= i ) {
+                diagonalDone = true;
+                if ( j == i ) {
+                    L.appendItem(i, i, degree - m_values[e]);
+                    continue;
+                }
+                L.appendItem(i, i, degree);
+            }
+            L.appendItem(i, j, - m_values[e]);
+        }
+        if ( !diagonalDone ) {
+            L.appendItem(i, i, degree);
+        }
+    }
+    L.finish();
+}
+
+
+
+/**
+ * @brief Expands this matrix into the dense matrix M
+ * @param M
+ */
+void SparseMatrix::toDense(Matrix &M) const {
+    qDebug()<< "SparseMatrix::toDense() -" << m_rows << "x" << m_cols
+            << "nnz" << nonZeros();
+    M.resize(m_rows, m_cols);
+    for (int i = 0; i < m_rows; ++i) {
+        qreal *row = M[i];
+        for (int e = m_offsets[i]; e < m_offsets[i+1]; ++e) {
+            row[ m_columns[e] ] = m_values[e];
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         sparsematrix.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef SPARSEMATRIX_H
+#define SPARSEMATRIX_H
+
+#include <QtGlobal>
+#include <QVector>
+
+class Matrix;
+
+
+/**
+ * @brief The SparseMatrix class
+ * A real m x n matrix in compressed sparse row (CSR) format: only the non-zero
+ * elements are stored, row after row, each row sorted by column.
+ * Memory and the cost of the products scale with the number of non-zeros,
+ * not with m x n, so it is used instead of Matrix for adjacency matrices of
+ * sparse networks (see Graph::graphMatrixAdjacencyCreate).
+ * The API follows Matrix where possible. A matrix is built once, with
+ * resize() followed by appendItem() calls in row-major order and finish().
+ */
+class SparseMatrix
+{
+public:
+    SparseMatrix (int rowDim=0, int colDim=0);
+
+    void clear();
+
+    void resize (const int m, const int n);
+
+    void reserve (const int &nonZeros);
+
+    void appendItem (const int &r, const int &c, const qreal &elem);
+
+    void finish();
+
+    int rows() const { return m_rows; }
+
+    int cols() const { return m_cols; }
+
+    /** Number of stored (non-zero) elements */
+    int nonZeros() const { return m_columns.size(); }
+
+    qreal density() const;
+
+    qreal item (const int r, const int c) const;
+
+    int rowBegin(const int &r) const { return m_offsets[r]; }
+    int rowEnd(const int &r) const { return m_offsets[r+1]; }
+    int column(const int &e) const { return m_columns[e]; }
+    qreal value(const int &e) const { return m_values[e]; }
+
+    void productByVector (const qreal in[],
+                          qreal out[],
+                          const bool &leftMultiply=false) const;
+
+    void product (const SparseMatrix &A, const SparseMatrix &B);
+
+    SparseMatrix pow (int n) const;
+    void pow (SparseMatrix &P, int n) const;
+
+    SparseMatrix transpose() const;
+    void transpose(SparseMatrix &T) const;
+
+    SparseMatrix degreeMatrix() const;
+    void degreeMatrix(SparseMatrix &D) const;
+
+    SparseMatrix laplacianMatrix() const;
+    void laplacianMatrix(SparseMatrix &L) const;
+
+    void toDense(Matrix &M) const;
+
+    void swap(SparseMatrix &b) noexcept;
+
+private:
+    int m_rows;
+    int m_cols;
+    int m_filledRows;           // rows whose start offset is already set
+
+    QVector<int> m_offsets;     // m_rows+1 row start offsets
+    QVector<int> m_columns;     // column of each non-zero
+    QVector<qreal> m_values;    // value of each non-zero
+};
+
+#endif // SPARSEMATRIX_H
@@ -34,7 +34,22 @@ TextEditor::TextEditor(const QString &fileName, QWidget *parent, const bool &for
     formatHTML(format)
 {
 	qDebug("TextEditor()");
-	textEdit = new QTextEdit;
+    if (formatHTML) {
+        // Reports link to their other pages, i.e. large matrices,
+        // which open in this same window.
+        QTextBrowser *browser = new QTextBrowser;
+        browser->setReadOnly(false);
+        browser->setTextInteractionFlags(Qt::TextEditorInteraction
+                                         | Qt::LinksAccessibleByMouse
+                                         | Qt::LinksAccessibleByKeyboard);
+        browser->setOpenLinks(false);
+        connect(browser, SIGNAL(anchorClicked(QUrl)),
+                this, SLOT(openLink(QUrl)));
+        textEdit = browser;
+    }
+    else {
+        textEdit = new QTextEdit;
+    }
 	setCentralWidget(textEdit);
 
 	createActions();
@@ -104,6 +119,22 @@ bool TextEditor::saveAs()
     return saveFile(fileName);
 }
 
+/**
+ * @brief Opens a link of an HTML report: local files in this window, the
+ * rest in the system browser.
+ * @param url
+ */
+void TextEditor::openLink(const QUrl &url)
+{
+    const QUrl target = QUrl::fromLocalFile(curFile).resolved(url);
+    if (!target.isLocalFile()) {
+        QDesktopServices::openUrl(target);
+        return;
+    }
+    if (maybeSave())
+        loadFile(target.toLocalFile());
+}
+
 void TextEditor::documentWasModified()
 {
     setWindowModified(textEdit->document()->isModified());
@@ -34,6 +34,7 @@ Written in Qt
 class QAction;
 class QMenu;
 class QTextEdit;
+class QUrl;
 
 class TextEditor : public QMainWindow
 {
@@ -53,6 +54,7 @@ private slots:
 	bool saveAs();
 	void about();
 	void documentWasModified();
+    void openLink(const QUrl &url);
 //protected:
 //    bool canInsertFromMimeData(const QMimeData *source) const;
 //    void insertFromMimeData(const QMimeData *source) ;
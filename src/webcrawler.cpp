@@ -28,11 +28,10 @@
 
 #include "webcrawler.h"
 
-#include <QCryptographicHash>
-
 #include <QDebug>
-#include <QQueue>
-#include <QNetworkReply>
+#include <QDataStream>
+
+#include <cctype>
 
 
 /**
@@ -44,7 +43,6 @@
  * @param intLinks
  */
 WebCrawler::WebCrawler(
-        QQueue<QUrl> *urlQueue,
         const QUrl &startUrl,
         const QStringList &urlPatternsIncluded,
         const QStringList &urlPatternsExcluded,
@@ -64,8 +62,6 @@ WebCrawler::WebCrawler(
               << thread()
               << "Initializing variables ";
 
-    m_urlQueue = urlQueue;
-
     m_initialUrl = startUrl;
 
     // Initialize user-defined control variables and limits
@@ -98,11 +94,7 @@ WebCrawler::WebCrawler(
                           << "plus.google.com";
 
 
-    knownUrls.clear();                              // a map of all known urls to their node number
-
-    m_discoveredNodes=1;                            // Counts discovered nodes -- Set the counter to 1, as we already know the initial url
-
-    knownUrls[m_initialUrl]=m_discoveredNodes;      // Add the initial url to the map of known urls as node numbered 1.
+    reset();
 
     qDebug() << "WebCrawler::load() - initialUrl:" << m_initialUrl.toString()
              << " m_maxUrls " << m_maxUrls
@@ -118,39 +110,70 @@ WebCrawler::WebCrawler(
 
 
 /**
- * @brief Called from Graph when a network reply for a new page download has finished
- * to do the actual parsing of that page's html source from the reply bytearray.
- * First, we start by reading all from http reply to a QString called page.
- * Then we parse the page string, searching for url substrings.
- * @param reply
+ * @brief Returns the streaming state of the page of currentUrl, creating it
+ * the first time data arrive for that page.
+ * Returns nullptr if currentUrl is not a url we have discovered,
+ * i.e. a late reply of a previous crawl.
+ * @param currentUrl
+ * @return
  */
-void WebCrawler::parse(QNetworkReply *reply){
+WebCrawlerPage *WebCrawler::page(const QUrl &currentUrl) {
+    WebCrawlerPage *p = m_pages.value(currentUrl, nullptr);
+    if ( p == nullptr ) {
+        if ( !knownUrls.contains(currentUrl) ) {
+            qDebug() << "WebCrawler::page() - unknown url" << currentUrl.toString();
+            return nullptr;
+        }
+        p = new WebCrawlerPage;
+        p->url = currentUrl;
+        p->sourceNode = knownUrls.value(currentUrl);
+        p->baseUrl = QUrl( currentUrl.scheme() + "://" + currentUrl.host() );
+        m_pages.insert(currentUrl, p);
+    }
+    return p;
+}
 
-    qDebug () << "WebCrawler::parse() - thread:" << this->thread();
 
-    // Find to which node the response HTML belongs to
-    // Get this from the reply object request method
-    QUrl currentUrl = reply->request().url();
-    QString currentUrlStr = currentUrl.toString();
-    QString locationHeader = reply->header(QNetworkRequest::LocationHeader).toString();
-    int sourceNode = knownUrls [ currentUrl ];
-    QString scheme = currentUrl.scheme();
-    QString host = currentUrl.host();
-    QUrl baseUrl = QUrl( scheme + "://" + host);
-    QString path = currentUrl.path();
-    qDebug() << "WebCrawler::parse() - HTML of url "
-             << currentUrlStr << " sourceNode " << sourceNode;
-    qDebug() << "WebCrawler::parse() - host " << host
-             << " path " << path;
 
+/**
+ * @brief Called from Graph every time a new chunk of the html source of a
+ * page arrives. Feeds the chunk to the tokenizer of that page, which parses
+ * the links while the page is still being downloaded.
+ * @param currentUrl the requested url
+ * @param data the new bytes of the html code
+ */
+void WebCrawler::parseData(const QUrl &currentUrl, const QByteArray &data){
+    WebCrawlerPage *p = page(currentUrl);
+    if ( p && !p->done ) {
+        tokenize(p, data);
+    }
+}
+
+
+
+/**
+ * @brief Called from Graph when a network reply for a page download has finished,
+ * with the last bytes of the page, if any.
+ * If the reply is a redirect, the Location url becomes a new link.
+ * Otherwise, the last bytes are parsed and the page is forgotten.
+ * @param currentUrl the requested url
+ * @param locationHeader the Location header of the reply, if any
+ * @param ba the last bytes of the html code
+ */
+void WebCrawler::parse(const QUrl &currentUrl,
+                       const QString &locationHeader,
+                       const QByteArray &ba){
 
-    //    qDebug () << "WebCrawler::parse() -  original locationHeader"
-    //              << reply->header(QNetworkRequest::LocationHeader) ;
-    //    qDebug () << "WebCrawler::parse() -  decoded locationHeader" << locationHeader ;
+    qDebug () << "WebCrawler::parse() - thread:" << this->thread();
 
-    //    qDebug () << "WebCrawler::parse() -  encoded currentUrl  " << currentUrl;
-    //    qDebug () << "WebCrawler::parse() -  decoded currentUrl " << currentUrlStr;
+    QString currentUrlStr = currentUrl.toString();
+    WebCrawlerPage *p = page(currentUrl);
+    if ( !p ) {
+        return;
+    }
 
+    qDebug() << "WebCrawler::parse() - HTML of url "
+             << currentUrlStr << " sourceNode " << p->sourceNode;
 
     // Check for redirects
     if ( locationHeader != "" && locationHeader != currentUrlStr ) {
@@ -158,335 +181,501 @@ void WebCrawler::parse(QNetworkReply *reply){
                   << locationHeader
                   << " differs from currentUrl " << currentUrlStr
                   << " Creating node redirect - Creating edge - RETURN ";
+        const int sourceNode = p->sourceNode;
+        m_pages.remove(currentUrl);
+        delete p;
         newLink( sourceNode, locationHeader , true );
         return;
     }
 
+    if ( !p->done ) {
+        tokenize(p, ba);
+    }
 
-    QUrl newUrl;
-    QString newUrlStr;
-    int start=-1, end=-1, equal=-1 , invalidUrlsInPage =0; // index=-1;
-    int validUrlsInPage = 0;
+    qDebug() << "WebCrawler::parse() - finished page" << currentUrlStr
+             << "bytes" << p->bytes
+             << "validUrlsInPage" << p->validUrls
+             << "invalidUrlsInPage" << p->invalidUrls;
 
-    QByteArray ba = reply->readAll();       // read all data from the reply into a bytearray
-    QString page(ba);                       // construct a QString from the bytearray
+    m_pages.remove(currentUrl);
+    delete p;
+}
 
-    // Create a md5 hash of the page code
-    QString md5(QCryptographicHash::hash(ba,QCryptographicHash::Md5).toHex());
 
-    qDebug () << "WebCrawler::parse() - MD5 sum:" << md5.toLocal8Bit();
 
-    // If there are no links inside the HTML source, return
-    if (!page.contains ("href"))  {
+/**
+ * @brief Scans the new bytes of a page, one by one, and keeps just the tag
+ * being read. Comments and the contents of script and style elements are
+ * skipped. Every complete tag goes to parseTag().
+ * Nothing else of the page is kept in memory.
+ * @param p
+ * @param data
+ */
+void WebCrawler::tokenize(WebCrawlerPage *p, const QByteArray &data) {
+
+    const char *c = data.constData();
+    const int size = data.size();
+    p->bytes += size;
+
+    for (int i = 0; i < size && !p->done; ++i) {
+        const char ch = c[i];
+        switch ( p->state ) {
+        case WebCrawlerPage::Text:
+            if ( ch == '<' ) {
+                p->state = WebCrawlerPage::Tag;
+                p->tag.clear();
+                p->quote = 0;
+            }
+            break;
 
-        //FIXME: Frameset pages are not parsed! See docs/manual.html for example.
+        case WebCrawlerPage::Tag:
+            if ( p->quote != 0 ) {
+                if ( ch == p->quote ) {
+                    p->quote = 0;
+                }
+            }
+            else if ( ( ch == '"' || ch == '\'' ) && quoteStartsValue(p->tag) ) {
+                p->quote = ch;
+            }
+            else if ( ch == '>' ) {
+                p->state = WebCrawlerPage::Text;
+                parseTag(p);
+                break;
+            }
+            if ( p->tag.size() < 65536 ) {
+                p->tag.append(ch);
+            }
+            if ( p->tag.size() == 3 && p->tag == "!--" ) {
+                p->state = WebCrawlerPage::Comment;
+                p->matched = 0;
+            }
+            break;
 
-        qDebug() << "WebCrawler::parse() - Empty or not useful html from "
-                 << currentUrl
-                 << " page size " << page.size()
-                 << " \npage contents: " << page
-                 << " RETURN ##";
+        case WebCrawlerPage::Comment:
+            // ends with -->
+            if ( ch == '-' ) {
+                p->matched++;
+            }
+            else if ( ch == '>' && p->matched >= 2 ) {
+                p->state = WebCrawlerPage::Text;
+            }
+            else {
+                p->matched = 0;
+            }
+            break;
+
+        case WebCrawlerPage::RawText:
+            // ends with </script or </style, in any case
+            if ( tolower( (uchar) ch ) == p->rawTextEnd.at(p->matched) ) {
+                p->matched++;
+                if ( p->matched == p->rawTextEnd.size() ) {
+                    p->state = WebCrawlerPage::Tag;
+                    p->tag = p->rawTextEnd.mid(1);
+                    p->quote = 0;
+                }
+            }
+            else {
+                p->matched = ( ch == '<' ) ? 1 : 0;
+            }
+            break;
+        }
+    }
+}
 
-        return;
 
+
+/**
+ * @brief Returns true if a quote after the given tag bytes starts an
+ * attribute value, that is if the last non-space byte is =
+ * @param tag
+ * @return
+ */
+bool WebCrawler::quoteStartsValue(const QByteArray &tag) {
+    for (int i = tag.size() - 1; i >= 0; --i) {
+        if ( !isspace( (uchar) tag[i] ) ) {
+            return tag[i] == '=';
+        }
     }
+    return false;
+}
 
-    //    qDebug() <<  " \npage contents: " << page << endl << endl;
 
-    // We only search inside <body>...</body> tags
-    qDebug() << "WebCrawler::parse() - Finding <body></body> tags";
 
-    start=page.indexOf ("<body");
-    end=page.indexOf ("</body>");
+/**
+ * @brief Parses a complete tag, without its < and >.
+ * Keeps track of the <head> element, whose links are not followed, and of
+ * script and style elements. Passes the href of every other tag, if it has
+ * the link classes the user asked for, to parseUrl().
+ * @param p
+ */
+void WebCrawler::parseTag(WebCrawlerPage *p) {
 
-    if ( start != -1 && end != -1 ) {
-        page = page.remove(0, start);       // remove everything until <body>
-        end=page.indexOf ("</body>");       // find new index pos of </body>
-        page = page.left(end);              // keep everything until </body>
-    }
-    else if ( start == -1  ) {
-        qDebug() << "WebCrawler::parse() - ERROR IN opening <body> tag";
+    const QByteArray &tag = p->tag;
+    const int size = tag.size();
+
+    int i = 0;
+    while ( i < size && !isspace( (uchar) tag[i] ) && tag[i] != '/' ) {
+        i++;
     }
-    else if ( end == -1  ) {
-        qDebug() << "WebCrawler::parse() - ERROR IN locating closing </body> tag";
+    if ( tag.startsWith('/') ) {
+        i = 1;
+        while ( i < size && !isspace( (uchar) tag[i] ) ) {
+            i++;
+        }
     }
+    const QByteArray name = tag.left(i).toLower();
 
+    if ( name == "head" ) {
+        p->inHead = true;
+        return;
+    }
+    if ( name == "/head" || name == "body" ) {
+        p->inHead = false;
+    }
+    if ( ( name == "script" || name == "style" ) && !tag.endsWith('/') ) {
+        p->state = WebCrawlerPage::RawText;
+        p->rawTextEnd = "</" + name;
+        p->matched = 0;
+        return;
+    }
+    if ( p->inHead || name.startsWith('/') || name.startsWith('!') ) {
+        return;
+    }
 
-    // Main Loop: While there are more links in the page, parse them
-    while (page.contains(" href")) {
-
-        if (m_maxUrls>0) {
-            if (m_discoveredNodes >= m_maxUrls ) {
-                qDebug () <<"!!WebCrawler::parse() - Reached m_maxUrls! STOP ";
-                emit finished("message from parse() -  discoveredNodes > maxNodes");
-                return;
+    // Read the attributes
+    QByteArray href, linkClass;
+    bool hasHref = false;
+    while ( i < size ) {
+        while ( i < size && ( isspace( (uchar) tag[i] ) || tag[i] == '/' ) ) {
+            i++;
+        }
+        const int nameStart = i;
+        while ( i < size && tag[i] != '=' && tag[i] != '/' && !isspace( (uchar) tag[i] ) ) {
+            i++;
+        }
+        const QByteArray attribute = tag.mid(nameStart, i - nameStart).toLower();
+        while ( i < size && isspace( (uchar) tag[i] ) ) {
+            i++;
+        }
+        QByteArray value;
+        if ( i < size && tag[i] == '=' ) {
+            i++;
+            while ( i < size && isspace( (uchar) tag[i] ) ) {
+                i++;
+            }
+            if ( i < size && ( tag[i] == '"' || tag[i] == '\'' ) ) {
+                const char quote = tag[i++];
+                const int valueStart = i;
+                while ( i < size && tag[i] != quote ) {
+                    i++;
+                }
+                value = tag.mid(valueStart, i - valueStart);
+                i++;
+            }
+            else {
+                const int valueStart = i;
+                while ( i < size && !isspace( (uchar) tag[i] ) ) {
+                    i++;
+                }
+                value = tag.mid(valueStart, i - valueStart);
             }
         }
+        if ( attribute == "href" ) {
+            href = value;
+            hasHref = true;
+        }
+        else if ( attribute == "class" ) {
+            linkClass = value;
+        }
+        if ( attribute.isEmpty() && i < size ) {
+            i++;
+        }
+    }
 
-        // remove whitespace from the start and the end
-        // all whitespace sequence becomes single space
-        page=page.simplified();
+    if ( !hasHref ) {
+        return;
+    }
 
-        start=page.indexOf (" href");		//Find its pos
-        // Why " href" instead of "href"?
-        // Because href might be inside random strings/tokens or
-        // even in share links (ie. whatsapp://sadadasd &href=url)
-        // By searching for " href" we avoid some of these cases, without
-        // introducing other serious problems.
+    // Check if the link has one of the link classes the user asked for
+    if ( !m_linkClasses.isEmpty() ) {
+        const QStringList classes =
+                QString::fromUtf8(linkClass).split(' ', QString::SkipEmptyParts);
+        m_linkClassAllowed = false;
+        for (constIterator = m_linkClasses.constBegin();
+             constIterator != m_linkClasses.constEnd();
+             ++constIterator)  {
+            if ( (*constIterator).isEmpty() || classes.contains( *constIterator ) ) {
+                m_linkClassAllowed = true;
+                break;
+            }
+        }
+        if ( !m_linkClassAllowed ) {
+            qDebug() << "!!WebCrawler::parseTag() - link class" << linkClass
+                     << "not in allowed link classes. CONTINUE ";
+            return;
+        }
+    }
 
-        page = page.remove(0, start);		//erase everything up to href
+    parseUrl(p, QString::fromUtf8(href).replace("&amp;", "&").simplified());
+}
 
-        equal=page.indexOf ("=");			// Find next equal sign (=)
 
-        page = page.remove(0, equal+1);		//Erase everything up to =
 
-        if (page.startsWith("\"") ) {
-            page.remove(0,1);
-            end=page.indexOf ("\"");
-        }
-        else if (page.startsWith("\'") ){
-            page.remove(0,1);
-            end=page.indexOf ("\'");
-        }
-        else {
-            //end=page.indexOf ("\'");
+/**
+ * @brief Checks a url found in a page against the user options, and creates
+ * the new node and edge, if allowed.
+ * Marks the page as done and asks for its download to be aborted, when
+ * maxLinksPerPage is reached.
+ * @param p
+ * @param newUrlStr
+ */
+void WebCrawler::parseUrl(WebCrawlerPage *p, QString newUrlStr) {
+
+    const QUrl &currentUrl = p->url;
+    const QString currentUrlStr = currentUrl.toString();
+    const QString host = currentUrl.host();
+    const QString path = currentUrl.path();
+    const int sourceNode = p->sourceNode;
+
+    if (m_maxUrls>0) {
+        if (m_discoveredNodes >= m_maxUrls ) {
+            qDebug () <<"!!WebCrawler::parseUrl() - Reached m_maxUrls! STOP ";
+            p->done = true;
+            emit finished("message from parse() -  discoveredNodes > maxNodes");
+            return;
         }
+    }
 
-        newUrlStr=page.left(end);			//Save new url to newUrl :)
+    qDebug() << "WebCrawler::parseUrl() - found newUrlStr "<< newUrlStr;
 
-        newUrlStr=newUrlStr.simplified();
-        qDebug() << "WebCrawler::parse() - found newUrlStr "<< newUrlStr;
+    QUrl newUrl = QUrl(newUrlStr);
 
-        newUrl = QUrl(newUrlStr);
+    if (newUrl.isRelative()) {
+        qDebug() << "@@WebCrawler::parseUrl() - newUrl is RELATIVE. Merging baseUrl with this";
+        newUrl=p->baseUrl.resolved(newUrl);
+    }
 
-        if (newUrl.isRelative()) {
-            qDebug() << "@@WebCrawler::parse() - newUrl is RELATIVE. Merging baseUrl with this";
-            newUrl=baseUrl.resolved(newUrl);
+    if (!newUrl.isValid()) {
+        p->invalidUrls ++;
+        qDebug() << "@@WebCrawler::parseUrl() - found INVALID newUrl "
+                    << newUrl.toString()
+                    << " in page " << currentUrlStr
+                    << " Will CONTINUE only if invalidUrlsInPage < 200";
+        if (p->invalidUrls > 200) {
+            qDebug() << "@@WebCrawler::parseUrl() -  INVALID newUrls > 200";
+            p->done = true;
+            emit finished("invalidUrlsInPage > 200");
         }
+        return;
+    }
 
-        if (!newUrl.isValid()) {
-            invalidUrlsInPage ++;
-            qDebug() << "@@WebCrawler::parse() - found INVALID newUrl "
-                        << newUrl.toString()
-                        << " in page " << currentUrlStr
-                        << " Will CONTINUE only if invalidUrlsInPage < 200";
-            if (invalidUrlsInPage > 200) {
-                qDebug() << "@@WebCrawler::parse() -  INVALID newUrls > 200";
-                emit finished("invalidUrlsInPage > 200");
-                return;
-            }
-            continue;
-        }
+    // TODO - REMOVE LAST / FROM EVERY PATH NOT ONLY ROOT PATH
+    if (newUrl.path() == "/") {
+        newUrl.setPath("");
+    }
+
+    qDebug() << "@@WebCrawler::parseUrl() - found VALID newUrl: "
+             << newUrl.toString();
+
+
+    newUrlStr = newUrl.toString();
+
+    // Skip css, favicon, rss, ping, etc
+    if ( newUrlStr.startsWith("#", Qt::CaseInsensitive) ||
+         newUrlStr.endsWith("feed/", Qt::CaseInsensitive) ||
+         newUrlStr.endsWith("rss/", Qt::CaseInsensitive) ||
+         newUrlStr.endsWith("atom/", Qt::CaseInsensitive) ||
+         newUrl.fileName().endsWith("xmlrpc.php", Qt::CaseInsensitive) ||
+         newUrl.fileName().endsWith(".xml", Qt::CaseInsensitive) ||
+         newUrl.fileName().endsWith(".ico", Qt::CaseInsensitive) ||
+         newUrl.fileName().endsWith(".gif", Qt::CaseInsensitive) ||
+         newUrl.fileName().endsWith(".png", Qt::CaseInsensitive) ||
+         newUrl.fileName().endsWith(".jpg", Qt::CaseInsensitive) ||
+         newUrl.fileName().endsWith(".js", Qt::CaseInsensitive) ||
+         newUrl.fileName().endsWith(".css", Qt::CaseInsensitive) ||
+         newUrl.fileName().endsWith(".rsd", Qt::CaseInsensitive)   )    {
+        qDebug()<< "!!WebCrawler::parseUrl() -  # newUrl "
+                    << " seems a page resource or anchor (rss, favicon, etc) "
+                    << "Skipping...";
+        return;
+    }
 
-        // TODO - REMOVE LAST / FROM EVERY PATH NOT ONLY ROOT PATH
-        if (newUrl.path() == "/") {
-            newUrl.setPath("");
-        }
 
-        qDebug() << "@@WebCrawler::parse() - found VALID newUrl: "
-                 << newUrl.toString();
-
-
-        newUrlStr = newUrl.toString();
-
-        // Skip css, favicon, rss, ping, etc
-        if ( newUrlStr.startsWith("#", Qt::CaseInsensitive) ||
-             newUrlStr.endsWith("feed/", Qt::CaseInsensitive) ||
-             newUrlStr.endsWith("rss/", Qt::CaseInsensitive) ||
-             newUrlStr.endsWith("atom/", Qt::CaseInsensitive) ||
-             newUrl.fileName().endsWith("xmlrpc.php", Qt::CaseInsensitive) ||
-             newUrl.fileName().endsWith(".xml", Qt::CaseInsensitive) ||
-             newUrl.fileName().endsWith(".ico", Qt::CaseInsensitive) ||
-             newUrl.fileName().endsWith(".gif", Qt::CaseInsensitive) ||
-             newUrl.fileName().endsWith(".png", Qt::CaseInsensitive) ||
-             newUrl.fileName().endsWith(".jpg", Qt::CaseInsensitive) ||
-             newUrl.fileName().endsWith(".js", Qt::CaseInsensitive) ||
-             newUrl.fileName().endsWith(".css", Qt::CaseInsensitive) ||
-             newUrl.fileName().endsWith(".rsd", Qt::CaseInsensitive)   )    {
-            qDebug()<< "!!WebCrawler::parse() -  # newUrl "
-                        << " seems a page resource or anchor (rss, favicon, etc) "
-                        << "Skipping...";
+    // Check if newUrl is compatible with the url patterns the user asked for
+    m_urlPatternAllowed = true;
+    for (constIterator = m_urlPatternsIncluded.constBegin();
+         constIterator != m_urlPatternsIncluded.constEnd();
+         ++constIterator)  {
+        //qDebug() << (*constIterator).toLocal8Bit().constData() << endl;
+        urlPattern = (*constIterator).toLocal8Bit().constData();
+        if (urlPattern.isEmpty())
             continue;
+        if ( newUrl.toString().contains( urlPattern ) ) {
+            qDebug() << "--WebCrawler::parseUrl() -  newUrl in allowed url patterns:"
+                      << urlPattern
+                      <<"Parsing";
+            break;
         }
-
-
-        // Check if newUrl is compatible with the url patterns the user asked for
-        m_urlPatternAllowed = true;
-        for (constIterator = m_urlPatternsIncluded.constBegin();
-             constIterator != m_urlPatternsIncluded.constEnd();
-             ++constIterator)  {
-            //qDebug() << (*constIterator).toLocal8Bit().constData() << endl;
-            urlPattern = (*constIterator).toLocal8Bit().constData();
-            if (urlPattern.isEmpty())
-                continue;
-            if ( newUrl.toString().contains( urlPattern ) ) {
-                qDebug() << "--WebCrawler::parse() -  newUrl in allowed url patterns:"
-                          << urlPattern
-                          <<"Parsing";
-                break;
-            }
-            else {
-                qDebug() << "!!WebCrawler::parse() -  newUrl not in allowed url patterns. CONTINUE ";
-                m_urlPatternAllowed = false;
-            }
-
+        else {
+            qDebug() << "!!WebCrawler::parseUrl() -  newUrl not in allowed url patterns. CONTINUE ";
+            m_urlPatternAllowed = false;
         }
 
+    }
 
-        m_urlPatternNotAllowed = false;
-        for (constIterator = m_urlPatternsExcluded.constBegin();
-             constIterator != m_urlPatternsExcluded.constEnd();
-             ++constIterator)  {
-            //qDebug() << (*constIterator).toLocal8Bit().constData() << endl;
-            urlPattern = (*constIterator).toLocal8Bit().constData();
-            if (urlPattern.isEmpty())
-                continue;
-            if ( newUrl.toString().contains( urlPattern ) ) {
-                qDebug() << "!!WebCrawler::parse() -  newUrl in excluded url patterns:"
-                          << urlPattern
-                          << "CONTINUE ";
-                m_urlPatternNotAllowed = true;
-                break;
-            }
-            else {
-                qDebug() << "--WebCrawler::parse() -  newUrl not in excluded url patterns. Parsing";
-            }
 
+    m_urlPatternNotAllowed = false;
+    for (constIterator = m_urlPatternsExcluded.constBegin();
+         constIterator != m_urlPatternsExcluded.constEnd();
+         ++constIterator)  {
+        //qDebug() << (*constIterator).toLocal8Bit().constData() << endl;
+        urlPattern = (*constIterator).toLocal8Bit().constData();
+        if (urlPattern.isEmpty())
+            continue;
+        if ( newUrl.toString().contains( urlPattern ) ) {
+            qDebug() << "!!WebCrawler::parseUrl() -  newUrl in excluded url patterns:"
+                      << urlPattern
+                      << "CONTINUE ";
+            m_urlPatternNotAllowed = true;
+            break;
+        }
+        else {
+            qDebug() << "--WebCrawler::parseUrl() -  newUrl not in excluded url patterns. Parsing";
         }
 
+    }
 
-        if (m_urlPatternAllowed && !m_urlPatternNotAllowed) {
 
-            if ( newUrl.isRelative() ) {
-                newUrl = currentUrl.resolved(newUrl);
-                newUrlStr = newUrl.toString();
+    if (m_urlPatternAllowed && !m_urlPatternNotAllowed) {
 
-                qDebug() << "WebCrawler::parse() - newUrl is RELATIVE."
-                            << " host: " << host
-                            << " resolved url "
-                            << newUrl.toString();
+        if ( newUrl.isRelative() ) {
+            newUrl = currentUrl.resolved(newUrl);
+            newUrlStr = newUrl.toString();
 
-                if (!m_intLinks ){
-                    qDebug()<< "WebCrawler::parse() - Internal URLs forbidden."
-                            << " SKIPPING node creation";
-                    continue;
-                }
+            qDebug() << "WebCrawler::parseUrl() - newUrl is RELATIVE."
+                        << " host: " << host
+                        << " resolved url "
+                        << newUrl.toString();
 
-                if (currentUrl.path() == newUrl.path()) {
-                    if  (m_selfLinks) {
-                        qDebug()<< "WebCrawler::parse() - "
-                                <<  " Creating self link";
+            if (!m_intLinks ){
+                qDebug()<< "WebCrawler::parseUrl() - Internal URLs forbidden."
+                        << " SKIPPING node creation";
+                return;
+            }
 
-                        newLink(sourceNode, newUrl, false);
-                    }
-                    else {
-                        qDebug()<< "WebCrawler::parse() - "
-                                << "currentUrl.path() = newUrl.path()"
-                                <<  "Self links not allowed. CONTINUE.";
-                    }
+            if (currentUrl.path() == newUrl.path()) {
+                if  (m_selfLinks) {
+                    qDebug()<< "WebCrawler::parseUrl() - "
+                            <<  " Creating self link";
 
+                    newLink(sourceNode, newUrl, false);
                 }
                 else {
-                    qDebug()<< "WebCrawler::parse() - Internal URLs allowed. Calling newLink() ";
-                    this->newLink(sourceNode, newUrl, true);
-
+                    qDebug()<< "WebCrawler::parseUrl() - "
+                            << "currentUrl.path() = newUrl.path()"
+                            <<  "Self links not allowed. CONTINUE.";
                 }
+
             }
             else {
-                qDebug() << "WebCrawler::parse() - newUrl is ABSOLUTE.";
-
-                if ( newUrl.scheme() != "http"  && newUrl.scheme() != "https"  &&
-                     newUrl.scheme() != "ftp" && newUrl.scheme() != "ftps") {
-                    qDebug() << "WebCrawler::parse() - INVALID newUrl SCHEME"
-                                << newUrl.toString()
-                                << "CONTINUE.";
-                    continue;
-                }
+                qDebug()<< "WebCrawler::parseUrl() - Internal URLs allowed. Calling newLink() ";
+                this->newLink(sourceNode, newUrl, true);
 
-                if (  newUrl.host() != host  ) {
-                    qDebug()<< "WebCrawler::parse() - newUrl ABSOLUTE & EXTERNAL.";
-                    if ( !m_extLinksIncluded ) {
-                        qDebug()<< "WebCrawler::parse() - External URLs forbidden. CONTINUE";
-                        continue;
-                    }
-                    else {
-                        m_urlIsSocial = false;
-                        if ( !m_socialLinks ) {
-                            for (constIterator = m_socialLinksExcluded.constBegin();
-                                 constIterator != m_socialLinksExcluded.constEnd();
-                                 ++constIterator)  {
-                                urlPattern = (*constIterator).toLocal8Bit().constData();
-                                if ( newUrl.host().contains ( urlPattern) ) {
-                                    m_urlIsSocial = true;
-                                    break;
-                                }
-                            }
-                            if ( m_urlIsSocial) {
-                                qDebug() << "!!WebCrawler::parse() -  newUrl in excluded social links:"
-                                         << urlPattern
-                                         << "CONTINUE ";
-                                continue;
+            }
+        }
+        else {
+            qDebug() << "WebCrawler::parseUrl() - newUrl is ABSOLUTE.";
+
+            if ( newUrl.scheme() != "http"  && newUrl.scheme() != "https"  &&
+                 newUrl.scheme() != "ftp" && newUrl.scheme() != "ftps") {
+                qDebug() << "WebCrawler::parseUrl() - INVALID newUrl SCHEME"
+                            << newUrl.toString()
+                            << "CONTINUE.";
+                return;
+            }
+
+            if (  newUrl.host() != host  ) {
+                qDebug()<< "WebCrawler::parseUrl() - newUrl ABSOLUTE & EXTERNAL.";
+                if ( !m_extLinksIncluded ) {
+                    qDebug()<< "WebCrawler::parseUrl() - External URLs forbidden. CONTINUE";
+                    return;
+                }
+                else {
+                    m_urlIsSocial = false;
+                    if ( !m_socialLinks ) {
+                        for (constIterator = m_socialLinksExcluded.constBegin();
+                             constIterator != m_socialLinksExcluded.constEnd();
+                             ++constIterator)  {
+                            urlPattern = (*constIterator).toLocal8Bit().constData();
+                            if ( newUrl.host().contains ( urlPattern) ) {
+                                m_urlIsSocial = true;
+                                break;
                             }
                         }
-                        if ( m_extLinksCrawl ) {
-                            qDebug()<< "WebCrawler::parse() - External URLs included and to be crawled. Calling newLink()";
-                            newLink(sourceNode, newUrl, true);
-                        }
-                        else {
-                            qDebug()<< "WebCrawler::parse() - External URLs included but not to be crawled. Calling newLink() but the url will not be added to the queue";
-                            newLink(sourceNode, newUrl, false);
+                        if ( m_urlIsSocial) {
+                            qDebug() << "!!WebCrawler::parseUrl() -  newUrl in excluded social links:"
+                                     << urlPattern
+                                     << "CONTINUE ";
+                            return;
                         }
                     }
-                }
-                else {
-                    qDebug()<< "WebCrawler::parse() - newUrl ABSOLUTE & INTERNAL.";
-
-                    if (!m_intLinks){
-                        qDebug()<< "WebCrawler::parse() - Internal URLs forbidden."
-                                  << " SKIPPING node creation";
-                        continue;
-                    }
-
-                    if (  newUrl.path () == path && !m_selfLinks) {
-                        qDebug()<< "WebCrawler::parse() - "
-                                <<  "Self links forbidden. CONTINUE.";
-                        continue;
+                    if ( m_extLinksCrawl ) {
+                        qDebug()<< "WebCrawler::parseUrl() - External URLs included and to be crawled. Calling newLink()";
+                        newLink(sourceNode, newUrl, true);
                     }
-
-                    if ( newUrl.isParentOf(currentUrl) && !m_parentLinks ) {
-                        qDebug()<< "WebCrawler::parse() - "
-                                << "Parent URLs forbidden. CONTINUE";
-                        continue;
-                    }
-                    if ( currentUrl.isParentOf(newUrl) && !m_childLinks ) {
-                        qDebug()<< "WebCrawler::parse() - "
-                                << "Child URLs forbidden. CONTINUE";
-                        continue;
+                    else {
+                        qDebug()<< "WebCrawler::parseUrl() - External URLs included but not to be crawled. Calling newLink() but the url will not be added to the queue";
+                        newLink(sourceNode, newUrl, false);
                     }
-
-                    qDebug()<< "WebCrawler::parse() -  Internal, absolute newURL allowed. Calling newLink()";
-                    newLink(sourceNode, newUrl, true);
                 }
             }
+            else {
+                qDebug()<< "WebCrawler::parseUrl() - newUrl ABSOLUTE & INTERNAL.";
 
-        }
+                if (!m_intLinks){
+                    qDebug()<< "WebCrawler::parseUrl() - Internal URLs forbidden."
+                              << " SKIPPING node creation";
+                    return;
+                }
 
-        validUrlsInPage ++;
+                if (  newUrl.path () == path && !m_selfLinks) {
+                    qDebug()<< "WebCrawler::parseUrl() - "
+                            <<  "Self links forbidden. CONTINUE.";
+                    return;
+                }
 
-        qDebug() << "WebCrawler::parse() - validUrlsInPage " << validUrlsInPage << " in page " << currentUrlStr;
+                if ( newUrl.isParentOf(currentUrl) && !m_parentLinks ) {
+                    qDebug()<< "WebCrawler::parseUrl() - "
+                            << "Parent URLs forbidden. CONTINUE";
+                    return;
+                }
+                if ( currentUrl.isParentOf(newUrl) && !m_childLinks ) {
+                    qDebug()<< "WebCrawler::parseUrl() - "
+                            << "Child URLs forbidden. CONTINUE";
+                    return;
+                }
 
-        // If the user has specified a maxLinksPerPage limit then,
-        // if we have reached it, stop parsing this page
-        if ( m_maxLinksPerPage  != 0 ) {
-            if ( validUrlsInPage > m_maxLinksPerPage ) {
-                qDebug () <<"!!   wc_spider::parse() Reached m_maxLinksPerPage "
-                         <<m_maxLinksPerPage << " - STOP parsing this page."  ;
-                break;
+                qDebug()<< "WebCrawler::parseUrl() -  Internal, absolute newURL allowed. Calling newLink()";
+                newLink(sourceNode, newUrl, true);
             }
         }
 
-    } // end while there are more links
+    }
+
+    p->validUrls ++;
+
+    qDebug() << "WebCrawler::parseUrl() - validUrlsInPage " << p->validUrls << " in page " << currentUrlStr;
 
+    // If the user has specified a maxLinksPerPage limit then,
+    // if we have reached it, stop parsing this page and downloading it
+    if ( m_maxLinksPerPage  != 0 ) {
+        if ( p->validUrls > m_maxLinksPerPage ) {
+            qDebug () <<"!!WebCrawler::parseUrl() Reached m_maxLinksPerPage "
+                     <<m_maxLinksPerPage << " - STOP parsing this page."  ;
+            p->done = true;
+            emit signalAbortDownload(currentUrl);
+        }
+    }
 }
 
 
@@ -512,16 +701,16 @@ void WebCrawler::newLink(int s, QUrl target,  bool enqueue_to_frontier) {
 
 
     // check if the new url has been discovered previously
-    QMap<QUrl, int>::const_iterator index = knownUrls.find(target);
-    if (   index!= knownUrls.end() ) {
+    const int known = knownUrls.value(target);
+    if ( known != 0 ) {
         qDebug()<< "--WebCrawler::newLink() - target already discovered "
-                << " in knownUrls as node:" << index.value();
-        if  (s !=index.value()) {
+                << " in knownUrls as node:" << known;
+        if  (s != known) {
             qDebug()<< "--WebCrawler::newLink() - emitting signalCreateEdge"
                     << s << "->"
-                    << index.value()
+                    << known
                     << "then RETURN.";
-            emit signalCreateEdge (s, index.value() );
+            emit signalCreateEdge (s, known );
         }
         else {
             qDebug()<< "--WebCrawler::newLink() - Self links not allowed. RETURN.";
@@ -530,7 +719,9 @@ void WebCrawler::newLink(int s, QUrl target,  bool enqueue_to_frontier) {
     }
 
     m_discoveredNodes++;
-    knownUrls[target]=m_discoveredNodes;
+    knownUrls.insert(target, m_discoveredNodes);
+    const int depth = ( s > 0 && s < m_nodeDepth.size() ) ? m_nodeDepth[s] + 1 : 1;
+    m_nodeDepth.append(depth);
 
     qDebug()<< "**WebCrawler::newLink() - emitting signalCreateNode() " << m_discoveredNodes
             << " for url:"<< target.toString();
@@ -539,13 +730,10 @@ void WebCrawler::newLink(int s, QUrl target,  bool enqueue_to_frontier) {
 
     if (enqueue_to_frontier) {
 
-        m_urlQueue->enqueue(target);
-
-        qDebug()<< "**WebCrawler::newLink() - Enqueued new node to urlQueue "
-                   << " queue size: "<<  m_urlQueue->size()
-                   << " - emitting signalStartSpider()";
+        qDebug()<< "**WebCrawler::newLink() - emitting signalEnqueueUrl()"
+                << "to add the new node to the frontier, depth" << depth;
 
-        emit signalStartSpider();
+        emit signalEnqueueUrl(target, depth);
 
     }
     else {
@@ -562,11 +750,78 @@ void WebCrawler::newLink(int s, QUrl target,  bool enqueue_to_frontier) {
 
 
 
+/**
+ * @brief Forgets every url, but the initial one, which is node 1
+ */
+void WebCrawler::reset() {
+
+    knownUrls.clear();                              // an index of all known urls to their node number
+
+    m_discoveredNodes=1;                            // Counts discovered nodes -- Set the counter to 1, as we already know the initial url
+
+    knownUrls.insert(m_initialUrl, m_discoveredNodes);  // Add the initial url to the index of known urls as node numbered 1.
+
+    m_nodeDepth.clear();                            // the depth of each node from the initial url, by node number
+    m_nodeDepth << 0 << 0;
+}
+
+
+
+/**
+ * @brief Called from Graph to checkpoint the crawl. Writes what the crawler
+ * knows, the discovered nodes, their depths and the index of known urls,
+ * and emits it to Graph, which saves it with the frontier and the network.
+ * Every node and edge signalled before has already reached Graph by then.
+ */
+void WebCrawler::checkpoint() {
+    QByteArray state;
+    QDataStream out( &state, QIODevice::WriteOnly );
+    out.setVersion(QDataStream::Qt_5_0);
+    out << (qint32) m_discoveredNodes << m_nodeDepth;
+    knownUrls.write(out);
+    qDebug() << "WebCrawler::checkpoint() - discoveredNodes" << m_discoveredNodes
+             << "bytes" << state.size();
+    emit signalCheckpoint(state);
+}
+
+
+
+/**
+ * @brief Restores what the crawler knows from a checkpoint, to resume a crawl.
+ * Called from Graph before the crawler moves to its thread.
+ * If the data are not valid, the crawler starts over, see reset().
+ * @param state the data emitted by checkpoint()
+ * @return false if the data are not valid
+ */
+bool WebCrawler::restore(const QByteArray &state) {
+    QDataStream in( state );
+    in.setVersion(QDataStream::Qt_5_0);
+    qint32 discoveredNodes = 0;
+    QVector<int> nodeDepth;
+    in >> discoveredNodes >> nodeDepth;
+    if ( in.status() != QDataStream::Ok || discoveredNodes < 1
+         || nodeDepth.size() != discoveredNodes + 1 || !knownUrls.read(in) ) {
+        qDebug() << "WebCrawler::restore() - invalid checkpoint";
+        reset();
+        return false;
+    }
+    m_discoveredNodes = discoveredNodes;
+    m_nodeDepth = nodeDepth;
+    qDebug() << "WebCrawler::restore() - discoveredNodes" << m_discoveredNodes
+             << "known urls" << knownUrls.size();
+    return true;
+}
+
+
+
 WebCrawler::~WebCrawler() {
 
     qDebug() << "WebCrawler::~WebCrawler() - clearing vars";
 
+    qDeleteAll(m_pages);
+    m_pages.clear();
     knownUrls.clear();
+    m_nodeDepth.clear();
     m_urlPatternsIncluded.clear();
     urlPattern="";
     m_urlPatternsExcluded.clear();
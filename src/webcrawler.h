@@ -28,24 +28,48 @@
 #ifndef WEBCRAWLER_H
 #define WEBCRAWLER_H
 
-#include <QNetworkReply>
+#include <QObject>
 #include <QUrl>
-#include <QQueue>
+#include <QHash>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
 
-QT_BEGIN_NAMESPACE
-class QNetworkAccessManager;
-class QNetworkRequest;
-class QNetworkReply;
-QT_END_NAMESPACE
+#include "webcrawlerindex.h"
 
 //class WebCrawler_Spider;
 
 using namespace std;
 
+/**
+ * @brief The streaming parse state of a page being downloaded.
+ * Only the tag being read is kept, never the whole page.
+ */
+struct WebCrawlerPage {
+    enum State { Text, Tag, Comment, RawText };
+
+    QUrl url;
+    QUrl baseUrl;
+    int sourceNode = 0;
+    int state = Text;
+    QByteArray tag;             // the tag being read, without its <
+    QByteArray rawTextEnd;      // "</script" or "</style", while inside them
+    char quote = 0;             // the quote of the attribute value being read
+    int matched = 0;            // bytes matched of the end of a comment or raw text
+    bool inHead = false;
+    bool done = false;          // maxLinksPerPage reached, the rest is ignored
+    int validUrls = 0;
+    int invalidUrls = 0;
+    qint64 bytes = 0;
+};
+
+
+
 /**
  * @brief The WebCrawler class
- * Parses HTML code it receives, locates urls inside it and puts them into a url queue (passed from the parent)
+ * Parses HTML code it receives, locates urls inside it and signals them to the parent to crawl,
  * while emitting signals to the parent to create new nodes and edges between them.
+ * Pages are parsed as their bytes arrive, by a streaming tokenizer, one per page.
  */
 class WebCrawler : public QObject  {
     Q_OBJECT
@@ -53,7 +77,6 @@ class WebCrawler : public QObject  {
 public:
 
     WebCrawler (
-            QQueue<QUrl> *urlQueue,
             const QUrl &startUrl,
             const QStringList &urlPatternsIncluded,
             const QStringList &urlPatternsExcluded,
@@ -71,8 +94,15 @@ public:
 
     ~WebCrawler();
 
+    void reset();
+    bool restore(const QByteArray &state);
+
 public slots:
-    void parse(QNetworkReply *reply);
+    void checkpoint();
+    void parseData(const QUrl &currentUrl, const QByteArray &data);
+    void parse(const QUrl &currentUrl,
+               const QString &locationHeader,
+               const QByteArray &ba);
     void newLink(int s, QUrl target, bool enqueue_to_frontier);
 
 signals:
@@ -80,12 +110,21 @@ signals:
                           const QString &url,
                           const bool &signalMW=false);
     void signalCreateEdge (const int &source, const int &target);
-    void signalStartSpider();
+    void signalEnqueueUrl(const QUrl &url, const int &priority);
+    void signalAbortDownload(const QUrl &url);
+    void signalCheckpoint(const QByteArray &state);
     void finished (QString);
 
 private:
-    QQueue<QUrl> *m_urlQueue;
-    QMap <QUrl, int> knownUrls;
+    WebCrawlerPage *page(const QUrl &currentUrl);
+    void tokenize(WebCrawlerPage *p, const QByteArray &data);
+    static bool quoteStartsValue(const QByteArray &tag);
+    void parseTag(WebCrawlerPage *p);
+    void parseUrl(WebCrawlerPage *p, QString newUrlStr);
+
+    QHash <QUrl, WebCrawlerPage*> m_pages;
+    WebCrawlerIndex knownUrls;
+    QVector<int> m_nodeDepth;
     QUrl m_initialUrl;
     int m_maxUrls;
     int m_discoveredNodes;
@@ -0,0 +1,209 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         webcrawlerfrontier.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "webcrawlerfrontier.h"
+
+#include <QUrl>
+#include <QDataStream>
+#include <QtDebug>
+
+#include <cstdlib>
+
+
+WebCrawlerFrontier::WebCrawlerFrontier() :
+    m_size(0),
+    m_capacity(0),
+    m_maxHostRequests(1),
+    m_delayedRequests(false),
+    m_requests(0),
+    m_dropped(0)
+{
+}
+
+
+
+/**
+ * @brief Forgets all urls and hosts
+ */
+void WebCrawlerFrontier::clear() {
+    m_hosts.clear();
+    m_turns.clear();
+    m_inflight.clear();
+    m_size = 0;
+    m_requests = 0;
+    m_dropped = 0;
+}
+
+
+
+/**
+ * @brief Sets the limits of the frontier
+ * @param capacity the max urls kept, 0 for no limit
+ * @param maxHostRequests the max requests in flight to the same host
+ * @param delayedRequests if true, waits a random delay between the requests to the same host
+ */
+void WebCrawlerFrontier::setLimits(const int &capacity,
+                                   const int &maxHostRequests,
+                                   const bool &delayedRequests) {
+    m_capacity = capacity;
+    m_maxHostRequests = qMax(1, maxHostRequests);
+    m_delayedRequests = delayedRequests;
+}
+
+
+
+/**
+ * @brief Adds url to the queue of its host
+ * @param url
+ * @param priority lower values are taken first
+ * @return false if the frontier is full and url was dropped
+ */
+bool WebCrawlerFrontier::enqueue(const QUrl &url, const int &priority) {
+    if ( m_capacity > 0 && m_size >= m_capacity ) {
+        m_dropped++;
+        qDebug() << "WebCrawlerFrontier::enqueue() - frontier full, dropping" << url.toString();
+        return false;
+    }
+    const QString host = url.host();
+    Host &h = m_hosts[host];
+    if ( h.urls.isEmpty() ) {
+        m_turns.append(host);
+    }
+    h.urls[priority].enqueue( url.toEncoded() );
+    m_size++;
+    return true;
+}
+
+
+
+/**
+ * @brief Takes the next url of the first host, in turn, which is neither busy
+ * nor waiting, and sends that host to the end of the line.
+ * @param now the current time, in msecs
+ * @param url the url to request
+ * @param wakeAt if no url can be taken now, the earliest time a waiting host
+ * may be requested again, or left as it is
+ * @return true if a url was taken
+ */
+bool WebCrawlerFrontier::take(const qint64 &now, QUrl &url, qint64 &wakeAt) {
+    for (int i = 0; i < m_turns.size(); ++i) {
+        const QString host = m_turns.at(i);
+        Host &h = m_hosts[host];
+        if ( h.requests >= m_maxHostRequests ) {
+            continue;
+        }
+        if ( h.next > now ) {
+            if ( wakeAt == -1 || h.next < wakeAt ) {
+                wakeAt = h.next;
+            }
+            continue;
+        }
+
+        QMap<int, QQueue<QByteArray> >::iterator first = h.urls.begin();
+        url = QUrl::fromEncoded( first.value().dequeue() );
+        m_inflight.insert( url.toEncoded(), first.key() );
+        if ( first.value().isEmpty() ) {
+            h.urls.erase(first);
+        }
+        m_turns.removeAt(i);
+        if ( !h.urls.isEmpty() ) {
+            m_turns.append(host);
+        }
+
+        if ( m_delayedRequests ) {
+            h.next = now + rand() % 1000;
+        }
+        h.requests++;
+        m_requests++;
+        m_size--;
+        return true;
+    }
+    return false;
+}
+
+
+
+/**
+ * @brief Marks the request of url as finished, so that its host may be
+ * requested again
+ * @param url
+ */
+void WebCrawlerFrontier::finished(const QUrl &url) {
+    m_inflight.remove( url.toEncoded() );
+    QHash<QString, Host>::iterator h = m_hosts.find( url.host() );
+    if ( h == m_hosts.end() || h.value().requests == 0 ) {
+        return;
+    }
+    h.value().requests--;
+    m_requests--;
+}
+
+
+
+/**
+ * @brief Writes the urls of the frontier to a checkpoint of the web crawler,
+ * together with the given urls in flight, which will be requested again
+ * @param out
+ * @param inflight
+ */
+void WebCrawlerFrontier::write(QDataStream &out,
+                               const QHash<QByteArray, int> &inflight) const {
+    out << (qint32) ( m_size + inflight.size() );
+    QHash<QByteArray, int>::const_iterator f;
+    for (f = inflight.constBegin(); f != inflight.constEnd(); ++f) {
+        out << (qint32) f.value() << f.key();
+    }
+    // Keep the turns of the hosts
+    for (int i = 0; i < m_turns.size(); ++i) {
+        const Host h = m_hosts.value( m_turns.at(i) );
+        QMap<int, QQueue<QByteArray> >::const_iterator p;
+        for (p = h.urls.constBegin(); p != h.urls.constEnd(); ++p) {
+            for (int j = 0; j < p.value().size(); ++j) {
+                out << (qint32) p.key() << p.value().at(j);
+            }
+        }
+    }
+}
+
+
+
+/**
+ * @brief Enqueues the urls of a checkpoint written by write()
+ * @param in
+ * @return false if the data are not valid
+ */
+bool WebCrawlerFrontier::read(QDataStream &in) {
+    qint32 count = 0, priority = 0;
+    QByteArray encoded;
+    in >> count;
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        in >> priority >> encoded;
+        enqueue( QUrl::fromEncoded(encoded), priority );
+    }
+    return in.status() == QDataStream::Ok;
+}
@@ -0,0 +1,104 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         webcrawlerfrontier.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef WEBCRAWLERFRONTIER_H
+#define WEBCRAWLERFRONTIER_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QQueue>
+#include <QString>
+
+class QUrl;
+class QDataStream;
+
+
+/**
+ * @brief The WebCrawlerFrontier class
+ * The urls the web crawler will download, by host, until take() gives them to
+ * the spider. The hosts take turns. Each host gives first the urls with the
+ * lowest priority value, i.e. the shallowest, in the order they were enqueued.
+ * Each host may have up to maxHostRequests requests in flight and, with
+ * delayed requests, waits a random delay of up to one second between them.
+ * Urls are kept encoded, not as QUrl, and the frontier holds at most
+ * capacity urls. Once full, new urls are dropped.
+ */
+class WebCrawlerFrontier
+{
+public:
+    WebCrawlerFrontier();
+
+    void clear();
+
+    void setLimits(const int &capacity,
+                   const int &maxHostRequests,
+                   const bool &delayedRequests);
+
+    bool enqueue(const QUrl &url, const int &priority = 0);
+
+    bool take(const qint64 &now, QUrl &url, qint64 &wakeAt);
+
+    void finished(const QUrl &url);
+
+    /** Returns the urls in flight, encoded, with their priorities */
+    const QHash<QByteArray, int> &inflight() const { return m_inflight; }
+
+    void write(QDataStream &out, const QHash<QByteArray, int> &inflight) const;
+    bool read(QDataStream &in);
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    /** Returns the requests in flight, taken and not finished yet */
+    int requests() const { return m_requests; }
+
+    /** Returns the urls dropped because the frontier was full */
+    int dropped() const { return m_dropped; }
+
+private:
+    struct Host {
+        QMap<int, QQueue<QByteArray> > urls;     // by priority, lowest first
+        int requests = 0;
+        qint64 next = 0;
+    };
+
+    QHash<QString, Host> m_hosts;
+    QList<QString> m_turns;                     // hosts with urls, in round-robin order
+    QHash<QByteArray, int> m_inflight;          // urls taken and not finished yet, with their priorities
+    int m_size;
+    int m_capacity;
+    int m_maxHostRequests;
+    bool m_delayedRequests;
+    int m_requests;
+    int m_dropped;
+};
+
+#endif // WEBCRAWLERFRONTIER_H
@@ -0,0 +1,185 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         webcrawlerindex.cpp  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#include "webcrawlerindex.h"
+
+#include <QUrl>
+#include <QByteArray>
+#include <QDataStream>
+
+
+WebCrawlerIndex::WebCrawlerIndex() :
+    m_size(0)
+{
+    m_keys.fill(0, 1024);
+    m_nodes.fill(0, 1024);
+}
+
+
+
+/**
+ * @brief Forgets all urls
+ */
+void WebCrawlerIndex::clear() {
+    m_keys.fill(0, 1024);
+    m_nodes.fill(0, 1024);
+    m_size = 0;
+}
+
+
+
+/**
+ * @brief Returns the 64-bit FNV-1a hash of the normalized url: without its
+ * fragment and default port, with its path segments normalized.
+ * Never returns 0, which marks the empty slots.
+ * @param url
+ * @return
+ */
+quint64 WebCrawlerIndex::fingerprint(const QUrl &url) {
+    QUrl normalized = url.adjusted( QUrl::RemoveFragment | QUrl::NormalizePathSegments );
+    if ( ( normalized.scheme() == "http" && normalized.port() == 80 ) ||
+         ( normalized.scheme() == "https" && normalized.port() == 443 ) ) {
+        normalized.setPort(-1);
+    }
+    const QByteArray bytes = normalized.toEncoded();
+
+    quint64 hash = Q_UINT64_C(14695981039346656037);
+    const char *c = bytes.constData();
+    for (int i = 0; i < bytes.size(); ++i) {
+        hash ^= (uchar) c[i];
+        hash *= Q_UINT64_C(1099511628211);
+    }
+    return hash ? hash : 1;
+}
+
+
+
+/**
+ * @brief Returns the slot of key, or the empty slot where it would go.
+ * The hash is mixed again, so that the low bits address the table well.
+ * @param key
+ * @return
+ */
+int WebCrawlerIndex::slot(const quint64 &key) const {
+    quint64 h = key;
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    const int mask = m_keys.size() - 1;
+    int i = (int) ( h & mask );
+    while ( m_keys[i] != 0 && m_keys[i] != key ) {
+        i = ( i + 1 ) & mask;
+    }
+    return i;
+}
+
+
+
+int WebCrawlerIndex::value(const QUrl &url) const {
+    const int i = slot( fingerprint(url) );
+    return m_nodes[i];
+}
+
+
+
+/**
+ * @brief Maps url to node, growing the table if needed
+ * @param url
+ * @param node
+ */
+void WebCrawlerIndex::insert(const QUrl &url, const int &node) {
+    const quint64 key = fingerprint(url);
+    int i = slot(key);
+    if ( m_keys[i] == 0 ) {
+        if ( ( m_size + 1 ) * 10 > m_keys.size() * 7 ) {
+            grow();
+            i = slot(key);
+        }
+        m_keys[i] = key;
+        m_size++;
+    }
+    m_nodes[i] = node;
+}
+
+
+
+/**
+ * @brief Doubles the table and puts every key into its new slot
+ */
+void WebCrawlerIndex::grow() {
+    const QVector<quint64> keys = m_keys;
+    const QVector<int> nodes = m_nodes;
+    m_keys.fill(0, keys.size() * 2);
+    m_nodes.fill(0, keys.size() * 2);
+    for (int j = 0; j < keys.size(); ++j) {
+        if ( keys[j] != 0 ) {
+            const int i = slot( keys[j] );
+            m_keys[i] = keys[j];
+            m_nodes[i] = nodes[j];
+        }
+    }
+}
+
+
+
+/**
+ * @brief Writes the table to a checkpoint of the web crawler
+ * @param out
+ */
+void WebCrawlerIndex::write(QDataStream &out) const {
+    out << (qint32) m_size << m_keys << m_nodes;
+}
+
+
+
+/**
+ * @brief Reads the table from a checkpoint written by write()
+ * The table must hold size keys and be within the load factor of insert(),
+ * or slot() could probe a full table forever.
+ * @param in
+ * @return false if the data are not valid
+ */
+bool WebCrawlerIndex::read(QDataStream &in) {
+    qint32 size = 0;
+    QVector<quint64> keys;
+    QVector<int> nodes;
+    in >> size >> keys >> nodes;
+    const int capacity = keys.size();
+    if ( in.status() != QDataStream::Ok || capacity < 1024
+         || ( capacity & ( capacity - 1 ) ) != 0
+         || nodes.size() != capacity || size < 0
+         || (qint64) size * 10 > (qint64) capacity * 7
+         || capacity - keys.count(0) != size ) {
+        clear();
+        return false;
+    }
+    m_keys = keys;
+    m_nodes = nodes;
+    m_size = size;
+    return true;
+}
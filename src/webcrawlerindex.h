@@ -0,0 +1,83 @@
+/***************************************************************************
+ SocNetV: Social Network Visualizer
+ version: 2.9
+ Written in Qt
+
+                         webcrawlerindex.h  -  description
+                             -------------------
+    copyright         : (C) 2005-2021 by Dimitris B. Kalamaras
+    project site      : https://socnetv.org
+
+ ***************************************************************************/
+
+/*******************************************************************************
+*     This program is free software: you can redistribute it and/or modify     *
+*     it under the terms of the GNU General Public License as published by     *
+*     the Free Software Foundation, either version 3 of the License, or        *
+*     (at your option) any later version.                                      *
+*                                                                              *
+*     This program is distributed in the hope that it will be useful,          *
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+*     GNU General Public License for more details.                             *
+*                                                                              *
+*     You should have received a copy of the GNU General Public License        *
+*     along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+********************************************************************************/
+
+
+#ifndef WEBCRAWLERINDEX_H
+#define WEBCRAWLERINDEX_H
+
+#include <QtGlobal>
+#include <QVector>
+
+class QUrl;
+class QDataStream;
+
+
+/**
+ * @brief The WebCrawlerIndex class
+ * Maps the urls the web crawler has discovered to their node numbers.
+ * Each url is kept as a 64-bit fingerprint of its normalized form, in an
+ * open-addressing table with linear probing, which doubles when it is 70% full.
+ * That is 12 bytes per slot, some 17 bytes per url, instead of a QUrl.
+ * Two different urls share a fingerprint with a probability of about n^2 / 2^65,
+ * which is negligible for the networks we crawl.
+ */
+class WebCrawlerIndex
+{
+public:
+    WebCrawlerIndex();
+
+    void clear();
+
+    static quint64 fingerprint(const QUrl &url);
+
+    /** Returns the node of url, or 0 if url is not known */
+    int value(const QUrl &url) const;
+
+    bool contains(const QUrl &url) const { return value(url) != 0; }
+
+    void insert(const QUrl &url, const int &node);
+
+    int size() const { return m_size; }
+
+    void write(QDataStream &out) const;
+    bool read(QDataStream &in);
+
+    /** Returns the bytes used by the table */
+    qint64 memory() const {
+        return (qint64) m_keys.size() * ( sizeof(quint64) + sizeof(int) );
+    }
+
+private:
+    int slot(const quint64 &key) const;
+    void grow();
+
+    QVector<quint64> m_keys;        // 0 for empty slots
+    QVector<int> m_nodes;
+    int m_size;
+};
+
+#endif // WEBCRAWLERINDEX_H